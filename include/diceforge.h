@@ -5,4 +5,9 @@
 #include "diceforge_distributions.h"
 #include "diceforge_generators.h"
 
+// Defined before the include in one file of a program, compiles the library into it, in place of linking it
+#if defined(DF_IMPLEMENTATION)
+#include "diceforge_implementation.h"
+#endif
+
 #endif
\ No newline at end of file
@@ -1,13 +1,15 @@
+// Generated from src/ by tools/amalgamate.cmake (cmake --build <build> --target headers): edit the
+// sources rather than this file
+
 #ifndef DF_CORE_H
 #define DF_CORE_H
 
-#include <limits>
-#include <iostream>
-#include <algorithm>
-#include <vector>
+// src/Core/types.h
 
-#define _USE_MATH_DEFINES
-#include <cmath>
+#ifndef DF_TYPES_H
+#define DF_TYPES_H
+
+#include <ctype.h>
 
 namespace DiceForge
 {
@@ -50,174 +52,4736 @@ namespace DiceForge
     typedef double real_t;   // A signed floating point real number (64 bit)
 
 #endif
+}
 
-    /// @brief DiceForge::Generator<T> - A generic class for RNGs
-    /// @tparam T datatype of random number generated (RNG implementation specific)
-    /// @note Every RNG implemented in DiceForge is derived from this base class.
-    /// @note For writing your own RNG it is advisable to use this as the base class for compatibility with other features.
-    template <typename T>
-    class Generator
+#endif
+
+// src/Core/instrument.h
+
+#ifndef DF_INSTRUMENT_H
+#define DF_INSTRUMENT_H
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <cctype>
+#include <chrono>
+
+
+// Opt-in instrumentation of the hot paths, compiled out entirely unless DF_INSTRUMENT is defined (for the library
+// and for the code using it alike). DF_INSTRUMENT_CYCLES adds cycle timers to the bulk calls.
+#if defined(DF_INSTRUMENT_CYCLES) && !defined(DF_INSTRUMENT)
+#define DF_INSTRUMENT
+#endif
+
+#if defined(DF_INSTRUMENT)
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <typeinfo>
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+#if defined(DF_INSTRUMENT_CYCLES) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#elif defined(DF_INSTRUMENT_CYCLES) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace DiceForge
+{
+    namespace instrument
+    {
+        /// @brief What the counters of a site measure
+        enum class Kind
+        {
+            engine,         // count: random integers consumed, calls: next() and bulk calls
+            distribution,   // count: values produced, calls: next() and sample() calls, retries: rejected candidates
+            method,         // shared samplers (ziggurat, polar, next_in_range...): count: values, retries: rejections
+            timer           // a scope timed with DF_INSTRUMENT_SCOPE: calls and cycles
+        };
+
+        /// @brief Counters of one instrumented site, summed over all threads
+        struct Counters
+        {
+            Kind kind;
+            std::string name;
+            uint64_t count = 0, calls = 0, retries = 0, cycles = 0;
+            /// @brief Rejected candidates per value produced
+            real_t retry_rate() const
+            {
+                return count ? real_t(retries) / real_t(count) : 0;
+            }
+            /// @brief Cycles (or nanoseconds without a cycle counter) per value, with DF_INSTRUMENT_CYCLES
+            real_t cycles_per_item() const
+            {
+                return count ? real_t(cycles) / real_t(count) : (calls ? real_t(cycles) / real_t(calls) : 0);
+            }
+        };
+
+        /// @brief A snapshot of all the counters (see instrument::stats)
+        struct Stats
+        {
+            std::vector<Counters> sites;
+            /// @brief The counters of the named site, nullptr if it has not been reached
+            const Counters* find(const std::string& name) const
+            {
+                for (const Counters& c : sites)
+                    if (c.name == name)
+                        return &c;
+                return nullptr;
+            }
+            /// @brief Random integers consumed by all the engines
+            uint64_t words() const
+            {
+                uint64_t total = 0;
+                for (const Counters& c : sites)
+                    total += (c.kind == Kind::engine) ? c.count : 0;
+                return total;
+            }
+        };
+
+        /// @brief Whether the library was built with DF_INSTRUMENT
+#if defined(DF_INSTRUMENT)
+        constexpr bool enabled = true;
+#else
+        constexpr bool enabled = false;
+#endif
+    }
+
+#if defined(DF_INSTRUMENT)
+    namespace detail
+    {
+        namespace instrument
+        {
+            using DiceForge::instrument::Kind;
+
+            // Sites beyond this share the last slot
+            constexpr size_t max_sites = 256;
+            enum Field { count, calls, retries, cycles, fields };
+
+            // Counters of one thread, written by it alone (relaxed loads and stores, no locked instructions) and
+            // read by the snapshots
+            struct Thread
+            {
+                std::atomic<uint64_t> c[max_sites][fields] = {};
+                Thread();
+                ~Thread();
+            };
+
+            struct Registry
+            {
+                std::mutex mutex;
+                std::vector<std::pair<Kind, std::string>> sites;
+                std::vector<Thread*> threads;
+                // Counts of the threads that have ended
+                uint64_t retired[max_sites][fields] = {};
+            };
+
+            inline Registry& registry()
+            {
+                static Registry r;
+                return r;
+            }
+
+            inline Thread::Thread()
+            {
+                std::lock_guard<std::mutex> lock(registry().mutex);
+                registry().threads.push_back(this);
+            }
+
+            inline Thread::~Thread()
+            {
+                Registry& r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                for (size_t s = 0; s < max_sites; s++)
+                    for (size_t f = 0; f < fields; f++)
+                        r.retired[s][f] += c[s][f].load(std::memory_order_relaxed);
+                r.threads.erase(std::find(r.threads.begin(), r.threads.end(), this));
+            }
+
+            inline Thread& local()
+            {
+                thread_local Thread t;
+                return t;
+            }
+
+            /// @brief Index of the site of the given kind and name, registered on the first call
+            inline size_t site(Kind kind, const std::string& name)
+            {
+                Registry& r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                for (size_t s = 0; s < r.sites.size(); s++)
+                    if (r.sites[s].first == kind && r.sites[s].second == name)
+                        return s;
+                if (r.sites.size() == max_sites - 1)
+                    r.sites.emplace_back(kind, "(other sites)");
+                if (r.sites.size() == max_sites)
+                    return max_sites - 1;
+                r.sites.emplace_back(kind, name);
+                return r.sites.size() - 1;
+            }
+
+            inline void add(size_t s, Field f, uint64_t v)
+            {
+                std::atomic<uint64_t>& a = local().c[s][f];
+                a.store(a.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+            }
+
+            /// @brief Readable name of a type: without the namespace, with the widths of the integer types and only
+            /// the first argument of a template (MT64 is MersenneTwisterEngine<uint64_t>)
+            inline std::string type_name(const std::type_info& type)
+            {
+                std::string name = type.name();
+#if defined(__GNUG__)
+                int status = 0;
+                char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+                if (status == 0 && demangled != nullptr)
+                    name = demangled;
+                std::free(demangled);
+#endif
+                const std::pair<const char*, const char*> replace[] = {
+                    {"DiceForge::", ""}, {"class ", ""}, {"unsigned long long", "uint64_t"},
+                    {"unsigned __int64", "uint64_t"}, {"unsigned long", "uint64_t"}, {"unsigned int", "uint32_t"}};
+                for (const auto& r : replace)
+                    for (size_t at = name.find(r.first); at != std::string::npos; at = name.find(r.first, at))
+                        name.replace(at, std::strlen(r.first), r.second);
+                // Integer literals of template arguments, 4ul -> 4, and the arguments after the first
+                std::string out;
+                int depth = 0;
+                bool skip = false;
+                for (size_t i = 0; i < name.size(); i++)
+                {
+                    depth += (name[i] == '<') - (name[i] == '>');
+                    if (name[i] == ',' && depth == 1)
+                        skip = true;
+                    else if (depth == 0)
+                        skip = false;
+                    if (skip)
+                        continue;
+                    if ((name[i] == 'u' || name[i] == 'l') && i > 0 && std::isdigit((unsigned char)name[i - 1]))
+                    {
+                        while (i + 1 < name.size() && (name[i + 1] == 'u' || name[i + 1] == 'l'))
+                            i++;
+                        continue;
+                    }
+                    out += name[i];
+                }
+                return out;
+            }
+
+            /// @brief Index of the site of an engine type, cached per thread
+            /// @note The engines hold no counter state of their own, so their layout does not depend on the flag
+            /// and code built with it can use a library built without it (whose own draws go uncounted)
+            inline size_t engine_site(const std::type_info& type)
+            {
+                thread_local std::vector<std::pair<const std::type_info*, size_t>> known;
+                for (const auto& k : known)
+                    if (*k.first == type)
+                        return k.second;
+                known.emplace_back(&type, site(Kind::engine, type_name(type)));
+                return known.back().second;
+            }
+
+            /// @brief Reads the cycle counter (the steady clock in nanoseconds where there is none)
+            inline uint64_t ticks()
+            {
+#if defined(DF_INSTRUMENT_CYCLES) && (defined(__x86_64__) || defined(__i386__) || defined(_MSC_VER))
+                return __rdtsc();
+#else
+                return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+            }
+
+            // Depth of the instrumented sampling calls of the thread: sample() looping over next(), or a
+            // distribution drawing from another, counts once, for the outermost call
+            inline int& depth()
+            {
+                thread_local int d = 0;
+                return d;
+            }
+
+            /// @brief Counts a call of a distribution producing n values, and times it with DF_INSTRUMENT_CYCLES
+            class Sampling
+            {
+            private:
+                size_t s;
+                bool outer;
+#if defined(DF_INSTRUMENT_CYCLES)
+                uint64_t start = 0;
+#endif
+            public:
+                Sampling(size_t s, uint64_t n) : s(s), outer(depth()++ == 0)
+                {
+                    if (outer)
+                    {
+                        add(s, count, n);
+                        add(s, calls, 1);
+#if defined(DF_INSTRUMENT_CYCLES)
+                        start = ticks();
+#endif
+                    }
+                }
+                ~Sampling()
+                {
+                    depth()--;
+#if defined(DF_INSTRUMENT_CYCLES)
+                    if (outer)
+                        add(s, cycles, ticks() - start);
+#endif
+                }
+                Sampling(const Sampling&) = delete;
+                Sampling& operator=(const Sampling&) = delete;
+            };
+
+            /// @brief Counts and times a scope (DF_INSTRUMENT_SCOPE), or an engine filling a block
+            class Scope
+            {
+            private:
+                size_t s;
+                uint64_t start;
+            public:
+                explicit Scope(size_t s) : s(s), start(ticks())
+                {
+                    add(s, calls, 1);
+                }
+                ~Scope()
+                {
+                    add(s, cycles, ticks() - start);
+                }
+                Scope(const Scope&) = delete;
+                Scope& operator=(const Scope&) = delete;
+            };
+        }
+    }
+
+// Index of a site, looked up once per place in the code
+#define DF_INSTRUMENT_SITE(kind, name) ([]() { \
+        static const size_t df_site = ::DiceForge::detail::instrument::site(::DiceForge::instrument::Kind::kind, name); \
+        return df_site; }())
+#define DF_INSTRUMENT_ADD(kind, name, field, n) \
+    ::DiceForge::detail::instrument::add(DF_INSTRUMENT_SITE(kind, name), ::DiceForge::detail::instrument::field, (n))
+/// Counts a call of a distribution producing n values (for the outermost call only, see detail::instrument::depth)
+#define DF_INSTRUMENT_SAMPLES(name, n) \
+    ::DiceForge::detail::instrument::Sampling df_sampling(DF_INSTRUMENT_SITE(distribution, name), uint64_t(n))
+/// Counts a rejected candidate of a distribution
+#define DF_INSTRUMENT_REJECT(name) DF_INSTRUMENT_ADD(distribution, name, retries, 1)
+/// Counts n values of a shared sampling method
+#define DF_INSTRUMENT_METHOD(name, n) DF_INSTRUMENT_ADD(method, name, count, n)
+/// Counts a rejection of a shared sampling method
+#define DF_INSTRUMENT_METHOD_REJECT(name) DF_INSTRUMENT_ADD(method, name, retries, 1)
+/// Counts n rejections of a shared sampling method
+#define DF_INSTRUMENT_METHOD_REJECTS(name, n) DF_INSTRUMENT_ADD(method, name, retries, n)
+/// Counts the calls of the enclosing scope and the cycles spent in it
+#define DF_INSTRUMENT_SCOPE(name) \
+    ::DiceForge::detail::instrument::Scope df_scope(DF_INSTRUMENT_SITE(timer, name))
+#else
+#define DF_INSTRUMENT_SAMPLES(name, n) ((void)0)
+#define DF_INSTRUMENT_REJECT(name) ((void)0)
+#define DF_INSTRUMENT_METHOD(name, n) ((void)0)
+#define DF_INSTRUMENT_METHOD_REJECT(name) ((void)0)
+#define DF_INSTRUMENT_METHOD_REJECTS(name, n) ((void)0)
+#define DF_INSTRUMENT_SCOPE(name) ((void)0)
+#endif
+
+    namespace instrument
+    {
+        /// @brief Returns the counters of every site reached so far, summed over the threads (empty without
+        /// DF_INSTRUMENT)
+        /// @note Safe to call while other threads draw; their latest increments may be missing
+        inline Stats stats()
+        {
+            Stats out;
+#if defined(DF_INSTRUMENT)
+            namespace di = detail::instrument;
+            di::Registry& r = di::registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            for (size_t s = 0; s < r.sites.size(); s++)
+            {
+                uint64_t total[di::fields];
+                for (size_t f = 0; f < di::fields; f++)
+                {
+                    total[f] = r.retired[s][f];
+                    for (const di::Thread* t : r.threads)
+                        total[f] += t->c[s][f].load(std::memory_order_relaxed);
+                }
+                Counters c;
+                c.kind = r.sites[s].first;
+                c.name = r.sites[s].second;
+                c.count = total[di::count];
+                c.calls = total[di::calls];
+                c.retries = total[di::retries];
+                c.cycles = total[di::cycles];
+                out.sites.push_back(c);
+            }
+#endif
+            return out;
+        }
+
+        /// @brief Sets every counter back to 0 (the sites stay registered)
+        /// @note Counts added by other threads during the reset may survive it
+        inline void reset()
+        {
+#if defined(DF_INSTRUMENT)
+            namespace di = detail::instrument;
+            di::Registry& r = di::registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            for (size_t s = 0; s < di::max_sites; s++)
+                for (size_t f = 0; f < di::fields; f++)
+                {
+                    r.retired[s][f] = 0;
+                    for (di::Thread* t : r.threads)
+                        t->c[s][f].store(0, std::memory_order_relaxed);
+                }
+#endif
+        }
+
+        /// @brief Writes the counters as a table, one site per line
+        inline void dump(std::ostream& out, const Stats& stats)
+        {
+            if (!enabled) {
+                out << "DiceForge instrumentation is off (build with DF_INSTRUMENT)" << std::endl;
+                return;
+            }
+            static const char* kinds[] = {"engine", "distribution", "method", "timer"};
+            const std::ios_base::fmtflags flags = out.flags();
+            out << std::left << std::setw(14) << "kind" << std::setw(44) << "site" << std::right << std::setw(16)
+                << "count" << std::setw(14) << "calls" << std::setw(16) << "retries/value"
+#if defined(DF_INSTRUMENT_CYCLES)
+                << std::setw(16) << "cycles/value"
+#endif
+                << "\n";
+            for (const Counters& c : stats.sites)
+            {
+                out << std::left << std::setw(14) << kinds[int(c.kind)] << std::setw(44) << c.name << std::right
+                    << std::setw(16) << c.count << std::setw(14) << c.calls << std::setw(16) << c.retry_rate()
+#if defined(DF_INSTRUMENT_CYCLES)
+                    << std::setw(16) << c.cycles_per_item()
+#endif
+                    << "\n";
+            }
+            out.flags(flags);
+            out.flush();
+        }
+
+        /// @brief Writes the current counters as a table
+        inline void dump(std::ostream& out = std::cerr)
+        {
+            dump(out, stats());
+        }
+
+        /// @brief DiceForge::instrument::PeriodicDump - Writes the counters to a stream at regular intervals, from
+        /// a thread of its own, until it is destroyed (does nothing without DF_INSTRUMENT)
+        class PeriodicDump
+        {
+#if defined(DF_INSTRUMENT)
+        private:
+            std::mutex mutex;
+            std::condition_variable wake;
+            bool stopping = false;
+            std::thread worker;
+        public:
+            /// @param out stream to write to, which must outlive this object
+            /// @param interval time between two dumps
+            PeriodicDump(std::ostream& out, std::chrono::milliseconds interval)
+            {
+                worker = std::thread([this, &out, interval]() {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    while (!wake.wait_for(lock, interval, [this]() { return stopping; }))
+                        dump(out);
+                });
+            }
+            ~PeriodicDump()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stopping = true;
+                }
+                wake.notify_one();
+                worker.join();
+            }
+#else
+        public:
+            PeriodicDump(std::ostream&, std::chrono::milliseconds) {}
+#endif
+            PeriodicDump(const PeriodicDump&) = delete;
+            PeriodicDump& operator=(const PeriodicDump&) = delete;
+        };
+    }
+}
+
+#endif
+
+// src/Core/state.h
+
+#ifndef DF_STATE_H
+#define DF_STATE_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+
+namespace DiceForge
+{
+    namespace detail
+    {
+        // Saved states start with the magic "DFst", the version of the format and the length of the payload (4 bytes)
+        constexpr unsigned char state_magic[4] = {'D', 'F', 's', 't'};
+        constexpr unsigned char state_version = 1;
+        constexpr size_t state_header = 9;
+        // Reading a stream, the payload grows by at most this much per read, so that a corrupt length asks for no
+        // more memory than the stream holds
+        constexpr size_t state_chunk = 1 << 16;
+
+        /// @brief Appends the fields of a saved state to a byte buffer, integers in little-endian order
+        class StateWriter
+        {
+        private:
+            std::vector<unsigned char>& out;
+        public:
+            explicit StateWriter(std::vector<unsigned char>& out) : out(out) {}
+            /// @brief Appends an unsigned integer (or a real, by its bits)
+            template <typename U>
+            void put(U x)
+            {
+                if constexpr (std::is_floating_point<U>::value) {
+                    uint64_t bits;
+                    static_assert(sizeof(U) <= sizeof(bits), "Expected a float or a double");
+                    double d = double(x);
+                    std::memcpy(&bits, &d, sizeof(bits));
+                    put(bits);
+                }
+                else {
+                    static_assert(std::is_unsigned<U>::value, "Expected an unsigned integer");
+                    for (size_t b = 0; b < sizeof(U); b++)
+                        out.push_back((unsigned char)(x >> (8 * b)));
+                }
+            }
+            /// @brief Appends n values
+            template <typename U>
+            void put(const U* x, size_t n)
+            {
+                for (size_t i = 0; i < n; i++)
+                    put(x[i]);
+            }
+            /// @brief Appends raw bytes, preceded by their number
+            void bytes(const unsigned char* data, size_t n)
+            {
+                put(uint32_t(n));
+                out.insert(out.end(), data, data + n);
+            }
+            /// @brief Appends the name of the saved object, which load_state checks before anything else
+            void tag(const char* name)
+            {
+                const size_t n = std::strlen(name);
+                put((unsigned char)(n));
+                out.insert(out.end(), name, name + n);
+            }
+        };
+
+        /// @brief Reads back the fields appended by a StateWriter, throwing std::invalid_argument past the end
+        class StateReader
+        {
+        private:
+            const unsigned char* data;
+            size_t size, position = 0;
+            const unsigned char* take(size_t n)
+            {
+                if (n > size - position)
+                    throw std::invalid_argument("The saved state is truncated");
+                position += n;
+                return data + position - n;
+            }
+        public:
+            StateReader(const unsigned char* data, size_t size) : data(data), size(size) {}
+            /// @brief Reads an unsigned integer (or a real)
+            template <typename U>
+            U get()
+            {
+                if constexpr (std::is_floating_point<U>::value) {
+                    const uint64_t bits = get<uint64_t>();
+                    double d;
+                    std::memcpy(&d, &bits, sizeof(d));
+                    return U(d);
+                }
+                else {
+                    const unsigned char* p = take(sizeof(U));
+                    U x = 0;
+                    for (size_t b = 0; b < sizeof(U); b++)
+                        x |= U(p[b]) << (8 * b);
+                    return x;
+                }
+            }
+            /// @brief Reads n values
+            template <typename U>
+            void get(U* x, size_t n)
+            {
+                for (size_t i = 0; i < n; i++)
+                    x[i] = get<U>();
+            }
+            /// @brief Reads an integer and throws unless it is the expected one (a size or a parameter of the type)
+            template <typename U>
+            void expect(U x)
+            {
+                if (get<U>() != x)
+                    throw std::invalid_argument("The saved state does not fit this object");
+            }
+            /// @brief Reads raw bytes written by StateWriter::bytes, returns their number
+            size_t bytes(const unsigned char*& out)
+            {
+                const size_t n = get<uint32_t>();
+                out = take(n);
+                return n;
+            }
+            /// @brief Reads the name of the saved object and throws unless it is the given one
+            void tag(const char* name)
+            {
+                const size_t n = get<unsigned char>();
+                if (n != std::strlen(name) || std::memcmp(take(n), name, n) != 0)
+                    throw std::invalid_argument(std::string("The saved state is not that of a ") + name);
+            }
+            /// @brief Number of bytes not read yet
+            size_t remaining() const
+            {
+                return size - position;
+            }
+            /// @brief Throws unless the whole payload has been read, for read_state to call before it changes anything
+            void end() const
+            {
+                if (position != size)
+                    throw std::invalid_argument("The saved state does not fit this object");
+            }
+        };
+    }
+
+    /// @brief DiceForge::Serializable<Derived> - Saves and restores the state of an object in a compact binary format
+    /// @tparam Derived class providing write_state(detail::StateWriter&) const and read_state(detail::StateReader&)
+    /// (it must declare Serializable<Derived> as a friend), which reads every field into temporaries and calls
+    /// in.end() before changing the object
+    /// @note A saved state is the magic "DFst", a version byte, the length of the payload and the payload: the name
+    /// of the object followed by its fields, integers in little-endian order, so it can be restored on any machine.
+    template <typename Derived>
+    class Serializable
     {
     public:
-        /// @brief Returns a random integer generated by the RNG
-        /// @returns An unsigned integer (usually 32 or 64 bit)
-        T next()
+        /// @brief Returns the state of the object
+        std::vector<unsigned char> save_state() const
+        {
+            std::vector<unsigned char> out(std::begin(detail::state_magic), std::end(detail::state_magic));
+            out.push_back(detail::state_version);
+            out.resize(detail::state_header);
+            detail::StateWriter writer(out);
+            static_cast<const Derived&>(*this).write_state(writer);
+            const size_t n = out.size() - detail::state_header;
+            for (size_t b = 0; b < 4; b++)
+                out[5 + b] = (unsigned char)(n >> (8 * b));
+            return out;
+        }
+        /// @brief Writes the state of the object to the stream
+        void save_state(std::ostream& out) const
+        {
+            const std::vector<unsigned char> state = save_state();
+            out.write(reinterpret_cast<const char*>(state.data()), std::streamsize(state.size()));
+        }
+        /// @brief Restores a state returned by save_state()
+        /// @note Throws std::invalid_argument if the bytes are not a state of the same kind of object (with the same
+        /// sizes), the object being left as it was
+        void load_state(const unsigned char* data, size_t size)
+        {
+            if (size < detail::state_header || payload(data) != size - detail::state_header)
+                throw std::invalid_argument("The saved state is truncated");
+            detail::StateReader reader(data + detail::state_header, size - detail::state_header);
+            static_cast<Derived&>(*this).read_state(reader);
+            if (reader.remaining() != 0)
+                throw std::invalid_argument("The saved state does not fit this object");
+        }
+        /// @brief Restores a state returned by save_state()
+        void load_state(const std::vector<unsigned char>& state)
+        {
+            load_state(state.data(), state.size());
+        }
+        /// @brief Reads a state written by save_state(std::ostream&) from the stream and restores it
+        void load_state(std::istream& in)
+        {
+            std::vector<unsigned char> state(detail::state_header);
+            if (!in.read(reinterpret_cast<char*>(state.data()), std::streamsize(state.size())))
+                throw std::invalid_argument("The saved state is truncated");
+            for (size_t left = payload(state.data()); left > 0;)
+            {
+                const size_t at = state.size(), n = (left < detail::state_chunk) ? left : detail::state_chunk;
+                state.resize(at + n);
+                if (!in.read(reinterpret_cast<char*>(state.data() + at), std::streamsize(n)))
+                    throw std::invalid_argument("The saved state is truncated");
+                left -= n;
+            }
+            load_state(state.data(), state.size());
+        }
+    protected:
+        ~Serializable() = default;
+    private:
+        // Checks the magic and the version, returns the length of the payload
+        static size_t payload(const unsigned char* header)
+        {
+            if (std::memcmp(header, detail::state_magic, 4) != 0)
+                throw std::invalid_argument("Expected a state saved by DiceForge");
+            if (header[4] != detail::state_version)
+                throw std::invalid_argument("The saved state is of an unknown version");
+            size_t n = 0;
+            for (size_t b = 0; b < 4; b++)
+                n |= size_t(header[5 + b]) << (8 * b);
+            return n;
+        }
+    };
+}
+
+#endif
+
+// src/Core/generator.h
+
+#ifndef DF_GENERATOR_H
+#define DF_GENERATOR_H
+
+#include <limits>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <thread>
+#include <iterator>
+#include <unordered_set>
+#include <initializer_list>
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+
+namespace DiceForge
+{
+    namespace detail
+    {
+        /// @brief Returns 64 random bits, from one or more outputs of the RNG
+        template <typename Engine>
+        uint64_t bits64(Engine& rng)
+        {
+            typedef decltype(rng.next()) word_t;
+            if constexpr (sizeof(word_t) >= sizeof(uint64_t))
+                return uint64_t(rng.next());
+            else {
+                uint64_t x = 0;
+                for (size_t b = 0; b < 64; b += 8 * sizeof(word_t))
+                    x = (x << (8 * sizeof(word_t))) | uint64_t(rng.next());
+                return x;
+            }
+        }
+
+        /// @brief Returns a random index in [0, n), n > 0, using as many outputs of the RNG as needed
+        /// when n exceeds its range
+        template <typename Engine>
+        uint64_t uniform_index(Engine& rng, uint64_t n)
+        {
+            typedef decltype(rng.next()) word_t;
+            if (n - 1 <= uint64_t(std::numeric_limits<word_t>::max()))
+                return uint64_t(rng.next_in_range(0, word_t(n - 1)));
+            if constexpr (sizeof(word_t) < sizeof(uint64_t)) {
+                // Multiply-shift (as in next_in_range) on 64-bit words made of several outputs
+                uint128_t m = uint128_t(bits64(rng)) * n;
+                if (uint64_t(m) < n) {
+                    const uint64_t threshold = (0 - n) % n;
+                    while (uint64_t(m) < threshold) {
+                        DF_INSTRUMENT_METHOD_REJECT("uniform_index");
+                        m = uint128_t(bits64(rng)) * n;
+                    }
+                }
+                return uint64_t(m >> 64);
+            }
+            return 0;
+        }
+
+        /// @brief Merges the shuffled ranges [first, mid) and [mid, last) into a shuffled [first, last)
+        /// @note Picks the next element from either range by a coin flip until one runs out, then inserts
+        /// the rest at random positions (MergeShuffle, Bacher et al.)
+        template <typename RandomAccessIterator, typename Engine>
+        void merge_shuffled(RandomAccessIterator first, RandomAccessIterator mid, RandomAccessIterator last, Engine& rng)
+        {
+            typedef decltype(rng.next()) word_t;
+            word_t coins = 0;
+            size_t left = 0;
+            auto i = first, j = mid;
+            for (;; ++i) {
+                if (left == 0) {
+                    coins = rng.next();
+                    left = 8 * sizeof(word_t);
+                }
+                bool second = coins & 1;
+                coins >>= 1;
+                left--;
+                if (second) {
+                    if (j == last)
+                        break;
+                    std::iter_swap(i, j);
+                    ++j;
+                }
+                else if (i == j)
+                    break;
+            }
+            for (; i != last; ++i)
+                std::iter_swap(i, first + uniform_index(rng, uint64_t(i - first) + 1));
+        }
+
+        // Smallest number of elements per thread worth shuffling in parallel
+        constexpr size_t parallel_shuffle_block = size_t(1) << 16;
+
+        // Longest jump asked of an RNG that discards the integers one by one (a second or so for MT32)
+        constexpr uint64_t slow_jump_limit = uint64_t(1) << 30;
+        // Engines that tell whether they jump fast (those derived from DiceForge::Generator)
+        template <typename Engine, typename = void>
+        struct reports_jump : std::false_type {};
+        template <typename Engine>
+        struct reports_jump<Engine, std::void_t<decltype(std::declval<const Engine&>().has_fast_jump())>>
+            : std::true_type {};
+        // Throws std::invalid_argument when the engine would discard more than slow_jump_limit integers to jump by
+        // steps; engines that do not tell are assumed to jump fast
+        template <typename Engine>
+        void check_jump(const Engine& engine, uint128_t steps)
+        {
+            if constexpr (reports_jump<Engine>::value) {
+                if (steps > slow_jump_limit && !engine.has_fast_jump())
+                    throw std::invalid_argument("This RNG has no fast jump, so its streams must start at most 2^30 "
+                                                "integers apart");
+            }
+        }
+    }
+
+    /// @brief Advances x by the golden gamma and returns the next output of SplitMix64 (Steele, Lea and Flood)
+    /// @note Every output is a bijection of x, so distinct seeds never give the same first output
+    inline uint64_t splitmix64(uint64_t& x)
+    {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    /// @brief DiceForge::SeedSequence - Expands seed material of any length into the words of the state of an RNG
+    /// @note The material is folded into one 64-bit key, and word i of the expansion is output i of SplitMix64
+    /// started at the key, so a sequence made of a single seed s gives the outputs of SplitMix64 seeded with s.
+    /// Every RNG of DiceForge fills its whole state from a SeedSequence (reset_seed(seed) uses SeedSequence(seed)),
+    /// so that any seed, 0 included, gives a well mixed state without a warm-up.
+    class SeedSequence
+    {
+    private:
+        uint64_t key = 0;
+    public:
+        /// @brief The sequence of a single seed
+        explicit SeedSequence(uint64_t seed) : key(seed) {}
+        /// @brief The sequence of the given words of seed material
+        SeedSequence(std::initializer_list<uint64_t> material) : SeedSequence(material.begin(), material.end()) {}
+        /// @brief The sequence of the seed material in [first, last), converted to 64-bit words
+        template <typename InputIterator>
+        SeedSequence(InputIterator first, InputIterator last)
+        {
+            // key = m_0, then key = splitmix64(key) ^ m_j, a bijection of every word given the ones before it
+            for (bool start = true; first != last; ++first, start = false)
+                key = (start ? 0 : splitmix64(key)) ^ uint64_t(*first);
+        }
+        /// @brief Returns word i of the expansion
+        uint64_t word(size_t i) const
+        {
+            uint64_t x = key + uint64_t(i) * 0x9E3779B97F4A7C15ULL;
+            return splitmix64(x);
+        }
+        /// @brief Fills the buffer with the first n words of the expansion, cut into pieces of U
+        /// @note Words are cut as by StaticGenerator::fill_fixed, the high piece first
+        template <typename U>
+        void generate(U* out, size_t n) const
+        {
+            static_assert(std::is_unsigned<U>::value && sizeof(U) <= sizeof(uint64_t), "Expected an unsigned word");
+            constexpr size_t pieces = sizeof(uint64_t) / sizeof(U);
+            uint64_t x = key, w = 0;
+            for (size_t i = 0; i < n; i++) {
+                if (i % pieces == 0)
+                    w = splitmix64(x);
+                out[i] = U(w >> (8 * sizeof(U) * (pieces - 1 - i % pieces)));
+            }
+        }
+    };
+
+    /// @brief DiceForge::StaticGenerator<Derived, T> - The interface shared by every RNG, resolved at compile time (CRTP)
+    /// @tparam Derived class providing generate() and generate_block(T*, size_t)
+    /// @tparam T datatype of random number generated (RNG implementation specific)
+    /// @note Generator<T> builds on this class with virtual generate() for runtime choice of RNG, while
+    /// StaticView<Engine> builds on it with direct calls into a concrete RNG, so that hot loops can be inlined.
+    template <typename Derived, typename T>
+    class StaticGenerator
+    {
+    public:
+        /// @brief Datatype of the random integers generated by the RNG
+        typedef T result_type;
+
+        /// @brief Returns a random integer generated by the RNG
+        /// @returns An unsigned integer (usually 32 or 64 bit)
+        T next()
+        {
+            return draw();
+        };
+        /// @brief Returns a random real between 0 and 1
+        /// @returns An floating-point real number (64 bit) in [0, 1)
+        /// @note Built from the top 53 bits of a 64-bit integer (all 32 bits of a 32-bit one), with no division or retries
+        real_t next_unit()
+        {
+            return to_unit(draw());
+        }
+        /// @brief Returns a random single precision real between 0 and 1
+        /// @returns A floating-point real number (32 bit) in [0, 1)
+        /// @note Built from the top 24 bits of one random integer (filled out from more of them for RNGs narrower
+        /// than 24 bits), the full mantissa of a float, so it is never rounded up to 1
+        float next_unit_float()
+        {
+            if constexpr (sizeof(T) * 8 >= 24)
+                return float(draw() >> (sizeof(T) * 8 - 24)) * (1.0f / 16777216.0f);
+            else
+                return float(detail::bits64(derived()) >> 40) * (1.0f / 16777216.0f);
+        }
+        /// @brief Returns a random integer in the specified range
+        /// @param min minimum value of the random number (inclusive)
+        /// @param max maximum value of the random number (inclusive)
+        /// @returns An signed integer (64 bit)
+        /// @note Unbiased, using Lemire's multiply-shift method (integer arithmetic only, rarely retries)
+        int64_t next_in_range(T min, T max)
+        {
+            typedef typename std::conditional<sizeof(T) <= 4, uint64_t, uint128_t>::type wide_t;
+            DF_INSTRUMENT_METHOD("next_in_range", 1);
+            const T range = T(max - min + 1);
+            // The whole range of T
+            if (range == 0)
+                return (int64_t)(T)(draw() + min);
+            wide_t m = wide_t(draw()) * range;
+            T low = T(m);
+            if (low < range) {
+                // Reject the values that would make low multiples of the range more likely
+                const T threshold = T(0 - range) % range;
+                while (low < threshold) {
+                    DF_INSTRUMENT_METHOD_REJECT("next_in_range");
+                    m = wide_t(draw()) * range;
+                    low = T(m);
+                }
+            }
+            return (int64_t)(T)(T(m >> (8 * sizeof(T))) + min);
+        };
+        /// @brief Returns a random real number in the specified range
+        /// @param min minimum value of the random number
+        /// @param max maximum value of the random number
+        /// @returns An signed floating-point real number (64 bit)
+        real_t next_in_crange(real_t min, real_t max)
+        {
+            DF_INSTRUMENT_METHOD("next_in_crange", 1);
+            real_t x = (max - min) * next_unit() + min;
+            // Rounding can reach max, which is excluded
+            while (x == max) {
+                DF_INSTRUMENT_METHOD_REJECT("next_in_crange");
+                x = (max - min) * next_unit() + min;
+            }
+            return x;
+        };
+        /// @brief Fills the buffer with random integers generated by the RNG
+        /// @param out Pointer to the first element of the buffer
+        /// @param n Number of random integers to be written
+        /// @note Equivalent to n calls of next(), but costs a single (virtual) call for the whole block
+        void fill(T* out, size_t n)
+        {
+            draw_block(out, n);
+        }
+        /// @brief Fills the buffer with random reals between 0 and 1
+        /// @param out Pointer to the first element of the buffer
+        /// @param n Number of random reals to be written
+        void fill_unit(real_t* out, size_t n)
+        {
+            T block[block_size];
+            while (n > 0) {
+                size_t m = std::min(n, block_size);
+                draw_block(block, m);
+                for (size_t i = 0; i < m; i++) {
+                    out[i] = to_unit(block[i]);
+                }
+                out += m;
+                n -= m;
+            }
+        }
+        /// @brief Fills the buffer with random single precision reals between 0 and 1
+        /// @param out Pointer to the first element of the buffer
+        /// @param n Number of random reals to be written
+        /// @note Each one takes 32 random bits (see fill_fixed), of which the top 24 make the mantissa, so a 64-bit
+        /// RNG fills two floats per integer
+        void fill_unit(float* out, size_t n)
+        {
+            uint32_t block[block_size];
+            while (n > 0) {
+                size_t m = std::min(n, block_size);
+                fill_fixed(block, m);
+                for (size_t i = 0; i < m; i++) {
+                    out[i] = float(block[i] >> 8) * (1.0f / 16777216.0f);
+                }
+                out += m;
+                n -= m;
+            }
+        }
+        /// @brief Fills the buffer with random fixed-point fractions, all of whose bits follow the binary point
+        /// (x / 2^bits is uniform in [0, 1)), e.g. 0.16 fixed-point values for U = uint16_t
+        /// @tparam U an unsigned integer type
+        /// @param out Pointer to the first element of the buffer
+        /// @param n Number of random fractions to be written
+        /// @note Integers wider than U are cut into sizeof(T) / sizeof(U) pieces, the high one first, and narrower
+        /// ones are joined, so that no random bits are wasted except for the unused pieces of the last integer
+        template <typename U>
+        void fill_fixed(U* out, size_t n)
+        {
+            static_assert(std::is_unsigned<U>::value, "Fixed-point fractions are unsigned integers");
+            T block[block_size];
+            if constexpr (sizeof(U) <= sizeof(T)) {
+                constexpr size_t pieces = sizeof(T) / sizeof(U);
+                while (n > 0) {
+                    size_t words = std::min(block_size, (n + pieces - 1) / pieces);
+                    size_t m = std::min(n, words * pieces);
+                    draw_block(block, words);
+                    for (size_t i = 0; i < m; i++) {
+                        out[i] = U(block[i / pieces] >> (8 * sizeof(U) * (pieces - 1 - i % pieces)));
+                    }
+                    out += m;
+                    n -= m;
+                }
+            }
+            else {
+                constexpr size_t words = sizeof(U) / sizeof(T);
+                while (n > 0) {
+                    size_t m = std::min(n, block_size / words);
+                    draw_block(block, m * words);
+                    for (size_t i = 0; i < m; i++) {
+                        U x = 0;
+                        for (size_t j = 0; j < words; j++)
+                            x = U(x << (8 * sizeof(T))) | U(block[i * words + j]);
+                        out[i] = x;
+                    }
+                    out += m;
+                    n -= m;
+                }
+            }
+        }
+        /// @brief Returns a uniformly chosen random element from the sequence
+        /// @param first Iterator of first element (like .begin() of vectors)
+        /// @param last Iterator after last element (like .end() of vectors)
+        template <typename RandomAccessIterator>
+        auto choice(RandomAccessIterator first, RandomAccessIterator last)
+        {
+            return *(first + next_in_range(0, last - first - 1));
+        };
+
+        /// @brief Returns a uniformly chosen random element from the sequence
+        /// @param first Iterator of first element (like .begin() of vectors)
+        /// @param last Iterator after last element (like .end() of vectors)
+        /// @param weights_first Iterator of first element of the weights list
+        /// @param weights_last Iterator after last element of the weights list
+        /// @note weights here refer to an array containing the probability weights for each element in the input sequence
+        /// @note Takes O(n) per call, use DiceForge::WeightedSampler to draw repeatedly from the same weights
+        template <typename RandomAccessIterator1, typename RandomAccessIterator2>
+        auto choice(RandomAccessIterator1 first, RandomAccessIterator1 last,
+                    RandomAccessIterator2 weights_first, RandomAccessIterator2 weights_last)
+        {
+            if (last - first != weights_last - weights_first){
+                throw std::invalid_argument("Lengths of sequence and weight sequence must be equal!");
+            }
+            else if (last == first){
+                throw std::invalid_argument("Sequence must have non-zero length!");
+            }
+            // A single pass for the total and one for the index, without allocating
+            real_t total = 0;
+            for (auto it = weights_first; it != weights_last; it++){
+                total += *it;
+            }
+            real_t target = next_unit() * total, cumulative = 0;
+            auto chosen = first;
+            for (auto it = weights_first; it != weights_last; it++){
+                cumulative += *it;
+                if (*it > 0){
+                    chosen = first + (it - weights_first);
+                    if (cumulative > target)
+                        break;
+                }
+            }
+            return *chosen;
+        };
+
+        /// @brief Shuffles the sequence in place
+        /// @param first Iterator of first element (like .begin() of vectors)
+        /// @param last Iterator after last element (like .end() of vectors)
+        template <typename RandomAccessIterator>
+        void shuffle(RandomAccessIterator first, RandomAccessIterator last)
+        {
+            // Fisher-Yates: the element placed at n - 1 is drawn from the first n
+            for (auto n = last - first; n > 1; n--)
+                std::iter_swap(first + (n - 1), first + detail::uniform_index(derived(), uint64_t(n)));
+        };
+
+        /// @brief Writes k distinct elements of the sequence, chosen uniformly at random, to out
+        /// @param first Iterator of first element (like .begin() of vectors)
+        /// @param last Iterator after last element (like .end() of vectors)
+        /// @param out Iterator to write the chosen elements to
+        /// @param k Number of elements to be chosen (at most the length of the sequence)
+        /// @returns Iterator after the last element written
+        /// @note For random access sequences much longer than k, Floyd's algorithm is used (O(k) time and memory,
+        /// chosen elements in no particular order). Otherwise the sequence is walked once with Vitter's
+        /// Algorithm D (O(k) random numbers, chosen elements in their original order).
+        template <typename ForwardIterator, typename OutputIterator>
+        OutputIterator sample(ForwardIterator first, ForwardIterator last, OutputIterator out, size_t k)
+        {
+            typedef typename std::iterator_traits<ForwardIterator>::iterator_category category;
+            const uint64_t n = uint64_t(std::distance(first, last));
+            if (k > n){
+                throw std::invalid_argument("Sample larger than sequence!");
+            }
+            if constexpr (std::is_base_of<std::random_access_iterator_tag, category>::value) {
+                if (k <= n / floyd_ratio) {
+                    // Floyd: the j-th pick is uniform over the first n - k + j + 1 indices, taking
+                    // the last of them instead if it was already chosen
+                    std::unordered_set<uint64_t> chosen;
+                    chosen.reserve(k);
+                    for (uint64_t j = n - k; j < n; j++) {
+                        uint64_t t = detail::uniform_index(derived(), j + 1);
+                        if (!chosen.insert(t).second) {
+                            chosen.insert(j);
+                            t = j;
+                        }
+                        *out++ = *(first + t);
+                    }
+                    return out;
+                }
+            }
+            sequential_sample(n, k, [&](uint64_t skip) {
+                std::advance(first, skip);
+                *out++ = *first;
+                ++first;
+            });
+            return out;
+        }
+
+        /// @brief Writes k distinct indices in [0, n), chosen uniformly at random, to out in increasing order
+        /// @param n Number of indices to choose from
+        /// @param k Number of indices to be chosen (at most n)
+        /// @param out Iterator to write the chosen indices to
+        /// @returns Iterator after the last index written
+        /// @note Vitter's Algorithm D: O(k) time and random numbers, no memory besides the output
+        template <typename OutputIterator>
+        OutputIterator sample_indices(uint64_t n, size_t k, OutputIterator out)
+        {
+            if (k > n){
+                throw std::invalid_argument("Sample larger than sequence!");
+            }
+            uint64_t next = 0;
+            sequential_sample(n, k, [&](uint64_t skip) {
+                next += skip;
+                *out++ = next++;
+            });
+            return out;
+        }
+
+        /// @brief Keeps k elements chosen uniformly at random from a sequence read only once (reservoir sampling)
+        /// @param first Iterator of first element (any input iterator, e.g. over a stream)
+        /// @param last Iterator after last element
+        /// @param reservoir Iterator of first element of a buffer with room for k elements
+        /// @param k Number of elements to be kept
+        /// @returns Number of elements kept, k unless the sequence was shorter
+        /// @note Li's Algorithm L: after the first k elements, jumps straight to the next element to be kept,
+        /// so that only O(k log(n / k)) random numbers are used
+        template <typename InputIterator, typename RandomAccessIterator>
+        size_t reservoir_sample(InputIterator first, InputIterator last, RandomAccessIterator reservoir, size_t k)
+        {
+            size_t filled = 0;
+            for (; filled < k && first != last; ++first, ++filled) {
+                reservoir[filled] = *first;
+            }
+            if (first == last || k == 0)
+                return filled;
+            // w is the largest of k uniform keys, elements are kept while their key is below it
+            real_t w = std::exp(std::log(open_unit()) / k);
+            while (true) {
+                real_t skip = std::floor(std::log(open_unit()) / std::log1p(-w));
+                for (uint64_t s = (skip < 9.2e18) ? uint64_t(skip) : uint64_t(9.2e18); s > 0 && first != last; s--) {
+                    ++first;
+                }
+                if (first == last)
+                    break;
+                reservoir[detail::uniform_index(derived(), k)] = *first;
+                ++first;
+                w *= std::exp(std::log(open_unit()) / k);
+            }
+            return k;
+        }
+    protected:
+        /// @brief Returns the RNG this interface is resolved against
+        Derived& derived()
+        {
+            return static_cast<Derived&>(*this);
+        }
+    private:
+        // Number of integers generated per block while filling buffers of other types
+        static constexpr size_t block_size = 256;
+        // Every integer of the RNG goes through these two, which count them per engine with DF_INSTRUMENT
+        T draw()
+        {
+#if defined(DF_INSTRUMENT)
+            const size_t site = derived().instrument_site();
+            detail::instrument::add(site, detail::instrument::count, 1);
+            detail::instrument::add(site, detail::instrument::calls, 1);
+#endif
+            return derived().generate();
+        }
+        void draw_block(T* out, size_t n)
+        {
+#if defined(DF_INSTRUMENT)
+            const size_t site = derived().instrument_site();
+            detail::instrument::add(site, detail::instrument::count, n);
+#if defined(DF_INSTRUMENT_CYCLES)
+            detail::instrument::Scope scope(site);
+#else
+            detail::instrument::add(site, detail::instrument::calls, 1);
+#endif
+#endif
+            derived().generate_block(out, n);
+        }
+        // Maps a random integer to [0, 1): the top 53 bits (or all the bits, if fewer) scaled by a power of two
+        static real_t to_unit(T x)
+        {
+            if constexpr (sizeof(T) * 8 > 53)
+                return real_t(x >> (sizeof(T) * 8 - 53)) * (1.0 / 9007199254740992.0);
+            else
+                return real_t(x) * (1.0 / real_t(uint64_t(1) << (sizeof(T) * 8)));
+        }
+        // sample() uses Floyd's algorithm when the sequence is at least this many times longer than the sample
+        static constexpr uint64_t floyd_ratio = 16;
+        // Returns a random real in (0, 1], safe to take the logarithm of
+        real_t open_unit()
+        {
+            return 1.0 - next_unit();
+        }
+        /// @brief Chooses k out of n positions in order (Vitter's Algorithm D, falling back to Algorithm A
+        /// once k is a large fraction of what is left)
+        /// @param select called with the number of positions skipped before each chosen one
+        template <typename Select>
+        void sequential_sample(uint64_t n, uint64_t k, Select select)
+        {
+            if (k == 0)
+                return;
+            // Algorithm D while n > 13 k, the point beyond which Algorithm A is faster
+            const real_t alpha_inv = 13;
+            real_t kr = real_t(k), nr = real_t(n), k_inv = 1.0 / kr;
+            real_t v = std::exp(std::log(open_unit()) * k_inv);
+            uint64_t q1 = n - k + 1;
+            real_t q1r = nr - kr + 1;
+            real_t threshold = alpha_inv * kr;
+            while (k > 1 && threshold < nr) {
+                real_t k1_inv = 1.0 / (kr - 1);
+                uint64_t s;
+                while (true) {
+                    // Step D2: propose a skip s from the approximating continuous distribution
+                    real_t x;
+                    while (true) {
+                        x = nr * (1.0 - v);
+                        s = uint64_t(x);
+                        if (s < q1)
+                            break;
+                        v = std::exp(std::log(open_unit()) * k_inv);
+                    }
+                    real_t u = open_unit(), sr = real_t(s);
+                    real_t y1 = std::exp(std::log(u * nr / q1r) * k1_inv);
+                    v = y1 * (1.0 - x / nr) * (q1r / (q1r - sr));
+                    if (v <= 1.0)
+                        break;
+                    // Step D3: exact acceptance test
+                    real_t y2 = 1.0, top = nr - 1, bottom;
+                    uint64_t limit;
+                    if (k - 1 > s) {
+                        bottom = nr - kr;
+                        limit = n - s;
+                    }
+                    else {
+                        bottom = nr - sr - 1;
+                        limit = q1;
+                    }
+                    for (uint64_t t = n - 1; t >= limit; t--) {
+                        y2 = (y2 * top) / bottom;
+                        top--;
+                        bottom--;
+                    }
+                    if (nr / (nr - x) >= y1 * std::exp(std::log(y2) * k1_inv)) {
+                        v = std::exp(std::log(open_unit()) * k1_inv);
+                        break;
+                    }
+                    v = std::exp(std::log(open_unit()) * k_inv);
+                }
+                select(s);
+                n -= s + 1;
+                nr -= real_t(s) + 1;
+                k--;
+                kr--;
+                k_inv = k1_inv;
+                q1 -= s;
+                q1r -= real_t(s);
+                threshold -= alpha_inv;
+            }
+            if (k == 1) {
+                select(uint64_t(nr * v) < n ? uint64_t(nr * v) : n - 1);
+                return;
+            }
+            // Algorithm A: the probability of skipping s positions is built up term by term
+            uint64_t top = n - k;
+            while (k >= 2) {
+                real_t u = next_unit(), quot = real_t(top) / real_t(n);
+                uint64_t s = 0;
+                while (quot > u) {
+                    s++;
+                    top--;
+                    n--;
+                    quot = quot * real_t(top) / real_t(n);
+                }
+                select(s);
+                n--;
+                k--;
+            }
+            select(detail::uniform_index(derived(), n));
+        }
+    };
+
+    /// @brief DiceForge::Generator<T> - A generic class for RNGs
+    /// @tparam T datatype of random number generated (RNG implementation specific)
+    /// @note Every RNG implemented in DiceForge is derived from this base class.
+    /// @note For writing your own RNG it is advisable to use this as the base class for compatibility with other features.
+    /// @note The state of every RNG of DiceForge can be saved and restored with save_state and load_state (see
+    /// DiceForge::Serializable), to checkpoint a long simulation and carry on from where it stopped.
+    template <typename T>
+    class Generator : public StaticGenerator<Generator<T>, T>, public Serializable<Generator<T>>
+    {
+        friend class StaticGenerator<Generator<T>, T>;
+        friend class Serializable<Generator<T>>;
+    public:
+        /// @brief Re-initializes the RNG with specified seed
+        /// @param seed seed provided for initialization
+        void reset_seed(T seed)
+        {
+            reseed(seed);
+        }
+        /// @brief Re-initializes the RNG from seed material of any length
+        /// @param seq seed material (see DiceForge::SeedSequence)
+        void reset_seed(const SeedSequence& seq)
+        {
+            reseed_from(seq);
+        }
+        /// @brief Advances the RNG as if steps random integers had been generated
+        /// @param steps number of random integers to skip
+        /// @note Takes O(log steps) time for most RNGs (see each RNG); the others discard steps integers one by one
+        void jump(uint64_t steps)
+        {
+            jump_ahead(steps);
+        }
+        /// @brief Whether jump takes much less time than generating the integers skipped
+        bool has_fast_jump() const
+        {
+            return fast_jump();
+        }
+        /// @brief Default destructor
+        virtual ~Generator() = default;
+#if defined(DF_INSTRUMENT)
+        /// @brief Index of the counters of this kind of RNG (see instrument::stats), registered on the first call
+        size_t instrument_site() const
+        {
+            return detail::instrument::engine_site(typeid(*this));
+        }
+#endif
+        /*** Note: These are the only functions to be implemented by the implementation RNG ***/
+    private:
+        /// @brief Should return a random integer generated by the RNG
+        virtual T generate() = 0;
+        /// @brief Should initialize the seed for the RNG
+        virtual void reseed(T seed) = 0;
+        /// @brief Should initialize the state of the RNG from the seed material
+        /// @note The default implementation reseeds with the first word of the sequence, the RNGs of DiceForge fill
+        /// their whole state from it
+        virtual void reseed_from(const SeedSequence& seq)
+        {
+            reseed(T(seq.word(0)));
+        }
+        /// @brief Should fill the buffer with n random integers generated by the RNG
+        /// @note The default implementation calls generate() n times, RNGs override it to produce whole blocks at once
+        virtual void generate_block(T* out, size_t n)
+        {
+            for (size_t i = 0; i < n; i++) {
+                out[i] = generate();
+            }
+        }
+        /// @brief Should advance the RNG as if steps random integers had been generated
+        /// @note The default implementation calls generate() steps times, RNGs override it to jump directly
+        virtual void jump_ahead(uint64_t steps)
+        {
+            for (uint64_t i = 0; i < steps; i++) {
+                generate();
+            }
+        }
+        /// @brief Should return true when jump_ahead does not discard the integers one by one
+        virtual bool fast_jump() const
+        {
+            return false;
+        }
+        /// @brief Should append the name of the RNG and its whole state to the saved state
+        /// @note The default implementation throws std::logic_error, RNGs that can be checkpointed override it
+        virtual void write_state(detail::StateWriter&) const
+        {
+            throw std::logic_error("This RNG cannot save its state");
+        }
+        /// @brief Should check the name written by write_state and restore the state that follows it
+        /// @note Overrides read the whole state and call StateReader::end() before changing the RNG
+        virtual void read_state(detail::StateReader&)
+        {
+            throw std::logic_error("This RNG cannot restore its state");
+        }
+    };
+
+    /// @brief DiceForge::StaticView<Engine> - A non-virtual view of a concrete RNG (like MT64 or XORShift64)
+    /// @tparam Engine RNG derived from Generator<T> (it must declare StaticView<Engine> as a friend)
+    /// @note All calls are resolved at compile time, so templated code using the view (and the distributions)
+    /// can inline the RNG into its loops. The view shares the state of the RNG it was made from.
+    template <typename Engine>
+    class StaticView : public StaticGenerator<StaticView<Engine>, typename Engine::result_type>
+    {
+        typedef typename Engine::result_type T;
+        friend class StaticGenerator<StaticView<Engine>, T>;
+    public:
+        /// @brief Creates a view of the given RNG
+        /// @param engine RNG to be viewed, it must outlive the view
+        explicit StaticView(Engine& engine) : engine(engine) {}
+        /// @brief Re-initializes the viewed RNG with specified seed
+        /// @param seed seed provided for initialization
+        void reset_seed(T seed)
+        {
+            engine.reset_seed(seed);
+        }
+        /// @brief Re-initializes the viewed RNG from seed material of any length
+        /// @param seq seed material (see DiceForge::SeedSequence)
+        void reset_seed(const SeedSequence& seq)
+        {
+            engine.reset_seed(seq);
+        }
+        /// @brief Advances the viewed RNG as if steps random integers had been generated
+        /// @param steps number of random integers to skip
+        void jump(uint64_t steps)
+        {
+            engine.jump(steps);
+        }
+    private:
+        Engine& engine;
+#if defined(DF_INSTRUMENT)
+        // The viewed RNG is counted as itself
+        size_t instrument_site()
+        {
+            return engine.instrument_site();
+        }
+#endif
+        // Qualified calls bypass the vtable of the viewed RNG
+        T generate()
+        {
+            return engine.Engine::generate();
+        }
+        void generate_block(T* out, size_t n)
+        {
+            engine.Engine::generate_block(out, n);
+        }
+    };
+
+    /// @brief Returns a non-virtual view of the given RNG (see DiceForge::StaticView)
+    /// @param engine RNG to be viewed, it must outlive the view
+    template <typename Engine>
+    StaticView<Engine> make_static(Engine& engine)
+    {
+        return StaticView<Engine>(engine);
+    }
+
+    /// @brief Splits the stream of the given RNG into k substreams, e.g. one per worker thread
+    /// @param engine RNG whose stream is split (it is not modified)
+    /// @param k number of substreams
+    /// @param stride distance between the starts of consecutive substreams (2^64 / k by default)
+    /// @returns k copies of the RNG, the i-th one jumped ahead by i * stride random integers
+    /// @note The substreams do not overlap as long as each one is used for at most stride random integers
+    /// and k * stride does not exceed the period of the RNG
+    /// @note Throws std::invalid_argument for an RNG without a fast jump (MT32, the plain Blum Blum Shub) and a stride
+    /// above 2^30, which includes the default one, as the RNG would discard the whole stride
+    template <typename Engine>
+    std::vector<Engine> split(const Engine& engine, size_t k, uint64_t stride = 0)
+    {
+        if (k == 0)
+            throw std::invalid_argument("Expected k > 0");
+        if (stride == 0)
+            stride = std::numeric_limits<uint64_t>::max() / k;
+        if (k > 1)
+            detail::check_jump(engine, stride);
+        std::vector<Engine> streams;
+        streams.reserve(k);
+        streams.push_back(engine);
+        for (size_t i = 1; i < k; i++) {
+            streams.push_back(streams.back());
+            streams.back().jump(stride);
+        }
+        return streams;
+    }
+
+    /// @brief Shuffles a range in place on several threads
+    /// @param first iterator to the first element
+    /// @param last iterator past the last element
+    /// @param engine RNG whose stream is split among the threads (it is not modified)
+    /// @param threads maximum number of threads (the hardware concurrency by default)
+    /// @note Blocks are shuffled on their own threads and then merged pairwise at random (MergeShuffle),
+    /// every permutation being equally likely. The result is reproducible for a given RNG, range and
+    /// number of threads.
+    /// @note The RNG is split with DiceForge::split, so it must have a fast jump (any engine but the
+    /// plain Blum Blum Shub and MT32, which throw std::invalid_argument)
+    template <typename RandomAccessIterator, typename Engine>
+    void parallel_shuffle(RandomAccessIterator first, RandomAccessIterator last, const Engine& engine, size_t threads = 0)
+    {
+        if (threads == 0)
+            threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        const size_t n = size_t(last - first);
+        // A power of two number of blocks, k, merged over log2(k) rounds
+        size_t k = 1;
+        while (k < threads && n / (2 * k) >= detail::parallel_shuffle_block)
+            k *= 2;
+
+        std::vector<Engine> streams = split(engine, 2 * k - 1);
+        std::vector<size_t> bounds(k + 1);
+        for (size_t b = 0; b <= k; b++)
+            bounds[b] = size_t(uint128_t(n) * b / k);
+
+        auto run = [](size_t tasks, const auto& task) {
+            std::vector<std::thread> pool;
+            for (size_t t = 1; t < tasks; t++)
+                pool.emplace_back(task, t);
+            task(0);
+            for (auto& thread : pool)
+                thread.join();
+        };
+
+        run(k, [&](size_t b) {
+            streams[b].shuffle(first + bounds[b], first + bounds[b + 1]);
+        });
+        for (size_t width = 1, s = k; width < k; s += k / (2 * width), width *= 2) {
+            run(k / (2 * width), [&, width, s](size_t p) {
+                detail::merge_shuffled(first + bounds[2 * p * width], first + bounds[(2 * p + 1) * width],
+                                       first + bounds[(2 * p + 2) * width], streams[s + p]);
+            });
+        }
+    }
+}
+
+#endif
+
+// src/Core/streams.h
+
+/***STREAM PLANS***/
+/*the random streams of a run spread over many machines and threads, derived
+from one root seed and the key of each stream with no coordination between
+them: counter-based engines get the key as their stream index, the others
+jump ahead to a slice of their period of their own*/
+
+#ifndef DF_STREAMS_H
+#define DF_STREAMS_H
+
+#include <cstddef>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+
+
+namespace DiceForge
+{
+    /// @brief DiceForge::StreamKey - The coordinates of a stream in a run
+    /// @note For results that do not depend on the number of machines, node and thread should name shards of the
+    /// work rather than the machines and threads themselves (see StreamPlan::shards)
+    struct StreamKey
+    {
+        uint64_t job = 0;       // Run, or simulation, sharing the root seed
+        uint64_t node = 0;      // Shard of the job
+        uint64_t thread = 0;    // Part of the shard
+        uint64_t substream = 0; // Stream of the part, e.g. one per kind of draw
+    };
+
+    /// @brief DiceForge::StreamPlan - Derives the engines of every stream of a run from one root seed and the key of
+    /// the stream, the same on every machine
+    /// @note The node, thread and substream of a key are packed into a stream index of node_bits + thread_bits +
+    /// substream_bits bits (at most 64). A counter-based engine (Philox) is keyed with SeedSequence{root, job} and
+    /// takes the index as its stream, giving each stream 2^64 blocks of its own. Any other engine is seeded with
+    /// SeedSequence{root, job} and jumped ahead by index * 2^stride_bits(), the remaining bits: its streams are
+    /// disjoint as long as each one draws at most 2^stride_bits() integers and the period of the engine is at least
+    /// 2^64 (not so for the 32-bit XORShift and LFSR), and should have a fast jump (not Blum Blum Shub or MT32; the
+    /// jump of MT64 takes a fraction of a second, that of XORShift64 a microsecond and Philox none at all).
+    /// Distinct jobs are distinct seeds. The plan is saved and restored with save_state and load_state.
+    class StreamPlan : public Serializable<StreamPlan>
+    {
+        friend class Serializable<StreamPlan>;
+    private:
+        uint64_t m_root;
+        unsigned m_node_bits, m_thread_bits, m_substream_bits;
+        void write_state(detail::StateWriter& out) const;
+        void read_state(detail::StateReader& in);
+        // Engines taking a stream index next to their seed and seeking to any element of it
+        template <typename Engine, typename = void>
+        struct counter_based : std::false_type {};
+        template <typename Engine>
+        struct counter_based<Engine, std::void_t<decltype(std::declval<Engine&>().seek(uint64_t(0)))>>
+            : std::is_constructible<Engine, typename Engine::result_type, uint64_t> {};
+    public:
+        /// @brief A plan for the streams of the given root seed
+        /// @param root seed shared by every machine of the run
+        /// @param node_bits, thread_bits, substream_bits widths of the coordinates of a key in the stream index
+        /// @note Throws std::invalid_argument when the widths add up to more than 64
+        explicit StreamPlan(uint64_t root, unsigned node_bits = 16, unsigned thread_bits = 8, unsigned substream_bits = 8);
+
+        /// @brief Returns the root seed
+        uint64_t root() const;
+        /// @brief Returns the stream index of the key, (node, thread, substream) packed from the highest bits down
+        /// @note Throws std::out_of_range when a coordinate does not fit in its width
+        uint64_t index(const StreamKey& key) const;
+        /// @brief Returns log2 of the number of integers between the starts of consecutive jumped streams
+        unsigned stride_bits() const;
+        /// @brief Returns the seed material of all the streams of a job
+        SeedSequence job_seed(uint64_t job) const;
+        /// @brief Returns seed material of the key alone, SeedSequence{root, job, node, thread, substream}
+        /// @note For engines without a fast jump: engine.reset_seed(plan.seed(key)) gives streams that are
+        /// independent seedings, though not provably disjoint
+        SeedSequence seed(const StreamKey& key) const;
+
+        /// @brief Returns the engine of the stream of the given key
+        /// @tparam Engine RNG constructible from a seed (for instance MT64, XORShift64 or Philox)
+        /// @note Throws std::invalid_argument when an RNG without a fast jump would discard more than 2^30 integers
+        template <typename Engine>
+        Engine engine(const StreamKey& key) const
+        {
+            const uint64_t i = index(key);
+            typedef typename Engine::result_type T;
+            if constexpr (counter_based<Engine>::value) {
+                Engine rng(T(0), i);
+                rng.reset_seed(job_seed(key.job));
+                return rng;
+            }
+            else {
+                Engine rng(T(0));
+                rng.reset_seed(job_seed(key.job));
+                if (i != 0) {
+                    detail::check_jump(rng, uint128_t(i) << stride_bits());
+                    rng.jump(i << stride_bits());
+                }
+                return rng;
+            }
+        }
+
+        /// @brief Returns the range [first, last) of the shards 0 to count - 1 handled by node of nodes
+        /// @note Consecutive nodes get consecutive ranges, of sizes differing by at most one
+        static std::pair<uint64_t, uint64_t> shards(uint64_t count, uint64_t node, uint64_t nodes);
+    };
+}
+
+#endif
+
+// src/Core/table.h
+
+#ifndef DF_TABLE_H
+#define DF_TABLE_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+
+namespace DiceForge
+{
+    /// @brief DiceForge::TableFile - A file of precomputed sampling tables, mapped read-only into memory
+    /// @note A table file is the magic "DFtb", a version byte, the size of real_t and a byte order mark, the name
+    /// of the distribution that wrote it and a directory of arrays, each stored in the representation of the
+    /// machine at an offset aligned to 64 bytes, so that a distribution samples straight from the mapping. The
+    /// pages are shared through the page cache by every process mapping the same file, and are only read in as
+    /// they are used. Only the header and the directory are checked on opening (std::invalid_argument if they do
+    /// not fit the file or this machine), not the values of the arrays.
+    class TableFile
+    {
+    private:
+        const unsigned char* data = nullptr;
+        size_t length = 0;
+        // The copy read into memory where files cannot be mapped
+        std::vector<unsigned char> buffer;
+        struct Entry
+        {
+            size_t offset, count, element;
+        };
+        std::vector<Entry> directory;
+        std::string m_name;
+    public:
+        /// @brief Maps the table file at path (std::runtime_error if it cannot be opened)
+        explicit TableFile(const std::string& path);
+        ~TableFile();
+        TableFile(const TableFile&) = delete;
+        TableFile& operator=(const TableFile&) = delete;
+
+        /// @brief Name of the distribution that wrote the tables
+        const std::string& name() const;
+        /// @brief Throws std::invalid_argument unless the tables were written by the named distribution
+        void expect(const char* distribution) const;
+        /// @brief Number of arrays in the file
+        size_t arrays() const;
+        /// @brief Array k of the file, as a pointer into the mapping and its number of elements
+        /// @note std::out_of_range if there is no array k, std::invalid_argument if its elements are not of type U
+        template <typename U>
+        std::pair<const U*, size_t> array(size_t k) const
+        {
+            const Entry& e = entry(k, sizeof(U));
+            return {reinterpret_cast<const U*>(data + e.offset), e.count};
+        }
+    private:
+        const Entry& entry(size_t k, size_t element) const;
+    };
+
+    namespace detail
+    {
+        // Table files start with the magic "DFtb" and a version byte, then a 64 byte header and the directory
+        constexpr unsigned char table_magic[4] = {'D', 'F', 't', 'b'};
+        constexpr unsigned char table_version = 1;
+        constexpr size_t table_header = 64;
+        constexpr size_t table_alignment = 64;
+
+        /// @brief Collects the arrays of a table file and writes it
+        class TableWriter
+        {
+        private:
+            std::string name;
+            struct Array
+            {
+                std::vector<unsigned char> bytes;
+                size_t count, element;
+            };
+            std::vector<Array> arrays;
+        public:
+            /// @brief Tables of the named distribution (at most 31 characters)
+            explicit TableWriter(const char* name);
+            /// @brief Appends an array of n values, which will be array arrays() - 1 of the file
+            template <typename U>
+            void add(const U* values, size_t n)
+            {
+                const unsigned char* p = reinterpret_cast<const unsigned char*>(values);
+                arrays.push_back({std::vector<unsigned char>(p, p + n * sizeof(U)), n, sizeof(U)});
+            }
+            /// @brief Writes the file, to a temporary name first and then renamed to path, so that a process
+            /// mapping path never sees it half written (std::runtime_error if it cannot be written)
+            void write(const std::string& path) const;
+        };
+
+        /// @brief A read-only array of a sampling table, held in memory or read in place from a TableFile
+        /// @note Copies share the values (and keep the file mapped) rather than copy them
+        template <typename U>
+        class TableArray
+        {
+        private:
+            std::shared_ptr<const void> owner;
+            const U* p = nullptr;
+            size_t n = 0;
+        public:
+            TableArray() = default;
+            /// @brief Takes over the values of a vector
+            explicit TableArray(std::vector<U>&& values)
+            {
+                auto held = std::make_shared<const std::vector<U>>(std::move(values));
+                p = held->data();
+                n = held->size();
+                owner = std::move(held);
+            }
+            /// @brief Array k of a mapped file
+            TableArray(const std::shared_ptr<const TableFile>& file, size_t k)
+            {
+                std::pair<const U*, size_t> a = file->template array<U>(k);
+                p = a.first;
+                n = a.second;
+                owner = file;
+            }
+            const U& operator[](size_t i) const
+            {
+                return p[i];
+            }
+            const U* data() const
+            {
+                return p;
+            }
+            size_t size() const
+            {
+                return n;
+            }
+            bool empty() const
+            {
+                return n == 0;
+            }
+        };
+    }
+}
+
+#endif
+
+// src/Core/polar.h
+
+/***MARSAGLIA'S POLAR METHOD***/
+/*a point drawn uniformly in the unit disc, scaled by sqrt(-2 log(s) / s) where
+s is its squared distance from the centre, gives two independent standard
+normals for one logarithm and one square root, without any trigonometry*/
+
+#ifndef DF_POLAR_H
+#define DF_POLAR_H
+
+#include <utility>
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+
+namespace DiceForge
+{
+    namespace polar
+    {
+        /// @brief Returns a pair of independent standard normal variates
+        template <typename Derived, typename T>
+        std::pair<real_t, real_t> normal_pair(StaticGenerator<Derived, T>& rng)
+        {
+            real_t u, v, s;
+            DF_INSTRUMENT_METHOD("polar", 2);
+            do {
+                u = 2 * rng.next_unit() - 1;
+                v = 2 * rng.next_unit() - 1;
+                s = u * u + v * v;
+                if (s >= 1 || s == 0)
+                    DF_INSTRUMENT_METHOD_REJECT("polar");
+            } while (s >= 1 || s == 0);
+            real_t f = std::sqrt(-2.0 * std::log(s) / s);
+            return std::make_pair(u * f, v * f);
+        }
+    }
+}
+
+#endif
+
+// src/Core/ziggurat.h
+
+/***ZIGGURAT SAMPLERS***/
+/*the density is covered by 256 horizontal layers of equal area, so a random
+layer and a random point across it are accepted straight away unless the point
+falls in the part of the layer overhanging the curve (Marsaglia and Tsang)*/
+
+#ifndef DF_ZIGGURAT_H
+#define DF_ZIGGURAT_H
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+
+namespace DiceForge
+{
+    namespace ziggurat
+    {
+        // Number of layers, the index of a layer is read from the low bits of a random integer
+        constexpr int layers = 256;
+
+        /// @brief Layer edges x[0] > x[1] > ... > x[layers] = 0 and the density f[i] at x[i]
+        /// @note Layer i spans [0, x[i]) and lies between heights f[i] and f[i + 1], x[1] is where the tail
+        /// starts and x[0] is the width the base layer would have if the tail were a rectangle
+        struct Tables
+        {
+            real_t x[layers + 1];
+            real_t f[layers + 1];
+        };
+
+        /// @brief Tables for the standard normal density exp(-x^2 / 2)
+        const Tables& normal();
+        /// @brief Tables for the standard exponential density exp(-x)
+        const Tables& exponential();
+
+        /// @brief The layer edges of Tables in single precision, for the float samplers
+        struct FloatTables
+        {
+            float x[layers + 1];
+        };
+
+        /// @brief normal().x in single precision
+        const FloatTables& normal_float();
+        /// @brief exponential().x in single precision
+        const FloatTables& exponential_float();
+
+        // Variates drawn at a time by the float samplers
+        constexpr size_t float_block = 256;
+
+        /// @brief Returns a standard normal variate
+        template <typename Derived, typename T>
+        real_t next_normal(StaticGenerator<Derived, T>& rng)
+        {
+            const Tables& t = normal();
+            DF_INSTRUMENT_METHOD("ziggurat normal", 1);
+            while (true) {
+                // Bits 0-7 pick the layer, bit 8 the sign and the top 53 bits the position across the layer
+                uint64_t bits = detail::bits64(rng);
+                int i = int(bits & 0xFF);
+                real_t x = real_t(bits >> 11) * (1.0 / 9007199254740992.0) * t.x[i];
+                real_t sign = (bits & 0x100) ? -1.0 : 1.0;
+                if (x < t.x[i + 1])
+                    return sign * x;
+                if (i == 0) {
+                    // Tail beyond x[1], by Marsaglia's method
+                    real_t r = t.x[1], a, b;
+                    do {
+                        a = -std::log(1.0 - rng.next_unit()) / r;
+                        b = -std::log(1.0 - rng.next_unit());
+                        if (2 * b < a * a)
+                            DF_INSTRUMENT_METHOD_REJECT("ziggurat normal");
+                    } while (2 * b < a * a);
+                    return sign * (r + a);
+                }
+                if (t.f[i] + rng.next_unit() * (t.f[i + 1] - t.f[i]) < std::exp(-0.5 * x * x))
+                    return sign * x;
+                DF_INSTRUMENT_METHOD_REJECT("ziggurat normal");
+            }
+        }
+
+        /// @brief Returns a standard exponential variate
+        template <typename Derived, typename T>
+        real_t next_exponential(StaticGenerator<Derived, T>& rng)
+        {
+            const Tables& t = exponential();
+            DF_INSTRUMENT_METHOD("ziggurat exponential", 1);
+            while (true) {
+                uint64_t bits = detail::bits64(rng);
+                int i = int(bits & 0xFF);
+                real_t x = real_t(bits >> 11) * (1.0 / 9007199254740992.0) * t.x[i];
+                if (x < t.x[i + 1])
+                    return x;
+                if (i == 0) {
+                    // The tail beyond x[1] is the distribution itself, shifted
+                    return t.x[1] - std::log(1.0 - rng.next_unit());
+                }
+                if (t.f[i] + rng.next_unit() * (t.f[i + 1] - t.f[i]) < std::exp(-x))
+                    return x;
+                DF_INSTRUMENT_METHOD_REJECT("ziggurat exponential");
+            }
+        }
+
+        /// @brief Fills the buffer with standard normal variates in single precision
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @param out Pointer to the first element of the buffer
+        /// @param n Number of variates to be written
+        /// @note A candidate takes 32 random bits (two per 64-bit integer, see fill_fixed): bits 0-7 pick the
+        /// layer, bit 8 the sign and the top 23 the position across the layer. The candidates of a block are
+        /// computed without branches, then the few outside the inner part of their layer go through the wedge or
+        /// tail test, and are redrawn in double precision by next_normal when they fail it.
+        template <typename Derived, typename T>
+        void fill_normal(StaticGenerator<Derived, T>& rng, float* out, size_t n)
+        {
+            const Tables& t = normal();
+            const FloatTables& ft = normal_float();
+            uint32_t bits[float_block];
+            DF_INSTRUMENT_METHOD("ziggurat normal float", n);
+            while (n > 0) {
+                size_t m = std::min(n, float_block);
+                rng.fill_fixed(bits, m);
+                for (size_t j = 0; j < m; j++) {
+                    // 1 - 2 * (bit 8) rather than a branch on the sign, which would be mispredicted half the time
+                    float sign = 1.0f - float((bits[j] >> 7) & 2);
+                    out[j] = sign * float(bits[j] >> 9) * (1.0f / 8388608.0f) * ft.x[bits[j] & 0xFF];
+                }
+                for (size_t j = 0; j < m; j++) {
+                    int i = int(bits[j] & 0xFF);
+                    real_t x = std::fabs(out[j]);
+                    if (x < ft.x[i + 1])
+                        continue;
+                    if (i == 0) {
+                        real_t r = t.x[1], a, b;
+                        do {
+                            a = -std::log(1.0 - rng.next_unit()) / r;
+                            b = -std::log(1.0 - rng.next_unit());
+                            if (2 * b < a * a)
+                                DF_INSTRUMENT_METHOD_REJECT("ziggurat normal float");
+                        } while (2 * b < a * a);
+                        // The candidate is past x[1] > 0, so it still carries the sign
+                        out[j] = std::copysign(float(r + a), out[j]);
+                    }
+                    else if (!(t.f[i] + rng.next_unit() * (t.f[i + 1] - t.f[i]) < std::exp(-0.5 * x * x))) {
+                        DF_INSTRUMENT_METHOD_REJECT("ziggurat normal float");
+                        out[j] = float(next_normal(rng));
+                    }
+                }
+                out += m;
+                n -= m;
+            }
+        }
+
+        /// @brief Fills the buffer with standard exponential variates in single precision
+        /// @note As fill_normal, with bits 0-7 picking the layer and the top 24 the position across it
+        template <typename Derived, typename T>
+        void fill_exponential(StaticGenerator<Derived, T>& rng, float* out, size_t n)
+        {
+            const Tables& t = exponential();
+            const FloatTables& ft = exponential_float();
+            uint32_t bits[float_block];
+            DF_INSTRUMENT_METHOD("ziggurat exponential float", n);
+            while (n > 0) {
+                size_t m = std::min(n, float_block);
+                rng.fill_fixed(bits, m);
+                for (size_t j = 0; j < m; j++)
+                    out[j] = float(bits[j] >> 8) * (1.0f / 16777216.0f) * ft.x[bits[j] & 0xFF];
+                for (size_t j = 0; j < m; j++) {
+                    int i = int(bits[j] & 0xFF);
+                    real_t x = out[j];
+                    if (x < ft.x[i + 1])
+                        continue;
+                    if (i == 0)
+                        out[j] = float(t.x[1] - std::log(1.0 - rng.next_unit()));
+                    else if (!(t.f[i] + rng.next_unit() * (t.f[i + 1] - t.f[i]) < std::exp(-x))) {
+                        DF_INSTRUMENT_METHOD_REJECT("ziggurat exponential float");
+                        out[j] = float(next_exponential(rng));
+                    }
+                }
+                out += m;
+                n -= m;
+            }
+        }
+    }
+}
+
+#endif
+
+// src/Core/process.h
+
+/***STOCHASTIC PROCESSES***/
+/*processes that keep their state between calls, so that a path of any length
+is generated block by block into the buffers of the caller: arrival times of
+Poisson processes, and many independent paths of random walks, geometric
+Brownian motions and Ornstein-Uhlenbeck processes advanced side by side*/
+
+#ifndef DF_PROCESS_H
+#define DF_PROCESS_H
+
+#include <vector>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+
+
+namespace DiceForge
+{
+    /// @brief DiceForge::PoissonProcess - Arrival times of a homogeneous Poisson process of the given rate
+    /// @note The time of the last arrival is kept between calls, and can be saved with save_state
+    class PoissonProcess : public Serializable<PoissonProcess>
+    {
+        friend class Serializable<PoissonProcess>;
+    private:
+        real_t m_rate, inv_rate, t;
+        void write_state(detail::StateWriter& out) const;
+        void read_state(detail::StateReader& in);
+    public:
+        /// @brief A process of rate events per unit of time, started at time start
+        /// @note rate > 0
+        explicit PoissonProcess(real_t rate, real_t start = 0);
+
+        /// @brief Returns the time of the next arrival
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        template <typename Derived, typename T>
+        real_t next(StaticGenerator<Derived, T>& rng)
+        {
+            t += ziggurat::next_exponential(rng) * inv_rate;
+            return t;
+        }
+        /// @brief Writes the times of the next n arrivals
+        template <typename Derived, typename T>
+        void sample(StaticGenerator<Derived, T>& rng, real_t* times, size_t n)
+        {
+            for (size_t i = 0; i < n; i++)
+                times[i] = next(rng);
+        }
+        /// @brief Writes the times of the next arrivals before end, at most capacity of them, and returns their number
+        /// @note When fewer than capacity are written the process has reached end, and goes on from there; otherwise
+        /// call again for the rest. A gap drawn past end is dropped, which leaves the distribution of the arrivals
+        /// unchanged as the gaps are memoryless.
+        template <typename Derived, typename T>
+        size_t sample_until(StaticGenerator<Derived, T>& rng, real_t end, real_t* times, size_t capacity)
+        {
+            size_t count = 0;
+            while (count < capacity) {
+                const real_t candidate = t + ziggurat::next_exponential(rng) * inv_rate;
+                if (candidate >= end) {
+                    t = end;
+                    break;
+                }
+                t = candidate;
+                times[count++] = t;
+            }
+            return count;
+        }
+        /// @brief Time of the last arrival (or the start)
+        real_t time() const;
+        /// @brief Restarts the process at the given time
+        void reset(real_t start = 0);
+        /// @brief Rate of the arrivals
+        real_t rate() const;
+    };
+
+    /// @brief DiceForge::InhomogeneousPoissonProcess - Arrival times of a Poisson process whose rate varies in time
+    /// @note Thinning (Lewis and Shedler): the arrivals of a homogeneous process of rate bound are kept with
+    /// probability intensity(t) / bound, so the cost per arrival is bound over the mean intensity
+    class InhomogeneousPoissonProcess
+    {
+    private:
+        std::function<real_t(real_t)> intensity;
+        real_t m_bound, inv_bound, t;
+        // Whether the candidate at time t is kept, given a uniform u
+        bool keep(real_t u) const
+        {
+            const real_t rate = intensity(t);
+            if (!(rate <= m_bound))
+                throw std::invalid_argument("The intensity exceeds its bound!");
+            return u * m_bound < rate;
+        }
+    public:
+        /// @brief A process of instantaneous rate intensity(t), started at time start
+        /// @param intensity rate of the arrivals at time t, between 0 and bound
+        /// @param bound upper bound of the intensity (> 0), the rate of the candidates
+        /// @note std::invalid_argument is thrown when the intensity is found above its bound
+        template <typename Function>
+        InhomogeneousPoissonProcess(Function intensity, real_t bound, real_t start = 0)
+            : intensity(intensity), m_bound(bound), inv_bound(1 / bound), t(start)
+        {
+            if (!(bound > 0) || !std::isfinite(bound))
+                throw std::invalid_argument("The bound of the intensity must be positive and finite!");
+        }
+        /// @brief Returns the time of the next arrival
+        template <typename Derived, typename T>
+        real_t next(StaticGenerator<Derived, T>& rng)
+        {
+            DF_INSTRUMENT_METHOD("thinning", 1);
+            while (true) {
+                t += ziggurat::next_exponential(rng) * inv_bound;
+                if (keep(rng.next_unit()))
+                    return t;
+                DF_INSTRUMENT_METHOD_REJECT("thinning");
+            }
+        }
+        /// @brief Writes the times of the next n arrivals
+        template <typename Derived, typename T>
+        void sample(StaticGenerator<Derived, T>& rng, real_t* times, size_t n)
+        {
+            for (size_t i = 0; i < n; i++)
+                times[i] = next(rng);
+        }
+        /// @brief Writes the times of the next arrivals before end, at most capacity of them, and returns their number
+        /// @note As PoissonProcess::sample_until
+        template <typename Derived, typename T>
+        size_t sample_until(StaticGenerator<Derived, T>& rng, real_t end, real_t* times, size_t capacity)
+        {
+            size_t count = 0;
+            while (count < capacity) {
+                const real_t candidate = t + ziggurat::next_exponential(rng) * inv_bound;
+                if (candidate >= end) {
+                    t = end;
+                    break;
+                }
+                t = candidate;
+                if (keep(rng.next_unit())) {
+                    DF_INSTRUMENT_METHOD("thinning", 1);
+                    times[count++] = t;
+                }
+                else
+                    DF_INSTRUMENT_METHOD_REJECT("thinning");
+            }
+            return count;
+        }
+        /// @brief Time of the last candidate (or the start)
+        real_t time() const
+        {
+            return t;
+        }
+        /// @brief Restarts the process at the given time
+        void reset(real_t start = 0)
+        {
+            t = start;
+        }
+    };
+
+    namespace detail
+    {
+        /// @brief The paths of a process advanced side by side, a step at a time of all the paths
+        /// @tparam Derived class providing step(z), which replaces the standard normal variates z[p] with the
+        /// values of the paths p after one more step and stores them in the state
+        template <typename Derived>
+        class PathProcess
+        {
+        protected:
+            // The current value of every path, and the number of steps taken
+            std::vector<real_t> state;
+            uint64_t m_steps = 0;
+            PathProcess(size_t paths, real_t x0) : state(paths, x0)
+            {
+                if (paths == 0)
+                    throw std::invalid_argument("Expected at least one path!");
+            }
+            ~PathProcess() = default;
+        public:
+            /// @brief Number of paths
+            size_t paths() const
+            {
+                return state.size();
+            }
+            /// @brief The current values of the paths
+            const real_t* values() const
+            {
+                return state.data();
+            }
+            /// @brief Number of steps taken since construction (or the last reset)
+            uint64_t steps() const
+            {
+                return m_steps;
+            }
+            /// @brief Restarts every path at x0
+            void reset(real_t x0)
+            {
+                std::fill(state.begin(), state.end(), x0);
+                m_steps = 0;
+            }
+            /// @brief Advances every path by the given number of steps, writing the values along the way
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param out steps rows of paths() values: out[s paths() + p] is path p after s + 1 more steps
+            /// @note The paths resume where the last call left them, so a long simulation can be streamed
+            /// through a buffer of a few steps. Each step draws paths() standard normals and updates the paths
+            /// in one pass over SIMD lanes.
+            template <typename D, typename T>
+            void advance(StaticGenerator<D, T>& rng, real_t* out, size_t steps)
+            {
+                const size_t n = state.size();
+                for (size_t s = 0; s < steps; s++) {
+                    real_t* row = out + s * n;
+                    for (size_t p = 0; p < n; p++)
+                        row[p] = ziggurat::next_normal(rng);
+                    static_cast<Derived*>(this)->step(row);
+                }
+                m_steps += steps;
+            }
+            /// @brief Advances every path by the given number of steps, keeping only their final values
+            template <typename D, typename T>
+            void advance(StaticGenerator<D, T>& rng, size_t steps)
+            {
+                std::vector<real_t> row(state.size());
+                for (size_t s = 0; s < steps; s++)
+                    advance(rng, row.data(), 1);
+            }
+        };
+    }
+
+    /// @brief DiceForge::GaussianRandomWalk - Independent random walks with normal steps of mean mu and deviation sigma
+    /// @note x_(k+1) = x_k + mu + sigma z; the state (the paths and the parameters) can be saved with save_state
+    class GaussianRandomWalk : public detail::PathProcess<GaussianRandomWalk>, public Serializable<GaussianRandomWalk>
+    {
+        friend class detail::PathProcess<GaussianRandomWalk>;
+        friend class Serializable<GaussianRandomWalk>;
+    private:
+        real_t mu, sigma;
+        void step(real_t* z);
+        void write_state(detail::StateWriter& out) const;
+        void read_state(detail::StateReader& in);
+    public:
+        /// @brief paths walks started at x0, with steps of mean mu and standard deviation sigma (>= 0)
+        GaussianRandomWalk(size_t paths, real_t mu, real_t sigma, real_t x0 = 0);
+    };
+
+    /// @brief DiceForge::GeometricBrownianMotion - Independent paths of dS = mu S dt + sigma S dW sampled every dt
+    /// @note Exact in distribution at the sampled times: S_(k+1) = S_k exp((mu - sigma^2 / 2) dt + sigma sqrt(dt) z),
+    /// with the exponential over SIMD lanes; the state can be saved with save_state
+    class GeometricBrownianMotion : public detail::PathProcess<GeometricBrownianMotion>,
+                                    public Serializable<GeometricBrownianMotion>
+    {
+        friend class detail::PathProcess<GeometricBrownianMotion>;
+        friend class Serializable<GeometricBrownianMotion>;
+    private:
+        real_t mu, sigma, dt;
+        // Drift and volatility of the logarithm over one step
+        real_t drift, volatility;
+        void step(real_t* z);
+        void write_state(detail::StateWriter& out) const;
+        void read_state(detail::StateReader& in);
+    public:
+        /// @brief paths motions started at s0 (> 0), of drift mu and volatility sigma (>= 0), with steps of dt (> 0)
+        GeometricBrownianMotion(size_t paths, real_t s0, real_t mu, real_t sigma, real_t dt);
+    };
+
+    /// @brief DiceForge::OrnsteinUhlenbeck - Independent paths of dX = theta (mu - X) dt + sigma dW sampled every dt
+    /// @note Exact in distribution at the sampled times: X_(k+1) = mu + (X_k - mu) e^(-theta dt)
+    /// + sigma sqrt((1 - e^(-2 theta dt)) / (2 theta)) z, whatever the step; the state can be saved with save_state
+    class OrnsteinUhlenbeck : public detail::PathProcess<OrnsteinUhlenbeck>, public Serializable<OrnsteinUhlenbeck>
+    {
+        friend class detail::PathProcess<OrnsteinUhlenbeck>;
+        friend class Serializable<OrnsteinUhlenbeck>;
+    private:
+        real_t theta, mu, sigma, dt;
+        // Decay of the distance to mu and deviation of the noise over one step
+        real_t decay, deviation;
+        void step(real_t* z);
+        void write_state(detail::StateWriter& out) const;
+        void read_state(detail::StateReader& in);
+    public:
+        /// @brief paths processes started at x0, reverting to mu at the rate theta (> 0), of volatility sigma (>= 0),
+        /// with steps of dt (> 0)
+        OrnsteinUhlenbeck(size_t paths, real_t theta, real_t mu, real_t sigma, real_t dt, real_t x0 = 0);
+        /// @brief Standard deviation of the stationary distribution, sigma / sqrt(2 theta)
+        real_t stationary_deviation() const;
+    };
+}
+
+#endif
+
+// src/Core/geometry.h
+
+/***GEOMETRIC SAMPLING***/
+/*points drawn uniformly on or in the usual shapes of Monte Carlo rendering and
+particle emission, written as separate arrays of coordinates (x[i], y[i], z[i]
+being point i), so that a batch is a few passes of vector arithmetic over the
+uniforms of fill_unit*/
+
+#ifndef DF_GEOMETRY_H
+#define DF_GEOMETRY_H
+
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace DiceForge
+{
+    namespace geometry
+    {
+        /// @brief The transforms of the samplers below, turning the uniforms already written in the arrays into
+        /// points in place (for circle, x holds the angles; for disk and cosine_hemisphere, x the squared radii and
+        /// y the angles; for sphere and hemisphere, z the heights and x the angles)
+        /// @note Over SIMD lanes where available, with the sines and cosines of simd::sincos_turn
+        void circle_from_unit(real_t* x, real_t* y, size_t n);
+        void disk_from_unit(real_t* x, real_t* y, size_t n);
+        void sphere_from_unit(real_t* x, real_t* y, real_t* z, size_t n);
+        void hemisphere_from_unit(real_t* x, real_t* y, real_t* z, size_t n);
+        void cosine_hemisphere_from_unit(real_t* x, real_t* y, real_t* z, size_t n);
+        void triangle_from_unit(real_t* u, real_t* v, size_t n);
+        /// @brief Replaces the d rows of n uniforms with the exponential variates -log(1 - u), normalised point by point
+        void simplex_from_unit(size_t d, real_t* out, size_t n);
+
+        // Candidates drawn at a time by the rejection samplers
+        constexpr size_t rejection_block = 256;
+
+        /// @brief Points uniformly distributed on the unit circle
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @param x, y the coordinates of the n points
+        /// @note One uniform per point, the angle
+        template <typename Derived, typename T>
+        void circle(StaticGenerator<Derived, T>& rng, real_t* x, real_t* y, size_t n)
+        {
+            DF_INSTRUMENT_METHOD("geometry circle", n);
+            rng.fill_unit(x, n);
+            circle_from_unit(x, y, n);
+        }
+
+        /// @brief Points uniformly distributed in the unit disk
+        /// @param rng A random number generator
+        /// @param x, y the coordinates of the n points
+        /// @note Two uniforms per point, by the radius sqrt(u) and the angle 2 pi v: with vector sin and cos this
+        /// is as fast as rejection from the square, which needs 2.5 uniforms per point and a branch on each
+        template <typename Derived, typename T>
+        void disk(StaticGenerator<Derived, T>& rng, real_t* x, real_t* y, size_t n)
+        {
+            DF_INSTRUMENT_METHOD("geometry disk", n);
+            rng.fill_unit(x, n);
+            rng.fill_unit(y, n);
+            disk_from_unit(x, y, n);
+        }
+
+        /// @brief Points uniformly distributed on the unit sphere
+        /// @param rng A random number generator
+        /// @param x, y, z the coordinates of the n points
+        /// @note Two uniforms per point (Archimedes): z uniform in [-1, 1), and the angle around the z axis
+        template <typename Derived, typename T>
+        void sphere(StaticGenerator<Derived, T>& rng, real_t* x, real_t* y, real_t* z, size_t n)
+        {
+            DF_INSTRUMENT_METHOD("geometry sphere", n);
+            rng.fill_unit(z, n);
+            rng.fill_unit(x, n);
+            sphere_from_unit(x, y, z, n);
+        }
+
+        /// @brief Points uniformly distributed on the unit hemisphere z >= 0
+        /// @note As sphere, with z uniform in [0, 1)
+        template <typename Derived, typename T>
+        void hemisphere(StaticGenerator<Derived, T>& rng, real_t* x, real_t* y, real_t* z, size_t n)
+        {
+            DF_INSTRUMENT_METHOD("geometry hemisphere", n);
+            rng.fill_unit(z, n);
+            rng.fill_unit(x, n);
+            hemisphere_from_unit(x, y, z, n);
+        }
+
+        /// @brief Directions on the unit hemisphere z >= 0 with density cos(theta) / pi, about the normal z
+        /// @note Malley's method: a point of the unit disk lifted to the hemisphere, z = sqrt(1 - x^2 - y^2)
+        template <typename Derived, typename T>
+        void cosine_hemisphere(StaticGenerator<Derived, T>& rng, real_t* x, real_t* y, real_t* z, size_t n)
+        {
+            DF_INSTRUMENT_METHOD("geometry cosine hemisphere", n);
+            rng.fill_unit(x, n);
+            rng.fill_unit(y, n);
+            cosine_hemisphere_from_unit(x, y, z, n);
+        }
+
+        /// @brief Points uniformly distributed in the unit ball
+        /// @param rng A random number generator
+        /// @param x, y, z the coordinates of the n points
+        /// @note Rejection from the cube [-1, 1)^3, which keeps pi / 6 of the candidates: 5.7 uniforms per point
+        /// without a square root or a cube root. The candidates are drawn in blocks of 256, of which those past
+        /// the n-th point are dropped.
+        template <typename Derived, typename T>
+        void ball(StaticGenerator<Derived, T>& rng, real_t* x, real_t* y, real_t* z, size_t n)
+        {
+            DF_INSTRUMENT_METHOD("geometry ball", n);
+            real_t u[3 * rejection_block];
+            real_t px[rejection_block], py[rejection_block], pz[rejection_block];
+            size_t done = 0;
+            while (done < n) {
+                rng.fill_unit(u, 3 * rejection_block);
+                // Every candidate is written, and the count moves on past those inside the ball
+                size_t k = 0;
+                for (size_t i = 0; i < rejection_block; i++) {
+                    const real_t a = 2 * u[3 * i] - 1, b = 2 * u[3 * i + 1] - 1, c = 2 * u[3 * i + 2] - 1;
+                    px[k] = a;
+                    py[k] = b;
+                    pz[k] = c;
+                    k += (a * a + b * b + c * c < 1);
+                }
+                DF_INSTRUMENT_METHOD_REJECTS("geometry ball", rejection_block - k);
+                k = std::min(k, n - done);
+                std::copy(px, px + k, x + done);
+                std::copy(py, py + k, y + done);
+                std::copy(pz, pz + k, z + done);
+                done += k;
+            }
+        }
+
+        /// @brief Barycentric coordinates of points uniformly distributed in a triangle
+        /// @param rng A random number generator
+        /// @param u, v the weights of the second and the third vertices: the point of the triangle ABC is
+        /// A + u (B - A) + v (C - A), with u, v >= 0 and u + v <= 1
+        /// @note Two uniforms per point, the unit square folded onto the triangle along its diagonal
+        template <typename Derived, typename T>
+        void triangle(StaticGenerator<Derived, T>& rng, real_t* u, real_t* v, size_t n)
+        {
+            DF_INSTRUMENT_METHOD("geometry triangle", n);
+            rng.fill_unit(u, n);
+            rng.fill_unit(v, n);
+            triangle_from_unit(u, v, n);
+        }
+
+        /// @brief Points uniformly distributed on the standard simplex of d weights, w_j >= 0 summing to 1
+        /// (the Dirichlet distribution with all its parameters 1)
+        /// @param rng A random number generator
+        /// @param d number of weights of each point (d = 3 gives the barycentric coordinates of a triangle)
+        /// @param out d rows of n values, weight j of point i being out[j n + i]
+        /// @note d uniforms per point, normalised exponential variates
+        template <typename Derived, typename T>
+        void simplex(StaticGenerator<Derived, T>& rng, size_t d, real_t* out, size_t n)
+        {
+            if (d == 0)
+                throw std::invalid_argument("A simplex has at least one weight!");
+            DF_INSTRUMENT_METHOD("geometry simplex", n);
+            rng.fill_unit(out, d * n);
+            simplex_from_unit(d, out, n);
+        }
+    }
+}
+
+#endif
+
+// src/Core/special.h
+
+#ifndef DF_SPECIAL_H
+#define DF_SPECIAL_H
+
+#include <cstddef>
+
+
+namespace DiceForge
+{
+    /* Special functions behind the cumulative distribution functions, accurate to a few ulp */
+
+    namespace special
+    {
+        /// @brief The error function erf(x)
+        /// @note Polynomial fits of erf(x) / x for |x| < 1 and of erfc(x) e^(x^2) on [0.5, 1], [1, 2], [2, 3.5],
+        /// [3.5, 6] and in 1 / x^2 beyond (erfc switching over at 0.5), with e^(-x^2) computed from x split in two
+        /// halves, so that the tails keep their relative accuracy down to the smallest subnormal
+        real_t erf(real_t x);
+        /// @brief The complementary error function erfc(x) = 1 - erf(x), without the cancellation of the difference
+        real_t erfc(real_t x);
+        /// @brief Standard normal cumulative distribution function, P(Z <= z)
+        /// @note 0.5 erfc(-z / sqrt(2)), with e^(-z^2 / 2) taken from z itself to keep the lower tail accurate
+        real_t normal_cdf(real_t z);
+        /// @brief Inverse of normal_cdf: the z with P(Z <= z) = p, -infinity for p = 0 and infinity for p = 1
+        /// @note Acklam's rational approximation (relative error 1.15e-9) polished by one Halley step on normal_cdf
+        real_t normal_quantile(real_t p);
+
+        /// @brief erf of n values, out[i] = erf(x[i]) (out may be x)
+        /// @note A vector of values is evaluated at once when all of them fall in the same piece of the fit, as is
+        /// usual for sorted or clustered data, and one by one otherwise; results agree with the scalar function to
+        /// an ulp or two, but underflow to 0 below the smallest normal
+        void erf(const real_t* x, real_t* out, size_t n);
+        /// @brief erfc of n values, out[i] = erfc(x[i]) (out may be x), vectorised as erf
+        void erfc(const real_t* x, real_t* out, size_t n);
+        /// @brief normal_cdf of n values, out[i] = normal_cdf(z[i]) (out may be z), vectorised as erf
+        void normal_cdf(const real_t* z, real_t* out, size_t n);
+        /// @brief normal_quantile of n values, out[i] = normal_quantile(p[i]) (out may be p), vectorised as erf
+        void normal_quantile(const real_t* p, real_t* out, size_t n);
+
+        /// @brief Regularized lower incomplete gamma function P(a, x) = (1 / Gamma(a)) int_0^x t^(a-1) e^-t dt
+        /// @param a shape, positive
+        /// @param x upper limit, non-negative
+        /// @return P(a, x), or NaN outside the domain
+        /// @note The power series below x = a + 1 and the continued fraction of Q(a, x) above, both of which take on
+        /// the order of sqrt(a) terms near x = a. The prefactor x^a e^-x / Gamma(a) is built from Stirling's series
+        /// in (x - a) / a, so large shapes (e.g. the Poisson CDF of a large mean) do not lose digits to log Gamma.
+        real_t gamma_p(real_t a, real_t x);
+        /// @brief Regularized upper incomplete gamma function Q(a, x) = 1 - P(a, x), without the cancellation
+        real_t gamma_q(real_t a, real_t x);
+        /// @brief Inverse of gamma_p in x: the x with P(a, x) = p, 0 for p = 0 and infinity for p = 1
+        /// @param a shape, positive
+        /// @param p probability, in [0, 1]
+        /// @return x, or NaN outside the domain
+        /// @note Wilson and Hilferty's normal approximation (or the leading terms of the tails for a <= 1) polished
+        /// by Halley's method on P, or on Q above the median so that the upper tail keeps its relative accuracy
+        real_t gamma_p_inverse(real_t a, real_t p);
+        /// @brief Regularized incomplete beta function I_x(a, b)
+        /// @param a, b shapes, positive
+        /// @param x in [0, 1]
+        /// @return I_x(a, b), or NaN outside the domain
+        /// @note The continued fraction (modified Lentz) in x or in 1 - x, whichever converges faster, with the
+        /// prefactor x^a (1-x)^b / B(a, b) built from Stirling's series as in gamma_p
+        real_t beta_inc(real_t a, real_t b, real_t x);
+    }
+}
+
+#endif
+
+// src/Core/combinatorics.h
+
+#ifndef DF_COMBINATORICS_H
+#define DF_COMBINATORICS_H
+
+#include <cmath>
+
+
+namespace DiceForge
+{
+    /* Factorials, binomial coefficients and permutations in log space, in O(1) and without overflow */
+
+    namespace detail
+    {
+        // log(n!) is looked up for n below this, and follows from Stirling's series above
+        constexpr uint64_t log_factorial_table_size = 256;
+        extern const real_t log_factorial_table[log_factorial_table_size];
+
+        // log(2 pi) / 2
+        constexpr real_t half_log_2pi = 0.918938533204672741780329736405618;
+
+        // Error of Stirling's formula, log(n!) - ((n + 1/2) log(n) - n + log(2 pi) / 2), for n >= 1. Beyond the
+        // table the series 1/(12n) - 1/(360n^3) + 1/(1260n^5) - 1/(1680n^7) is exact to double precision.
+        inline real_t stirling_error(uint64_t n)
+        {
+            const real_t x = real_t(n);
+            if (n < log_factorial_table_size)
+                return log_factorial_table[n] - ((x + 0.5) * std::log(x) - x + half_log_2pi);
+            const real_t r = 1 / x, r2 = r * r;
+            return r * (1.0 / 12 - r2 * (1.0 / 360 - r2 * (1.0 / 1260 - r2 * (1.0 / 1680))));
+        }
+    }
+
+    /// @brief Returns log(n!)
+    /// @note A table lookup for n < 256 and Stirling's series beyond, both to double precision
+    inline real_t log_factorial(uint64_t n)
+    {
+        if (n < detail::log_factorial_table_size)
+            return detail::log_factorial_table[n];
+        const real_t x = real_t(n);
+        return (x + 0.5) * std::log(x) - x + detail::half_log_2pi + detail::stirling_error(n);
+    }
+
+    /// @brief Returns the logarithm of the binomial coefficient C(n, r), -infinity for r > n
+    /// @note Large n are handled in the form k log(n/k) - (n-k) log1p(-k/n) + log(n / (k (n-k))) / 2 - log(2 pi) / 2
+    /// plus the Stirling errors of n, k and n - k (k = min(r, n - r)), which does not lose the small C(n, r) of a
+    /// large n to cancellation as the difference of the three log factorials would
+    inline real_t log_nCr(uint64_t n, uint64_t r)
+    {
+        if (r > n)
+            return -INFINITY;
+        if (r > n - r)
+            r = n - r; // because C(n, r) == C(n, n - r)
+        if (r == 0)
+            return 0;
+        if (n < detail::log_factorial_table_size)
+            return detail::log_factorial_table[n] - detail::log_factorial_table[r] - detail::log_factorial_table[n - r];
+
+        const real_t x = real_t(n), k = real_t(r), m = real_t(n - r);
+        return k * std::log(x / k) - m * std::log1p(-k / x) + 0.5 * std::log(x / (k * m)) - detail::half_log_2pi
+               + detail::stirling_error(n) - detail::stirling_error(r) - detail::stirling_error(n - r);
+    }
+
+    /// @brief Returns the logarithm of the number of r-permutations of n, n! / (n - r)!, -infinity for r > n
+    inline real_t log_nPr(uint64_t n, uint64_t r)
+    {
+        if (r > n)
+            return -INFINITY;
+        return log_nCr(n, r) + log_factorial(r);
+    }
+}
+
+#endif
+
+// src/Core/quadrature.h
+
+#ifndef DF_QUADRATURE_H
+#define DF_QUADRATURE_H
+
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <cstddef>
+#include <cmath>
+#include <atomic>
+#include <thread>
+
+
+namespace DiceForge
+{
+    /// @brief Outcome of an adaptive integration
+    template <typename T = real_t>
+    struct quadrature_result
+    {
+        T value;            // estimate of the integral
+        T error;            // estimate of the absolute error
+        size_t evaluations; // number of integrand evaluations used
+        bool converged;     // whether the requested tolerance was met within the evaluation budget
+    };
+
+    namespace detail
+    {
+        // 15-point Kronrod extension of the 7-point Gauss rule (abscissae of the upper half, the Gauss nodes being
+        // the odd ones, and the centre last)
+        constexpr long double kronrod_nodes[8] = {
+            0.991455371120812639206854697526329L, 0.949107912342758524526189684047851L,
+            0.864864423359769072789712788640926L, 0.741531185599394439863864773280788L,
+            0.586087235467691130294144845693013L, 0.405845151377397166906606412076961L,
+            0.207784955007898467600689403773245L, 0.0L};
+        constexpr long double kronrod_weights[8] = {
+            0.022935322010529224963732008058970L, 0.063092092629978553290700663189204L,
+            0.104790010322250183839876322541518L, 0.140653259715525918745189590510238L,
+            0.169004726639267902826583426598550L, 0.190350578064785409913256402421014L,
+            0.204432940075298892414161999234649L, 0.209482141084727828012999174891714L};
+        constexpr long double gauss7_weights[4] = {
+            0.129484966168869693270611432679082L, 0.279705391489276667901467771423780L,
+            0.381830050505118944950369775488975L, 0.417959183673469387755102040816327L};
+
+        template <typename T>
+        struct kronrod_panel
+        {
+            T a, b, value, error;
+            bool operator<(const kronrod_panel& other) const { return error < other.error; }
+        };
+
+        // G7-K15 estimate over [a, b], the error being |K15 - G7|. Integrands of the form
+        // f(const T* x, T* out, size_t n) get all 15 nodes in one call.
+        template <typename T, typename F>
+        kronrod_panel<T> kronrod15(F& f, T a, T b)
+        {
+            const T h = (b - a) / 2, c = (a + b) / 2;
+            T x[15], y[15];
+            for (int i = 0; i < 7; i++)
+            {
+                x[i] = c - h * T(kronrod_nodes[i]);
+                x[14 - i] = c + h * T(kronrod_nodes[i]);
+            }
+            x[7] = c;
+
+            if constexpr (std::is_invocable_v<F&, const T*, T*, size_t>)
+                f(static_cast<const T*>(x), y, size_t(15));
+            else
+                for (int i = 0; i < 15; i++)
+                    y[i] = f(x[i]);
+
+            T kronrod = T(kronrod_weights[7]) * y[7], gauss = T(gauss7_weights[3]) * y[7];
+            for (int i = 0; i < 7; i++)
+            {
+                T pair = y[i] + y[14 - i];
+                kronrod += T(kronrod_weights[i]) * pair;
+                if (i % 2 == 1)
+                    gauss += T(gauss7_weights[i / 2]) * pair;
+            }
+            return {a, b, kronrod * h, std::fabs((kronrod - gauss) * h)};
+        }
+
+        // Calls job(i) for every i < n on up to `threads` threads (the caller being one of them)
+        template <typename Job>
+        void parallel_for(size_t n, int threads, Job &job)
+        {
+            if (threads <= 0)
+                threads = std::max(1, int(std::thread::hardware_concurrency()));
+            const size_t count = std::min(size_t(threads), n);
+            if (count <= 1)
+            {
+                for (size_t i = 0; i < n; i++)
+                    job(i);
+                return;
+            }
+
+            std::atomic<size_t> next{0};
+            auto work = [&]()
+            {
+                for (size_t i = next++; i < n; i = next++)
+                    job(i);
+            };
+            std::vector<std::thread> pool;
+            for (size_t t = 1; t < count; t++)
+                pool.emplace_back(work);
+            work();
+            for (std::thread &t : pool)
+                t.join();
+        }
+    }
+
+    /// @brief Adaptive Gauss-Kronrod (G7-K15) integration of f over the finite interval [a, b]
+    /// @param f the integrand, either f(x) or f(const T* x, T* out, size_t n) evaluating n points in one call
+    /// @param a lower limit of integration
+    /// @param b upper limit of integration
+    /// @param rel_tol requested error relative to the magnitude of the integral
+    /// @param abs_tol requested absolute error (the looser of the two is used)
+    /// @param max_evaluations evaluation budget, after which the best estimate so far is returned
+    /// @return The integral with its error estimate, the evaluations used and whether the tolerance was met
+    /// @note The panels are kept in a heap ordered by their error, and the worst one is bisected until the total
+    /// error is small enough. Only the two new halves are evaluated, every other panel keeps its estimate.
+    template <typename T = real_t, typename F>
+    quadrature_result<T> integrate_adaptive(F &&f, T a, T b, T rel_tol = T(1e-10), T abs_tol = T(1e-14),
+                                            size_t max_evaluations = 100000)
+    {
+        if (b < a)
+        {
+            quadrature_result<T> r = integrate_adaptive<T>(f, b, a, rel_tol, abs_tol, max_evaluations);
+            r.value = -r.value;
+            return r;
+        }
+
+        std::vector<detail::kronrod_panel<T>> heap;
+        heap.push_back(detail::kronrod15<T>(f, a, b));
+        T value = heap[0].value, error = heap[0].error;
+        size_t evaluations = 15;
+
+        bool converged = false;
+        while (true)
+        {
+            if (error <= std::max(abs_tol, rel_tol * std::fabs(value)))
+            {
+                converged = true;
+                break;
+            }
+            if (evaluations + 30 > max_evaluations)
+                break;
+
+            std::pop_heap(heap.begin(), heap.end());
+            detail::kronrod_panel<T> worst = heap.back();
+            T mid = (worst.a + worst.b) / 2;
+            // the panel can not be split any further in this precision
+            if (!(mid > worst.a && mid < worst.b))
+            {
+                std::push_heap(heap.begin(), heap.end());
+                break;
+            }
+
+            detail::kronrod_panel<T> left = detail::kronrod15<T>(f, worst.a, mid);
+            detail::kronrod_panel<T> right = detail::kronrod15<T>(f, mid, worst.b);
+            evaluations += 30;
+            value += left.value + right.value - worst.value;
+            error += left.error + right.error - worst.error;
+
+            heap.back() = left;
+            std::push_heap(heap.begin(), heap.end());
+            heap.push_back(right);
+            std::push_heap(heap.begin(), heap.end());
+        }
+
+        // the running sums drift, so the final totals are added up again
+        value = error = T(0);
+        for (const detail::kronrod_panel<T>& panel : heap)
+        {
+            value += panel.value;
+            error += panel.error;
+        }
+        return {value, error, evaluations, converged};
+    }
+}
+
+#endif
+
+// src/Core/basicfxn.h
+
+#ifndef DF_BASICFXN_H
+#define DF_BASICFXN_H
+
+#include <iostream>
+#include <functional>
+#include <vector>
+#include <limits>
+#include <stdexcept>
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+
+namespace DiceForge
+{
+    /* Helper strucure for matrix operations */
+
+    /* It is assumed that you are aware of contraints on the number of rows 
+    * and columns while performing binary operations on two matrices and 
+    * you will not abuse this poor struct */
+
+    /* The elements are stored contiguously, row after row. Copies and moves are those of
+    * the std::vector, and the in-place operators and multiply_transposed() let a loop
+    * reuse its matrices instead of allocating new ones on every pass */
+
+    struct matrix_t
+    {
+        matrix_t(int r, int c);
+
+        const real_t* operator[](int i) const { return data.data() + size_t(i) * c; }
+        real_t* operator[](int i) { return data.data() + size_t(i) * c; }
+
+        matrix_t operator*(const matrix_t& other) const;
+        matrix_t operator+(const matrix_t& other) const;
+        matrix_t operator-(const matrix_t& other) const;
+        matrix_t operator-() const;        
+        matrix_t transpose() const;
+
+        matrix_t& operator+=(const matrix_t& other);
+        matrix_t& operator-=(const matrix_t& other);
+        matrix_t& operator*=(real_t k);
+
+        std::vector<real_t> data;
+
+        int r; // rows
+        int c; // cols
+    };
+
+    /* out = A^T * B, without forming the transpose (out has to be A.c x B.c) */
+    void multiply_transposed(const matrix_t& A, const matrix_t& B, matrix_t& out);
+
+    /* Small matrices of fixed size, kept on the stack */
+
+    template <int R, int C>
+    struct fixed_matrix_t
+    {
+        real_t m[R][C] = {};
+
+        const real_t* operator[](int i) const { return m[i]; }
+        real_t* operator[](int i) { return m[i]; }
+
+        template <int K>
+        fixed_matrix_t<R, K> operator*(const fixed_matrix_t<C, K>& other) const
+        {
+            fixed_matrix_t<R, K> pdt;
+            for (int i = 0; i < R; i++)
+                for (int j = 0; j < K; j++)
+                    for (int k = 0; k < C; k++)
+                        pdt.m[i][j] += m[i][k] * other.m[k][j];
+            return pdt;
+        }
+
+        fixed_matrix_t operator+(const fixed_matrix_t& other) const
+        {
+            fixed_matrix_t sum;
+            for (int i = 0; i < R; i++)
+                for (int j = 0; j < C; j++)
+                    sum.m[i][j] = m[i][j] + other.m[i][j];
+            return sum;
+        }
+
+        fixed_matrix_t operator-(const fixed_matrix_t& other) const
+        {
+            fixed_matrix_t diff;
+            for (int i = 0; i < R; i++)
+                for (int j = 0; j < C; j++)
+                    diff.m[i][j] = m[i][j] - other.m[i][j];
+            return diff;
+        }
+
+        fixed_matrix_t<C, R> transpose() const
+        {
+            fixed_matrix_t<C, R> t;
+            for (int i = 0; i < R; i++)
+                for (int j = 0; j < C; j++)
+                    t.m[j][i] = m[i][j];
+            return t;
+        }
+    };
+
+    typedef fixed_matrix_t<2, 2> matrix2_t;
+    typedef fixed_matrix_t<3, 3> matrix3_t;
+
+    /* J^T * J for a matrix J with C columns */
+    template <int C>
+    fixed_matrix_t<C, C> gram(const matrix_t& J)
+    {
+        fixed_matrix_t<C, C> g;
+        for (int i = 0; i < J.r; i++)
+        {
+            const real_t* row = J[i];
+            for (int a = 0; a < C; a++)
+                for (int b = a; b < C; b++)
+                    g.m[a][b] += row[a] * row[b];
+        }
+        for (int a = 0; a < C; a++)
+            for (int b = 0; b < a; b++)
+                g.m[a][b] = g.m[b][a];
+        return g;
+    }
+
+    /* J^T * R for a matrix J with C columns and a column vector R */
+    template <int C>
+    fixed_matrix_t<C, 1> transpose_times(const matrix_t& J, const matrix_t& R)
+    {
+        fixed_matrix_t<C, 1> v;
+        for (int i = 0; i < J.r; i++)
+        {
+            const real_t* row = J[i];
+            for (int a = 0; a < C; a++)
+                v.m[a][0] += row[a] * R[i][0];
+        }
+        return v;
+    }
+
+    /* Exact k-permutations and k-combinations of n, which throw std::overflow_error when the
+    * result does not fit (see combinatorics.h for their logarithms, which never overflow) */
+
+    /* k-permutations of n */
+    static inline uint_t nPr(uint_t n, uint_t r)
+    {
+        if (r > n)
+            return 0;
+
+        uint_t p = 1;
+        for (uint_t i = n; i > n - r; i--)
+        {
+            if (p > std::numeric_limits<uint_t>::max() / i)
+                throw std::overflow_error("nPr(n, r) does not fit in 64 bits");
+            p *= i;
+        }
+
+        return p;
+    }
+
+    /* uint128_t returns a 128-bit value
+    * Every step multiplies by (n - r + i) / i, with the common factors of the running product
+    * and i taken out first, so that only a result too large for 128 bits can overflow. */
+
+    /* k-combinations of n */
+    static inline uint128_t nCr(uint128_t n, uint128_t r)
+    {
+        if (r > n)
+            return 0;
+        if (r > n - r)
+            r = n - r; // because C(n, r) == C(n, n - r)
+
+        uint128_t ans = 1;
+        uint128_t i;
+
+        for (i = 1; i <= r; i++)
+        {
+            // ans * (n - r + i) is divisible by i, and i / gcd(ans, i) divides n - r + i
+            uint128_t g = ans, h = i;
+            while (h != 0)
+            {
+                uint128_t t = g % h;
+                g = h;
+                h = t;
+            }
+            uint128_t factor = (n - r + i) / (i / g);
+            if (ans / g > ~uint128_t(0) / factor)
+                throw std::overflow_error("nCr(n, r) does not fit in 128 bits");
+            ans = ans / g * factor;
+        }
+
+        return ans;
+    }
+
+    /* inverse of a 2x2 matrix */
+    static inline matrix_t inverse2x2(const matrix_t& M)
+    {
+        real_t inv_det = 1 / (M[0][0] * M[1][1] - M[1][0] * M[0][1]);
+        matrix_t inv = matrix_t(2, 2);
+        inv[0][0] = M[1][1] * inv_det;
+        inv[0][1] = -M[0][1] * inv_det;
+        inv[1][0] = -M[1][0] * inv_det;
+        inv[1][1] = M[0][0] * inv_det;
+        
+        return inv;
+    }
+
+    /* inverse of a 2x2 matrix */
+    static inline matrix2_t inverse(const matrix2_t& M)
+    {
+        real_t inv_det = 1 / (M[0][0] * M[1][1] - M[1][0] * M[0][1]);
+        matrix2_t inv;
+        inv[0][0] = M[1][1] * inv_det;
+        inv[0][1] = -M[0][1] * inv_det;
+        inv[1][0] = -M[1][0] * inv_det;
+        inv[1][1] = M[0][0] * inv_det;
+        return inv;
+    }
+
+    /* inverse of a 3x3 matrix (adjugate over determinant) */
+    static inline matrix3_t inverse(const matrix3_t& M)
+    {
+        matrix3_t inv;
+        inv[0][0] = M[1][1] * M[2][2] - M[1][2] * M[2][1];
+        inv[0][1] = M[0][2] * M[2][1] - M[0][1] * M[2][2];
+        inv[0][2] = M[0][1] * M[1][2] - M[0][2] * M[1][1];
+        inv[1][0] = M[1][2] * M[2][0] - M[1][0] * M[2][2];
+        inv[1][1] = M[0][0] * M[2][2] - M[0][2] * M[2][0];
+        inv[1][2] = M[0][2] * M[1][0] - M[0][0] * M[1][2];
+        inv[2][0] = M[1][0] * M[2][1] - M[1][1] * M[2][0];
+        inv[2][1] = M[0][1] * M[2][0] - M[0][0] * M[2][1];
+        inv[2][2] = M[0][0] * M[1][1] - M[0][1] * M[1][0];
+        real_t inv_det = 1 / (M[0][0] * inv[0][0] + M[0][1] * inv[1][0] + M[0][2] * inv[2][0]);
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++)
+                inv[i][j] *= inv_det;
+        return inv;
+    }
+    
+    /* integral of f over [a, b]; partitions is the evaluation budget of the adaptive Gauss-Kronrod
+    * integration (see quadrature.h) that replaced the fixed composite Simpson rule */
+    static inline real_t simpson(std::function<real_t(real_t)> f, real_t a, real_t b, size_t partitions = 1000000)
+    {
+        return integrate_adaptive<real_t>(f, a, b, 1e-12, 1e-15, std::max(partitions + 1, size_t(15))).value;
+    }
+}
+
+#endif
+
+// src/Core/distribution.h
+
+#ifndef DF_DISTRIBUTION_H
+#define DF_DISTRIBUTION_H
+
+#include <limits>
+#include <iostream>
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#if __cplusplus >= 202002L && __has_include(<span>)
+#include <span>
+// Set when std::span overloads are available
+#define DF_SPAN
+#endif
+
+
+namespace DiceForge
+{    
+    namespace detail
+    {
+        // Quantile functions take probabilities in [0, 1]
+        inline void check_probability(real_t p)
+        {
+            if (!(p >= 0 && p <= 1))
+                throw std::invalid_argument("Expected a probability in [0, 1]!");
+        }
+    }
+
+    /// @brief DiceForge::Continuous - A generic class for distributions describing continuous random variables
+    class Continuous
+    {
+    public:
+        /// @brief Returns the theoretical variance of the distribution
+        virtual real_t variance() const = 0;
+        /// @brief Returns the theoretical expectation value of the distribution
+        virtual real_t expectation() const = 0;
+        /// @brief Returns the minimum possible value of the random variable described by the distribution
+        virtual real_t minValue() const = 0;
+        /// @brief Returns the maximum possible value of the random variable described by the distribution
+        virtual real_t maxValue() const = 0;
+        /// @brief Probabiliity density function (pdf) of the distribution
+        /// @param x location where the pdf is to be evaluated
+        virtual real_t pdf(real_t x) const = 0;
+        /// @brief Cumulative distribution function (cdf) of the distribution
+        /// @param x location where the cdf is to be evaluated [P(X <= x)]
+        virtual real_t cdf(real_t x) const = 0;
+        /// @brief Natural logarithm of the probability density function (pdf) of the distribution
+        /// @param x location where the log-pdf is to be evaluated
+        virtual real_t logpdf(real_t x) const
+        {
+            return log(pdf(x));
+        }
+        /// @brief Evaluates the pdf at n locations
+        /// @param x pointer to the first of the locations
+        /// @param out pointer to the first element of the buffer receiving pdf(x[i])
+        /// @param n number of locations
+        virtual void pdf(const real_t* x, real_t* out, size_t n) const
+        {
+            for (size_t i = 0; i < n; i++)
+                out[i] = pdf(x[i]);
+        }
+        /// @brief Evaluates the log-pdf at n locations (see pdf(const real_t*, real_t*, size_t))
+        virtual void logpdf(const real_t* x, real_t* out, size_t n) const
+        {
+            for (size_t i = 0; i < n; i++)
+                out[i] = logpdf(x[i]);
+        }
+        /// @brief Evaluates the cdf at n locations (see pdf(const real_t*, real_t*, size_t))
+        virtual void cdf(const real_t* x, real_t* out, size_t n) const
+        {
+            for (size_t i = 0; i < n; i++)
+                out[i] = cdf(x[i]);
+        }
+        /// @brief Quantile function (inverse of the cdf) of the distribution, the x with cdf(x) = p
+        /// @param p probability, in [0, 1] (std::invalid_argument otherwise)
+        /// @note minValue() for p = 0 and maxValue() for p = 1. By default cdf(x) = p is solved numerically: the
+        /// normal approximation expectation + sqrt(variance) z(p) is bracketed in steps doubling from the standard
+        /// deviation and the bracket closed by regula falsi (Illinois) to a few ulp. Closed forms override it.
+        virtual real_t quantile(real_t p) const
+        {
+            detail::check_probability(p);
+            const real_t lower = minValue(), upper = maxValue();
+            if (p == 0)
+                return lower;
+            if (p == 1)
+                return upper;
+            real_t scale = std::sqrt(variance()), x = expectation();
+            if (!(scale > 0 && scale < INFINITY))
+                scale = 1;
+            if (!std::isfinite(x))
+                x = 0;
+            x += scale * special::normal_quantile(p);
+            if (!(x > lower))
+                x = lower;
+            else if (!(x < upper))
+                x = upper;
+
+            // cdf(lo) < p <= cdf(hi)
+            real_t lo = x, hi = x, flo = cdf(x) - p, fhi = flo;
+            if (flo < 0)
+                for (real_t step = scale; fhi < 0 && hi < upper; step *= 2)
+                {
+                    lo = hi, flo = fhi;
+                    hi = (upper - lo > step) ? lo + step : upper;
+                    fhi = cdf(hi) - p;
+                }
+            else
+                for (real_t step = scale; flo >= 0 && lo > lower; step *= 2)
+                {
+                    hi = lo, fhi = flo;
+                    lo = (lo - lower > step) ? lo - step : lower;
+                    flo = cdf(lo) - p;
+                }
+            if (flo >= 0)
+                return lo;
+            if (fhi < 0)
+                return hi;
+
+            // Regula falsi, halving the value kept at the same end twice in a row
+            int side = 0;
+            for (int i = 0; i < 100; i++)
+            {
+                const real_t mid = lo + (hi - lo) / 2;
+                if (!(mid > lo && mid < hi) || hi - lo <= 4 * std::numeric_limits<real_t>::epsilon() * std::fabs(mid))
+                    break;
+                real_t t = lo - flo * ((hi - lo) / (fhi - flo));
+                if (!(t > lo && t < hi))
+                    t = mid;
+                const real_t ft = cdf(t) - p;
+                if (ft < 0)
+                {
+                    lo = t, flo = ft;
+                    if (side < 0)
+                        fhi /= 2;
+                    side = -1;
+                }
+                else
+                {
+                    hi = t, fhi = ft;
+                    if (side > 0)
+                        flo /= 2;
+                    side = 1;
+                }
+            }
+            const real_t mid = lo + (hi - lo) / 2;
+            return (mid > lo && mid < hi) ? mid : hi;
+        }
+        /// @brief Evaluates the quantile function at n probabilities (out may be p)
+        /// @param p pointer to the first of the probabilities
+        /// @param out pointer to the first element of the buffer receiving quantile(p[i])
+        /// @param n number of probabilities
+        virtual void quantile(const real_t* p, real_t* out, size_t n) const
+        {
+            for (size_t i = 0; i < n; i++)
+                out[i] = quantile(p[i]);
+        }
+    };
+
+    /// @brief DiceForge::Discrete - A generic class for distributions describing discrete random variables
+    class Discrete
+    {
+    public:
+        /// @brief Returns the theoretical variance of the distribution
+        virtual real_t variance() const = 0;
+        /// @brief Returns the theoretical expectation value of the distribution
+        virtual real_t expectation() const = 0;
+        /// @brief Returns the minimum possible value of the random variable described by the distribution
+        virtual int_t minValue() const = 0;
+        /// @brief Returns the maximum possible value of the random variable described by the distribution
+        virtual int_t maxValue() const = 0;
+        /// @brief Probabiliity mass function (pmf) of the distribution
+        /// @param x location where the pdf is to be evaluated [P(X = x)]
+        virtual real_t pmf(int_t x) const = 0;
+        /// @brief Cumulative distribution function (cdf) of the distribution
+        /// @param x location where the cdf is to be evaluated [P(X <= x)]
+        virtual real_t cdf(int_t x) const = 0;
+        /// @brief Natural logarithm of the probability mass function (pmf) of the distribution
+        /// @param x location where the log-pmf is to be evaluated
+        virtual real_t logpmf(int_t x) const
+        {
+            return log(pmf(x));
+        }
+        /// @brief Evaluates the pmf at n locations
+        /// @param x pointer to the first of the locations
+        /// @param out pointer to the first element of the buffer receiving pmf(x[i])
+        /// @param n number of locations
+        virtual void pmf(const int_t* x, real_t* out, size_t n) const
+        {
+            for (size_t i = 0; i < n; i++)
+                out[i] = pmf(x[i]);
+        }
+        /// @brief Evaluates the log-pmf at n locations (see pmf(const int_t*, real_t*, size_t))
+        virtual void logpmf(const int_t* x, real_t* out, size_t n) const
+        {
+            for (size_t i = 0; i < n; i++)
+                out[i] = logpmf(x[i]);
+        }
+        /// @brief Evaluates the cdf at n locations (see pmf(const int_t*, real_t*, size_t))
+        virtual void cdf(const int_t* x, real_t* out, size_t n) const
+        {
+            for (size_t i = 0; i < n; i++)
+                out[i] = cdf(x[i]);
+        }
+        /// @brief Quantile function (generalised inverse of the cdf) of the distribution, the smallest x with cdf(x) >= p
+        /// @param p probability, in [0, 1] (std::invalid_argument otherwise)
+        /// @note By default the normal approximation expectation + sqrt(variance) z(p) is bracketed in steps
+        /// doubling from 1, and the bracket closed by binary search on the cdf, with O(log) cdf evaluations
+        virtual int_t quantile(real_t p) const
+        {
+            detail::check_probability(p);
+            const int_t lower = minValue(), upper = maxValue();
+            const real_t guess = expectation() + std::sqrt(variance()) * special::normal_quantile(p);
+            int_t k;
+            if (!(guess > real_t(lower)))
+                k = lower;
+            else if (!(guess < real_t(upper)))
+                k = upper;
+            else
+                k = int_t(std::floor(guess));
+
+            // cdf(lo) < p <= cdf(hi), with the distances in unsigned arithmetic as the support may span all of int_t
+            int_t lo, hi;
+            uint64_t step = 1;
+            if (cdf(k) >= p)
+                for (hi = k;; hi = lo, step *= 2)
+                {
+                    if (hi == lower)
+                        return lower;
+                    lo = (uint64_t(hi) - uint64_t(lower) > step) ? int_t(uint64_t(hi) - step) : lower;
+                    if (cdf(lo) < p)
+                        break;
+                }
+            else
+                for (lo = k;; lo = hi, step *= 2)
+                {
+                    if (lo == upper)
+                        return upper;
+                    hi = (uint64_t(upper) - uint64_t(lo) > step) ? int_t(uint64_t(lo) + step) : upper;
+                    if (cdf(hi) >= p)
+                        break;
+                }
+            while (uint64_t(hi) - uint64_t(lo) > 1)
+            {
+                const int_t mid = int_t(uint64_t(lo) + (uint64_t(hi) - uint64_t(lo)) / 2);
+                if (cdf(mid) >= p)
+                    hi = mid;
+                else
+                    lo = mid;
+            }
+            return hi;
+        }
+        /// @brief Evaluates the quantile function at n probabilities
+        /// @param p pointer to the first of the probabilities
+        /// @param out pointer to the first element of the buffer receiving quantile(p[i])
+        /// @param n number of probabilities
+        virtual void quantile(const real_t* p, int_t* out, size_t n) const
+        {
+            for (size_t i = 0; i < n; i++)
+                out[i] = quantile(p[i]);
+        }
+    };
+}
+
+#endif
+
+// src/Core/pool.h
+
+#ifndef DF_POOL_H
+#define DF_POOL_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <optional>
+#include <limits>
+#include <cstddef>
+#include <stdexcept>
+
+
+namespace DiceForge
+{
+    namespace detail
+    {
+        // Values per chunk of parallel_fill and parallel_sample, every chunk drawing from its own stream
+        constexpr size_t pool_chunk = 65536;
+        // Distinguishes the pools in the per-thread tables of GeneratorPool::local
+        inline std::atomic<uint64_t> pool_count{0};
+    }
+
+    /// @brief DiceForge::GeneratorPool<Engine> - A fixed number of independent streams of one RNG, for threads
+    /// @tparam Engine RNG derived from Generator<T> (like MT64 or XORShift64)
+    /// @note Stream i is the master RNG jumped ahead by i * stride random integers, as with DiceForge::split, and is
+    /// only made the first time it is asked for. It then lives in a slot of its own cache line(s), so that threads
+    /// drawing from neighbouring streams do not write to the same line.
+    /// @note The streams are independent of the order in which threads ask for them, so results are reproducible as
+    /// long as work is tied to stream indices (as in parallel_fill and parallel_sample) rather than to threads.
+    /// Engine should have a fast jump (any but the plain Blum Blum Shub and MT32): without one, the pool throws
+    /// std::invalid_argument unless its last stream starts at most 2^30 integers ahead.
+    template <typename Engine>
+    class GeneratorPool
+    {
+    private:
+        struct alignas(64) Slot
+        {
+            std::once_flag made;
+            std::optional<Engine> engine;
+        };
+        Engine master;
+        size_t count;
+        uint64_t stride;
+        std::unique_ptr<Slot[]> slots;
+        uint64_t id = detail::pool_count++;
+        std::atomic<size_t> handed{0};
+
+    public:
+        /// @brief Creates a pool of streams of the given RNG
+        /// @param engine master RNG, copied (stream 0 starts where it is)
+        /// @param streams number of streams
+        /// @param stride distance between the starts of consecutive streams (2^64 / streams by default)
+        /// @note The streams do not overlap as long as each one is used for at most stride random integers
+        /// @note Throws std::invalid_argument for an RNG without a fast jump and (streams - 1) * stride above 2^30
+        GeneratorPool(const Engine& engine, size_t streams, uint64_t stride = 0)
+            : master(engine), count(streams), stride(stride), slots(new Slot[streams])
+        {
+            if (streams == 0)
+                throw std::invalid_argument("Expected at least one stream");
+            if (this->stride == 0)
+                this->stride = std::numeric_limits<uint64_t>::max() / streams;
+            detail::check_jump(engine, uint128_t(streams - 1) * this->stride);
+        }
+        GeneratorPool(const GeneratorPool&) = delete;
+        GeneratorPool& operator=(const GeneratorPool&) = delete;
+
+        /// @brief Number of streams in the pool
+        size_t size() const
+        {
+            return count;
+        }
+        /// @brief Returns stream i, making it on the first call
+        /// @note Safe to call from several threads at once, but a stream should only be drawn from by one thread at
+        /// a time
+        Engine& stream(size_t i)
+        {
+            if (i >= count)
+                throw std::out_of_range("No such stream in the pool");
+            Slot& slot = slots[i];
+            std::call_once(slot.made, [&]() {
+                slot.engine.emplace(master);
+                slot.engine->jump(uint64_t(i) * stride);
+            });
+            return *slot.engine;
+        }
+        /// @brief Returns the stream of the calling thread, handing it the next unused stream on its first call
+        /// @note Which thread gets which stream depends on the order of the first calls; use stream(i) with a worker
+        /// index for results that do not depend on scheduling. Throws std::out_of_range once every stream is taken.
+        Engine& local()
+        {
+            // (pool, stream) pairs of the calling thread; a pool is never reused, so stale entries are harmless
+            thread_local std::vector<std::pair<uint64_t, size_t>> taken;
+            for (const std::pair<uint64_t, size_t>& entry : taken)
+                if (entry.first == id)
+                    return stream(entry.second);
+            const size_t i = handed++;
+            if (i >= count)
+                throw std::out_of_range("Every stream of the pool has been handed out");
+            taken.emplace_back(id, i);
+            return stream(i);
+        }
+    };
+
+    /// @brief Fills the buffer with random reals between 0 and 1 on several threads
+    /// @param pool streams to draw from, chunk c of the buffer drawing from stream c % pool.size()
+    /// @param out Pointer to the first element of the buffer
+    /// @param n Number of random reals to be written
+    /// @param threads maximum number of threads, 0 for std::thread::hardware_concurrency
+    /// @note The buffer is cut into chunks of detail::pool_chunk values, and the chunks sharing a stream are filled
+    /// in order by one thread, so the result depends on the pool but not on the number of threads
+    template <typename Engine>
+    void parallel_fill(GeneratorPool<Engine>& pool, real_t* out, size_t n, int threads = 0)
+    {
+        const size_t chunks = (n + detail::pool_chunk - 1) / detail::pool_chunk;
+        auto job = [&](size_t s) {
+            auto rng = make_static(pool.stream(s));
+            for (size_t c = s; c < chunks; c += pool.size()) {
+                const size_t begin = c * detail::pool_chunk;
+                rng.fill_unit(out + begin, std::min(detail::pool_chunk, n - begin));
+            }
+        };
+        detail::parallel_for(std::min(chunks, pool.size()), threads, job);
+    }
+
+    /// @brief Fills the buffer with values of a distribution on several threads
+    /// @param pool streams to draw from, chunk c of the buffer drawing from stream c % pool.size()
+    /// @param distribution a distribution with a batch sample(rng, out, n), of a concrete (copyable) type
+    /// @param out Pointer to the first element of the buffer
+    /// @param n Number of values to be written
+    /// @param threads maximum number of threads, 0 for std::thread::hardware_concurrency
+    /// @note Each stream draws from its own copy of the distribution, so that samplers keeping a state between
+    /// draws (the hull of AdaptiveRejection, a cached normal) are never shared between threads, and the copy of
+    /// stream s fills its chunks in order. As parallel_fill, the result depends on the pool but not on the number
+    /// of threads; the state gathered by the copies is dropped, the distribution itself being left unchanged.
+    template <typename Engine, typename Distribution, typename V>
+    void parallel_sample(GeneratorPool<Engine>& pool, const Distribution& distribution, V* out, size_t n, int threads = 0)
+    {
+        const size_t chunks = (n + detail::pool_chunk - 1) / detail::pool_chunk;
+        auto job = [&](size_t s) {
+            auto rng = make_static(pool.stream(s));
+            Distribution local(distribution);
+            for (size_t c = s; c < chunks; c += pool.size()) {
+                const size_t begin = c * detail::pool_chunk;
+                local.sample(rng, out + begin, std::min(detail::pool_chunk, n - begin));
+            }
+        };
+        detail::parallel_for(std::min(chunks, pool.size()), threads, job);
+    }
+}
+
+#endif
+
+// src/Core/statistics.h
+
+#ifndef DF_STATISTICS_H
+#define DF_STATISTICS_H
+
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+
+namespace DiceForge
+{
+    /// @brief Outcome of a goodness of fit test
+    struct TestResult
+    {
+        /// @brief Value of the test statistic (chi-square, Kolmogorov-Smirnov distance or z score)
+        real_t statistic;
+        /// @brief Probability of a statistic at least as extreme under the hypothesis
+        real_t p_value;
+        /// @brief Degrees of freedom of the chi-square test, 0 for the others
+        size_t dof;
+    };
+
+    /// @brief DiceForge::Moments - Streaming count, mean, variance, skewness, kurtosis, minimum, maximum and sum of a
+    /// sample, in constant memory
+    /// @note Values are taken in blocks: a block's own mean and central moments are computed in two passes over it
+    /// and merged into the totals with the pairwise formulas of Chan et al. and Pébay, so the variance keeps its
+    /// accuracy far beyond the 1e8 values where the naive sum of squares breaks down. The sum itself is compensated
+    /// (Kahan-Babuska). Accumulators over parts of a sample (e.g. one per thread) can be merged.
+    class Moments : public Serializable<Moments>
+    {
+        friend class Serializable<Moments>;
+    private:
+        uint64_t n = 0;
+        real_t m1 = 0, m2 = 0, m3 = 0, m4 = 0;
+        real_t sum = 0, compensation = 0;
+        real_t low = 0, high = 0;
+        void merge(uint64_t count, real_t mean, real_t c2, real_t c3, real_t c4, real_t total, real_t lo, real_t hi);
+        // The statistics, for save_state and load_state (see DiceForge::Serializable)
+        void write_state(detail::StateWriter& out) const;
+        void read_state(detail::StateReader& in);
+    public:
+        /// @brief Adds one value
+        void add(real_t x);
+        /// @brief Adds the n values x
+        void add(const real_t* x, size_t n);
+        /// @brief Adds the n integers x
+        void add(const int_t* x, size_t n);
+        /// @brief Adds all the values seen by other
+        void merge(const Moments& other);
+        /// @brief Number of values added
+        uint64_t count() const;
+        /// @brief Sum of the values
+        real_t total() const;
+        /// @brief Sample mean
+        real_t mean() const;
+        /// @brief Unbiased sample variance (0 below two values)
+        real_t variance() const;
+        /// @brief Sample skewness, m3 / m2^1.5 of the central moments (NaN without two distinct values)
+        real_t skewness() const;
+        /// @brief Sample excess kurtosis, m4 / m2^2 - 3 of the central moments (NaN without two distinct values)
+        real_t kurtosis() const;
+        /// @brief Smallest value added (0 if none)
+        real_t min() const;
+        /// @brief Largest value added (0 if none)
+        real_t max() const;
+        /// @brief z test of the mean against the expectation of a distribution with the given variance
+        /// @return z = (mean - expectation) / sqrt(variance / n) and its two-sided p value
+        TestResult mean_test(real_t expectation, real_t variance) const;
+    };
+
+    /// @brief DiceForge::Histogram - Counts of a sample in equal bins of [lo, hi), with the values below and above,
+    /// for chi-square and Kolmogorov-Smirnov tests against a distribution in constant memory
+    /// @note Integers k fall into bin k - lo of a histogram of [lo, hi) with hi - lo bins, so the same class tallies
+    /// discrete samples (residues, dice...) one value per bin.
+    class Histogram : public Serializable<Histogram>
+    {
+        friend class Serializable<Histogram>;
+    private:
+        real_t lo, hi, scale;
+        std::vector<uint64_t> counts;
+        uint64_t below = 0, above = 0;
+        // P(X < edge) at the bin edges, for the tests
+        std::vector<real_t> edges(const Continuous& distribution) const;
+        std::vector<real_t> edges(const Discrete& distribution) const;
+        std::vector<real_t> edges() const;
+        // The statistics, for save_state and load_state (see DiceForge::Serializable)
+        void write_state(detail::StateWriter& out) const;
+        void read_state(detail::StateReader& in);
+    public:
+        /// @brief Histogram of [lo, hi) in the given number of bins
+        Histogram(real_t lo = 0, real_t hi = 1, size_t bins = 100);
+        /// @brief Adds one value
+        void add(real_t x)
+        {
+            const real_t t = (x - lo) * scale;
+            if (t < 0)
+                below++;
+            else if (t < real_t(counts.size()))
+                counts[size_t(t)]++;
+            else
+                above++;    // NaN included
+        }
+        /// @brief Adds the n values x
+        void add(const real_t* x, size_t n);
+        /// @brief Adds the n integers x
+        void add(const int_t* x, size_t n);
+        /// @brief Adds all the values seen by other, a histogram of the same bins
+        void merge(const Histogram& other);
+        /// @brief Number of bins
+        size_t bins() const;
+        /// @brief Count of bin i, values in [lo + i (hi - lo) / bins, lo + (i + 1) (hi - lo) / bins)
+        uint64_t operator[](size_t i) const;
+        /// @brief Number of values below lo
+        uint64_t underflow() const;
+        /// @brief Number of values at or above hi (or NaN)
+        uint64_t overflow() const;
+        /// @brief Number of values added
+        uint64_t count() const;
+        /// @brief Pearson's chi-square test of the counts against a distribution
+        /// @param fitted number of parameters of the distribution estimated from the same sample
+        /// @note The values below lo and above hi count as two more bins, and neighbouring bins are pooled until
+        /// each expects at least 5 values. A value where the distribution expects none gives an infinite statistic.
+        TestResult chi_square(const Continuous& distribution, size_t fitted = 0) const;
+        /// @brief Pearson's chi-square test of the counts against a discrete distribution
+        TestResult chi_square(const Discrete& distribution, size_t fitted = 0) const;
+        /// @brief Pearson's chi-square test of the counts against the uniform distribution on [lo, hi)
+        TestResult chi_square() const;
+        /// @brief Kolmogorov-Smirnov test of the counts against a distribution
+        /// @note The distance is taken at the bin edges only, so it is at most that of the raw sample, short of it
+        /// by no more than the largest probability of a bin: with fine bins the test is nearly as sensitive as on
+        /// the sorted sample, without storing it. The p value is the asymptotic one with Stephens' correction.
+        TestResult kolmogorov_smirnov(const Continuous& distribution) const;
+        /// @brief Kolmogorov-Smirnov test of the counts against a discrete distribution (at the bin edges)
+        TestResult kolmogorov_smirnov(const Discrete& distribution) const;
+        /// @brief Kolmogorov-Smirnov test of the counts against the uniform distribution on [lo, hi)
+        TestResult kolmogorov_smirnov() const;
+    };
+
+    /// @brief DiceForge::SampleSummary - Moments and histogram of one sample, filled together
+    struct SampleSummary
+    {
+        Moments moments;
+        Histogram histogram;
+        /// @brief An empty summary with a histogram of [lo, hi) in the given number of bins
+        SampleSummary(real_t lo = 0, real_t hi = 1, size_t bins = 100) : histogram(lo, hi, bins) {}
+        /// @brief Adds the n values x
+        template <typename V>
+        void add(const V* x, size_t n)
+        {
+            moments.add(x, n);
+            histogram.add(x, n);
+        }
+        /// @brief Adds all the values seen by other
+        void merge(const SampleSummary& other)
+        {
+            moments.merge(other.moments);
+            histogram.merge(other.histogram);
+        }
+    };
+
+    /// @brief Draws n values on several threads and gathers them into an accumulator, in constant memory
+    /// @param pool streams to draw from, chunk c of the sample drawing from stream c % pool.size()
+    /// @param n number of values
+    /// @param empty accumulator to start every stream from, providing add(const V*, size_t) and merge (Moments,
+    /// Histogram, SampleSummary, GaussianAccumulator...)
+    /// @param draw draw(rng, out, m) writing m values of type V, rng being a StaticView of a stream
+    /// @param threads maximum number of threads, 0 for std::thread::hardware_concurrency
+    /// @return the accumulator of all the values
+    /// @note Each stream works through its chunks (of detail::pool_chunk values) with a buffer of its own and an
+    /// accumulator of its own, and the accumulators are merged in the order of the streams, so the result depends
+    /// on the pool but not on the number of threads. Only a chunk per stream is kept in memory, whatever n is.
+    template <typename V = real_t, typename Engine, typename Accumulator, typename Draw>
+    Accumulator parallel_accumulate(GeneratorPool<Engine>& pool, uint64_t n, const Accumulator& empty, Draw draw,
+                                    int threads = 0)
+    {
+        const uint64_t chunks = (n + detail::pool_chunk - 1) / detail::pool_chunk;
+        const size_t used = size_t(std::min<uint64_t>(chunks, pool.size()));
+        std::vector<Accumulator> partial(used, empty);
+        auto job = [&](size_t s) {
+            auto rng = make_static(pool.stream(s));
+            std::vector<V> buffer(size_t(std::min<uint64_t>(detail::pool_chunk, n)));
+            for (uint64_t c = s; c < chunks; c += pool.size()) {
+                const size_t m = size_t(std::min<uint64_t>(detail::pool_chunk, n - c * detail::pool_chunk));
+                draw(rng, buffer.data(), m);
+                partial[s].add(buffer.data(), m);
+            }
+        };
+        detail::parallel_for(used, threads, job);
+        Accumulator result = empty;
+        for (const Accumulator& p : partial)
+            result.merge(p);
+        return result;
+    }
+
+    /// @brief Summary of n random reals between 0 and 1 of the pool, drawn on several threads
+    /// @param bins bins of the histogram of [0, 1)
+    /// @note See parallel_accumulate
+    template <typename Engine>
+    SampleSummary parallel_summary(GeneratorPool<Engine>& pool, uint64_t n, size_t bins = 1000, int threads = 0)
+    {
+        return parallel_accumulate(pool, n, SampleSummary(0, 1, bins),
+                                   [](auto& rng, real_t* out, size_t m) { rng.fill_unit(out, m); }, threads);
+    }
+
+    /// @brief Summary of n values of a distribution drawn on several threads
+    /// @param distribution any distribution with a batch sample(rng, out, n), called from all the threads at once (of
+    /// integers for those derived from Discrete, of reals otherwise)
+    /// @param lo, hi, bins the bins of the histogram
+    /// @note See parallel_accumulate
+    template <typename Engine, typename Distribution>
+    SampleSummary parallel_summary(GeneratorPool<Engine>& pool, Distribution& distribution, uint64_t n, real_t lo,
+                                   real_t hi, size_t bins, int threads = 0)
+    {
+        typedef typename std::conditional<std::is_base_of<Discrete, Distribution>::value, int_t, real_t>::type V;
+        return parallel_accumulate<V>(pool, n, SampleSummary(lo, hi, bins),
+                                   [&](auto& rng, V* out, size_t m) { distribution.sample(rng, out, m); }, threads);
+    }
+}
+
+#endif
+
+// src/Core/sampler.h
+
+#ifndef DF_SAMPLER_H
+#define DF_SAMPLER_H
+
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+
+namespace DiceForge
+{
+    /// @brief DiceForge::WeightedSampler - Draws indices in [0, n) with probabilities proportional to the given weights
+    /// @note Built once in O(n) (Vose's alias method), after which every draw takes O(1) regardless of n.
+    /// Changing weights rebuilds the table, so batch the changes with update(indices, weights) when possible.
+    class WeightedSampler
+    {
+    public:
+        /// @brief Builds the sampler from a sequence of finite non-negative weights (not all zero)
+        /// @param weights_first Iterator of first element of the weights list
+        /// @param weights_last Iterator after last element of the weights list
+        template <typename InputIterator>
+        WeightedSampler(InputIterator weights_first, InputIterator weights_last)
+            : WeightedSampler(std::vector<real_t>(weights_first, weights_last)) {}
+        /// @brief Builds the sampler from a list of finite non-negative weights (not all zero)
+        explicit WeightedSampler(std::vector<real_t> weights);
+
+        /// @brief Number of indices that can be drawn
+        size_t size() const;
+        /// @brief Weight of index i
+        real_t weight(size_t i) const;
+        /// @brief Probability of drawing index i
+        real_t probability(size_t i) const;
+
+        /// @brief Changes the weight of index i and rebuilds the table (O(n))
+        /// @note Throws std::invalid_argument, leaving the sampler as it was, for an index out of range, a weight
+        /// that is negative or not finite, or weights that would all be zero
+        void update(size_t i, real_t weight);
+        /// @brief Changes the weights of several indices and rebuilds the table once
+        /// @param indices_first Iterator of first element of the indices list
+        /// @param indices_last Iterator after last element of the indices list
+        /// @param weights_first Iterator of first element of the new weights (as many as indices)
+        /// @note The whole batch is checked as update(i, weight) before any weight changes
+        template <typename InputIterator1, typename InputIterator2>
+        void update(InputIterator1 indices_first, InputIterator1 indices_last, InputIterator2 weights_first)
+        {
+            std::vector<real_t> weights = m_weights;
+            for (; indices_first != indices_last; ++indices_first, ++weights_first)
+                set_weight(weights, *indices_first, *weights_first);
+            build(std::move(weights));
+        }
+
+        /// @brief Returns a random index, drawn with the given RNG
+        template <typename Engine>
+        size_t sample(Engine& rng) const
+        {
+            size_t i = size_t(detail::uniform_index(rng, uint64_t(m_prob.size())));
+            return (rng.next_unit() < m_prob[i]) ? i : m_alias[i];
+        }
+        /// @brief Fills out with k random indices, drawn with the given RNG
+        template <typename Engine>
+        void sample(Engine& rng, size_t* out, size_t k) const
+        {
+            for (size_t j = 0; j < k; j++)
+                out[j] = sample(rng);
+        }
+        /// @brief Maps a uniformly distributed unit random variable r to an index
+        /// @note The integer part of r * n picks a column of the table and its fractional part decides
+        /// between the column and its alias, so precision is lost for very large n
+        size_t index(real_t r) const;
+
+    private:
+        // Weights as given and their sum
+        std::vector<real_t> m_weights;
+        real_t m_total = 0;
+        // Probability of keeping each column, and the index it is paired with otherwise
+        std::vector<real_t> m_prob;
+        std::vector<size_t> m_alias;
+
+        static void check_weight(real_t weight);
+        // Checks index and weight, then writes the weight to weights
+        static void set_weight(std::vector<real_t>& weights, size_t i, real_t weight);
+        // Builds the table of the weights and takes them, changing nothing when it throws
+        void build(std::vector<real_t> weights);
+    };
+}
+
+#endif
+
+// src/Core/montecarlo.h
+
+#ifndef DF_MONTECARLO_H
+#define DF_MONTECARLO_H
+
+#include <vector>
+#include <utility>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+
+namespace DiceForge
+{
+    /// @brief Outcome of a Monte Carlo integration
+    struct monte_carlo_result
+    {
+        real_t value;       // estimate of the integral
+        real_t error;       // standard error of the estimate (one standard deviation)
+        size_t evaluations; // number of integrand evaluations used
+    };
+
+    /// @brief Variance reduction and threading for monte_carlo_integrate
+    struct monte_carlo_options
+    {
+        bool antithetic = false; // pair every point with its reflection through the centre of its stratum
+        size_t strata = 1;       // strata per dimension, 1 for plain sampling, 0 for about n / 8 strata in all
+        int threads = 0;         // threads for the chunks, 0 for std::thread::hardware_concurrency
+    };
+
+    namespace detail
+    {
+        // Sampling units (points, or antithetic pairs) per chunk, every chunk drawing from its own substream
+        constexpr size_t monte_carlo_chunk = 65536;
+        // Units whose uniforms are drawn in one bulk call
+        constexpr size_t monte_carlo_block = 256;
+
+        // Mean and sum of squared deviations of the units drawn in one stratum
+        struct stratum_stats
+        {
+            size_t stratum = 0, n = 0;
+            real_t mean = 0, m2 = 0;
+
+            void add(real_t y)
+            {
+                n++;
+                real_t delta = y - mean;
+                mean += delta / real_t(n);
+                m2 += delta * (y - mean);
+            }
+            void merge(const stratum_stats& other)
+            {
+                size_t total = n + other.n;
+                real_t delta = other.mean - mean;
+                mean += delta * real_t(other.n) / real_t(total);
+                m2 += other.m2 + delta * delta * real_t(n) * real_t(other.n) / real_t(total);
+                n = total;
+            }
+        };
+
+        // One chunk: the strata it starts and ends in, which may carry on into the neighbouring chunks, and the
+        // sums of the means and of the variances of the means over the strata lying wholly inside it
+        struct monte_carlo_part
+        {
+            stratum_stats first, last;
+            bool has_last = false;
+            real_t means = 0, variances = 0;
+        };
+    }
+
+    /// @brief Monte Carlo integration of f over a box in any number of dimensions
+    /// @param f the integrand f(const real_t* x), x holding one coordinate per dimension
+    /// @param domain lower and upper limit of every dimension
+    /// @param n number of evaluations of f
+    /// @param rng RNG the points are drawn with, advanced past all the random numbers used
+    /// @param options antithetic pairs, stratification and threads (see monte_carlo_options)
+    /// @return The integral with its standard error and the evaluations used
+    /// @note The box is cut into strata^d equal cells with the same number of points each, and the error is estimated
+    /// from the spread within the cells. The points are drawn in chunks, each from its own substream of rng (see
+    /// DiceForge::split) laid end to end, so the result does not depend on the number of threads. f is called from
+    /// all the threads at once. As with split, rng should have a fast jump.
+    template <typename F, typename Engine>
+    monte_carlo_result monte_carlo_integrate(F &&f, const std::vector<std::pair<real_t, real_t>>& domain, size_t n,
+                                             Engine& rng, monte_carlo_options options = {})
+    {
+        const size_t d = domain.size();
+        if (d == 0)
+            throw std::invalid_argument("Expected a domain of at least one dimension");
+        real_t volume = 1;
+        for (const std::pair<real_t, real_t>& bounds : domain)
+        {
+            if (!(std::isfinite(bounds.first) && std::isfinite(bounds.second)))
+                throw std::invalid_argument("Expected finite integration limits");
+            volume *= bounds.second - bounds.first;
+        }
+
+        const size_t units = options.antithetic ? n / 2 : n;
+        size_t k = options.strata;
+        if (k == 0)
+        {
+            // the largest k with k^d cells holding 8 units or more each
+            for (k = 1;; k++)
+            {
+                size_t cells = 1;
+                for (size_t j = 0; j < d && cells <= units / 8; j++)
+                    cells *= k + 1;
+                if (cells > units / 8)
+                    break;
+            }
+        }
+        size_t cells = 1;
+        for (size_t j = 0; j < d; j++)
+        {
+            if (cells > units / k / 2)
+                throw std::invalid_argument("Expected at least two points per stratum");
+            cells *= k;
+        }
+        const size_t per_cell = units / cells;
+        const size_t total = cells * per_cell;
+
+        const size_t chunks = (total + detail::monte_carlo_chunk - 1) / detail::monte_carlo_chunk;
+        std::vector<Engine> streams = split(rng, chunks, uint64_t(detail::monte_carlo_chunk) * d);
+        std::vector<detail::monte_carlo_part> parts(chunks);
+
+        auto job = [&](size_t c)
+        {
+            Engine& stream = streams[c];
+            detail::monte_carlo_part& part = parts[c];
+            const size_t begin = c * detail::monte_carlo_chunk, end = std::min(total, begin + detail::monte_carlo_chunk);
+            std::vector<real_t> u(detail::monte_carlo_block * d), x(d), lower(d), width(d);
+            for (size_t j = 0; j < d; j++)
+                width[j] = (domain[j].second - domain[j].first) / real_t(k);
+
+            detail::stratum_stats current;
+            bool has_first = false;
+            auto enter = [&](size_t stratum)
+            {
+                current = detail::stratum_stats();
+                current.stratum = stratum;
+                for (size_t j = 0; j < d; j++, stratum /= k)
+                    lower[j] = domain[j].first + real_t(stratum % k) * width[j];
+            };
+            enter(begin / per_cell);
+
+            for (size_t i = begin; i < end; i += detail::monte_carlo_block)
+            {
+                const size_t m = std::min(detail::monte_carlo_block, end - i);
+                stream.fill_unit(u.data(), m * d);
+                for (size_t t = 0; t < m; t++)
+                {
+                    const size_t stratum = (i + t) / per_cell;
+                    if (stratum != current.stratum)
+                    {
+                        if (!has_first)
+                        {
+                            part.first = current;
+                            has_first = true;
+                        }
+                        else
+                        {
+                            part.means += current.mean;
+                            part.variances += current.m2 / real_t(current.n - 1) / real_t(current.n);
+                        }
+                        enter(stratum);
+                    }
+
+                    const real_t* v = u.data() + t * d;
+                    for (size_t j = 0; j < d; j++)
+                        x[j] = lower[j] + v[j] * width[j];
+                    real_t y = f(static_cast<const real_t*>(x.data()));
+                    if (options.antithetic)
+                    {
+                        for (size_t j = 0; j < d; j++)
+                            x[j] = lower[j] + (1 - v[j]) * width[j];
+                        y = (y + f(static_cast<const real_t*>(x.data()))) / 2;
+                    }
+                    current.add(y);
+                }
+            }
+            if (!has_first)
+                part.first = current;
+            else
+            {
+                part.last = current;
+                part.has_last = true;
+            }
+        };
+        detail::parallel_for(chunks, options.threads, job);
+        // the last substream ends where the whole run does
+        rng = streams.back();
+
+        // strata cut by chunk boundaries are merged back together, in order
+        real_t means = 0, variances = 0;
+        auto close = [&](const detail::stratum_stats& s)
+        {
+            means += s.mean;
+            variances += s.m2 / real_t(s.n - 1) / real_t(s.n);
+        };
+        detail::stratum_stats open = parts[0].first;
+        for (size_t c = 0; c < chunks; c++)
+        {
+            const detail::monte_carlo_part& part = parts[c];
+            if (c > 0)
+            {
+                if (part.first.stratum == open.stratum)
+                    open.merge(part.first);
+                else
+                {
+                    close(open);
+                    open = part.first;
+                }
+            }
+            if (part.has_last)
+            {
+                close(open);
+                means += part.means;
+                variances += part.variances;
+                open = part.last;
+            }
+        }
+        close(open);
+
+        return {volume * means / real_t(cells), volume * std::sqrt(variances) / real_t(cells),
+                total * (options.antithetic ? 2 : 1)};
+    }
+}
+
+#endif
+
+// src/Core/2D.h
+
+#ifndef DF_2DRV_H
+#define DF_2DRV_H
+
+#if (__cplusplus >= 202002L)
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <tuple>
+#include <type_traits>
+#include <concepts>
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+
+namespace DiceForge
+{
+    /* Helper functions for integration */
+
+    namespace detail
+    {
+        // cos by its Taylor series, accurate for |x| <= pi, for the compile time starting guesses below
+        constexpr long double cos_series(long double x)
+        {
+            long double term = 1, sum = 1;
+            for (int k = 1; k < 40; k++)
+            {
+                term *= -x * x / ((2 * k - 1) * (2 * k));
+                sum += term;
+            }
+            return sum;
+        }
+
+        template <int N, typename T>
+        struct gauss_legendre_table
+        {
+            std::array<T, N> nodes{};   // roots of the Legendre polynomial P_N, increasing
+            std::array<T, N> weights{};
+        };
+
+        // Newton's method on P_N (evaluated by its three term recurrence) from the approximation
+        // cos(pi (i + 3/4) / (N + 1/2)) of the i-th largest root, carried out in long double
+        template <int N, typename T>
+        constexpr gauss_legendre_table<N, T> make_gauss_legendre()
+        {
+            static_assert(N >= 1, "a Gauss-Legendre rule needs at least one node");
+            constexpr long double pi = 3.141592653589793238462643383279502884L;
+            gauss_legendre_table<N, T> table;
+            for (int i = 0; i < (N + 1) / 2; i++)
+            {
+                long double x = (2 * i + 1 == N) ? 0 : cos_series(pi * (i + 0.75L) / (N + 0.5L)), dp = 0;
+                for (int iter = 0; iter < 100; iter++)
+                {
+                    long double p0 = 1, p1 = x;
+                    for (int k = 2; k <= N; k++)
+                    {
+                        long double p2 = ((2 * k - 1) * x * p1 - (k - 1) * p0) / k;
+                        p0 = p1;
+                        p1 = p2;
+                    }
+                    // P_N'(x) from P_N and P_(N-1)
+                    dp = (N == 1) ? 1 : N * (x * p1 - p0) / (x * x - 1);
+                    long double dx = p1 / dp;
+                    x -= dx;
+                    if (dx <= 1e-18L && dx >= -1e-18L)
+                        break;
+                }
+                long double w = 2 / ((1 - x * x) * dp * dp);
+                table.nodes[i] = T(-x);
+                table.nodes[N - 1 - i] = T(x);
+                table.weights[i] = table.weights[N - 1 - i] = T(w);
+            }
+            return table;
+        }
+
+        // Integrands evaluated in batches, f(const T* x, T* out, size_t n) as for the pdf of a distribution
+        template <typename F, typename T>
+        concept batch_integrand_c = std::is_invocable_v<F&, const T*, T*, size_t>;
+    }
+
+    /// @brief Nodes and weights of the N-point Gauss-Legendre rule on [-1, 1] in the type T, computed at compile time
+    template <int N, typename T = double>
+    inline constexpr detail::gauss_legendre_table<N, T> gauss_legendre_rule = detail::make_gauss_legendre<N, T>();
+
+    /// @brief N-point Gauss-Legendre quadrature of f over [x1, x2], exact for polynomials of degree below 2N
+    /// @param f the integrand, either f(x) or a batch integrand f(const T* x, T* out, size_t n) evaluating all the
+    /// nodes in one call (e.g. a vectorized pdf), no copies of it are made
+    /// @note Needs no heap memory; the nodes are mapped to [x1, x2] and the weighted sum is taken over arrays on the stack
+    template <int N, typename T, typename F>
+    T gauss_legendre(F &&f, T x1, T x2)
+    {
+        constexpr const detail::gauss_legendre_table<N, T>& rule = gauss_legendre_rule<N, T>;
+        const T a = (x2 - x1) / 2, b = (x2 + x1) / 2;
+        T x[N], y[N];
+        for (int i = 0; i < N; i++)
+            x[i] = a * rule.nodes[i] + b;
+
+        if constexpr (detail::batch_integrand_c<F, T>)
+            f(static_cast<const T*>(x), y, size_t(N));
+        else
+            for (int i = 0; i < N; i++)
+                y[i] = f(x[i]);
+
+        T I{};
+        for (int i = 0; i < N; i++)
+            I += rule.weights[i] * y[i];
+        return a * I;
+    }
+
+    /// @brief 64-point Gauss-Legendre quadrature of f over [x1, x2] (see gauss_legendre)
+    template <typename T1 = double, typename T2 = double (&)(double)>
+    T1 gaussian_quadrature(T2 &&f, T1 x1, T1 x2)
+    {
+        using value_t = std::conditional_t<std::is_floating_point_v<T1>, T1, double>;
+        return T1(gauss_legendre<64>(f, value_t(x1), value_t(x2)));
+    }
+    
+    /// @brief Adaptive Gauss-Kronrod quadrature of f over [a, b] to a relative error of about 100 epsilon of T1
+    /// (see integrate_adaptive for control over the tolerances and the evaluation budget)
+    template <typename T1 = double, typename T2 = double (&)(double)>
+    T1 adaptive_gaussian_quadrature(T2 &&f, T1 a, T1 b)
+    {
+        using value_t = std::conditional_t<std::is_floating_point_v<T1>, T1, double>;
+        constexpr value_t tolerance = std::numeric_limits<value_t>::epsilon();
+        return T1(integrate_adaptive<value_t>(f, value_t(a), value_t(b), 100 * tolerance, tolerance).value);
+    }
+    
+    // defining a concept which is a predicate to constrain template type T is of arithmetic type
+    template <typename T>
+    concept arithmetic_c = std::is_arithmetic_v<std::remove_cvref_t<T>>;
+    template <typename FuncType, typename ValueType>
+    auto evaluate(FuncType &&f, ValueType value)
+    {
+        if constexpr (DiceForge::arithmetic_c<FuncType>)
+        {
+            using common_t = std::common_type_t<FuncType, ValueType>;
+
+            return (common_t)f;
+        }
+        else if constexpr (requires { f(value); })
+            return f(value); // if f is function, then evaluate f(value);
+        else
+            static_assert(arithmetic_c<FuncType> || requires { f(value); });
+    }
+    // helper function for evaluating value
+    template <typename FuncType1, typename FuncType2, arithmetic_c ValueType>
+    auto evaluate(std::tuple<FuncType1, FuncType2> funcs, /* bound of integral */
+                  ValueType value)
+    {
+        return std::tuple{evaluate(std::get<0>(funcs), value), /*lower bound*/
+                          evaluate(std::get<1>(funcs), value) /*upper bound*/};
+    }
+
+    /// @brief An integrator for functions in one variable, to be used as integrate(f, bounds)
+    /// @param f the function to be integrated f(x)
+    /// @param bounds integration bounds as a tuple
+    /// @return The evaluated value of the integral
+    template <typename FuncType, typename BoundType>
+    BoundType integrate(FuncType &&f, std::tuple<BoundType, BoundType> bounds)
+    {
+        return gaussian_quadrature(f, std::get<0>(bounds), std::get<1>(bounds));
+    }
+
+    // use DiceForge::dx_dy for integration of f(x,y)dxdy and  DiceForge::dy_dx for integration of f(x,y)dydx
+
+    // Integrate wrt x first, then wrt y in f(x, y)
+    auto dx_dy = std::integer_sequence<int, 1, 0>{};
+    // Integrate wrt y first, then wrt x in f(x, y)
+    auto dy_dx = std::integer_sequence<int, 0, 1>{};
+
+    /// @brief An integrator for functions in two variables, to be used as integrate(f, bounds_0, bounds_1, integration sequence)
+    /// @param f the function to be integrated f(x, y)
+    /// @param bounds_0 integration bounds of the first variable (x or y depending on integration sequence) as a tuple
+    /// @param bounds_1 integration bounds of the second variable (x or y depending on integration sequence) as a tuple
+    /// @param integration_sequence dx_dy or dy_dx (using DiceForge::dx_dy, DiceForge::dy_dx)
+    /// @return The evaluated value of the integral
+    template <auto First, auto Second, typename FuncType,
+              typename Lower_0, typename Upper_0,
+              typename Lower_1, typename Upper_1>
+    std::common_type_t<Lower_0, Upper_0>
+    integrate(FuncType &&f,
+             std::tuple<Lower_0, Upper_0> bounds_0,
+             std::tuple<Lower_1, Upper_1> bounds_1, std::integer_sequence<int, First, Second> integration_sequence)
+    {
+        using bound_t = std::common_type_t<Lower_0, Upper_0>;
+
+        auto F0 = [&](auto v0)
+        {
+            auto F1 = [&](auto v1)
+            {
+                std::tuple<bound_t, bound_t> args{};
+
+                std::get<First>(args) = v0;
+                std::get<Second>(args) = v1;
+
+                return std::apply(f, args);
+            };
+
+            return DiceForge::integrate(F1, evaluate(bounds_1, v0));
+        };
+
+        return DiceForge::integrate(F0, bounds_0);
+    }
+
+    /// @brief Asks the two variable integrators below to spread their work over threads
+    struct parallel_t
+    {
+        int threads = 0; // total number of threads, 0 for std::thread::hardware_concurrency, 1 to stay serial
+    };
+    // Parallel execution on all hardware threads, parallel_t{n} for n threads
+    inline constexpr parallel_t parallel{};
+
+    namespace detail
+    {
+        // Calls f with v0 and v1 placed as the variables First and Second
+        template <auto First, auto Second, typename T, typename FuncType>
+        auto apply_ordered(FuncType &f, T v0, T v1)
+        {
+            std::tuple<T, T> args{};
+            std::get<First>(args) = v0;
+            std::get<Second>(args) = v1;
+            return std::apply(f, args);
+        }
+    }
+
+    /// @brief The two variable integrate(f, bounds_0, bounds_1, integration sequence) with the inner integrals of the
+    /// 64 outer nodes computed in parallel, e.g. integrate(f, bounds_0, bounds_1, DiceForge::dy_dx, DiceForge::parallel)
+    /// @param policy number of threads to use (f and the bounds are called from all of them at once)
+    /// @return The same value as the serial integrate, as every node is integrated on its own and the weighted sum is
+    /// taken in order
+    template <auto First, auto Second, typename FuncType,
+              typename Lower_0, typename Upper_0,
+              typename Lower_1, typename Upper_1>
+    std::common_type_t<Lower_0, Upper_0>
+    integrate(FuncType &&f,
+             std::tuple<Lower_0, Upper_0> bounds_0,
+             std::tuple<Lower_1, Upper_1> bounds_1, std::integer_sequence<int, First, Second> integration_sequence,
+             parallel_t policy)
+    {
+        using bound_t = std::common_type_t<Lower_0, Upper_0>;
+        using value_t = std::conditional_t<std::is_floating_point_v<bound_t>, bound_t, double>;
+        constexpr int N = 64;
+        constexpr const detail::gauss_legendre_table<N, value_t>& rule = gauss_legendre_rule<N, value_t>;
+
+        const value_t x1 = value_t(std::get<0>(bounds_0)), x2 = value_t(std::get<1>(bounds_0));
+        const value_t a = (x2 - x1) / 2, b = (x2 + x1) / 2;
+        value_t y[N];
+        auto node = [&](size_t i)
+        {
+            value_t v0 = a * rule.nodes[i] + b;
+            auto F1 = [&](auto v1) { return detail::apply_ordered<First, Second, bound_t>(f, v0, v1); };
+            y[i] = value_t(DiceForge::integrate(F1, evaluate(bounds_1, v0)));
+        };
+        detail::parallel_for(N, policy.threads, node);
+
+        value_t I{};
+        for (int i = 0; i < N; i++)
+            I += rule.weights[i] * y[i];
+        return bound_t(a * I);
+    }
+
+    namespace detail
+    {
+        // Genz-Malik degree 7 rule on a rectangle with its embedded degree 5 rule, the 17 points being the centre,
+        // 2 x 4 points on the axes at +-lambda_2 and +-lambda_3, and 2 x 4 on the diagonals at +-lambda_4 and +-lambda_5
+        // (all as fractions of the half widths)
+        constexpr long double genz_malik_lambda2 = 0.358568582800318091990645153907937L; // sqrt(9/70)
+        constexpr long double genz_malik_lambda3 = 0.948683298050513799599668063329816L; // sqrt(9/10)
+        constexpr long double genz_malik_lambda5 = 0.688247201611685297721628734293624L; // sqrt(9/19)
+        // weights of the degree 7 rule in two dimensions, for a unit volume
+        constexpr long double genz_malik_w7[5] = {-3816.0L / 19683, 980.0L / 6561, 1020.0L / 19683, 200.0L / 19683,
+                                                  6859.0L / 78732};
+        // and of the degree 5 rule, which has no lambda_5 points
+        constexpr long double genz_malik_w5[4] = {-971.0L / 729, 245.0L / 486, 65.0L / 1458, 25.0L / 729};
+
+        template <typename T>
+        struct cubature_region
+        {
+            T c[2], h[2];  // centre and half widths
+            T value, error;
+            int split;     // axis along which the integrand varies the most
+            bool operator<(const cubature_region& other) const { return error < other.error; }
+        };
+
+        // Genz-Malik estimate of the integral of g(u, v) over the rectangle, the error being |degree 7 - degree 5|
+        template <typename T, typename G>
+        cubature_region<T> genz_malik(G &g, T c0, T c1, T h0, T h1)
+        {
+            const T l2 = T(genz_malik_lambda2), l3 = T(genz_malik_lambda3), l4 = l3, l5 = T(genz_malik_lambda5);
+            const T f0 = g(c0, c1);
+
+            const T a2 = g(c0 + l2 * h0, c1), b2 = g(c0 - l2 * h0, c1);
+            const T a3 = g(c0 + l3 * h0, c1), b3 = g(c0 - l3 * h0, c1);
+            const T c2 = g(c0, c1 + l2 * h1), d2 = g(c0, c1 - l2 * h1);
+            const T c3 = g(c0, c1 + l3 * h1), d3 = g(c0, c1 - l3 * h1);
+            const T s4 = g(c0 + l4 * h0, c1 + l4 * h1) + g(c0 + l4 * h0, c1 - l4 * h1) +
+                         g(c0 - l4 * h0, c1 + l4 * h1) + g(c0 - l4 * h0, c1 - l4 * h1);
+            const T s5 = g(c0 + l5 * h0, c1 + l5 * h1) + g(c0 + l5 * h0, c1 - l5 * h1) +
+                         g(c0 - l5 * h0, c1 + l5 * h1) + g(c0 - l5 * h0, c1 - l5 * h1);
+            const T s2 = a2 + b2 + c2 + d2, s3 = a3 + b3 + c3 + d3;
+
+            // fourth differences along each axis (lambda_2^2 / lambda_3^2 = 1/7) pick the axis to split
+            const T diff0 = std::fabs(a2 + b2 - 2 * f0 - (a3 + b3 - 2 * f0) / 7);
+            const T diff1 = std::fabs(c2 + d2 - 2 * f0 - (c3 + d3 - 2 * f0) / 7);
+
+            const T volume = 4 * h0 * h1;
+            const T I7 = volume * (T(genz_malik_w7[0]) * f0 + T(genz_malik_w7[1]) * s2 + T(genz_malik_w7[2]) * s3 +
+                                   T(genz_malik_w7[3]) * s4 + T(genz_malik_w7[4]) * s5);
+            const T I5 = volume * (T(genz_malik_w5[0]) * f0 + T(genz_malik_w5[1]) * s2 + T(genz_malik_w5[2]) * s3 +
+                                   T(genz_malik_w5[3]) * s4);
+            return {{c0, c1}, {h0, h1}, I7, std::fabs(I7 - I5), diff1 > diff0 ? 1 : 0};
+        }
+    }
+
+    // Regions bisected per round of the adaptive cubature
+    constexpr size_t cubature_batch = 16;
+
+    /// @brief Adaptive Genz-Malik cubature of f over a two variable domain, to be used as
+    /// cubature(f, bounds_0, bounds_1, integration sequence), with the same bounds as the two variable integrate
+    /// @param f the function to be integrated f(x, y)
+    /// @param bounds_0 constant integration bounds of the outer variable as a tuple
+    /// @param bounds_1 integration bounds of the inner variable as a tuple of constants or functions of the outer one,
+    /// which makes domains such as triangles and discs possible
+    /// @param integration_sequence dx_dy or dy_dx (using DiceForge::dx_dy, DiceForge::dy_dx)
+    /// @param rel_tol requested error relative to the magnitude of the integral
+    /// @param abs_tol requested absolute error (the looser of the two is used)
+    /// @param max_evaluations evaluation budget, after which the best estimate so far is returned
+    /// @param policy threads to evaluate the regions with, serial by default (f and the bounds are called from all of
+    /// them at once otherwise)
+    /// @return The integral with its error estimate, the evaluations used and whether the tolerance was met
+    /// @note The inner variable is mapped linearly onto [0, 1] between its bounds, which turns the domain into a
+    /// rectangle. The regions are kept in a heap ordered by their error and every round bisects up to
+    /// cubature_batch of the worst ones along the axis where f varies the most, the new regions being evaluated in
+    /// parallel. The rounds do not depend on the number of threads, and neither does the result.
+    template <auto First, auto Second, typename FuncType,
+              typename Lower_0, typename Upper_0,
+              typename Lower_1, typename Upper_1,
+              typename T = std::conditional_t<std::is_floating_point_v<std::common_type_t<Lower_0, Upper_0>>,
+                                              std::common_type_t<Lower_0, Upper_0>, double>>
+    quadrature_result<T> cubature(FuncType &&f,
+                                  std::tuple<Lower_0, Upper_0> bounds_0,
+                                  std::tuple<Lower_1, Upper_1> bounds_1,
+                                  std::integer_sequence<int, First, Second> integration_sequence,
+                                  T rel_tol = T(1e-10), T abs_tol = T(1e-14), size_t max_evaluations = 1000000,
+                                  parallel_t policy = parallel_t{1})
+    {
+        using bound_t = std::common_type_t<Lower_0, Upper_0>;
+        constexpr size_t points = 17;
+
+        // f on the rectangle [x1, x2] x [0, 1], with the Jacobian of the inner variable's mapping
+        auto g = [&](T v0, T t)
+        {
+            auto [lower, upper] = evaluate(bounds_1, v0);
+            const T lo = T(lower), width = T(upper) - lo;
+            return T(detail::apply_ordered<First, Second, bound_t>(f, v0, lo + width * t)) * width;
+        };
+
+        const T x1 = T(std::get<0>(bounds_0)), x2 = T(std::get<1>(bounds_0));
+        std::vector<detail::cubature_region<T>> heap;
+        heap.push_back(detail::genz_malik<T>(g, (x1 + x2) / 2, T(0.5), (x2 - x1) / 2, T(0.5)));
+        T value = heap[0].value, error = heap[0].error;
+        size_t evaluations = points;
+
+        std::vector<detail::cubature_region<T>> children;
+        bool converged = false;
+        while (true)
+        {
+            if (error <= std::max(abs_tol, rel_tol * std::fabs(value)))
+            {
+                converged = true;
+                break;
+            }
+            const size_t batch = std::min({cubature_batch, heap.size(), (max_evaluations - std::min(max_evaluations, evaluations)) / (2 * points)});
+            if (batch == 0)
+                break;
+
+            // the halves of the worst regions, set up here and evaluated below
+            children.resize(2 * batch);
+            bool splittable = true;
+            for (size_t k = 0; k < batch; k++)
+            {
+                std::pop_heap(heap.begin(), heap.end());
+                detail::cubature_region<T> worst = heap.back();
+                heap.pop_back();
+                value -= worst.value;
+                error -= worst.error;
+
+                const int axis = worst.split;
+                const T h = worst.h[axis] / 2;
+                splittable = splittable && worst.c[axis] - h != worst.c[axis] && worst.c[axis] + h != worst.c[axis];
+                children[2 * k] = children[2 * k + 1] = worst;
+                children[2 * k].h[axis] = children[2 * k + 1].h[axis] = h;
+                children[2 * k].c[axis] -= h;
+                children[2 * k + 1].c[axis] += h;
+            }
+
+            auto job = [&](size_t k)
+            {
+                const detail::cubature_region<T>& r = children[k];
+                children[k] = detail::genz_malik<T>(g, r.c[0], r.c[1], r.h[0], r.h[1]);
+            };
+            detail::parallel_for(children.size(), policy.threads, job);
+            evaluations += points * children.size();
+
+            for (const detail::cubature_region<T>& child : children)
+            {
+                value += child.value;
+                error += child.error;
+                heap.push_back(child);
+                std::push_heap(heap.begin(), heap.end());
+            }
+            // the regions can not be split any further in this precision
+            if (!splittable)
+                break;
+        }
+
+        // the running sums drift, so the final totals are added up again
+        value = error = T(0);
+        for (const detail::cubature_region<T>& region : heap)
+        {
+            value += region.value;
+            error += region.error;
+        }
+        return {value, error, evaluations, converged};
+    }
+}
+
+#endif
+#endif
+
+// src/Core/views.h
+
+#ifndef DF_VIEWS_H
+#define DF_VIEWS_H
+
+// Lazy views of random streams, for range pipelines and coroutine consumers (C++20)
+#if (__cplusplus >= 202002L) && __has_include(<ranges>)
+
+#include <vector>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#if __has_include(<coroutine>) && defined(__cpp_impl_coroutine)
+#include <coroutine>
+// Set when DiceForge::Stream and the coroutine streams are available
+#define DF_COROUTINES
+#endif
+
+
+namespace DiceForge
+{
+    namespace detail
+    {
+        // Values drawn at a time by the views and streams: 8 KiB of reals, which stay in L1 while a pipeline
+        // consumes them
+        constexpr size_t view_block = 1024;
+
+        // The values a distribution samples: integers for those derived from Discrete, reals otherwise
+        template <typename Distribution>
+        using sample_t = std::conditional_t<std::is_base_of_v<Discrete, Distribution>, int_t, real_t>;
+
+        // Fills for block_view: reals of fill_unit, integers of fill, values of sample (pointers, so that the views
+        // stay default constructible and copyable)
+        template <typename Derived, typename T>
+        struct unit_fill
         {
-            return generate();
+            StaticGenerator<Derived, T>* rng = nullptr;
+            void operator()(real_t* out, size_t n) const { rng->fill_unit(out, n); }
         };
-        /// @brief Returns a random real between 0 and 1
-        /// @returns An floating-point real number (64 bit)
-        real_t next_unit()
+
+        template <typename Derived, typename T>
+        struct integer_fill
         {
-            real_t x = 1.0;
-            while (x == 1.0) {
-                x = generate() / real_t(std::numeric_limits<T>().max());
-            }
-            return x;
-        }
-        /// @brief Returns a random integer in the specified range
-        /// @param min minimum value of the random number (inclusive)
-        /// @param max maximum value of the random number (inclusive)
-        /// @returns An signed integer (64 bit)
-        int64_t next_in_range(T min, T max)
+            StaticGenerator<Derived, T>* rng = nullptr;
+            void operator()(T* out, size_t n) const { rng->fill(out, n); }
+        };
+
+        template <typename Distribution, typename Derived, typename T>
+        struct sample_fill
         {
-            return (int64_t)floor(next_unit() * (max - min + 1)) + min;
+            Distribution* distribution = nullptr;
+            StaticGenerator<Derived, T>* rng = nullptr;
+            void operator()(sample_t<Distribution>* out, size_t n) const { distribution->sample(*rng, out, n); }
         };
-        /// @brief Returns a random real number in the specified range
-        /// @param min minimum value of the random number
-        /// @param max maximum value of the random number
-        /// @returns An signed floating-point real number (64 bit)
-        real_t next_in_crange(real_t min, real_t max)
+
+        /// @brief An endless input view handing out the values of a buffer, refilled a block at a time by fill
+        /// @note As std::ranges::istream_view, the view holds the buffer and its iterators point to the view: the
+        /// first block is drawn by begin(), and the values are those of a single pass
+        template <typename V, typename Fill>
+        class block_view : public std::ranges::view_interface<block_view<V, Fill>>
         {
-            real_t x = (real_t)max;
-            while (x == max) {
-                x = (max - min) * next_unit() + min;
+        private:
+            Fill fill;
+            std::vector<V> buffer;
+            void refill()
+            {
+                fill(buffer.data(), buffer.size());
+            }
+        public:
+            class iterator
+            {
+            private:
+                // The current value and the end of the buffer, kept here rather than in the view so that the
+                // loop of a pipeline runs on registers
+                block_view* parent = nullptr;
+                const V* current = nullptr;
+                const V* last = nullptr;
+            public:
+                typedef V value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef std::input_iterator_tag iterator_concept;
+                iterator() = default;
+                explicit iterator(block_view* parent)
+                    : parent(parent), current(parent->buffer.data()), last(current + parent->buffer.size()) {}
+                const V& operator*() const
+                {
+                    return *current;
+                }
+                iterator& operator++()
+                {
+                    if (++current == last) {
+                        parent->refill();
+                        current = parent->buffer.data();
+                    }
+                    return *this;
+                }
+                void operator++(int)
+                {
+                    ++*this;
+                }
+            };
+
+            block_view() = default;
+            block_view(Fill fill, size_t block) : fill(fill), buffer(block > 0 ? block : 1) {}
+            iterator begin()
+            {
+                refill();
+                return iterator(this);
+            }
+            std::unreachable_sentinel_t end() const
+            {
+                return std::unreachable_sentinel;
             }
-            return x;
         };
-        /// @brief Re-initializes the RNG with specified seed
-        /// @param seed seed provided for initialization
-        void reset_seed(T seed)
+    }
+
+    namespace views
+    {
+        /// @brief An endless view of random reals between 0 and 1
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of
+        /// one), which must outlive the view
+        /// @param block number of values drawn at a time with fill_unit
+        /// @note Compose with std::views::take for a finite range; the last block is drawn whole, so the RNG moves
+        /// on by a multiple of the block
+        template <typename Derived, typename T>
+        auto uniform(StaticGenerator<Derived, T>& rng, size_t block = detail::view_block)
         {
-            reseed(seed);
+            return detail::block_view<real_t, detail::unit_fill<Derived, T>>({&rng}, block);
         }
 
-        /// @brief Returns a random element from the sequence
-        /// @param first Iterator of first element (like .begin() of vectors)
-        /// @param last Iterator after last element (like .end() of vectors)
-        template <typename RandomAccessIterator>
-        auto choice(RandomAccessIterator first, RandomAccessIterator last)
+        /// @brief An endless view of the random integers of the RNG
+        /// @note As uniform, drawn with fill
+        template <typename Derived, typename T>
+        auto integers(StaticGenerator<Derived, T>& rng, size_t block = detail::view_block)
         {
-            return *(first + next_in_range(0, last - first - 1));
-        };
+            return detail::block_view<T, detail::integer_fill<Derived, T>>({&rng}, block);
+        }
 
-        /// @brief Returns a random element from the sequence
-        /// @param first Iterator of first element (like .begin() of vectors)
-        /// @param last Iterator after last element (like .end() of vectors)
-        /// @param weights_first Iterator of first element of the weights list
-        /// @param weights_last Iterator after last element of the weights list
-        /// @note weights here refer to an array containing the probability weights for each element in the input sequence
-        template <typename RandomAccessIterator1, typename RandomAccessIterator2>
-        auto choice(RandomAccessIterator1 first, RandomAccessIterator1 last,
-                    RandomAccessIterator2 weights_first, RandomAccessIterator2 weights_last)
+        /// @brief An endless view of values of a distribution
+        /// @param distribution any distribution with a batch sample(rng, out, n) (of integers for those derived from
+        /// Discrete, of reals otherwise), which must outlive the view
+        /// @param rng A random number generator, which must outlive the view
+        /// @note As uniform, drawn with distribution.sample
+        template <typename Distribution, typename Derived, typename T>
+        auto sample(Distribution& distribution, StaticGenerator<Derived, T>& rng, size_t block = detail::view_block)
         {
-            if (last - first != weights_last - weights_first){
-                throw std::invalid_argument("Lengths of sequence and weight sequence must be equal!");
-            }
-            else if (last == first){
-                throw std::invalid_argument("Sequence must have non-zero length!");
+            typedef detail::sample_t<Distribution> V;
+            return detail::block_view<V, detail::sample_fill<Distribution, Derived, T>>({&distribution, &rng}, block);
+        }
+    }
+
+#if defined(DF_COROUTINES)
+    /// @brief DiceForge::Stream - A coroutine generating values of type V one at a time, and an input range of them
+    /// @note The coroutine runs up to its first value when begin() (or next()) is first called, and on to the
+    /// next one at each increment. A Stream is moved, not copied.
+    template <typename V>
+    class Stream : public std::ranges::view_interface<Stream<V>>
+    {
+    public:
+        struct promise_type
+        {
+            const V* current = nullptr;
+            Stream get_return_object()
+            {
+                return Stream(std::coroutine_handle<promise_type>::from_promise(*this));
             }
-            auto cumulative_weights = (decltype(&(*weights_first)))malloc(sizeof(*weights_first) * (last - first));
-            auto prev = *weights_first;
-            prev = 0;
-            for (auto it = weights_first; it != weights_last; it++){
-                cumulative_weights[it - weights_first] = prev + *it;
-                prev = cumulative_weights[it - weights_first];
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            std::suspend_always yield_value(const V& value) noexcept
+            {
+                current = std::addressof(value);
+                return {};
             }
-            auto ans = *(first + (std::upper_bound(cumulative_weights, &(cumulative_weights[last - first - 1]) + 1, next_unit() * cumulative_weights[last - first - 1]) - cumulative_weights));
-            free(cumulative_weights);
-            return ans;
+            void return_void() {}
+            void unhandled_exception() { throw; }
         };
 
-        /// @brief Shuffles the sequence in place
-        /// @param first Iterator of first element (like .begin() of vectors)
-        /// @param last Iterator after last element (like .end() of vectors)
-        template <typename RandomAccessIterator>
-        void shuffle(RandomAccessIterator first, RandomAccessIterator last)
+        class iterator
         {
-            auto temp = (decltype(&(*first)))malloc(sizeof(*first) * (last - first));
-            for (auto it = first; it != last; it++){
-                temp[it - first] = *it;
+        private:
+            std::coroutine_handle<promise_type> handle;
+        public:
+            typedef V value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef std::input_iterator_tag iterator_concept;
+            iterator() = default;
+            explicit iterator(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+            const V& operator*() const
+            {
+                return *handle.promise().current;
             }
-            shuffle_array(temp, last - first);
-            for (auto it = first; it!= last; it++){
-                *it = temp[it - first];
+            iterator& operator++()
+            {
+                handle.resume();
+                return *this;
             }
-        };
-        /*** Note: These are the only functions to be implemented by the implementation RNG ***/
-    private:
-        /// @brief Should return a random integer generated by the RNG
-        virtual T generate() = 0;
-        /// @brief Should initialize the seed for the RNG
-        virtual void reseed(T seed) = 0;
-        /// @brief Shuffles the array in place
-        /// @param arr Pointer to the first element
-        /// @param len Length of the array
-        template <typename other_T>
-        void shuffle_array(other_T arr[], T len) {
-            T ind;
-            std::vector<other_T> v;
-            for (int i = 0; i < len; i++) {
-                v.push_back(arr[i]);
-            }
-            for (int i = 0; i < len; i++) {
-                ind = next_in_range(0, len - i - 1);
-                arr[i] = v[ind];
-                v.erase(v.begin() + ind);
+            void operator++(int)
+            {
+                ++*this;
+            }
+            friend bool operator==(const iterator& i, std::default_sentinel_t)
+            {
+                return !i.handle || i.handle.done();
             }
         };
+
+        Stream() = default;
+        Stream(Stream&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+        Stream& operator=(Stream&& other) noexcept
+        {
+            if (this != &other) {
+                if (handle)
+                    handle.destroy();
+                handle = std::exchange(other.handle, nullptr);
+            }
+            return *this;
+        }
+        ~Stream()
+        {
+            if (handle)
+                handle.destroy();
+        }
+        /// @brief Runs the coroutine up to its first value
+        iterator begin()
+        {
+            if (handle && !handle.done() && handle.promise().current == nullptr)
+                handle.resume();
+            return iterator(handle);
+        }
+        std::default_sentinel_t end() const
+        {
+            return std::default_sentinel;
+        }
+        /// @brief Returns the next value of the coroutine, which must not have ended
+        V next()
+        {
+            handle.resume();
+            return *handle.promise().current;
+        }
+    private:
+        std::coroutine_handle<promise_type> handle = nullptr;
+        explicit Stream(std::coroutine_handle<promise_type> handle) : handle(handle) {}
     };
 
-    /// @brief DiceForge::Continuous - A generic class for distributions describing continuous random variables
-    class Continuous
+    /// @brief An endless stream of random reals between 0 and 1, drawn block by block with fill_unit
+    /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one),
+    /// which must outlive the stream
+    template <typename Derived, typename T>
+    Stream<real_t> uniform_stream(StaticGenerator<Derived, T>& rng, size_t block = detail::view_block)
     {
-    public:
-        /// @brief Returns the theoretical variance of the distribution
-        virtual real_t variance() const = 0;
-        /// @brief Returns the theoretical expectation value of the distribution
-        virtual real_t expectation() const = 0;
-        /// @brief Returns the minimum possible value of the random variable described by the distribution
-        virtual real_t minValue() const = 0;
-        /// @brief Returns the maximum possible value of the random variable described by the distribution
-        virtual real_t maxValue() const = 0;
-        /// @brief Probabiliity density function (pdf) of the distribution
-        /// @param x location where the pdf is to be evaluated
-        virtual real_t pdf(real_t x) const = 0;
-        /// @brief Cumulative distribution function (cdf) of the distribution
-        /// @param x location where the cdf is to be evaluated [P(X <= x)]
-        virtual real_t cdf(real_t x) const = 0;
-    };
+        std::vector<real_t> buffer(block > 0 ? block : 1);
+        while (true) {
+            rng.fill_unit(buffer.data(), buffer.size());
+            for (const real_t& x : buffer)
+                co_yield x;
+        }
+    }
 
-    /// @brief DiceForge::Discrete - A generic class for distributions describing discrete random variables
-    class Discrete
+    /// @brief An endless stream of values of a distribution, drawn block by block with its batch sample
+    /// @param distribution any distribution with a batch sample(rng, out, n), which must outlive the stream
+    /// @param rng A random number generator, which must outlive the stream
+    template <typename Distribution, typename Derived, typename T>
+    Stream<detail::sample_t<Distribution>> sample_stream(Distribution& distribution, StaticGenerator<Derived, T>& rng,
+                                                          size_t block = detail::view_block)
     {
-    public:
-        /// @brief Returns the theoretical variance of the distribution
-        virtual real_t variance() const = 0;
-        /// @brief Returns the theoretical expectation value of the distribution
-        virtual real_t expectation() const = 0;
-        /// @brief Returns the minimum possible value of the random variable described by the distribution
-        virtual int_t minValue() const = 0;
-        /// @brief Returns the maximum possible value of the random variable described by the distribution
-        virtual int_t maxValue() const = 0;
-        /// @brief Probabiliity mass function (pmf) of the distribution
-        /// @param x location where the pdf is to be evaluated [P(X = x)]
-        virtual real_t pmf(int_t x) const = 0;
-        /// @brief Cumulative distribution function (cdf) of the distribution
-        /// @param x location where the cdf is to be evaluated [P(X <= x)]
-        virtual real_t cdf(int_t x) const = 0;
-    };
+        std::vector<detail::sample_t<Distribution>> buffer(block > 0 ? block : 1);
+        while (true) {
+            distribution.sample(rng, buffer.data(), buffer.size());
+            for (const auto& x : buffer)
+                co_yield x;
+        }
+    }
+#endif
+}
+
+#endif
+
+#endif
+
+// src/Core/bigint.h
 
+#ifndef DF_BigInt128_H
+#define DF_BigInt128_H
+
+
+namespace DiceForge{
     /**
      * @brief A struct representing a 128-bit integer.
      * 
@@ -298,204 +4862,8 @@ namespace DiceForge
             }
         }
     };
-
-    #if (__cplusplus >= 202002L)  // Atleast C++ 20 is required to use integration for 2D Random Variables
-
-    /* Helper functions for integration of 2D PDF */
-
-    template <typename valuetype = long double>
-    auto weights()
-    {
-        using pair_t = std::pair<valuetype, valuetype>;
-        using wts = std::vector<pair_t>;
-
-        return wts
-        {
-                std::make_pair(0.0486909570091397, -0.024350292663424),
-                std::make_pair(0.0486909570091397, 0.0243502926634244),
-                std::make_pair(0.0485754674415034, -0.072993121787799),
-                std::make_pair(0.0485754674415034, 0.0729931217877990),
-                std::make_pair(0.0483447622348030, -0.121462819296120),
-                std::make_pair(0.0483447622348030, 0.1214628192961206),
-                std::make_pair(0.0479993885964583, -0.169644420423992),
-                std::make_pair(0.0479993885964583, 0.1696444204239928),
-                std::make_pair(0.0475401657148303, -0.217423643740007),
-                std::make_pair(0.0475401657148303, 0.2174236437400071),
-                std::make_pair(0.0469681828162100, -0.264687162208767),
-                std::make_pair(0.0469681828162100, 0.2646871622087674),
-                std::make_pair(0.0462847965813144, -0.311322871990211),
-                std::make_pair(0.0462847965813144, 0.3113228719902110),
-                std::make_pair(0.0454916279274181, -0.357220158337668),
-                std::make_pair(0.0454916279274181, 0.3572201583376681),
-                std::make_pair(0.0445905581637566, -0.402270157963991),
-                std::make_pair(0.0445905581637566, 0.4022701579639916),
-                std::make_pair(0.0435837245293235, -0.446366017253464),
-                std::make_pair(0.0435837245293235, 0.4463660172534641),
-                std::make_pair(0.0424735151236536, -0.489403145707053),
-                std::make_pair(0.0424735151236536, 0.4894031457070530),
-                std::make_pair(0.0412625632426235, -0.531279464019894),
-                std::make_pair(0.0412625632426235, 0.5312794640198946),
-                std::make_pair(0.0399537411327203, -0.571895646202634),
-                std::make_pair(0.0399537411327203, 0.5718956462026340),
-                std::make_pair(0.0385501531786156, -0.611155355172393),
-                std::make_pair(0.0385501531786156, 0.6111553551723933),
-                std::make_pair(0.0370551285402400, -0.648965471254657),
-                std::make_pair(0.0370551285402400, 0.6489654712546573),
-                std::make_pair(0.0354722132568824, -0.685236313054233),
-                std::make_pair(0.0354722132568824, 0.6852363130542333),
-                std::make_pair(0.0338051618371416, -0.719881850171610),
-                std::make_pair(0.0338051618371416, 0.7198818501716109),
-                std::make_pair(0.0320579283548516, -0.752819907260531),
-                std::make_pair(0.0320579283548516, 0.7528199072605319),
-                std::make_pair(0.0302346570724025, -0.783972358943341),
-                std::make_pair(0.0302346570724025, 0.7839723589433414),
-                std::make_pair(0.0283396726142595, -0.813265315122797),
-                std::make_pair(0.0283396726142595, 0.8132653151227975),
-                std::make_pair(0.0263774697150547, -0.840629296252580),
-                std::make_pair(0.0263774697150547, 0.8406292962525803),
-                std::make_pair(0.0243527025687109, -0.865999398154092),
-                std::make_pair(0.0243527025687109, 0.8659993981540928),
-                std::make_pair(0.0222701738083833, -0.889315445995114),
-                std::make_pair(0.0222701738083833, 0.8893154459951141),
-                std::make_pair(0.0201348231535302, -0.910522137078502),
-                std::make_pair(0.0201348231535302, 0.9105221370785028),
-                std::make_pair(0.0179517157756973, -0.929569172131939),
-                std::make_pair(0.0179517157756973, 0.9295691721319396),
-                std::make_pair(0.0157260304760247, -0.946411374858402),
-                std::make_pair(0.0157260304760247, 0.9464113748584028),
-                std::make_pair(0.0134630478967186, -0.961008799652053),
-                std::make_pair(0.0134630478967186, 0.9610087996520538),
-                std::make_pair(0.0111681394601311, -0.973326827789911),
-                std::make_pair(0.0111681394601311, 0.9733268277899110),
-                std::make_pair(0.0088467598263639, -0.983336253884626),
-                std::make_pair(0.0088467598263639, 0.9833362538846260),
-                std::make_pair(0.0065044579689784, -0.991013371476744),
-                std::make_pair(0.0065044579689784, 0.9910133714767443),
-                std::make_pair(0.0041470332605625, -0.996340116771955),
-                std::make_pair(0.0041470332605625, 0.9963401167719553),
-                std::make_pair(0.0017832807216964, -0.999305041735772),
-                std::make_pair(0.0017832807216964, 0.9993050417357722)
-            
-        };
-    }
-
-    template <typename T1 = double, typename T2 = double (&)(double)>
-    T1 gaussian_quadrature(T2 &&f, T1 x1, T1 x2)
-    {
-        auto weight = weights();
-        auto a = (x2 - x1) / 2.0;
-        auto b = (x2 + x1) / 2.0;
-        T1 I{};
-        for (auto &&[w, t] : weight)
-        {
-            I += w * f(a * t + b);
-        }
-        I *= a;
-        return I;
-    }
-    
-    template <typename T1 = double, typename T2 = double (&)(double)>
-    T1 adaptive_gaussian_quadrature(T2 &&f, T1 a, T1 b)
-    {
-        constexpr T1 tolerance = std::numeric_limits<T1>::epsilon();
-
-        auto c = (a + b) / 2;
-
-        auto s1 = gaussian_quadrature(f, a, b);
-
-        auto s2 = gaussian_quadrature(f, a, c) + gaussian_quadrature(f, c, b);
-
-        auto diff = std::abs(s1 - s2);
-
-        if (diff <= tolerance)
-        {
-            return s2;
-        }
-        else
-        {
-            return adaptive_gaussian_quadrature(f, a, c) + adaptive_gaussian_quadrature(f, c, b);
-        }
-    }
-    
-    // defining a concept which is a predicate to constrain template type T is of arithmetic type
-    template <typename T>
-    concept arithmetic_c = std::is_arithmetic_v<std::remove_cvref_t<T>>;
-    template <typename FuncType, typename ValueType>
-    auto evaluate(FuncType &&f, ValueType value)
-    {
-        if constexpr (DiceForge::arithmetic_c<FuncType>)
-        {
-            using common_t = std::common_type_t<FuncType, ValueType>;
-
-            return (common_t)f;
-        }
-        else if constexpr (requires { f(value); })
-            return f(value); // if f is function, then evaluate f(value);
-        else
-            static_assert(arithmetic_c<FuncType> || requires { f(value); });
-    }
-    // helper function for evaluating value
-    template <typename FuncType1, typename FuncType2, arithmetic_c ValueType>
-    auto evaluate(std::tuple<FuncType1, FuncType2> funcs, /* bound of integral */
-                  ValueType value)
-    {
-        return std::tuple{evaluate(std::get<0>(funcs), value), /*lower bound*/
-                          evaluate(std::get<1>(funcs), value) /*upper bound*/};
-    }
-
-    /// @brief An integrator for functions in one variable, to be used as integrate(f, bounds)
-    /// @param f the function to be integrated f(x)
-    /// @param bounds integration bounds as a tuple
-    /// @return The evaluated value of the integral
-    template <typename FuncType, typename BoundType>
-    BoundType integrate(FuncType &&f, std::tuple<BoundType, BoundType> bounds)
-    {
-        return gaussian_quadrature(f, std::get<0>(bounds), std::get<1>(bounds));
-    }
-
-    // use DiceForge::dx_dy for integration of f(x,y)dxdy and  DiceForge::dy_dx for integration of f(x,y)dydx
-
-    // Integrate wrt x first, then wrt y in f(x, y)
-    auto dx_dy = std::integer_sequence<int, 1, 0>{};
-    // Integrate wrt y first, then wrt x in f(x, y)
-    auto dy_dx = std::integer_sequence<int, 0, 1>{};
-
-    /// @brief An integrator for functions in two variables, to be used as integrate(f, bounds_0, bounds_1, integration sequence)
-    /// @param f the function to be integrated f(x, y)
-    /// @param bounds_0 integration bounds of the first variable (x or y depending on integration sequence) as a tuple
-    /// @param bounds_1 integration bounds of the second variable (x or y depending on integration sequence) as a tuple
-    /// @param integration_sequence dx_dy or dy_dx (using DiceForge::dx_dy, DiceForge::dy_dx)
-    /// @return The evaluated value of the integral
-    template <auto First, auto Second, typename FuncType,
-              typename Lower_0, typename Upper_0,
-              typename Lower_1, typename Upper_1>
-    std::common_type_t<Lower_0, Upper_0>
-    integrate(FuncType &&f,
-             std::tuple<Lower_0, Upper_0> bounds_0,
-             std::tuple<Lower_1, Upper_1> bounds_1, std::integer_sequence<int, First, Second> integration_sequence)
-    {
-        using bound_t = std::common_type_t<Lower_0, Upper_0>;
-
-        auto F0 = [&](auto v0)
-        {
-            auto F1 = [&](auto v1)
-            {
-                std::tuple<bound_t, bound_t> args{};
-
-                std::get<First>(args) = v0;
-                std::get<Second>(args) = v1;
-
-                return std::apply(f, args);
-            };
-
-            return DiceForge::integrate(F1, evaluate(bounds_1, v0));
-        };
-
-        return DiceForge::integrate(F0, bounds_0);
-    }
-
-    #endif
-
 }
 
 #endif
+
+#endif
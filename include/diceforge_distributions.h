@@ -1,11 +1,18 @@
+// Generated from src/ by tools/amalgamate.cmake (cmake --build <build> --target headers): edit the
+// sources rather than this file
+
 #ifndef DF_DISTRIBUTIONS_H
 #define DF_DISTRIBUTIONS_H
 
 #include "diceforge_core.h"
-#include <functional>
+
+// src/Distributions/Continuous/Cauchy/Cauchy.h
+
+#ifndef DF_CAUCHY_H
+#define DF_CAUCHY_H
+
 
 namespace DiceForge {
-    
     /// @brief DiceForge::Cauchy - A Continuous Probability Distribution (Cauchy) 
     class Cauchy : public Continuous {
         private:
@@ -19,6 +26,48 @@ namespace DiceForge {
             /// @brief Returns the next value of the random variable described by the distribution
             /// @param r A random real number uniformly distributed between 0 and 1
             real_t next(real_t r);
+            /// @brief Replaces n uniformly distributed unit random variables in place with values of the random variable
+            /// @param r Pointer to the first of the random variables, each as would be passed to next(r)
+            /// @param n Number of random variables
+            void transform(real_t* r, size_t n) const;
+            /// @brief Replaces n uniformly distributed unit random variables in place with values of the random
+            /// variable, in single precision
+            void transform(float* r, size_t n) const;
+            /// @brief Fills the buffer with values of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param out Pointer to the first element of the buffer
+            /// @param n Number of values to be written
+            /// @note The uniforms are drawn in bulk and transformed in one pass (see transform)
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, real_t* out, size_t n)
+            {
+                DF_INSTRUMENT_SAMPLES("Cauchy", n);
+                rng.fill_unit(out, n);
+                transform(out, n);
+            }
+            /// @brief Fills the buffer with single precision values of the random variable
+            /// @note Single precision uniforms (see StaticGenerator::fill_unit), transformed in single precision
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, float* out, size_t n)
+            {
+                DF_INSTRUMENT_SAMPLES("Cauchy", n);
+                rng.fill_unit(out, n);
+                transform(out, n);
+            }
+#if defined(DF_SPAN)
+            /// @brief Fills the span with values of the random variable described by the distribution
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<real_t> out)
+            {
+                sample(rng, out.data(), out.size());
+            }
+            /// @brief Fills the span with single precision values of the random variable
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<float> out)
+            {
+                sample(rng, out.data(), out.size());
+            }
+#endif
             /// @brief Returns the theoretical variance of the distribution
             /// @note The variation of a Cauchy distribution is undefined
             /// @returns NaN
@@ -37,6 +86,19 @@ namespace DiceForge {
             real_t pdf(real_t x) const override final;
             /// @brief Cumulative distribution function of the Cauchy distribution
             real_t cdf(real_t x) const override final;
+            /// @brief Natural logarithm of the probability density function of the Cauchy distribution
+            real_t logpdf(real_t x) const override final;
+            /// @brief Probability density function of the Cauchy distribution at the n locations x, written to out
+            void pdf(const real_t* x, real_t* out, size_t n) const override final;
+            /// @brief Logarithm of the probability density function at the n locations x, written to out
+            void logpdf(const real_t* x, real_t* out, size_t n) const override final;
+            /// @brief Cumulative distribution function at the n locations x, written to out
+            void cdf(const real_t* x, real_t* out, size_t n) const override final;
+            /// @brief Quantile function (inverse cdf) of the Cauchy distribution
+            /// @note x0 + gamma tan(pi (p - 1/2)), as -gamma / tan(pi p) or gamma / tan(pi (1 - p)) from the nearer tail
+            real_t quantile(real_t p) const override final;
+            /// @brief Quantile function at the n probabilities p, written to out (out may be p)
+            void quantile(const real_t* p, real_t* out, size_t n) const override final;
             /// @brief Returns x0 (centre of the distribution) 
             real_t get_x0() const;
             /// @brief Returns gamma (scale factor of the distribution) 
@@ -52,6 +114,33 @@ namespace DiceForge {
     /// @return A Cauchy distribution fit to the given sample points
     Cauchy fitToCauchy(std::vector<real_t> x, std::vector<real_t> y, int max_iter = 10000, real_t epsilon = 1e-6);
 
+    /// @brief Fits a Cauchy distribution to raw samples by maximum likelihood, with no binning. The sample median and
+    /// half the interquartile range (found in linear time) start Fisher scoring on the log-likelihood, each iteration
+    /// being one pass over the samples.
+    /// @param samples list of samples
+    /// @param max_iter maximum scoring iterations
+    /// @param epsilon change in x0 and gamma, relative to gamma, below which the fit has converged
+    /// @return The maximum likelihood Cauchy distribution of the samples
+    /// @note The Cauchy distribution has no finite sufficient statistics, so unlike the other distributions there is no
+    /// mergeable accumulator for it
+    Cauchy fitCauchyFromSamples(const std::vector<real_t>& samples, int max_iter = 100, real_t epsilon = 1e-12);
+}
+
+
+#endif
+
+// src/Distributions/Continuous/Custom/Custom.h
+
+#ifndef DF_CUSTOM_DISTRIBUTION_H
+#define DF_CUSTOM_DISTRIBUTION_H
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <stdexcept>
+#include <algorithm>
+
+namespace DiceForge {
     using PDF_Function = std::function<real_t(real_t)>;
 
     /// @brief DiceForge::CustomDistribution - Samples a continuous pdf, cutomised by the user 
@@ -62,27 +151,124 @@ namespace DiceForge {
         real_t lower_limit;
         real_t upper_limit;
         real_t m_expectation, m_variance;
-        std::vector<std::pair<real_t, real_t>> cdf_values; // (input, cdf)
+        // The tables, held in memory or read in place from a table file (see save_table), and shared by copies
+        // The pdf (normalised) at the knots and the midpoints between them, 2 n + 1 values
+        detail::TableArray<real_t> density;
+        // Inverse cdf table: the grid knots, the cdf at each of them (normalised to end at 1), and for each
+        // segment the slopes dx/dcdf at its two ends (Hermite interpolation, equal to the secant when linear)
+        detail::TableArray<real_t> knots;
+        detail::TableArray<real_t> knot_cdf;
+        detail::TableArray<real_t> slope_left;
+        detail::TableArray<real_t> slope_right;
+        // guide[j] = the segment holding the cdf value j / guide.size()
+        detail::TableArray<uint64_t> guide;
         PDF_Function pdf_function; // Declare pdf_function as a member variable
 
+        // Value of the inverse cdf at u
+        real_t invert(real_t u) const;
+        // Builds the tables from the pdf at the 2 n + 1 points of the half-step grid
+        void build(std::vector<real_t>& f, bool smooth);
+
     public:
         /// @brief Constructor for Custom Distribution
         /// @param lower lower bound for the random variable (finite)
         /// @param upper upper bound for the random variable (finite)
         /// @param pdf probability density function describing the distribution
         /// @param n number of points where the pdf should be sampled for expectation, variance and cdf calculations (higher n provides better accuracy) 
-        CustomDistribution(real_t lower, real_t upper, PDF_Function pdf, int n);
+        /// @param smooth inverts the cdf by monotone cubic Hermite interpolation, using the pdf at the knots, instead of linearly
+        /// @note The pdf is evaluated once at each of the 2 n + 1 points of a half-step grid, and the cdf (by Simpson's
+        /// rule) and the sampling tables are computed from those values. The expectation and variance are
+        /// integrated from the pdf by adaptive Gauss-Kronrod quadrature (see integrate_adaptive).
+        template <typename Function>
+        CustomDistribution(real_t lower, real_t upper, Function pdf, int n = 1000, bool smooth = false)
+            : lower_limit(lower), upper_limit(upper), pdf_function(pdf)
+        {
+            if (!(upper > lower) || n < 1)
+                throw std::invalid_argument("Expected lower < upper and n >= 1!");
+
+            std::vector<real_t> f(2 * size_t(n) + 1);
+            const real_t h = (upper - lower) / (2 * real_t(n));
+            for (size_t i = 0; i < f.size(); i++)
+                f[i] = pdf((i + 1 == f.size()) ? upper : lower + i * h);
+            build(f, smooth);
+        }
+
+        /// @brief Constructor from the tables saved by save_table, sampling straight from the mapped file
+        /// @param path table file written by save_table
+        /// @param pdf the pdf the tables were built from, for pdf(x); when not given, pdf(x) interpolates the
+        /// normalised pdf from the table instead
+        /// @note Costs the mapping of the file and a check of its header, with neither a pdf evaluation nor an
+        /// integration. The values drawn are those of the distribution that saved the tables. Every process
+        /// mapping the file shares one copy of it in the page cache. std::invalid_argument if the file does not
+        /// hold the tables of a CustomDistribution.
+        explicit CustomDistribution(const std::string& path, PDF_Function pdf = PDF_Function());
+
+        /// @brief Writes the tables to a file, for the constructor from a path
+        /// @note The file is written under a temporary name and then renamed, so processes starting meanwhile
+        /// map either the whole old file or the whole new one. It holds doubles in the representation of this
+        /// machine, for machines of the same kind.
+        void save_table(const std::string& path) const;
 
         /// @brief Returns the next value of the random variable described by the distribution
         /// @param r A random real number uniformly distributed between 0 and 1
+        /// @note O(1): a guide table picks the segment of the inverse cdf table, which is then interpolated
         real_t next(real_t r);
+
+        /// @brief Replaces n uniformly distributed unit random variables in place with values of the random variable
+        /// @param r Pointer to the first of the random variables, each as would be passed to next(r)
+        /// @param n Number of random variables
+        void transform(real_t* r, size_t n) const;
+
+        /// @brief Fills the buffer with values of the random variable described by the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @param out Pointer to the first element of the buffer
+        /// @param n Number of values to be written
+        /// @note The uniforms are drawn in bulk and transformed in one pass (see transform)
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, real_t* out, size_t n)
+        {
+            DF_INSTRUMENT_SAMPLES("Custom", n);
+            rng.fill_unit(out, n);
+            transform(out, n);
+        }
+        /// @brief Fills the buffer with single precision values of the random variable
+        /// @note The table is inverted in double precision, a block at a time
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, float* out, size_t n)
+        {
+            DF_INSTRUMENT_SAMPLES("Custom", n);
+            real_t u[256];
+            while (n > 0) {
+                size_t m = std::min(n, size_t(256));
+                rng.fill_unit(u, m);
+                transform(u, m);
+                for (size_t j = 0; j < m; j++)
+                    out[j] = float(u[j]);
+                out += m;
+                n -= m;
+            }
+        }
+#if defined(DF_SPAN)
+        /// @brief Fills the span with values of the random variable described by the distribution
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<real_t> out)
+        {
+            sample(rng, out.data(), out.size());
+        }
+        /// @brief Fills the span with single precision values of the random variable
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<float> out)
+        {
+            sample(rng, out.data(), out.size());
+        }
+#endif
         
         /// @brief Returns the expected value of the distribution
-        /// @note The expectation value is approximate
+        /// @note The expectation value is integrated numerically, to a relative error of about 1e-10
         real_t expectation() const override final;
         
         /// @brief Returns the variance of the distribution
-        /// @note The variance is an approximatation 
+        /// @note The variance is integrated numerically, to a relative error of about 1e-10
         real_t variance() const override final;
 
         /// @brief Returns the minimum possible value of the random variable described by the distribution
@@ -93,56 +279,419 @@ namespace DiceForge {
 
         /// @brief Probabiliity density function (pdf) of the distribution
         /// @param x location where the pdf is to be evaluated
+        /// @note The pdf as given, or for a distribution read from a table file without one, the quadratic through
+        /// the normalised values of the table (the same interpolant as the cdf)
         real_t pdf(real_t x) const override final;
 
         /// @brief Cummalative density function (cdf) of the distribution
         /// @param x location where the pdf is to be evaluated
-        /// @note Numerical methods of inegration are emplyed to find the cdf value. This does not ensure that the function itself is integrable over the given range.
+        /// @note Integrates the quadratic through the pdf values of the segment holding x (the same interpolant as
+        /// Simpson's rule), so it costs O(1) and agrees with the table used for sampling
         real_t cdf(real_t x) const override final;
+        using Continuous::pdf;
+        using Continuous::cdf;
     };
-    
+} // namespace DiceForge
+
+#endif // DF_CUSTOM_DISTRIBUTION_H
+
+
+
+// src/Distributions/Continuous/Custom/AdaptiveRejection.h
+
+#ifndef DF_ADAPTIVE_REJECTION_H
+#define DF_ADAPTIVE_REJECTION_H
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <cmath>
+
+namespace DiceForge {
+    /// @brief DiceForge::AdaptiveRejection - Samples a log-concave density, customised by the user, over any interval
+    /// (unbounded ones included) by derivative-free adaptive rejection sampling (Gilks, 1992)
+    /// @details The envelope is made of the secants through the points where the log density is known, extended
+    /// past their ends, which lie above a concave function everywhere outside their own interval. Every value
+    /// rejected by the chords below (the squeeze) costs one call to the log density, and that point is added
+    /// to the envelope, so both close in on the density and nearly every later value is accepted at once.
+    /// @tparam LogDensity any callable returning the logarithm of a (not necessarily normalised) density at x
+    template <typename LogDensity>
+    class AdaptiveRejection {
+    public:
+        /// @brief Builds the initial envelope
+        /// @param log_density the logarithm of the density, concave over (lower, upper)
+        /// @param points at least 3 distinct points in (lower, upper) where the log density is finite. With an
+        /// unbounded lower (upper) limit the log density must increase between the two smallest (decrease between
+        /// the two largest) points, i.e. they must lie on both sides of the mode
+        /// @param lower lower limit of the support (may be -infinity)
+        /// @param upper upper limit of the support (may be +infinity)
+        /// @param max_points the envelope stops growing at this many points
+        AdaptiveRejection(LogDensity log_density, std::vector<real_t> points,
+                          real_t lower = -std::numeric_limits<real_t>::infinity(),
+                          real_t upper = std::numeric_limits<real_t>::infinity(), size_t max_points = 64)
+            : h(log_density), lower(lower), upper(upper), max_points(max_points)
+        {
+            std::sort(points.begin(), points.end());
+            points.erase(std::unique(points.begin(), points.end()), points.end());
+            if (points.size() < 3)
+                throw std::invalid_argument("At least 3 distinct starting points are needed!");
+            if (!(points.front() > lower) || !(points.back() < upper))
+                throw std::invalid_argument("The starting points must lie strictly inside (lower, upper)!");
+            for (real_t x : points) {
+                real_t y = h(x);
+                if (!std::isfinite(y))
+                    throw std::invalid_argument("The log density must be finite at the starting points!");
+                xs.push_back(x);
+                hs.push_back(y);
+            }
+            build();
+            if (std::isinf(lower) && !(slope(0) > 0))
+                throw std::invalid_argument("With an unbounded lower limit the log density must increase between the two smallest points!");
+            if (std::isinf(upper) && !(slope(xs.size() - 2) < 0))
+                throw std::invalid_argument("With an unbounded upper limit the log density must decrease between the two largest points!");
+        }
+
+        /// @brief Returns the next value of the random variable described by the density
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        template <typename Derived, typename T>
+        real_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+        {
+            DF_INSTRUMENT_SAMPLES("AdaptiveRejection", 1);
+            while (true) {
+                size_t i;
+                real_t x = from_envelope(rng.next_unit(), i);
+                real_t e = line_at(pieces[i], x), lv = std::log(rng.next_unit());
+                attempts++;
+                if (lv <= squeeze(x) - e) {
+                    accepted++;
+                    return x;
+                }
+                real_t y = h(x);
+                if (y > e + 1e-9 * (1 + std::fabs(e)))
+                    throw std::invalid_argument("The density is not log-concave!");
+                if (xs.size() < max_points && std::isfinite(y))
+                    insert(x, y);
+                if (lv <= y - e) {
+                    accepted++;
+                    return x;
+                }
+                DF_INSTRUMENT_REJECT("AdaptiveRejection");
+            }
+        }
+
+        /// @brief Fills the buffer with values of the random variable described by the density
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @param out Pointer to the first element of the buffer
+        /// @param n Number of values to be written
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, real_t* out, size_t n)
+        {
+            DF_INSTRUMENT_SAMPLES("AdaptiveRejection", n);
+            for (size_t i = 0; i < n; i++)
+                out[i] = next(rng);
+        }
+#if defined(DF_SPAN)
+        /// @brief Fills the span with values of the random variable described by the density
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<real_t> out)
+        {
+            sample(rng, out.data(), out.size());
+        }
+#endif
+
+        /// @brief Number of points the envelope is built on
+        size_t size() const { return xs.size(); }
+
+        /// @brief Fraction of the attempts so far that were accepted
+        real_t acceptance() const { return attempts ? real_t(accepted) / attempts : 1; }
+
+        /// @brief Fraction of the envelope's mass below the squeeze, an estimate of the acceptance rate to come
+        /// without any call to the log density
+        real_t efficiency() const
+        {
+            real_t inner = 0;
+            for (size_t i = 0; i + 1 < xs.size(); i++)
+                inner += mass(Piece{xs[i], xs[i + 1], xs[i], hs[i] - top, slope(i)});
+            return inner / total;
+        }
+
+    private:
+        // A piece of the envelope: the line y(x) = y0 + s (x - x0) over [a, b], shifted down by top
+        struct Piece { real_t a, b, x0, y0, s; };
+
+        LogDensity h;
+        real_t lower, upper;
+        size_t max_points;
+        // Points of the envelope, sorted, and the log density there
+        std::vector<real_t> xs, hs;
+        // Pieces of the envelope, the running sums of their masses, the total and the largest log value
+        std::vector<Piece> pieces;
+        std::vector<real_t> sums;
+        real_t total = 0, top = 0;
+        size_t attempts = 0, accepted = 0;
+
+        // Slope of the secant through points i and i + 1
+        real_t slope(size_t i) const { return (hs[i + 1] - hs[i]) / (xs[i + 1] - xs[i]); }
+
+        static real_t line_at(const Piece& p, real_t x) { return p.y0 + p.s * (x - p.x0); }
+
+        // Integral of exp(y(x)) over the piece
+        static real_t mass(const Piece& p)
+        {
+            if (std::isinf(p.a))
+                return std::exp(line_at(p, p.b)) / p.s;
+            if (std::isinf(p.b))
+                return -std::exp(line_at(p, p.a)) / p.s;
+            real_t w = p.b - p.a, t = p.s * w;
+            if (std::fabs(t) < 1e-10)
+                return std::exp(line_at(p, p.a)) * w * (1 + t / 2);
+            return std::exp(line_at(p, p.a)) * std::expm1(t) / p.s;
+        }
+
+        // The chord below the log density, or -infinity outside the points
+        real_t squeeze(real_t x) const
+        {
+            if (x < xs.front() || x > xs.back())
+                return -std::numeric_limits<real_t>::infinity();
+            size_t i = std::upper_bound(xs.begin(), xs.end(), x) - xs.begin();
+            i = std::min(std::max(i, size_t(1)), xs.size() - 1) - 1;
+            return hs[i] + slope(i) * (x - xs[i]);
+        }
+
+        // Adds the line through points j and j + 1 over [a, b] (nothing if it is empty)
+        void add(real_t a, real_t b, size_t j)
+        {
+            if (b > a)
+                pieces.push_back(Piece{a, b, xs[j], hs[j], slope(j)});
+        }
+
+        void build()
+        {
+            const size_t k = xs.size();
+            pieces.clear();
+            // Left tail, then each interval, then the right tail
+            add(lower, xs[0], 0);
+            add(xs[0], xs[1], 1);
+            for (size_t i = 1; i + 2 < k; i++) {
+                // min of the secants from the left (i - 1, i) and from the right (i + 1, i + 2); the first is the
+                // lower one at xs[i] and the second at xs[i + 1], so they cross once in between
+                real_t sa = slope(i - 1), sb = slope(i + 1);
+                real_t z = xs[i];
+                if (sa != sb)
+                    z = std::min(xs[i + 1], std::max(xs[i], ((hs[i + 1] - sb * xs[i + 1]) - (hs[i] - sa * xs[i])) / (sa - sb)));
+                add(xs[i], z, i - 1);
+                add(z, xs[i + 1], i + 1);
+            }
+            add(xs[k - 2], xs[k - 1], k - 3);
+            add(xs[k - 1], upper, k - 2);
+
+            // Shift by the largest value of the envelope, which is at an end of some piece
+            top = -std::numeric_limits<real_t>::infinity();
+            for (const Piece& p : pieces) {
+                if (!std::isinf(p.a)) top = std::max(top, line_at(p, p.a));
+                if (!std::isinf(p.b)) top = std::max(top, line_at(p, p.b));
+            }
+            sums.resize(pieces.size());
+            total = 0;
+            for (size_t i = 0; i < pieces.size(); i++) {
+                pieces[i].y0 -= top;
+                total += mass(pieces[i]);
+                sums[i] = total;
+            }
+            for (Piece& p : pieces)
+                p.y0 += top;
+        }
+
+        void insert(real_t x, real_t y)
+        {
+            size_t i = std::upper_bound(xs.begin(), xs.end(), x) - xs.begin();
+            if ((i > 0 && xs[i - 1] == x) || (i < xs.size() && xs[i] == x))
+                return;
+            xs.insert(xs.begin() + i, x);
+            hs.insert(hs.begin() + i, y);
+            build();
+        }
+
+        // Draws from the envelope by inversion, and tells which piece the value came from
+        real_t from_envelope(real_t u, size_t& i) const
+        {
+            real_t m = u * total;
+            i = std::min(size_t(std::upper_bound(sums.begin(), sums.end(), m) - sums.begin()), pieces.size() - 1);
+            const Piece& p = pieces[i];
+            // Fraction of the piece's own mass to the left of the value
+            real_t prev = (i == 0) ? 0 : sums[i - 1];
+            real_t f = std::min(real_t(1), std::max(real_t(0), (m - prev) / (sums[i] - prev)));
+            if (std::isinf(p.a))
+                return p.b + std::log(f) / p.s;
+            if (std::isinf(p.b))
+                return p.a + std::log1p(-f) / p.s;
+            real_t w = p.b - p.a, t = p.s * w;
+            if (std::fabs(t) < 1e-10)
+                return p.a + f * w;
+            return std::min(p.b, p.a + std::log1p(f * std::expm1(t)) / p.s);
+        }
+    };
+}
+
+#endif
+
+// src/Distributions/Continuous/Exponential/Exponential.h
+
+#ifndef DF_EXPONENTIAL_H
+#define DF_EXPONENTIAL_H
+
+
+namespace DiceForge {
     /// @brief DiceForge::Exponential - A continuous exponential probability distribution
     class Exponential : public Continuous {
     private:
         real_t k;  // Rate parameter
         real_t x0; // Origin of the distribution
-    public:        
-        /// @brief Constructor for Exponential distribution.
-        /// @param k Rate parameter for the exponential distribution.
-        /// @param x0 Origin of the distribution.
-        /// @note k > 0
+        // e[j] / k[j] for the standard variates e of sample_each, on lanes of simd::vreal
+        static void scale_each(const real_t* k, real_t* e, size_t n);
+    public:
+        /**
+         * @brief Constructor for Exponential distribution.
+         * @param k Rate parameter for the exponential distribution.
+         * @param x0 Origin of the distribution.
+         */
         Exponential(real_t k, real_t x0 = 0);
-
-        /// @brief Generate a random number from the exponential distribution.
-        /// @param r Uniformly distributed random number in the range [0,1).
-        /// @returns Random number from the exponential distribution.
+        /**
+         * @brief Generate a random number from the exponential distribution.
+         * @param r Random number in the range [0,1).
+         * @returns Random number from the exponential distribution.
+         */
         real_t next(real_t r);
-
-        ///@brief Calculate the variance of the distribution.
-        /// @returns Variance of the exponential distribution.
+        /// @brief Returns the next value of the random variable described by the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @note Uses the Ziggurat method, mostly one random integer, a table lookup and a multiply per value
+        template <typename Derived, typename T>
+        real_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+        {
+            DF_INSTRUMENT_SAMPLES("Exponential", 1);
+            return x0 + ziggurat::next_exponential(rng) / k;
+        }
+        /// @brief Fills the buffer with values of the random variable described by the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @param out Pointer to the first element of the buffer
+        /// @param n Number of values to be written
+        /// @note Ziggurat method, as in next(rng)
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, real_t* out, size_t n)
+        {
+            DF_INSTRUMENT_SAMPLES("Exponential", n);
+            for (size_t j = 0; j < n; j++)
+                out[j] = next(rng);
+        }
+        /// @brief Fills the buffer with single precision values of the random variable
+        /// @note ziggurat::fill_exponential, 32 random bits per value in the common case
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, float* out, size_t n)
+        {
+            DF_INSTRUMENT_SAMPLES("Exponential", n);
+            ziggurat::fill_exponential(rng, out, n);
+            const float origin = float(x0), scale = float(1 / k);
+            for (size_t j = 0; j < n; j++)
+                out[j] = origin + out[j] * scale;
+        }
+        /// @brief Fills the buffer with one value of each of n Exponential distributions (of origin 0), without
+        /// constructing them
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @param k Pointer to the n rate parameters (> 0)
+        /// @param out Pointer to the first element of the buffer
+        /// @param n Number of values to be written
+        /// @note Standard variates by the Ziggurat method, then divided by the rates lanes at a time
+        template <typename Derived, typename T>
+        static void sample_each(DiceForge::StaticGenerator<Derived, T>& rng, const real_t* k, real_t* out, size_t n)
+        {
+            DF_INSTRUMENT_SAMPLES("Exponential", n);
+            bool valid = true;
+            for (size_t j = 0; j < n; j++)
+                valid &= (k[j] > 0);
+            if (!valid)
+                throw std::invalid_argument("Rate parameter (k) must be positive");
+            for (size_t j = 0; j < n; j++)
+                out[j] = ziggurat::next_exponential(rng);
+            scale_each(k, out, n);
+        }
+#if defined(DF_SPAN)
+        /// @brief Fills the span with values of the random variable described by the distribution
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<real_t> out)
+        {
+            sample(rng, out.data(), out.size());
+        }
+        /// @brief Fills the span with single precision values of the random variable
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<float> out)
+        {
+            sample(rng, out.data(), out.size());
+        }
+#endif
+        /**
+         * @brief Calculate the variance of the distribution.
+         * @returns Variance of the exponential distribution.
+         */
         real_t variance() const override final;
-        
-        /// @brief Calculate the expectation of the distribution.
-        /// @returns Expectation of the exponential distribution.
+        /**
+         * @brief Calculate the expectation of the distribution.
+         * @returns Expectation of the exponential distribution.
+         */
         real_t expectation() const override final;
-        
-        /// @brief Get the minimum possible value in the distribution.
-        /// @returns Minimum value of the exponential distribution.
+        /**
+         * @brief Get the minimum possible value in the distribution.
+         * @returns Minimum value of the exponential distribution.
+         */
         real_t minValue() const override final;
-
-        /// @brief Get the maximum possible value in the distribution.
-        /// @returns Maximum value of the exponential distribution.
+        /**
+         * @brief Get the maximum possible value in the distribution.
+         * @returns Maximum value of the exponential distribution.
+         */
         real_t maxValue() const override final;
-        
-        /// @brief Calculate the probability density function (PDF) of the distribution at a given point x.
-        /// @param x Point at which to calculate the PDF.
-        /// @returns PDF value at point x.
+        /**
+         * @brief Calculate the probability density function (PDF) of the distribution at a given point x.
+         * @param x Point at which to calculate the PDF.
+         * @returns PDF value at point x.
+         */
         real_t pdf(real_t x) const override final;
-        
-        /// @brief Calculate the cumulative distribution function (CDF) of the distribution at a given point x.
-        /// @param x Point at which to calculate the CDF.
-        /// @returns CDF value at point x.
+        /**
+         * @brief Calculate the cumulative distribution function (CDF) of the distribution at a given point x.
+         * @param x Point at which to calculate the CDF.
+         * @returns CDF value at point x.
+         */
         real_t cdf(real_t x) const override final;
+        /**
+         * @brief Calculate the natural logarithm of the PDF of the distribution at a given point x.
+         * @param x Point at which to calculate the log-PDF.
+         * @returns log-PDF value at point x.
+         */
+        real_t logpdf(real_t x) const override final;
+        /**
+         * @brief Calculate the PDF at n points at once.
+         * @param x Points at which to calculate the PDF.
+         * @param out Buffer receiving the n PDF values.
+         * @param n Number of points.
+         */
+        void pdf(const real_t* x, real_t* out, size_t n) const override final;
+        /**
+         * @brief Calculate the log-PDF at n points at once (see pdf).
+         */
+        void logpdf(const real_t* x, real_t* out, size_t n) const override final;
+        /**
+         * @brief Calculate the CDF at n points at once (see pdf).
+         */
+        void cdf(const real_t* x, real_t* out, size_t n) const override final;
+        /**
+         * @brief Calculate the quantile function (inverse CDF) of the distribution, x0 - log(1 - p) / k.
+         * @param p Probability, in [0, 1].
+         * @returns The x with CDF(x) = p.
+         */
+        real_t quantile(real_t p) const override final;
+        /**
+         * @brief Calculate the quantile function at n probabilities at once (out may be p).
+         */
+        void quantile(const real_t* p, real_t* out, size_t n) const override final;
 
         /// @brief Returns the rate parameter of the distribution
         real_t get_k() const;
@@ -158,13 +707,63 @@ namespace DiceForge {
     /// @param max_iter maximum iterations to attempt to fit the data (higher to try for better fits)
     /// @param epsilon minimum acceptable error tolerance while attempting to fit the data (smaller to try for better fits)
     /// @returns An Exponential distribution fit to the given sample points
-    Exponential fitToExponential(const std::vector<real_t>& x, const std::vector<real_t>& y, int max_iter, real_t epsilon);
+    Exponential fitToExponential(const std::vector<real_t>& x, const std::vector<real_t>& y, int max_iter = 10000, real_t epsilon = 1e-6);
+
+    /// @brief Streaming sufficient statistics of a sample (count, sum and minimum), from which the maximum likelihood
+    /// Exponential follows in closed form. Accumulators over parts of a sample can be merged.
+    /// @note The statistics can be saved with save_state, to carry on with a sample from a checkpoint
+    class ExponentialAccumulator : public Serializable<ExponentialAccumulator> {
+        friend class Serializable<ExponentialAccumulator>;
+        private:
+            size_t n = 0;
+            real_t sum = 0, min = INFINITY;
+            // The statistics, for save_state and load_state (see DiceForge::Serializable)
+            void write_state(detail::StateWriter& out) const;
+            void read_state(detail::StateReader& in);
+        public:
+            /// @brief Adds one sample
+            void add(real_t x);
+            /// @brief Adds the n samples x
+            void add(const real_t* x, size_t n);
+            /// @brief Adds all the samples seen by other
+            void merge(const ExponentialAccumulator& other);
+            /// @brief Number of samples added
+            size_t count() const;
+            /// @brief Maximum likelihood Exponential of the samples added (x0 = smallest sample, k = 1 / (mean - x0))
+            Exponential fit() const;
+    };
+
+    /// @brief Fits an Exponential distribution to raw samples by maximum likelihood, in one pass with no binning
+    /// @param samples list of samples
+    /// @return The maximum likelihood Exponential distribution of the samples
+    Exponential fitExponentialFromSamples(const std::vector<real_t>& samples);
+}
+
+#endif
+
+// src/Distributions/Continuous/Gaussian/Gaussian.h
 
+#ifndef DF_GAUSSIAN_H
+#define DF_GAUSSIAN_H
+
+
+namespace DiceForge {
     /// @brief DiceForge::Gaussian - A Continuous Probability Distribution (Gaussian) 
-    class Gaussian : public Continuous {
+    /// @note The state (the parameters and the variate cached by next_cached) can be saved with save_state
+    class Gaussian : public Continuous, public Serializable<Gaussian> {
+        friend class Serializable<Gaussian>;
         private:
             real_t mu, sigma;
-            real_t myerf(real_t x) const;
+            // 1 / sigma and the normalisation 1 / (sqrt(2 pi) sigma) of the pdf, with its logarithm
+            real_t inv_sigma, norm, log_norm;
+            // Second variate of the last pair drawn by next_cached()
+            real_t cached = 0;
+            bool has_cached = false;
+            // The parameters and the cached variate, for save_state and load_state (see DiceForge::Serializable)
+            void write_state(detail::StateWriter& out) const;
+            void read_state(detail::StateReader& in);
+            // z[j] * sigma[j] + mu[j] for the standard variates z of sample_each, on lanes of simd::vreal
+            static void scale_each(const real_t* mu, const real_t* sigma, real_t* z, size_t n);
         public:
             /// @brief Initializes the Gaussian distribution about location x = mu with standard deviation sigma
             /// @param mu mean of the distribution
@@ -174,6 +773,102 @@ namespace DiceForge {
             /// @param r1 A random real number uniformly distributed between 0 and 1
             /// @param r2 A random real number uniformly distributed between 0 and 1
             real_t next(real_t r1, real_t r2);
+            /// @brief Returns the next value of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @note Uses the Ziggurat method, mostly one random integer, a table lookup and a multiply per value
+            template <typename Derived, typename T>
+            real_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+            {
+                DF_INSTRUMENT_SAMPLES("Gaussian", 1);
+                return ziggurat::next_normal(rng) * sigma + mu;
+            }
+            /// @brief Fills the buffer with values of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param out Pointer to the first element of the buffer
+            /// @param n Number of values to be written
+            /// @note Ziggurat method, as in next(rng)
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, real_t* out, size_t n)
+            {
+                DF_INSTRUMENT_SAMPLES("Gaussian", n);
+                for (size_t j = 0; j < n; j++)
+                    out[j] = next(rng);
+            }
+            /// @brief Fills the buffer with single precision values of the random variable
+            /// @note ziggurat::fill_normal, 32 random bits per value in the common case
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, float* out, size_t n)
+            {
+                DF_INSTRUMENT_SAMPLES("Gaussian", n);
+                ziggurat::fill_normal(rng, out, n);
+                const float m = float(mu), s = float(sigma);
+                for (size_t j = 0; j < n; j++)
+                    out[j] = out[j] * s + m;
+            }
+            /// @brief Fills the buffer with one value of each of n Gaussian distributions, without constructing them
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param mu Pointer to the n means
+            /// @param sigma Pointer to the n standard deviations (> 0)
+            /// @param out Pointer to the first element of the buffer
+            /// @param n Number of values to be written
+            /// @note Standard variates by the Ziggurat method, then scaled and shifted lanes at a time
+            template <typename Derived, typename T>
+            static void sample_each(DiceForge::StaticGenerator<Derived, T>& rng, const real_t* mu, const real_t* sigma,
+                                    real_t* out, size_t n)
+            {
+                DF_INSTRUMENT_SAMPLES("Gaussian", n);
+                bool valid = true;
+                for (size_t j = 0; j < n; j++)
+                    valid &= (sigma[j] > 0);
+                if (!valid)
+                    throw std::invalid_argument("Value of sigma must be positive!");
+                for (size_t j = 0; j < n; j++)
+                    out[j] = ziggurat::next_normal(rng);
+                scale_each(mu, sigma, out, n);
+            }
+#if defined(DF_SPAN)
+            /// @brief Fills the span with values of the random variable described by the distribution
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<real_t> out)
+            {
+                sample(rng, out.data(), out.size());
+            }
+            /// @brief Fills the span with single precision values of the random variable
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<float> out)
+            {
+                sample(rng, out.data(), out.size());
+            }
+#endif
+            /// @brief Returns two independent values of the random variable from one pair of uniforms (Box-Muller)
+            /// @param r1 A random real number uniformly distributed between 0 and 1
+            /// @param r2 A random real number uniformly distributed between 0 and 1
+            std::pair<real_t, real_t> next_pair(real_t r1, real_t r2);
+            /// @brief Returns two independent values of the random variable (Marsaglia's polar method)
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            template <typename Derived, typename T>
+            std::pair<real_t, real_t> next_pair(DiceForge::StaticGenerator<Derived, T>& rng)
+            {
+                DF_INSTRUMENT_SAMPLES("Gaussian", 2);
+                std::pair<real_t, real_t> z = polar::normal_pair(rng);
+                return std::make_pair(z.first * sigma + mu, z.second * sigma + mu);
+            }
+            /// @brief Returns the next value of the random variable, drawing a new pair (polar method) every other call
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @note The second value of each pair is kept in this object, so a copy of it continues the same sequence
+            template <typename Derived, typename T>
+            real_t next_cached(DiceForge::StaticGenerator<Derived, T>& rng)
+            {
+                DF_INSTRUMENT_SAMPLES("Gaussian", 1);
+                if (has_cached) {
+                    has_cached = false;
+                    return cached;
+                }
+                std::pair<real_t, real_t> z = next_pair(rng);
+                cached = z.second;
+                has_cached = true;
+                return z.first;
+            }
             /// @brief Returns the theoretical variance of the distribution
             real_t variance() const override final;
             /// @brief Returns the theoretical expectation value of the distribution
@@ -189,12 +884,26 @@ namespace DiceForge {
             real_t pdf(real_t x) const override final;
             /// @brief Cumulative distribution function of the Gaussian distribution
             real_t cdf(real_t x) const override final;
+            /// @brief Natural logarithm of the probability density function of the Gaussian distribution
+            real_t logpdf(real_t x) const override final;
+            /// @brief Probability density function of the Gaussian distribution at the n locations x, written to out
+            void pdf(const real_t* x, real_t* out, size_t n) const override final;
+            /// @brief Logarithm of the probability density function at the n locations x, written to out
+            void logpdf(const real_t* x, real_t* out, size_t n) const override final;
+            /// @brief Cumulative distribution function at the n locations x, written to out
+            void cdf(const real_t* x, real_t* out, size_t n) const override final;
+            /// @brief Quantile function (inverse cdf) of the Gaussian distribution
+            /// @note mu + sigma special::normal_quantile(p)
+            real_t quantile(real_t p) const override final;
+            /// @brief Quantile function at the n probabilities p, written to out (out may be p)
+            /// @note Through the vectorised special::normal_quantile
+            void quantile(const real_t* p, real_t* out, size_t n) const override final;
             /// @brief Returns mean of the distribution
             real_t get_mu() const;
             /// @brief Returns standard deviation of the distribution
             real_t get_sigma() const;
     };
-
+    
     /// @brief Fits the given sample points (x, y=pdf(x)) to a Gaussian distribution using non-linear least squares regression
     /// following Gauss-Newton methods
     /// @param x list of x coordinates
@@ -204,11 +913,61 @@ namespace DiceForge {
     /// @return A Gaussian distribution fit to the given sample points
     Gaussian fitToGaussian(const std::vector<real_t>& x, const std::vector<real_t>& y, int max_iter = 10000, real_t epsilon = 1e-6);
 
+    /// @brief Streaming sufficient statistics of a sample (count, mean and sum of squared deviations), from which
+    /// the maximum likelihood Gaussian follows in closed form. Accumulators over parts of a sample can be merged.
+    /// @note The statistics can be saved with save_state, to carry on with a sample from a checkpoint
+    class GaussianAccumulator : public Serializable<GaussianAccumulator> {
+        friend class Serializable<GaussianAccumulator>;
+        private:
+            size_t n = 0;
+            real_t mean = 0, m2 = 0;
+            // The statistics, for save_state and load_state (see DiceForge::Serializable)
+            void write_state(detail::StateWriter& out) const;
+            void read_state(detail::StateReader& in);
+        public:
+            /// @brief Adds one sample
+            void add(real_t x);
+            /// @brief Adds the n samples x
+            void add(const real_t* x, size_t n);
+            /// @brief Adds all the samples seen by other
+            void merge(const GaussianAccumulator& other);
+            /// @brief Number of samples added
+            size_t count() const;
+            /// @brief Maximum likelihood Gaussian of the samples added (mu = sample mean, sigma^2 = mean squared deviation)
+            Gaussian fit() const;
+    };
+
+    /// @brief Fits a Gaussian distribution to raw samples by maximum likelihood, in one pass with no binning
+    /// @param samples list of samples
+    /// @return The maximum likelihood Gaussian distribution of the samples
+    Gaussian fitGaussianFromSamples(const std::vector<real_t>& samples);
+}
+
+
+#endif
+
+
+// src/Distributions/Continuous/Maxwell/Maxwell.h
+
+#ifndef DF_MAXWELL_H
+#define DF_MAXWELL_H
+
+#include <algorithm>
+
+namespace DiceForge {
     /// @brief DiceForge::Maxwell - A Continuous Probability Distribution (Maxwell) 
-    class Maxwell : public Continuous
+    /// @note The state (the scale and the cached normal) can be saved with save_state
+    class Maxwell : public Continuous, public Serializable<Maxwell>
     {
+        friend class Serializable<Maxwell>;
         private:
             real_t a;
+            // Second normal of the last pair drawn by next(rng)
+            real_t cached = 0;
+            bool has_cached = false;
+            // The parameters and the cached normal, for save_state and load_state (see DiceForge::Serializable)
+            void write_state(detail::StateWriter& out) const;
+            void read_state(detail::StateReader& in);
         public:
             /// @brief Initializes the Maxwell distribution with scale "a"
             /// @param a scale factor of the distribution
@@ -218,7 +977,80 @@ namespace DiceForge {
             /// @param r1 A random real number uniformly distributed between 0 and 1
             /// @param r2 A random real number uniformly distributed between 0 and 1
             /// @param r3 A random real number uniformly distributed between 0 and 1
+            /// @note The squared speed is the sum of -2 log(r1), for two of the components, and the square of a
+            /// normal built from r2 and r3 for the third, so the components are independent
             real_t next(real_t r1, real_t r2, real_t r3);
+            /// @brief Generates a random number from the Maxwell Distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @note Two components contribute -2 log(u) to the squared speed and the third is one half of a normal
+            /// pair (polar method), the other half being kept in this object for the next call
+            template <typename Derived, typename T>
+            real_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+            {
+                DF_INSTRUMENT_SAMPLES("Maxwell", 1);
+                real_t z;
+                if (has_cached) {
+                    z = cached;
+                    has_cached = false;
+                }
+                else {
+                    std::pair<real_t, real_t> p = polar::normal_pair(rng);
+                    z = p.first;
+                    cached = p.second;
+                    has_cached = true;
+                }
+                return a * sqrt(z * z - 2.0 * log(1.0 - rng.next_unit()));
+            }
+            /// @brief Fills the buffer with values of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param out Pointer to the first element of the buffer
+            /// @param n Number of values to be written
+            /// @note Draws as next(rng) would from a fresh object, both halves of each normal pair going to consecutive
+            /// values; the cached normal of next(rng) is neither used nor changed, so a call draws from this rng only
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, real_t* out, size_t n)
+            {
+                DF_INSTRUMENT_SAMPLES("Maxwell", n);
+                for (size_t j = 0; j < n; j += 2) {
+                    std::pair<real_t, real_t> p = polar::normal_pair(rng);
+                    out[j] = a * sqrt(p.first * p.first - 2.0 * log(1.0 - rng.next_unit()));
+                    if (j + 1 < n)
+                        out[j + 1] = a * sqrt(p.second * p.second - 2.0 * log(1.0 - rng.next_unit()));
+                }
+            }
+            /// @brief Fills the buffer with single precision values of the random variable
+            /// @note a sqrt(z^2 + 2 e) for a normal z and an exponential e, drawn in blocks by ziggurat::fill_normal and
+            /// ziggurat::fill_exponential
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, float* out, size_t n)
+            {
+                DF_INSTRUMENT_SAMPLES("Maxwell", n);
+                float e[ziggurat::float_block];
+                const float s = float(a);
+                while (n > 0) {
+                    size_t m = std::min(n, ziggurat::float_block);
+                    ziggurat::fill_normal(rng, out, m);
+                    ziggurat::fill_exponential(rng, e, m);
+                    for (size_t j = 0; j < m; j++)
+                        out[j] = s * std::sqrt(out[j] * out[j] + 2 * e[j]);
+                    out += m;
+                    n -= m;
+                }
+            }
+#if defined(DF_SPAN)
+            /// @brief Fills the span with values of the random variable described by the distribution
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<real_t> out)
+            {
+                sample(rng, out.data(), out.size());
+            }
+            /// @brief Fills the span with single precision values of the random variable
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<float> out)
+            {
+                sample(rng, out.data(), out.size());
+            }
+#endif
             /// @brief Returns the theoretical variance of the distribution
             real_t variance() const override final;
             /// @brief Returns the theoretical expectation value of the distribution
@@ -232,11 +1064,25 @@ namespace DiceForge {
             /// @brief Probability density function of the Maxwell distribution
             real_t pdf(real_t x) const override final;
             /// @brief Cumulative distribution function of the Maxwell distribution
+            /// @note The regularized incomplete gamma function P(3/2, x^2 / (2 a^2))
             real_t cdf(real_t x) const override final;
+            /// @brief Natural logarithm of the probability density function of the Maxwell distribution
+            real_t logpdf(real_t x) const override final;
+            /// @brief Probability density function of the Maxwell distribution at the n locations x, written to out
+            void pdf(const real_t* x, real_t* out, size_t n) const override final;
+            /// @brief Logarithm of the probability density function at the n locations x, written to out
+            void logpdf(const real_t* x, real_t* out, size_t n) const override final;
+            /// @brief Cumulative distribution function at the n locations x, written to out
+            void cdf(const real_t* x, real_t* out, size_t n) const override final;
+            /// @brief Quantile function (inverse cdf) of the Maxwell distribution
+            /// @note a sqrt(2 special::gamma_p_inverse(3/2, p))
+            real_t quantile(real_t p) const override final;
+            /// @brief Quantile function at the n probabilities p, written to out (out may be p)
+            void quantile(const real_t* p, real_t* out, size_t n) const override final;
             /// @brief Returns the scale factor of the distribution 
             real_t get_a() const;
     };
-    
+
     /// @brief Fits the given sample points (x, y=pdf(x)) to a Maxwell distribution by non-linear least squares regression 
     /// using modified Gauss-Newton
     /// @param x list of x coordinates
@@ -246,10 +1092,145 @@ namespace DiceForge {
     /// @return A Maxwell distribution fit to the given sample points
     Maxwell fitToMaxwell(const std::vector<real_t>& x, const std::vector<real_t>& y, int max_iter, real_t epsilon);
 
+    /// @brief Streaming sufficient statistics of a sample (count and sum of squares), from which the maximum likelihood
+    /// Maxwell distribution follows in closed form. Accumulators over parts of a sample can be merged.
+    /// @note The statistics can be saved with save_state, to carry on with a sample from a checkpoint
+    class MaxwellAccumulator : public Serializable<MaxwellAccumulator> {
+        friend class Serializable<MaxwellAccumulator>;
+        private:
+            size_t n = 0;
+            real_t sum2 = 0;
+            // The statistics, for save_state and load_state (see DiceForge::Serializable)
+            void write_state(detail::StateWriter& out) const;
+            void read_state(detail::StateReader& in);
+        public:
+            /// @brief Adds one sample
+            void add(real_t x);
+            /// @brief Adds the n samples x
+            void add(const real_t* x, size_t n);
+            /// @brief Adds all the samples seen by other
+            void merge(const MaxwellAccumulator& other);
+            /// @brief Number of samples added
+            size_t count() const;
+            /// @brief Maximum likelihood Maxwell distribution of the samples added (a^2 = mean of x^2 / 3)
+            Maxwell fit() const;
+    };
+
+    /// @brief Fits a Maxwell distribution to raw samples by maximum likelihood, in one pass with no binning
+    /// @param samples list of samples
+    /// @return The maximum likelihood Maxwell distribution of the samples
+    Maxwell fitMaxwellFromSamples(const std::vector<real_t>& samples);
+}
+
+
+#endif
+
+// src/Distributions/Continuous/MultivariateGaussian/MultivariateGaussian.h
+
+#ifndef DF_MULTIVARIATE_GAUSSIAN_H
+#define DF_MULTIVARIATE_GAUSSIAN_H
+
+#include <vector>
+#include <stdexcept>
+
+namespace DiceForge {
+    /// @brief DiceForge::MultivariateGaussian - The multivariate normal distribution N(mu, Sigma) of random vectors
+    /// @note The covariance is factored once as Sigma = L L^T (Cholesky), and a value is mu + L z for a vector z of
+    /// independent standard normals. Batches of vectors are transformed together, as a blocked product of the
+    /// triangular factor with a matrix of standard normals.
+    /// @note Vectors are stored one after the other, so that n of them take n * dimensions() reals
+    class MultivariateGaussian {
+        private:
+            size_t d;
+            std::vector<real_t> mu;
+            std::vector<real_t> sigma;
+            // Lower triangular Cholesky factor, row-major d x d with zeros above the diagonal
+            std::vector<real_t> factor;
+            // The factor in tiles of 4 rows, interleaved by column (row 4t + r, column k at offset[t] + 4 k + r),
+            // each tile ending at its last diagonal element and rows past d zero
+            std::vector<real_t> packed;
+            std::vector<size_t> offset;
+            // -(d log(2 pi) + log det Sigma) / 2
+            real_t log_norm;
+        public:
+            /// @brief Vectors transformed together by transform(), one block at a time
+            static constexpr size_t block = 64;
+
+            /// @brief Initializes the distribution with the given mean and covariance
+            /// @param mean mean vector, of d components
+            /// @param covariance covariance matrix, d x d in row-major order (only the lower triangle is read)
+            /// @note Throws std::invalid_argument if the sizes do not match or the covariance is not positive definite
+            MultivariateGaussian(const std::vector<real_t>& mean, const std::vector<real_t>& covariance);
+            /// @brief Number of components of the random vector
+            size_t dimensions() const;
+            /// @brief Replaces n vectors of independent standard normals in place with values of the random vector
+            /// @param z Pointer to the first of the n * dimensions() standard normals, vector after vector
+            /// @param n Number of vectors
+            /// @note Blocks of vectors are transposed, multiplied by the packed factor in register tiles of 4 rows by
+            /// two vectors of lanes, and transposed back
+            void transform(real_t* z, size_t n) const;
+            /// @brief Writes the next value of the random vector to x (dimensions() reals)
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            template <typename Derived, typename T>
+            void next(DiceForge::StaticGenerator<Derived, T>& rng, real_t* x)
+            {
+                DF_INSTRUMENT_SAMPLES("MultivariateGaussian", 1);
+                for (size_t j = 0; j < d; j++)
+                    x[j] = ziggurat::next_normal(rng);
+                transform(x, 1);
+            }
+            /// @brief Fills the buffer with n values of the random vector
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param out Pointer to the first element of the buffer, of n * dimensions() reals
+            /// @param n Number of vectors to be written
+            /// @note Standard normals by the Ziggurat method, then transform()
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, real_t* out, size_t n)
+            {
+                DF_INSTRUMENT_SAMPLES("MultivariateGaussian", n);
+                for (size_t i = 0; i < n * d; i++)
+                    out[i] = ziggurat::next_normal(rng);
+                transform(out, n);
+            }
+#if defined(DF_SPAN)
+            /// @brief Fills the span with values of the random vector (out.size() / dimensions() of them)
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<real_t> out)
+            {
+                sample(rng, out.data(), out.size() / d);
+            }
+#endif
+            /// @brief Natural logarithm of the probability density function at x (dimensions() reals)
+            /// @note Forward substitution with the factor, in O(d^2)
+            real_t logpdf(const real_t* x) const;
+            /// @brief Probability density function at x (dimensions() reals)
+            real_t pdf(const real_t* x) const;
+            /// @brief Returns the mean vector
+            const std::vector<real_t>& get_mu() const;
+            /// @brief Returns the covariance matrix, row-major
+            const std::vector<real_t>& get_sigma() const;
+            /// @brief Returns the lower triangular Cholesky factor L of the covariance (Sigma = L L^T), row-major
+            const std::vector<real_t>& get_cholesky() const;
+    };
+}
+
+#endif
+
+// src/Distributions/Continuous/Weibull/Weibull.h
+
+#ifndef DF_WEIBULL_H
+#define DF_WEIBULL_H
+
+
+namespace DiceForge {
+
     /// @brief DiceForge::Weibull - A Continuous Probability Distribution (Weibull) 
     class Weibull : public Continuous {
         private:
             real_t k, lambda;
+            // Turns standard exponential variates in place into values of the random variable
+            void scale_exponentials(real_t* x, size_t n) const;
+            void scale_exponentials(float* x, size_t n) const;
         public:
             /// @brief Initializes the Weibull distribution with scale gamma
             /// @param lambda scale factor of the distribution
@@ -260,6 +1241,42 @@ namespace DiceForge {
             /// @brief Returns the next value of the random variable described by the distribution
             /// @param r A random real number uniformly distributed between 0 and 1
             real_t next(real_t r);
+            /// @brief Fills the buffer with values of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param out Pointer to the first element of the buffer
+            /// @param n Number of values to be written
+            /// @note Raises Ziggurat exponential variates to the power 1 / k (no logarithm, and no power at all for k = 1 or 2)
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, real_t* out, size_t n)
+            {
+                DF_INSTRUMENT_SAMPLES("Weibull", n);
+                for (size_t j = 0; j < n; j++)
+                    out[j] = ziggurat::next_exponential(rng);
+                scale_exponentials(out, n);
+            }
+            /// @brief Fills the buffer with single precision values of the random variable
+            /// @note Exponentials from ziggurat::fill_exponential, scaled in single precision
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, float* out, size_t n)
+            {
+                DF_INSTRUMENT_SAMPLES("Weibull", n);
+                ziggurat::fill_exponential(rng, out, n);
+                scale_exponentials(out, n);
+            }
+#if defined(DF_SPAN)
+            /// @brief Fills the span with values of the random variable described by the distribution
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<real_t> out)
+            {
+                sample(rng, out.data(), out.size());
+            }
+            /// @brief Fills the span with single precision values of the random variable
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<float> out)
+            {
+                sample(rng, out.data(), out.size());
+            }
+#endif
         
             /// @brief Returns the theoretical variance of the distribution
             /// @note The variation of a Weibull distribution is undefined
@@ -284,6 +1301,19 @@ namespace DiceForge {
         
             /// @brief Cumulative distribution function of the Weibull distribution
             real_t cdf(real_t x) const override final;
+            /// @brief Natural logarithm of the probability density function of the Weibull distribution
+            real_t logpdf(real_t x) const override final;
+            /// @brief Probability density function of the Weibull distribution at the n locations x, written to out
+            void pdf(const real_t* x, real_t* out, size_t n) const override final;
+            /// @brief Logarithm of the probability density function at the n locations x, written to out
+            void logpdf(const real_t* x, real_t* out, size_t n) const override final;
+            /// @brief Cumulative distribution function at the n locations x, written to out
+            void cdf(const real_t* x, real_t* out, size_t n) const override final;
+            /// @brief Quantile function (inverse cdf) of the Weibull distribution
+            /// @note lambda (-log(1 - p))^(1/k)
+            real_t quantile(real_t p) const override final;
+            /// @brief Quantile function at the n probabilities p, written to out (out may be p)
+            void quantile(const real_t* p, real_t* out, size_t n) const override final;
 
             /// @brief Returns scale factor of the distribution
             real_t get_lambda() const;
@@ -301,17 +1331,734 @@ namespace DiceForge {
     /// @return A Weibull distribution fit to the given sample points
     Weibull fitToWeibull(std::vector<real_t> x, std::vector<real_t> y, int max_iter, real_t epsilon);
 
+    /// @brief Streaming moments of the logarithm of a sample (count, mean, sum of squared deviations and maximum).
+    /// log(x) follows a Gumbel distribution, so these give a closed form estimate of the Weibull parameters, which
+    /// fitWeibullFromSamples refines to the maximum likelihood one. Accumulators over parts of a sample can be merged.
+    /// @note The statistics can be saved with save_state, to carry on with a sample from a checkpoint
+    class WeibullAccumulator : public Serializable<WeibullAccumulator> {
+        friend class Serializable<WeibullAccumulator>;
+        private:
+            size_t n = 0;
+            real_t mean = 0, m2 = 0, max = -INFINITY;
+            // The statistics, for save_state and load_state (see DiceForge::Serializable)
+            void write_state(detail::StateWriter& out) const;
+            void read_state(detail::StateReader& in);
+        public:
+            /// @brief Adds one (positive) sample
+            void add(real_t x);
+            /// @brief Adds the n (positive) samples x
+            void add(const real_t* x, size_t n);
+            /// @brief Adds all the samples seen by other
+            void merge(const WeibullAccumulator& other);
+            /// @brief Number of samples added
+            size_t count() const;
+            /// @brief Mean of log(x) over the samples added
+            real_t log_mean() const;
+            /// @brief Largest log(x) over the samples added
+            real_t log_max() const;
+            /// @brief Moment estimate from the log-samples: k = pi / (sqrt(6) s) and lambda = exp(m + gamma / k), where m and s
+            /// are their mean and standard deviation and gamma is the Euler-Mascheroni constant
+            Weibull fit() const;
+    };
+
+    /// @brief Fits a Weibull distribution to raw (positive) samples by maximum likelihood, with no binning. Newton's
+    /// method on the likelihood profiled over lambda is started from the moment estimate of WeibullAccumulator,
+    /// each iteration being one pass over the samples.
+    /// @param samples list of samples
+    /// @param max_iter maximum Newton iterations
+    /// @param epsilon relative change in k below which the fit has converged
+    /// @return The maximum likelihood Weibull distribution of the samples
+    Weibull fitWeibullFromSamples(const std::vector<real_t>& samples, int max_iter = 100, real_t epsilon = 1e-12);
+}
+
+
+#endif
+
+// src/Distributions/Continuous/Composite/Composite.h
+
+#ifndef DF_COMPOSITE_H
+#define DF_COMPOSITE_H
+
+#include <array>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace DiceForge {
+    namespace detail
+    {
+        // Values handled at a time by the batch functions of the composite distributions
+        constexpr size_t composite_block = 256;
+
+        // A uniform of next_unit or fill_unit (at most 53 bits in [0, 1)) moved up by 2^-54, into (0, 1)
+        inline real_t open_unit(real_t u)
+        {
+            return u + real_t(0.5) * std::numeric_limits<real_t>::epsilon() / 2;
+        }
+    }
+
+    /// @brief DiceForge::Mixture - A distribution drawing each value from one of its components, chosen at random
+    /// with the given weights (such as 95% Gaussian + 5% Exponential for a latency with a heavy tail)
+    /// @details The components are kept by value and their types are known at compile time, so that next and
+    /// sample call their own next and sample directly rather than through Continuous. sample(rng, out, n) takes a
+    /// block of uniforms to choose the components, groups the positions of the block by component and fills
+    /// them with one call to the sample of each component, so every component fills its share in a batch.
+    /// @tparam D the types of the components (such as Gaussian, Exponential, or Truncated<Cauchy>)
+    template <typename... D>
+    class Mixture : public Continuous {
+        static_assert(sizeof...(D) >= 1 && sizeof...(D) <= 255, "A Mixture has between 1 and 255 components");
+        static_assert((std::is_base_of_v<Continuous, D> && ...), "The components of a Mixture are Continuous");
+    public:
+        static constexpr size_t size = sizeof...(D);
+    private:
+        std::tuple<D...> components;
+        std::array<real_t, size> weights;
+        // cumulative[k] = weights[0] + ... + weights[k], the last one being exactly 1
+        std::array<real_t, size> cumulative;
+
+        // Index of the component chosen by the uniform u, the number of cumulative weights below or at u
+        size_t choose(real_t u) const
+        {
+            size_t k = 0;
+            for (size_t j = 0; j + 1 < size; j++)
+                k += (u >= cumulative[j]);
+            return k;
+        }
+        // Calls f(component, index) for every component in turn
+        template <typename F, size_t... I>
+        void each(F&& f, std::index_sequence<I...>) const
+        {
+            (f(std::get<I>(components), I), ...);
+        }
+        template <typename F, size_t... I>
+        void each(F&& f, std::index_sequence<I...>)
+        {
+            (f(std::get<I>(components), I), ...);
+        }
+        // Returns f(component k)
+        template <size_t I = 0, typename F>
+        real_t visit(size_t k, F&& f)
+        {
+            if constexpr (I + 1 < size) {
+                if (k != I)
+                    return visit<I + 1>(k, f);
+            }
+            return f(std::get<I>(components));
+        }
+        // Sums w_k f(component k, x, tmp, n) over the components, a block at a time, for the batch pdf and cdf
+        template <typename F>
+        void weighted_sum(F f, const real_t* x, real_t* out, size_t n) const
+        {
+            real_t tmp[detail::composite_block], sum[detail::composite_block];
+            for (size_t first = 0; first < n; first += detail::composite_block) {
+                const size_t b = std::min(n - first, detail::composite_block);
+                std::fill(sum, sum + b, real_t(0));
+                each([&](const auto& d, size_t k) {
+                    f(d, x + first, tmp, b);
+                    for (size_t i = 0; i < b; i++)
+                        sum[i] += weights[k] * tmp[i];
+                }, std::index_sequence_for<D...>());
+                std::copy(sum, sum + b, out + first);
+            }
+        }
+    public:
+        /// @brief A mixture of the components with the given weights
+        /// @param weights the relative weights of the components (>= 0, not all 0), normalised to sum to 1
+        /// @param components the distributions mixed
+        /// @note std::invalid_argument is thrown for negative or infinite weights, or weights summing to 0
+        Mixture(const std::array<real_t, size>& weights, const D&... components)
+            : components(components...), weights(weights)
+        {
+            real_t total = 0;
+            for (real_t w : weights) {
+                if (!(w >= 0) || !std::isfinite(w))
+                    throw std::invalid_argument("The weights of a Mixture must be non-negative and finite!");
+                total += w;
+            }
+            if (!(total > 0))
+                throw std::invalid_argument("The weights of a Mixture must not all be 0!");
+            real_t sum = 0;
+            for (size_t k = 0; k < size; k++) {
+                this->weights[k] = weights[k] / total;
+                sum += this->weights[k];
+                cumulative[k] = sum;
+            }
+            cumulative[size - 1] = 1;
+        }
+
+        /// @brief Returns the next value of the random variable described by the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @note One uniform to choose the component, then the next value of that component
+        template <typename Derived, typename T>
+        real_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+        {
+            DF_INSTRUMENT_SAMPLES("Mixture", 1);
+            return visit(choose(rng.next_unit()), [&](auto& d) { return real_t(d.next(rng)); });
+        }
+        /// @brief Fills the buffer with values of the random variable described by the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @param out Pointer to the first element of the buffer
+        /// @param n Number of values to be written
+        /// @note A block of 256 uniforms chooses the components of 256 values; the positions are sorted by
+        /// component (a counting sort), and each component fills its positions from one call to its sample
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, real_t* out, size_t n)
+        {
+            DF_INSTRUMENT_SAMPLES("Mixture", n);
+            constexpr size_t block = detail::composite_block;
+            real_t u[block], values[block];
+            unsigned char label[block];
+            unsigned short order[block];
+            for (size_t first = 0; first < n; first += block) {
+                const size_t b = std::min(n - first, block);
+                rng.fill_unit(u, b);
+                size_t start[size + 1] = {};
+                for (size_t i = 0; i < b; i++) {
+                    label[i] = (unsigned char)(choose(u[i]));
+                    start[label[i] + 1]++;
+                }
+                for (size_t k = 0; k < size; k++)
+                    start[k + 1] += start[k];
+                size_t slot[size];
+                std::copy(start, start + size, slot);
+                for (size_t i = 0; i < b; i++)
+                    order[slot[label[i]]++] = (unsigned short)(i);
+
+                real_t* block_out = out + first;
+                each([&](auto& d, size_t k) {
+                    const size_t count = start[k + 1] - start[k];
+                    if (count == 0)
+                        return;
+                    d.sample(rng, values, count);
+                    for (size_t j = 0; j < count; j++)
+                        block_out[order[start[k] + j]] = values[j];
+                }, std::index_sequence_for<D...>());
+            }
+        }
+#if defined(DF_SPAN)
+        /// @brief Fills the span with values of the random variable described by the distribution
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<real_t> out)
+        {
+            sample(rng, out.data(), out.size());
+        }
+#endif
+
+        /// @brief Returns component I
+        template <size_t I>
+        const auto& get_component() const
+        {
+            return std::get<I>(components);
+        }
+        /// @brief Returns the (normalised) weight of component k
+        real_t get_weight(size_t k) const
+        {
+            if (k >= size)
+                throw std::out_of_range("No such component in the Mixture!");
+            return weights[k];
+        }
+
+        /// @brief The weighted sum of the expectations of the components
+        real_t expectation() const override final
+        {
+            real_t mean = 0;
+            each([&](const auto& d, size_t k) { mean += weights[k] * d.expectation(); }, std::index_sequence_for<D...>());
+            return mean;
+        }
+        /// @brief The weighted variances of the components plus the variance of their expectations
+        real_t variance() const override final
+        {
+            const real_t mean = expectation();
+            real_t var = 0;
+            each([&](const auto& d, size_t k) {
+                const real_t offset = d.expectation() - mean;
+                var += weights[k] * (d.variance() + offset * offset);
+            }, std::index_sequence_for<D...>());
+            return var;
+        }
+        /// @brief The smallest minimum of the components of positive weight
+        real_t minValue() const override final
+        {
+            real_t lower = INFINITY;
+            each([&](const auto& d, size_t k) {
+                if (weights[k] > 0)
+                    lower = std::min(lower, d.minValue());
+            }, std::index_sequence_for<D...>());
+            return lower;
+        }
+        /// @brief The largest maximum of the components of positive weight
+        real_t maxValue() const override final
+        {
+            real_t upper = -INFINITY;
+            each([&](const auto& d, size_t k) {
+                if (weights[k] > 0)
+                    upper = std::max(upper, d.maxValue());
+            }, std::index_sequence_for<D...>());
+            return upper;
+        }
+        /// @brief The weighted sum of the pdfs of the components
+        real_t pdf(real_t x) const override final
+        {
+            real_t p = 0;
+            each([&](const auto& d, size_t k) { p += weights[k] * d.pdf(x); }, std::index_sequence_for<D...>());
+            return p;
+        }
+        /// @brief The weighted sum of the cdfs of the components
+        real_t cdf(real_t x) const override final
+        {
+            real_t p = 0;
+            each([&](const auto& d, size_t k) { p += weights[k] * d.cdf(x); }, std::index_sequence_for<D...>());
+            return std::min(p, real_t(1));
+        }
+        /// @brief Evaluates the pdf at n locations, with the batch pdf of every component
+        void pdf(const real_t* x, real_t* out, size_t n) const override final
+        {
+            weighted_sum([](const auto& d, const real_t* x, real_t* y, size_t b) { d.pdf(x, y, b); }, x, out, n);
+        }
+        /// @brief Evaluates the cdf at n locations, with the batch cdf of every component
+        void cdf(const real_t* x, real_t* out, size_t n) const override final
+        {
+            weighted_sum([](const auto& d, const real_t* x, real_t* y, size_t b) { d.cdf(x, y, b); }, x, out, n);
+            for (size_t i = 0; i < n; i++)
+                out[i] = std::min(out[i], real_t(1));
+        }
+    };
+
+    /// @brief DiceForge::Truncated - A distribution restricted to an interval [lower, upper], its density there
+    /// divided by the probability of the interval
+    /// @details Sampled by the inverse cdf rather than by rejection: a uniform u becomes
+    /// quantile(cdf(lower) + u (cdf(upper) - cdf(lower))), so the cost does not depend on the probability of the
+    /// interval and sample(rng, out, n) is one fill_unit and one call to the batch quantile of the distribution.
+    /// The interval must hold a probability the cdf resolves: far in a tail where cdf rounds to 0 or 1 the
+    /// values are only as fine as the doubles near that probability.
+    /// @tparam D the type of the distribution (such as Gaussian or Cauchy)
+    template <typename D>
+    class Truncated : public Continuous {
+        static_assert(std::is_base_of_v<Continuous, D>, "A Truncated distribution is Continuous");
+    private:
+        D dist;
+        real_t lower, upper;
+        // cdf(lower) and the probability of [lower, upper]
+        real_t cdf_lower, mass;
+
+        // The value of probability p in [0, 1] in the distribution, clamped to the interval
+        real_t inverse(real_t p) const
+        {
+            return std::clamp(dist.quantile(std::min(cdf_lower + p * mass, real_t(1))), lower, upper);
+        }
+        // The expectation of f(x) by quadrature over the probabilities, x = quantile(p) being finite inside (0, 1)
+        template <typename F>
+        real_t integrate(F f) const
+        {
+            return integrate_adaptive([&](const real_t* p, real_t* out, size_t n) {
+                quantile(p, out, n);
+                for (size_t i = 0; i < n; i++)
+                    out[i] = f(out[i]);
+            }, real_t(0), real_t(1)).value;
+        }
+    public:
+        /// @brief The distribution dist restricted to [lower, upper] (met with its own support)
+        /// @note std::invalid_argument is thrown when the interval is empty or has no probability
+        Truncated(const D& dist, real_t lower, real_t upper)
+            : dist(dist), lower(std::max(lower, dist.minValue())), upper(std::min(upper, dist.maxValue()))
+        {
+            if (!(this->lower < this->upper))
+                throw std::invalid_argument("The interval of a Truncated distribution must not be empty!");
+            cdf_lower = std::isfinite(this->lower) ? dist.cdf(this->lower) : 0;
+            const real_t cdf_upper = std::isfinite(this->upper) ? dist.cdf(this->upper) : 1;
+            mass = cdf_upper - cdf_lower;
+            if (!(mass > 0))
+                throw std::invalid_argument("The interval of a Truncated distribution has no probability!");
+        }
+
+        /// @brief Returns the next value of the random variable described by the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @note One uniform, through the quantile of the distribution
+        template <typename Derived, typename T>
+        real_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+        {
+            DF_INSTRUMENT_SAMPLES("Truncated", 1);
+            return inverse(detail::open_unit(rng.next_unit()));
+        }
+        /// @brief Fills the buffer with values of the random variable described by the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @param out Pointer to the first element of the buffer
+        /// @param n Number of values to be written
+        /// @note fill_unit, then the batch quantile of the distribution in place. The uniforms are moved up by
+        /// 2^-54, into (0, 1), so that no value falls on an infinite end.
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, real_t* out, size_t n)
+        {
+            DF_INSTRUMENT_SAMPLES("Truncated", n);
+            rng.fill_unit(out, n);
+            const real_t c = cdf_lower, m = mass;
+            for (size_t i = 0; i < n; i++)
+                out[i] = std::min(c + detail::open_unit(out[i]) * m, real_t(1));
+            dist.quantile(out, out, n);
+            for (size_t i = 0; i < n; i++)
+                out[i] = std::clamp(out[i], lower, upper);
+        }
+#if defined(DF_SPAN)
+        /// @brief Fills the span with values of the random variable described by the distribution
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<real_t> out)
+        {
+            sample(rng, out.data(), out.size());
+        }
+#endif
+
+        // The batch pdf, cdf and log-pdf of Continuous, over the ones below
+        using Continuous::pdf;
+        using Continuous::cdf;
+        using Continuous::logpdf;
+
+        /// @brief Returns the distribution before truncation
+        const D& get_distribution() const
+        {
+            return dist;
+        }
+        /// @brief Returns the probability of the interval in the distribution before truncation
+        real_t get_mass() const
+        {
+            return mass;
+        }
+
+        /// @brief Expectation, by adaptive quadrature of the quantile over (0, 1)
+        real_t expectation() const override final
+        {
+            return integrate([](real_t x) { return x; });
+        }
+        /// @brief Variance, by adaptive quadrature of the quantile over (0, 1)
+        real_t variance() const override final
+        {
+            const real_t mean = expectation();
+            return integrate([mean](real_t x) { return (x - mean) * (x - mean); });
+        }
+        real_t minValue() const override final
+        {
+            return lower;
+        }
+        real_t maxValue() const override final
+        {
+            return upper;
+        }
+        real_t pdf(real_t x) const override final
+        {
+            return (x < lower || x > upper) ? 0 : dist.pdf(x) / mass;
+        }
+        real_t cdf(real_t x) const override final
+        {
+            if (x <= lower)
+                return 0;
+            if (x >= upper)
+                return 1;
+            return std::clamp((dist.cdf(x) - cdf_lower) / mass, real_t(0), real_t(1));
+        }
+        real_t logpdf(real_t x) const override final
+        {
+            return (x < lower || x > upper) ? -INFINITY : dist.logpdf(x) - std::log(mass);
+        }
+        /// @brief Quantile function, the quantile of the distribution at cdf(lower) + p (cdf(upper) - cdf(lower))
+        real_t quantile(real_t p) const override final
+        {
+            detail::check_probability(p);
+            if (p == 0)
+                return lower;
+            if (p == 1)
+                return upper;
+            return inverse(p);
+        }
+        /// @brief Quantile function at n probabilities at once, with the batch quantile of the distribution
+        /// (out may be p)
+        void quantile(const real_t* p, real_t* out, size_t n) const override final
+        {
+            for (size_t i = 0; i < n; i++)
+                detail::check_probability(p[i]);
+            const real_t c = cdf_lower, m = mass;
+            for (size_t i = 0; i < n; i++)
+                out[i] = std::min(c + p[i] * m, real_t(1));
+            dist.quantile(out, out, n);
+            for (size_t i = 0; i < n; i++)
+                out[i] = std::clamp(out[i], lower, upper);
+        }
+    };
+
+    /// @brief DiceForge::Affine - The distribution of location + scale X, X being drawn from another distribution
+    /// @details sample(rng, out, n) is the sample of the distribution followed by one multiply-add per value
+    /// @tparam D the type of the distribution (such as Exponential or Weibull)
+    template <typename D>
+    class Affine : public Continuous {
+        static_assert(std::is_base_of_v<Continuous, D>, "An Affine distribution is Continuous");
+    private:
+        D dist;
+        real_t location, scale;
+
+        // The value x of the transform as a value of the distribution
+        real_t inverse(real_t x) const
+        {
+            return (x - location) / scale;
+        }
+        // Applies f(const real_t* y, real_t* out, size_t b) to the values y of the distribution for the n values
+        // x, a block at a time
+        template <typename F>
+        void blocks(F f, const real_t* x, real_t* out, size_t n) const
+        {
+            real_t y[detail::composite_block];
+            for (size_t first = 0; first < n; first += detail::composite_block) {
+                const size_t b = std::min(n - first, detail::composite_block);
+                for (size_t i = 0; i < b; i++)
+                    y[i] = inverse(x[first + i]);
+                f(y, out + first, b);
+            }
+        }
+    public:
+        /// @brief The distribution of location + scale X, for X drawn from dist
+        /// @note scale may be negative, which mirrors the distribution; std::invalid_argument is thrown when it
+        /// is 0 or either parameter is not finite
+        Affine(const D& dist, real_t location, real_t scale)
+            : dist(dist), location(location), scale(scale)
+        {
+            if (!(scale != 0) || !std::isfinite(scale) || !std::isfinite(location))
+                throw std::invalid_argument("An Affine distribution needs a finite location and a finite, non-zero scale!");
+        }
+
+        /// @brief Returns the next value of the random variable described by the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        template <typename Derived, typename T>
+        real_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+        {
+            DF_INSTRUMENT_SAMPLES("Affine", 1);
+            return location + scale * real_t(dist.next(rng));
+        }
+        /// @brief Fills the buffer with values of the random variable described by the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @param out Pointer to the first element of the buffer
+        /// @param n Number of values to be written
+        /// @note The sample of the distribution, then a multiply-add per value in a separate loop
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, real_t* out, size_t n)
+        {
+            DF_INSTRUMENT_SAMPLES("Affine", n);
+            dist.sample(rng, out, n);
+            const real_t a = location, s = scale;
+            for (size_t i = 0; i < n; i++)
+                out[i] = a + s * out[i];
+        }
+#if defined(DF_SPAN)
+        /// @brief Fills the span with values of the random variable described by the distribution
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<real_t> out)
+        {
+            sample(rng, out.data(), out.size());
+        }
+#endif
+
+        // The batch log-pdf of Continuous, over the one below
+        using Continuous::logpdf;
+
+        /// @brief Returns the distribution transformed
+        const D& get_distribution() const
+        {
+            return dist;
+        }
+        /// @brief Returns the location (the shift)
+        real_t get_location() const
+        {
+            return location;
+        }
+        /// @brief Returns the scale (negative for a mirrored distribution)
+        real_t get_scale() const
+        {
+            return scale;
+        }
+
+        real_t expectation() const override final
+        {
+            return location + scale * dist.expectation();
+        }
+        real_t variance() const override final
+        {
+            return scale * scale * dist.variance();
+        }
+        real_t minValue() const override final
+        {
+            return location + scale * (scale > 0 ? dist.minValue() : dist.maxValue());
+        }
+        real_t maxValue() const override final
+        {
+            return location + scale * (scale > 0 ? dist.maxValue() : dist.minValue());
+        }
+        real_t pdf(real_t x) const override final
+        {
+            return dist.pdf(inverse(x)) / std::fabs(scale);
+        }
+        real_t cdf(real_t x) const override final
+        {
+            const real_t p = dist.cdf(inverse(x));
+            return scale > 0 ? p : 1 - p;
+        }
+        real_t logpdf(real_t x) const override final
+        {
+            return dist.logpdf(inverse(x)) - std::log(std::fabs(scale));
+        }
+        void pdf(const real_t* x, real_t* out, size_t n) const override final
+        {
+            const real_t factor = 1 / std::fabs(scale);
+            blocks([&](const real_t* y, real_t* o, size_t b) {
+                dist.pdf(y, o, b);
+                for (size_t i = 0; i < b; i++)
+                    o[i] *= factor;
+            }, x, out, n);
+        }
+        void cdf(const real_t* x, real_t* out, size_t n) const override final
+        {
+            blocks([&](const real_t* y, real_t* o, size_t b) {
+                dist.cdf(y, o, b);
+                if (scale < 0)
+                    for (size_t i = 0; i < b; i++)
+                        o[i] = 1 - o[i];
+            }, x, out, n);
+        }
+        /// @brief Quantile function, location + scale quantile(p) (quantile(1 - p) for a negative scale)
+        real_t quantile(real_t p) const override final
+        {
+            detail::check_probability(p);
+            return location + scale * dist.quantile(scale > 0 ? p : 1 - p);
+        }
+        /// @brief Quantile function at n probabilities at once, with the batch quantile of the distribution
+        /// (out may be p)
+        void quantile(const real_t* p, real_t* out, size_t n) const override final
+        {
+            if (scale > 0)
+                dist.quantile(p, out, n);
+            else {
+                for (size_t i = 0; i < n; i++)
+                    detail::check_probability(p[i]);
+                for (size_t i = 0; i < n; i++)
+                    out[i] = 1 - p[i];
+                dist.quantile(out, out, n);
+            }
+            const real_t a = location, s = scale;
+            for (size_t i = 0; i < n; i++)
+                out[i] = a + s * out[i];
+        }
+    };
+}
+
+#endif
+
+// src/Distributions/Discrete/Bernoulli/Bernoulli.h
+
+#ifndef DF_BERNOULLI_H
+#define DF_BERNOULLI_H
+
+
+namespace DiceForge {
     /// @brief DiceForge::Bernoulli - A Discrete Probability Distribution (Bernoulli) 
     class Bernoulli : public Discrete {
         private:
-            float p;
+            real_t p;
+            // p as a 64-bit fixed-point fraction, and the lowest set bit of it
+            uint64_t cut;
+            int low;
         public:
             /// @brief Constructor for the Bernoulli Distribution
-            /// @param p 
+            /// @param p probability of 1
             Bernoulli(real_t p);
             /// @brief Returns the next value of the random variable described by the distribution
             /// @param r A random real number uniformly distributed between 0 and 1
             int_t next(real_t r);
+            /// @brief Returns the next value of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @note Compares 64 random bits with p in fixed point, without going through a real number
+            template <typename Derived, typename T>
+            int_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+            {
+                DF_INSTRUMENT_SAMPLES("Bernoulli", 1);
+                return (p >= 1 || detail::bits64(rng) < cut) ? 1 : 0;
+            }
+            /// @brief Fills the buffer with trials packed 64 to a word, bit j of out[i] being trial 64 i + j
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param out Pointer to the first word of the buffer
+            /// @param words Number of words to be written
+            /// @note All 64 lanes compare their random bits with the bits of p together, from the most significant
+            /// one, and a lane is settled at the first bit that differs from p. That takes about 7 words of the RNG
+            /// for 64 trials (a single one for p = 1/2), and ends early when the remaining bits of p are zero.
+            template <typename Derived, typename T>
+            void sample_bits(DiceForge::StaticGenerator<Derived, T>& rng, uint64_t* out, size_t words)
+            {
+                DF_INSTRUMENT_SAMPLES("Bernoulli", 64 * words);
+                for (size_t w = 0; w < words; w++)
+                {
+                    if (p >= 1 || cut == 0)
+                    {
+                        out[w] = (p >= 1) ? ~uint64_t(0) : 0;
+                        continue;
+                    }
+                    uint64_t undecided = ~uint64_t(0), ones = 0;
+                    for (int i = 63; i >= low && undecided != 0; i--)
+                    {
+                        uint64_t u = detail::bits64(rng);
+                        if ((cut >> i) & 1)
+                        {
+                            // A 0 where p has a 1: that trial's number is below p
+                            ones |= undecided & ~u;
+                            undecided &= u;
+                        }
+                        else
+                            undecided &= ~u;
+                    }
+                    out[w] = ones;
+                }
+            }
+            /// @brief Fills the buffer with values of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param out Pointer to the first element of the buffer
+            /// @param count Number of values to be written
+            /// @note Unpacks the words of sample_bits
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, int_t* out, size_t count)
+            {
+                DF_INSTRUMENT_SAMPLES("Bernoulli", count);
+                uint64_t bits;
+                for (size_t i = 0; i < count; i += 64)
+                {
+                    sample_bits(rng, &bits, 1);
+                    for (size_t j = 0; j < 64 && i + j < count; j++)
+                        out[i + j] = int_t((bits >> j) & 1);
+                }
+            }
+            /// @brief Fills the buffer with one trial of each of n Bernoulli distributions, without constructing them
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param p Pointer to the n probabilities of 1 (in [0, 1])
+            /// @param out Pointer to the first element of the buffer
+            /// @param count Number of values to be written
+            /// @note A comparison of a block of uniforms from fill_unit with the probabilities, without branches
+            template <typename Derived, typename T>
+            static void sample_each(DiceForge::StaticGenerator<Derived, T>& rng, const real_t* p, int_t* out,
+                                    size_t count)
+            {
+                DF_INSTRUMENT_SAMPLES("Bernoulli", count);
+                bool valid = true;
+                for (size_t i = 0; i < count; i++)
+                    valid &= (p[i] >= 0) & (p[i] <= 1);
+                if (!valid)
+                    throw std::invalid_argument("Error: Invalid probability value for Bernoulli distribution!");
+                real_t u[256];
+                while (count > 0)
+                {
+                    size_t m = std::min(count, size_t(256));
+                    rng.fill_unit(u, m);
+                    for (size_t i = 0; i < m; i++)
+                        out[i] = int_t(u[i] < p[i]);
+                    p += m;
+                    out += m;
+                    count -= m;
+                }
+            }
             /// @brief Returns the theoretical variance of the distribution
             /// @returns p(1-p)
             real_t variance() const override final;
@@ -328,23 +2075,97 @@ namespace DiceForge {
             real_t pmf(int_t k) const override final;            
             /// @brief Cumulative distribution function of the Bernoulli distribution
             real_t cdf(int_t k) const override final;
+            /// @brief Quantile function of the Bernoulli distribution, 0 for u <= 1 - p and 1 above
+            int_t quantile(real_t u) const override final;
+            using Discrete::pmf;
+            using Discrete::cdf;
+            using Discrete::quantile;
     };
+}
+
+
+#endif
+
+
 
+// src/Distributions/Discrete/Binomial/Binomial.h
+
+#ifndef DF_BINOMIAL_H
+#define DF_BINOMIAL_H
+
+#include <vector>
+
+namespace DiceForge {
     /// @brief DiceForge::Binomial - A Discrete Probability Distribution (Binomial Distribution) 
     class Binomial : public Discrete {
         private:
             uint_t n;
             real_t p;
-            std::vector<real_t> pmfs;
+            // Values are drawn as Y ~ Binomial(n, s) with s = min(p, 1 - p), and X = n - Y when p > 1/2
+            real_t s, lns, lnq;
+            bool flipped;
+            // Below this n * s values are drawn by inversion, above it by BTPE
+            static constexpr real_t inversion_limit = 30;
+            // Inversion: cdf[k] = P(Y <= k) up to where the remaining terms no longer change the sum,
+            // and guide[j] = smallest k with cdf[k] > j / guide.size()
+            std::vector<real_t> table;
+            std::vector<int_t> guide;
+            // BTPE constants (Kachitvichyanukul and Schmeiser, "Binomial random variate generation")
+            int_t m;
+            real_t xm, xl, xr, c, laml, lamr, p1, p2, p3, p4;
+
+            int_t from_table(real_t u) const
+            {
+                int_t k = guide[size_t(u * guide.size())];
+                while (k + 1 < int_t(table.size()) && u >= table[k]) k++;
+                return k;
+            }
+            // One BTPE attempt with the uniforms u and v, Y if accepted and -1 otherwise
+            int_t btpe(real_t u, real_t v) const;
+            // P(Y <= k)
+            real_t cdf_y(int_t k) const;
         public:
             /// @brief Initializes the Binomial Distribution with (n, p)
             /// @param n number of trials 
             /// @param p probability of "success" in each trial
             /// @note 0 <= p <= 1
+            /// @note n * min(p, 1 - p) below 30 gets an inversion table with a guide table, sized by the
+            /// probabilities rather than n; above that values are drawn by BTPE in O(1) expected time
             Binomial(uint_t n, real_t p);
             /// @brief Returns the next value of the random variable described by the distribution
             /// @param r A random real number uniformly distributed between 0 and 1
+            /// @note Inversion, walking from the mode when there is no table
             int_t next(real_t r);
+            /// @brief Returns the next value of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            template <typename Derived, typename T>
+            int_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+            {
+                DF_INSTRUMENT_SAMPLES("Binomial", 1);
+                int_t y;
+                if (!table.empty())
+                    y = from_table(rng.next_unit());
+                else {
+                    do {
+                        real_t u = rng.next_unit();
+                        y = btpe(u, rng.next_unit());
+                        if (y < 0)
+                            DF_INSTRUMENT_REJECT("Binomial");
+                    } while (y < 0);
+                }
+                return flipped ? int_t(n) - y : y;
+            }
+            /// @brief Fills the buffer with values of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param out Pointer to the first element of the buffer
+            /// @param count Number of values to be written
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, int_t* out, size_t count)
+            {
+                DF_INSTRUMENT_SAMPLES("Binomial", count);
+                for (size_t i = 0; i < count; i++)
+                    out[i] = next(rng);
+            }
             /// @brief Returns the theoretical variance of the distribution
             real_t variance() const override final;
             /// @brief Returns the theoretical expectation value of the distribution
@@ -357,20 +2178,49 @@ namespace DiceForge {
             /// @note Here it is the probability of encountering exactly k "success" trials
             real_t pmf(int_t k) const override final;
             /// @brief Cumulative distribution function of the Binomial distribution
+            /// @note A table lookup, or the regularized incomplete beta function I_(1-p)(n - k, k + 1)
             real_t cdf(int_t k) const override final;
+            /// @brief Natural logarithm of the probability mass function of the Binomial distribution
+            real_t logpmf(int_t k) const override final;
+            using Discrete::pmf;
+            using Discrete::logpmf;
+            using Discrete::cdf;
     };
-    
+}
+
+
+#endif
+
+// src/Distributions/Discrete/Gibbs/Gibbs.h
+
+#ifndef DF_GIBBS_H
+#define DF_GIBBS_H
+
+#include <algorithm>
+#include <vector>
+
+namespace DiceForge {
+
     /// @brief DiceForge::Gibbs - Gibbs distribution class (derived from Discrete)
     class Gibbs : public Discrete {
     private:
-        // Array to store cdf
-        real_t *cdf_array = nullptr;
-        // Array to store pmf
-        real_t *pmf_array = nullptr;
-        // Array to store x values (output values)
-        int_t *x_array = nullptr;
-        // Length of all 3 arrays
+        // x values (output values), sorted, and the energies that go with them
+        std::vector<int_t> x_array;
+        std::vector<real_t> energy_array;
+        // pmf and cdf (prefix sum of the pmf) of each x value
+        std::vector<real_t> pmf_array;
+        std::vector<real_t> cdf_array;
+        // Alias table: probability of keeping each column, and the index it is paired with otherwise
+        std::vector<real_t> alias_prob;
+        std::vector<int_t> alias_index;
+        // Worklist for building the alias table, kept so that setBeta does not allocate
+        std::vector<int_t> work;
+        // Length of all the arrays
         int_t n = 0;
+        real_t current_beta = 0;
+
+        // Sorts the (x, energy) pairs and checks them, then computes the distribution for beta
+        void init(std::vector<std::pair<int_t, real_t>>& xy, real_t beta);
     public:
         /// @brief Constructor to initialise private attributes of the distribution
         template <typename RandomAccessIterator1, typename RandomAccessIterator2>
@@ -381,55 +2231,52 @@ namespace DiceForge {
             if (sequence_last - sequence_first != function_last - function_first){
                 throw std::invalid_argument("Lengths of sequence and function sequence must match!");
             }
-            n = sequence_last - sequence_first;
             // Display error if n is not at least 1
-            if (n <= 0) {
+            if (sequence_last - sequence_first <= 0) {
                 throw std::invalid_argument("len must be positive!");
             }
 
-            // Sort the pmf in increasing order of x (required for constructing cdf)
-            std::pair<int_t, real_t> xy_arr[n];
-            for (int i = 0; i < n; i++){
-                xy_arr[i].first = sequence_first[i];
-                xy_arr[i].second = function_first[i];
-            }
-            std::sort(xy_arr, xy_arr + n);
-
-            // Display error if x values are not unique
-            for (int i = 1; i < n; i++) {
-                if (xy_arr[i].first == xy_arr[i - 1].first) {
-                    throw std::invalid_argument("All x values in x_arr must be unique!");
-                }
-            }
-
-            // Store x_array
-            x_array = (int_t*)malloc(n * sizeof(int_t));
-            for (int i = 0; i < n; i++){
-                x_array[i] = xy_arr[i].first;
+            std::vector<std::pair<int_t, real_t>> xy(sequence_last - sequence_first);
+            for (size_t i = 0; i < xy.size(); i++){
+                xy[i].first = sequence_first[i];
+                xy[i].second = function_first[i];
             }
+            init(xy, beta);
+        }
 
-            // Store pmf_array and cdf_array (prefix sum array of pmf_array)
-            pmf_array = (real_t *)malloc(n * sizeof(real_t));
-            cdf_array = (real_t *)malloc(n * sizeof(real_t));
-            real_t prev = 0;
-            for (int i = 0; i < n; i++){
-                pmf_array[i] = exp(- beta * xy_arr[i].second);
-                cdf_array[i] = prev + pmf_array[i];
-                prev = cdf_array[i];
-            }
+        /// @brief Recomputes the distribution for a new beta, reusing the sorted values and all the arrays
+        /// @note O(n), without sorting or allocating, for sweeping beta (as in simulated annealing)
+        void setBeta(real_t beta);
 
-            // Divide by Z(beta) = cdf_array[n - 1] for normalisation
-            for (int i = 0; i < n; i++){
-                pmf_array[i] /= cdf_array[n - 1];
-                cdf_array[i] /= cdf_array[n - 1];
-            }
-        }
-        // Destructor to free memory used by the 3 array attributes
-        ~Gibbs();
+        /// @brief The current beta
+        real_t getBeta() const;
         
         /// @brief Returns a sample of the random variable following the distribution given a 'r'
         /// @param r a uniformly distributed unit random variable
+        /// @note Inversion by binary search, so that the value is nondecreasing in r
         int_t next(real_t r);
+
+        /// @brief Returns a sample of the random variable following the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @note O(1) per value, by the alias method
+        template <typename Derived, typename T>
+        int_t next(DiceForge::StaticGenerator<Derived, T>& rng){
+            DF_INSTRUMENT_SAMPLES("Gibbs", 1);
+            size_t i = size_t(detail::uniform_index(rng, uint64_t(n)));
+            return x_array[(rng.next_unit() < alias_prob[i]) ? int_t(i) : alias_index[i]];
+        }
+
+        /// @brief Fills the buffer with samples of the random variable following the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @param out Pointer to the first element of the buffer
+        /// @param count Number of values to be written
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, int_t* out, size_t count){
+            DF_INSTRUMENT_SAMPLES("Gibbs", count);
+            for (size_t j = 0; j < count; j++){
+                out[j] = next(rng);
+            }
+        }
         
         /// @brief Returns the theoretical variance of the distribution
         real_t variance() const override;
@@ -448,35 +2295,289 @@ namespace DiceForge {
         
         /// @brief Cumulative distribution function for the Gibbs distribution
         real_t cdf(int_t x) const override;
+
+        /// @brief Quantile function for the Gibbs distribution, the first x whose cdf reaches p (binary search)
+        int_t quantile(real_t p) const override;
+        using Discrete::pmf;
+        using Discrete::cdf;
+        using Discrete::quantile;
     };
-    
+}
+
+
+#endif
+
+// src/Distributions/Discrete/DynamicDiscrete/DynamicDiscrete.h
+
+#ifndef DF_DYNAMIC_DISCRETE_H
+#define DF_DYNAMIC_DISCRETE_H
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace DiceForge {
+
+    /// @brief DiceForge::DynamicDiscrete - The distribution of an index i in [0, n) drawn with probability
+    /// proportional to its weight w[i], with weights that can change between draws (derived from Discrete)
+    /// @note The weights are the leaves of a tree of sums with 8 children per node, so that a draw descends from the
+    /// total to a leaf reading one cache line per level (7 levels for a million weights), and changing a weight
+    /// recomputes the sums on its path: O(log n) for both. The sums are recomputed from the children rather than
+    /// adjusted by differences, so they do not drift however many updates are made.
+    class DynamicDiscrete : public Discrete {
+    private:
+        static constexpr size_t fanout = 8;
+        // levels[0] holds the weights, padded with zeros to a multiple of fanout, and levels[l + 1][j] the sum of
+        // levels[l][fanout j] to levels[l][fanout j + fanout - 1], up to the last level whose only entry is the total
+        std::vector<std::vector<real_t>> levels;
+        size_t n = 0;
+
+        // Throws unless the weight is finite and not negative
+        static void check_weight(real_t w);
+        // Lays out the levels for n weights, keeping the existing ones, and computes all the sums
+        void build();
+        // Recomputes the sums on the path of weight i
+        void repair(size_t i);
+        // Recomputes the sums on the paths of the m weights index[k], or the whole tree when there are many
+        void repair(const size_t* index, size_t m);
+        // Sum of the weights before index i
+        real_t prefix(size_t i) const;
+        // Nearest index before (after) i with a positive weight, n if there is none, in O(log n) through the sums
+        size_t previous_positive(size_t i) const;
+        size_t next_positive(size_t i) const;
+
+        // Index of the weight where target u in [0, total) falls, or (inclusive) the first where the running sum
+        // reaches u; a weight of 0 is never chosen
+        template <bool inclusive>
+        size_t find(real_t u) const
+        {
+            size_t j = 0;
+            for (size_t l = levels.size() - 1; l-- > 0;){
+                const real_t* s = levels[l].data() + fanout * j;
+                size_t c = 0, last = 0;
+                for (; c < fanout; c++){
+                    if (s[c] > 0){
+                        if (inclusive ? u <= s[c] : u < s[c])
+                            break;
+                        last = c;
+                        u -= s[c];
+                    }
+                }
+                if (c == fanout){
+                    // Rounding took u past the sum of the children: the first positive weight under the last
+                    c = last;
+                    u = 0;
+                }
+                j = fanout * j + c;
+            }
+            return j;
+        }
+    public:
+        /// @brief Initialises n weights of 0 (to be set with update before sampling)
+        explicit DynamicDiscrete(size_t n = 0);
+
+        /// @brief Initialises the weights of the indices 0, 1, ... from a sequence
+        /// @note The weights must be finite and not negative, as must be their total (std::invalid_argument
+        /// otherwise)
+        template <typename InputIterator>
+        DynamicDiscrete(InputIterator first, InputIterator last){
+            std::vector<real_t> w(first, last);
+            for (real_t x : w)
+                check_weight(x);
+            n = w.size();
+            levels.assign(1, std::move(w));
+            build();
+            if (!std::isfinite(total()))
+                throw std::invalid_argument("The sum of the weights must be finite!");
+        }
+
+        /// @brief Sets the weight of index i, in O(log n)
+        /// @note std::out_of_range for i >= size(), std::invalid_argument for a negative or non-finite weight, or one
+        /// that takes the total to infinity (the weights then being left as they were)
+        void update(size_t i, real_t w);
+
+        /// @brief Sets the weights of the m indices index[k] to weight[k]
+        /// @note All the arguments are checked before anything changes, and the weights are put back if the total
+        /// overflows (std::invalid_argument as for update(i, w)). The paths of the changed weights are
+        /// recomputed once each, where their sums are shared, and the whole tree is rebuilt instead (in O(n)) when
+        /// there are more than n / fanout of them.
+        void update(const size_t* index, const real_t* weight, size_t m);
+
+        /// @brief Changes the number of weights, those added being 0
+        /// @note O(n)
+        void resize(size_t size);
+
+        /// @brief Number of weights
+        size_t size() const;
+
+        /// @brief Weight of index i
+        real_t weight(size_t i) const;
+
+        /// @brief Sum of the weights
+        real_t total() const;
+
+        /// @brief Returns a sample of the random variable following the distribution given a 'r'
+        /// @param r a uniformly distributed unit random variable
+        /// @note Nondecreasing in r; std::invalid_argument if all the weights are 0
+        int_t next(real_t r) const;
+
+        /// @brief Returns a sample of the random variable following the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @note O(log n) per value; std::invalid_argument if all the weights are 0
+        template <typename Derived, typename T>
+        int_t next(DiceForge::StaticGenerator<Derived, T>& rng) const {
+            DF_INSTRUMENT_SAMPLES("DynamicDiscrete", 1);
+            return next(rng.next_unit());
+        }
+
+        /// @brief Fills the buffer with samples of the random variable following the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @param out Pointer to the first element of the buffer
+        /// @param count Number of values to be written
+        /// @note Blocks of uniforms from fill_unit, each descending the tree
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, int_t* out, size_t count) const {
+            DF_INSTRUMENT_SAMPLES("DynamicDiscrete", count);
+            const real_t sum = total();
+            if (!(sum > 0))
+                throw std::invalid_argument("All the weights are zero!");
+            real_t u[256];
+            while (count > 0){
+                size_t m = std::min(count, size_t(256));
+                rng.fill_unit(u, m);
+                for (size_t i = 0; i < m; i++)
+                    out[i] = int_t(find<false>(u[i] * sum));
+                out += m;
+                count -= m;
+            }
+        }
+
+        /// @brief Returns the theoretical variance of the distribution
+        /// @note O(n)
+        real_t variance() const override;
+
+        /// @brief Returns the theoretical expectation value of the distribution
+        /// @note O(n)
+        real_t expectation() const override;
+
+        /// @brief Smallest number that can be generated in the distribution
+        /// @returns 0
+        int_t minValue() const override;
+
+        /// @brief Largest number that can be generated in the distribution
+        /// @returns size() - 1
+        int_t maxValue() const override;
+
+        /// @brief Probability mass function, w[x] / total()
+        real_t pmf(int_t x) const override;
+
+        /// @brief Cumulative distribution function, in O(log n) from the sums of the tree
+        real_t cdf(int_t x) const override;
+
+        /// @brief Quantile function, the first x whose cdf reaches p, in O(log n) by descending the tree
+        int_t quantile(real_t p) const override;
+        using Discrete::pmf;
+        using Discrete::cdf;
+        using Discrete::quantile;
+    };
+}
+
+#endif
+
+// src/Distributions/Discrete/Hypergeometric/Hypergeometric.h
+
+#ifndef DF_HYPERGEOMETRIC_H
+#define DF_HYPERGEOMETRIC_H
+
+#include <vector>
+
+namespace DiceForge
+{
     /// @brief DiceForge::Discrete - A discrete probability distribution
     /// @details This is the distribution you get when drawing balls without
     /// replacement from an urn with two colors. n is the number of balls you take,
     /// K is the number of red balls in the urn, N is the total number of balls in
     /// the urn, and the return value is the number of red balls you get.
-    /// To regenerate samples of the variation this class uses inversion by chop-down
-    /// search from start when parameters are small
+    /// To regenerate samples of the variation this class uses inversion with a guide
+    /// table when the spread is small, and ratio-of-uniforms rejection otherwise
     class Hypergeometric : public Discrete
     {
     private:
         int32_t N, K, n;
-        std::vector<real_t> pmfs;
-        std::vector<real_t> cumulative;
         // N - total size of the population
         // K - occurence in the population (successes)
         // n - sample numbers
         // constraints-(n<=N and k<=N and n>=0 and k>=0)
+        // Support [lo, hi] and mode
+        int_t lo, hi, mode;
+        // log(K!) + log((N - K)!) - log(nCr(N, n)), the part of logpmf that does not depend on k
+        real_t lnorm;
+        // Below this standard deviation values are drawn by inversion, above it by ratio-of-uniforms
+        static constexpr real_t inversion_limit = 30;
+        // Inversion: pmfs and cumulative from first on, over the values whose probabilities are not negligible,
+        // and guide[j] = first index with cumulative > j / guide.size()
+        int_t first;
+        std::vector<real_t> pmfs;
+        std::vector<real_t> cumulative;
+        std::vector<int_t> guide;
+        // Ratio-of-uniforms (Stadlober): centre, width and cut-off of the hat, and logpmf at the mode
+        real_t centre, width, cutoff, lpmode;
+
+        int_t from_table(real_t u) const
+        {
+            int_t k = guide[size_t(u * guide.size())];
+            while (k + 1 < int_t(cumulative.size()) && u >= cumulative[k]) k++;
+            return first + k;
+        }
+        // pmf(k + 1) / pmf(k) and pmf(k - 1) / pmf(k)
+        real_t ratio_up(int_t k) const;
+        real_t ratio_down(int_t k) const;
+        // One ratio-of-uniforms attempt with the uniforms u and v, the value if accepted and -1 otherwise
+        int_t attempt(real_t u, real_t v) const;
+        // pmf(x) + pmf(x + step) + pmf(x + 2 step) + ... until the terms are negligible
+        real_t tail(int_t x, int step) const;
     public:
         /// @brief Constructor for the Hypergeometric distribution
         /// @param N total size of the population
         /// @param K occurence in the population (successes)
         /// @param n sample numbers
         /// @note n<=N, k<=N, n>=0, k>=0
+        /// @note The cost of construction follows the standard deviation, not the support. Below 30 it builds
+        /// tables for inversion with a guide table, above it values are drawn by ratio-of-uniforms in O(1)
+        /// expected time.
         Hypergeometric(int32_t N, int32_t K, int32_t n); 
         /// @brief Returns the next value of the random variable described by the distribution
         /// @param r A random real number uniformly distributed between 0 and 1
         int_t next(real_t r);        
+        /// @brief Returns the next value of the random variable described by the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        template <typename Derived, typename T>
+        int_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+        {
+            DF_INSTRUMENT_SAMPLES("Hypergeometric", 1);
+            if (!cumulative.empty())
+                return from_table(rng.next_unit());
+            int_t k;
+            do {
+                real_t u = rng.next_unit();
+                k = attempt(u, rng.next_unit());
+                if (k < 0)
+                    DF_INSTRUMENT_REJECT("Hypergeometric");
+            } while (k < 0);
+            return k;
+        }
+        /// @brief Fills the buffer with values of the random variable described by the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @param out Pointer to the first element of the buffer
+        /// @param count Number of values to be written
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, int_t* out, size_t count)
+        {
+            DF_INSTRUMENT_SAMPLES("Hypergeometric", count);
+            for (size_t i = 0; i < count; i++)
+                out[i] = next(rng);
+        }
         /// @brief Returns the theoretical variance of the distribution
         real_t variance() const override;
         /// @brief Returns the theoretical expectation value of the distribution
@@ -489,25 +2590,96 @@ namespace DiceForge {
         real_t pmf(int_t k) const override;       
         /// @brief Cumulative distribution function of the Hypergeometric distribution 
         real_t cdf(int_t k) const override;
+        /// @brief Natural logarithm of the probability mass function of the Hypergeometric distribution
+        real_t logpmf(int_t k) const override;
+        using Discrete::pmf;
+        using Discrete::logpmf;
+        using Discrete::cdf;
     };
+}
+
+#endif
+
+// src/Distributions/Discrete/Negative-Hypergeometric/NegHypergeometric.h
 
+#ifndef DF_NEGHYPERGEOMETIRC_H
+#define DF_NEGHYPERGEOMETIRC_H
+
+#include <vector>
+
+namespace DiceForge {
     /// @brief DiceForge::NegHypergeometric - A Discrete Probability Distribution (Negative Hypergeometric) 
     class NegHypergeometric : public Discrete {
         private:
             uint_t N, K, r;
-            real_t* pmfs;
+            // Largest value with a non-zero probability, and the mode
+            int_t hi, mode;
+            // The part of logpmf that does not depend on k
+            real_t lnorm;
+            // Below this standard deviation values are drawn by inversion, above it by ratio-of-uniforms
+            static constexpr real_t inversion_limit = 30;
+            // Inversion: pmfs and cumulative from first on, over the values whose probabilities are not negligible,
+            // and guide[j] = first index with cumulative > j / guide.size()
+            int_t first;
+            std::vector<real_t> pmfs;
+            std::vector<real_t> cumulative;
+            std::vector<int_t> guide;
+            // Ratio-of-uniforms (Stadlober): centre, width and cut-off of the hat, and logpmf at the mode
+            real_t centre, width, cutoff, lpmode;
+
+            int_t from_table(real_t u) const
+            {
+                int_t k = guide[size_t(u * guide.size())];
+                while (k + 1 < int_t(cumulative.size()) && u >= cumulative[k]) k++;
+                return first + k;
+            }
+            // pmf(k + 1) / pmf(k) and pmf(k - 1) / pmf(k)
+            real_t ratio_up(int_t k) const;
+            real_t ratio_down(int_t k) const;
+            // One ratio-of-uniforms attempt with the uniforms u and v, the value if accepted and -1 otherwise
+            int_t attempt(real_t u, real_t v) const;
+            // pmf(x) + pmf(x + step) + pmf(x + 2 step) + ... until the terms are negligible
+            real_t tail(int_t x, int step) const;
         public:
             /// @brief Initializes the Negative Hypergeometric Distribution with (N, K, r)
             /// @param N size of the population 
             /// @param K number of "success" elements in the population
             /// @param r number of "failure" elements to be encountered before experiment is stopped
             /// @note 0 <= K <= N, 0 <= r <= N - K for a valid distribution
+            /// @note As for DiceForge::Hypergeometric, tables for inversion are only built when the standard
+            /// deviation is below 30, and values are drawn by ratio-of-uniforms otherwise
             NegHypergeometric(uint_t N, uint_t K, uint_t r);
-            /// @brief Default destuctor
-            ~NegHypergeometric();
             /// @brief Returns the next value of the random variable described by the distribution
             /// @param r A random real number uniformly distributed between 0 and 1
             int_t next(real_t r);
+            /// @brief Returns the next value of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            template <typename Derived, typename T>
+            int_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+            {
+                DF_INSTRUMENT_SAMPLES("NegHypergeometric", 1);
+                if (!cumulative.empty())
+                    return from_table(rng.next_unit());
+                int_t k;
+                do {
+                    real_t u = rng.next_unit();
+                    k = attempt(u, rng.next_unit());
+                    if (k < 0)
+                        DF_INSTRUMENT_REJECT("NegHypergeometric");
+                } while (k < 0);
+                return k;
+            }
+            /// @brief Fills the buffer with values of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param out Pointer to the first element of the buffer
+            /// @param count Number of values to be written
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, int_t* out, size_t count)
+            {
+                DF_INSTRUMENT_SAMPLES("NegHypergeometric", count);
+                for (size_t i = 0; i < count; i++)
+                    out[i] = next(rng);
+            }
             /// @brief Returns the theoretical variance of the distribution
             real_t variance() const override final;
             /// @brief Returns the theoretical expectation value of the distribution
@@ -522,33 +2694,159 @@ namespace DiceForge {
             /// @brief Cumulative distribution function of the Negative hypergeometric distribution
             /// @note Here it is the probability of encountering at most k "success" elements when the experiment is stopped
             real_t cdf(int_t k) const override final;
+            /// @brief Natural logarithm of the probability mass function of the Negative hypergeometric distribution
+            real_t logpmf(int_t k) const override final;
+            using Discrete::pmf;
+            using Discrete::logpmf;
+            using Discrete::cdf;
     };
+}
+
+
+#endif
+
+// src/Distributions/Discrete/Poisson/Poisson.h
+
+#ifndef DF_POISSON_H
+#define DF_POISSON_H
+
+#include <vector>
+#include <algorithm>
+
+namespace DiceForge {
     
     /// @brief DiceForge::Poisson - A discrete probability distribution
     class Poisson : public Discrete {
         private:
             real_t l,sq,lnl,g;
+            // Below this lambda values are drawn from a table, above it by transformed rejection
+            static constexpr real_t table_limit = 10;
+            // Table mode: cdf[k] = P(X <= k) up to where the remaining terms no longer change the sum,
+            // and guide[j] = smallest k with cdf[k] > j / guide.size()
+            std::vector<real_t> table;
+            std::vector<int_t> guide;
+            // PTRS constants (Hormann, "The transformed rejection method for generating Poisson random variables")
+            real_t a,b,inv_alpha,vr;
+
+            int_t from_table(real_t u) const
+            {
+                int_t k=guide[size_t(u*guide.size())];
+                while (k+1<int_t(table.size()) && u>=table[k]) k++;
+                return k;
+            }
+            // Inversion by sequential search from 0, for a small lambda without a table
+            static int_t invert(real_t u, real_t lambda)
+            {
+                real_t p=std::exp(-lambda), sum=p;
+                int_t k=0;
+                while (u>=sum && p>sum*1e-17){
+                    k++;
+                    p*=lambda/k;
+                    sum+=p;
+                }
+                return k;
+            }
+            // invert(u[i], lambda[i]) for the means below table_limit, e^-lambda being worked out on lanes of
+            // simd::vreal; the others are left to sample_each (n <= 256)
+            static void invert_each(const real_t* u, const real_t* lambda, int_t* out, size_t n);
+            // PTRS with the constants of the given lambda, u being the first uniform
+            template <typename Derived, typename T>
+            static int_t ptrs(DiceForge::StaticGenerator<Derived, T>& rng, real_t u, real_t lambda, real_t lnl,
+                              real_t a, real_t b, real_t inv_alpha, real_t vr)
+            {
+                while (true){
+                    u-=0.5;
+                    real_t v=rng.next_unit();
+                    real_t us=0.5-fabs(u);
+                    int_t k=int_t(floor((2*a/us+b)*u+lambda+0.43));
+                    if (us>=0.07 && v<=vr)
+                        return k;
+                    if (k<0 || (us<0.013 && v>us)){
+                        DF_INSTRUMENT_REJECT("Poisson");
+                        u=rng.next_unit();
+                        continue;
+                    }
+                    if (log(v*inv_alpha/(a/(us*us)+b)) <= -lambda+k*lnl-log_factorial(k))
+                        return k;
+                    DF_INSTRUMENT_REJECT("Poisson");
+                    u=rng.next_unit();
+                }
+            }
         public:
             /// @brief Constructor for the Poisson Distribution
             /// @param lambda lambda (> 0)
+            /// @note Small lambda (< 10) get an inversion table with a guide table, so that a value costs one uniform
+            /// and about one comparison. Larger ones use PTRS, accepting nearly 90% of the first attempts without
+            /// any logarithm.
             Poisson(real_t lambda);
 
             /// @brief Returns the next value of the random variable described by the distribution
-            /// @param rng A random number generator (derived from DiceForge::Generator) 
-            template <typename T>
-            int_t next(DiceForge::Generator<T>& rng)
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            template <typename Derived, typename T>
+            int_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+            {
+                DF_INSTRUMENT_SAMPLES("Poisson", 1);
+                if (!table.empty())
+                    return from_table(rng.next_unit());
+                return ptrs(rng, rng.next_unit(), l, lnl, a, b, inv_alpha, vr);
+            }
+
+            /// @brief Fills the buffer with values of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param out Pointer to the first element of the buffer
+            /// @param n Number of values to be written
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, int_t* out, size_t n)
             {
-                real_t t,x,c;
-                do{
-                    do{
-                        t=tan(M_PI*rng.next_unit());
-                        x=sq*t+l;
-                    } while (x<0);
-                    x=floor(x);
-                    c=0.9*(1+t*t)*exp(x*lnl-lgamma(x+1)-g);
-                } while(rng.next_unit()>c);
+                DF_INSTRUMENT_SAMPLES("Poisson", n);
+                if (table.empty()){
+                    for (size_t i=0; i<n; i++) out[i]=next(rng);
+                    return;
+                }
+                // Uniforms in blocks, looked up in the table
+                real_t u[256];
+                while (n>0){
+                    size_t m=std::min(n,size_t(256));
+                    rng.fill_unit(u,m);
+                    for (size_t i=0; i<m; i++) out[i]=from_table(u[i]);
+                    out+=m;
+                    n-=m;
+                }
+            }
 
-                return int_t(x);
+            /// @brief Fills the buffer with one value of each of n Poisson distributions, without constructing them
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param lambda Pointer to the n means (>= 0)
+            /// @param out Pointer to the first element of the buffer
+            /// @param n Number of values to be written
+            /// @note Means below 10 are inverted by a sequential search from 0 (one exponential and about lambda
+            /// steps), larger ones go through PTRS with its constants worked out on the spot (a square root
+            /// and a logarithm), both starting from a block of uniforms from fill_unit. The searches run lanes at a
+            /// time, each lane stepping until its own value is found.
+            template <typename Derived, typename T>
+            static void sample_each(DiceForge::StaticGenerator<Derived, T>& rng, const real_t* lambda, int_t* out,
+                                    size_t n)
+            {
+                DF_INSTRUMENT_SAMPLES("Poisson", n);
+                bool valid=true;
+                for (size_t i=0; i<n; i++) valid&=(lambda[i]>=0);
+                if (!valid)
+                    throw std::invalid_argument("Lambda must not be negative!");
+                real_t u[256];
+                while (n>0){
+                    size_t m=std::min(n,size_t(256));
+                    rng.fill_unit(u,m);
+                    invert_each(u,lambda,out,m);
+                    for (size_t i=0; i<m; i++){
+                        const real_t l=lambda[i];
+                        if (l<table_limit) continue;
+                        const real_t b=0.931+2.53*std::sqrt(l), a=-0.059+0.02483*b;
+                        out[i]=ptrs(rng,u[i],l,std::log(l),a,b,1.1239+1.1328/(b-3.4),0.9277-3.6224/(b-2));
+                    }
+                    lambda+=m;
+                    out+=m;
+                    n-=m;
+                }
             }
 
             /// @brief Returns the theoretical variance of the distribution
@@ -569,13 +2867,44 @@ namespace DiceForge {
             real_t pmf(int_t x) const override;
 
             /// @brief Cumulative distribution function of the Poisson distribution
+            /// @note A table lookup for small means, the regularized incomplete gamma function Q(x + 1, lambda)
+            /// otherwise
             real_t cdf(int_t x) const override;
+            /// @brief Natural logarithm of the probability mass function of the Poisson distribution
+            real_t logpmf(int_t k) const override;
+            /// @brief Probability mass function of the Poisson distribution at the n locations k, written to out
+            void pmf(const int_t* k, real_t* out, size_t n) const override;
+            /// @brief Logarithm of the probability mass function at the n locations k, written to out
+            void logpmf(const int_t* k, real_t* out, size_t n) const override;
+            /// @brief Cumulative distribution function at the n locations k, written to out
+            void cdf(const int_t* k, real_t* out, size_t n) const override;
+            /// @brief Quantile function of the Poisson distribution, the smallest k with cdf(k) >= p
+            /// @note A binary search of the table for small means, the search of Discrete::quantile on the
+            /// incomplete gamma function otherwise
+            int_t quantile(real_t p) const override;
+            using Discrete::quantile;
     };
-    
+}
+
+#endif
+
+// src/Distributions/Discrete/Geometric/Geometric.h
+
+#ifndef DF_GEOMETRIC_H
+#define DF_GEOMETRIC_H
+
+#include <algorithm>
+
+namespace DiceForge {
     /// @brief DiceForge::Geometric - A Discrete Probability Distribution (Geometric) 
+    /// @note The number of failed trials before the first "success"
     class Geometric : public Discrete {
         private:
-            float p;
+            real_t p;
+            // 1 / log(1 - p), for inversion
+            real_t inv_log_q;
+            // floor(log(1 - u[i]) / log(1 - p[i])) for the uniforms u of sample_each, on lanes of simd::vreal
+            static void invert_each(const real_t* u, const real_t* p, int_t* out, size_t n);
         public:
             /// @brief Constructor for the Geometric distribution
             /// @param p probability of "success"
@@ -583,25 +2912,93 @@ namespace DiceForge {
             /// @brief Returns the next value of the random variable described by the distribution
             /// @param r A random real number uniformly distributed between 0 and 1
             int_t next(real_t r);            
+            /// @brief Returns the next value of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            template <typename Derived, typename T>
+            int_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+            {
+                DF_INSTRUMENT_SAMPLES("Geometric", 1);
+                return int_t(std::floor(std::log1p(-rng.next_unit()) * inv_log_q));
+            }
+            /// @brief Fills the buffer with values of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param out Pointer to the first element of the buffer
+            /// @param count Number of values to be written
+            /// @note Inversion of blocks of uniforms from fill_unit
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, int_t* out, size_t count)
+            {
+                DF_INSTRUMENT_SAMPLES("Geometric", count);
+                real_t u[256];
+                while (count > 0)
+                {
+                    size_t m = std::min(count, size_t(256));
+                    rng.fill_unit(u, m);
+                    for (size_t i = 0; i < m; i++)
+                        out[i] = int_t(std::floor(std::log1p(-u[i]) * inv_log_q));
+                    out += m;
+                    count -= m;
+                }
+            }
+            /// @brief Fills the buffer with one value of each of n Geometric distributions, without constructing them
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param p Pointer to the n probabilities of "success" (in [0, 1])
+            /// @param out Pointer to the first element of the buffer
+            /// @param count Number of values to be written
+            /// @note Inversion of blocks of uniforms from fill_unit, as in sample, lanes at a time
+            template <typename Derived, typename T>
+            static void sample_each(DiceForge::StaticGenerator<Derived, T>& rng, const real_t* p, int_t* out,
+                                    size_t count)
+            {
+                DF_INSTRUMENT_SAMPLES("Geometric", count);
+                bool valid = true;
+                for (size_t i = 0; i < count; i++)
+                    valid &= (p[i] >= 0) & (p[i] <= 1);
+                if (!valid)
+                    throw std::invalid_argument("Invalid 'success' probability value for Geometric distribution!");
+                real_t u[256];
+                while (count > 0)
+                {
+                    size_t m = std::min(count, size_t(256));
+                    rng.fill_unit(u, m);
+                    invert_each(u, p, out, m);
+                    p += m;
+                    out += m;
+                    count -= m;
+                }
+            }
             /// @brief Returns the theoretical variance of the distribution
             /// @returns (1-p)/(p^2)
             real_t variance() const override;
             /// @brief Returns the theoretical expectation value of the distribution
-            /// @return 1/p
+            /// @return (1-p)/p
             real_t expectation() const override;
             /// @brief Returns the minimum possible value of the random variable described by the distribution
             /// @return 0
             int_t minValue() const override;
             /// @brief Returns the maximum possible value of the random variable described by the distribution
-            /// @return positive infinity
+            /// @return the largest int_t (the distribution is unbounded)
             int_t maxValue() const override;
             /// @brief Probability mass function of the Geometric distribution
             real_t pmf(int_t k) const override;        
             /// @brief Cumulative distribution function of the Geometric distribution 
             real_t cdf(int_t k) const override;
+            /// @brief Natural logarithm of the probability mass function of the Geometric distribution
+            real_t logpmf(int_t k) const override;
+            /// @brief Probability mass function of the Geometric distribution at the n locations k, written to out
+            void pmf(const int_t* k, real_t* out, size_t n) const override;
+            /// @brief Logarithm of the probability mass function at the n locations k, written to out
+            void logpmf(const int_t* k, real_t* out, size_t n) const override;
+            /// @brief Cumulative distribution function at the n locations k, written to out
+            void cdf(const int_t* k, real_t* out, size_t n) const override;
+            /// @brief Quantile function of the Geometric distribution, the smallest k with 1 - (1-p)^(k+1) >= u
+            /// @note In closed form, as in next(r), corrected by a step where the logarithms round the other way
+            int_t quantile(real_t u) const override;
+            using Discrete::quantile;
     };
 }
 
 
+#endif
 
-#endif
\ No newline at end of file
+#endif
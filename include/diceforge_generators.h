@@ -1,14 +1,26 @@
+// Generated from src/ by tools/amalgamate.cmake (cmake --build <build> --target headers): edit the
+// sources rather than this file
+
 #ifndef DF_GENERATORS_H
 #define DF_GENERATORS_H
 
 #include "diceforge_core.h"
 
+// src/Generators/BBS/blumblumshub.h
+
+#ifndef DF_BLUMBLUMSHUB_H
+#define DF_BLUMBLUMSHUB_H
+
+
 namespace DiceForge
 {
-    /// @brief DiceForge::BlumBlumShub32 - A RNG utilizing the Blum-Blum-Shub algorithm
-    /// for generating 32-bit unsigned random integers
+    /**
+     * @brief DiceForge::BlumBlumShub32 - A RNG utilizing the Blum-Blum-Shub algorithm
+     * for generating 32-bit unsigned random integers
+     */
     class BlumBlumShub32 : public Generator<uint32_t>
     {
+        friend class StaticView<BlumBlumShub32>;
         private:
             static const uint64_t p;
             static const uint64_t q;
@@ -21,29 +33,62 @@ namespace DiceForge
              */
             inline void propagate();
 
-            /// @brief generate - Generates a random number using the Blum-Blum-Shub algorithm
-            /// @return The generated random number
+            /**
+             * @brief generate - Generates a random number using the Blum-Blum-Shub algorithm
+             * @return The generated random number
+             */
             uint32_t generate() override;
 
-            /// @brief reseed - Reseeds the generator with a new seed
-            /// @param seed The new seed value
-            /// @note if the seed is zero then a non-zero seed is adopted by default
+            /**
+             * @brief generate_block - Fills the buffer with random numbers using the Blum-Blum-Shub algorithm
+             * @param out Pointer to the first element of the buffer
+             * @param n Number of random numbers to be generated
+             */
+            void generate_block(uint32_t* out, size_t n) override;
+
+            /**
+             * @brief reseed - Reseeds the generator with a new seed
+             * @param seed The new seed value
+             * @note the state is expanded from the seed by DiceForge::SeedSequence, for any seed (zero included)
+             */
             void reseed(uint32_t seed) override;
 
+            /**
+             * @brief reseed_from - Reseeds the generator from seed material of any length
+             */
+            void reseed_from(const SeedSequence& seq) override;
+
+            /**
+             * @brief write_state - Saves the internal state
+             */
+            void write_state(detail::StateWriter& out) const override;
+
+            /**
+             * @brief read_state - Restores the internal state saved by write_state
+             */
+            void read_state(detail::StateReader& in) override;
+
         public:
-            /// @brief Constructor for BlumBlumShub32
-            /// @param seed The initial seed value
-            /// @note if the seed is zero then a non-zero seed is adopted by default
+            /**
+             * @brief Constructor for BlumBlumShub32
+             * @param seed The initial seed value
+             * @note the state is expanded from the seed by DiceForge::SeedSequence, for any seed (zero included)
+             */
             BlumBlumShub32(uint32_t seed);
 
-            /// @brief Destructor for BlumBlumShub32
+            /**
+             * @brief Destructor for BlumBlumShub32
+             */
             ~BlumBlumShub32() = default;
     };
 
-    /// @brief DiceForge::BlumBlumShub64 - A RNG utilizing the Blum-Blum-Shub algorithm
-    /// for generating 64-bit unsigned random integers
+    /**
+     * @brief DiceForge::BlumBlumShub64 - A RNG utilizing the Blum-Blum-Shub algorithm
+     * for generating 64-bit unsigned random integers
+     */
     class BlumBlumShub64 : public Generator<uint64_t>
     {
+        friend class StaticView<BlumBlumShub64>;
         private:
             static const uint64_t p;
             static const uint64_t q;
@@ -56,39 +101,193 @@ namespace DiceForge
              */
             inline void propagate();
 
-            /// @brief generate - Generates a random number using the Blum-Blum-Shub algorithm
-            /// @return The generated random number
+            /**
+             * @brief generate - Generates a random number using the Blum-Blum-Shub algorithm
+             * @return The generated random number
+             */
             uint64_t generate() override;
 
-            /// @brief reseed - Reseeds the generator with a new seed
-            /// @param seed The new seed value
-            /// @note if the seed is zero then a non-zero seed is adopted by default
+            /**
+             * @brief generate_block - Fills the buffer with random numbers using the Blum-Blum-Shub algorithm
+             * @param out Pointer to the first element of the buffer
+             * @param n Number of random numbers to be generated
+             */
+            void generate_block(uint64_t* out, size_t n) override;
+
+            /**
+             * @brief reseed - Reseeds the generator with a new seed
+             * @param seed The new seed value
+             * @note the state is expanded from the seed by DiceForge::SeedSequence, for any seed (zero included)
+             */
             void reseed(uint64_t seed) override;
 
+            /**
+             * @brief reseed_from - Reseeds the generator from seed material of any length
+             */
+            void reseed_from(const SeedSequence& seq) override;
+
+            /**
+             * @brief write_state - Saves the internal state
+             */
+            void write_state(detail::StateWriter& out) const override;
+
+            /**
+             * @brief read_state - Restores the internal state saved by write_state
+             */
+            void read_state(detail::StateReader& in) override;
+
         public:
-            /// @brief Constructor for BlumBlumShub64
-            /// @param seed The initial seed value
-            /// @note if the seed is zero then a non-zero seed is adopted by default
+            /**
+             * @brief Constructor for BlumBlumShub64
+             * @param seed The initial seed value
+             * @note the state is expanded from the seed by DiceForge::SeedSequence, for any seed (zero included)
+             */
             BlumBlumShub64(uint64_t seed);
 
-            /// @brief Destructor for BlumBlumShub64            
+            /**
+             * @brief Destructor for BlumBlumShub64
+             */
             ~BlumBlumShub64() = default;
     };
 
+    /**
+     * @brief DiceForge::BlumBlumShubMontgomery - A RNG utilizing the Blum-Blum-Shub algorithm,
+     * with the squarings done in Montgomery form using native 128-bit products
+     * @tparam UIntType uint32_t or uint64_t, the type of the generated integers
+     * @note Unlike BlumBlumShub32/64 the state is squared exactly modulo n = p*q, and up to
+     * bits_per_step low bits of every state are used (log2 log2 n = 6 by default)
+     */
+    template <typename UIntType>
+    class BlumBlumShubMontgomery : public Generator<UIntType>
+    {
+        friend class StaticView<BlumBlumShubMontgomery>;
+        private:
+            static const uint64_t p;
+            static const uint64_t q;
+            static const uint64_t n;
+            static const uint64_t n_inv;    // -1/n modulo 2^64
+            static const uint64_t r2;       // 2^128 modulo n
+            static const uint64_t lambda;   // lcm(p-1, q-1), the exponent of the group of units modulo n
+
+            uint64_t state;     // Internal state (in Montgomery form, state = x * 2^64 mod n)
+            int bits_per_step;  // Number of bits extracted from every state
+
+            /**
+             * @brief redc - Montgomery reduction
+             * @return t / 2^64 modulo n
+             */
+            static uint64_t redc(uint128_t t);
+
+            /**
+             * @brief propagate - Advances the internal state using the Blum-Blum-Shub algorithm
+             * @return The low bits_per_step bits of the new state
+             */
+            uint64_t propagate();
+
+            /**
+             * @brief generate - Generates a random number using the Blum-Blum-Shub algorithm
+             * @return The generated random number
+             */
+            UIntType generate() override;
+
+            /**
+             * @brief generate_block - Fills the buffer with random numbers using the Blum-Blum-Shub algorithm
+             * @param out Pointer to the first element of the buffer
+             * @param n Number of random numbers to be generated
+             */
+            void generate_block(UIntType* out, size_t n) override;
+
+            /**
+             * @brief jump_ahead - Skips the given number of outputs
+             * @note The state after s squarings is x^(2^s) mod n, and 2^s is reduced modulo lcm(p-1, q-1)
+             */
+            void jump_ahead(uint64_t steps) override;
+            bool fast_jump() const override { return true; }
+
+            /**
+             * @brief reseed - Reseeds the generator with a new seed
+             * @param seed The new seed value
+             * @note the state is expanded from the seed by DiceForge::SeedSequence, for any seed (zero included)
+             */
+            void reseed(UIntType seed) override;
+
+            /**
+             * @brief reseed_from - Reseeds the generator from seed material of any length
+             */
+            void reseed_from(const SeedSequence& seq) override;
+
+            /**
+             * @brief write_state - Saves the internal state
+             */
+            void write_state(detail::StateWriter& out) const override;
+
+            /**
+             * @brief read_state - Restores the internal state saved by write_state
+             */
+            void read_state(detail::StateReader& in) override;
+
+        public:
+            /**
+             * @brief Constructor for BlumBlumShubMontgomery
+             * @param seed The initial seed value
+             * @param bits_per_step Number of bits taken from every squaring, between 1 and 32. At most
+             * log2 log2 n = 6 bits keeps the security argument of the algorithm; more bits trade it for speed
+             * @note the state is expanded from the seed by DiceForge::SeedSequence, for any seed (zero included)
+             */
+            BlumBlumShubMontgomery(UIntType seed, int bits_per_step = 6);
+
+            /**
+             * @brief Destructor for BlumBlumShubMontgomery
+             */
+            ~BlumBlumShubMontgomery() = default;
+    };
+
+    // The members are compiled once in blumblumshub.cpp for these two engines
+    extern template class BlumBlumShubMontgomery<uint32_t>;
+    extern template class BlumBlumShubMontgomery<uint64_t>;
+
+    typedef BlumBlumShubMontgomery<uint32_t> BlumBlumShubMontgomery32;
+    typedef BlumBlumShubMontgomery<uint64_t> BlumBlumShubMontgomery64;
+
+    // Typedef for convenience
+
+    typedef BlumBlumShub64 BlumBlumShub;
+}
+
+#endif
+
+// src/Generators/LFSR/LFSR.h
+
+#ifndef DF_LFSR_H
+#define DF_LFSR_H
+
+
+namespace DiceForge {
     /// @brief DiceForge::LFSR64 - Linear Feedback Shift Register class (derived from Generator)
     /// for generating 64-bit unsigned integers
     class LFSR64 : public DiceForge::Generator<uint64_t> {
+        friend class StaticView<LFSR64>;
     private:
         // Two curr_seeds, together forming a 128-bit seed
         uint64_t curr_seed1 = 0, curr_seed2 = 0;
         // Function to generate a random 64-bit positive integer
         uint64_t generate() override;
+        // Function to fill a buffer with random 64-bit positive integers
+        void generate_block(uint64_t* out, size_t n) override;
+        // Function to skip ahead by a number of outputs, with a polynomial jump of the register
+        void jump_ahead(uint64_t steps) override;
+        bool fast_jump() const override { return true; }
         // Function to reseed the RNG
         void reseed(uint64_t seed) override;
+        // Function to fill the register from seed material
+        void reseed_from(const SeedSequence& seq) override;
+        // Functions to save and restore the register
+        void write_state(detail::StateWriter& out) const override;
+        void read_state(detail::StateReader& in) override;
     public:
         /// @brief Initializes the LFSR with the specified seed
         /// @param seed seed to initialize the RNG with
-        /// @note if the seed provided is zero, then the current system time is taken as seed
+        /// @note Every seed, zero included, gives its own (non-zero) register, expanded from it by DiceForge::SeedSequence
         LFSR64(uint64_t seed);
         /// @brief Default destructor
         ~LFSR64() = default;
@@ -97,159 +296,843 @@ namespace DiceForge
     /// @brief DiceForge::LFSR32 - Linear Feedback Shift Register class (derived from Generator)
     /// for generating 32-bit unsigned integers
     class LFSR32 : public DiceForge::Generator<uint32_t> {
+        friend class StaticView<LFSR32>;
     private:
         // Two curr_seeds, together forming a 128-bit seed
         uint64_t curr_seed1 = 0, curr_seed2 = 0;
         // Function to generate a random 32-bit positive integer
         uint32_t generate() override;
-        /// @brief Function to reseed the RNG
-        /// @note if the seed provided is zero, then the current system time is taken as seed
+        // Function to fill a buffer with random 32-bit positive integers
+        void generate_block(uint32_t* out, size_t n) override;
+        // Function to skip ahead by a number of outputs, with a polynomial jump of the register
+        void jump_ahead(uint64_t steps) override;
+        bool fast_jump() const override { return true; }
+        // Function to reseed the RNG
         void reseed(uint32_t seed) override;
+        // Function to fill the register from seed material
+        void reseed_from(const SeedSequence& seq) override;
+        // Functions to save and restore the register
+        void write_state(detail::StateWriter& out) const override;
+        void read_state(detail::StateReader& in) override;
     public:    
         /// @brief Initializes the LFSR with the specified seed
         /// @param seed seed to initialize the RNG with
-        /// @note if the seed provided is zero, then the current system time is taken as seed
+        /// @note Every seed, zero included, gives its own (non-zero) register, expanded from it by DiceForge::SeedSequence
         LFSR32(uint32_t seed);
         /// @brief Default destructor
         ~LFSR32() = default;
     };
 
-    /// @brief DiceForge::MT32 - A Mersenne Twister RNG for generating 32-bit unsigned integers
-    class MT32 : public Generator<uint32_t>
-    {
-    private:
-        // Main Parameters:
-        int N;                          // length of state value vector
-        int M;                          // optimum value as mid
-        uint32_t A;                     // vector in the matrix A
-        uint32_t upperbits, lowerbits;  // for obtaining first w-r bits of the number
-        // Tempering Parameters:
-        uint32_t tempering_mask_B;
-        uint32_t tempering_mask_C;
-        uint32_t tempering_shift_U;
-        uint32_t tempering_shift_S;
-        uint32_t tempering_shift_T;
-        uint32_t tempering_shift_L;
-        // Other Parameters:
-        std::vector<uint32_t> mt;       // State Vector
-        int mti;                // Used as index for the array MT.
-        uint32_t seed;                  // Seed given from main
-        // Functions to generate first N pseudo-random numbers as a seed for the algorithm.
-        void sgenrand(uint32_t);
-        void trytransform();
-        uint32_t temper(uint32_t);
-        uint32_t generate() override;
-        void reseed(uint32_t seed) override;
-    public:
-        /// @brief Initializes the Mersenne Twister RNG with the specified seed
-        /// @param seed seed to initialize the RNG with
-        /// @note if the seed provided is zero, then the current system time is taken as seed
-        MT32(uint32_t seed);
-        ~MT32() = default;
-    };
-    
-    /// @brief DiceForge::MT64 - A Mersenne Twister RNG for generating 64-bit unsigned integers
-    class MT64 : public Generator<uint64_t>
+    // Typedef for convenience
+
+    typedef LFSR64 LFSR;
+}
+
+
+#endif
+
+// src/Generators/MT/MT.h
+
+/***MERSENNE TWISTER PRNG***/
+/*generates 32 or 64 bit integers*/
+/*Parameters involved
+(w,n,m,r)=(32,624,397,31) for MT32
+(w,n,m,r)=(64,312,156,31) for MT64
+*/
+
+#ifndef DF_MT_H
+#define DF_MT_H
+
+#include <array>
+
+namespace DiceForge{
+
+    /// @brief DiceForge::MersenneTwisterEngine - A Mersenne Twister RNG with all of its parameters fixed at compile time
+    /// @tparam UIntType word type of the state and of the generated numbers (uint32_t or uint64_t)
+    /// @tparam N length of the state vector
+    /// @tparam M middle word offset used by the recurrence
+    /// @tparam A vector in the matrix A
+    /// @tparam UpperBits mask for obtaining the first w-r bits of a word
+    /// @tparam LowerBits mask for obtaining the last r bits of a word
+    /// @tparam U, S, B, T, C, L tempering shifts (U, S, T, L) and masks (B, C)
+    /// @note Since every parameter is a constant, the shifts and masks in the tempering and in the
+    /// recurrence are folded into the instructions, and the state lives inside the object itself.
+    template <typename UIntType, int N, int M, UIntType A, UIntType UpperBits, UIntType LowerBits,
+              int U, int S, UIntType B, int T, UIntType C, int L>
+    class MersenneTwisterEngine : public Generator<UIntType>
     {
+        friend class StaticView<MersenneTwisterEngine>;
     private:
-        // Main Parameters:
-        int N;                          // length of state value vector
-        int M;                          // optimum value as mid
-        uint64_t A;                     // vector in the matrix A
-        uint64_t upperbits, lowerbits;  // for obtaining first w-r bits of the number
-        // Tempering Parameters:
-        uint64_t tempering_mask_B;
-        uint64_t tempering_mask_C;
-        uint64_t tempering_shift_U;
-        uint64_t tempering_shift_S;
-        uint64_t tempering_shift_T;
-        uint64_t tempering_shift_L;
-        // Other Parameters:
-        std::vector<uint64_t> mt;       // State Vector
-        int mti;                // Used as index for the array MT.
-        uint64_t seed;                  // Seed given from main
-        // Functions to generate first N pseudo-random numbers as a seed for the algorithm.
-        void sgenrand(uint64_t);
+        std::array<UIntType, N> mt;     // State Vector
+        int mti;                        // Used as index for the array MT.
         void trytransform();
-        uint64_t temper(uint64_t);
-        uint64_t generate() override;
-        void reseed(uint64_t seed) override;
+        static UIntType temper(UIntType);
+        UIntType generate() override;
+        void generate_block(UIntType* out, size_t n) override;
+        // Jumps with the characteristic polynomial of the recurrence (when it is linear, i.e. the masks do not overlap)
+        void jump_ahead(uint64_t steps) override;
+        bool fast_jump() const override { return (UpperBits & LowerBits) == 0; }
+        void reseed(UIntType seed) override;
+        // Fills the whole state vector from the seed material
+        void reseed_from(const SeedSequence& seq) override;
+        // Saves the state vector and the index into it
+        void write_state(detail::StateWriter& out) const override;
+        void read_state(detail::StateReader& in) override;
     public:
         /// @brief Initializes the Mersenne Twister RNG with the specified seed
         /// @param seed seed to initialize the RNG with
-        /// @note if the seed provided is zero, then the current system time is taken as seed
-        MT64(uint64_t seed);
-        ~MT64() = default;
+        /// @note Every seed, zero included, gives its own state, expanded from it by DiceForge::SeedSequence
+        MersenneTwisterEngine(UIntType seed);
+        ~MersenneTwisterEngine() = default;
     };
-            
-    /// @brief DiceForge::NaorReingold - An implementation of the Naor-Reingold PRF 
-    /// for generating 32-bit unsigned integers
-    class NaorReingold : public Generator<uint32_t> 
+
+    // Main program to get random number.
+    // Defined here so that it can be inlined through StaticView<MersenneTwisterEngine<...>>
+    template <typename UIntType, int N, int M, UIntType A, UIntType UpperBits, UIntType LowerBits,
+              int U, int S, UIntType B, int T, UIntType C, int L>
+    inline UIntType MersenneTwisterEngine<UIntType, N, M, A, UpperBits, LowerBits, U, S, B, T, C, L>::generate()
     {
+        if (mti >= N)
+            trytransform();
+        UIntType y = temper(mt[mti]);
+        mti++;
+        return y;
+    }
+
+    // Tempers generated value before returning.
+    template <typename UIntType, int N, int M, UIntType A, UIntType UpperBits, UIntType LowerBits,
+              int U, int S, UIntType B, int T, UIntType C, int L>
+    inline UIntType MersenneTwisterEngine<UIntType, N, M, A, UpperBits, LowerBits, U, S, B, T, C, L>::temper(UIntType y){
+        //performing tempering
+        y ^= (y >> U);
+        y ^= (y << S) & B;
+        y ^= (y << T) & C;
+        y ^= (y >> L);
+        return y;
+    }
+
+    /// @brief DiceForge::MT32 - A Mersenne Twister RNG for generating 32-bit unsigned integers
+    /// @note A and the lower mask (all ones rather than 0x7FFFFFFF) are kept as in earlier releases
+    /// (they also make its twist non-linear, so jump() discards the outputs one by one)
+    typedef MersenneTwisterEngine<uint32_t, 624, 397, 0x9967EA1FU, 0x80000000U, 0xFFFFFFFFU,
+                                  11, 7, 0x9D2C5680U, 15, 0xEFC60000U, 18> MT32;
+
+    /// @brief DiceForge::MT64 - A Mersenne Twister RNG for generating 64-bit unsigned integers
+    typedef MersenneTwisterEngine<uint64_t, 312, 156, 0xB5026F5AA96619E9ULL, 0xFFFFFFFF80000000ULL, 0x7FFFFFFFULL,
+                                  29, 17, 0xD66B5EF5B4DA0000ULL, 37, 0xFDED6BE000000000ULL, 41> MT64;
+
+    // The out-of-line members are compiled once in MT.cpp for these two engines
+    extern template class MersenneTwisterEngine<uint32_t, 624, 397, 0x9967EA1FU, 0x80000000U, 0xFFFFFFFFU,
+                                                11, 7, 0x9D2C5680U, 15, 0xEFC60000U, 18>;
+    extern template class MersenneTwisterEngine<uint64_t, 312, 156, 0xB5026F5AA96619E9ULL, 0xFFFFFFFF80000000ULL, 0x7FFFFFFFULL,
+                                                29, 17, 0xD66B5EF5B4DA0000ULL, 37, 0xFDED6BE000000000ULL, 41>;
+    
+    // Typedef for convenience
+    
+    typedef MT64 MT;
+}
+
+#endif
+
+// src/Generators/Naor-Reingold/naor_reingold.h
+
+#ifndef DF_NAOR_REINGOLD_H
+#define DF_NAOR_REINGOLD_H
+
+namespace DiceForge {
+  
+  /// @brief DiceForge::NaorReingold - An implementation of the Naor-Reingold PRF 
+  /// for generating 32-bit unsigned integers
+  class NaorReingold : public Generator<uint32_t> {
+      friend class StaticView<NaorReingold>;
     private:
-        uint64_t m_state;   // Internal state
-        uint32_t generate() override;
-        void reseed(uint32_t seed) override;        
+      uint64_t m_state;   // Internal state
+      uint64_t m_product; // Output for the current state
+      uint32_t generate() override;
+      void generate_block(uint32_t* out, size_t n) override;
+      void jump_ahead(uint64_t steps) override;
+      bool fast_jump() const override { return true; }
+      void reseed(uint32_t seed) override;
+      void reseed_from(const SeedSequence& seq) override;
+      void write_state(detail::StateWriter& out) const override;
+      void read_state(detail::StateReader& in) override;
+      
     public:
-        /// @brief Initializes the PRF with the given seed
-        /// @param seed seed to initialize the PRF with
-        /// @note If the seed given is zero, then it is taken to be the current system time
-        /// @note The key for the PRF is predetermined and fixed. The seed is not the key.
-        NaorReingold(uint32_t seed);
-        /// @brief Default destructor
-        ~NaorReingold() = default;
-    };
+      /// @brief Initializes the PRF with the given seed
+      /// @param seed seed to initialize the PRF with
+      /// @note The starting state is expanded from the seed by DiceForge::SeedSequence, for any seed (zero included)
+      /// @note The key for the PRF is predetermined and fixed. The seed is not the key.
+      NaorReingold(uint32_t seed);
+      /// @brief Default destructor
+      ~NaorReingold() = default;
+};
+
+  typedef NaorReingold NaorReingold32;
+} // namespace DiceForge
+
+#endif
+
+// src/Generators/XORShift/XORShift.h
 
+#ifndef DF_XORSHIFT_H
+#define DF_XORSHIFT_H
+
+
+namespace DiceForge
+{   
     /// @brief DiceForge::XORShift32 - A PRNG following the XORShift* algorithm
     /// A naive implementation of the original XORShift algorithm proposed by Marsaglia
     /// followed by a multiplicative transform
     /// @note Generates 32-bit unsigned integers
     class XORShift32 : public Generator<uint32_t>
     {
+        friend class StaticView<XORShift32>;
     private:
         uint32_t m_state;   // Internal state
         uint32_t generate() override;
+        void generate_block(uint32_t* out, size_t n) override;
+        // Jumps with precomputed powers of the (linear) transition matrix of the state
+        void jump_ahead(uint64_t steps) override;
+        bool fast_jump() const override { return true; }
         void reseed(uint32_t seed) override;
+        void reseed_from(const SeedSequence& seq) override;
+        void write_state(detail::StateWriter& out) const override;
+        void read_state(detail::StateReader& in) override;
     public:
         /// @brief Initializes the XOR Shift RNG with the specified seed
-        /// @param seed must be a non-zero number
-        /// @note If the given seed is zero, then the current system is used as the seed
+        /// @param seed seed to initialize the RNG with
+        /// @note Every seed, zero included, gives its own (non-zero) state, expanded from it by DiceForge::SeedSequence
         XORShift32(uint32_t seed);
         /// @brief Default destructor
         ~XORShift32() = default;
     };
 
+    // Defined here so that it can be inlined through StaticView<XORShift32>
+    inline uint32_t XORShift32::generate()
+    {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 17;
+        m_state ^= m_state << 5;
+        return m_state * 0x2545F4914F6CDD1DULL;
+    }
+
     /// @brief DiceForge::XORShift64 - A PRNG following the XORShift* algorithm
     /// A naive implementation of the original XORShift algorithm proposed by Marsaglia
     /// followed by a multiplicative transform
     /// @note Generates 64-bit unsigned integers
     class XORShift64 : public Generator<uint64_t>
     {
+        friend class StaticView<XORShift64>;
     private:
         uint64_t m_state;   // Internal state
         uint64_t generate() override;
+        void generate_block(uint64_t* out, size_t n) override;
+        // Jumps with precomputed powers of the (linear) transition matrix of the state
+        void jump_ahead(uint64_t steps) override;
+        bool fast_jump() const override { return true; }
         void reseed(uint64_t seed) override;
+        void reseed_from(const SeedSequence& seq) override;
+        void write_state(detail::StateWriter& out) const override;
+        void read_state(detail::StateReader& in) override;
     public:
         /// @brief Initializes the XOR Shift RNG with the specified seed
-        /// @param seed must be a non-zero number
-        /// @note If the given seed is zero, then the current system is used as the seed
+        /// @param seed seed to initialize the RNG with
+        /// @note Every seed, zero included, gives its own (non-zero) state, expanded from it by DiceForge::SeedSequence
         XORShift64(uint64_t seed);
         /// @brief Default destructor
         ~XORShift64() = default;
     };
 
-    // Typedefs for convenience
+    // Defined here so that it can be inlined through StaticView<XORShift64>
+    inline uint64_t XORShift64::generate()
+    {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 7;
+        m_state ^= m_state << 17;
+        return m_state * 0x2545F4914F6CDD1DULL;
+    }
+
+    /// @brief DiceForge::XORShiftMultiLane - Runs several independently seeded XORShift* generators
+    /// side by side in SIMD registers and hands out their outputs interleaved
+    /// @tparam UIntType uint32_t (same lanes as XORShift32) or uint64_t (same lanes as XORShift64)
+    /// @tparam Lanes number of lanes; every step of the generator advances all of them at once
+    /// @note Meant to be used through fill() / fill_unit(), which step all lanes for whole runs of the block
+    /// while the states stay in registers. Single calls to next() are served from the last step's outputs.
+    template <typename UIntType, int Lanes>
+    class XORShiftMultiLane : public Generator<UIntType>
+    {
+        friend class StaticView<XORShiftMultiLane>;
+    private:
+        UIntType m_state[Lanes];    // Internal state of each lane
+        UIntType m_buffer[Lanes];   // Outputs of the last step
+        int m_index;                // Index of the next unused output in m_buffer
+        // Steps all lanes the given number of times, writing Lanes outputs per step to out
+        void advance(UIntType* out, size_t steps);
+        UIntType generate() override;
+        void generate_block(UIntType* out, size_t n) override;
+        // Jumps every lane with precomputed powers of the transition matrix of XORShift32 / XORShift64
+        void jump_ahead(uint64_t steps) override;
+        bool fast_jump() const override { return true; }
+        void reseed(UIntType seed) override;
+        void reseed_from(const SeedSequence& seq) override;
+        void write_state(detail::StateWriter& out) const override;
+        void read_state(detail::StateReader& in) override;
+    public:
+        /// @brief Initializes the lanes with seeds derived from the specified seed
+        /// @param seed seed to initialize the RNG with
+        /// @note The lanes take the successive non-zero words of DiceForge::SeedSequence(seed), for any seed
+        XORShiftMultiLane(UIntType seed);
+        /// @brief Default destructor
+        ~XORShiftMultiLane() = default;
+    };
+
+    // Defined here so that it can be inlined through StaticView<XORShiftMultiLane<...>>
+    template <typename UIntType, int Lanes>
+    inline UIntType XORShiftMultiLane<UIntType, Lanes>::generate()
+    {
+        if (m_index >= Lanes)
+        {
+            advance(m_buffer, 1);
+            m_index = 0;
+        }
+        return m_buffer[m_index++];
+    }
+
+    /// @brief DiceForge::XORShift64x4 - Four interleaved XORShift64* lanes
+    typedef XORShiftMultiLane<uint64_t, 4> XORShift64x4;
+    /// @brief DiceForge::XORShift32x8 - Eight interleaved XORShift32* lanes
+    typedef XORShiftMultiLane<uint32_t, 8> XORShift32x8;
+
+    // The out-of-line members are compiled once in XORShift.cpp for these two engines
+    extern template class XORShiftMultiLane<uint64_t, 4>;
+    extern template class XORShiftMultiLane<uint32_t, 8>;
 
-    typedef BlumBlumShub64 BlumBlumShub;
-    typedef LFSR64 LFSR;
-    typedef MT64 MT;
-    typedef NaorReingold NaorReingold32;
     typedef XORShift64 XORShift;
+    typedef XORShift64x4 XORShiftx4;
+    typedef XORShift32x8 XORShiftx8;
+}
 
-    /// @brief The default random number generator of DiceForge; can be used as it is
-    static XORShift64 Random(0);
+#endif
 
-} // namespace DiceForge
+// src/Generators/Halton/Halton.h
+
+#ifndef DF_HALTON_H
+#define DF_HALTON_H
+
+#include <vector>
+
+namespace DiceForge
+{
+    /// @brief DiceForge::Halton - The Halton low-discrepancy sequence, optionally scrambled
+    /// @note Coordinate j of point n is the radical inverse of n in the j-th prime base: its base b digits
+    /// mirrored about the radix point. The coordinates are handed out like those of Sobol (point 0 in all
+    /// dimensions, then point 1, ...), as 64 bit fractions, so fill_unit(x, dimensions()) or next_point(x) draws
+    /// one point of the unit cube.
+    /// @note Every point is updated from the previous one by incrementing the digits of the index, and jump() /
+    /// seek() compute any point directly, so that threads can take disjoint ranges of points.
+    /// @note The plain sequence shows strong correlations between high dimensions with large bases; scrambling
+    /// replaces digit d at position k of dimension j by (f_jk * d + g_jk) mod b for random f_jk != 0 and g_jk,
+    /// which breaks them up while keeping the low discrepancy.
+    class Halton : public Generator<uint64_t>
+    {
+        friend class StaticView<Halton>;
+    private:
+        // Digits of the index per dimension, enough for any 64 bit index in base 2
+        static constexpr int max_digits = 64;
+        unsigned m_dimensions;
+        std::vector<uint64_t> m_bases;       // Prime base of each dimension
+        std::vector<uint64_t> m_scale;       // floor(2^64 / b^(k+1)), max_digits per dimension
+        std::vector<uint64_t> m_multiplier;  // Scrambling of each digit position, f_jk (1 when not scrambled)
+        std::vector<uint64_t> m_addend;      // and g_jk (0 when not scrambled)
+        std::vector<uint64_t> m_digits;      // Digits of m_index in the base of each dimension, lowest first
+        std::vector<uint64_t> m_point;       // Coordinates of point m_index
+        uint64_t m_index;                    // Index of the current point
+        unsigned m_coordinate;               // Next coordinate of the current point to be handed out
+        uint64_t m_seed;                     // Seed of the scrambling
+        // Moves on to the next point by incrementing the digits of the index
+        void advance();
+        uint64_t generate() override;
+        void generate_block(uint64_t* out, size_t n) override;
+        // Computes the point reached directly from the digits of its index
+        void jump_ahead(uint64_t steps) override;
+        bool fast_jump() const override { return true; }
+        void reseed(uint64_t seed) override;
+        // Saves the seed and the position, from which load_state rebuilds the scrambling and the point
+        void write_state(detail::StateWriter& out) const override;
+        void read_state(detail::StateReader& in) override;
+    public:
+        /// @brief Initializes the sequence in the given number of dimensions
+        /// @param dimensions number of coordinates of every point (at least 1), dimension j taking the j-th prime
+        /// as its base
+        /// @param seed 0 for the plain Halton sequence, any other seed for a scrambled one (see above)
+        Halton(unsigned dimensions, uint64_t seed = 0);
+        /// @brief Number of coordinates of every point
+        unsigned dimensions() const
+        {
+            return m_dimensions;
+        }
+        /// @brief Writes the next point of the unit cube to x (dimensions() reals)
+        void next_point(real_t* x)
+        {
+            fill_unit(x, m_dimensions);
+        }
+        /// @brief Returns the index of the next element of the stream
+        uint64_t position() const
+        {
+            return m_index * m_dimensions + m_coordinate;
+        }
+        /// @brief Moves to element i of the stream, e.g. seek(k * dimensions()) to start from point k
+        /// @param i index of the element
+        void seek(uint64_t i);
+        /// @brief Default destructor
+        ~Halton() = default;
+    };
+
+    // Defined here so that it can be inlined through StaticView<Halton>
+    inline uint64_t Halton::generate()
+    {
+        if (m_coordinate == m_dimensions)
+            advance();
+        return m_point[m_coordinate++];
+    }
+}
+
+#endif
+
+// src/Generators/Sobol/Sobol.h
+
+#ifndef DF_SOBOL_H
+#define DF_SOBOL_H
+
+#include <vector>
+
+namespace DiceForge
+{
+    /// @brief DiceForge::Sobol - The Sobol low-discrepancy sequence in up to 1024 dimensions, with the direction
+    /// numbers of Joe and Kuo
+    /// @note Hands out the coordinates of the points one after the other (point 0 in all dimensions, then
+    /// point 1, ...), so fill_unit(x, dimensions()) or next_point(x) draws one point of the unit cube, and element
+    /// i of the stream is coordinate i % dimensions() of point i / dimensions(). For quasi-Monte Carlo runs it can
+    /// replace a PRNG anywhere random reals are drawn in groups of dimensions() (e.g. monte_carlo_integrate).
+    /// @note Consecutive points differ by one direction number per coordinate (Gray code order), and jump() /
+    /// seek() compute any point directly, so that threads can take disjoint ranges of points.
+    /// @note The first point is the origin (or the shift, when scrambled).
+    class Sobol : public Generator<uint64_t>
+    {
+        friend class StaticView<Sobol>;
+    public:
+        /// @brief Largest number of dimensions supported
+        static constexpr unsigned max_dimensions = 1024;
+    private:
+        unsigned m_dimensions;
+        std::vector<uint64_t> m_directions; // Direction numbers, 64 per dimension
+        std::vector<uint64_t> m_shift;      // Random digital shift of each coordinate (zero when not scrambled)
+        std::vector<uint64_t> m_point;      // Unshifted coordinates of point m_index
+        uint64_t m_index;                   // Index of the current point
+        unsigned m_coordinate;              // Next coordinate of the current point to be handed out
+        uint64_t m_seed;                    // Seed of the digital shift
+        // Moves on to the next point in Gray code order
+        void advance();
+        uint64_t generate() override;
+        void generate_block(uint64_t* out, size_t n) override;
+        // Computes the point reached directly from the Gray code of its index
+        void jump_ahead(uint64_t steps) override;
+        bool fast_jump() const override { return true; }
+        void reseed(uint64_t seed) override;
+        // Saves the seed and the position, from which load_state rebuilds the shift and the point
+        void write_state(detail::StateWriter& out) const override;
+        void read_state(detail::StateReader& in) override;
+    public:
+        /// @brief Initializes the sequence in the given number of dimensions
+        /// @param dimensions number of coordinates of every point (1 to max_dimensions)
+        /// @param seed 0 for the plain Sobol sequence, any other seed for a random digital shift (XOR of every
+        /// coordinate with a random number), which keeps the low discrepancy and makes independent replicas
+        Sobol(unsigned dimensions, uint64_t seed = 0);
+        /// @brief Number of coordinates of every point
+        unsigned dimensions() const
+        {
+            return m_dimensions;
+        }
+        /// @brief Writes the next point of the unit cube to x (dimensions() reals)
+        void next_point(real_t* x)
+        {
+            fill_unit(x, m_dimensions);
+        }
+        /// @brief Returns the index of the next element of the stream
+        uint64_t position() const
+        {
+            return m_index * m_dimensions + m_coordinate;
+        }
+        /// @brief Moves to element i of the stream, e.g. seek(k * dimensions()) to start from point k
+        /// @param i index of the element
+        void seek(uint64_t i);
+        /// @brief Default destructor
+        ~Sobol() = default;
+    };
+
+    // Defined here so that it can be inlined through StaticView<Sobol>
+    inline void Sobol::advance()
+    {
+        // the lowest zero bit of the index is the one whose Gray code bit flips
+        int c = 0;
+        for (uint64_t i = m_index; i & 1; i >>= 1)
+            c++;
+        const uint64_t* v = m_directions.data() + c;
+        for (unsigned j = 0; j < m_dimensions; j++, v += 64)
+            m_point[j] ^= *v;
+        m_index++;
+        m_coordinate = 0;
+    }
+
+    inline uint64_t Sobol::generate()
+    {
+        if (m_coordinate == m_dimensions)
+            advance();
+        const unsigned j = m_coordinate++;
+        return m_point[j] ^ m_shift[j];
+    }
+}
+
+#endif
+
+// src/Generators/Philox/Philox.h
+
+#ifndef DF_PHILOX_H
+#define DF_PHILOX_H
+
+
+namespace DiceForge
+{
+    /// @brief DiceForge::PhiloxEngine - A counter-based RNG following the Philox4x32-10 algorithm
+    /// (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3")
+    /// @tparam UIntType uint32_t (4 outputs per block) or uint64_t (2 outputs per block)
+    /// @note Block b of a stream is a keyed bijection of the counter (b, stream), so element i of a stream
+    /// depends only on (seed, stream, i). Threads, processes or nodes can each take their own stream
+    /// (or ranges of one stream) with no coordination, and any element can be recomputed directly with at().
+    template <typename UIntType>
+    class PhiloxEngine : public Generator<UIntType>
+    {
+        friend class StaticView<PhiloxEngine>;
+    public:
+        /// @brief Number of outputs produced by each block of the counter
+        static constexpr int per_block = 16 / sizeof(UIntType);
+    private:
+        uint32_t m_key[2];              // Key of the bijection (derived from the seed)
+        uint64_t m_stream;              // Upper half of the counter, selects the stream
+        uint64_t m_position;            // Index of the next element of the stream
+        UIntType m_block[per_block];    // Outputs of the block m_block_index
+        uint64_t m_block_index;
+        bool m_block_valid;
+        // Computes the outputs of the given block
+        void compute_block(uint64_t block, UIntType* out) const;
+        UIntType generate() override;
+        void generate_block(UIntType* out, size_t n) override;
+        // Counter mode: the position is simply offset
+        void jump_ahead(uint64_t steps) override;
+        bool fast_jump() const override { return true; }
+        void reseed(UIntType seed) override;
+        void reseed_from(const SeedSequence& seq) override;
+        // Saves the key, the stream and the position (the block is recomputed when needed)
+        void write_state(detail::StateWriter& out) const override;
+        void read_state(detail::StateReader& in) override;
+    public:
+        /// @brief Initializes the RNG with the specified seed (key) and stream
+        /// @param seed seed to initialize the RNG with
+        /// @param stream index of the stream to generate, streams of the same seed never overlap
+        /// @note The key is the first word of DiceForge::SeedSequence(seed), for any seed (zero included)
+        PhiloxEngine(UIntType seed, uint64_t stream = 0);
+        /// @brief Returns element i of the stream, without changing the state of the RNG
+        /// @param i index of the element
+        UIntType at(uint64_t i) const;
+        /// @brief Returns the index of the next element of the stream
+        uint64_t position() const
+        {
+            return m_position;
+        }
+        /// @brief Moves to element i of the stream, so that the next call to next() returns at(i)
+        /// @param i index of the element
+        void seek(uint64_t i)
+        {
+            m_position = i;
+        }
+        /// @brief Default destructor
+        ~PhiloxEngine() = default;
+    };
+
+    // Defined here so that it can be inlined through StaticView<PhiloxEngine<...>>
+    template <typename UIntType>
+    inline UIntType PhiloxEngine<UIntType>::generate()
+    {
+        uint64_t block = m_position / per_block;
+        if (!m_block_valid || block != m_block_index)
+        {
+            compute_block(block, m_block);
+            m_block_index = block;
+            m_block_valid = true;
+        }
+        return m_block[m_position++ % per_block];
+    }
+
+    /// @brief DiceForge::Philox32 - Philox4x32-10 counter-based RNG for generating 32-bit unsigned integers
+    typedef PhiloxEngine<uint32_t> Philox32;
+    /// @brief DiceForge::Philox64 - Philox4x32-10 counter-based RNG for generating 64-bit unsigned integers
+    typedef PhiloxEngine<uint64_t> Philox64;
+
+    // The out-of-line members are compiled once in Philox.cpp for these two engines
+    extern template class PhiloxEngine<uint32_t>;
+    extern template class PhiloxEngine<uint64_t>;
+
+    typedef Philox64 Philox;
+}
+
+#endif
+
+// src/Generators/Buffered/Buffered.h
+
+#ifndef DF_BUFFERED_H
+#define DF_BUFFERED_H
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+namespace DiceForge {
+    /// @brief DiceForge::BufferedGenerator<Engine> - Draws the random integers of a slow RNG ahead of time, into a
+    /// ring buffer
+    /// @tparam Engine RNG derived from Generator<T> (like BlumBlumShub64 or NaorReingold)
+    /// @note With a background thread, the thread fills the ring in chunks while the consumer reads it, so bursts of
+    /// draws are served from memory as long as the ring holds them. Without one, the ring is refilled in a single
+    /// bulk call whenever it runs dry. Either way the integers are those of the engine, in order.
+    /// @note The ring is a single producer, single consumer queue: only one thread may draw from the generator.
+    /// The fast path of next() is a compare, a load and an increment; the consumer publishes its position and the
+    /// producer sleeps or wakes up only once per chunk.
+    /// @note A saved state holds the state of the engine and the integers still in the ring, so the restored
+    /// generator hands out the same sequence (the ring must be large enough for them).
+    template <typename Engine>
+    class BufferedGenerator : public Generator<typename Engine::result_type>
+    {
+        typedef typename Engine::result_type T;
+        friend class StaticView<BufferedGenerator>;
+    private:
+        Engine engine;
+        const size_t capacity, mask, chunk;
+        const bool background;
+        std::unique_ptr<T[]> ring;
+        // Consumer side: next position to read and the end of what it may read without looking at the producer
+        uint64_t read = 0, limit = 0;
+        // Positions shared by the two sides, on lines of their own
+        alignas(64) std::atomic<uint64_t> head{0};   // everything before it has been read
+        alignas(64) std::atomic<uint64_t> tail{0};   // everything before it has been written
+        alignas(64) std::atomic<bool> sleeping{false}, stopping{false};
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::thread producer;
+
+        static size_t ring_size(size_t n)
+        {
+            if (n == 0)
+                throw std::invalid_argument("Expected a ring of at least one integer");
+            size_t s = 2;
+            while (s < n)
+                s *= 2;
+            return s;
+        }
+        void produce()
+        {
+            while (true) {
+                const uint64_t t = tail.load(std::memory_order_relaxed);
+                if (t + chunk - head.load() > capacity) {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    sleeping.store(true);
+                    wake.wait(lock, [&]() { return stopping.load() || t + chunk - head.load() <= capacity; });
+                    sleeping.store(false);
+                }
+                if (stopping.load())
+                    return;
+                if (t + chunk - head.load() <= capacity) {
+                    engine.fill(ring.get() + (t & mask), chunk);
+                    tail.store(t + chunk, std::memory_order_release);
+                }
+            }
+        }
+        void start()
+        {
+            if (background) {
+                stopping.store(false);
+                producer = std::thread(&BufferedGenerator::produce, this);
+            }
+        }
+        void stop()
+        {
+            if (producer.joinable()) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stopping.store(true);
+                }
+                wake.notify_one();
+                producer.join();
+            }
+        }
+        // Called when read reaches limit: hands the space read so far back to the producer and waits for more
+        void refill()
+        {
+            if (!background) {
+                engine.fill(ring.get(), capacity);
+                read = 0;
+                limit = capacity;
+                return;
+            }
+            head.store(read);
+            if (sleeping.load()) {
+                std::lock_guard<std::mutex> lock(mutex);
+                wake.notify_one();
+            }
+            uint64_t t;
+            while ((t = tail.load(std::memory_order_acquire)) == read)
+                std::this_thread::yield();
+            // At most a chunk at a time, so the producer gets space back while the consumer is still reading
+            limit = std::min(t, read + chunk);
+        }
+        T generate() override
+        {
+            if (read == limit)
+                refill();
+            return ring[read++ & mask];
+        }
+        void generate_block(T* out, size_t n) override
+        {
+            while (n > 0) {
+                if (read == limit)
+                    refill();
+                size_t m = std::min<uint64_t>({n, limit - read, capacity - (read & mask)});
+                std::copy(ring.get() + (read & mask), ring.get() + (read & mask) + m, out);
+                read += m;
+                out += m;
+                n -= m;
+            }
+        }
+        void jump_ahead(uint64_t steps) override
+        {
+            stop();
+            // What is in the ring is skipped first, the rest by the engine
+            const uint64_t buffered = (background ? tail.load() : limit) - read;
+            if (steps <= buffered)
+                read += steps;
+            else {
+                engine.jump(steps - buffered);
+                discard();
+            }
+            limit = background ? std::min(tail.load(), read + chunk) : limit;
+            start();
+        }
+        bool fast_jump() const override
+        {
+            return engine.has_fast_jump();
+        }
+        void reseed(T seed) override
+        {
+            stop();
+            engine.reset_seed(seed);
+            discard();
+            start();
+        }
+        void reseed_from(const SeedSequence& seq) override
+        {
+            stop();
+            engine.reset_seed(seq);
+            discard();
+            start();
+        }
+        void discard()
+        {
+            read = limit = 0;
+            head.store(0);
+            tail.store(0);
+        }
+        // The state of the engine followed by the integers of the ring that are still to be read
+        void write_state(detail::StateWriter& out) const override
+        {
+            // The producer is paused so that the engine and the ring agree (saving does not change the values)
+            BufferedGenerator& self = const_cast<BufferedGenerator&>(*this);
+            self.stop();
+            std::vector<unsigned char> state;
+            std::vector<T> buffered;
+            try {
+                state = engine.save_state();
+                const uint64_t end = background ? tail.load() : limit;
+                for (uint64_t i = read; i < end; i++)
+                    buffered.push_back(ring[i & mask]);
+            }
+            catch (...) {
+                self.start();
+                throw;
+            }
+            self.start();
+            out.tag("BufferedGenerator");
+            out.bytes(state.data(), state.size());
+            out.put(uint64_t(buffered.size()));
+            out.put(buffered.data(), buffered.size());
+        }
+        void read_state(detail::StateReader& in) override
+        {
+            in.tag("BufferedGenerator");
+            const unsigned char* state;
+            const size_t size = in.bytes(state);
+            const uint64_t count = in.get<uint64_t>();
+            // The producer writes whole chunks, so the integers are put right before a chunk boundary
+            const uint64_t base = background ? (chunk - count % chunk) % chunk : 0;
+            if (count > capacity - base || count > in.remaining() / sizeof(T))
+                throw std::invalid_argument("The saved state holds more integers than the ring");
+            std::vector<T> buffered(count);
+            in.get(buffered.data(), count);
+            in.end();
+            stop();
+            try {
+                engine.load_state(state, size);
+                std::copy(buffered.begin(), buffered.end(), ring.get() + base);
+            }
+            catch (...) {
+                start();
+                throw;
+            }
+            read = base;
+            head.store(base);
+            tail.store(base + count);
+            limit = background ? std::min(base + count, base + chunk) : count;
+            start();
+        }
+    public:
+        /// @brief Wraps a copy of the given RNG
+        /// @param engine RNG whose integers are buffered
+        /// @param capacity size of the ring, in random integers (rounded up to a power of two, at least 2 chunks)
+        /// @param background true to fill the ring on a thread of its own, false to refill it in bulk on demand
+        BufferedGenerator(const Engine& engine, size_t capacity = 65536, bool background = true)
+            : engine(engine), capacity(ring_size(capacity)), mask(this->capacity - 1),
+              chunk(std::min<size_t>(4096, this->capacity / 2)), background(background),
+              ring(new T[this->capacity])
+        {
+            start();
+        }
+        BufferedGenerator(const BufferedGenerator&) = delete;
+        BufferedGenerator& operator=(const BufferedGenerator&) = delete;
+        /// @brief Stops the background thread
+        ~BufferedGenerator()
+        {
+            stop();
+        }
+        /// @brief Number of random integers the ring holds
+        size_t size() const
+        {
+            return capacity;
+        }
+    };
+}
 
+#endif
 
-#endif
\ No newline at end of file
+#endif
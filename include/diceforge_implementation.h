@@ -0,0 +1,8512 @@
+// Generated from src/ by tools/amalgamate.cmake (cmake --build <build> --target headers): edit the
+// sources rather than this file
+
+#ifndef DF_IMPLEMENTATION_H
+#define DF_IMPLEMENTATION_H
+
+#include "diceforge_core.h"
+#include "diceforge_distributions.h"
+#include "diceforge_generators.h"
+
+// src/Core/simd.h
+
+/***SIMD LANE WRAPPER***/
+/*a thin layer over the vector instructions (AVX2, SSE2 or NEON, whichever
+is available at compile time) shared by the SIMD kernels of the generators
+and, for lanes of real_t, by the data passes of the fitters*/
+
+#ifndef DF_SIMD_H
+#define DF_SIMD_H
+
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define DF_SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define DF_SIMD_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define DF_SIMD_NEON
+#endif
+
+#if defined(DF_SIMD_AVX2) || defined(DF_SIMD_SSE2) || defined(DF_SIMD_NEON)
+#define DF_SIMD
+#endif
+
+// The instruction set of the lanes, naming the inline namespace below: files compiled for different instruction
+// sets (see dispatch.h) each get their own copy of the inline functions, which the linker cannot mix up
+#if defined(DF_SIMD_AVX2)
+#define DF_SIMD_ISA avx2
+#elif defined(DF_SIMD_SSE2)
+#define DF_SIMD_ISA sse2
+#elif defined(DF_SIMD_NEON)
+#define DF_SIMD_ISA neon
+#else
+#define DF_SIMD_ISA scalar
+#endif
+
+namespace DiceForge
+{
+    namespace simd
+    {
+    inline namespace DF_SIMD_ISA
+    {
+        // Lanes<W> - thin wrapper over the vector instructions for lanes of the word type W
+        template <typename W>
+        struct Lanes;
+
+#if defined(DF_SIMD_AVX2)
+        template <>
+        struct Lanes<uint32_t>
+        {
+            typedef __m256i vec;
+            static constexpr int width = 8;
+            static vec load(const uint32_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+            static void store(uint32_t* p, vec v) { _mm256_storeu_si256((__m256i*)p, v); }
+            static vec set1(uint32_t x) { return _mm256_set1_epi32((int)x); }
+            static vec srl(vec v, int n) { return _mm256_srl_epi32(v, _mm_cvtsi32_si128(n)); }
+            static vec sll(vec v, int n) { return _mm256_sll_epi32(v, _mm_cvtsi32_si128(n)); }
+            static vec neg(vec v) { return _mm256_sub_epi32(_mm256_setzero_si256(), v); }
+            static vec band(vec a, vec b) { return _mm256_and_si256(a, b); }
+            static vec bor(vec a, vec b) { return _mm256_or_si256(a, b); }
+            static vec bxor(vec a, vec b) { return _mm256_xor_si256(a, b); }
+            static vec add(vec a, vec b) { return _mm256_add_epi32(a, b); }
+            static vec mul(vec a, vec b) { return _mm256_mullo_epi32(a, b); }
+        };
+
+        template <>
+        struct Lanes<uint64_t>
+        {
+            typedef __m256i vec;
+            static constexpr int width = 4;
+            static vec load(const uint64_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+            static void store(uint64_t* p, vec v) { _mm256_storeu_si256((__m256i*)p, v); }
+            static vec set1(uint64_t x) { return _mm256_set1_epi64x((long long)x); }
+            static vec srl(vec v, int n) { return _mm256_srl_epi64(v, _mm_cvtsi32_si128(n)); }
+            static vec sll(vec v, int n) { return _mm256_sll_epi64(v, _mm_cvtsi32_si128(n)); }
+            static vec neg(vec v) { return _mm256_sub_epi64(_mm256_setzero_si256(), v); }
+            static vec band(vec a, vec b) { return _mm256_and_si256(a, b); }
+            static vec bor(vec a, vec b) { return _mm256_or_si256(a, b); }
+            static vec bxor(vec a, vec b) { return _mm256_xor_si256(a, b); }
+            static vec add(vec a, vec b) { return _mm256_add_epi64(a, b); }
+            // Low 64 bits of the products, built from 32x32 -> 64 bit multiplies (there is no 64-bit mullo in AVX2)
+            static vec mul(vec a, vec b)
+            {
+                vec cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b), _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+                return _mm256_add_epi64(_mm256_mul_epu32(a, b), _mm256_slli_epi64(cross, 32));
+            }
+        };
+#elif defined(DF_SIMD_SSE2)
+        template <>
+        struct Lanes<uint32_t>
+        {
+            typedef __m128i vec;
+            static constexpr int width = 4;
+            static vec load(const uint32_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+            static void store(uint32_t* p, vec v) { _mm_storeu_si128((__m128i*)p, v); }
+            static vec set1(uint32_t x) { return _mm_set1_epi32((int)x); }
+            static vec srl(vec v, int n) { return _mm_srl_epi32(v, _mm_cvtsi32_si128(n)); }
+            static vec sll(vec v, int n) { return _mm_sll_epi32(v, _mm_cvtsi32_si128(n)); }
+            static vec neg(vec v) { return _mm_sub_epi32(_mm_setzero_si128(), v); }
+            static vec band(vec a, vec b) { return _mm_and_si128(a, b); }
+            static vec bor(vec a, vec b) { return _mm_or_si128(a, b); }
+            static vec bxor(vec a, vec b) { return _mm_xor_si128(a, b); }
+            static vec add(vec a, vec b) { return _mm_add_epi32(a, b); }
+            // SSE2 has no 32-bit mullo, so the even and odd lanes are multiplied separately and interleaved back
+            static vec mul(vec a, vec b)
+            {
+                vec even = _mm_mul_epu32(a, b);
+                vec odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+                return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+            }
+        };
+
+        template <>
+        struct Lanes<uint64_t>
+        {
+            typedef __m128i vec;
+            static constexpr int width = 2;
+            static vec load(const uint64_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+            static void store(uint64_t* p, vec v) { _mm_storeu_si128((__m128i*)p, v); }
+            static vec set1(uint64_t x) { return _mm_set1_epi64x((long long)x); }
+            static vec srl(vec v, int n) { return _mm_srl_epi64(v, _mm_cvtsi32_si128(n)); }
+            static vec sll(vec v, int n) { return _mm_sll_epi64(v, _mm_cvtsi32_si128(n)); }
+            static vec neg(vec v) { return _mm_sub_epi64(_mm_setzero_si128(), v); }
+            static vec band(vec a, vec b) { return _mm_and_si128(a, b); }
+            static vec bor(vec a, vec b) { return _mm_or_si128(a, b); }
+            static vec bxor(vec a, vec b) { return _mm_xor_si128(a, b); }
+            static vec add(vec a, vec b) { return _mm_add_epi64(a, b); }
+            // Low 64 bits of the products, built from 32x32 -> 64 bit multiplies
+            static vec mul(vec a, vec b)
+            {
+                vec cross = _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(a, 32), b), _mm_mul_epu32(a, _mm_srli_epi64(b, 32)));
+                return _mm_add_epi64(_mm_mul_epu32(a, b), _mm_slli_epi64(cross, 32));
+            }
+        };
+#elif defined(DF_SIMD_NEON)
+        template <>
+        struct Lanes<uint32_t>
+        {
+            typedef uint32x4_t vec;
+            static constexpr int width = 4;
+            static vec load(const uint32_t* p) { return vld1q_u32((const ::uint32_t*)p); }
+            static void store(uint32_t* p, vec v) { vst1q_u32((::uint32_t*)p, v); }
+            static vec set1(uint32_t x) { return vdupq_n_u32(x); }
+            static vec srl(vec v, int n) { return vshlq_u32(v, vdupq_n_s32(-n)); }
+            static vec sll(vec v, int n) { return vshlq_u32(v, vdupq_n_s32(n)); }
+            static vec neg(vec v) { return vsubq_u32(vdupq_n_u32(0), v); }
+            static vec band(vec a, vec b) { return vandq_u32(a, b); }
+            static vec bor(vec a, vec b) { return vorrq_u32(a, b); }
+            static vec bxor(vec a, vec b) { return veorq_u32(a, b); }
+            static vec add(vec a, vec b) { return vaddq_u32(a, b); }
+            static vec mul(vec a, vec b) { return vmulq_u32(a, b); }
+        };
+
+        template <>
+        struct Lanes<uint64_t>
+        {
+            typedef uint64x2_t vec;
+            static constexpr int width = 2;
+            static vec load(const uint64_t* p) { return vld1q_u64((const ::uint64_t*)p); }
+            static void store(uint64_t* p, vec v) { vst1q_u64((::uint64_t*)p, v); }
+            static vec set1(uint64_t x) { return vdupq_n_u64(x); }
+            static vec srl(vec v, int n) { return vshlq_u64(v, vdupq_n_s64(-n)); }
+            static vec sll(vec v, int n) { return vshlq_u64(v, vdupq_n_s64(n)); }
+            static vec neg(vec v) { return vsubq_u64(vdupq_n_u64(0), v); }
+            static vec band(vec a, vec b) { return vandq_u64(a, b); }
+            static vec bor(vec a, vec b) { return vorrq_u64(a, b); }
+            static vec bxor(vec a, vec b) { return veorq_u64(a, b); }
+            static vec add(vec a, vec b) { return vaddq_u64(a, b); }
+            // Low 64 bits of the products, built from 32x32 -> 64 bit multiplies
+            static vec mul(vec a, vec b)
+            {
+                uint32x2_t al = vmovn_u64(a), ah = vshrn_n_u64(a, 32), bl = vmovn_u64(b), bh = vshrn_n_u64(b, 32);
+                uint64x2_t cross = vmlal_u32(vmull_u32(ah, bl), al, bh);
+                return vaddq_u64(vmull_u32(al, bl), vshlq_n_u64(cross, 32));
+            }
+        };
+#endif
+
+        // Elementary functions with the same spelling for real_t and vreal, so that a kernel written
+        // once as a template over the value type runs both on single values and on whole lanes
+        inline real_t exp(real_t x) { return ::exp(x); }
+        inline real_t log(real_t x) { return ::log(x); }
+        inline real_t log1p(real_t x) { return ::log1p(x); }
+        inline real_t sqrt(real_t x) { return ::sqrt(x); }
+        // min and max keep the operand order of the vector instructions, giving b when either is NaN
+        inline real_t min(real_t a, real_t b) { return (a < b) ? a : b; }
+        inline real_t max(real_t a, real_t b) { return (a > b) ? a : b; }
+        inline real_t select(bool c, real_t a, real_t b) { return c ? a : b; }
+
+#if defined(DF_SIMD_AVX2) || defined(DF_SIMD_SSE2) || (defined(DF_SIMD_NEON) && defined(__aarch64__))
+#define DF_SIMD_REAL
+        // vreal - lanes of real_t with the arithmetic operators, comparisons giving a vmask
+#if defined(DF_SIMD_AVX2)
+        struct vreal
+        {
+            typedef __m256d native;
+            static constexpr int width = 4;
+            native v;
+            vreal() {}
+            vreal(native v) : v(v) {}
+            vreal(real_t x) : v(_mm256_set1_pd(x)) {}
+            static vreal load(const real_t* p) { return _mm256_loadu_pd(p); }
+            void store(real_t* p) const { _mm256_storeu_pd(p, v); }
+        };
+        typedef __m256d vmask;
+
+        inline vreal operator+(vreal a, vreal b) { return _mm256_add_pd(a.v, b.v); }
+        inline vreal operator-(vreal a, vreal b) { return _mm256_sub_pd(a.v, b.v); }
+        inline vreal operator*(vreal a, vreal b) { return _mm256_mul_pd(a.v, b.v); }
+        inline vreal operator/(vreal a, vreal b) { return _mm256_div_pd(a.v, b.v); }
+        inline vmask operator<(vreal a, vreal b) { return _mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ); }
+        inline vmask operator>(vreal a, vreal b) { return _mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ); }
+        inline vreal select(vmask c, vreal a, vreal b) { return _mm256_blendv_pd(b.v, a.v, c); }
+        inline vreal min(vreal a, vreal b) { return _mm256_min_pd(a.v, b.v); }
+        inline vreal max(vreal a, vreal b) { return _mm256_max_pd(a.v, b.v); }
+        inline vreal sqrt(vreal a) { return _mm256_sqrt_pd(a.v); }
+        // Integer view of the bit patterns (64-bit lanes)
+        inline Lanes<uint64_t>::vec bits(vreal a) { return _mm256_castpd_si256(a.v); }
+        inline vreal from_bits(Lanes<uint64_t>::vec b) { return _mm256_castsi256_pd(b); }
+#elif defined(DF_SIMD_SSE2)
+        struct vreal
+        {
+            typedef __m128d native;
+            static constexpr int width = 2;
+            native v;
+            vreal() {}
+            vreal(native v) : v(v) {}
+            vreal(real_t x) : v(_mm_set1_pd(x)) {}
+            static vreal load(const real_t* p) { return _mm_loadu_pd(p); }
+            void store(real_t* p) const { _mm_storeu_pd(p, v); }
+        };
+        typedef __m128d vmask;
+
+        inline vreal operator+(vreal a, vreal b) { return _mm_add_pd(a.v, b.v); }
+        inline vreal operator-(vreal a, vreal b) { return _mm_sub_pd(a.v, b.v); }
+        inline vreal operator*(vreal a, vreal b) { return _mm_mul_pd(a.v, b.v); }
+        inline vreal operator/(vreal a, vreal b) { return _mm_div_pd(a.v, b.v); }
+        inline vmask operator<(vreal a, vreal b) { return _mm_cmplt_pd(a.v, b.v); }
+        inline vmask operator>(vreal a, vreal b) { return _mm_cmpgt_pd(a.v, b.v); }
+        inline vreal select(vmask c, vreal a, vreal b) { return _mm_or_pd(_mm_and_pd(c, a.v), _mm_andnot_pd(c, b.v)); }
+        inline vreal min(vreal a, vreal b) { return _mm_min_pd(a.v, b.v); }
+        inline vreal max(vreal a, vreal b) { return _mm_max_pd(a.v, b.v); }
+        inline vreal sqrt(vreal a) { return _mm_sqrt_pd(a.v); }
+        inline Lanes<uint64_t>::vec bits(vreal a) { return _mm_castpd_si128(a.v); }
+        inline vreal from_bits(Lanes<uint64_t>::vec b) { return _mm_castsi128_pd(b); }
+#else
+        struct vreal
+        {
+            typedef float64x2_t native;
+            static constexpr int width = 2;
+            native v;
+            vreal() {}
+            vreal(native v) : v(v) {}
+            vreal(real_t x) : v(vdupq_n_f64(x)) {}
+            static vreal load(const real_t* p) { return vld1q_f64(p); }
+            void store(real_t* p) const { vst1q_f64(p, v); }
+        };
+        typedef uint64x2_t vmask;
+
+        inline vreal operator+(vreal a, vreal b) { return vaddq_f64(a.v, b.v); }
+        inline vreal operator-(vreal a, vreal b) { return vsubq_f64(a.v, b.v); }
+        inline vreal operator*(vreal a, vreal b) { return vmulq_f64(a.v, b.v); }
+        inline vreal operator/(vreal a, vreal b) { return vdivq_f64(a.v, b.v); }
+        inline vmask operator<(vreal a, vreal b) { return vcltq_f64(a.v, b.v); }
+        inline vmask operator>(vreal a, vreal b) { return vcgtq_f64(a.v, b.v); }
+        inline vreal select(vmask c, vreal a, vreal b) { return vbslq_f64(c, a.v, b.v); }
+        inline vreal min(vreal a, vreal b) { return vminq_f64(a.v, b.v); }
+        inline vreal max(vreal a, vreal b) { return vmaxq_f64(a.v, b.v); }
+        inline vreal sqrt(vreal a) { return vsqrtq_f64(a.v); }
+        inline Lanes<uint64_t>::vec bits(vreal a) { return vreinterpretq_u64_f64(a.v); }
+        inline vreal from_bits(Lanes<uint64_t>::vec b) { return vreinterpretq_f64_u64(b); }
+#endif
+        inline vreal operator-(vreal a) { return vreal(0.0) - a; }
+        inline vreal& operator+=(vreal& a, vreal b) { return a = a + b; }
+        inline vreal& operator-=(vreal& a, vreal b) { return a = a - b; }
+        inline vreal& operator*=(vreal& a, vreal b) { return a = a * b; }
+
+        /// @brief Sum of the lanes, always added up in the same order
+        inline real_t sum(vreal a)
+        {
+            real_t l[vreal::width], s = 0;
+            a.store(l);
+            for (int i = 0; i < vreal::width; i++)
+                s += l[i];
+            return s;
+        }
+
+        /// @brief Clears the upper halves of the AVX registers, before scalar code calling the C library in the
+        /// middle of a vector loop: its SSE instructions would otherwise wait on those halves, call after call
+        inline void zero_upper()
+        {
+#if defined(DF_SIMD_AVX2)
+            _mm256_zeroupper();
+#endif
+        }
+
+        /// @brief e^x in every lane (within a couple of ulp), flushing to 0 below -708 and overflowing to infinity
+        /// @note x is split as n ln2 + r with |r| <= ln2 / 2; e^r is a degree 13 Taylor polynomial and 2^n is
+        /// assembled in the exponent field
+        inline vreal exp(vreal x)
+        {
+            typedef Lanes<uint64_t> U;
+            const vreal shifter(6755399441055744.0);         // 1.5 * 2^52, rounds to the nearest integer
+            vreal xc = min(max(x, vreal(-708.0)), vreal(709.78));
+            vreal t = xc * vreal(M_LOG2E) + shifter;
+            vreal n = t - shifter;
+            vreal r = xc - n * vreal(6.93145751953125e-1) - n * vreal(1.42860682030941723212e-6);
+
+            vreal p(1.0 / 6227020800.0);
+            const real_t inv_factorial[13] = {1.0 / 479001600.0, 1.0 / 39916800.0, 1.0 / 3628800.0, 1.0 / 362880.0,
+                                              1.0 / 40320.0, 1.0 / 5040.0, 1.0 / 720.0, 1.0 / 120.0, 1.0 / 24.0,
+                                              1.0 / 6.0, 0.5, 1.0, 1.0};
+            for (int k = 0; k < 13; k++)
+                p = p * r + vreal(inv_factorial[k]);
+
+            // the low bits of t hold n; 2^(n - 1) has the biased exponent n + 1022, which stays finite for n = 1024
+            U::vec e = U::sll(U::add(U::add(bits(t), U::set1(0ULL - 0x4338000000000000ULL)), U::set1(1022)), 52);
+            vreal y = p * from_bits(e) * vreal(2.0);
+            y = select(x > vreal(709.78), vreal(INFINITY), y);
+            return select(x < vreal(-708.0), vreal(0.0), y);
+        }
+
+        /// @brief Natural logarithm in every lane, for positive normal x
+        /// @note With x = 2^e m and m in [sqrt(1/2), sqrt(2)), log m = 2 atanh(s) for s = (m - 1) / (m + 1),
+        /// |s| < 0.172, summed to s^23
+        inline vreal log(vreal x)
+        {
+            typedef Lanes<uint64_t> U;
+            U::vec b = bits(x);
+            vreal m = from_bits(U::bor(U::band(b, U::set1(0x000FFFFFFFFFFFFFULL)), U::set1(0x3FF0000000000000ULL)));
+            // 2^52 + biased exponent, as a real
+            vreal e = from_bits(U::bor(U::srl(b, 52), U::set1(0x4330000000000000ULL))) - vreal(4503599627371519.0);
+            vmask big = m > vreal(M_SQRT2);
+            m = select(big, m * vreal(0.5), m);
+            e = select(big, e + vreal(1.0), e);
+
+            vreal s = (m - vreal(1.0)) / (m + vreal(1.0)), s2 = s * s;
+            vreal p(1.0 / 23);
+            for (int k = 21; k >= 1; k -= 2)
+                p = p * s2 + vreal(1.0 / k);
+            return e * vreal(6.93145751953125e-1) + (vreal(2.0) * s * p + e * vreal(1.42860682030941723212e-6));
+        }
+
+        /// @brief log(1 + x) in every lane, for x > -1 with 1 + x normal
+        /// @note The logarithm of w = 1 + x rounded, less the rounding error (w - 1) - x divided by w
+        inline vreal log1p(vreal x)
+        {
+            const vreal w = vreal(1.0) + x;
+            return log(w) - ((w - vreal(1.0)) - x) / w;
+        }
+#endif
+
+        /// @brief sin(2 pi x) and cos(2 pi x), for V = real_t or vreal (within a few ulp, for |x| < 2^51)
+        /// @note x is reduced to r in [-1/2, 1/2] by removing the nearest integer, so that the angles of uniform
+        /// variates need no range reduction in radians; sin and cos of pi r / 2, in [-pi/4, pi/4], are Taylor
+        /// polynomials of degree 17 and 16, and two doublings give those of 2 pi r
+        template <typename V>
+        inline void sincos_turn(V x, V& s, V& c)
+        {
+            const V shifter(6755399441055744.0);             // 1.5 * 2^52, rounds to the nearest integer
+            const V a = (x - ((x + shifter) - shifter)) * V(M_PI / 2), a2 = a * a;
+            // (-1)^k / (2k + 1)! and (-1)^k / (2k)!, from k = 8 down to 0
+            const real_t sin_terms[9] = {1.0 / 355687428096000.0, -1.0 / 1307674368000.0, 1.0 / 6227020800.0,
+                                         -1.0 / 39916800.0, 1.0 / 362880.0, -1.0 / 5040.0, 1.0 / 120.0, -1.0 / 6.0, 1.0};
+            const real_t cos_terms[9] = {1.0 / 20922789888000.0, -1.0 / 87178291200.0, 1.0 / 479001600.0,
+                                         -1.0 / 3628800.0, 1.0 / 40320.0, -1.0 / 720.0, 1.0 / 24.0, -0.5, 1.0};
+            V ps(sin_terms[0]), pc(cos_terms[0]);
+            for (int k = 1; k < 9; k++) {
+                ps = ps * a2 + V(sin_terms[k]);
+                pc = pc * a2 + V(cos_terms[k]);
+            }
+            s = ps * a;
+            c = pc;
+            for (int k = 0; k < 2; k++) {
+                const V s2 = V(2.0) * s * c;
+                c = (c - s) * (c + s);
+                s = s2;
+            }
+        }
+    }
+    }
+}
+
+#endif
+
+// src/Core/dispatch.h
+
+/***RUNTIME CPU DISPATCH***/
+/*with the CMake option DICEFORGE_DISPATCH, the files of SIMD kernels are also
+compiled for AVX2 with FMA, their functions going into a namespace avx2 (the
+value of DF_DISPATCH_VARIANT in that compilation), and the functions of the
+baseline compilation hand their work over to those when the CPU running them
+has both instruction sets*/
+
+#ifndef DF_DISPATCH_H
+#define DF_DISPATCH_H
+
+// A variant must not odr-use any inline function that the baseline uses too (standard algorithms included), since
+// the linker keeps one copy of each, maybe compiled for the wrong CPU: it calls the functions of simd.h, which
+// are in a namespace named after the instruction set, of its own file, in an unnamed namespace, or none at all.
+#if defined(DF_DISPATCH_VARIANT)
+#define DF_DISPATCH_BEGIN namespace DF_DISPATCH_VARIANT {
+#define DF_DISPATCH_END }
+#define DF_DISPATCH(call) ((void)0)
+#elif defined(DF_RUNTIME_DISPATCH) && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define DF_DISPATCH_BEGIN
+#define DF_DISPATCH_END
+// Returns the value of the AVX2 variant of the call when the CPU has AVX2 and FMA
+#define DF_DISPATCH(call) if (::DiceForge::detail::has_avx2()) return avx2::call
+#define DF_DISPATCH_AVX2
+
+namespace DiceForge
+{
+    namespace detail
+    {
+        // Whether the CPU running the program has AVX2 and FMA, found out once
+        inline bool has_avx2()
+        {
+            static const bool avx2 = []() {
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+            }();
+            return avx2;
+        }
+    }
+}
+#else
+#define DF_DISPATCH_BEGIN
+#define DF_DISPATCH_END
+#define DF_DISPATCH(call) ((void)0)
+#endif
+
+#endif
+
+// src/Core/fitting.h
+
+#ifndef DF_FITTING_H
+#define DF_FITTING_H
+
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace DiceForge
+{
+    /* Shared non-linear least squares core for the fitTo* functions */
+
+    /* The model is a callable V model(V x, const real_t* theta, V* grad) returning f(x; theta) and
+    * writing the P partial derivatives df/dtheta into grad, for V = real_t and (when DF_SIMD_REAL is
+    * defined) V = simd::vreal, i.e. a generic lambda written with simd::exp, simd::log and simd::select.
+    * It should return NaN for parameters outside its domain (e.g. a non-positive scale), which rejects
+    * the step. */
+
+    namespace fitting
+    {
+        // Points per chunk of a data pass: every chunk is summed on its own and the chunk sums are added
+        // in order, so the result does not depend on the number of threads
+        constexpr size_t chunk_size = 8192;
+        // Passes over fewer points than this stay on the calling thread
+        constexpr size_t parallel_threshold = 65536;
+
+        /// @brief A fixed set of threads that run the chunks of a data pass together with the caller
+        class Workers
+        {
+        public:
+            /// @param threads total number of threads including the caller, 0 for std::thread::hardware_concurrency
+            explicit Workers(int threads = 0);
+            ~Workers();
+
+            Workers(const Workers&) = delete;
+            Workers& operator=(const Workers&) = delete;
+
+            /// @brief Calls job(i) for every i < jobs, spread over the threads, and returns once all are done
+            void run(size_t jobs, const std::function<void(size_t)>& job);
+
+            int size() const { return int(threads.size()) + 1; }
+
+        private:
+            void work();
+
+            std::vector<std::thread> threads;
+            std::mutex lock;
+            std::condition_variable wake, done;
+            const std::function<void(size_t)>* job = nullptr;
+            size_t jobs = 0;
+            std::atomic<size_t> next{0};
+            int busy = 0;
+            unsigned long generation = 0;
+            bool stop = false;
+        };
+
+        /* Sums of one chunk: squared residuals and the normal equations */
+        template <int P>
+        struct Partial
+        {
+            real_t sse;
+            fixed_matrix_t<P, P> A;
+            fixed_matrix_t<P, 1> g;
+        };
+
+        /* Accumulates the points [begin, end) into an (upper triangular) partial sum, the model being
+        * evaluated over whole SIMD lanes where possible */
+        template <int P, typename Model>
+        void accumulate_chunk(Model& model, const real_t* x, const real_t* y, size_t begin, size_t end,
+                              const real_t* theta, Partial<P>& out)
+        {
+            out.sse = 0;
+            out.A = fixed_matrix_t<P, P>();
+            out.g = fixed_matrix_t<P, 1>();
+            size_t i = begin;
+#if defined(DF_SIMD_REAL)
+            typedef simd::vreal V;
+            V sse(0.0), grad[P], g[P], A[P][P];
+            for (int a = 0; a < P; a++)
+            {
+                g[a] = V(0.0);
+                for (int b = a; b < P; b++)
+                    A[a][b] = V(0.0);
+            }
+            for (; i + V::width <= end; i += V::width)
+            {
+                V r = V::load(y + i) - model(V::load(x + i), theta, grad);
+                sse += r * r;
+                for (int a = 0; a < P; a++)
+                {
+                    g[a] += grad[a] * r;
+                    for (int b = a; b < P; b++)
+                        A[a][b] += grad[a] * grad[b];
+                }
+            }
+            out.sse = simd::sum(sse);
+            for (int a = 0; a < P; a++)
+            {
+                out.g.m[a][0] = simd::sum(g[a]);
+                for (int b = a; b < P; b++)
+                    out.A.m[a][b] = simd::sum(A[a][b]);
+            }
+#endif
+            real_t grad1[P];
+            for (; i < end; i++)
+            {
+                real_t r = y[i] - model(x[i], theta, grad1);
+                out.sse += r * r;
+                for (int a = 0; a < P; a++)
+                {
+                    out.g.m[a][0] += grad1[a] * r;
+                    for (int b = a; b < P; b++)
+                        out.A.m[a][b] += grad1[a] * grad1[b];
+                }
+            }
+        }
+
+        /* One pass over the data: sum of squared residuals r_i = y_i - f(x_i), together with
+        * the normal equations A = G^T G and g = G^T r of the gradient rows G, without storing G.
+        * parts has one entry per chunk, workers may be null to stay on the calling thread. */
+        template <int P, typename Model>
+        real_t accumulate(Model& model, const real_t* x, const real_t* y, size_t n, const real_t* theta,
+                          fixed_matrix_t<P, P>& A, fixed_matrix_t<P, 1>& g,
+                          std::vector<Partial<P>>& parts, Workers* workers)
+        {
+            auto job = [&](size_t c)
+            {
+                accumulate_chunk<P>(model, x, y, c * chunk_size, std::min(n, (c + 1) * chunk_size), theta, parts[c]);
+            };
+            if (workers)
+                workers->run(parts.size(), job);
+            else
+                for (size_t c = 0; c < parts.size(); c++)
+                    job(c);
+
+            A = fixed_matrix_t<P, P>();
+            g = fixed_matrix_t<P, 1>();
+            real_t sse = 0;
+            for (const Partial<P>& part : parts)
+            {
+                sse += part.sse;
+                for (int a = 0; a < P; a++)
+                {
+                    g.m[a][0] += part.g.m[a][0];
+                    for (int b = a; b < P; b++)
+                        A.m[a][b] += part.A.m[a][b];
+                }
+            }
+            for (int a = 0; a < P; a++)
+                for (int b = 0; b < a; b++)
+                    A.m[a][b] = A.m[b][a];
+            return sse;
+        }
+
+        /* Solves M d = v by Cholesky decomposition, false if M is not positive definite */
+        template <int P>
+        bool cholesky_solve(fixed_matrix_t<P, P> M, const fixed_matrix_t<P, 1>& v, real_t* d)
+        {
+            for (int j = 0; j < P; j++)
+            {
+                real_t s = M.m[j][j];
+                for (int k = 0; k < j; k++)
+                    s -= M.m[j][k] * M.m[j][k];
+                if (!(s > 0))
+                    return false;
+                M.m[j][j] = sqrt(s);
+                for (int i = j + 1; i < P; i++)
+                {
+                    real_t t = M.m[i][j];
+                    for (int k = 0; k < j; k++)
+                        t -= M.m[i][k] * M.m[j][k];
+                    M.m[i][j] = t / M.m[j][j];
+                }
+            }
+            for (int i = 0; i < P; i++)
+            {
+                real_t t = v.m[i][0];
+                for (int k = 0; k < i; k++)
+                    t -= M.m[i][k] * d[k];
+                d[i] = t / M.m[i][i];
+            }
+            for (int i = P - 1; i >= 0; i--)
+            {
+                real_t t = d[i];
+                for (int k = i + 1; k < P; k++)
+                    t -= M.m[k][i] * d[k];
+                d[i] = t / M.m[i][i];
+            }
+            return true;
+        }
+    }
+
+    /// @brief Levenberg-Marquardt minimisation of sum (y_i - f(x_i; theta))^2 over the P parameters theta
+    /// @param model callable evaluating f and its gradient, see above
+    /// @param x, y the n data points
+    /// @param theta initial guess on entry, best parameters found on return
+    /// @param max_iter maximum number of iterations (each is one pass over the data)
+    /// @param epsilon the fit has converged once an accepted step moves no parameter by more than epsilon
+    /// @param threads threads for the data passes, 0 for all hardware threads (passes over fewer than
+    /// fitting::parallel_threshold points always run on the calling thread)
+    /// @return true if the fit converged within max_iter iterations
+    /// @note Only the P x P normal equations are kept, so the memory used does not grow with n. A step is
+    /// taken only if it lowers the sum of squared residuals; the damping lambda * diag(G^T G) moves between
+    /// gradient descent (rejected steps) and Gauss-Newton (accepted steps). The result is the same for any
+    /// number of threads.
+    template <int P, typename Model>
+    bool levenberg_marquardt(Model model, const real_t* x, const real_t* y, size_t n, real_t* theta,
+                             int max_iter, real_t epsilon, int threads = 0)
+    {
+        std::vector<fitting::Partial<P>> parts((n + fitting::chunk_size - 1) / fitting::chunk_size);
+        std::unique_ptr<fitting::Workers> workers;
+        if (n >= fitting::parallel_threshold && threads != 1)
+        {
+            workers.reset(new fitting::Workers(threads));
+            if (workers->size() == 1)
+                workers.reset();
+        }
+
+        fixed_matrix_t<P, P> A, A_trial, M;
+        fixed_matrix_t<P, 1> g, g_trial;
+        real_t trial[P], d[P];
+        real_t lambda = 1e-3;
+
+        real_t sse = fitting::accumulate<P>(model, x, y, n, theta, A, g, parts, workers.get());
+        if (!std::isfinite(sse))
+            return false;
+
+        for (int iter = 0; iter < max_iter; iter++)
+        {
+            M = A;
+            for (int a = 0; a < P; a++)
+                M.m[a][a] += lambda * (A.m[a][a] > 0 ? A.m[a][a] : 1);
+
+            real_t sse_trial = INFINITY;
+            if (fitting::cholesky_solve<P>(M, g, d))
+            {
+                for (int a = 0; a < P; a++)
+                    trial[a] = theta[a] + d[a];
+                sse_trial = fitting::accumulate<P>(model, x, y, n, trial, A_trial, g_trial, parts, workers.get());
+            }
+
+            if (sse_trial <= sse)
+            {
+                bool small = true;
+                for (int a = 0; a < P; a++)
+                {
+                    small = small && fabs(d[a]) < epsilon;
+                    theta[a] = trial[a];
+                }
+                A = A_trial;
+                g = g_trial;
+                sse = sse_trial;
+                lambda = fmax(lambda * 0.1, 1e-12);
+                if (small)
+                    return true;
+            }
+            else
+            {
+                // no step along any direction lowers the error any more
+                lambda *= 10;
+                if (lambda > 1e16)
+                    return true;
+            }
+        }
+        return false;
+    }
+}
+
+#endif
+
+// src/Generators/MT/MT_jump.h
+
+/***JUMP AHEAD FOR THE MERSENNE TWISTER***/
+/*the words of the Mersenne Twister follow a linear recurrence over GF(2),
+so the state e steps ahead is p(T) applied to the current one, where T is the
+transition and p(x) = x^e modulo the characteristic polynomial of T*/
+
+#ifndef DF_MT_JUMP_H
+#define DF_MT_JUMP_H
+
+#include <vector>
+#include <cstddef>
+
+namespace DiceForge
+{
+    namespace MT_jump
+    {
+        // Polynomial over GF(2): bit i % 64 of word i / 64 is the coefficient of x^i
+        typedef std::vector<uint64_t> Poly;
+
+        inline bool coefficient(const Poly& a, size_t i)
+        {
+            return i / 64 < a.size() && ((a[i / 64] >> (i % 64)) & 1);
+        }
+
+        // a ^= b * x^shift
+        inline void add_shifted(Poly& a, const Poly& b, size_t shift)
+        {
+            size_t ws = shift / 64, bs = shift % 64;
+            for (size_t w = 0; w < b.size() && w + ws < a.size(); w++)
+            {
+                a[w + ws] ^= b[w] << bs;
+                if (bs != 0 && w + ws + 1 < a.size())
+                    a[w + ws + 1] ^= b[w] >> (64 - bs);
+            }
+        }
+
+        /// @brief The recurrence x[k + N] = x[k + M] ^ twist(x[k], x[k + 1]) of the state words
+        template <typename W>
+        struct Recurrence
+        {
+            int N, M;
+            W A, upperbits, lowerbits;
+
+            /// @brief Computes the word N places after c[i] in the circular window c, stores it in c[i]
+            /// and moves i to the next word
+            void step(W* c, int& i) const
+            {
+                int i1 = (i + 1 == N) ? 0 : i + 1, im = (i + M >= N) ? i + M - N : i + M;
+                W y = (c[i] & upperbits) | (c[i1] & lowerbits);
+                c[i] = c[im] ^ (y >> 1) ^ ((W(0) - (y & 1)) & A);
+                i = i1;
+            }
+        };
+
+        /// @brief Characteristic polynomial of the transition, found as the minimal polynomial of the lowest
+        /// bit of the words (Berlekamp-Massey over 2 * N * w terms)
+        /// @param degree set to the degree of the polynomial
+        /// @note Both are the same for a primitive characteristic polynomial, as in the standard parameter sets
+        template <typename W>
+        Poly characteristic_polynomial(const Recurrence<W>& rec, size_t& degree)
+        {
+            const size_t terms = 2 * size_t(rec.N) * 8 * sizeof(W), words = terms / 64 + 2;
+
+            // Any non-zero starting state will do
+            std::vector<W> c(rec.N);
+            for (int k = 0; k < rec.N; k++)
+                c[k] = W(0x9E3779B97F4A7C15ULL * (k + 1));
+            int i = 0;
+            // The lower bits of the very first word are not part of the recurrence state
+            rec.step(c.data(), i);
+
+            // Connection polynomials C and B, and the sequence read backwards, R[j] = s[n - j]
+            Poly C(words, 0), B(words, 0), R(words, 0), T;
+            C[0] = B[0] = 1;
+            size_t L = 0, m = 1;
+            for (size_t n = 0; n < terms; n++)
+            {
+                uint64_t s = c[i] & 1;
+                rec.step(c.data(), i);
+                for (size_t w = words - 1; w > 0; w--)
+                    R[w] = (R[w] << 1) | (R[w - 1] >> 63);
+                R[0] = (R[0] << 1) | s;
+
+                // Discrepancy: parity of C . R over the first L + 1 terms
+                uint64_t d = 0;
+                for (size_t w = 0; w <= L / 64; w++)
+                    d ^= C[w] & R[w];
+                d ^= d >> 32; d ^= d >> 16; d ^= d >> 8; d ^= d >> 4; d ^= d >> 2; d ^= d >> 1;
+
+                if ((d & 1) == 0)
+                    m++;
+                else if (2 * L <= n)
+                {
+                    T = C;
+                    add_shifted(C, B, m);
+                    L = n + 1 - L;
+                    B = T;
+                    m = 1;
+                }
+                else
+                {
+                    add_shifted(C, B, m);
+                    m++;
+                }
+            }
+
+            // P(x) = x^L C(1/x)
+            Poly P(L / 64 + 1, 0);
+            for (size_t j = 0; j <= L; j++)
+                if (coefficient(C, L - j))
+                    P[j / 64] |= 1ULL << (j % 64);
+            degree = L;
+            return P;
+        }
+
+        /// @brief x^e modulo P, where P has the given degree
+        inline Poly power_of_x(const Poly& P, size_t degree, uint128_t e)
+        {
+            const size_t words = degree / 64 + 1;
+            Poly r(words, 0), sq(2 * words, 0);
+            r[0] = 1;
+            int top = 127;
+            while (top >= 0 && ((e >> top) & 1) == 0)
+                top--;
+            for (; top >= 0; top--)
+            {
+                // Squaring over GF(2) spreads the coefficients to the even powers
+                for (size_t w = 0; w < words; w++)
+                {
+                    for (int h = 0; h < 2; h++)
+                    {
+                        uint64_t x = (r[w] >> (32 * h)) & 0xFFFFFFFFULL;
+                        x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+                        x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+                        x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+                        x = (x | (x << 2)) & 0x3333333333333333ULL;
+                        x = (x | (x << 1)) & 0x5555555555555555ULL;
+                        sq[2 * w + h] = x;
+                    }
+                }
+                for (size_t i = 2 * degree; i-- > degree;)
+                    if (coefficient(sq, i))
+                        add_shifted(sq, P, i - degree);
+                for (size_t w = 0; w < words; w++)
+                    r[w] = sq[w];
+
+                // Multiplying by x is a shift
+                if ((e >> top) & 1)
+                {
+                    for (size_t w = words - 1; w > 0; w--)
+                        r[w] = (r[w] << 1) | (r[w - 1] >> 63);
+                    r[0] <<= 1;
+                    if (coefficient(r, degree))
+                        add_shifted(r, P, 0);
+                }
+            }
+            return r;
+        }
+
+        /// @brief Replaces the window of N consecutive words mt with the window e words further on
+        /// @param p x^e modulo the characteristic polynomial (see power_of_x)
+        /// @note The lower bits of the first word of the result are not determined by the recurrence
+        /// state and must not be used
+        template <typename W>
+        void jump(const Recurrence<W>& rec, W* mt, const Poly& p, size_t degree)
+        {
+            std::vector<W> c(mt, mt + rec.N), acc(rec.N, 0);
+            int i = 0;
+            for (size_t j = 0; j < degree; j++)
+            {
+                if (coefficient(p, j))
+                {
+                    for (int t = 0, k = i; t < rec.N; t++, k = (k + 1 == rec.N) ? 0 : k + 1)
+                        acc[t] ^= c[k];
+                }
+                rec.step(c.data(), i);
+            }
+            for (int t = 0; t < rec.N; t++)
+                mt[t] = acc[t];
+        }
+    }
+}
+
+#endif
+
+// src/Generators/MT/MT_simd.h
+
+/***SIMD KERNELS FOR THE MERSENNE TWISTER***/
+/*regenerates the state vector and tempers whole blocks
+several words at a time (AVX2, SSE2 or NEON, whichever is available),
+producing exactly the same words as the scalar algorithm*/
+
+#ifndef DF_MT_SIMD_H
+#define DF_MT_SIMD_H
+
+#include <cstddef>
+
+namespace DiceForge
+{
+    namespace MT_simd
+    {
+        /// @brief Regenerates all N words of the state vector mt (the "twist")
+        /// @note While k < N - M every new word depends only on old words, and afterwards on new words
+        /// at least N - M places behind, so runs of Lanes<W>::width words can be computed at once.
+        template <typename W>
+        void regenerate(W* mt, int N, int M, W A, W upperbits, W lowerbits)
+        {
+            int k = 0;
+#if defined(DF_SIMD)
+            typedef simd::Lanes<W> L;
+            const typename L::vec upper = L::set1(upperbits), lower = L::set1(lowerbits);
+            const typename L::vec a = L::set1(A), one = L::set1(1);
+
+            auto twist = [&](int k, int m)
+            {
+                typename L::vec y = L::bor(L::band(L::load(mt + k), upper), L::band(L::load(mt + k + 1), lower));
+                typename L::vec mag = L::band(L::neg(L::band(y, one)), a);
+                L::store(mt + k, L::bxor(L::bxor(L::load(mt + m), L::srl(y, 1)), mag));
+            };
+
+            for (; k + L::width <= N - M; k += L::width)
+                twist(k, k + M);
+#endif
+            W y;
+            for (; k < N - M; k++)
+            {
+                y = (mt[k] & upperbits) | (mt[k + 1] & lowerbits);
+                mt[k] = mt[k + M] ^ (y >> 1) ^ ((W(0) - (y & 1)) & A);
+            }
+#if defined(DF_SIMD)
+            for (; k + L::width <= N - 1; k += L::width)
+                twist(k, k + M - N);
+#endif
+            for (; k < N - 1; k++)
+            {
+                y = (mt[k] & upperbits) | (mt[k + 1] & lowerbits);
+                mt[k] = mt[k + M - N] ^ (y >> 1) ^ ((W(0) - (y & 1)) & A);
+            }
+
+            y = (mt[N - 1] & upperbits) | (mt[0] & lowerbits);
+            mt[N - 1] = mt[M - 1] ^ (y >> 1) ^ ((W(0) - (y & 1)) & A);
+        }
+
+        /// @brief Tempers n words of in and writes them to out
+        template <typename W>
+        void temper(const W* in, W* out, size_t n, int u, int s, W b, int t, W c, int l)
+        {
+            size_t i = 0;
+#if defined(DF_SIMD)
+            typedef simd::Lanes<W> L;
+            const typename L::vec B = L::set1(b), C = L::set1(c);
+            for (; i + L::width <= n; i += L::width)
+            {
+                typename L::vec y = L::load(in + i);
+                y = L::bxor(y, L::srl(y, u));
+                y = L::bxor(y, L::band(L::sll(y, s), B));
+                y = L::bxor(y, L::band(L::sll(y, t), C));
+                y = L::bxor(y, L::srl(y, l));
+                L::store(out + i, y);
+            }
+#endif
+            for (; i < n; i++)
+            {
+                W y = in[i];
+                y ^= (y >> u);
+                y ^= (y << s) & b;
+                y ^= (y << t) & c;
+                y ^= (y >> l);
+                out[i] = y;
+            }
+        }
+    }
+}
+
+#endif
+
+// src/Generators/Sobol/sobol_directions.h
+
+/***DIRECTION NUMBERS OF THE SOBOL SEQUENCE***/
+/*primitive polynomials over GF(2) and the initial direction numbers m_1 .. m_s of
+dimensions 2 to 1024, from S. Joe and F. Y. Kuo, "Constructing Sobol sequences with better
+two-dimensional projections", SIAM J. Sci. Comput. 30 (2008), file new-joe-kuo-6.21201.
+Dimension 1 is the van der Corput sequence (all m_k = 1).*/
+
+#ifndef DF_SOBOL_DIRECTIONS_H
+#define DF_SOBOL_DIRECTIONS_H
+
+namespace DiceForge
+{
+    namespace Sobol_directions
+    {
+        // Number of dimensions covered by the tables
+        constexpr unsigned dimensions = 1024;
+
+        // Polynomial of dimension j + 2 with its coefficients as bits, the leading and constant terms included
+        // (3 = x + 1, 7 = x^2 + x + 1, ...), so that its degree s is the position of the highest bit
+        constexpr unsigned short polynomials[1023] = {
+            3, 7, 11, 13, 19, 25, 37, 41, 47, 55, 59, 61,
+            67, 91, 97, 103, 109, 115, 131, 137, 143, 145, 157, 167,
+            171, 185, 191, 193, 203, 211, 213, 229, 239, 241, 247, 253,
+            285, 299, 301, 333, 351, 355, 357, 361, 369, 391, 397, 425,
+            451, 463, 487, 501, 529, 539, 545, 557, 563, 601, 607, 617,
+            623, 631, 637, 647, 661, 675, 677, 687, 695, 701, 719, 721,
+            731, 757, 761, 787, 789, 799, 803, 817, 827, 847, 859, 865,
+            875, 877, 883, 895, 901, 911, 949, 953, 967, 971, 973, 981,
+            985, 995, 1001, 1019, 1033, 1051, 1063, 1069, 1125, 1135, 1153, 1163,
+            1221, 1239, 1255, 1267, 1279, 1293, 1305, 1315, 1329, 1341, 1347, 1367,
+            1387, 1413, 1423, 1431, 1441, 1479, 1509, 1527, 1531, 1555, 1557, 1573,
+            1591, 1603, 1615, 1627, 1657, 1663, 1673, 1717, 1729, 1747, 1759, 1789,
+            1815, 1821, 1825, 1849, 1863, 1869, 1877, 1881, 1891, 1917, 1933, 1939,
+            1969, 2011, 2035, 2041, 2053, 2071, 2091, 2093, 2119, 2147, 2149, 2161,
+            2171, 2189, 2197, 2207, 2217, 2225, 2255, 2257, 2273, 2279, 2283, 2293,
+            2317, 2323, 2341, 2345, 2363, 2365, 2373, 2377, 2385, 2395, 2419, 2421,
+            2431, 2435, 2447, 2475, 2477, 2489, 2503, 2521, 2533, 2551, 2561, 2567,
+            2579, 2581, 2601, 2633, 2657, 2669, 2681, 2687, 2693, 2705, 2717, 2727,
+            2731, 2739, 2741, 2773, 2783, 2793, 2799, 2801, 2811, 2819, 2825, 2833,
+            2867, 2879, 2881, 2891, 2905, 2911, 2917, 2927, 2941, 2951, 2955, 2963,
+            2965, 2991, 2999, 3005, 3017, 3035, 3037, 3047, 3053, 3083, 3085, 3097,
+            3103, 3159, 3169, 3179, 3187, 3205, 3209, 3223, 3227, 3229, 3251, 3263,
+            3271, 3277, 3283, 3285, 3299, 3305, 3319, 3331, 3343, 3357, 3367, 3373,
+            3393, 3399, 3413, 3417, 3427, 3439, 3441, 3475, 3487, 3497, 3515, 3517,
+            3529, 3543, 3547, 3553, 3559, 3573, 3589, 3613, 3617, 3623, 3627, 3635,
+            3641, 3655, 3659, 3669, 3679, 3697, 3707, 3709, 3713, 3731, 3743, 3747,
+            3771, 3791, 3805, 3827, 3833, 3851, 3865, 3889, 3895, 3933, 3947, 3949,
+            3957, 3971, 3985, 3991, 3995, 4007, 4013, 4021, 4045, 4051, 4069, 4073,
+            4179, 4201, 4219, 4221, 4249, 4305, 4331, 4359, 4383, 4387, 4411, 4431,
+            4439, 4449, 4459, 4485, 4531, 4569, 4575, 4621, 4663, 4669, 4711, 4723,
+            4735, 4793, 4801, 4811, 4879, 4893, 4897, 4921, 4927, 4941, 4977, 5017,
+            5027, 5033, 5127, 5169, 5175, 5199, 5213, 5223, 5237, 5287, 5293, 5331,
+            5391, 5405, 5453, 5523, 5573, 5591, 5597, 5611, 5641, 5703, 5717, 5721,
+            5797, 5821, 5909, 5913, 5955, 5957, 6005, 6025, 6061, 6067, 6079, 6081,
+            6231, 6237, 6289, 6295, 6329, 6383, 6427, 6453, 6465, 6501, 6523, 6539,
+            6577, 6589, 6601, 6607, 6631, 6683, 6699, 6707, 6761, 6795, 6865, 6881,
+            6901, 6923, 6931, 6943, 6999, 7057, 7079, 7103, 7105, 7123, 7173, 7185,
+            7191, 7207, 7245, 7303, 7327, 7333, 7355, 7365, 7369, 7375, 7411, 7431,
+            7459, 7491, 7505, 7515, 7541, 7557, 7561, 7701, 7705, 7727, 7749, 7761,
+            7783, 7795, 7823, 7907, 7953, 7963, 7975, 8049, 8089, 8123, 8125, 8137,
+            8219, 8231, 8245, 8275, 8293, 8303, 8331, 8333, 8351, 8357, 8367, 8379,
+            8381, 8387, 8393, 8417, 8435, 8461, 8469, 8489, 8495, 8507, 8515, 8551,
+            8555, 8569, 8585, 8599, 8605, 8639, 8641, 8647, 8653, 8671, 8675, 8689,
+            8699, 8729, 8741, 8759, 8765, 8771, 8795, 8797, 8825, 8831, 8841, 8855,
+            8859, 8883, 8895, 8909, 8943, 8951, 8955, 8965, 8999, 9003, 9031, 9045,
+            9049, 9071, 9073, 9085, 9095, 9101, 9109, 9123, 9129, 9137, 9143, 9147,
+            9185, 9197, 9209, 9227, 9235, 9247, 9253, 9257, 9277, 9297, 9303, 9313,
+            9325, 9343, 9347, 9371, 9373, 9397, 9407, 9409, 9415, 9419, 9443, 9481,
+            9495, 9501, 9505, 9517, 9529, 9555, 9557, 9571, 9585, 9591, 9607, 9611,
+            9621, 9625, 9631, 9647, 9661, 9669, 9679, 9687, 9707, 9731, 9733, 9745,
+            9773, 9791, 9803, 9811, 9817, 9833, 9847, 9851, 9863, 9875, 9881, 9905,
+            9911, 9917, 9923, 9963, 9973, 10003, 10025, 10043, 10063, 10071, 10077, 10091,
+            10099, 10105, 10115, 10129, 10145, 10169, 10183, 10187, 10207, 10223, 10225, 10247,
+            10265, 10271, 10275, 10289, 10299, 10301, 10309, 10343, 10357, 10373, 10411, 10413,
+            10431, 10445, 10453, 10463, 10467, 10473, 10491, 10505, 10511, 10513, 10523, 10539,
+            10549, 10559, 10561, 10571, 10581, 10615, 10621, 10625, 10643, 10655, 10671, 10679,
+            10685, 10691, 10711, 10739, 10741, 10755, 10767, 10781, 10785, 10803, 10805, 10829,
+            10857, 10863, 10865, 10875, 10877, 10917, 10921, 10929, 10949, 10967, 10971, 10987,
+            10995, 11009, 11029, 11043, 11045, 11055, 11063, 11075, 11081, 11117, 11135, 11141,
+            11159, 11163, 11181, 11187, 11225, 11237, 11261, 11279, 11297, 11307, 11309, 11327,
+            11329, 11341, 11377, 11403, 11405, 11413, 11427, 11439, 11453, 11461, 11473, 11479,
+            11489, 11495, 11499, 11533, 11545, 11561, 11567, 11575, 11579, 11589, 11611, 11623,
+            11637, 11657, 11663, 11687, 11691, 11701, 11747, 11761, 11773, 11783, 11795, 11797,
+            11817, 11849, 11855, 11867, 11869, 11873, 11883, 11919, 11921, 11927, 11933, 11947,
+            11955, 11961, 11999, 12027, 12029, 12037, 12041, 12049, 12055, 12095, 12097, 12107,
+            12109, 12121, 12127, 12133, 12137, 12181, 12197, 12207, 12209, 12239, 12253, 12263,
+            12269, 12277, 12287, 12295, 12309, 12313, 12335, 12361, 12367, 12391, 12409, 12415,
+            12433, 12449, 12469, 12479, 12481, 12499, 12505, 12517, 12527, 12549, 12559, 12597,
+            12615, 12621, 12639, 12643, 12657, 12667, 12707, 12713, 12727, 12741, 12745, 12763,
+            12769, 12779, 12781, 12787, 12799, 12809, 12815, 12829, 12839, 12857, 12875, 12883,
+            12889, 12901, 12929, 12947, 12953, 12959, 12969, 12983, 12987, 12995, 13015, 13019,
+            13031, 13063, 13077, 13103, 13137, 13149, 13173, 13207, 13211, 13227, 13241, 13249,
+            13255, 13269, 13283, 13285, 13303, 13307, 13321, 13339, 13351, 13377, 13389, 13407,
+            13417, 13431, 13435, 13447, 13459, 13465, 13477, 13501, 13513, 13531, 13543, 13561,
+            13581, 13599, 13605, 13617, 13623, 13637, 13647, 13661, 13677, 13683, 13695, 13725,
+            13729, 13753, 13773, 13781, 13785, 13795, 13801, 13807, 13825, 13835, 13855, 13861,
+            13871, 13883, 13897, 13905, 13915, 13939, 13941, 13969, 13979, 13981, 13997, 14027,
+            14035, 14037, 14051, 14063, 14085, 14095, 14107, 14113, 14125, 14137, 14145, 14151,
+            14163, 14193, 14199, 14219, 14229, 14233, 14243, 14277, 14287, 14289, 14295, 14301,
+            14305, 14323, 14339, 14341, 14359, 14365, 14375, 14387, 14411, 14425, 14441, 14449,
+            14499, 14513, 14523, 14537, 14543, 14561, 14579, 14585, 14593, 14599, 14603, 14611,
+            14641, 14671, 14695, 14701, 14723, 14725, 14743, 14753, 14759, 14765, 14795, 14797,
+            14803, 14831, 14839, 14845, 14855, 14889, 14895, 14909, 14929, 14941, 14945, 14951,
+            14963, 14965, 14985, 15033, 15039, 15053, 15059, 15061, 15071, 15077, 15081, 15099,
+            15121, 15147, 15149, 15157, 15167, 15187, 15193, 15203, 15205, 15215, 15217, 15223,
+            15243, 15257, 15269
+        };
+
+        // m_1 .. m_s of every dimension in turn, s being the degree of its polynomial
+        constexpr unsigned short initial[12092] = {
+            1, 1, 3, 1, 3, 1, 1, 1, 1, 1, 1, 3, 3, 1, 3, 5,
+            13, 1, 1, 5, 5, 17, 1, 1, 5, 5, 5, 1, 1, 7, 11, 19,
+            1, 1, 5, 1, 1, 1, 1, 1, 3, 11, 1, 3, 5, 5, 31, 1,
+            3, 3, 9, 7, 49, 1, 1, 1, 15, 21, 21, 1, 3, 1, 13, 27,
+            49, 1, 1, 1, 15, 7, 5, 1, 3, 1, 15, 13, 25, 1, 1, 5,
+            5, 19, 61, 1, 3, 7, 11, 23, 15, 103, 1, 3, 7, 13, 13, 15,
+            69, 1, 1, 3, 13, 7, 35, 63, 1, 3, 5, 9, 1, 25, 53, 1,
+            3, 1, 13, 9, 35, 107, 1, 3, 1, 5, 27, 61, 31, 1, 1, 5,
+            11, 19, 41, 61, 1, 3, 5, 3, 3, 13, 69, 1, 1, 7, 13, 1,
+            19, 1, 1, 3, 7, 5, 13, 19, 59, 1, 1, 3, 9, 25, 29, 41,
+            1, 3, 5, 13, 23, 1, 55, 1, 3, 7, 3, 13, 59, 17, 1, 3,
+            1, 3, 5, 53, 69, 1, 1, 5, 5, 23, 33, 13, 1, 1, 7, 7,
+            1, 61, 123, 1, 1, 7, 9, 13, 61, 49, 1, 3, 3, 5, 3, 55,
+            33, 1, 3, 1, 15, 31, 13, 49, 245, 1, 3, 5, 15, 31, 59, 63,
+            97, 1, 3, 1, 11, 11, 11, 77, 249, 1, 3, 1, 11, 27, 43, 71,
+            9, 1, 1, 7, 15, 21, 11, 81, 45, 1, 3, 7, 3, 25, 31, 65,
+            79, 1, 3, 1, 1, 19, 11, 3, 205, 1, 1, 5, 9, 19, 21, 29,
+            157, 1, 3, 7, 11, 1, 33, 89, 185, 1, 3, 3, 3, 15, 9, 79,
+            71, 1, 3, 7, 11, 15, 39, 119, 27, 1, 1, 3, 1, 11, 31, 97,
+            225, 1, 1, 1, 3, 23, 43, 57, 177, 1, 3, 7, 7, 17, 17, 37,
+            71, 1, 3, 1, 5, 27, 63, 123, 213, 1, 1, 3, 5, 11, 43, 53,
+            133, 1, 3, 5, 5, 29, 17, 47, 173, 479, 1, 3, 3, 11, 3, 1,
+            109, 9, 69, 1, 1, 1, 5, 17, 39, 23, 5, 343, 1, 3, 1, 5,
+            25, 15, 31, 103, 499, 1, 1, 1, 11, 11, 17, 63, 105, 183, 1, 1,
+            5, 11, 9, 29, 97, 231, 363, 1, 1, 5, 15, 19, 45, 41, 7, 383,
+            1, 3, 7, 7, 31, 19, 83, 137, 221, 1, 1, 1, 3, 23, 15, 111,
+            223, 83, 1, 1, 5, 13, 31, 15, 55, 25, 161, 1, 1, 3, 13, 25,
+            47, 39, 87, 257, 1, 1, 1, 11, 21, 53, 125, 249, 293, 1, 1, 7,
+            11, 11, 7, 57, 79, 323, 1, 1, 5, 5, 17, 13, 81, 3, 131, 1,
+            1, 7, 13, 23, 7, 65, 251, 475, 1, 3, 5, 1, 9, 43, 3, 149,
+            11, 1, 1, 3, 13, 31, 13, 13, 255, 487, 1, 3, 3, 1, 5, 63,
+            89, 91, 127, 1, 1, 3, 3, 1, 19, 123, 127, 237, 1, 1, 5, 7,
+            23, 31, 37, 243, 289, 1, 1, 5, 11, 17, 53, 117, 183, 491, 1, 1,
+            1, 5, 1, 13, 13, 209, 345, 1, 1, 3, 15, 1, 57, 115, 7, 33,
+            1, 3, 1, 11, 7, 43, 81, 207, 175, 1, 3, 1, 1, 15, 27, 63,
+            255, 49, 1, 3, 5, 3, 27, 61, 105, 171, 305, 1, 1, 5, 3, 1,
+            3, 57, 249, 149, 1, 1, 3, 5, 5, 57, 15, 13, 159, 1, 1, 1,
+            11, 7, 11, 105, 141, 225, 1, 3, 3, 5, 27, 59, 121, 101, 271, 1,
+            3, 5, 9, 11, 49, 51, 59, 115, 1, 1, 7, 1, 23, 45, 125, 71,
+            419, 1, 1, 3, 5, 23, 5, 105, 109, 75, 1, 1, 7, 15, 7, 11,
+            67, 121, 453, 1, 3, 7, 3, 9, 13, 31, 27, 449, 1, 3, 1, 15,
+            19, 39, 39, 89, 15, 1, 1, 1, 1, 1, 33, 73, 145, 379, 1, 3,
+            1, 15, 15, 43, 29, 13, 483, 1, 1, 7, 3, 19, 27, 85, 131, 431,
+            1, 3, 3, 3, 5, 35, 23, 195, 349, 1, 3, 3, 7, 9, 27, 39,
+            59, 297, 1, 1, 3, 9, 11, 17, 13, 241, 157, 1, 3, 7, 15, 25,
+            57, 33, 189, 213, 1, 1, 7, 1, 9, 55, 73, 83, 217, 1, 3, 3,
+            13, 19, 27, 23, 113, 249, 1, 3, 5, 3, 23, 43, 3, 253, 479, 1,
+            1, 5, 5, 11, 5, 45, 117, 217, 1, 3, 3, 7, 29, 37, 33, 123,
+            147, 1, 3, 1, 15, 5, 5, 37, 227, 223, 459, 1, 1, 7, 5, 5,
+            39, 63, 255, 135, 487, 1, 3, 1, 7, 9, 7, 87, 249, 217, 599, 1,
+            1, 3, 13, 9, 47, 7, 225, 363, 247, 1, 3, 7, 13, 19, 13, 9,
+            67, 9, 737, 1, 3, 5, 5, 19, 59, 7, 41, 319, 677, 1, 1, 5,
+            3, 31, 63, 15, 43, 207, 789, 1, 1, 7, 9, 13, 39, 3, 47, 497,
+            169, 1, 3, 1, 7, 21, 17, 97, 19, 415, 905, 1, 3, 7, 1, 3,
+            31, 71, 111, 165, 127, 1, 1, 5, 11, 1, 61, 83, 119, 203, 847, 1,
+            3, 3, 13, 9, 61, 19, 97, 47, 35, 1, 1, 7, 7, 15, 29, 63,
+            95, 417, 469, 1, 3, 1, 9, 25, 9, 71, 57, 213, 385, 1, 3, 5,
+            13, 31, 47, 101, 57, 39, 341, 1, 1, 3, 3, 31, 57, 125, 173, 365,
+            551, 1, 3, 7, 1, 13, 57, 67, 157, 451, 707, 1, 1, 1, 7, 21,
+            13, 105, 89, 429, 965, 1, 1, 5, 9, 17, 51, 45, 119, 157, 141, 1,
+            3, 7, 7, 13, 45, 91, 9, 129, 741, 1, 3, 7, 1, 23, 57, 67,
+            141, 151, 571, 1, 1, 3, 11, 17, 47, 93, 107, 375, 157, 1, 3, 3,
+            5, 11, 21, 43, 51, 169, 915, 1, 1, 5, 3, 15, 55, 101, 67, 455,
+            625, 1, 3, 5, 9, 1, 23, 29, 47, 345, 595, 1, 3, 7, 7, 5,
+            49, 29, 155, 323, 589, 1, 3, 3, 7, 5, 41, 127, 61, 261, 717, 1,
+            3, 7, 7, 17, 23, 117, 67, 129, 1009, 1, 1, 3, 13, 11, 39, 21,
+            207, 123, 305, 1, 1, 3, 9, 29, 3, 95, 47, 231, 73, 1, 3, 1,
+            9, 1, 29, 117, 21, 441, 259, 1, 3, 1, 13, 21, 39, 125, 211, 439,
+            723, 1, 1, 7, 3, 17, 63, 115, 89, 49, 773, 1, 3, 7, 13, 11,
+            33, 101, 107, 63, 73, 1, 1, 5, 5, 13, 57, 63, 135, 437, 177, 1,
+            1, 3, 7, 27, 63, 93, 47, 417, 483, 1, 1, 3, 1, 23, 29, 1,
+            191, 49, 23, 1, 1, 3, 15, 25, 55, 9, 101, 219, 607, 1, 3, 1,
+            7, 7, 19, 51, 251, 393, 307, 1, 3, 3, 3, 25, 55, 17, 75, 337,
+            3, 1, 1, 1, 13, 25, 17, 65, 45, 479, 413, 1, 1, 7, 7, 27,
+            49, 99, 161, 213, 727, 1, 3, 5, 1, 23, 5, 43, 41, 251, 857, 1,
+            3, 3, 7, 11, 61, 39, 87, 383, 835, 1, 1, 3, 15, 13, 7, 29,
+            7, 505, 923, 1, 3, 7, 1, 5, 31, 47, 157, 445, 501, 1, 1, 3,
+            7, 1, 43, 9, 147, 115, 605, 1, 3, 3, 13, 5, 1, 119, 211, 455,
+            1001, 1, 1, 3, 5, 13, 19, 3, 243, 75, 843, 1, 3, 7, 7, 1,
+            19, 91, 249, 357, 589, 1, 1, 1, 9, 1, 25, 109, 197, 279, 411, 1,
+            3, 1, 15, 23, 57, 59, 135, 191, 75, 1, 1, 5, 15, 29, 21, 39,
+            253, 383, 349, 1, 3, 3, 5, 19, 45, 61, 151, 199, 981, 1, 3, 5,
+            13, 9, 61, 107, 141, 141, 1, 1, 3, 1, 11, 27, 25, 85, 105, 309,
+            979, 1, 3, 3, 11, 19, 7, 115, 223, 349, 43, 1, 1, 7, 9, 21,
+            39, 123, 21, 275, 927, 1, 1, 7, 13, 15, 41, 47, 243, 303, 437, 1,
+            1, 1, 7, 7, 3, 15, 99, 409, 719, 1, 3, 3, 15, 27, 49, 113,
+            123, 113, 67, 469, 1, 3, 7, 11, 3, 23, 87, 169, 119, 483, 199, 1,
+            1, 5, 15, 7, 17, 109, 229, 179, 213, 741, 1, 1, 5, 13, 11, 17,
+            25, 135, 403, 557, 1433, 1, 3, 1, 1, 1, 61, 67, 215, 189, 945, 1243,
+            1, 1, 7, 13, 17, 33, 9, 221, 429, 217, 1679, 1, 1, 3, 11, 27,
+            3, 15, 93, 93, 865, 1049, 1, 3, 7, 7, 25, 41, 121, 35, 373, 379,
+            1547, 1, 3, 3, 9, 11, 35, 45, 205, 241, 9, 59, 1, 3, 1, 7,
+            3, 51, 7, 177, 53, 975, 89, 1, 1, 3, 5, 27, 1, 113, 231, 299,
+            759, 861, 1, 3, 3, 15, 25, 29, 5, 255, 139, 891, 2031, 1, 3, 1,
+            1, 13, 9, 109, 193, 419, 95, 17, 1, 1, 7, 9, 3, 7, 29, 41,
+            135, 839, 867, 1, 1, 7, 9, 25, 49, 123, 217, 113, 909, 215, 1, 1,
+            7, 3, 23, 15, 43, 133, 217, 327, 901, 1, 1, 3, 3, 13, 53, 63,
+            123, 477, 711, 1387, 1, 1, 3, 15, 7, 29, 75, 119, 181, 957, 247, 1,
+            1, 1, 11, 27, 25, 109, 151, 267, 99, 1461, 1, 3, 7, 15, 5, 5,
+            53, 145, 11, 725, 1501, 1, 3, 7, 1, 9, 43, 71, 229, 157, 607, 1835,
+            1, 3, 3, 13, 25, 1, 5, 27, 471, 349, 127, 1, 1, 1, 1, 23,
+            37, 9, 221, 269, 897, 1685, 1, 1, 3, 3, 31, 29, 51, 19, 311, 553,
+            1969, 1, 3, 7, 5, 5, 55, 17, 39, 475, 671, 1529, 1, 1, 7, 1,
+            1, 35, 47, 27, 437, 395, 1635, 1, 1, 7, 3, 13, 23, 43, 135, 327,
+            139, 389, 1, 3, 7, 3, 9, 25, 91, 25, 429, 219, 513, 1, 1, 3,
+            5, 13, 29, 119, 201, 277, 157, 2043, 1, 3, 5, 3, 29, 57, 13, 17,
+            167, 739, 1031, 1, 3, 3, 5, 29, 21, 95, 27, 255, 679, 1531, 1, 3,
+            7, 15, 9, 5, 21, 71, 61, 961, 1201, 1, 3, 5, 13, 15, 57, 33,
+            93, 459, 867, 223, 1, 1, 1, 15, 17, 43, 127, 191, 67, 177, 1073, 1,
+            1, 1, 15, 23, 7, 21, 199, 75, 293, 1611, 1, 3, 7, 13, 15, 39,
+            21, 149, 65, 741, 319, 1, 3, 7, 11, 23, 13, 101, 89, 277, 519, 711,
+            1, 3, 7, 15, 19, 27, 85, 203, 441, 97, 1895, 1, 3, 1, 3, 29,
+            25, 21, 155, 11, 191, 197, 1, 1, 7, 5, 27, 11, 81, 101, 457, 675,
+            1687, 1, 3, 1, 5, 25, 5, 65, 193, 41, 567, 781, 1, 3, 1, 5,
+            11, 15, 113, 77, 411, 695, 1111, 1, 1, 3, 9, 11, 53, 119, 171, 55,
+            297, 509, 1, 1, 1, 1, 11, 39, 113, 139, 165, 347, 595, 1, 3, 7,
+            11, 9, 17, 101, 13, 81, 325, 1733, 1, 3, 1, 1, 21, 43, 115, 9,
+            113, 907, 645, 1, 1, 7, 3, 9, 25, 117, 197, 159, 471, 475, 1, 3,
+            1, 9, 11, 21, 57, 207, 485, 613, 1661, 1, 1, 7, 7, 27, 55, 49,
+            223, 89, 85, 1523, 1, 1, 5, 3, 19, 41, 45, 51, 447, 299, 1355, 1,
+            3, 1, 13, 1, 33, 117, 143, 313, 187, 1073, 1, 1, 7, 7, 5, 11,
+            65, 97, 377, 377, 1501, 1, 3, 1, 1, 21, 35, 95, 65, 99, 23, 1239,
+            1, 1, 5, 9, 3, 37, 95, 167, 115, 425, 867, 1, 3, 3, 13, 1,
+            37, 27, 189, 81, 679, 773, 1, 1, 3, 11, 1, 61, 99, 233, 429, 969,
+            49, 1, 1, 1, 7, 25, 63, 99, 165, 245, 793, 1143, 1, 1, 5, 11,
+            11, 43, 55, 65, 71, 283, 273, 1, 1, 5, 5, 9, 3, 101, 251, 355,
+            379, 1611, 1, 1, 1, 15, 21, 63, 85, 99, 49, 749, 1335, 1, 1, 5,
+            13, 27, 9, 121, 43, 255, 715, 289, 1, 3, 1, 5, 27, 19, 17, 223,
+            77, 571, 1415, 1, 1, 5, 3, 13, 59, 125, 251, 195, 551, 1737, 1, 3,
+            3, 15, 13, 27, 49, 105, 389, 971, 755, 1, 3, 5, 15, 23, 43, 35,
+            107, 447, 763, 253, 1, 3, 5, 11, 21, 3, 17, 39, 497, 407, 611, 1,
+            1, 7, 13, 15, 31, 113, 17, 23, 507, 1995, 1, 1, 7, 15, 3, 15,
+            31, 153, 423, 79, 503, 1, 1, 7, 9, 19, 25, 23, 171, 505, 923, 1989,
+            1, 1, 5, 9, 21, 27, 121, 223, 133, 87, 697, 1, 1, 5, 5, 9,
+            19, 107, 99, 319, 765, 1461, 1, 1, 3, 3, 19, 25, 3, 101, 171, 729,
+            187, 1, 1, 3, 1, 13, 23, 85, 93, 291, 209, 37, 1, 1, 1, 15,
+            25, 25, 77, 253, 333, 947, 1073, 1, 1, 3, 9, 17, 29, 55, 47, 255,
+            305, 2037, 1, 3, 3, 9, 29, 63, 9, 103, 489, 939, 1523, 1, 3, 7,
+            15, 7, 31, 89, 175, 369, 339, 595, 1, 3, 7, 13, 25, 5, 71, 207,
+            251, 367, 665, 1, 3, 3, 3, 21, 25, 75, 35, 31, 321, 1603, 1, 1,
+            1, 9, 11, 1, 65, 5, 11, 329, 535, 1, 1, 5, 3, 19, 13, 17,
+            43, 379, 485, 383, 1, 3, 5, 13, 13, 9, 85, 147, 489, 787, 1133, 1,
+            3, 1, 1, 5, 51, 37, 129, 195, 297, 1783, 1, 1, 3, 15, 19, 57,
+            59, 181, 455, 697, 2033, 1, 3, 7, 1, 27, 9, 65, 145, 325, 189, 201,
+            1, 3, 1, 15, 31, 23, 19, 5, 485, 581, 539, 1, 1, 7, 13, 11,
+            15, 65, 83, 185, 847, 831, 1, 3, 5, 7, 7, 55, 73, 15, 303, 511,
+            1905, 1, 3, 5, 9, 7, 21, 45, 15, 397, 385, 597, 1, 3, 7, 3,
+            23, 13, 73, 221, 511, 883, 1265, 1, 1, 3, 11, 1, 51, 73, 185, 33,
+            975, 1441, 1, 3, 3, 9, 19, 59, 21, 39, 339, 37, 143, 1, 1, 7,
+            1, 31, 33, 19, 167, 117, 635, 639, 1, 1, 1, 3, 5, 13, 59, 83,
+            355, 349, 1967, 1, 1, 1, 5, 19, 3, 53, 133, 97, 863, 983, 1, 3,
+            1, 13, 9, 41, 91, 105, 173, 97, 625, 1, 1, 5, 3, 7, 49, 115,
+            133, 71, 231, 1063, 1, 1, 7, 5, 17, 43, 47, 45, 497, 547, 757, 1,
+            3, 5, 15, 21, 61, 123, 191, 249, 31, 631, 1, 3, 7, 9, 17, 7,
+            11, 185, 127, 169, 1951, 1, 1, 5, 13, 11, 11, 9, 49, 29, 125, 791,
+            1, 1, 1, 15, 31, 41, 13, 167, 273, 429, 57, 1, 3, 5, 3, 27,
+            7, 35, 209, 65, 265, 1393, 1, 3, 1, 13, 31, 19, 53, 143, 135, 9,
+            1021, 1, 1, 7, 13, 31, 5, 115, 153, 143, 957, 623, 1, 1, 5, 11,
+            25, 19, 29, 31, 297, 943, 443, 1, 3, 3, 5, 21, 11, 127, 81, 479,
+            25, 699, 1, 1, 3, 11, 25, 31, 97, 19, 195, 781, 705, 1, 1, 5,
+            5, 31, 11, 75, 207, 197, 885, 2037, 1, 1, 1, 11, 9, 23, 29, 231,
+            307, 17, 1497, 1, 1, 5, 11, 11, 43, 111, 233, 307, 523, 1259, 1, 1,
+            7, 5, 1, 21, 107, 229, 343, 933, 217, 1, 1, 1, 11, 3, 21, 125,
+            131, 405, 599, 1469, 1, 3, 5, 5, 9, 39, 33, 81, 389, 151, 811, 1,
+            1, 7, 7, 7, 1, 59, 223, 265, 529, 2021, 1, 3, 1, 3, 9, 23,
+            85, 181, 47, 265, 49, 1, 3, 5, 11, 19, 23, 9, 7, 157, 299, 1983,
+            1, 3, 1, 5, 15, 5, 21, 105, 29, 339, 1041, 1, 1, 1, 1, 5,
+            33, 65, 85, 111, 705, 479, 1, 1, 1, 7, 9, 35, 77, 87, 151, 321,
+            101, 1, 1, 5, 7, 17, 1, 51, 197, 175, 811, 1229, 1, 3, 3, 15,
+            23, 37, 85, 185, 239, 543, 731, 1, 3, 1, 7, 7, 55, 111, 109, 289,
+            439, 243, 1, 1, 7, 11, 17, 53, 35, 217, 259, 853, 1667, 1, 3, 1,
+            9, 1, 63, 87, 17, 73, 565, 1091, 1, 1, 3, 3, 11, 41, 1, 57,
+            295, 263, 1029, 1, 1, 5, 1, 27, 45, 109, 161, 411, 421, 1395, 1, 3,
+            5, 11, 25, 35, 47, 191, 339, 417, 1727, 1, 1, 5, 15, 21, 1, 93,
+            251, 351, 217, 1767, 1, 3, 3, 11, 3, 7, 75, 155, 313, 211, 491, 1,
+            3, 3, 5, 11, 9, 101, 161, 453, 913, 1067, 1, 1, 3, 1, 15, 45,
+            127, 141, 163, 727, 1597, 1, 3, 3, 7, 1, 33, 63, 73, 73, 341, 1691,
+            1, 3, 5, 13, 15, 39, 53, 235, 77, 99, 949, 1, 1, 5, 13, 31,
+            17, 97, 13, 215, 301, 1927, 1, 1, 7, 1, 1, 37, 91, 93, 441, 251,
+            1131, 1, 3, 7, 9, 25, 5, 105, 69, 81, 943, 1459, 1, 3, 7, 11,
+            31, 43, 13, 209, 27, 1017, 501, 1, 1, 7, 15, 1, 33, 31, 233, 161,
+            507, 387, 1, 3, 3, 5, 5, 53, 33, 177, 503, 627, 1927, 1, 1, 7,
+            11, 7, 61, 119, 31, 457, 229, 1875, 1, 1, 5, 15, 19, 5, 53, 201,
+            157, 885, 1057, 1, 3, 7, 9, 1, 35, 51, 113, 249, 425, 1009, 1, 3,
+            5, 7, 21, 53, 37, 155, 119, 345, 631, 1, 3, 5, 7, 15, 31, 109,
+            69, 503, 595, 1879, 1, 3, 3, 1, 25, 35, 65, 131, 403, 705, 503, 1,
+            3, 7, 7, 19, 33, 11, 153, 45, 633, 499, 1, 3, 3, 5, 11, 3,
+            29, 93, 487, 33, 703, 1, 1, 3, 15, 21, 53, 107, 179, 387, 927, 1757,
+            1, 1, 3, 7, 21, 45, 51, 147, 175, 317, 361, 1, 1, 1, 7, 7,
+            13, 15, 243, 269, 795, 1965, 1, 1, 3, 5, 19, 33, 57, 115, 443, 537,
+            627, 1, 3, 3, 9, 3, 39, 25, 61, 185, 717, 1049, 1, 3, 7, 3,
+            7, 37, 107, 153, 7, 269, 1581, 1, 1, 7, 3, 7, 41, 91, 41, 145,
+            489, 1245, 1, 1, 5, 9, 7, 7, 105, 81, 403, 407, 283, 1, 1, 7,
+            9, 27, 55, 29, 77, 193, 963, 949, 1, 1, 5, 3, 25, 51, 107, 63,
+            403, 917, 815, 1, 1, 7, 3, 7, 61, 19, 51, 457, 599, 535, 1, 3,
+            7, 1, 23, 51, 105, 153, 239, 215, 1847, 1, 1, 3, 5, 27, 23, 79,
+            49, 495, 45, 1935, 1, 1, 1, 11, 11, 47, 55, 133, 495, 999, 1461, 1,
+            1, 3, 15, 27, 51, 93, 17, 355, 763, 1675, 1, 3, 1, 3, 1, 3,
+            79, 119, 499, 17, 995, 1, 1, 1, 1, 15, 43, 45, 17, 167, 973, 799,
+            1, 1, 1, 3, 27, 49, 89, 29, 483, 913, 2023, 1, 1, 3, 3, 5,
+            11, 75, 7, 41, 851, 611, 1, 3, 1, 3, 7, 57, 39, 123, 257, 283,
+            507, 1, 3, 3, 11, 27, 23, 113, 229, 187, 299, 133, 1, 1, 3, 13,
+            9, 63, 101, 77, 451, 169, 337, 1, 3, 7, 3, 3, 59, 45, 195, 229,
+            415, 409, 1, 3, 5, 3, 11, 19, 71, 93, 43, 857, 369, 1, 3, 7,
+            9, 19, 33, 115, 19, 241, 703, 247, 1, 3, 5, 11, 5, 35, 21, 155,
+            463, 1005, 1073, 1, 3, 7, 3, 25, 15, 109, 83, 93, 69, 1189, 1, 3,
+            5, 7, 5, 21, 93, 133, 135, 167, 903, 1, 1, 7, 7, 3, 59, 121,
+            161, 285, 815, 1769, 3705, 1, 3, 1, 1, 3, 47, 103, 171, 381, 609, 185,
+            373, 1, 3, 3, 15, 23, 33, 107, 131, 441, 445, 689, 2059, 1, 3, 3,
+            11, 7, 53, 101, 167, 435, 803, 1255, 3781, 1, 1, 5, 11, 15, 59, 41,
+            19, 135, 835, 1263, 505, 1, 1, 7, 11, 21, 49, 23, 219, 127, 961, 1065,
+            385, 1, 3, 5, 15, 7, 47, 117, 217, 45, 731, 1639, 733, 1, 1, 7,
+            11, 27, 57, 91, 87, 81, 35, 1269, 1007, 1, 1, 3, 11, 15, 37, 53,
+            219, 193, 937, 1899, 3733, 1, 3, 5, 3, 13, 11, 27, 19, 199, 393, 965,
+            2195, 1, 3, 1, 3, 5, 1, 37, 173, 413, 1023, 553, 409, 1, 3, 1,
+            7, 15, 29, 123, 95, 255, 373, 1799, 3841, 1, 3, 5, 13, 21, 57, 51,
+            17, 511, 195, 1157, 1831, 1, 1, 1, 15, 29, 19, 7, 73, 295, 519, 587,
+            3523, 1, 1, 5, 13, 13, 35, 115, 191, 123, 535, 717, 1661, 1, 3, 3,
+            5, 23, 21, 47, 251, 379, 921, 1119, 297, 1, 3, 3, 9, 29, 53, 121,
+            201, 135, 193, 523, 2943, 1, 1, 1, 7, 29, 45, 125, 9, 99, 867, 425,
+            601, 1, 3, 1, 9, 13, 15, 67, 181, 109, 293, 1305, 3079, 1, 3, 3,
+            9, 5, 35, 15, 209, 305, 87, 767, 2795, 1, 3, 3, 11, 27, 57, 113,
+            123, 179, 643, 149, 523, 1, 1, 3, 15, 11, 17, 67, 223, 63, 657, 335,
+            3309, 1, 1, 1, 9, 25, 29, 109, 159, 39, 513, 571, 1761, 1, 1, 3,
+            1, 5, 63, 75, 19, 455, 601, 123, 691, 1, 1, 1, 3, 21, 5, 45,
+            169, 377, 513, 1951, 2565, 1, 1, 3, 11, 3, 33, 119, 69, 253, 907, 805,
+            1449, 1, 1, 5, 13, 31, 15, 17, 7, 499, 61, 687, 1867, 1, 3, 7,
+            11, 17, 33, 73, 77, 299, 243, 641, 2345, 1, 1, 7, 11, 9, 35, 31,
+            235, 359, 647, 379, 1161, 1, 3, 3, 15, 31, 25, 5, 67, 33, 45, 437,
+            4067, 1, 1, 3, 11, 7, 17, 37, 87, 333, 253, 1517, 2921, 1, 1, 7,
+            15, 7, 15, 107, 189, 153, 769, 1521, 3427, 1, 3, 5, 13, 5, 61, 113,
+            37, 293, 393, 113, 43, 1, 1, 1, 15, 29, 43, 107, 31, 167, 147, 301,
+            1021, 1, 1, 1, 13, 3, 1, 35, 93, 195, 181, 2027, 1491, 1, 3, 3,
+            3, 13, 33, 77, 199, 153, 221, 1699, 3671, 1, 3, 5, 13, 7, 49, 123,
+            155, 495, 681, 819, 809, 1, 3, 5, 15, 27, 61, 117, 189, 183, 887, 617,
+            4053, 1, 1, 1, 7, 31, 59, 125, 235, 389, 369, 447, 1039, 1, 3, 5,
+            1, 5, 39, 115, 89, 249, 377, 431, 3747, 1, 1, 1, 5, 7, 47, 59,
+            157, 77, 445, 699, 3439, 1, 1, 3, 5, 11, 21, 19, 75, 11, 599, 1575,
+            735, 1, 3, 5, 3, 19, 13, 41, 69, 199, 143, 1761, 3215, 1, 3, 5,
+            7, 19, 43, 25, 41, 41, 11, 1647, 2783, 1, 3, 1, 9, 19, 45, 111,
+            97, 405, 399, 457, 3219, 1, 1, 3, 1, 23, 15, 65, 121, 59, 985, 829,
+            2259, 1, 1, 3, 7, 17, 13, 107, 229, 75, 551, 1299, 2363, 1, 1, 5,
+            5, 21, 57, 23, 199, 509, 139, 2007, 3875, 1, 3, 1, 11, 19, 53, 15,
+            229, 215, 741, 695, 823, 1, 3, 7, 1, 29, 3, 17, 163, 417, 559, 549,
+            319, 1, 3, 1, 13, 17, 9, 47, 133, 365, 7, 1937, 1071, 1, 3, 5,
+            7, 19, 37, 55, 163, 301, 249, 689, 2327, 1, 3, 5, 13, 11, 23, 61,
+            205, 257, 377, 615, 1457, 1, 3, 5, 1, 23, 37, 13, 75, 331, 495, 579,
+            3367, 1, 1, 1, 9, 1, 23, 49, 129, 475, 543, 883, 2531, 1, 3, 1,
+            5, 23, 59, 51, 35, 343, 695, 219, 369, 1, 3, 3, 1, 27, 17, 63,
+            97, 71, 507, 1929, 613, 1, 1, 5, 1, 21, 31, 11, 109, 247, 409, 1817,
+            2173, 1, 1, 3, 15, 23, 9, 7, 209, 301, 23, 147, 1691, 1, 1, 7,
+            5, 5, 19, 37, 229, 249, 277, 1115, 2309, 1, 1, 1, 5, 5, 63, 5,
+            249, 285, 431, 343, 2467, 1, 1, 1, 11, 7, 45, 35, 75, 505, 537, 29,
+            2919, 1, 3, 5, 15, 11, 39, 15, 63, 263, 9, 199, 445, 1, 3, 3,
+            3, 27, 63, 53, 171, 227, 63, 1049, 827, 1, 1, 3, 13, 7, 11, 115,
+            183, 179, 937, 1785, 381, 1, 3, 1, 11, 13, 15, 107, 81, 53, 295, 1785,
+            3757, 1, 3, 3, 13, 11, 5, 109, 243, 3, 505, 323, 1373, 1, 3, 3,
+            11, 21, 51, 17, 177, 381, 937, 1263, 3889, 1, 3, 5, 9, 27, 25, 85,
+            193, 143, 573, 1189, 2995, 1, 3, 5, 11, 13, 9, 81, 21, 159, 953, 91,
+            1751, 1, 1, 3, 3, 27, 61, 11, 253, 391, 333, 1105, 635, 1, 3, 3,
+            15, 9, 57, 95, 81, 419, 735, 251, 1141, 1, 1, 5, 9, 31, 39, 59,
+            13, 319, 807, 1241, 2433, 1, 3, 3, 5, 27, 13, 107, 141, 423, 937, 2027,
+            3233, 1, 3, 3, 9, 9, 25, 125, 23, 443, 835, 1245, 847, 1, 1, 7,
+            15, 17, 17, 83, 107, 411, 285, 847, 1571, 1, 1, 3, 13, 29, 61, 37,
+            81, 349, 727, 1453, 1957, 1, 3, 7, 11, 31, 13, 59, 77, 273, 591, 1265,
+            1533, 1, 1, 7, 7, 13, 17, 25, 25, 187, 329, 347, 1473, 1, 3, 7,
+            7, 5, 51, 37, 99, 221, 153, 503, 2583, 1, 3, 1, 13, 19, 27, 11,
+            69, 181, 479, 1183, 3229, 1, 3, 3, 13, 23, 21, 103, 147, 323, 909, 947,
+            315, 1, 3, 1, 3, 23, 1, 31, 59, 93, 513, 45, 2271, 1, 3, 5,
+            1, 7, 43, 109, 59, 231, 41, 1515, 2385, 1, 3, 1, 5, 31, 57, 49,
+            223, 283, 1013, 11, 701, 1, 1, 5, 1, 19, 53, 55, 31, 31, 299, 495,
+            693, 1, 3, 3, 9, 5, 33, 77, 253, 427, 791, 731, 1019, 1, 3, 7,
+            11, 1, 9, 119, 203, 53, 877, 1707, 3499, 1, 1, 3, 7, 13, 39, 55,
+            159, 423, 113, 1653, 3455, 1, 1, 3, 5, 21, 47, 51, 59, 55, 411, 931,
+            251, 1, 3, 7, 3, 31, 25, 81, 115, 405, 239, 741, 455, 1, 1, 5,
+            1, 31, 3, 101, 83, 479, 491, 1779, 2225, 1, 3, 3, 3, 9, 37, 107,
+            161, 203, 503, 767, 3435, 1, 3, 7, 9, 1, 27, 61, 119, 233, 39, 1375,
+            4089, 1, 1, 5, 9, 1, 31, 45, 51, 369, 587, 383, 2813, 1, 3, 7,
+            5, 31, 7, 49, 119, 487, 591, 1627, 53, 1, 1, 7, 1, 9, 47, 1,
+            223, 369, 711, 1603, 1917, 1, 3, 5, 3, 21, 37, 111, 17, 483, 739, 1193,
+            2775, 1, 3, 3, 7, 17, 11, 51, 117, 455, 191, 1493, 3821, 1, 1, 5,
+            9, 23, 39, 99, 181, 343, 485, 99, 1931, 1, 3, 1, 7, 29, 49, 31,
+            71, 489, 527, 1763, 2909, 1, 1, 5, 11, 5, 5, 73, 189, 321, 57, 1191,
+            3685, 1, 1, 5, 15, 13, 45, 125, 207, 371, 415, 315, 983, 1, 3, 3,
+            5, 25, 59, 33, 31, 239, 919, 1859, 2709, 1, 3, 5, 13, 27, 61, 23,
+            115, 61, 413, 1275, 3559, 1, 3, 7, 15, 5, 59, 101, 81, 47, 967, 809,
+            3189, 1, 1, 5, 11, 31, 15, 39, 25, 173, 505, 809, 2677, 1, 1, 5,
+            9, 19, 13, 95, 89, 511, 127, 1395, 2935, 1, 1, 5, 5, 31, 45, 9,
+            57, 91, 303, 1295, 3215, 1, 3, 3, 3, 19, 15, 113, 187, 217, 489, 1285,
+            1803, 1, 1, 3, 1, 13, 29, 57, 139, 255, 197, 537, 2183, 1, 3, 1,
+            15, 11, 7, 53, 255, 467, 9, 757, 3167, 1, 3, 3, 15, 21, 13, 9,
+            189, 359, 323, 49, 333, 1, 3, 7, 11, 7, 37, 21, 119, 401, 157, 1659,
+            1069, 1, 1, 5, 7, 17, 33, 115, 229, 149, 151, 2027, 279, 1, 1, 5,
+            15, 5, 49, 77, 155, 383, 385, 1985, 945, 1, 3, 7, 3, 7, 55, 85,
+            41, 357, 527, 1715, 1619, 1, 1, 3, 1, 21, 45, 115, 21, 199, 967, 1581,
+            3807, 1, 1, 3, 7, 21, 39, 117, 191, 169, 73, 413, 3417, 1, 1, 1,
+            13, 1, 31, 57, 195, 231, 321, 367, 1027, 1, 3, 7, 3, 11, 29, 47,
+            161, 71, 419, 1721, 437, 1, 1, 7, 3, 11, 9, 43, 65, 157, 1, 1851,
+            823, 1, 1, 1, 5, 21, 15, 31, 101, 293, 299, 127, 1321, 1, 1, 7,
+            1, 27, 1, 11, 229, 241, 705, 43, 1475, 1, 3, 7, 1, 5, 15, 73,
+            183, 193, 55, 1345, 49, 1, 3, 3, 3, 19, 3, 55, 21, 169, 663, 1675,
+            137, 1, 1, 1, 13, 7, 21, 69, 67, 373, 965, 1273, 2279, 1, 1, 7,
+            7, 21, 23, 17, 43, 341, 845, 465, 3355, 1, 3, 5, 5, 25, 5, 81,
+            101, 233, 139, 359, 2057, 1, 1, 3, 11, 15, 39, 55, 3, 471, 765, 1143,
+            3941, 1, 1, 7, 15, 9, 57, 81, 79, 215, 433, 333, 3855, 1, 1, 5,
+            5, 19, 45, 83, 31, 209, 363, 701, 1303, 1, 3, 7, 5, 1, 13, 55,
+            163, 435, 807, 287, 2031, 1, 3, 3, 7, 3, 3, 17, 197, 39, 169, 489,
+            1769, 1, 1, 3, 5, 29, 43, 87, 161, 289, 339, 1233, 2353, 1, 3, 3,
+            9, 21, 9, 77, 1, 453, 167, 1643, 2227, 1, 1, 7, 1, 15, 7, 67,
+            33, 193, 241, 1031, 2339, 1, 3, 1, 11, 1, 63, 45, 65, 265, 661, 849,
+            1979, 1, 3, 1, 13, 19, 49, 3, 11, 159, 213, 659, 2839, 1, 3, 5,
+            11, 9, 29, 27, 227, 253, 449, 1403, 3427, 1, 1, 3, 1, 7, 3, 77,
+            143, 277, 779, 1499, 475, 1, 1, 1, 5, 11, 23, 87, 131, 393, 849, 193,
+            3189, 1, 3, 5, 11, 3, 3, 89, 9, 449, 243, 1501, 1739, 1, 3, 1,
+            9, 29, 29, 113, 15, 65, 611, 135, 3687, 1, 1, 1, 9, 21, 19, 39,
+            151, 395, 501, 1339, 959, 2725, 1, 3, 7, 1, 7, 35, 45, 33, 119, 225,
+            1631, 1695, 1459, 1, 1, 1, 3, 25, 55, 37, 79, 167, 907, 1075, 271, 4059,
+            1, 3, 5, 13, 5, 13, 53, 165, 437, 67, 1705, 3177, 8095, 1, 3, 3,
+            13, 27, 57, 95, 55, 443, 245, 1945, 1725, 1929, 1, 3, 1, 9, 5, 33,
+            109, 35, 99, 827, 341, 2401, 2411, 1, 1, 5, 9, 7, 33, 43, 39, 87,
+            799, 635, 3481, 7159, 1, 3, 1, 1, 31, 15, 45, 27, 337, 113, 987, 2065,
+            2529, 1, 1, 5, 9, 5, 15, 105, 123, 479, 289, 1609, 2177, 4629, 1, 3,
+            5, 11, 31, 47, 97, 87, 385, 195, 1041, 651, 3271, 1, 1, 3, 7, 17,
+            3, 101, 55, 87, 629, 1687, 1387, 2745, 1, 3, 5, 5, 7, 21, 9, 237,
+            313, 549, 1107, 117, 6183, 1, 1, 3, 9, 9, 5, 55, 201, 487, 851, 1103,
+            2993, 4055, 1, 1, 5, 9, 31, 19, 59, 7, 363, 381, 1167, 2057, 5715, 1,
+            3, 3, 15, 23, 63, 19, 227, 387, 827, 487, 1049, 7471, 1, 3, 1, 5,
+            23, 25, 61, 245, 363, 863, 963, 3583, 6475, 1, 1, 5, 1, 5, 27, 81,
+            85, 275, 49, 235, 3291, 1195, 1, 1, 5, 7, 23, 53, 85, 107, 511, 779,
+            1265, 1093, 7859, 1, 3, 3, 1, 9, 21, 75, 219, 59, 485, 1739, 3845, 1109,
+            1, 3, 5, 1, 13, 41, 19, 143, 293, 391, 2023, 1791, 4399, 1, 3, 7,
+            15, 21, 13, 21, 195, 215, 413, 523, 2099, 2341, 1, 1, 1, 3, 29, 51,
+            47, 57, 135, 575, 943, 1673, 541, 1, 3, 5, 1, 9, 13, 113, 175, 447,
+            115, 657, 4077, 5973, 1, 1, 1, 11, 17, 41, 37, 95, 297, 579, 911, 2207,
+            2387, 1, 3, 5, 3, 23, 11, 23, 231, 93, 667, 711, 1563, 7961, 1, 1,
+            7, 3, 17, 59, 13, 181, 141, 991, 1817, 457, 1711, 1, 3, 3, 5, 31,
+            59, 81, 205, 245, 537, 1049, 997, 1815, 1, 3, 7, 5, 17, 13, 9, 79,
+            17, 185, 5, 2211, 6263, 1, 3, 7, 13, 7, 53, 61, 145, 13, 285, 1203,
+            947, 2933, 1, 1, 7, 3, 31, 19, 69, 217, 47, 441, 1893, 673, 4451, 1,
+            1, 1, 1, 25, 9, 23, 225, 385, 629, 603, 3747, 4241, 1, 3, 1, 9,
+            5, 37, 31, 237, 431, 79, 1521, 459, 2523, 1, 3, 7, 3, 9, 43, 105,
+            179, 5, 225, 799, 1777, 4893, 1, 1, 3, 1, 29, 45, 29, 159, 267, 247,
+            455, 847, 3909, 1, 1, 3, 7, 25, 21, 121, 57, 467, 275, 719, 1521, 7319,
+            1, 3, 1, 3, 11, 35, 119, 123, 81, 979, 1187, 3623, 4293, 1, 1, 1,
+            7, 15, 25, 121, 235, 25, 487, 873, 1787, 1977, 1, 1, 1, 11, 3, 7,
+            17, 135, 345, 353, 383, 4011, 2573, 1, 3, 7, 15, 27, 13, 97, 123, 65,
+            675, 951, 1285, 6559, 1, 3, 7, 3, 7, 1, 71, 19, 325, 765, 337, 1197,
+            2697, 1, 3, 5, 1, 31, 37, 11, 71, 169, 283, 83, 3801, 7083, 1, 1,
+            3, 15, 17, 29, 83, 65, 275, 679, 1749, 4007, 7749, 1, 1, 3, 1, 21,
+            11, 41, 95, 237, 361, 1819, 2783, 2383, 1, 3, 7, 11, 29, 57, 111, 187,
+            465, 145, 605, 1987, 8109, 1, 1, 3, 3, 19, 15, 55, 83, 357, 1001, 643,
+            1517, 6529, 1, 3, 1, 5, 29, 35, 73, 23, 77, 619, 1523, 1725, 8145, 1,
+            1, 5, 5, 19, 23, 7, 197, 449, 337, 717, 2921, 315, 1, 3, 5, 9,
+            7, 63, 117, 97, 97, 813, 1925, 2817, 1579, 1, 1, 1, 11, 31, 7, 25,
+            235, 231, 133, 1007, 1371, 1553, 1, 1, 7, 5, 19, 7, 47, 171, 267, 243,
+            1331, 567, 6033, 1, 1, 5, 1, 7, 49, 55, 89, 109, 735, 1455, 3193, 6239,
+            1, 1, 1, 7, 1, 61, 9, 103, 3, 929, 1481, 2927, 2957, 1, 1, 5,
+            13, 17, 21, 75, 49, 255, 1019, 1161, 2133, 1177, 1, 3, 1, 3, 13, 15,
+            41, 247, 211, 409, 1163, 523, 2635, 1, 3, 7, 7, 21, 59, 91, 149, 479,
+            391, 681, 2311, 6249, 1, 1, 5, 11, 27, 53, 21, 211, 197, 815, 719, 1605,
+            255, 1, 1, 3, 3, 9, 33, 59, 3, 323, 1, 101, 1135, 8105, 1, 3,
+            3, 1, 29, 5, 17, 141, 51, 991, 841, 327, 3859, 1, 3, 1, 5, 11,
+            19, 23, 89, 175, 173, 165, 2881, 1881, 1, 1, 1, 15, 13, 51, 87, 39,
+            495, 611, 1341, 1531, 7029, 1, 1, 3, 11, 13, 55, 75, 185, 57, 61, 1917,
+            2051, 5965, 1, 1, 5, 5, 7, 53, 11, 217, 213, 933, 921, 3607, 5175, 1,
+            3, 3, 5, 17, 53, 103, 251, 369, 781, 1319, 3717, 4439, 1, 3, 5, 13,
+            1, 39, 25, 235, 321, 773, 251, 3111, 6397, 1, 1, 7, 3, 31, 5, 25,
+            29, 325, 385, 1313, 127, 4705, 1, 1, 5, 15, 15, 27, 15, 85, 239, 243,
+            1633, 3473, 2621, 1, 3, 3, 3, 9, 19, 113, 13, 137, 165, 25, 2957, 7549,
+            1, 3, 1, 3, 11, 21, 3, 97, 417, 183, 1205, 1437, 247, 1, 1, 7,
+            3, 17, 21, 125, 55, 67, 387, 385, 2323, 887, 1, 3, 5, 5, 29, 11,
+            103, 223, 233, 641, 133, 415, 1297, 1, 3, 3, 11, 1, 9, 5, 189, 235,
+            1007, 1363, 3985, 889, 1, 3, 7, 9, 23, 19, 19, 183, 269, 403, 1643, 3559,
+            5189, 1, 3, 7, 3, 29, 45, 17, 69, 475, 149, 1291, 2689, 7625, 1, 3,
+            7, 3, 27, 37, 41, 73, 253, 1001, 431, 1111, 7887, 1, 1, 7, 5, 3,
+            7, 87, 143, 289, 495, 631, 3011, 6151, 1, 1, 1, 13, 5, 45, 17, 167,
+            23, 975, 801, 1975, 6833, 1, 3, 1, 11, 7, 21, 39, 23, 213, 429, 1301,
+            2059, 197, 1, 3, 3, 15, 3, 57, 121, 133, 29, 711, 1961, 2497, 189, 1,
+            1, 3, 5, 11, 55, 115, 137, 233, 673, 985, 2849, 5911, 1, 1, 7, 15,
+            29, 45, 1, 241, 329, 323, 925, 2821, 3331, 1, 1, 5, 7, 13, 31, 81,
+            105, 199, 145, 195, 1365, 5119, 1, 3, 7, 11, 3, 55, 11, 31, 117, 343,
+            1265, 1837, 2451, 1, 1, 3, 7, 29, 57, 61, 179, 429, 591, 177, 1945, 2159,
+            1, 3, 5, 11, 23, 49, 101, 137, 339, 323, 1035, 1749, 7737, 1, 3, 1,
+            13, 21, 35, 55, 79, 19, 269, 1055, 2651, 7083, 1, 3, 3, 11, 9, 9,
+            95, 167, 437, 361, 1185, 4083, 603, 1, 1, 1, 7, 31, 61, 77, 65, 489,
+            657, 691, 2423, 4147, 1, 3, 5, 7, 21, 37, 87, 191, 311, 453, 2013, 829,
+            2619, 1, 1, 5, 9, 17, 47, 35, 101, 5, 813, 1157, 1279, 7365, 1, 1,
+            5, 3, 11, 35, 113, 199, 369, 721, 901, 1471, 7801, 1, 3, 1, 5, 9,
+            61, 83, 157, 391, 739, 1957, 2123, 4341, 1, 3, 5, 11, 19, 19, 111, 225,
+            383, 219, 997, 717, 7505, 1, 3, 1, 11, 13, 63, 35, 127, 209, 831, 501,
+            3017, 3507, 1, 3, 7, 9, 29, 7, 11, 163, 81, 563, 1445, 3215, 6377, 1,
+            3, 7, 11, 25, 3, 39, 195, 491, 45, 839, 4021, 4899, 1, 3, 7, 15,
+            13, 5, 67, 143, 117, 505, 1281, 3679, 5695, 1, 3, 7, 9, 9, 19, 21,
+            221, 147, 763, 683, 2211, 589, 1, 1, 3, 5, 21, 47, 53, 109, 299, 807,
+            1153, 1209, 7961, 1, 3, 7, 11, 9, 31, 45, 43, 505, 647, 1127, 2681, 4917,
+            1, 1, 5, 15, 31, 41, 63, 113, 399, 727, 673, 2587, 5259, 1, 1, 1,
+            13, 17, 53, 35, 99, 57, 243, 1447, 1919, 2831, 1, 3, 7, 11, 23, 51,
+            13, 9, 49, 449, 997, 3073, 4407, 1, 3, 5, 7, 23, 33, 89, 41, 415,
+            53, 697, 1113, 1489, 1, 1, 3, 7, 1, 13, 29, 13, 255, 749, 77, 3463,
+            1761, 1, 3, 3, 7, 13, 15, 93, 191, 309, 869, 739, 1041, 3053, 1, 3,
+            5, 13, 5, 19, 109, 211, 347, 839, 893, 2947, 7735, 1, 3, 1, 13, 27,
+            3, 119, 157, 485, 99, 1703, 3895, 573, 1, 3, 7, 11, 1, 23, 123, 105,
+            31, 359, 275, 1775, 3685, 1, 3, 3, 5, 27, 11, 125, 3, 413, 199, 2043,
+            2895, 2945, 1, 3, 3, 3, 15, 49, 121, 159, 233, 543, 193, 4007, 321, 1,
+            1, 3, 5, 9, 47, 87, 1, 51, 1011, 1595, 2239, 6467, 1, 3, 7, 9,
+            1, 33, 87, 137, 469, 749, 1413, 805, 6817, 1, 3, 1, 13, 19, 45, 95,
+            227, 29, 677, 1275, 3395, 4451, 1, 1, 7, 5, 7, 63, 33, 71, 443, 561,
+            1311, 3069, 6943, 1, 1, 1, 13, 9, 37, 23, 69, 13, 415, 1479, 1197, 861,
+            1, 3, 3, 13, 27, 21, 13, 233, 105, 777, 345, 2443, 1105, 1, 1, 7,
+            11, 23, 13, 21, 147, 221, 549, 73, 2729, 6279, 1, 1, 7, 7, 25, 27,
+            15, 45, 227, 39, 75, 1191, 3563, 1, 1, 5, 7, 13, 49, 99, 167, 227,
+            13, 353, 1047, 8075, 1, 1, 3, 13, 31, 9, 27, 7, 461, 737, 1559, 3243,
+            53, 1, 3, 1, 1, 21, 41, 97, 165, 171, 821, 587, 2137, 2293, 1, 3,
+            1, 11, 17, 41, 29, 187, 87, 599, 1467, 1395, 5931, 1, 1, 1, 9, 9,
+            49, 89, 205, 409, 453, 61, 1923, 1257, 1, 3, 7, 3, 9, 43, 89, 143,
+            431, 83, 1243, 1795, 3599, 1, 3, 5, 13, 3, 25, 59, 219, 43, 223, 797,
+            2651, 6015, 1, 1, 5, 15, 7, 55, 65, 207, 213, 311, 1287, 1269, 6467, 1,
+            3, 7, 11, 21, 57, 31, 183, 351, 857, 911, 1683, 7155, 1, 3, 5, 11,
+            27, 1, 21, 47, 387, 383, 1593, 115, 3805, 1, 3, 1, 1, 13, 23, 87,
+            173, 181, 619, 1653, 3931, 6073, 1, 1, 7, 5, 17, 43, 37, 61, 307, 621,
+            1785, 55, 115, 1, 3, 7, 15, 25, 61, 123, 15, 237, 671, 1473, 467, 1907,
+            1, 1, 7, 5, 29, 57, 75, 237, 85, 699, 159, 3577, 4771, 1, 1, 1,
+            11, 25, 19, 51, 1, 147, 31, 895, 2617, 625, 1, 3, 7, 5, 29, 15,
+            115, 175, 395, 391, 1141, 1827, 1181, 1, 3, 5, 7, 17, 7, 11, 193, 89,
+            243, 561, 3787, 4551, 1, 3, 1, 11, 7, 57, 7, 125, 403, 947, 1261, 409,
+            8083, 1, 1, 5, 13, 21, 63, 115, 233, 231, 921, 1747, 3635, 2519, 1, 1,
+            5, 11, 3, 27, 15, 91, 505, 591, 1451, 3881, 2997, 1, 1, 3, 11, 21,
+            9, 109, 153, 317, 533, 593, 3967, 2797, 1, 3, 3, 13, 9, 57, 121, 245,
+            219, 867, 967, 791, 7095, 1, 1, 1, 9, 29, 21, 99, 35, 375, 959, 329,
+            4087, 7171, 1, 1, 1, 9, 11, 17, 17, 97, 89, 135, 631, 3809, 3253, 1,
+            1, 1, 15, 21, 51, 91, 249, 459, 801, 757, 2353, 2033, 1, 3, 5, 9,
+            23, 29, 77, 53, 399, 767, 1817, 2171, 1629, 1, 1, 3, 5, 29, 5, 43,
+            121, 17, 859, 1479, 3785, 6641, 1, 1, 3, 7, 7, 61, 45, 109, 371, 833,
+            91, 153, 4553, 1, 1, 3, 11, 7, 55, 81, 123, 389, 139, 1933, 891, 1789,
+            1, 3, 7, 15, 25, 17, 93, 165, 503, 717, 1553, 1475, 1627, 1, 1, 1,
+            13, 13, 63, 13, 225, 357, 571, 33, 4073, 3795, 1, 1, 3, 11, 1, 31,
+            107, 145, 407, 961, 501, 2987, 103, 1, 1, 7, 1, 23, 63, 49, 193, 173,
+            281, 25, 2465, 5927, 1, 1, 7, 1, 1, 1, 85, 77, 273, 693, 349, 1239,
+            4503, 1, 1, 5, 11, 7, 61, 9, 121, 25, 357, 1443, 405, 7827, 1, 1,
+            7, 13, 11, 53, 11, 207, 145, 211, 1703, 1081, 2117, 1, 1, 3, 11, 27,
+            23, 19, 9, 297, 279, 1481, 2273, 6387, 1, 3, 3, 5, 15, 45, 3, 41,
+            305, 87, 1815, 3461, 5349, 1, 3, 3, 13, 9, 37, 79, 125, 259, 561, 1087,
+            4091, 793, 1, 3, 5, 7, 31, 55, 7, 145, 347, 929, 589, 2783, 5905, 1,
+            1, 7, 15, 3, 25, 1, 181, 13, 243, 653, 2235, 7445, 1, 3, 5, 5,
+            17, 53, 65, 7, 33, 583, 1363, 1313, 2319, 1, 3, 3, 7, 27, 47, 97,
+            201, 187, 321, 63, 1515, 7917, 1, 1, 3, 5, 23, 9, 3, 165, 61, 19,
+            1789, 3783, 3037, 1, 3, 1, 13, 15, 43, 125, 191, 67, 273, 1551, 2227, 5253,
+            1, 1, 1, 13, 25, 53, 107, 33, 299, 249, 1475, 2233, 907, 1, 3, 5,
+            1, 23, 37, 85, 17, 207, 643, 665, 2933, 5199, 1, 1, 7, 7, 25, 57,
+            59, 41, 15, 751, 751, 1749, 7053, 1, 3, 3, 1, 13, 25, 127, 93, 281,
+            613, 875, 2223, 6345, 1, 1, 5, 3, 29, 55, 79, 249, 43, 317, 533, 995,
+            1991, 1, 3, 3, 15, 17, 49, 79, 31, 193, 233, 1437, 2615, 819, 1, 1,
+            5, 15, 25, 3, 123, 145, 377, 9, 455, 1191, 3953, 1, 3, 5, 3, 15,
+            19, 41, 231, 81, 393, 3, 19, 2409, 1, 1, 3, 1, 27, 43, 113, 179,
+            7, 853, 947, 2731, 297, 1, 1, 1, 11, 29, 39, 53, 191, 443, 689, 529,
+            3329, 7431, 1, 3, 7, 5, 3, 29, 19, 67, 441, 113, 949, 2769, 4169, 1,
+            3, 5, 11, 11, 55, 85, 169, 215, 815, 803, 2345, 3967, 1, 1, 7, 9,
+            5, 45, 111, 5, 419, 375, 303, 1725, 4489, 1, 3, 5, 15, 29, 43, 79,
+            19, 23, 417, 381, 541, 4923, 1, 1, 3, 15, 3, 31, 117, 39, 117, 305,
+            1227, 1223, 143, 1, 1, 5, 9, 5, 47, 87, 239, 181, 353, 1561, 3313, 1921,
+            1, 3, 3, 1, 3, 15, 53, 221, 441, 987, 1997, 2529, 8059, 1, 1, 7,
+            11, 15, 57, 111, 139, 137, 883, 1881, 2823, 5661, 1, 3, 5, 5, 21, 11,
+            5, 13, 27, 973, 587, 1331, 1373, 1, 1, 7, 11, 29, 51, 93, 29, 217,
+            221, 55, 2477, 1979, 1, 3, 3, 13, 3, 11, 49, 75, 379, 371, 1441, 793,
+            7633, 1, 1, 1, 13, 19, 45, 89, 249, 91, 649, 1695, 915, 5619, 1, 3,
+            1, 7, 7, 29, 1, 77, 313, 895, 519, 771, 295, 1, 3, 1, 15, 5,
+            3, 1, 57, 331, 109, 485, 2853, 6831, 1, 1, 1, 15, 17, 3, 35, 99,
+            245, 971, 839, 2509, 2803, 1, 3, 3, 3, 9, 37, 57, 251, 325, 317, 529,
+            1313, 6379, 1, 1, 1, 15, 25, 59, 1, 119, 95, 15, 795, 2375, 6463, 1,
+            3, 1, 5, 1, 49, 117, 21, 47, 179, 863, 85, 1669, 1, 3, 7, 3,
+            9, 37, 19, 221, 455, 973, 571, 1427, 817, 1, 1, 1, 15, 17, 9, 67,
+            213, 127, 887, 1299, 2913, 7451, 1, 3, 1, 13, 27, 27, 41, 43, 171, 623,
+            691, 391, 4885, 1, 3, 1, 13, 17, 17, 123, 239, 143, 227, 1151, 519, 6543,
+            1, 3, 7, 5, 7, 63, 97, 39, 101, 555, 1057, 381, 7891, 1, 3, 5,
+            1, 3, 27, 85, 129, 161, 875, 1945, 3541, 695, 1, 3, 3, 5, 21, 59,
+            25, 183, 35, 25, 987, 1459, 181, 1, 3, 5, 13, 1, 15, 127, 237, 349,
+            337, 1491, 2383, 7811, 1, 3, 5, 5, 31, 5, 109, 51, 409, 733, 1395, 3207,
+            6049, 1, 1, 5, 7, 13, 35, 113, 25, 263, 389, 299, 2521, 1783, 1, 3,
+            7, 11, 15, 47, 97, 73, 55, 75, 113, 2695, 1023, 1, 3, 1, 1, 3,
+            13, 69, 211, 289, 483, 1335, 787, 677, 1, 1, 3, 3, 17, 7, 37, 77,
+            505, 137, 1113, 345, 2975, 1, 1, 1, 13, 3, 11, 95, 199, 453, 109, 479,
+            3725, 239, 1, 1, 7, 15, 19, 53, 3, 145, 359, 863, 347, 3833, 3043, 1,
+            1, 7, 15, 25, 63, 127, 129, 125, 195, 155, 2211, 8153, 1, 1, 7, 13,
+            9, 49, 121, 115, 73, 119, 1851, 727, 47, 1, 3, 3, 13, 13, 11, 71,
+            7, 45, 591, 133, 2407, 5563, 1, 1, 1, 13, 23, 29, 87, 89, 501, 71,
+            1759, 1119, 687, 1, 1, 7, 7, 13, 7, 13, 183, 53, 951, 1877, 3991, 6771,
+            1, 3, 7, 11, 7, 1, 27, 47, 61, 21, 919, 961, 1091, 1, 3, 5,
+            5, 1, 27, 1, 5, 63, 157, 1297, 1049, 5893, 1, 3, 7, 9, 19, 33,
+            17, 133, 425, 797, 1721, 153, 119, 1, 3, 3, 7, 13, 37, 1, 215, 509,
+            1003, 61, 2353, 7511, 1, 1, 7, 1, 29, 19, 31, 79, 199, 555, 1209, 1603,
+            6089, 1, 3, 1, 1, 5, 31, 111, 127, 333, 429, 1863, 3925, 5411, 1, 1,
+            7, 5, 5, 5, 123, 191, 47, 993, 269, 4051, 2111, 1, 1, 5, 15, 1,
+            9, 87, 5, 47, 463, 865, 1813, 7357, 1, 3, 1, 3, 23, 63, 123, 83,
+            511, 777, 63, 1285, 4537, 1, 3, 3, 7, 27, 25, 31, 65, 441, 529, 1815,
+            1893, 323, 1, 3, 7, 5, 11, 19, 7, 5, 397, 811, 755, 2883, 4217, 1,
+            3, 1, 13, 9, 21, 13, 7, 271, 539, 1769, 3243, 5325, 1, 1, 7, 1,
+            31, 13, 47, 131, 181, 457, 1559, 2663, 6653, 1, 3, 3, 7, 29, 55, 25,
+            203, 419, 91, 437, 1159, 5691, 1, 1, 3, 13, 29, 19, 71, 217, 337, 329,
+            501, 939, 2205, 1, 1, 3, 1, 1, 27, 17, 201, 97, 285, 1269, 4043, 2207,
+            1, 1, 1, 1, 3, 41, 13, 199, 141, 129, 1515, 3129, 5969, 1, 3, 3,
+            9, 3, 17, 119, 41, 271, 933, 877, 701, 2197, 1, 1, 1, 7, 15, 47,
+            3, 195, 115, 821, 725, 843, 6071, 1, 3, 5, 15, 17, 33, 85, 65, 297,
+            571, 1123, 2743, 5727, 1, 1, 5, 11, 27, 15, 37, 235, 415, 293, 1439, 2739,
+            4171, 1, 3, 7, 7, 1, 55, 71, 35, 307, 11, 401, 1881, 933, 1, 3,
+            1, 11, 21, 37, 3, 177, 119, 339, 559, 3991, 3437, 1, 3, 3, 9, 17,
+            17, 97, 119, 301, 169, 157, 3267, 2261, 1, 3, 3, 9, 29, 3, 111, 101,
+            355, 869, 375, 2609, 7377, 1, 3, 5, 9, 7, 21, 123, 99, 343, 693, 1927,
+            1605, 4923, 1, 1, 3, 5, 13, 31, 99, 17, 75, 385, 1539, 1553, 7077, 1,
+            3, 3, 5, 31, 35, 107, 11, 407, 1019, 1317, 3593, 7203, 1, 3, 3, 13,
+            17, 33, 99, 245, 401, 957, 157, 1949, 1571, 1, 3, 1, 11, 27, 15, 11,
+            109, 429, 307, 1911, 2701, 861, 1, 1, 5, 13, 13, 35, 55, 255, 311, 957,
+            1803, 2673, 5195, 1, 1, 1, 11, 19, 3, 89, 37, 211, 783, 1355, 3567, 7135,
+            1, 1, 5, 5, 21, 49, 79, 17, 509, 331, 183, 3831, 855, 1, 3, 7,
+            5, 29, 19, 85, 109, 105, 523, 845, 3385, 7477, 1, 1, 1, 7, 25, 17,
+            125, 131, 53, 757, 253, 2989, 2939, 1, 3, 3, 9, 19, 23, 105, 39, 351,
+            677, 211, 401, 8103, 1, 3, 5, 1, 5, 11, 17, 3, 405, 469, 1569, 2865,
+            3133, 1, 1, 3, 13, 15, 5, 117, 179, 139, 145, 477, 1137, 2537, 1, 1,
+            7, 9, 5, 21, 9, 93, 211, 963, 1207, 3343, 4911, 1, 1, 1, 9, 13,
+            43, 17, 53, 81, 793, 1571, 2523, 3683, 1, 3, 3, 13, 25, 21, 5, 59,
+            489, 987, 1941, 171, 6009, 1, 3, 3, 7, 1, 39, 89, 171, 403, 467, 1767,
+            3423, 2791, 1, 1, 3, 9, 19, 49, 91, 125, 163, 1013, 89, 2849, 6785, 1,
+            1, 5, 9, 9, 11, 15, 241, 43, 297, 1719, 1541, 1821, 1, 3, 7, 15,
+            29, 23, 103, 239, 191, 33, 1043, 3649, 6579, 1, 3, 3, 9, 21, 51, 123,
+            55, 223, 645, 1463, 4021, 5891, 1, 1, 5, 7, 3, 41, 27, 235, 391, 303,
+            2021, 3187, 7607, 1, 1, 1, 9, 5, 49, 49, 29, 377, 251, 1887, 1017, 1301,
+            1, 1, 3, 3, 13, 41, 27, 47, 223, 23, 517, 3227, 6731, 1, 1, 7,
+            1, 31, 25, 47, 9, 511, 623, 2047, 1263, 1511, 1, 1, 3, 15, 15, 23,
+            53, 1, 261, 595, 85, 241, 7047, 1, 3, 3, 11, 17, 5, 81, 73, 149,
+            781, 2035, 3163, 4247, 1, 3, 7, 7, 29, 59, 49, 79, 397, 901, 1105, 2191,
+            6277, 1, 3, 3, 11, 13, 27, 25, 173, 107, 73, 1265, 585, 5251, 1, 1,
+            7, 15, 29, 23, 73, 229, 235, 887, 1469, 4073, 2591, 1, 1, 3, 9, 17,
+            15, 83, 173, 207, 879, 1701, 1509, 11, 1, 1, 3, 5, 5, 37, 65, 161,
+            39, 421, 1153, 2007, 5355, 1, 1, 7, 11, 23, 37, 5, 11, 9, 499, 17,
+            157, 5747, 1, 3, 7, 13, 25, 9, 49, 7, 39, 945, 1349, 1759, 1441, 1,
+            1, 5, 3, 21, 15, 113, 81, 265, 837, 333, 3625, 6133, 1, 3, 1, 11,
+            13, 27, 73, 109, 297, 327, 299, 3253, 6957, 1, 1, 3, 13, 19, 39, 123,
+            73, 65, 5, 1061, 2187, 5055, 1, 1, 3, 1, 11, 31, 21, 115, 453, 857,
+            711, 495, 549, 1, 3, 7, 7, 15, 29, 79, 103, 47, 713, 1735, 3121, 6321,
+            1, 1, 5, 5, 29, 9, 97, 33, 471, 705, 329, 1501, 1349, 1, 3, 3,
+            1, 21, 9, 111, 209, 71, 47, 491, 2143, 1797, 1, 3, 3, 3, 11, 39,
+            21, 135, 445, 259, 607, 3811, 5449, 1, 1, 7, 9, 11, 25, 113, 251, 395,
+            317, 317, 91, 1979, 1, 3, 1, 9, 3, 21, 103, 133, 389, 943, 1235, 1749,
+            7063, 1, 1, 3, 7, 1, 11, 5, 15, 497, 477, 479, 3079, 6969, 1, 1,
+            3, 3, 15, 39, 105, 131, 475, 465, 181, 865, 3813, 1, 1, 7, 9, 19,
+            63, 123, 131, 415, 525, 457, 2471, 3135, 1, 3, 7, 15, 25, 35, 123, 45,
+            341, 805, 485, 4049, 7065, 1, 1, 1, 5, 29, 9, 47, 227, 51, 867, 1873,
+            1593, 2271, 1, 1, 7, 15, 31, 9, 71, 117, 285, 711, 837, 1435, 6275, 1,
+            3, 1, 1, 5, 19, 79, 25, 301, 415, 1871, 645, 3251, 1, 3, 1, 3,
+            17, 51, 99, 185, 447, 43, 523, 219, 429, 1, 3, 1, 13, 29, 13, 51,
+            93, 7, 995, 757, 3017, 6865, 1, 1, 3, 15, 7, 25, 75, 17, 155, 981,
+            1231, 1229, 1995, 1, 3, 5, 3, 27, 45, 71, 73, 225, 763, 377, 1139, 2863,
+            1, 1, 3, 1, 1, 39, 69, 113, 29, 371, 1051, 793, 3749, 1, 1, 3,
+            13, 23, 61, 27, 183, 307, 431, 1345, 2757, 4031, 1, 3, 7, 5, 5, 59,
+            117, 197, 303, 721, 877, 723, 1601, 1, 3, 5, 1, 27, 33, 99, 237, 485,
+            711, 665, 3077, 5105, 1, 1, 3, 1, 13, 9, 103, 201, 23, 951, 2029, 165,
+            2093, 1, 3, 5, 13, 5, 29, 55, 85, 221, 677, 611, 3613, 4567, 1, 1,
+            1, 1, 7, 61, 9, 233, 261, 561, 953, 4023, 2443, 1, 3, 3, 13, 1,
+            17, 103, 71, 223, 213, 833, 1747, 6999, 1, 3, 5, 15, 25, 53, 57, 187,
+            25, 695, 1207, 4089, 2877, 1, 1, 7, 1, 7, 31, 87, 129, 493, 519, 1555,
+            1155, 4637, 1, 1, 1, 15, 21, 17, 23, 29, 19, 255, 927, 1791, 3093, 1,
+            1, 3, 9, 17, 33, 95, 129, 175, 461, 287, 2633, 2325, 1, 3, 5, 7,
+            23, 19, 63, 209, 249, 583, 1373, 2039, 2225, 1, 3, 3, 5, 5, 19, 79,
+            241, 459, 355, 1455, 3313, 3639, 1, 1, 7, 9, 21, 41, 97, 119, 129, 769,
+            1541, 3495, 7741, 1, 1, 7, 11, 9, 29, 35, 255, 141, 937, 1763, 41, 1393,
+            1, 3, 7, 1, 13, 51, 61, 157, 177, 847, 1829, 3539, 285, 1, 1, 1,
+            15, 21, 13, 9, 55, 397, 19, 1495, 1255, 7235, 1, 1, 7, 7, 25, 37,
+            53, 237, 319, 197, 269, 1205, 1485, 1, 1, 5, 15, 23, 17, 35, 247, 323,
+            807, 233, 3681, 4407, 1, 1, 3, 7, 9, 59, 85, 105, 493, 763, 1639, 391,
+            1451, 1, 3, 3, 9, 15, 33, 5, 253, 129, 625, 1527, 2793, 6057, 1, 3,
+            1, 1, 7, 47, 21, 161, 235, 83, 397, 3563, 5953, 1, 3, 7, 11, 3,
+            41, 25, 117, 375, 779, 1297, 3715, 8117, 1, 1, 3, 7, 31, 19, 103, 173,
+            475, 189, 2035, 2921, 1107, 1, 1, 7, 3, 25, 7, 93, 255, 307, 113, 1893,
+            2233, 6919, 1, 3, 5, 15, 9, 57, 79, 143, 165, 5, 1389, 193, 693, 1,
+            3, 5, 1, 29, 45, 91, 49, 189, 461, 439, 1283, 7835, 1, 1, 3, 13,
+            11, 61, 41, 231, 373, 695, 395, 915, 5393, 1, 3, 7, 11, 5, 51, 67,
+            53, 483, 95, 1943, 247, 5653, 1, 3, 7, 5, 5, 57, 45, 235, 137, 793,
+            1069, 1661, 1557, 1, 3, 5, 3, 25, 55, 103, 177, 81, 861, 1151, 143, 7655,
+            1, 1, 3, 1, 21, 41, 67, 131, 253, 431, 1269, 3181, 3429, 1, 3, 1,
+            1, 21, 7, 77, 221, 257, 663, 71, 2949, 2481, 1, 3, 5, 3, 3, 23,
+            45, 107, 299, 739, 1013, 3, 3165, 1, 1, 5, 1, 3, 37, 109, 37, 243,
+            983, 1221, 1691, 3869, 1, 1, 5, 5, 31, 7, 5, 193, 397, 867, 1495, 3435,
+            7441, 1, 1, 1, 1, 17, 59, 97, 233, 389, 597, 1013, 1631, 483, 1, 1,
+            1, 11, 7, 41, 107, 53, 111, 125, 1513, 1921, 7647, 1, 3, 3, 3, 31,
+            29, 117, 3, 365, 971, 1139, 2123, 5913, 1, 1, 1, 13, 23, 3, 1, 167,
+            475, 639, 1811, 3841, 3081, 1, 1, 5, 3, 5, 47, 65, 123, 275, 783, 95,
+            119, 7591, 1, 3, 1, 15, 13, 33, 93, 237, 467, 431, 705, 4013, 4035, 1,
+            3, 5, 1, 19, 7, 101, 231, 155, 737, 1381, 3343, 2051, 1, 1, 5, 9,
+            15, 49, 45, 163, 433, 765, 2031, 201, 2589, 1, 3, 7, 9, 19, 41, 31,
+            89, 93, 623, 105, 745, 4409, 1, 1, 5, 1, 11, 45, 127, 85, 389, 439,
+            829, 477, 7965, 1, 3, 3, 15, 13, 41, 1, 207, 435, 585, 311, 1725, 2737,
+            1, 3, 3, 3, 13, 49, 21, 31, 197, 799, 1411, 2959, 7133, 1, 3, 1,
+            3, 7, 43, 9, 141, 133, 579, 1059, 93, 957, 1, 3, 7, 1, 15, 51,
+            23, 213, 381, 851, 699, 2261, 3419, 1, 3, 5, 9, 25, 35, 67, 141, 35,
+            409, 1423, 365, 1645, 1, 3, 3, 11, 15, 33, 27, 181, 93, 87, 1761, 3511,
+            1353, 1, 3, 5, 3, 25, 63, 111, 137, 321, 819, 705, 1547, 7271, 1, 3,
+            1, 1, 5, 57, 99, 59, 411, 757, 1371, 3953, 3695, 1, 3, 5, 11, 11,
+            21, 25, 147, 239, 455, 709, 953, 7175, 1, 3, 3, 15, 5, 53, 91, 205,
+            341, 63, 723, 1565, 7135, 1, 1, 7, 15, 11, 21, 99, 79, 63, 593, 2007,
+            3629, 5271, 1, 3, 3, 1, 9, 21, 45, 175, 453, 435, 1855, 2649, 6959, 1,
+            1, 3, 15, 15, 33, 121, 121, 251, 431, 1127, 3305, 4199, 1, 1, 1, 9,
+            31, 15, 71, 29, 345, 391, 1159, 2809, 345, 1, 3, 7, 1, 23, 29, 95,
+            151, 327, 727, 647, 1623, 2971, 1, 1, 7, 7, 9, 29, 79, 91, 127, 909,
+            1293, 1315, 5315, 1, 1, 5, 11, 13, 37, 89, 73, 149, 477, 1909, 3343, 525,
+            1, 3, 5, 7, 5, 59, 55, 255, 223, 459, 2027, 237, 4205, 1, 1, 1,
+            7, 27, 11, 95, 65, 325, 835, 907, 3801, 3787, 1, 1, 1, 11, 27, 33,
+            99, 175, 51, 913, 331, 1851, 4133, 1, 3, 5, 5, 13, 37, 31, 99, 273,
+            409, 1827, 3845, 5491, 1, 1, 3, 7, 23, 19, 107, 85, 283, 523, 509, 451,
+            421, 1, 3, 5, 7, 13, 9, 51, 81, 87, 619, 61, 2803, 5271, 1, 1,
+            1, 15, 9, 45, 35, 219, 401, 271, 953, 649, 6847, 1, 1, 7, 11, 9,
+            45, 17, 219, 169, 837, 1483, 1605, 2901, 1, 1, 7, 7, 21, 43, 37, 33,
+            291, 359, 71, 2899, 7037, 1, 3, 3, 13, 31, 53, 37, 15, 149, 949, 551,
+            3445, 5455, 1, 3, 1, 5, 19, 45, 81, 223, 193, 439, 2047, 3879, 789, 1,
+            1, 7, 3, 11, 63, 35, 61, 255, 563, 459, 2991, 3359, 1, 1, 5, 9,
+            13, 49, 47, 185, 239, 221, 1533, 3635, 2045, 1, 3, 7, 3, 25, 37, 127,
+            223, 51, 357, 483, 3837, 6873, 1, 1, 7, 9, 31, 37, 113, 31, 387, 833,
+            1243, 1543, 5535, 1, 3, 1, 9, 23, 59, 119, 221, 73, 185, 2007, 2885, 2563,
+            1, 1, 1, 13, 7, 33, 53, 179, 67, 185, 1541, 1807, 4659, 1, 3, 1,
+            11, 31, 37, 23, 215, 269, 357, 207, 645, 4219, 1, 3, 3, 13, 19, 27,
+            107, 55, 91, 71, 1695, 1815, 89, 1, 1, 3, 15, 3, 19, 35, 247, 49,
+            529, 1523, 3317, 6151, 1, 1, 7, 7, 23, 25, 107, 139, 483, 503, 1277, 243,
+            7879, 1, 3, 3, 13, 3, 15, 11, 197, 135, 839, 985, 275, 5527, 1, 3,
+            5, 3, 25, 47, 95, 21, 113, 307, 1001, 3065, 295, 1, 1, 3, 9, 19,
+            19, 99, 213, 363, 449, 735, 2851, 2521, 1, 1, 3, 9, 5, 49, 63, 61,
+            157, 857, 497, 2801, 6987, 1, 1, 1, 9, 1, 41, 109, 119, 499, 939, 867,
+            3675, 8023, 1, 3, 1, 1, 13, 33, 109, 123, 289, 3, 1271, 2773, 4265, 1,
+            3, 1, 11, 9, 57, 83, 221, 95, 43, 1189, 457, 7133, 1, 1, 7, 3,
+            11, 49, 33, 219, 229, 289, 685, 3359, 4495, 1, 3, 1, 3, 19, 43, 67,
+            193, 41, 771, 407, 81, 3891, 1, 1, 7, 11, 5, 29, 51, 175, 297, 539,
+            1, 2245, 6439, 1, 3, 7, 15, 21, 33, 117, 183, 511, 489, 1283, 3281, 5979,
+            1, 3, 7, 5, 9, 3, 125, 147, 359, 549, 369, 3049, 2405, 1, 3, 5,
+            7, 19, 5, 65, 97, 483, 377, 1523, 1457, 2995, 1, 1, 5, 1, 11, 21,
+            41, 113, 277, 131, 1475, 1043, 2367, 1, 3, 3, 1, 15, 17, 101, 69, 443,
+            865, 817, 1421, 5231, 1, 1, 3, 3, 3, 55, 95, 99, 75, 195, 1929, 3931,
+            5855, 1, 3, 1, 3, 19, 23, 93, 213, 241, 551, 1307, 585, 7729, 1, 3,
+            1, 11, 23, 15, 53, 249, 467, 519, 95, 741, 409, 1, 1, 1, 15, 29,
+            37, 43, 203, 233, 877, 77, 1933, 2729, 1, 3, 7, 11, 27, 39, 43, 161,
+            255, 15, 1463, 833, 495, 1, 1, 7, 11, 3, 53, 81, 67, 375, 823, 1903,
+            3061, 395, 1, 1, 1, 1, 15, 37, 93, 233, 247, 501, 1321, 3275, 5409, 1,
+            3, 3, 7, 7, 11, 5, 105, 139, 983, 1239, 531, 3881, 1, 1, 5, 3,
+            19, 49, 107, 227, 361, 101, 355, 2649, 7383, 1, 1, 7, 5, 25, 41, 101,
+            121, 209, 293, 1937, 2259, 5557, 1, 1, 3, 7, 7, 1, 9, 13, 463, 1019,
+            995, 3159, 107, 1, 3, 5, 11, 5, 35, 127, 97, 261, 789, 807, 807, 6257,
+            1, 1, 7, 5, 11, 13, 45, 91, 417, 101, 1973, 3645, 2107, 1, 1, 3,
+            7, 5, 63, 57, 49, 203, 157, 115, 1393, 8117, 1, 3, 5, 5, 3, 43,
+            15, 155, 127, 489, 1165, 3701, 4867, 1, 1, 7, 7, 29, 29, 69, 215, 415,
+            367, 371, 1901, 6075, 1, 1, 1, 3, 11, 33, 89, 149, 433, 705, 1437, 1597,
+            505, 1, 3, 5, 1, 13, 37, 19, 119, 5, 581, 2037, 1633, 2099, 1, 3,
+            7, 13, 5, 49, 103, 245, 215, 515, 133, 2007, 1933, 1, 3, 1, 9, 1,
+            3, 25, 197, 253, 387, 1683, 2267, 221, 1, 3, 5, 15, 21, 9, 73, 201,
+            405, 999, 437, 3877, 6045, 1, 1, 3, 1, 31, 55, 25, 83, 421, 395, 1807,
+            2129, 7797, 1, 1, 3, 1, 23, 21, 121, 183, 125, 347, 143, 3685, 4317, 1,
+            3, 3, 3, 17, 45, 17, 223, 267, 795, 1815, 1309, 155, 1, 1, 1, 15,
+            17, 59, 5, 133, 15, 715, 1503, 153, 2887, 1, 1, 1, 1, 27, 13, 119,
+            77, 243, 995, 1851, 3719, 4695, 1, 3, 1, 5, 31, 49, 43, 165, 49, 609,
+            1265, 1141, 505, 1, 1, 7, 13, 11, 63, 21, 253, 229, 585, 1543, 3719, 4141,
+            1, 3, 7, 11, 23, 27, 17, 131, 295, 895, 1493, 1411, 3247, 1, 1, 5,
+            9, 29, 7, 97, 15, 113, 445, 859, 1483, 1121, 1, 3, 1, 9, 13, 49,
+            99, 107, 323, 201, 681, 3071, 5281, 1, 1, 1, 15, 9, 19, 61, 161, 7,
+            87, 587, 2199, 2811, 1, 3, 3, 15, 15, 19, 95, 45, 299, 829, 981, 3479,
+            487, 1, 1, 1, 9, 3, 37, 7, 19, 227, 13, 397, 513, 1257, 1, 1,
+            5, 15, 15, 13, 17, 111, 135, 929, 1145, 811, 1801, 1, 3, 1, 3, 27,
+            57, 31, 19, 279, 103, 693, 631, 3409, 1, 1, 1, 1, 15, 13, 67, 83,
+            23, 799, 1735, 2063, 3363, 1, 3, 3, 7, 3, 1, 61, 31, 41, 533, 2025,
+            4067, 6963, 1, 1, 5, 7, 17, 27, 81, 79, 107, 205, 29, 97, 4883, 1,
+            1, 1, 5, 19, 49, 91, 201, 283, 949, 651, 3819, 5073, 1, 1, 7, 9,
+            11, 13, 73, 197, 37, 219, 1931, 3369, 6017, 1, 1, 7, 15, 11, 7, 75,
+            205, 7, 819, 399, 661, 6487, 1, 3, 3, 3, 27, 37, 95, 41, 307, 165,
+            1077, 3485, 563, 1, 3, 5, 3, 21, 49, 57, 179, 109, 627, 1789, 431, 2941,
+            1, 1, 7, 5, 11, 19, 43, 137, 149, 679, 1543, 245, 1381, 1, 3, 5,
+            5, 15, 3, 69, 81, 135, 159, 1363, 3401, 6355, 1, 3, 5, 1, 9, 61,
+            49, 53, 319, 25, 1647, 1297, 615, 1, 3, 5, 11, 31, 43, 9, 101, 71,
+            919, 335, 3147, 5823, 1, 3, 1, 1, 15, 5, 29, 109, 511, 945, 867, 3677,
+            6915, 1, 3, 3, 15, 17, 49, 91, 111, 215, 29, 1879, 97, 2505, 1, 3,
+            1, 13, 19, 61, 11, 111, 163, 777, 533, 1113, 5339, 1, 1, 7, 9, 17,
+            55, 117, 91, 455, 289, 557, 913, 4455, 1, 3, 1, 7, 25, 19, 123, 37,
+            1, 277, 717, 2965, 4469, 1, 3, 7, 3, 19, 23, 87, 235, 209, 457, 2041,
+            2893, 1805, 1, 3, 3, 5, 5, 43, 23, 61, 351, 791, 59, 2009, 2909, 1,
+            1, 3, 7, 5, 1, 27, 231, 385, 257, 1261, 2701, 1807, 1, 3, 1, 1,
+            27, 19, 87, 253, 131, 685, 1743, 3983, 2651, 1, 3, 7, 11, 21, 17, 11,
+            81, 191, 641, 1821, 3005, 7251, 1, 3, 3, 5, 15, 31, 41, 213, 55, 931,
+            1953, 49, 6037, 1, 1, 7, 15, 7, 27, 65, 223, 113, 79, 1875, 911, 5445,
+            1, 3, 7, 7, 23, 55, 51, 167, 495, 25, 1585, 3447, 799, 1, 1, 3,
+            7, 27, 15, 95, 193, 337, 415, 975, 3085, 967, 1, 1, 7, 15, 19, 7,
+            93, 41, 433, 551, 401, 3169, 3971, 1, 1, 7, 11, 13, 15, 53, 69, 433,
+            59, 1117, 3359, 6231, 1, 1, 7, 3, 23, 5, 115, 201, 225, 109, 1903, 3897,
+            6265, 1, 1, 1, 11, 17, 1, 39, 143, 361, 659, 1105, 23, 4923, 1, 1,
+            1, 9, 27, 57, 85, 227, 261, 119, 1881, 3965, 6999, 1, 3, 7, 7, 15,
+            7, 107, 17, 315, 49, 1591, 905, 7789, 1, 3, 1, 7, 29, 3, 47, 237,
+            157, 769, 839, 3199, 3195, 1, 1, 3, 15, 25, 39, 63, 15, 111, 857, 881,
+            1505, 7671, 1, 1, 7, 1, 3, 35, 41, 215, 99, 895, 1025, 1483, 4707, 1,
+            3, 5, 1, 1, 31, 25, 247, 113, 841, 397, 1825, 6969, 1, 1, 3, 5,
+            19, 41, 49, 243, 225, 973, 241, 175, 1041, 1, 1, 1, 7, 15, 15, 105,
+            141, 83, 75, 1675, 3523, 5219, 1, 1, 7, 5, 13, 27, 47, 199, 445, 841,
+            959, 1157, 2209, 1, 3, 5, 15, 23, 31, 31, 81, 85, 33, 785, 2639, 7799,
+            1, 1, 5, 13, 21, 3, 47, 99, 235, 943, 1731, 2467, 7891, 1, 1, 1,
+            3, 17, 53, 85, 219, 73, 131, 1339, 875, 1191, 1, 1, 5, 7, 17, 63,
+            113, 7, 185, 557, 749, 3563, 4973, 1, 3, 3, 15, 15, 21, 43, 111, 155,
+            689, 345, 423, 3597, 1, 1, 5, 1, 15, 29, 93, 5, 361, 713, 695, 3937,
+            425, 1, 3, 7, 7, 13, 41, 115, 175, 315, 937, 123, 2841, 4457, 1, 1,
+            3, 11, 25, 5, 103, 53, 423, 811, 657, 399, 7257, 1, 1, 1, 1, 1,
+            13, 101, 211, 383, 325, 97, 1703, 4429, 1, 3, 7, 9, 31, 45, 83, 157,
+            509, 701, 841, 1105, 3643, 1, 1, 1, 7, 1, 9, 69, 17, 129, 281, 1161,
+            2945, 7693, 1, 3, 7, 1, 11, 29, 51, 143, 77, 433, 1723, 2317, 5641, 1,
+            1, 1, 1, 21, 43, 13, 67, 177, 505, 1629, 1267, 4885, 1, 1, 3, 11,
+            27, 63, 111, 47, 233, 781, 453, 1679, 3209, 1, 1, 3, 13, 29, 27, 119,
+            141, 493, 971, 461, 1159, 633, 1, 1, 3, 15, 23, 5, 79, 215, 163, 149,
+            1805, 2399, 61, 1, 3, 5, 13, 19, 5, 1, 39, 409, 561, 709, 829, 1357,
+            1, 3, 3, 13, 19, 43, 9, 177, 449, 447, 73, 2107, 5669, 1, 3, 5,
+            1, 23, 13, 63, 109, 203, 593, 829, 4017, 6881, 1, 1, 5, 7, 3, 9,
+            53, 175, 391, 169, 1283, 3793, 4451, 1, 1, 5, 7, 29, 43, 9, 5, 209,
+            77, 927, 2941, 8145, 1, 3, 5, 15, 17, 49, 5, 143, 131, 771, 1685, 925,
+            2175, 1, 1, 3, 11, 27, 27, 27, 159, 161, 1015, 1587, 4049, 1983, 1, 3,
+            1, 3, 23, 57, 119, 67, 481, 577, 389, 3319, 5325, 1, 3, 5, 1, 19,
+            39, 87, 61, 329, 657, 1773, 31, 1707, 1, 1, 3, 1, 5, 25, 15, 241,
+            131, 815, 1751, 3029, 8039, 1, 3, 3, 13, 27, 13, 77, 87, 437, 57, 621,
+            1031, 7891, 1, 3, 1, 13, 23, 51, 117, 37, 331, 745, 605, 3179, 4713, 1,
+            1, 5, 5, 19, 17, 99, 167, 87, 721, 737, 789, 2165, 1, 3, 5, 13,
+            1, 51, 119, 211, 165, 299, 1327, 3053, 3343, 1, 1, 5, 15, 29, 45, 17,
+            129, 67, 345, 1553, 2705, 7369, 1, 1, 1, 9, 23, 7, 13, 209, 7, 407,
+            317, 3077, 7287, 1, 1, 1, 5, 9, 59, 89, 3, 487, 451, 505, 2499, 7563,
+            1, 3, 1, 7, 21, 1, 21, 203, 101, 417, 1389, 2751, 1397, 1, 3, 7,
+            13, 7, 31, 3, 247, 349, 485, 1259, 549, 6321, 1, 1, 7, 7, 27, 33,
+            107, 197, 293, 729, 1753, 2571, 103, 1, 3, 5, 9, 25, 35, 5, 253, 137,
+            213, 2041, 3387, 1809, 1, 1, 7, 13, 15, 35, 67, 83, 295, 175, 839, 2831,
+            839, 1, 3, 3, 11, 3, 17, 55, 141, 247, 991, 117, 3799, 1221, 1, 1,
+            5, 1, 11, 37, 87, 233, 457, 653, 899, 2933, 3105, 1, 1, 3, 15, 3,
+            31, 67, 167, 437, 9, 651, 1109, 1139, 1, 1, 3, 1, 7, 63, 67, 17,
+            11, 883, 1855, 1941, 4751, 1, 3, 7, 9, 19, 33, 113, 117, 495, 39, 1795,
+            2561, 5519, 1, 1, 7, 5, 1, 3, 103, 37, 201, 223, 1101, 877, 6483, 1,
+            1, 5, 9, 29, 49, 51, 33, 439, 917, 861, 1321, 2135, 1, 1, 3, 3,
+            1, 5, 17, 93, 217, 619, 613, 1357, 6095, 1, 3, 1, 11, 3, 21, 5,
+            41, 15, 175, 843, 2937, 6849, 1, 3, 3, 7, 9, 57, 55, 127, 79, 287,
+            445, 2205, 7989, 1, 1, 7, 13, 23, 17, 93, 129, 157, 135, 1747, 1813, 4183,
+            1, 1, 1, 5, 31, 59, 99, 33, 425, 329, 887, 367, 1761, 1, 1, 7,
+            9, 17, 53, 77, 139, 435, 387, 49, 3649, 1773, 1, 3, 3, 15, 21, 57,
+            45, 161, 331, 719, 273, 3479, 4173, 1, 1, 3, 9, 3, 3, 105, 201, 373,
+            877, 919, 1263, 6649, 1, 3, 1, 15, 13, 43, 13, 99, 73, 163, 353, 3569,
+            5601, 1, 3, 7, 3, 5, 9, 69, 177, 449, 47, 781, 1125, 4245, 1, 1,
+            1, 5, 3, 45, 1, 123, 409, 903, 205, 2057, 7637, 1, 3, 5, 9, 19,
+            47, 87, 135, 481, 799, 101, 3409, 2241, 1, 3, 1, 13, 3, 25, 15, 27,
+            181, 967, 669, 2577, 7249, 1, 1, 7, 3, 31, 5, 103, 53, 1, 911, 1209,
+            3697, 6685, 1, 1, 3, 1, 5, 5, 49, 135, 281, 747, 761, 2973, 7963, 1,
+            3, 3, 5, 19, 61, 125, 199, 299, 515, 1365, 369, 7027, 1, 3, 1, 7,
+            5, 41, 63, 229, 283, 571, 147, 447, 657, 1, 3, 1, 11, 5, 15, 55,
+            7, 259, 61, 27, 1429, 5631, 1, 1, 5, 1, 3, 53, 51, 253, 155, 553,
+            1293, 3735, 6567, 1, 3, 5, 9, 5, 41, 21, 159, 101, 785, 1981, 3799, 7693,
+            1, 3, 7, 7, 9, 3, 95, 105, 129, 213, 1215, 1027, 5699, 1, 1, 3,
+            3, 29, 13, 9, 253, 449, 321, 341, 2879, 171, 1, 3, 7, 11, 21, 11,
+            75, 35, 43, 965, 675, 2217, 7175, 1, 1, 5, 15, 31, 5, 29, 137, 311,
+            751, 47, 1367, 5921, 1, 1, 3, 15, 17, 1, 45, 69, 55, 649, 835, 569,
+            7615, 1, 3, 1, 13, 31, 7, 23, 15, 391, 145, 1845, 1825, 1403, 1, 1,
+            3, 15, 5, 9, 79, 77, 105, 399, 1933, 2503, 4781, 1, 3, 1, 3, 17,
+            47, 19, 13, 107, 475, 759, 2933, 3761, 1, 1, 7, 11, 3, 7, 121, 209,
+            397, 877, 293, 847, 7039, 1, 1, 1, 15, 29, 45, 5, 109, 335, 461, 143,
+            931, 4045, 1, 3, 1, 7, 11, 57, 73, 89, 201, 173, 803, 3953, 5205, 1,
+            1, 5, 11, 11, 33, 37, 29, 263, 1019, 657, 1453, 7807
+        };
+    }
+}
+
+#endif
+
+// src/Core/basicfxn.cpp
+
+#include <limits>
+#include <algorithm>
+
+namespace DiceForge
+{
+    matrix_t::matrix_t(int r, int c)
+        : data(size_t(r) * c, 0), r(r), c(c)
+    {
+    }
+
+    matrix_t matrix_t::operator*(const matrix_t& other) const
+    {
+        matrix_t pdt = matrix_t(r, other.c);
+        for (int i = 0; i < r; i++)
+        {
+            real_t* out = pdt[i];
+            // i-k-j order, so that the inner loop runs along rows of both
+            for (int k = 0; k < c; k++)
+            {
+                const real_t a = (*this)[i][k];
+                const real_t* row = other[k];
+                for (int j = 0; j < other.c; j++)
+                {
+                    out[j] += a * row[j];
+                }
+            }
+        }            
+
+        return pdt;
+    }
+
+    matrix_t matrix_t::operator+(const matrix_t& other) const
+    {
+        matrix_t sum = *this;
+        sum += other;
+        return sum;
+    }
+
+    matrix_t matrix_t::operator-(const matrix_t& other) const
+    {
+        matrix_t diff = *this;
+        diff -= other;
+        return diff;
+    }
+
+    matrix_t matrix_t::operator-() const
+    {
+        matrix_t neg = *this;
+        neg *= -1;
+        return neg;
+    }
+    
+    matrix_t matrix_t::transpose() const
+    {
+        matrix_t t = matrix_t(c, r);
+        for (int i = 0; i < r; i++)
+        {
+            for (int j = 0; j < c; j++)
+            {
+                t[j][i] = (*this)[i][j];
+            }
+        }
+
+        return t;
+    }
+
+    matrix_t& matrix_t::operator+=(const matrix_t& other)
+    {
+        for (size_t i = 0; i < data.size(); i++)
+        {
+            data[i] += other.data[i];
+        }
+        return *this;
+    }
+
+    matrix_t& matrix_t::operator-=(const matrix_t& other)
+    {
+        for (size_t i = 0; i < data.size(); i++)
+        {
+            data[i] -= other.data[i];
+        }
+        return *this;
+    }
+
+    matrix_t& matrix_t::operator*=(real_t k)
+    {
+        for (real_t& x : data)
+        {
+            x *= k;
+        }
+        return *this;
+    }
+
+    void multiply_transposed(const matrix_t& A, const matrix_t& B, matrix_t& out)
+    {
+        std::fill(out.data.begin(), out.data.end(), 0);
+        for (int k = 0; k < A.r; k++)
+        {
+            const real_t* a = A[k];
+            const real_t* b = B[k];
+            for (int i = 0; i < A.c; i++)
+            {
+                real_t* row = out[i];
+                for (int j = 0; j < B.c; j++)
+                {
+                    row[j] += a[i] * b[j];
+                }
+            }
+        }
+    }
+}
+
+// src/Core/combinatorics.cpp
+
+
+namespace DiceForge
+{
+    namespace detail
+    {
+        // log(n!) for n < 256, correctly rounded
+        const real_t log_factorial_table[log_factorial_table_size] = {
+            0.0, 0.0, 0.6931471805599453, 1.791759469228055, 3.1780538303479458, 4.787491742782046,
+            6.579251212010101, 8.525161361065415, 10.60460290274525, 12.801827480081469, 15.104412573075516, 17.502307845873887,
+            19.987214495661885, 22.552163853123425, 25.19122118273868, 27.89927138384089, 30.671860106080672, 33.50507345013689,
+            36.39544520803305, 39.339884187199495, 42.335616460753485, 45.38013889847691, 48.47118135183523, 51.60667556776438,
+            54.78472939811232, 58.00360522298052, 61.261701761002, 64.55753862700634, 67.88974313718154, 71.25703896716801,
+            74.65823634883016, 78.0922235533153, 81.55795945611504, 85.05446701758152, 88.58082754219768, 92.1361756036871,
+            95.7196945421432, 99.33061245478743, 102.96819861451381, 106.63176026064346, 110.32063971475739, 114.0342117814617,
+            117.77188139974507, 121.53308151543864, 125.3172711493569, 129.12393363912722, 132.95257503561632, 136.80272263732635,
+            140.67392364823425, 144.5657439463449, 148.47776695177302, 152.40959258449735, 156.3608363030788, 160.3311282166309,
+            164.32011226319517, 168.32744544842765, 172.3527971391628, 176.39584840699735, 180.45629141754378, 184.53382886144948,
+            188.6281734236716, 192.7390472878449, 196.86618167289, 201.00931639928152, 205.1681994826412, 209.34258675253685,
+            213.53224149456327, 217.73693411395422, 221.95644181913033, 226.1905483237276, 230.43904356577696, 234.70172344281826,
+            238.97838956183432, 243.2688490029827, 247.57291409618688, 251.8904022097232, 256.22113555000954, 260.5649409718632,
+            264.9216497985528, 269.2910976510198, 273.6731242856937, 278.0675734403661, 282.4742926876304, 286.893133295427,
+            291.3239500942703, 295.76660135076065, 300.22094864701415, 304.6868567656687, 309.1641935801469, 313.65282994987905,
+            318.1526396202093, 322.66349912672615, 327.1852877037752, 331.7178871969285, 336.26118197919845, 340.815058870799,
+            345.37940706226686, 349.95411804077025, 354.5390855194408, 359.1342053695754, 363.73937555556347, 368.35449607240474,
+            372.979468885689, 377.61419787391867, 382.25858877306, 386.91254912321756, 391.5759882173296, 396.24881705179155,
+            400.93094827891576, 405.6222961611449, 410.32277652693733, 415.03230672824964, 419.7508055995447, 424.4781934182571,
+            429.21439186665157, 433.9593239950148, 438.71291418612117, 443.47508812091894, 448.2457727453846, 453.0248962384961,
+            457.81238798127816, 462.6081785268749, 467.4121995716082, 472.2243839269806, 477.04466549258564, 481.87297922988796,
+            486.7092611368394, 491.553448223298, 496.40547848721764, 501.2652908915793, 506.1328253420349, 511.008022665236,
+            515.8908245878224, 520.7811737160441, 525.679013515995, 530.5842882944335, 535.4969431801695, 540.4169241059976,
+            545.3441777911548, 550.2786517242855, 555.2202941468948, 560.169054037273, 565.1248810948744, 570.0877257251342,
+            575.0575390247102, 580.0342727671308, 585.0178793888391, 590.0083119756179, 595.005524249382, 600.0094705553274,
+            605.0201058494237, 610.0373856862386, 615.0612662070849, 620.0917041284773, 625.128656730891, 630.1720818478102,
+            635.2219378550598, 640.278183660408, 645.340778693435, 650.4096828956552, 655.4848567108891, 660.5662610758735,
+            665.653857411106, 670.7476076119127, 675.8474740397369, 680.9534195136374, 686.065407301994, 691.1834011144108,
+            696.307365093814, 701.437263808737, 706.5730622457874, 711.71472580229, 716.8622202791034, 722.0155118736012,
+            727.1745671728157, 732.3393531467393, 737.5098371417774, 742.6859868743512, 747.8677704246434, 753.0551562304842,
+            758.2481130813743, 763.4466101126401, 768.6506167997169, 773.8601029525583, 779.0750387101673, 784.2953945352457,
+            789.5211412089589, 794.7522498258135, 799.9886917886435, 805.230438803703, 810.4774628758636, 815.7297363039102,
+            820.9872316759379, 826.2499218648428, 831.5177800239062, 836.7907795824699, 842.0688942417004, 847.3520979704384,
+            852.640365001133, 857.9336698258575, 863.2319871924054, 868.5352921004645, 873.8435597978657, 879.1567657769075,
+            884.4748857707517, 889.7978957498901, 895.1257719186798, 900.4584907119452, 905.7960287916464, 911.1383630436112,
+            916.4854705743287, 921.8373287078048, 927.1939149824768, 932.5552071481862, 937.9211831632081, 943.2918211913358,
+            948.6670995990199, 954.0469969525603, 959.4314920153495, 964.8205637451659, 970.2141912915183, 975.6123539930361,
+            981.0150313749083, 986.4222031463685, 991.8338491982234, 997.249949600428, 1002.6704845997002, 1008.0954346171816,
+            1013.5247802461361, 1018.9585022496902, 1024.3965815586134, 1029.8389992691352, 1035.2857366408016, 1040.7367750943672,
+            1046.192096209725, 1051.6516817238692, 1057.1155135288948, 1062.5835736700299, 1068.0558443437014, 1073.5323078956328,
+            1079.0129468189748, 1084.4977437524656, 1089.9866814786221, 1095.4797429219627, 1100.976911147256, 1106.4781693578007,
+            1111.983500893733, 1117.492889230361, 1123.006317976526, 1128.5237708729908, 1134.045231790853, 1139.5706847299848,
+            1145.100113817496, 1150.6335033062237, 1156.1708375732421, 1161.7121011184006
+        };
+    }
+}
+
+// src/Core/fitting.cpp
+
+
+namespace DiceForge
+{
+    namespace fitting
+    {
+        Workers::Workers(int count)
+        {
+            if (count <= 0)
+                count = std::max(1, int(std::thread::hardware_concurrency()));
+            for (int i = 1; i < count; i++)
+                threads.emplace_back(&Workers::work, this);
+        }
+
+        Workers::~Workers()
+        {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                stop = true;
+            }
+            wake.notify_all();
+            for (std::thread& t : threads)
+                t.join();
+        }
+
+        void Workers::run(size_t count, const std::function<void(size_t)>& task)
+        {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                job = &task;
+                jobs = count;
+                next = 0;
+                busy = int(threads.size());
+                generation++;
+            }
+            wake.notify_all();
+
+            // the caller takes chunks as well
+            for (size_t i = next++; i < count; i = next++)
+                task(i);
+
+            std::unique_lock<std::mutex> guard(lock);
+            done.wait(guard, [this] { return busy == 0; });
+            job = nullptr;
+        }
+
+        void Workers::work()
+        {
+            unsigned long seen = 0;
+            while (true)
+            {
+                const std::function<void(size_t)>* task;
+                size_t count;
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    wake.wait(guard, [&] { return stop || generation != seen; });
+                    if (stop)
+                        return;
+                    seen = generation;
+                    task = job;
+                    count = jobs;
+                }
+
+                for (size_t i = next++; i < count; i = next++)
+                    (*task)(i);
+
+                std::lock_guard<std::mutex> guard(lock);
+                if (--busy == 0)
+                    done.notify_one();
+            }
+        }
+    }
+}
+
+// src/Core/geometry.cpp
+
+
+namespace DiceForge
+{
+    namespace geometry
+    {
+#if defined(DF_DISPATCH_AVX2)
+        // The same transforms compiled for AVX2 and FMA
+        namespace avx2
+        {
+            void circle_from_unit(real_t* x, real_t* y, size_t n);
+            void disk_from_unit(real_t* x, real_t* y, size_t n);
+            void sphere_from_unit(real_t* x, real_t* y, real_t* z, size_t n);
+            void hemisphere_from_unit(real_t* x, real_t* y, real_t* z, size_t n);
+            void cosine_hemisphere_from_unit(real_t* x, real_t* y, real_t* z, size_t n);
+            void triangle_from_unit(real_t* u, real_t* v, size_t n);
+            void simplex_from_unit(size_t d, real_t* out, size_t n);
+        }
+#endif
+
+        DF_DISPATCH_BEGIN
+        namespace
+        {
+            // Every transform is a kernel written once over the value type V, run over whole lanes first and
+            // then over the values left, and reading its inputs from the arrays it writes
+            template <typename V>
+            void circle_kernel(V t, V& x, V& y)
+            {
+                simd::sincos_turn(t, y, x);
+            }
+
+            template <typename V>
+            void disk_kernel(V r2, V t, V& x, V& y)
+            {
+                V s, c;
+                simd::sincos_turn(t, s, c);
+                const V r = simd::sqrt(r2);
+                x = r * c;
+                y = r * s;
+            }
+
+            // z is the height, and the circle of radius sqrt(1 - z^2) = sqrt((1 - z)(1 + z)) at that height
+            template <typename V>
+            void sphere_kernel(V z, V t, V& x, V& y)
+            {
+                V s, c;
+                simd::sincos_turn(t, s, c);
+                const V r = simd::sqrt(simd::max(V(0.0), (V(1.0) - z) * (V(1.0) + z)));
+                x = r * c;
+                y = r * s;
+            }
+
+            template <typename V>
+            void cosine_kernel(V r2, V t, V& x, V& y, V& z)
+            {
+                disk_kernel(r2, t, x, y);
+                z = simd::sqrt(V(1.0) - r2);
+            }
+        }
+
+        void circle_from_unit(real_t* x, real_t* y, size_t n)
+        {
+            DF_DISPATCH(circle_from_unit(x, y, n));
+            size_t i = 0;
+#if defined(DF_SIMD_REAL)
+            typedef simd::vreal V;
+            for (; i + V::width <= n; i += V::width) {
+                V vx, vy;
+                circle_kernel(V::load(x + i), vx, vy);
+                vx.store(x + i);
+                vy.store(y + i);
+            }
+#endif
+            for (; i < n; i++)
+                circle_kernel(x[i], x[i], y[i]);
+        }
+
+        void disk_from_unit(real_t* x, real_t* y, size_t n)
+        {
+            DF_DISPATCH(disk_from_unit(x, y, n));
+            size_t i = 0;
+#if defined(DF_SIMD_REAL)
+            typedef simd::vreal V;
+            for (; i + V::width <= n; i += V::width) {
+                V vx, vy;
+                disk_kernel(V::load(x + i), V::load(y + i), vx, vy);
+                vx.store(x + i);
+                vy.store(y + i);
+            }
+#endif
+            for (; i < n; i++)
+                disk_kernel(x[i], y[i], x[i], y[i]);
+        }
+
+        void hemisphere_from_unit(real_t* x, real_t* y, real_t* z, size_t n)
+        {
+            DF_DISPATCH(hemisphere_from_unit(x, y, z, n));
+            size_t i = 0;
+#if defined(DF_SIMD_REAL)
+            typedef simd::vreal V;
+            for (; i + V::width <= n; i += V::width) {
+                V vx, vy;
+                sphere_kernel(V::load(z + i), V::load(x + i), vx, vy);
+                vx.store(x + i);
+                vy.store(y + i);
+            }
+#endif
+            for (; i < n; i++)
+                sphere_kernel(z[i], x[i], x[i], y[i]);
+        }
+
+        void sphere_from_unit(real_t* x, real_t* y, real_t* z, size_t n)
+        {
+            DF_DISPATCH(sphere_from_unit(x, y, z, n));
+            for (size_t i = 0; i < n; i++)
+                z[i] = 2 * z[i] - 1;
+            hemisphere_from_unit(x, y, z, n);
+        }
+
+        void cosine_hemisphere_from_unit(real_t* x, real_t* y, real_t* z, size_t n)
+        {
+            DF_DISPATCH(cosine_hemisphere_from_unit(x, y, z, n));
+            size_t i = 0;
+#if defined(DF_SIMD_REAL)
+            typedef simd::vreal V;
+            for (; i + V::width <= n; i += V::width) {
+                V vx, vy, vz;
+                cosine_kernel(V::load(x + i), V::load(y + i), vx, vy, vz);
+                vx.store(x + i);
+                vy.store(y + i);
+                vz.store(z + i);
+            }
+#endif
+            for (; i < n; i++)
+                cosine_kernel(x[i], y[i], x[i], y[i], z[i]);
+        }
+
+        void triangle_from_unit(real_t* u, real_t* v, size_t n)
+        {
+            DF_DISPATCH(triangle_from_unit(u, v, n));
+            // Points past the diagonal u + v = 1 are mirrored through the centre of the square
+            for (size_t i = 0; i < n; i++) {
+                const bool fold = u[i] + v[i] > 1;
+                u[i] = fold ? 1 - u[i] : u[i];
+                v[i] = fold ? 1 - v[i] : v[i];
+            }
+        }
+
+        void simplex_from_unit(size_t d, real_t* out, size_t n)
+        {
+            DF_DISPATCH(simplex_from_unit(d, out, n));
+            if (d == 1) {
+                for (size_t i = 0; i < n; i++)
+                    out[i] = 1;
+                return;
+            }
+            // 1 - u is in (0, 1], so that every variate is finite
+            size_t i = 0;
+            const size_t m = d * n;
+#if defined(DF_SIMD_REAL)
+            typedef simd::vreal V;
+            for (; i + V::width <= m; i += V::width)
+                (-simd::log(V(1.0) - V::load(out + i))).store(out + i);
+#endif
+            for (; i < m; i++)
+                out[i] = -std::log(1 - out[i]);
+
+            // The sums of the points a block at a time, the rows read one after the other
+            real_t sum[256];
+            for (size_t first = 0; first < n; first += 256) {
+                const size_t b = (n - first < 256) ? n - first : 256;
+                for (size_t k = 0; k < b; k++)
+                    sum[k] = out[first + k];
+                for (size_t j = 1; j < d; j++)
+                    for (size_t k = 0; k < b; k++)
+                        sum[k] += out[j * n + first + k];
+                for (size_t k = 0; k < b; k++)
+                    sum[k] = 1 / sum[k];
+                for (size_t j = 0; j < d; j++)
+                    for (size_t k = 0; k < b; k++)
+                        out[j * n + first + k] *= sum[k];
+            }
+        }
+        DF_DISPATCH_END
+    }
+}
+
+// src/Core/process.cpp
+
+
+namespace DiceForge
+{
+    PoissonProcess::PoissonProcess(real_t rate, real_t start) : m_rate(rate), inv_rate(1 / rate), t(start)
+    {
+        if (!(rate > 0) || !std::isfinite(rate))
+            throw std::invalid_argument("The rate must be positive and finite!");
+    }
+
+    real_t PoissonProcess::time() const
+    {
+        return t;
+    }
+
+    void PoissonProcess::reset(real_t start)
+    {
+        t = start;
+    }
+
+    real_t PoissonProcess::rate() const
+    {
+        return m_rate;
+    }
+
+    void PoissonProcess::write_state(detail::StateWriter& out) const
+    {
+        out.tag("PoissonProcess");
+        out.put(m_rate);
+        out.put(t);
+    }
+
+    void PoissonProcess::read_state(detail::StateReader& in)
+    {
+        in.tag("PoissonProcess");
+        const real_t rate = in.get<real_t>(), time = in.get<real_t>();
+        in.end();
+        *this = PoissonProcess(rate, time);
+    }
+
+    GaussianRandomWalk::GaussianRandomWalk(size_t paths, real_t mu, real_t sigma, real_t x0)
+        : PathProcess(paths, x0), mu(mu), sigma(sigma)
+    {
+        if (!(sigma >= 0))
+            throw std::invalid_argument("Value of sigma must not be negative!");
+    }
+
+    void GaussianRandomWalk::step(real_t* z)
+    {
+        real_t* x = state.data();
+        for (size_t p = 0; p < state.size(); p++)
+            z[p] = x[p] = x[p] + mu + sigma * z[p];
+    }
+
+    GeometricBrownianMotion::GeometricBrownianMotion(size_t paths, real_t s0, real_t mu, real_t sigma, real_t dt)
+        : PathProcess(paths, s0), mu(mu), sigma(sigma), dt(dt)
+    {
+        if (!(s0 > 0) || !(sigma >= 0) || !(dt > 0))
+            throw std::invalid_argument("Expected s0 > 0, sigma >= 0 and dt > 0!");
+        drift = (mu - sigma * sigma / 2) * dt;
+        volatility = sigma * std::sqrt(dt);
+    }
+
+    void GeometricBrownianMotion::step(real_t* z)
+    {
+        real_t* s = state.data();
+        const size_t n = state.size();
+        size_t p = 0;
+#if defined(DF_SIMD_REAL)
+        typedef simd::vreal V;
+        for (; p + V::width <= n; p += V::width) {
+            const V next = V::load(s + p) * simd::exp(V(drift) + V(volatility) * V::load(z + p));
+            next.store(s + p);
+            next.store(z + p);
+        }
+#endif
+        for (; p < n; p++)
+            z[p] = s[p] = s[p] * std::exp(drift + volatility * z[p]);
+    }
+
+    OrnsteinUhlenbeck::OrnsteinUhlenbeck(size_t paths, real_t theta, real_t mu, real_t sigma, real_t dt, real_t x0)
+        : PathProcess(paths, x0), theta(theta), mu(mu), sigma(sigma), dt(dt)
+    {
+        if (!(theta > 0) || !(sigma >= 0) || !(dt > 0))
+            throw std::invalid_argument("Expected theta > 0, sigma >= 0 and dt > 0!");
+        decay = std::exp(-theta * dt);
+        // 1 - e^(-2 theta dt) without the cancellation of small steps
+        deviation = sigma * std::sqrt(-std::expm1(-2 * theta * dt) / (2 * theta));
+    }
+
+    void OrnsteinUhlenbeck::step(real_t* z)
+    {
+        real_t* x = state.data();
+        for (size_t p = 0; p < state.size(); p++)
+            z[p] = x[p] = mu + (x[p] - mu) * decay + deviation * z[p];
+    }
+
+    real_t OrnsteinUhlenbeck::stationary_deviation() const
+    {
+        return sigma / std::sqrt(2 * theta);
+    }
+
+    // The states hold the parameters, the number of steps and the values of the paths, whose number must match
+
+    void GaussianRandomWalk::write_state(detail::StateWriter& out) const
+    {
+        out.tag("GaussianRandomWalk");
+        out.put(uint64_t(state.size()));
+        out.put(mu);
+        out.put(sigma);
+        out.put(m_steps);
+        out.put(state.data(), state.size());
+    }
+
+    void GaussianRandomWalk::read_state(detail::StateReader& in)
+    {
+        in.tag("GaussianRandomWalk");
+        in.expect(uint64_t(state.size()));
+        const real_t m = in.get<real_t>(), s = in.get<real_t>();
+        GaussianRandomWalk walk(state.size(), m, s);
+        walk.m_steps = in.get<uint64_t>();
+        in.get(walk.state.data(), walk.state.size());
+        in.end();
+        *this = walk;
+    }
+
+    void GeometricBrownianMotion::write_state(detail::StateWriter& out) const
+    {
+        out.tag("GeometricBrownianMotion");
+        out.put(uint64_t(state.size()));
+        out.put(mu);
+        out.put(sigma);
+        out.put(dt);
+        out.put(m_steps);
+        out.put(state.data(), state.size());
+    }
+
+    void GeometricBrownianMotion::read_state(detail::StateReader& in)
+    {
+        in.tag("GeometricBrownianMotion");
+        in.expect(uint64_t(state.size()));
+        const real_t m = in.get<real_t>(), s = in.get<real_t>(), d = in.get<real_t>();
+        GeometricBrownianMotion motion(state.size(), 1, m, s, d);
+        motion.m_steps = in.get<uint64_t>();
+        in.get(motion.state.data(), motion.state.size());
+        in.end();
+        *this = motion;
+    }
+
+    void OrnsteinUhlenbeck::write_state(detail::StateWriter& out) const
+    {
+        out.tag("OrnsteinUhlenbeck");
+        out.put(uint64_t(state.size()));
+        out.put(theta);
+        out.put(mu);
+        out.put(sigma);
+        out.put(dt);
+        out.put(m_steps);
+        out.put(state.data(), state.size());
+    }
+
+    void OrnsteinUhlenbeck::read_state(detail::StateReader& in)
+    {
+        in.tag("OrnsteinUhlenbeck");
+        in.expect(uint64_t(state.size()));
+        const real_t t = in.get<real_t>(), m = in.get<real_t>(), s = in.get<real_t>(), d = in.get<real_t>();
+        OrnsteinUhlenbeck process(state.size(), t, m, s, d);
+        process.m_steps = in.get<uint64_t>();
+        in.get(process.state.data(), process.state.size());
+        in.end();
+        *this = process;
+    }
+}
+
+// src/Core/sampler.cpp
+
+
+#include <cmath>
+
+namespace DiceForge
+{
+    WeightedSampler::WeightedSampler(std::vector<real_t> weights)
+    {
+        if (weights.empty())
+            throw std::invalid_argument("Weight sequence must have non-zero length!");
+        for (real_t w : weights)
+            check_weight(w);
+        build(std::move(weights));
+    }
+
+    size_t WeightedSampler::size() const
+    {
+        return m_weights.size();
+    }
+
+    real_t WeightedSampler::weight(size_t i) const
+    {
+        return m_weights.at(i);
+    }
+
+    real_t WeightedSampler::probability(size_t i) const
+    {
+        return m_weights.at(i) / m_total;
+    }
+
+    void WeightedSampler::update(size_t i, real_t weight)
+    {
+        std::vector<real_t> weights = m_weights;
+        set_weight(weights, i, weight);
+        build(std::move(weights));
+    }
+
+    size_t WeightedSampler::index(real_t r) const
+    {
+        real_t x = r * m_prob.size();
+        size_t i = size_t(x);
+        if (i >= m_prob.size())
+            i = m_prob.size() - 1;
+        return (x - i < m_prob[i]) ? i : m_alias[i];
+    }
+
+    void WeightedSampler::check_weight(real_t weight)
+    {
+        if (!(weight >= 0) || !std::isfinite(weight))
+            throw std::invalid_argument("Weights must be finite and not negative!");
+    }
+
+    void WeightedSampler::set_weight(std::vector<real_t>& weights, size_t i, real_t weight)
+    {
+        if (i >= weights.size())
+            throw std::invalid_argument("Index out of range!");
+        check_weight(weight);
+        weights[i] = weight;
+    }
+
+    void WeightedSampler::build(std::vector<real_t> weights)
+    {
+        const size_t n = weights.size();
+        real_t total = 0;
+        for (real_t w : weights)
+            total += w;
+        if (!(total > 0))
+            throw std::invalid_argument("Weights must not all be zero!");
+        if (!std::isfinite(total))
+            throw std::invalid_argument("The sum of the weights must be finite!");
+
+        // Scale the weights to average 1, then repeatedly top up a column below 1 from one above 1
+        std::vector<real_t> prob(n);
+        std::vector<size_t> alias(n);
+        std::vector<size_t> small, large;
+        for (size_t i = 0; i < n; i++) {
+            prob[i] = weights[i] * n / total;
+            alias[i] = i;
+            (prob[i] < 1 ? small : large).push_back(i);
+        }
+        while (!small.empty() && !large.empty()) {
+            size_t s = small.back(), l = large.back();
+            small.pop_back();
+            alias[s] = l;
+            prob[l] -= 1 - prob[s];
+            if (prob[l] < 1) {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+        // Whatever is left is 1 up to rounding
+        for (size_t i : large)
+            prob[i] = 1;
+        for (size_t i : small)
+            prob[i] = 1;
+
+        m_weights = std::move(weights);
+        m_total = total;
+        m_prob = std::move(prob);
+        m_alias = std::move(alias);
+    }
+}
+
+// src/Core/special.cpp
+
+
+#include <algorithm>
+#include <limits>
+
+namespace DiceForge
+{
+namespace special
+{
+#if defined(DF_DISPATCH_AVX2)
+    // The batch functions compiled for AVX2 and FMA
+    namespace avx2
+    {
+        void erf(const real_t* x, real_t* out, size_t n);
+        void erfc(const real_t* x, real_t* out, size_t n);
+        void normal_cdf(const real_t* z, real_t* out, size_t n);
+        void normal_quantile(const real_t* p, real_t* out, size_t n);
+    }
+#endif
+
+    DF_DISPATCH_BEGIN
+    namespace
+    {
+        // Polynomials sum a_k u^k in u = v * scale - shift, for
+        //   erf(x) / x             in v = x^2 for |x| < 1
+        //   erfc(x) e^(x^2)        in v = x on [0.5, 1], [1, 2], [2, 3.5] and [3.5, 6]
+        //   x erfc(x) e^(x^2)      in v = 1 / x^2 for x >= 6
+        // converted from Chebyshev expansions fitted in 90 digit arithmetic and cut off where the terms fall below
+        // 1e-19. The coefficients alternate and add up to less than twice the smallest value on |u| <= 1, so the
+        // power form loses nothing to cancellation and evaluates with more instruction-level parallelism.
+        constexpr int max_terms = 21;
+        struct polynomial_piece
+        {
+            real_t scale, shift;
+            int terms;
+            real_t a[max_terms];
+        };
+
+        constexpr polynomial_piece pieces[6] = {
+            {2.0, 1.0, 14,
+             {9.65468738669867265756e-01, -1.40536089022717108898e-01, 1.98524966889837076178e-02,
+              -2.28548556114406727080e-03, 2.17517156041601079268e-04, -1.75371694414920990313e-05,
+              1.22338273835240093022e-06, -7.51156916067813822249e-08, 4.11580059766495968551e-09,
+              -2.03524939202478536928e-10, 9.16760674606944502151e-12, -3.79109303927172170678e-13,
+              1.45481707596067904631e-14, -5.16606161680598076402e-16}},
+            {4.0, 3.0, 16,
+             {5.06937650293144859148e-01, -9.19931729139488452152e-02, 1.44348832219561434842e-02,
+              -2.02868846867001713721e-03, 2.60900556748306852728e-04, -3.11496699606254385173e-05,
+              3.48857389311855623390e-06, -3.69356219320466672692e-07, 3.71953940324303402631e-08,
+              -3.58013936662367072479e-09, 3.30687768670661627797e-10, -2.94100278501381327140e-11,
+              2.52492769854139230995e-12, -2.09877560325673482913e-13, 1.73366132943734678340e-14,
+              -1.35866642003184424488e-15}},
+            {2.0, 3.0, 18,
+             {3.21585416454317485346e-01, -8.18114588662800373831e-02, 1.90377599638693467687e-02,
+              -4.11636316244532850933e-03, 8.36083809566782153178e-04, -1.60811173374564883413e-04,
+              2.94708574524389269695e-05, -5.17132864357793881120e-06, 8.72304476034927648280e-07,
+              -1.41911958548499374912e-07, 2.23284128800710492717e-08, -3.40575474429394271400e-09,
+              5.04660297632011433416e-10, -7.27683737113064985099e-11, 1.01981701662763113800e-11,
+              -1.39881721619153167911e-12, 2.02921511637611651703e-13, -2.66418417346076753375e-14}},
+            {4.0 / 3, 11.0 / 3, 19,
+             {1.93662096279068690619e-01, -4.74282281704761290997e-02, 1.11142085553691104954e-02,
+              -2.50354880029600608549e-03, 5.44086455892283608199e-04, -1.14427153955736851947e-04,
+              2.33475421355103277498e-05, -4.63170526801472153986e-06, 8.95025082283777466692e-07,
+              -1.68743338498511473285e-07, 3.10837006828605971749e-08, -5.60142977778186391642e-09,
+              9.88592276073748777497e-10, -1.71088003486480988223e-10, 2.90484032109230475470e-11,
+              -4.80958588122338375960e-12, 7.87898324241981307008e-13, -1.43968632961225710827e-13,
+              2.28925370780666517761e-14}},
+            {0.8, 3.8, 21,
+             {1.16302707210247310843e-01, -2.93793107477039391884e-02, 7.28332245151928122512e-03,
+              -1.77363065826111705389e-03, 4.24629648536757001859e-04, -1.00023746138343778782e-04,
+              2.31976110472795492333e-05, -5.30036792854462928998e-06, 1.19383317248503706782e-06,
+              -2.65208980643889230314e-07, 5.81371971395507886844e-08, -1.25817235889070126760e-08,
+              2.68924424668368963677e-09, -5.67910833193717701787e-10, 1.18544257747461759847e-10,
+              -2.44941924363187033400e-11, 5.00076192420014874999e-12, -9.87956069176927902394e-13,
+              1.97192426586793410188e-13, -4.88127375048108068058e-14, 9.61698852074753442763e-15}},
+            {72.0, 1.0, 13,
+             {5.60350520556021081120e-01, -3.76272487307751420799e-03, 7.38713831321358106383e-05,
+              -2.35783333071174875607e-06, 1.02864657556038075170e-07, -5.63765510572339897647e-09,
+              3.69264968089351789595e-10, -2.79697016254181523095e-11, 2.39345157074314132656e-12,
+              -2.27233364577764864547e-13, 2.36441066421901805530e-14, -2.81354982296859576907e-15,
+              3.45171965870255511508e-16}}};
+
+        // erfc(x) is below the smallest subnormal from here on
+        constexpr real_t erfc_cutoff = 27.3;
+
+        // Estrin's scheme for sum a(k) u^k over lo <= k < lo + n, split in two halves of which the upper one is
+        // scaled by u^h (h the largest power of two below n, powers[j] = u^(2^j)), unrolled at compile time
+        template <int lo, int n, typename V, typename Coefficient>
+        V estrin(const V* powers, Coefficient a)
+        {
+            if constexpr (n == 1)
+                return V(a(lo));
+            else
+            {
+                constexpr int level = (n > 16) ? 4 : (n > 8) ? 3 : (n > 4) ? 2 : (n > 2) ? 1 : 0;
+                constexpr int h = 1 << level;
+                return estrin<lo, h>(powers, a) + powers[level] * estrin<lo + h, n - h>(powers, a);
+            }
+        }
+
+        template <int n, typename V, typename Coefficient>
+        V estrin(V u, Coefficient a)
+        {
+            static_assert(n <= 32, "the powers of u go up to u^16");
+            V powers[5] = {u};
+            for (int j = 1; j < 5; j++)
+                powers[j] = powers[j - 1] * powers[j - 1];
+            return estrin<0, n>(powers, a);
+        }
+
+        template <int i, typename V>
+        V piece(V v)
+        {
+            return estrin<pieces[i].terms>(v * pieces[i].scale - pieces[i].shift,
+                                           [](int k) { return pieces[i].a[k]; });
+        }
+
+        // Which expansion covers y >= 0: 0 (erf(y) / y) below `small`, which is 1 for erf and 1/2 for erfc, whose
+        // relative accuracy would suffer from 1 - erf(y) beyond; 1 to 5 (erfc(y) e^(y^2)) above. NaN gives 0.
+        int piece_index(real_t y, real_t small)
+        {
+            return (y < small) ? 0 : (y < 1) ? 1 : (y < 2) ? 2 : (y < 3.5) ? 3 : (y < 6) ? 4 : 5;
+        }
+
+        // The value of expansion i at y, in every lane
+        template <typename V>
+        V piece_value(int i, V y)
+        {
+            switch (i)
+            {
+            case 0:
+                return piece<0>(y * y);
+            case 1:
+                return piece<1>(y);
+            case 2:
+                return piece<2>(y);
+            case 3:
+                return piece<3>(y);
+            case 4:
+                return piece<4>(y);
+            default:
+                return piece<5>(V(1.0) / (y * y)) / y;
+            }
+        }
+
+        // e^(-scale y^2) for 0 <= y < 64 and scale 1 or 1/2: y = hi + lo with hi a multiple of 2^-20, so that
+        // hi^2 is exact and the rounding of y^2 (up to 4000 ulp of e^(-y^2) in the far tail) is avoided. The
+        // remaining factor e^(-scale lo (y + hi)), within 3e-5 of 1, is its cubic Taylor polynomial.
+        template <typename V>
+        V exp_minus_square(V y, real_t scale)
+        {
+            const V shifter(4294967296.0); // 2^32, whose ulp is 2^-20
+            V hi = (y + shifter) - shifter;
+            V t = (y - hi) * (y + hi) * -scale;
+            return simd::exp(hi * hi * -scale) * (V(1.0) + t * (V(1.0) + t * (V(0.5) + t * (1.0 / 6))));
+        }
+
+        // Horner's scheme, highest coefficient first
+        template <typename V, int N>
+        V polynomial(const real_t (&c)[N], V t)
+        {
+            V r(c[0]);
+            for (int k = 1; k < N; k++)
+                r = r * t + V(c[k]);
+            return r;
+        }
+
+        // Acklam's approximation of the normal quantile, in r = q - 1/2, r^2 below and t = sqrt(-2 log q) in the tail
+        constexpr real_t acklam_a[6] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                                        1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+        constexpr real_t acklam_b[6] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                                        6.680131188771972e+01, -1.328068155288572e+01, 1.0};
+        constexpr real_t acklam_c[6] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                                        -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+        constexpr real_t acklam_d[5] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                                        3.754408661907416e+00, 1.0};
+        constexpr real_t acklam_low = 0.02425;
+        constexpr real_t sqrt_2pi = 2.50662827463100050242;
+
+        // erf, erfc and normal_cdf in every lane of x, all the lanes falling in expansion k (see piece_index) of |x|,
+        // or of |z| / sqrt(2) for normal_cdf; on real_t they are the scalar functions
+        template <typename V>
+        V erf_kernel(int k, V x)
+        {
+            const V y = simd::min(V(erfc_cutoff), simd::max(x, -x));
+            const V f = piece_value(k, y);
+            if (k == 0)
+                return x * f;
+            const V tail = exp_minus_square(y, 1.0) * f;
+            return simd::select(x < V(0.0), tail - V(1.0), V(1.0) - tail);
+        }
+
+        template <typename V>
+        V erfc_kernel(int k, V x)
+        {
+            const V y = simd::min(V(erfc_cutoff), simd::max(x, -x));
+            const V f = piece_value(k, y);
+            if (k == 0)
+                return V(1.0) - x * f;
+            const V tail = exp_minus_square(y, 1.0) * f;
+            return simd::select(x < V(0.0), V(2.0) - tail, tail);
+        }
+
+        template <typename V>
+        V normal_cdf_kernel(int k, V z)
+        {
+            // 0.5 erfc(x), with e^(-x^2) taken as e^(-z^2 / 2) from z itself
+            const V x = z * -M_SQRT1_2;
+            const V y = simd::min(V(erfc_cutoff), simd::max(x, -x));
+            const V f = piece_value(k, y);
+            if (k == 0)
+                return V(0.5) - x * f * 0.5;
+            const V tail = exp_minus_square(simd::min(V(erfc_cutoff * M_SQRT2), simd::max(z, -z)), 0.5) * f * 0.5;
+            return simd::select(x < V(0.0), V(1.0) - tail, tail);
+        }
+
+        // Runs kernel(k, x) over the n values, a vector at a time where all the lanes fall in the same expansion k
+        // of |x| * scale and lane by lane elsewhere (out may be x)
+        template <typename Kernel>
+        void apply(Kernel kernel, real_t scale, real_t small, const real_t* x, real_t* out, size_t n)
+        {
+            size_t i = 0;
+#if defined(DF_SIMD_REAL)
+            typedef simd::vreal V;
+            for (; i + V::width <= n; i += V::width)
+            {
+                int k[V::width];
+                bool same = true;
+                for (int j = 0; j < V::width; j++)
+                {
+                    k[j] = piece_index(std::fabs(x[i + j]) * scale, small);
+                    same = same && k[j] == k[0];
+                }
+                if (same)
+                    kernel(k[0], V::load(x + i)).store(out + i);
+                else
+                {
+                    simd::zero_upper();
+                    for (int j = 0; j < V::width; j++)
+                        out[i + j] = kernel(k[j], x[i + j]);
+                }
+            }
+#endif
+            for (; i < n; i++)
+                out[i] = kernel(piece_index(std::fabs(x[i]) * scale, small), x[i]);
+        }
+
+        // Acklam's guess for the lower tail probability q <= 1/2, in the tail and in the middle
+        template <typename V>
+        V acklam_tail(V q)
+        {
+            const V t = simd::sqrt(simd::log(q) * -2.0);
+            return polynomial(acklam_c, t) / polynomial(acklam_d, t);
+        }
+
+        template <typename V>
+        V acklam_central(V q)
+        {
+            const V r = q - V(0.5);
+            return polynomial(acklam_a, r * r) * r / polynomial(acklam_b, r * r);
+        }
+
+        // Halley's step on normal_cdf(x) = q, from c = normal_cdf(x)
+        template <typename V>
+        V halley(V x, V q, V c)
+        {
+            const V u = (c - q) * sqrt_2pi * simd::exp(x * x * 0.5);
+            return x - u / (V(1.0) + x * u * 0.5);
+        }
+
+#if !defined(DF_DISPATCH_VARIANT)
+        /* Incomplete gamma and beta functions */
+
+        constexpr real_t epsilon = std::numeric_limits<real_t>::epsilon();
+        constexpr real_t tiny = 1e-300;
+        constexpr int max_iterations = 10000000;
+
+        // log Gamma(a) - ((a - 1/2) log a - a + log(2 pi) / 2), the error of Stirling's formula for real a > 0
+        real_t log_gamma_error(real_t a)
+        {
+            if (a < 10)
+                return std::lgamma(a) - ((a - 0.5) * std::log(a) - a + detail::half_log_2pi);
+            const real_t r = 1 / a, r2 = r * r;
+            return r * (1.0 / 12 - r2 * (1.0 / 360 - r2 * (1.0 / 1260 - r2 * (1.0 / 1680 - r2 * (1.0 / 1188
+                   - r2 * (691.0 / 360360))))));
+        }
+
+        // a log(y / a), through log1p when y is close to a
+        real_t log_ratio(real_t a, real_t y)
+        {
+            const real_t t = (y - a) / a;
+            return a * ((std::fabs(t) < 0.5) ? std::log1p(t) : std::log(y / a));
+        }
+
+        // log(x^a e^-x / Gamma(a)) = a log(x / a) - (x - a) + log(a) / 2 - log(2 pi) / 2 - log_gamma_error(a)
+        real_t log_gamma_front(real_t a, real_t x)
+        {
+            const real_t t = (x - a) / a;
+            const real_t l = (std::fabs(t) < 0.5) ? a * (std::log1p(t) - t) : a * std::log(x / a) - (x - a);
+            return l + 0.5 * std::log(a) - detail::half_log_2pi - log_gamma_error(a);
+        }
+
+        // P(a, x) by the power series x^a e^-x / Gamma(a) sum x^n / (a (a + 1) ... (a + n))
+        real_t gamma_series(real_t a, real_t x)
+        {
+            real_t term = 1 / a, sum = term;
+            for (int n = 1; n < max_iterations; n++)
+            {
+                term *= x / (a + n);
+                sum += term;
+                if (term < sum * epsilon)
+                    break;
+            }
+            return sum * std::exp(log_gamma_front(a, x));
+        }
+
+        // Q(a, x) by its continued fraction (modified Lentz), for x >= a + 1
+        real_t gamma_fraction(real_t a, real_t x)
+        {
+            real_t b = x + 1 - a, c = 1 / tiny, d = 1 / b, h = d;
+            for (int i = 1; i < max_iterations; i++)
+            {
+                real_t an = -i * (i - a);
+                b += 2;
+                d = an * d + b;
+                if (std::fabs(d) < tiny)
+                    d = tiny;
+                c = b + an / c;
+                if (std::fabs(c) < tiny)
+                    c = tiny;
+                d = 1 / d;
+                real_t delta = d * c;
+                h *= delta;
+                if (std::fabs(delta - 1) < epsilon)
+                    break;
+            }
+            return h * std::exp(log_gamma_front(a, x));
+        }
+
+        // Continued fraction of I_x(a, b) (modified Lentz), without the prefactor x^a (1-x)^b / (a B(a, b))
+        real_t beta_fraction(real_t a, real_t b, real_t x)
+        {
+            real_t c = 1, d = 1 - (a + b) * x / (a + 1);
+            if (std::fabs(d) < tiny)
+                d = tiny;
+            d = 1 / d;
+            real_t h = d;
+            for (int m = 1; m < max_iterations; m++)
+            {
+                real_t m2 = 2 * m;
+                real_t t = m * (b - m) * x / ((a + m2 - 1) * (a + m2));
+                d = 1 + t * d;
+                if (std::fabs(d) < tiny)
+                    d = tiny;
+                c = 1 + t / c;
+                if (std::fabs(c) < tiny)
+                    c = tiny;
+                d = 1 / d;
+                h *= d * c;
+                t = -(a + m) * (a + b + m) * x / ((a + m2) * (a + m2 + 1));
+                d = 1 + t * d;
+                if (std::fabs(d) < tiny)
+                    d = tiny;
+                c = 1 + t / c;
+                if (std::fabs(c) < tiny)
+                    c = tiny;
+                d = 1 / d;
+                real_t delta = d * c;
+                h *= delta;
+                if (std::fabs(delta - 1) < epsilon)
+                    break;
+            }
+            return h;
+        }
+
+        // log(x^a (1-x)^b / B(a, b)), with log B(a, b) from Stirling's formula as in log_gamma_front
+        real_t log_beta_front(real_t a, real_t b, real_t x)
+        {
+            const real_t c = a + b;
+            return log_ratio(a, x * c) + log_ratio(b, (1 - x) * c) + 0.5 * std::log(a * b / c) - detail::half_log_2pi
+                   - log_gamma_error(a) - log_gamma_error(b) + log_gamma_error(c);
+        }
+#endif
+    }
+
+#if !defined(DF_DISPATCH_VARIANT)
+    real_t erf(real_t x)
+    {
+        return erf_kernel(piece_index(std::fabs(x), 1.0), x);
+    }
+
+    real_t erfc(real_t x)
+    {
+        return erfc_kernel(piece_index(std::fabs(x), 0.5), x);
+    }
+
+    real_t normal_cdf(real_t z)
+    {
+        return normal_cdf_kernel(piece_index(std::fabs(z) * M_SQRT1_2, 0.5), z);
+    }
+
+    real_t normal_quantile(real_t p)
+    {
+        if (!(p > 0 && p < 1))
+            return (p == 0) ? -INFINITY : (p == 1) ? INFINITY : NAN;
+        // the lower tail probability, 1 - p being exact for p >= 1/2
+        const real_t q = std::min(p, 1 - p);
+        real_t x = (q < acklam_low) ? acklam_tail(q) : acklam_central(q);
+        const real_t r = halley(x, q, normal_cdf(x));
+        if (std::isfinite(r))
+            x = r;
+        return (p > 0.5) ? -x : x;
+    }
+#endif
+
+    void erf(const real_t* x, real_t* out, size_t n)
+    {
+        DF_DISPATCH(erf(x, out, n));
+        apply([](int k, auto v) { return erf_kernel(k, v); }, 1.0, 1.0, x, out, n);
+    }
+
+    void erfc(const real_t* x, real_t* out, size_t n)
+    {
+        DF_DISPATCH(erfc(x, out, n));
+        apply([](int k, auto v) { return erfc_kernel(k, v); }, 1.0, 0.5, x, out, n);
+    }
+
+    void normal_cdf(const real_t* z, real_t* out, size_t n)
+    {
+        DF_DISPATCH(normal_cdf(z, out, n));
+        apply([](int k, auto v) { return normal_cdf_kernel(k, v); }, M_SQRT1_2, 0.5, z, out, n);
+    }
+
+    void normal_quantile(const real_t* p, real_t* out, size_t n)
+    {
+        DF_DISPATCH(normal_quantile(p, out, n));
+        // In blocks: the initial guesses, then their normal_cdf in one batch, then the Halley steps
+        constexpr size_t block = 64;
+        constexpr real_t smallest = std::numeric_limits<real_t>::min();
+        real_t pb[block], q[block], x[block], c[block];
+        for (size_t i = 0; i < n; i += block)
+        {
+            const size_t m = (n - i < block) ? n - i : block;
+            for (size_t j = 0; j < m; j++)
+            {
+                pb[j] = p[i + j];
+                // everything outside [smallest normal, 1) gets a harmless stand-in and is redone at the end
+                q[j] = (pb[j] >= smallest && pb[j] < 1) ? ((pb[j] < 0.5) ? pb[j] : 1 - pb[j]) : 0.5;
+            }
+            size_t j = 0;
+#if defined(DF_SIMD_REAL)
+            typedef simd::vreal V;
+            for (; j + V::width <= m; j += V::width)
+            {
+                const V qv = V::load(q + j);
+                simd::select(qv < V(acklam_low), acklam_tail(qv), acklam_central(qv)).store(x + j);
+            }
+#endif
+            for (; j < m; j++)
+                x[j] = (q[j] < acklam_low) ? acklam_tail(q[j]) : acklam_central(q[j]);
+
+            normal_cdf(x, c, m);
+            j = 0;
+#if defined(DF_SIMD_REAL)
+            for (; j + V::width <= m; j += V::width)
+                halley(V::load(x + j), V::load(q + j), V::load(c + j)).store(x + j);
+#endif
+            for (; j < m; j++)
+                x[j] = halley(x[j], q[j], c[j]);
+
+            for (j = 0; j < m; j++)
+                out[i + j] = (pb[j] >= smallest && pb[j] < 1)
+                             ? ((pb[j] > 0.5) ? -x[j] : x[j]) : special::normal_quantile(pb[j]);
+        }
+    }
+
+#if !defined(DF_DISPATCH_VARIANT)
+
+    real_t gamma_p(real_t a, real_t x)
+    {
+        if (!(a > 0 && x >= 0))
+            return NAN;
+        if (x == 0)
+            return 0;
+        if (std::isinf(x))
+            return 1;
+        return (x < a + 1) ? gamma_series(a, x) : 1 - gamma_fraction(a, x);
+    }
+
+    real_t gamma_q(real_t a, real_t x)
+    {
+        if (!(a > 0 && x >= 0))
+            return NAN;
+        if (x == 0)
+            return 1;
+        if (std::isinf(x))
+            return 0;
+        return (x < a + 1) ? 1 - gamma_series(a, x) : gamma_fraction(a, x);
+    }
+
+    real_t gamma_p_inverse(real_t a, real_t p)
+    {
+        if (!(a > 0 && p >= 0 && p <= 1))
+            return NAN;
+        if (p == 0)
+            return 0;
+        if (p == 1)
+            return INFINITY;
+        real_t x;
+        if (a > 1)
+        {
+            // a (1 - 1/(9a) + z / (3 sqrt(a)))^3, or x^a / Gamma(a + 1) = p far in the lower tail
+            const real_t w = 1 - 1 / (9 * a) + normal_quantile(p) / (3 * std::sqrt(a));
+            x = (w > 0) ? a * w * w * w : std::exp((std::log(p) + std::lgamma(a + 1)) / a);
+        }
+        else
+        {
+            const real_t t = 1 - a * (0.253 + a * 0.12);
+            x = (p < t) ? std::pow(p / t, 1 / a) : 1 - std::log1p(-(p - t) / (1 - t));
+        }
+        // 1 - p is exact above the median
+        const bool upper = p > 0.5;
+        const real_t q = 1 - p;
+        for (int i = 0; i < 32; i++)
+        {
+            const real_t f = upper ? q - gamma_q(a, x) : gamma_p(a, x) - p;
+            const real_t density = std::exp(log_gamma_front(a, x)) / x;
+            if (!(density > 0))
+                break;
+            const real_t u = f / density;
+            real_t next = x - u / (1 - 0.5 * std::min(real_t(1), u * ((a - 1) / x - 1)));
+            if (!(next > 0))
+                next = x / 2;
+            const bool done = std::fabs(next - x) <= 4 * epsilon * next;
+            x = next;
+            if (done)
+                break;
+        }
+        return x;
+    }
+
+    real_t beta_inc(real_t a, real_t b, real_t x)
+    {
+        if (!(a > 0 && b > 0 && x >= 0 && x <= 1))
+            return NAN;
+        if (x == 0)
+            return 0;
+        if (x == 1)
+            return 1;
+        const real_t front = std::exp(log_beta_front(a, b, x));
+        if (x < (a + 1) / (a + b + 2))
+            return front * beta_fraction(a, b, x) / a;
+        return 1 - front * beta_fraction(b, a, 1 - x) / b;
+    }
+#endif
+    DF_DISPATCH_END
+}
+}
+
+// src/Core/statistics.cpp
+
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace DiceForge
+{
+    namespace
+    {
+        // Values per block of Moments::add, merged into the totals one block at a time
+        constexpr size_t moments_block = 1024;
+
+        // Pearson's statistic over the cells (below lo, the bins, above hi) given P(X < edge) at the edges,
+        // pooling neighbouring cells until each expects at least 5 values
+        TestResult pearson(const std::vector<uint64_t>& counts, uint64_t below, uint64_t above,
+                           const std::vector<real_t>& edges, size_t fitted)
+        {
+            uint64_t n = below + above;
+            for (uint64_t c : counts)
+                n += c;
+            const real_t total = real_t(n);
+            const size_t cells = counts.size() + 2;
+            real_t statistic = 0, observed = 0, expected = 0, last_observed = 0, last_expected = 0;
+            size_t groups = 0;
+            bool impossible = false;
+            for (size_t i = 0; i < cells; i++)
+            {
+                const real_t o = real_t(i == 0 ? below : (i == cells - 1 ? above : counts[i - 1]));
+                const real_t p = (i == 0) ? edges.front() : (i == cells - 1 ? 1 - edges.back() : edges[i] - edges[i - 1]);
+                const real_t e = total * std::max(real_t(0), p);
+                impossible = impossible || (e == 0 && o > 0);
+                observed += o;
+                expected += e;
+                if (expected >= 5)
+                {
+                    statistic += (observed - expected) * (observed - expected) / expected;
+                    last_observed = observed;
+                    last_expected = expected;
+                    groups++;
+                    observed = expected = 0;
+                }
+            }
+            // What is left joins the last group
+            if (expected > 0 || observed > 0)
+            {
+                if (groups > 0)
+                {
+                    statistic -= (last_observed - last_expected) * (last_observed - last_expected) / last_expected;
+                    observed += last_observed;
+                    expected += last_expected;
+                }
+                else
+                    groups = 1;
+                statistic += (expected > 0) ? (observed - expected) * (observed - expected) / expected : 0;
+            }
+            TestResult result;
+            result.dof = (groups > 1 + fitted) ? groups - 1 - fitted : 0;
+            if (impossible)
+            {
+                result.statistic = std::numeric_limits<real_t>::infinity();
+                result.p_value = 0;
+            }
+            else
+            {
+                result.statistic = statistic;
+                result.p_value = (result.dof > 0) ? special::gamma_q(real_t(result.dof) / 2, statistic / 2)
+                                                  : std::numeric_limits<real_t>::quiet_NaN();
+            }
+            return result;
+        }
+
+        // Kolmogorov's distribution, P(K > lambda), by whichever of its two series converges faster
+        real_t kolmogorov_q(real_t lambda)
+        {
+            if (lambda <= 0)
+                return 1;
+            const real_t pi = 3.14159265358979323846;
+            real_t sum = 0;
+            if (lambda < 1.18)
+            {
+                const real_t a = -pi * pi / (8 * lambda * lambda);
+                for (int k = 1; k < 20; k += 2)
+                    sum += std::exp(a * k * k);
+                return std::min(real_t(1), std::max(real_t(0), 1 - std::sqrt(2 * pi) / lambda * sum));
+            }
+            for (int k = 1; k < 100; k++)
+            {
+                const real_t term = std::exp(-2 * k * k * lambda * lambda);
+                sum += (k % 2 == 1) ? term : -term;
+                if (term < 1e-17)
+                    break;
+            }
+            return std::min(real_t(1), std::max(real_t(0), 2 * sum));
+        }
+
+        // Largest distance between the empirical and the hypothesised P(X < edge) over the edges
+        TestResult kolmogorov(const std::vector<uint64_t>& counts, uint64_t below, uint64_t above,
+                              const std::vector<real_t>& edges)
+        {
+            uint64_t total = below + above;
+            for (uint64_t c : counts)
+                total += c;
+            uint64_t cumulative = below;
+            real_t d = std::abs(real_t(cumulative) / real_t(total) - edges[0]);
+            for (size_t i = 0; i < counts.size(); i++)
+            {
+                cumulative += counts[i];
+                d = std::max(d, std::abs(real_t(cumulative) / real_t(total) - edges[i + 1]));
+            }
+            const real_t root = std::sqrt(real_t(total));
+            return {d, kolmogorov_q((root + 0.12 + 0.11 / root) * d), 0};
+        }
+    }
+
+    /* Moments */
+
+    void Moments::merge(uint64_t count, real_t mean, real_t c2, real_t c3, real_t c4, real_t total, real_t lo,
+                        real_t hi)
+    {
+        if (count == 0)
+            return;
+        if (n == 0)
+        {
+            n = count;
+            m1 = mean;
+            m2 = c2;
+            m3 = c3;
+            m4 = c4;
+            sum = total;
+            compensation = 0;
+            low = lo;
+            high = hi;
+            return;
+        }
+        // Chan et al. for the mean and m2, Pébay for the higher moments
+        const real_t na = real_t(n), nb = real_t(count), nt = na + nb;
+        const real_t d = mean - m1, dn = d / nt;
+        m4 += c4 + d * dn * dn * dn * na * nb * (na * na - na * nb + nb * nb) + 6 * dn * dn * (na * na * c2 + nb * nb * m2)
+              + 4 * dn * (na * c3 - nb * m3);
+        m3 += c3 + d * dn * dn * na * nb * (na - nb) + 3 * dn * (na * c2 - nb * m2);
+        m2 += c2 + d * dn * na * nb;
+        m1 += dn * nb;
+        n += count;
+        // Neumaier's compensated sum
+        const real_t t = sum + total;
+        compensation += (std::abs(sum) >= std::abs(total)) ? (sum - t) + total : (total - t) + sum;
+        sum = t;
+        low = std::min(low, lo);
+        high = std::max(high, hi);
+    }
+
+    void Moments::add(real_t x)
+    {
+        merge(1, x, 0, 0, 0, x, x, x);
+    }
+
+    void Moments::add(const real_t* x, size_t count)
+    {
+        for (size_t begin = 0; begin < count; begin += moments_block)
+        {
+            const size_t m = std::min(moments_block, count - begin);
+            const real_t* b = x + begin;
+            // Four partial sums, so the passes are not held up by the latency of the additions
+            real_t s[4] = {0, 0, 0, 0};
+            real_t lo = b[0], hi = b[0];
+            size_t i = 0;
+            for (; i + 4 <= m; i += 4)
+                for (int j = 0; j < 4; j++)
+                {
+                    s[j] += b[i + j];
+                    lo = std::min(lo, b[i + j]);
+                    hi = std::max(hi, b[i + j]);
+                }
+            for (; i < m; i++)
+            {
+                s[0] += b[i];
+                lo = std::min(lo, b[i]);
+                hi = std::max(hi, b[i]);
+            }
+            const real_t total = (s[0] + s[1]) + (s[2] + s[3]);
+            const real_t mean = total / real_t(m);
+            real_t c2[4] = {0, 0, 0, 0}, c3[4] = {0, 0, 0, 0}, c4[4] = {0, 0, 0, 0};
+            for (i = 0; i + 4 <= m; i += 4)
+                for (int j = 0; j < 4; j++)
+                {
+                    const real_t d = b[i + j] - mean, d2 = d * d;
+                    c2[j] += d2;
+                    c3[j] += d2 * d;
+                    c4[j] += d2 * d2;
+                }
+            for (; i < m; i++)
+            {
+                const real_t d = b[i] - mean, d2 = d * d;
+                c2[0] += d2;
+                c3[0] += d2 * d;
+                c4[0] += d2 * d2;
+            }
+            merge(m, mean, (c2[0] + c2[1]) + (c2[2] + c2[3]), (c3[0] + c3[1]) + (c3[2] + c3[3]),
+                  (c4[0] + c4[1]) + (c4[2] + c4[3]), total, lo, hi);
+        }
+    }
+
+    void Moments::add(const int_t* x, size_t count)
+    {
+        real_t block[moments_block];
+        for (size_t begin = 0; begin < count; begin += moments_block)
+        {
+            const size_t m = std::min(moments_block, count - begin);
+            for (size_t i = 0; i < m; i++)
+                block[i] = real_t(x[begin + i]);
+            add(block, m);
+        }
+    }
+
+    void Moments::merge(const Moments& other)
+    {
+        merge(other.n, other.m1, other.m2, other.m3, other.m4, other.sum, other.low, other.high);
+        compensation += other.compensation;
+    }
+
+    uint64_t Moments::count() const
+    {
+        return n;
+    }
+
+    real_t Moments::total() const
+    {
+        return sum + compensation;
+    }
+
+    real_t Moments::mean() const
+    {
+        return m1;
+    }
+
+    real_t Moments::variance() const
+    {
+        return (n < 2) ? 0 : m2 / real_t(n - 1);
+    }
+
+    real_t Moments::skewness() const
+    {
+        return std::sqrt(real_t(n)) * m3 / std::pow(m2, real_t(1.5));
+    }
+
+    real_t Moments::kurtosis() const
+    {
+        return real_t(n) * m4 / (m2 * m2) - 3;
+    }
+
+    real_t Moments::min() const
+    {
+        return low;
+    }
+
+    real_t Moments::max() const
+    {
+        return high;
+    }
+
+    TestResult Moments::mean_test(real_t expectation, real_t variance) const
+    {
+        const real_t z = (m1 - expectation) / std::sqrt(variance / real_t(n));
+        return {z, special::erfc(std::abs(z) / std::sqrt(real_t(2))), 0};
+    }
+
+    void Moments::write_state(detail::StateWriter& out) const
+    {
+        out.tag("Moments");
+        out.put(n);
+        out.put(m1);
+        out.put(m2);
+        out.put(m3);
+        out.put(m4);
+        out.put(sum);
+        out.put(compensation);
+        out.put(low);
+        out.put(high);
+    }
+
+    void Moments::read_state(detail::StateReader& in)
+    {
+        in.tag("Moments");
+        Moments loaded;
+        loaded.n = in.get<uint64_t>();
+        loaded.m1 = in.get<real_t>();
+        loaded.m2 = in.get<real_t>();
+        loaded.m3 = in.get<real_t>();
+        loaded.m4 = in.get<real_t>();
+        loaded.sum = in.get<real_t>();
+        loaded.compensation = in.get<real_t>();
+        loaded.low = in.get<real_t>();
+        loaded.high = in.get<real_t>();
+        in.end();
+        *this = loaded;
+    }
+
+    /* Histogram */
+
+    Histogram::Histogram(real_t lo, real_t hi, size_t bins) : lo(lo), hi(hi), scale(real_t(bins) / (hi - lo)), counts(bins)
+    {
+        if (bins == 0)
+            throw std::invalid_argument("Expected at least one bin");
+        if (!(lo < hi))
+            throw std::invalid_argument("Expected lo < hi");
+    }
+
+    void Histogram::add(const real_t* x, size_t n)
+    {
+        for (size_t i = 0; i < n; i++)
+            add(x[i]);
+    }
+
+    void Histogram::add(const int_t* x, size_t n)
+    {
+        for (size_t i = 0; i < n; i++)
+            add(real_t(x[i]));
+    }
+
+    void Histogram::merge(const Histogram& other)
+    {
+        if (other.lo != lo || other.hi != hi || other.counts.size() != counts.size())
+            throw std::invalid_argument("Only histograms of the same bins can be merged");
+        for (size_t i = 0; i < counts.size(); i++)
+            counts[i] += other.counts[i];
+        below += other.below;
+        above += other.above;
+    }
+
+    size_t Histogram::bins() const
+    {
+        return counts.size();
+    }
+
+    uint64_t Histogram::operator[](size_t i) const
+    {
+        if (i >= counts.size())
+            throw std::out_of_range("No such bin in the histogram");
+        return counts[i];
+    }
+
+    uint64_t Histogram::underflow() const
+    {
+        return below;
+    }
+
+    uint64_t Histogram::overflow() const
+    {
+        return above;
+    }
+
+    uint64_t Histogram::count() const
+    {
+        uint64_t total = below + above;
+        for (uint64_t c : counts)
+            total += c;
+        return total;
+    }
+
+    std::vector<real_t> Histogram::edges(const Continuous& distribution) const
+    {
+        std::vector<real_t> x(counts.size() + 1);
+        for (size_t i = 0; i <= counts.size(); i++)
+            x[i] = lo + (hi - lo) * real_t(i) / real_t(counts.size());
+        distribution.cdf(x.data(), x.data(), x.size());
+        return x;
+    }
+
+    std::vector<real_t> Histogram::edges(const Discrete& distribution) const
+    {
+        // P(X < e) = P(X <= ceil(e) - 1)
+        std::vector<real_t> f(counts.size() + 1);
+        for (size_t i = 0; i <= counts.size(); i++)
+        {
+            const real_t k = std::ceil(lo + (hi - lo) * real_t(i) / real_t(counts.size())) - 1;
+            if (k < real_t(distribution.minValue()))
+                f[i] = 0;
+            else if (k >= real_t(distribution.maxValue()))
+                f[i] = 1;
+            else
+                f[i] = distribution.cdf(int_t(k));
+        }
+        return f;
+    }
+
+    std::vector<real_t> Histogram::edges() const
+    {
+        std::vector<real_t> f(counts.size() + 1);
+        for (size_t i = 0; i <= counts.size(); i++)
+            f[i] = real_t(i) / real_t(counts.size());
+        return f;
+    }
+
+    TestResult Histogram::chi_square(const Continuous& distribution, size_t fitted) const
+    {
+        return pearson(counts, below, above, edges(distribution), fitted);
+    }
+
+    TestResult Histogram::chi_square(const Discrete& distribution, size_t fitted) const
+    {
+        return pearson(counts, below, above, edges(distribution), fitted);
+    }
+
+    TestResult Histogram::chi_square() const
+    {
+        return pearson(counts, below, above, edges(), 0);
+    }
+
+    TestResult Histogram::kolmogorov_smirnov(const Continuous& distribution) const
+    {
+        return kolmogorov(counts, below, above, edges(distribution));
+    }
+
+    TestResult Histogram::kolmogorov_smirnov(const Discrete& distribution) const
+    {
+        return kolmogorov(counts, below, above, edges(distribution));
+    }
+
+    TestResult Histogram::kolmogorov_smirnov() const
+    {
+        return kolmogorov(counts, below, above, edges());
+    }
+
+    void Histogram::write_state(detail::StateWriter& out) const
+    {
+        out.tag("Histogram");
+        out.put(lo);
+        out.put(hi);
+        out.put(uint64_t(counts.size()));
+        out.put(below);
+        out.put(above);
+        out.put(counts.data(), counts.size());
+    }
+
+    void Histogram::read_state(detail::StateReader& in)
+    {
+        in.tag("Histogram");
+        const real_t l = in.get<real_t>(), h = in.get<real_t>();
+        const uint64_t bins = in.get<uint64_t>();
+        if (bins == 0 || !(l < h) || in.remaining() < 16 || bins > (in.remaining() - 16) / 8)
+            throw std::invalid_argument("The saved state does not fit this object");
+        Histogram loaded(l, h, size_t(bins));
+        loaded.below = in.get<uint64_t>();
+        loaded.above = in.get<uint64_t>();
+        in.get(loaded.counts.data(), loaded.counts.size());
+        in.end();
+        *this = loaded;
+    }
+}
+
+// src/Core/streams.cpp
+
+
+namespace DiceForge
+{
+    StreamPlan::StreamPlan(uint64_t root, unsigned node_bits, unsigned thread_bits, unsigned substream_bits)
+        : m_root(root), m_node_bits(node_bits), m_thread_bits(thread_bits), m_substream_bits(substream_bits)
+    {
+        if (uint64_t(node_bits) + thread_bits + substream_bits > 64)
+            throw std::invalid_argument("The widths of the key must add up to at most 64 bits!");
+    }
+
+    uint64_t StreamPlan::root() const
+    {
+        return m_root;
+    }
+
+    uint64_t StreamPlan::index(const StreamKey& key) const
+    {
+        // Whether x fits in the given number of bits
+        auto fits = [](uint64_t x, unsigned bits) {
+            return bits >= 64 || (x >> bits) == 0;
+        };
+        if (!fits(key.node, m_node_bits) || !fits(key.thread, m_thread_bits) || !fits(key.substream, m_substream_bits))
+            throw std::out_of_range("A coordinate of the key does not fit in its width!");
+        // In 128 bits, as a width may be 64
+        const uint128_t i = (((uint128_t(key.node) << m_thread_bits) | key.thread) << m_substream_bits) | key.substream;
+        return uint64_t(i);
+    }
+
+    unsigned StreamPlan::stride_bits() const
+    {
+        return 64 - (m_node_bits + m_thread_bits + m_substream_bits);
+    }
+
+    SeedSequence StreamPlan::job_seed(uint64_t job) const
+    {
+        return SeedSequence{m_root, job};
+    }
+
+    SeedSequence StreamPlan::seed(const StreamKey& key) const
+    {
+        return SeedSequence{m_root, key.job, key.node, key.thread, key.substream};
+    }
+
+    std::pair<uint64_t, uint64_t> StreamPlan::shards(uint64_t count, uint64_t node, uint64_t nodes)
+    {
+        if (nodes == 0 || node >= nodes)
+            throw std::out_of_range("Expected node < nodes!");
+        return {uint64_t(uint128_t(count) * node / nodes), uint64_t(uint128_t(count) * (node + 1) / nodes)};
+    }
+
+    void StreamPlan::write_state(detail::StateWriter& out) const
+    {
+        out.tag("StreamPlan");
+        out.put(m_root);
+        out.put(uint8_t(m_node_bits));
+        out.put(uint8_t(m_thread_bits));
+        out.put(uint8_t(m_substream_bits));
+    }
+
+    void StreamPlan::read_state(detail::StateReader& in)
+    {
+        in.tag("StreamPlan");
+        const uint64_t root = in.get<uint64_t>();
+        const unsigned node_bits = in.get<uint8_t>(), thread_bits = in.get<uint8_t>(), substream_bits = in.get<uint8_t>();
+        in.end();
+        *this = StreamPlan(root, node_bits, thread_bits, substream_bits);
+    }
+}
+
+// src/Core/table.cpp
+
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <chrono>
+#include <fstream>
+
+#if defined(_WIN32)
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace DiceForge
+{
+    namespace
+    {
+        // Written in the representation of the machine, read back as 0x01020304 only on one of the same byte order
+        constexpr uint32_t byte_order_mark = 0x01020304;
+        constexpr size_t name_offset = 24, name_length = 32, entry_size = 24;
+
+        template <typename U>
+        U read_at(const unsigned char* data, size_t offset)
+        {
+            U x;
+            std::memcpy(&x, data + offset, sizeof(U));
+            return x;
+        }
+
+        template <typename U>
+        void write_at(std::vector<unsigned char>& out, size_t offset, U x)
+        {
+            std::memcpy(out.data() + offset, &x, sizeof(U));
+        }
+    }
+
+    TableFile::TableFile(const std::string& path)
+    {
+#if defined(_WIN32)
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            throw std::runtime_error("Cannot open the table file " + path);
+        buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        data = buffer.data();
+        length = buffer.size();
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("Cannot open the table file " + path);
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot open the table file " + path);
+        }
+        length = size_t(st.st_size);
+        if (length > 0) {
+            void* map = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+            if (map == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Cannot map the table file " + path);
+            }
+            data = static_cast<const unsigned char*>(map);
+        }
+        // The mapping stays valid once the descriptor is closed
+        ::close(fd);
+#endif
+        try {
+            if (length < detail::table_header || std::memcmp(data, detail::table_magic, 4) != 0)
+                throw std::invalid_argument("Expected a table file written by DiceForge");
+            if (data[4] != detail::table_version)
+                throw std::invalid_argument("The table file is of an unknown version");
+            if (data[5] != sizeof(real_t) || read_at<uint32_t>(data, 8) != byte_order_mark)
+                throw std::invalid_argument("The table file was written on a machine of another kind");
+            if (read_at<uint64_t>(data, 16) != length)
+                throw std::invalid_argument("The table file is truncated");
+            const char* name = reinterpret_cast<const char*>(data + name_offset);
+            m_name.assign(name, strnlen(name, name_length));
+
+            const size_t m = read_at<uint32_t>(data, 12);
+            if (m > (length - detail::table_header) / entry_size)
+                throw std::invalid_argument("The table file is truncated");
+            directory.resize(m);
+            for (size_t k = 0; k < m; k++) {
+                const size_t at = detail::table_header + k * entry_size;
+                const uint64_t offset = read_at<uint64_t>(data, at), count = read_at<uint64_t>(data, at + 8);
+                const uint32_t element = read_at<uint32_t>(data, at + 16);
+                if (element == 0 || offset % detail::table_alignment != 0 || offset > length
+                    || count > (length - offset) / element)
+                    throw std::invalid_argument("The table file is truncated");
+                directory[k] = {size_t(offset), size_t(count), size_t(element)};
+            }
+        }
+        catch (...) {
+#if !defined(_WIN32)
+            if (data != nullptr)
+                ::munmap(const_cast<unsigned char*>(data), length);
+#endif
+            throw;
+        }
+    }
+
+    TableFile::~TableFile()
+    {
+#if !defined(_WIN32)
+        if (data != nullptr)
+            ::munmap(const_cast<unsigned char*>(data), length);
+#endif
+    }
+
+    const std::string& TableFile::name() const
+    {
+        return m_name;
+    }
+
+    void TableFile::expect(const char* distribution) const
+    {
+        if (m_name != distribution)
+            throw std::invalid_argument("The table file holds the tables of a " + m_name + ", not of a " + distribution);
+    }
+
+    size_t TableFile::arrays() const
+    {
+        return directory.size();
+    }
+
+    const TableFile::Entry& TableFile::entry(size_t k, size_t element) const
+    {
+        if (k >= directory.size())
+            throw std::out_of_range("The table file has no such array");
+        if (directory[k].element != element)
+            throw std::invalid_argument("The array of the table file is not of the expected type");
+        return directory[k];
+    }
+
+    namespace detail
+    {
+        TableWriter::TableWriter(const char* name) : name(name)
+        {
+            if (this->name.size() >= name_length)
+                throw std::invalid_argument("The name of a table file has at most 31 characters");
+        }
+
+        void TableWriter::write(const std::string& path) const
+        {
+            // Header, directory, then the arrays each at an aligned offset
+            size_t length = table_header + arrays.size() * entry_size;
+            std::vector<size_t> offsets;
+            for (const Array& a : arrays) {
+                length = (length + table_alignment - 1) / table_alignment * table_alignment;
+                offsets.push_back(length);
+                length += a.bytes.size();
+            }
+            std::vector<unsigned char> out(length, 0);
+            std::memcpy(out.data(), table_magic, 4);
+            out[4] = table_version;
+            out[5] = (unsigned char)(sizeof(real_t));
+            write_at(out, 8, byte_order_mark);
+            write_at(out, 12, uint32_t(arrays.size()));
+            write_at(out, 16, uint64_t(length));
+            std::memcpy(out.data() + name_offset, name.data(), name.size());
+            for (size_t k = 0; k < arrays.size(); k++) {
+                const size_t at = table_header + k * entry_size;
+                write_at(out, at, uint64_t(offsets[k]));
+                write_at(out, at + 8, uint64_t(arrays[k].count));
+                write_at(out, at + 16, uint32_t(arrays[k].element));
+                if (!arrays[k].bytes.empty())
+                    std::memcpy(out.data() + offsets[k], arrays[k].bytes.data(), arrays[k].bytes.size());
+            }
+
+            // A name of its own for every writer, as several processes may write the same tables at once
+            const std::string temporary = path + ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count())
+                                        + std::to_string(reinterpret_cast<uintptr_t>(this));
+            {
+                std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+                if (!file.write(reinterpret_cast<const char*>(out.data()), std::streamsize(out.size())) || !file.flush()) {
+                    file.close();
+                    std::remove(temporary.c_str());
+                    throw std::runtime_error("Cannot write the table file " + path);
+                }
+            }
+#if defined(_WIN32)
+            std::remove(path.c_str());
+#endif
+            if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+                std::remove(temporary.c_str());
+                throw std::runtime_error("Cannot write the table file " + path);
+            }
+        }
+    }
+}
+
+// src/Core/ziggurat.cpp
+
+
+namespace DiceForge
+{
+    namespace ziggurat
+    {
+        namespace
+        {
+            /// @brief Builds the layers of a decreasing density f with inverse f_inv
+            /// @param r start of the tail
+            /// @param v area of every layer (including the base one, with its tail)
+            template <typename F, typename FInv>
+            Tables build(real_t r, real_t v, F f, FInv f_inv)
+            {
+                Tables t;
+                t.x[0] = v / f(r);
+                t.x[1] = r;
+                for (int i = 2; i < layers; i++)
+                    t.x[i] = f_inv(f(t.x[i - 1]) + v / t.x[i - 1]);
+                t.x[layers] = 0;
+                for (int i = 0; i <= layers; i++)
+                    t.f[i] = f(t.x[i]);
+                return t;
+            }
+        }
+
+        const Tables& normal()
+        {
+            static const Tables tables = build(3.6541528853610088, 0.00492867323399,
+                [](real_t x) { return std::exp(-0.5 * x * x); },
+                [](real_t y) { return std::sqrt(-2.0 * std::log(y)); });
+            return tables;
+        }
+
+        const Tables& exponential()
+        {
+            static const Tables tables = build(7.69711747013104972, 0.0039496598225815571993,
+                [](real_t x) { return std::exp(-x); },
+                [](real_t y) { return -std::log(y); });
+            return tables;
+        }
+
+        namespace
+        {
+            // Rounded towards 0, so that a candidate accepted straight away is always inside its layer
+            FloatTables narrow(const Tables& t)
+            {
+                FloatTables f;
+                for (int i = 0; i <= layers; i++) {
+                    f.x[i] = float(t.x[i]);
+                    if (f.x[i] > t.x[i])
+                        f.x[i] = std::nextafter(f.x[i], 0.0f);
+                }
+                return f;
+            }
+        }
+
+        const FloatTables& normal_float()
+        {
+            static const FloatTables tables = narrow(normal());
+            return tables;
+        }
+
+        const FloatTables& exponential_float()
+        {
+            static const FloatTables tables = narrow(exponential());
+            return tables;
+        }
+    }
+}
+
+// src/Generators/BBS/blumblumshub.cpp
+
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+
+namespace DiceForge
+{
+    const uint64_t BlumBlumShub32::p = 4294967291;
+    const uint64_t BlumBlumShub32::q = 4294967279;
+    const uint64_t BlumBlumShub32::n = BlumBlumShub32::p*BlumBlumShub32::q;
+
+    const uint64_t BlumBlumShub64::p = 4294967291;
+    const uint64_t BlumBlumShub64::q = 4294967279;
+    const uint64_t BlumBlumShub64::n = BlumBlumShub64::p*BlumBlumShub64::q;
+
+    inline void BlumBlumShub32::propagate(){
+        state.square();
+        state.mod(n);
+
+        // Ensure the state is not 0 or 1
+        if((state.data[0] == 0 || state.data[0] == 1)&& state.data[1] != 0){
+            state.data[0] += 429496737ULL; // A random constant to avoid getting stuck at 0 or 1
+            state.data[1] += state.data[0] >> 32;
+            state.data[0] &= 0xFFFFFFFF;
+        }
+    }
+
+    BlumBlumShub32::BlumBlumShub32(uint32_t seed): state(0, 0, 0, 0){
+        reseed(seed);
+    }
+
+    uint32_t BlumBlumShub32::generate() {
+        uint32_t num = 0;
+        for(int i = 0; i < 4; i++){
+            propagate();
+            num = (num << 8) | (state.data[0] & 0xFF); // Extracting LSB and appending
+        }
+        return num;
+    }
+
+    void BlumBlumShub32::generate_block(uint32_t* out, size_t n) {
+        // Qualified call, so the whole block is generated without virtual dispatch
+        for (size_t i = 0; i < n; i++)
+            out[i] = BlumBlumShub32::generate();
+    }
+
+    void BlumBlumShub32::reseed(uint32_t seed) {
+        reseed_from(SeedSequence(seed));
+    }
+
+    void BlumBlumShub32::reseed_from(const SeedSequence& seq) {
+        for(int i = 1; i < 4; i++)
+            state.data[i] = 0;
+        state.data[0] = uint32_t(seq.word(0));
+    }
+
+    void BlumBlumShub32::write_state(detail::StateWriter& out) const {
+        out.tag("BlumBlumShub32");
+        out.put(state.data, 4);
+    }
+
+    void BlumBlumShub32::read_state(detail::StateReader& in) {
+        in.tag("BlumBlumShub32");
+        uint64_t s[4];
+        in.get(s, 4);
+        in.end();
+        std::copy(s, s + 4, state.data);
+    }
+
+    inline void BlumBlumShub64::propagate(){
+        state.square();
+        state.mod(n);
+
+        // Ensure the state is not 0 or 1
+        if((state.data[0] == 0 || state.data[0] == 1)&& state.data[1] != 0){
+            state.data[0] += 429496737ULL; // A random constant to avoid getting stuck at 0 or 1
+            state.data[1] += state.data[0] >> 32;
+            state.data[0] &= 0xFFFFFFFF;
+        }
+    }
+
+    BlumBlumShub64::BlumBlumShub64(uint64_t seed): state(0, 0, 0, 0){
+        reseed(seed);
+    }
+
+    uint64_t BlumBlumShub64::generate() {
+        uint64_t num = 0;
+        for(int i = 0; i < 8; i++){
+            propagate();
+            num = (num << 8) | (state.data[0] & 0xFF); // Extracting LSB and appending
+        }
+        return num;
+    }
+
+    void BlumBlumShub64::generate_block(uint64_t* out, size_t n) {
+        // Qualified call, so the whole block is generated without virtual dispatch
+        for (size_t i = 0; i < n; i++)
+            out[i] = BlumBlumShub64::generate();
+    }
+
+    void BlumBlumShub64::reseed(uint64_t seed) {
+        reseed_from(SeedSequence(seed));
+    }
+
+    void BlumBlumShub64::reseed_from(const SeedSequence& seq) {
+        const uint64_t seed = seq.word(0);
+        for(int i = 2; i < 4; i++)
+            state.data[i] = 0;
+        state.data[1] = seed >> 32;
+        state.data[0] = seed & 0xFFFFFFFF;
+    }
+
+    void BlumBlumShub64::write_state(detail::StateWriter& out) const {
+        out.tag("BlumBlumShub64");
+        out.put(state.data, 4);
+    }
+
+    void BlumBlumShub64::read_state(detail::StateReader& in) {
+        in.tag("BlumBlumShub64");
+        uint64_t s[4];
+        in.get(s, 4);
+        in.end();
+        std::copy(s, s + 4, state.data);
+    }
+
+    namespace
+    {
+        // -1/n modulo 2^64 for an odd n, by Newton's iteration (each step doubles the correct low bits)
+        constexpr uint64_t montgomery_inverse(uint64_t n)
+        {
+            uint64_t inv = n;   // correct to 3 bits, since n * n = 1 mod 8
+            for (int i = 0; i < 5; i++)
+                inv *= 2 - n * inv;
+            return 0 - inv;
+        }
+
+        // b^e modulo m (m < 2^64)
+        uint64_t powmod(uint64_t b, uint64_t e, uint64_t m)
+        {
+            uint64_t result = 1 % m;
+            for (b %= m; e > 0; e >>= 1)
+            {
+                if (e & 1)
+                    result = (uint128_t(result) * b) % m;
+                b = (uint128_t(b) * b) % m;
+            }
+            return result;
+        }
+    }
+
+    template <typename UIntType>
+    const uint64_t BlumBlumShubMontgomery<UIntType>::p = 4294967291;
+    template <typename UIntType>
+    const uint64_t BlumBlumShubMontgomery<UIntType>::q = 4294967279;
+    template <typename UIntType>
+    const uint64_t BlumBlumShubMontgomery<UIntType>::n = 4294967291ULL * 4294967279ULL;
+    template <typename UIntType>
+    const uint64_t BlumBlumShubMontgomery<UIntType>::n_inv = montgomery_inverse(4294967291ULL * 4294967279ULL);
+    template <typename UIntType>
+    const uint64_t BlumBlumShubMontgomery<UIntType>::r2 = ((~uint128_t(0)) % (4294967291ULL * 4294967279ULL) + 1) % (4294967291ULL * 4294967279ULL);
+
+    template <typename UIntType>
+    const uint64_t BlumBlumShubMontgomery<UIntType>::lambda = (4294967290ULL * 4294967278ULL) / std::gcd(4294967290ULL, 4294967278ULL);
+
+    template <typename UIntType>
+    inline uint64_t BlumBlumShubMontgomery<UIntType>::redc(uint128_t t){
+        // t + m*n is divisible by 2^64; its low halves sum to 2^64 unless both are zero
+        uint64_t m = uint64_t(t) * n_inv;
+        uint128_t r = (t >> 64) + ((uint128_t(m) * n) >> 64) + (uint64_t(t) != 0);
+        return (r >= n) ? uint64_t(r - n) : uint64_t(r);
+    }
+
+    template <typename UIntType>
+    inline uint64_t BlumBlumShubMontgomery<UIntType>::propagate(){
+        state = redc(uint128_t(state) * state);
+        // Bits are taken from the state itself, not from its Montgomery form
+        return redc(state) & ((1ULL << bits_per_step) - 1);
+    }
+
+    template <typename UIntType>
+    BlumBlumShubMontgomery<UIntType>::BlumBlumShubMontgomery(UIntType seed, int bits_per_step): bits_per_step(bits_per_step){
+        if (bits_per_step < 1 || bits_per_step > 32)
+            throw std::invalid_argument("Expected 1 <= bits_per_step <= 32");
+        reseed(seed);
+    }
+
+    template <typename UIntType>
+    UIntType BlumBlumShubMontgomery<UIntType>::generate() {
+        // Bits of the first squaring that do not fit are shifted out at the top
+        uint64_t num = 0;
+        for (int filled = 0; filled < int(8 * sizeof(UIntType)); filled += bits_per_step)
+            num = (num << bits_per_step) | propagate();
+        return UIntType(num);
+    }
+
+    template <typename UIntType>
+    void BlumBlumShubMontgomery<UIntType>::generate_block(UIntType* out, size_t n) {
+        // Qualified call, so the whole block is generated without virtual dispatch
+        for (size_t i = 0; i < n; i++)
+            out[i] = BlumBlumShubMontgomery::generate();
+    }
+
+    template <typename UIntType>
+    void BlumBlumShubMontgomery<UIntType>::jump_ahead(uint64_t steps) {
+        // Every output takes ceil(bits / bits_per_step) squarings, so the state is raised to
+        // 2^(squarings * steps), an exponent that only matters modulo lambda as the state is coprime to n
+        uint64_t squarings = (8 * sizeof(UIntType) + bits_per_step - 1) / bits_per_step;
+        uint64_t e = powmod(powmod(2, squarings, lambda), steps, lambda);
+        // Montgomery square-and-multiply, starting from 1 in Montgomery form
+        uint64_t result = redc(r2), base = state;
+        for (; e > 0; e >>= 1)
+        {
+            if (e & 1)
+                result = redc(uint128_t(result) * base);
+            base = redc(uint128_t(base) * base);
+        }
+        state = result;
+    }
+
+    template <typename UIntType>
+    void BlumBlumShubMontgomery<UIntType>::reseed(UIntType seed) {
+        reseed_from(SeedSequence(seed));
+    }
+
+    template <typename UIntType>
+    void BlumBlumShubMontgomery<UIntType>::reseed_from(const SeedSequence& seq) {
+        uint64_t x = seq.word(0) % n;
+        // The seed must be coprime to n, and its square must not be 1 (or the state gets stuck at 1)
+        while (x < 2 || std::gcd(x, n) != 1 || (uint128_t(x) * x) % n == 1)
+            x = (x + 1) % n;
+        // Start from the square of the seed, in Montgomery form
+        state = redc(uint128_t((uint128_t(x) * x) % n) * r2);
+    }
+
+    // bits_per_step is saved with the state, as it decides how the states are cut into outputs
+    template <typename UIntType>
+    void BlumBlumShubMontgomery<UIntType>::write_state(detail::StateWriter& out) const {
+        out.tag("BlumBlumShubMontgomery");
+        out.put(uint8_t(sizeof(UIntType)));
+        out.put(state);
+        out.put(uint8_t(bits_per_step));
+    }
+
+    template <typename UIntType>
+    void BlumBlumShubMontgomery<UIntType>::read_state(detail::StateReader& in) {
+        in.tag("BlumBlumShubMontgomery");
+        in.expect(uint8_t(sizeof(UIntType)));
+        const uint64_t s = in.get<uint64_t>();
+        const int bits = in.get<uint8_t>();
+        if (s >= n || bits < 1 || bits > 32)
+            throw std::invalid_argument("The saved state does not fit this object");
+        in.end();
+        state = s;
+        bits_per_step = bits;
+    }
+
+    template class BlumBlumShubMontgomery<uint32_t>;
+    template class BlumBlumShubMontgomery<uint64_t>;
+}
+
+// src/Generators/LFSR/LFSR.cpp
+
+
+namespace DiceForge
+{
+    /*
+    Both LFSRs share one 128-bit Fibonacci register, curr_seed1 (upper half) : curr_seed2 (lower half).
+    Reading it as the bits b[t], ..., b[t + 127] of a sequence (b[t] being the lowest), every step
+    shifts it right and feeds in b[t + 128] = b[t] ^ b[t + 1] ^ b[t + 2] ^ b[t + 7], and outputs the
+    new lowest bit. Since all the taps lie in the lowest 8 bits, the next 64 bits of the sequence only
+    depend on bits already in the register, so a whole word of steps is a handful of shifts and xors.
+    */
+    namespace
+    {
+        // Feedback polynomial x^128 + x^7 + x^2 + x + 1, without its x^128 term
+        const uint128_t feedback = 0x87;
+
+        // The next 64 bits of the sequence, b[t + 128], ..., b[t + 191]
+        inline uint64_t feedback_word(uint64_t s1, uint64_t s2)
+        {
+            return s2 ^ ((s2 >> 1) | (s1 << 63)) ^ ((s2 >> 2) | (s1 << 62)) ^ ((s2 >> 7) | (s1 << 57));
+        }
+
+        // Reverses the order of the bits of x
+        inline uint64_t reverse_bits(uint64_t x)
+        {
+            x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+            x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+            x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+            x = ((x >> 8) & 0x00FF00FF00FF00FFULL) | ((x & 0x00FF00FF00FF00FFULL) << 8);
+            x = ((x >> 16) & 0x0000FFFF0000FFFFULL) | ((x & 0x0000FFFF0000FFFFULL) << 16);
+            return (x >> 32) | (x << 32);
+        }
+
+        // Product of the polynomials a and b over GF(2), modulo the feedback polynomial
+        uint128_t polymulmod(uint128_t a, uint128_t b)
+        {
+            uint128_t r = 0;
+            for (int i = 127; i >= 0; i--)
+            {
+                r = (r << 1) ^ ((r >> 127) ? feedback : 0);
+                if ((b >> i) & 1)
+                    r ^= a;
+            }
+            return r;
+        }
+
+        // base^e modulo the feedback polynomial
+        uint128_t polypowmod(uint128_t base, uint64_t e)
+        {
+            uint128_t result = 1;
+            for (; e > 0; e >>= 1)
+            {
+                if (e & 1)
+                    result = polymulmod(result, base);
+                base = polymulmod(base, base);
+            }
+            return result;
+        }
+
+        // x^(steps * step_bits) modulo the feedback polynomial. Its coefficients c[j] give the register that
+        // many steps ahead as the xor of the registers j steps ahead for which c[j] = 1 (j < 128)
+        uint128_t jump_polynomial(uint64_t steps, uint64_t step_bits = 1)
+        {
+            return polypowmod(polypowmod(2, step_bits), steps);
+        }
+
+        // Advances the register by the steps that the jump polynomial was computed for
+        void jump_register(uint64_t& s1, uint64_t& s2, uint128_t poly)
+        {
+            // 256 bits of the sequence, enough for the registers up to 127 steps ahead
+            uint64_t w[4] = {s2, s1, 0, 0};
+            w[2] = feedback_word(w[1], w[0]);
+            w[3] = feedback_word(w[2], w[1]);
+            // 64 bits of the sequence starting at bit o of w
+            auto word = [&w](int o) { return (o % 64 == 0) ? w[o / 64] : (w[o / 64] >> (o % 64)) | (w[o / 64 + 1] << (64 - o % 64)); };
+
+            uint64_t r1 = 0, r2 = 0;
+            for (int j = 0; j < 128; j++)
+            {
+                if ((poly >> j) & 1)
+                {
+                    r2 ^= word(j);
+                    r1 ^= word(j + 64);
+                }
+            }
+            s1 = r1;
+            s2 = r2;
+        }
+
+        // Fills the register with the first two words of the expansion that are not both zero (the all-zero register
+        // would stay zero). Being well mixed already, it needs no warm-up.
+        void seed_register(uint64_t& s1, uint64_t& s2, const SeedSequence& seq)
+        {
+            size_t i = 0;
+            do {
+                s1 = seq.word(i++);
+                s2 = seq.word(i++);
+            } while (s1 == 0 && s2 == 0);
+        }
+    }
+
+    LFSR64::LFSR64(uint64_t seed)
+    {
+        reseed(seed);
+    }
+
+    uint64_t LFSR64::generate() {
+        // The 64 output bits are the register bits 1 to 64, taken lowest first into the highest bit of rand_num
+        uint64_t rand_num = reverse_bits((curr_seed2 >> 1) | (curr_seed1 << 63));
+        // Advance the register by 64 steps at once
+        uint64_t new_bits = feedback_word(curr_seed1, curr_seed2);
+        curr_seed2 = curr_seed1;
+        curr_seed1 = new_bits;
+        return rand_num * 0x2545F4914F6CDD1DULL;
+    }
+
+    void LFSR64::generate_block(uint64_t* out, size_t n) {
+        // Qualified call, so the whole block is generated without virtual dispatch
+        for (size_t i = 0; i < n; i++)
+            out[i] = LFSR64::generate();
+    }
+
+    void LFSR64::jump_ahead(uint64_t steps) {
+        // Each output advances the register by 64 steps
+        jump_register(curr_seed1, curr_seed2, jump_polynomial(steps, 64));
+    }
+
+    void LFSR64::reseed(uint64_t seed) {
+        reseed_from(SeedSequence(seed));
+    }
+
+    void LFSR64::reseed_from(const SeedSequence& seq) {
+        seed_register(curr_seed1, curr_seed2, seq);
+    }
+
+    void LFSR64::write_state(detail::StateWriter& out) const {
+        out.tag("LFSR64");
+        out.put(curr_seed1);
+        out.put(curr_seed2);
+    }
+
+    void LFSR64::read_state(detail::StateReader& in) {
+        in.tag("LFSR64");
+        const uint64_t s1 = in.get<uint64_t>(), s2 = in.get<uint64_t>();
+        in.end();
+        curr_seed1 = s1;
+        curr_seed2 = s2;
+    }
+
+    DiceForge::LFSR32::LFSR32(uint32_t seed)
+    {
+        reseed(seed);
+    }
+
+    uint32_t DiceForge::LFSR32::generate() {
+        // The 32 output bits are the register bits 1 to 32, taken lowest first into the highest bit of rand_num
+        uint32_t rand_num = reverse_bits((curr_seed2 >> 1) | (curr_seed1 << 63)) >> 32;
+        // Advance the register by 32 steps at once
+        uint64_t new_bits = feedback_word(curr_seed1, curr_seed2) & 0xFFFFFFFFULL;
+        curr_seed2 = (curr_seed2 >> 32) | (curr_seed1 << 32);
+        curr_seed1 = (curr_seed1 >> 32) | (new_bits << 32);
+        return rand_num * 0x2545F4914F6CDD1DULL;
+    }
+
+    void LFSR32::generate_block(uint32_t* out, size_t n) {
+        // Qualified call, so the whole block is generated without virtual dispatch
+        for (size_t i = 0; i < n; i++)
+            out[i] = LFSR32::generate();
+    }
+
+    void LFSR32::jump_ahead(uint64_t steps) {
+        // Each output advances the register by 32 steps
+        jump_register(curr_seed1, curr_seed2, jump_polynomial(steps, 32));
+    }
+
+    void LFSR32::reseed(uint32_t seed) {
+        reseed_from(SeedSequence(seed));
+    }
+
+    void LFSR32::reseed_from(const SeedSequence& seq) {
+        seed_register(curr_seed1, curr_seed2, seq);
+    }
+
+    void LFSR32::write_state(detail::StateWriter& out) const {
+        out.tag("LFSR32");
+        out.put(curr_seed1);
+        out.put(curr_seed2);
+    }
+
+    void LFSR32::read_state(detail::StateReader& in) {
+        in.tag("LFSR32");
+        const uint64_t s1 = in.get<uint64_t>(), s2 = in.get<uint64_t>();
+        in.end();
+        curr_seed1 = s1;
+        curr_seed2 = s2;
+    }
+}
+
+// src/Generators/MT/MT.cpp
+
+
+namespace DiceForge
+{
+    // Shorthand for the template header of the out-of-line members below
+    #define DF_MT_TEMPLATE template <typename UIntType, int N, int M, UIntType A, UIntType UpperBits, UIntType LowerBits, \
+                                     int U, int S, UIntType B, int T, UIntType C, int L>
+    #define DF_MT_ENGINE MersenneTwisterEngine<UIntType, N, M, A, UpperBits, LowerBits, U, S, B, T, C, L>
+
+    // Constructor
+    DF_MT_TEMPLATE
+    DF_MT_ENGINE::MersenneTwisterEngine(UIntType seed)
+    {
+        reseed(seed);
+    }
+
+    // Reset seed
+    DF_MT_TEMPLATE
+    void DF_MT_ENGINE::reseed(UIntType seed)
+    {
+        reseed_from(SeedSequence(seed));
+    }
+
+    // Fills the state vector with the expansion of the seed material, all N words at full width.
+    DF_MT_TEMPLATE
+    void DF_MT_ENGINE::reseed_from(const SeedSequence& seq)
+    {
+        seq.generate(mt.data(), N);
+        // Of the first word only the upper bits enter the recurrence, and a state that is zero apart from them
+        // would stay zero
+        bool zero = (mt[0] & UpperBits) == 0;
+        for (int i = 1; i < N && zero; i++)
+            zero = (mt[i] == 0);
+        if (zero)
+            mt[0] = UpperBits;
+        mti=N+1;
+    }
+
+    // The word size and N tell MT32 from MT64, the index is at most N + 1 (right after reseeding)
+    DF_MT_TEMPLATE
+    void DF_MT_ENGINE::write_state(detail::StateWriter& out) const
+    {
+        out.tag("MersenneTwister");
+        out.put(uint8_t(sizeof(UIntType)));
+        out.put(uint32_t(N));
+        out.put(mt.data(), N);
+        out.put(uint32_t(mti));
+    }
+
+    DF_MT_TEMPLATE
+    void DF_MT_ENGINE::read_state(detail::StateReader& in)
+    {
+        in.tag("MersenneTwister");
+        in.expect(uint8_t(sizeof(UIntType)));
+        in.expect(uint32_t(N));
+        std::array<UIntType, N> state;
+        in.get(state.data(), N);
+        const uint32_t index = in.get<uint32_t>();
+        if (index > uint32_t(N) + 1)
+            throw std::invalid_argument("The saved state does not fit this object");
+        in.end();
+        mt = state;
+        mti = int(index);
+    }
+
+    // Tempers whole runs of the state vector at once, regenerating it whenever it is used up.
+    DF_MT_TEMPLATE
+    void DF_MT_ENGINE::generate_block(UIntType* out, size_t n)
+    {
+        while (n > 0)
+        {
+            trytransform();
+            size_t m = std::min(n, size_t(N - mti));
+            MT_simd::temper(mt.data() + mti, out, m, U, S, B, T, C, L);
+            mti += m;
+            out += m;
+            n -= m;
+        }
+    }
+
+    // Skips the given number of outputs.
+    DF_MT_TEMPLATE
+    void DF_MT_ENGINE::jump_ahead(uint64_t steps)
+    {
+        if constexpr ((UpperBits & LowerBits) != 0)
+        {
+            // Overlapping masks make the twist non-linear, so the outputs are simply discarded
+            for (uint64_t i = 0; i < steps; i++)
+                generate();
+        }
+        else
+        {
+            // Output index (relative to the start of the current block) to jump to
+            uint128_t target = uint128_t(std::min(mti, N)) + steps;
+            if (target < uint128_t(N))
+            {
+                mti = int(target);
+                return;
+            }
+            uint128_t blocks = target / N;
+            mti = int(target % N);
+
+            static const MT_jump::Recurrence<UIntType> rec = {N, M, A, UpperBits, LowerBits};
+            static size_t degree;
+            static const MT_jump::Poly P = MT_jump::characteristic_polynomial(rec, degree);
+
+            // Jump to the window starting one word before the new block, since the lower bits of the first
+            // word of a jumped window are not determined, then step once to get the whole block
+            MT_jump::jump(rec, mt.data(), MT_jump::power_of_x(P, degree, blocks * N - 1), degree);
+            int i = 0;
+            rec.step(mt.data(), i);
+            std::rotate(mt.begin(), mt.begin() + 1, mt.end());
+        }
+    }
+
+    // If mti>=N, MT algorithm is run to regenerate values.
+    DF_MT_TEMPLATE
+    void DF_MT_ENGINE::trytransform(){
+        if (mti >= N){
+            // Performing the linear reccurence transformation on whole runs of the state vector
+            MT_simd::regenerate(mt.data(), N, M, A, UpperBits, LowerBits);
+            mti = 0;
+        }
+    }
+
+    #undef DF_MT_TEMPLATE
+    #undef DF_MT_ENGINE
+
+    // MT32 and MT64
+    template class MersenneTwisterEngine<uint32_t, 624, 397, 0x9967EA1FU, 0x80000000U, 0xFFFFFFFFU,
+                                         11, 7, 0x9D2C5680U, 15, 0xEFC60000U, 18>;
+    template class MersenneTwisterEngine<uint64_t, 312, 156, 0xB5026F5AA96619E9ULL, 0xFFFFFFFF80000000ULL, 0x7FFFFFFFULL,
+                                         29, 17, 0xD66B5EF5B4DA0000ULL, 37, 0xFDED6BE000000000ULL, 41>;
+}
+
+// src/Generators/Naor-Reingold/naor_reingold.cpp
+
+
+
+namespace DiceForge {
+
+  namespace {
+    typedef unsigned long long ull;
+
+    // Refer wikipedia article for these numbers and their explanation
+    constexpr ull l = 9999929;
+    constexpr ull p = 4279969613;
+    constexpr ull g = 9999918;
+    constexpr ull a[] = {
+        650051,  3948705, 3142325, 4036110, 1141941, 5739231, 5725758,
+        8299330, 1776388, 1423550, 9260804, 156410,  1190436, 61218,
+        2382500, 1738876, 7978879, 6010478, 310917,  4280253, 24724,
+        7087659, 796099,  8383655, 7638286, 1390415, 7899225, 5628976,
+        1472292, 4284966, 9708041, 4179835, 3635954};
+  }
+
+  constexpr ull power(ull a, ull b, ull mod) {
+    ull result = 1;
+    ull a_pwr = a % mod;
+    while (b) {
+      if (b % 2 == 1)
+        result *= a_pwr;
+      a_pwr *= a_pwr;
+      a_pwr %= mod; // Take modulo everywhere
+      result %= mod;
+      b /= 2;
+    }
+    return result;
+  }
+
+  namespace {
+    struct PowerTables {
+      ull factor[32];   // g^a[i] mod p, the factor contributed by bit i of the state
+      ull step[32];     // factor[k] / (factor[0] * ... * factor[k-1]) mod p
+    };
+
+    constexpr PowerTables make_tables() {
+      PowerTables t{};
+      ull inv_prefix = 1;   // 1 / (factor[0] * ... * factor[k-1]) mod p (p is prime)
+      for (int i = 0; i < 32; i++) {
+        t.factor[i] = power(g, a[i], p);
+        t.step[i] = (t.factor[i] * inv_prefix) % p;
+        inv_prefix = (inv_prefix * power(t.factor[i], p - 2, p)) % p;
+      }
+      return t;
+    }
+
+    // Computed at compile time, since g, a[] and p are constants
+    constexpr PowerTables tables = make_tables();
+
+    // Product of the factors of the set bits of the state
+    ull product(uint64_t state) {
+      ull res = 1;
+      for (int i = 0; i < 31; i++) {
+        // Only multiply the remainder if the corresponding bit is 1
+        if (state & (1ULL << i))
+          res = (res * tables.factor[i]) % p;
+      }
+      // The factor of the last bit is used whenever any of the bits 31 to 63 is set
+      if (state >> 31)
+        res = (res * tables.factor[31]) % p;
+      return res;
+    }
+  }
+
+  NaorReingold::NaorReingold(uint32_t seed) {
+    reseed(seed);
+  }
+
+  void NaorReingold::reseed(uint32_t seed) { 
+    reseed_from(SeedSequence(seed));
+  }
+
+  void NaorReingold::reseed_from(const SeedSequence& seq) {
+    m_state = uint32_t(seq.word(0));
+    m_product = product(m_state);
+  }
+
+  // The product is a function of the state, so only the state is saved
+  void NaorReingold::write_state(detail::StateWriter& out) const {
+    out.tag("NaorReingold");
+    out.put(uint64_t(m_state));
+  }
+
+  void NaorReingold::read_state(detail::StateReader& in) {
+    in.tag("NaorReingold");
+    const uint64_t state = in.get<uint64_t>();
+    in.end();
+    m_state = state;
+    m_product = product(m_state);
+  }
+
+  uint32_t NaorReingold::generate() {
+    ull res = m_product;
+
+    // Incrementing the state clears its k trailing ones and sets bit k, so unless the carry reaches
+    // the last bit, the product is updated with the single precomputed step factor for k
+    int k = 0;
+    while (k < 31 && ((m_state >> k) & 1))
+      k++;
+
+    m_state++;
+    if (k < 31)
+      m_product = (m_product * tables.step[k]) % p;
+    else
+      m_product = product(m_state);
+    return res;
+  }
+
+  void NaorReingold::jump_ahead(uint64_t steps) {
+    // Counter mode: the state is simply offset
+    m_state += steps;
+    m_product = product(m_state);
+  }
+
+  void NaorReingold::generate_block(uint32_t* out, size_t n) {
+    // Qualified call, so the whole block is generated without virtual dispatch
+    for (size_t i = 0; i < n; i++)
+      out[i] = NaorReingold::generate();
+  }
+
+} // namespace DiceForge
+
+// src/Generators/Halton/Halton.cpp
+
+#include <stdexcept>
+
+namespace DiceForge
+{
+    Halton::Halton(unsigned dimensions, uint64_t seed) : m_dimensions(dimensions)
+    {
+        if (dimensions == 0)
+            throw std::invalid_argument("Expected at least 1 dimension");
+
+        // the first primes, by trial division
+        for (uint64_t p = 2; m_bases.size() < dimensions; p++)
+        {
+            bool prime = true;
+            for (uint64_t q : m_bases)
+            {
+                if (q * q > p)
+                    break;
+                if (p % q == 0)
+                {
+                    prime = false;
+                    break;
+                }
+            }
+            if (prime)
+                m_bases.push_back(p);
+        }
+
+        // digit k is worth b^-(k+1), or floor(2^64 / b^(k+1)) as a 64 bit fraction
+        m_scale.assign(size_t(dimensions) * max_digits, 0);
+        for (unsigned j = 0; j < dimensions; j++)
+        {
+            uint128_t power = m_bases[j];
+            for (int k = 0; k < max_digits && (power >> 64) == 0; k++, power *= m_bases[j])
+                m_scale[size_t(j) * max_digits + k] = uint64_t((uint128_t(1) << 64) / power);
+        }
+
+        m_multiplier.assign(size_t(dimensions) * max_digits, 1);
+        m_addend.assign(size_t(dimensions) * max_digits, 0);
+        m_digits.assign(size_t(dimensions) * max_digits, 0);
+        m_point.assign(dimensions, 0);
+        reseed(seed);
+    }
+
+    void Halton::reseed(uint64_t seed)
+    {
+        m_seed = seed;
+        uint64_t x = seed;
+        for (unsigned j = 0; j < m_dimensions; j++)
+        {
+            const uint64_t b = m_bases[j];
+            for (int k = 0; k < max_digits; k++)
+            {
+                const size_t i = size_t(j) * max_digits + k;
+                m_multiplier[i] = seed == 0 ? 1 : 1 + splitmix64(x) % (b - 1);
+                m_addend[i] = seed == 0 ? 0 : splitmix64(x) % b;
+            }
+        }
+        seek(0);
+    }
+
+    void Halton::write_state(detail::StateWriter& out) const
+    {
+        out.tag("Halton");
+        out.put(uint32_t(m_dimensions));
+        out.put(m_seed);
+        out.put(position());
+    }
+
+    void Halton::read_state(detail::StateReader& in)
+    {
+        in.tag("Halton");
+        in.expect(uint32_t(m_dimensions));
+        const uint64_t seed = in.get<uint64_t>();
+        const uint64_t i = in.get<uint64_t>();
+        in.end();
+        reseed(seed);
+        seek(i);
+    }
+
+    void Halton::seek(uint64_t i)
+    {
+        m_index = i / m_dimensions;
+        m_coordinate = unsigned(i % m_dimensions);
+        for (unsigned j = 0; j < m_dimensions; j++)
+        {
+            const uint64_t b = m_bases[j];
+            const size_t first = size_t(j) * max_digits;
+            uint64_t n = m_index, x = 0;
+            for (int k = 0; k < max_digits; k++, n /= b)
+            {
+                m_digits[first + k] = n % b;
+                x += (m_multiplier[first + k] * (n % b) + m_addend[first + k]) % b * m_scale[first + k];
+            }
+            m_point[j] = x;
+        }
+    }
+
+    void Halton::jump_ahead(uint64_t steps)
+    {
+        seek(position() + steps);
+    }
+
+    void Halton::advance()
+    {
+        for (unsigned j = 0; j < m_dimensions; j++)
+        {
+            const uint64_t b = m_bases[j];
+            const size_t first = size_t(j) * max_digits;
+            uint64_t x = m_point[j];
+            // add one with carry, updating the coordinate by the change of every digit (modulo 2^64)
+            for (size_t i = first; i < first + max_digits; i++)
+            {
+                const uint64_t f = m_multiplier[i], g = m_addend[i], d = m_digits[i];
+                const uint64_t old = (f * d + g) % b;
+                m_digits[i] = d + 1 == b ? 0 : d + 1;
+                x += ((f * m_digits[i] + g) % b - old) * m_scale[i];
+                if (m_digits[i] != 0)
+                    break;
+            }
+            m_point[j] = x;
+        }
+        m_index++;
+        m_coordinate = 0;
+    }
+
+    void Halton::generate_block(uint64_t* out, size_t n)
+    {
+        // Finish the current point, then write whole points straight to the buffer
+        while (n > 0 && m_coordinate < m_dimensions)
+        {
+            *out++ = m_point[m_coordinate++];
+            n--;
+        }
+        while (n >= m_dimensions)
+        {
+            advance();
+            for (unsigned j = 0; j < m_dimensions; j++)
+                out[j] = m_point[j];
+            m_coordinate = m_dimensions;
+            out += m_dimensions;
+            n -= m_dimensions;
+        }
+        for (size_t i = 0; i < n; i++)
+            out[i] = Halton::generate();
+    }
+}
+
+// src/Generators/Philox/Philox.cpp
+
+
+namespace DiceForge
+{
+    namespace
+    {
+        // Multipliers and key increments (Weyl sequence) of Philox4x32
+        const uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+        const uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+
+        // The Philox4x32-10 bijection of the counter c under the key k, in place
+        inline void philox4x32_10(uint32_t c[4], uint32_t k0, uint32_t k1)
+        {
+            for (int round = 0; round < 10; round++)
+            {
+                uint64_t p0 = uint64_t(M0) * c[0], p1 = uint64_t(M1) * c[2];
+                uint32_t c0 = uint32_t(p1 >> 32) ^ c[1] ^ k0;
+                uint32_t c2 = uint32_t(p0 >> 32) ^ c[3] ^ k1;
+                c[1] = uint32_t(p1);
+                c[3] = uint32_t(p0);
+                c[0] = c0;
+                c[2] = c2;
+                k0 += W0;
+                k1 += W1;
+            }
+        }
+    }
+
+    template <typename UIntType>
+    PhiloxEngine<UIntType>::PhiloxEngine(UIntType seed, uint64_t stream) : m_stream(stream)
+    {
+        reseed(seed);
+    }
+
+    template <typename UIntType>
+    void PhiloxEngine<UIntType>::reseed(UIntType seed)
+    {
+        reseed_from(SeedSequence(seed));
+    }
+
+    template <typename UIntType>
+    void PhiloxEngine<UIntType>::reseed_from(const SeedSequence& seq)
+    {
+        const uint64_t key = seq.word(0);
+        m_key[0] = uint32_t(key);
+        m_key[1] = uint32_t(key >> 32);
+        m_position = 0;
+        m_block_valid = false;
+    }
+
+    template <typename UIntType>
+    void PhiloxEngine<UIntType>::write_state(detail::StateWriter& out) const
+    {
+        out.tag("Philox");
+        out.put(uint8_t(sizeof(UIntType)));
+        out.put(m_key, 2);
+        out.put(m_stream);
+        out.put(m_position);
+    }
+
+    template <typename UIntType>
+    void PhiloxEngine<UIntType>::read_state(detail::StateReader& in)
+    {
+        in.tag("Philox");
+        in.expect(uint8_t(sizeof(UIntType)));
+        uint32_t key[2];
+        in.get(key, 2);
+        const uint64_t stream = in.get<uint64_t>(), position = in.get<uint64_t>();
+        in.end();
+        m_stream = stream;
+        m_position = position;
+        m_key[0] = key[0];
+        m_key[1] = key[1];
+        m_block_valid = false;
+    }
+
+    template <typename UIntType>
+    void PhiloxEngine<UIntType>::compute_block(uint64_t block, UIntType* out) const
+    {
+        uint32_t c[4] = {uint32_t(block), uint32_t(block >> 32), uint32_t(m_stream), uint32_t(m_stream >> 32)};
+        philox4x32_10(c, m_key[0], m_key[1]);
+        if constexpr (per_block == 4)
+        {
+            for (int j = 0; j < 4; j++)
+                out[j] = c[j];
+        }
+        else
+        {
+            out[0] = (uint64_t(c[1]) << 32) | c[0];
+            out[1] = (uint64_t(c[3]) << 32) | c[2];
+        }
+    }
+
+    template <typename UIntType>
+    UIntType PhiloxEngine<UIntType>::at(uint64_t i) const
+    {
+        UIntType block[per_block];
+        compute_block(i / per_block, block);
+        return block[i % per_block];
+    }
+
+    template <typename UIntType>
+    void PhiloxEngine<UIntType>::generate_block(UIntType* out, size_t n)
+    {
+        // Finish the current block one by one, then write whole blocks straight to the buffer
+        while (n > 0 && m_position % per_block != 0)
+        {
+            *out++ = PhiloxEngine::generate();
+            n--;
+        }
+        for (; n >= size_t(per_block); n -= per_block, out += per_block)
+        {
+            compute_block(m_position / per_block, out);
+            m_position += per_block;
+        }
+        while (n > 0)
+        {
+            *out++ = PhiloxEngine::generate();
+            n--;
+        }
+    }
+
+    template <typename UIntType>
+    void PhiloxEngine<UIntType>::jump_ahead(uint64_t steps)
+    {
+        m_position += steps;
+    }
+
+    template class PhiloxEngine<uint32_t>;
+    template class PhiloxEngine<uint64_t>;
+}
+
+// src/Generators/Sobol/Sobol.cpp
+
+#include <stdexcept>
+
+namespace DiceForge
+{
+    Sobol::Sobol(unsigned dimensions, uint64_t seed) : m_dimensions(dimensions)
+    {
+        if (dimensions == 0 || dimensions > max_dimensions)
+            throw std::invalid_argument("Expected 1 to 1024 dimensions");
+
+        // v_k = m_k / 2^k as a 64 bit fraction, the m_k beyond the initial ones following the recurrence of the
+        // polynomial x^s + a_1 x^(s-1) + ... + a_(s-1) x + 1:
+        // v_k = a_1 v_(k-1) ^ ... ^ a_(s-1) v_(k-s+1) ^ v_(k-s) ^ (v_(k-s) >> s)
+        m_directions.assign(size_t(dimensions) * 64, 0);
+        for (int k = 0; k < 64; k++)
+            m_directions[k] = uint64_t(1) << (63 - k);
+        for (unsigned j = 1, offset = 0; j < dimensions; j++)
+        {
+            const unsigned poly = Sobol_directions::polynomials[j - 1];
+            int s = 0;
+            while ((poly >> (s + 1)) != 0)
+                s++;
+            uint64_t* v = m_directions.data() + size_t(j) * 64;
+            for (int k = 0; k < s; k++)
+                v[k] = uint64_t(Sobol_directions::initial[offset + k]) << (63 - k);
+            offset += s;
+            for (int k = s; k < 64; k++)
+            {
+                v[k] = v[k - s] ^ (v[k - s] >> s);
+                for (int i = 1; i < s; i++)
+                    if ((poly >> (s - i)) & 1)
+                        v[k] ^= v[k - i];
+            }
+        }
+
+        m_shift.assign(dimensions, 0);
+        m_point.assign(dimensions, 0);
+        reseed(seed);
+    }
+
+    void Sobol::reseed(uint64_t seed)
+    {
+        m_seed = seed;
+        uint64_t x = seed;
+        for (unsigned j = 0; j < m_dimensions; j++)
+            m_shift[j] = seed == 0 ? 0 : splitmix64(x);
+        seek(0);
+    }
+
+    void Sobol::write_state(detail::StateWriter& out) const
+    {
+        out.tag("Sobol");
+        out.put(uint32_t(m_dimensions));
+        out.put(m_seed);
+        out.put(position());
+    }
+
+    void Sobol::read_state(detail::StateReader& in)
+    {
+        in.tag("Sobol");
+        in.expect(uint32_t(m_dimensions));
+        const uint64_t seed = in.get<uint64_t>();
+        const uint64_t i = in.get<uint64_t>();
+        in.end();
+        reseed(seed);
+        seek(i);
+    }
+
+    void Sobol::seek(uint64_t i)
+    {
+        m_index = i / m_dimensions;
+        m_coordinate = unsigned(i % m_dimensions);
+        // point n is the XOR of the direction numbers picked out by the bits of its Gray code n ^ (n >> 1)
+        const uint64_t gray = m_index ^ (m_index >> 1);
+        for (unsigned j = 0; j < m_dimensions; j++)
+        {
+            const uint64_t* v = m_directions.data() + size_t(j) * 64;
+            uint64_t x = 0;
+            for (int k = 0; k < 64; k++)
+                if ((gray >> k) & 1)
+                    x ^= v[k];
+            m_point[j] = x;
+        }
+    }
+
+    void Sobol::jump_ahead(uint64_t steps)
+    {
+        seek(position() + steps);
+    }
+
+    void Sobol::generate_block(uint64_t* out, size_t n)
+    {
+        // Finish the current point, then write whole points straight to the buffer
+        while (n > 0 && m_coordinate < m_dimensions)
+        {
+            *out++ = m_point[m_coordinate] ^ m_shift[m_coordinate];
+            m_coordinate++;
+            n--;
+        }
+        while (n >= m_dimensions)
+        {
+            advance();
+            for (unsigned j = 0; j < m_dimensions; j++)
+                out[j] = m_point[j] ^ m_shift[j];
+            m_coordinate = m_dimensions;
+            out += m_dimensions;
+            n -= m_dimensions;
+        }
+        for (size_t i = 0; i < n; i++)
+            out[i] = Sobol::generate();
+    }
+}
+
+// src/Generators/XORShift/XORShift.cpp
+
+
+namespace DiceForge
+{
+    namespace
+    {
+        // Shift triples of XORShift32 and XORShift64
+        template <typename W>
+        struct XORShiftShifts;
+        template <>
+        struct XORShiftShifts<uint32_t> { static constexpr int a = 13, b = 17, c = 5; };
+        template <>
+        struct XORShiftShifts<uint64_t> { static constexpr int a = 13, b = 7, c = 17; };
+
+        // The next non-zero word of the expansion from word i on, cut to W (a zero state would stay zero)
+        template <typename W>
+        W nonzero_word(const SeedSequence& seq, size_t& i)
+        {
+            W w;
+            do {
+                w = W(seq.word(i++));
+            } while (w == 0);
+            return w;
+        }
+
+        // Powers of the transition matrix T of the XORShift state, which is linear over GF(2):
+        // power[i][j] is the image of the j-th unit vector under T^(2^i)
+        template <typename W>
+        struct JumpTable
+        {
+            static constexpr int bits = 8 * sizeof(W);
+            W power[64][bits];
+        };
+
+        // Image of x under the matrix given by its columns
+        template <typename W>
+        W apply(const W* columns, W x)
+        {
+            W y = 0;
+            for (int j = 0; x != 0; j++, x >>= 1)
+                if (x & 1)
+                    y ^= columns[j];
+            return y;
+        }
+
+        template <typename W>
+        JumpTable<W> make_jump_table()
+        {
+            typedef XORShiftShifts<W> Sh;
+            JumpTable<W> t;
+            for (int j = 0; j < t.bits; j++)
+            {
+                W s = W(1) << j;
+                s ^= s << Sh::a;
+                s ^= s >> Sh::b;
+                s ^= s << Sh::c;
+                t.power[0][j] = s;
+            }
+            for (int i = 1; i < 64; i++)
+                for (int j = 0; j < t.bits; j++)
+                    t.power[i][j] = apply(t.power[i - 1], t.power[i - 1][j]);
+            return t;
+        }
+
+        // The state after the given number of steps, in O(log steps) time
+        template <typename W>
+        W jump_state(W state, uint64_t steps)
+        {
+            static const JumpTable<W> table = make_jump_table<W>();
+            for (int i = 0; steps != 0; i++, steps >>= 1)
+                if (steps & 1)
+                    state = apply(table.power[i], state);
+            return state;
+        }
+    }
+
+
+    XORShift32::XORShift32(uint32_t seed)
+    {
+        reseed(seed);
+    }
+
+    void XORShift32::reseed(uint32_t seed)
+    {
+        reseed_from(SeedSequence(seed));
+    }
+
+    void XORShift32::reseed_from(const SeedSequence& seq)
+    {
+        size_t i = 0;
+        m_state = nonzero_word<uint32_t>(seq, i);
+    }
+
+    void XORShift32::write_state(detail::StateWriter& out) const
+    {
+        out.tag("XORShift32");
+        out.put(m_state);
+    }
+
+    void XORShift32::read_state(detail::StateReader& in)
+    {
+        in.tag("XORShift32");
+        const uint32_t state = in.get<uint32_t>();
+        in.end();
+        m_state = state;
+    }
+
+    void XORShift32::generate_block(uint32_t* out, size_t n)
+    {
+        // Work on a local copy so the state can stay in a register for the whole block
+        uint32_t s = m_state;
+        for (size_t i = 0; i < n; i++)
+        {
+            s ^= s << 13;
+            s ^= s >> 17;
+            s ^= s << 5;
+            out[i] = s * 0x2545F4914F6CDD1DULL;
+        }
+        m_state = s;
+    }
+
+    void XORShift32::jump_ahead(uint64_t steps)
+    {
+        m_state = jump_state(m_state, steps);
+    }
+
+    XORShift64::XORShift64(uint64_t seed)
+    {
+        reseed(seed);
+    }
+
+    void XORShift64::reseed(uint64_t seed)
+    {
+        reseed_from(SeedSequence(seed));
+    }
+
+    void XORShift64::reseed_from(const SeedSequence& seq)
+    {
+        size_t i = 0;
+        m_state = nonzero_word<uint64_t>(seq, i);
+    }
+
+    void XORShift64::write_state(detail::StateWriter& out) const
+    {
+        out.tag("XORShift64");
+        out.put(m_state);
+    }
+
+    void XORShift64::read_state(detail::StateReader& in)
+    {
+        in.tag("XORShift64");
+        const uint64_t state = in.get<uint64_t>();
+        in.end();
+        m_state = state;
+    }
+
+    void XORShift64::generate_block(uint64_t* out, size_t n)
+    {
+        // Work on a local copy so the state can stay in a register for the whole block
+        uint64_t s = m_state;
+        for (size_t i = 0; i < n; i++)
+        {
+            s ^= s << 13;
+            s ^= s >> 7;
+            s ^= s << 17;
+            out[i] = s * 0x2545F4914F6CDD1DULL;
+        }
+        m_state = s;
+    }
+
+    void XORShift64::jump_ahead(uint64_t steps)
+    {
+        m_state = jump_state(m_state, steps);
+    }
+
+    template <typename UIntType, int Lanes>
+    XORShiftMultiLane<UIntType, Lanes>::XORShiftMultiLane(UIntType seed)
+    {
+        reseed(seed);
+    }
+
+    template <typename UIntType, int Lanes>
+    void XORShiftMultiLane<UIntType, Lanes>::reseed(UIntType seed)
+    {
+        reseed_from(SeedSequence(seed));
+    }
+
+    template <typename UIntType, int Lanes>
+    void XORShiftMultiLane<UIntType, Lanes>::reseed_from(const SeedSequence& seq)
+    {
+        // Every lane needs its own non-zero state
+        size_t i = 0;
+        for (int j = 0; j < Lanes; j++)
+            m_state[j] = nonzero_word<UIntType>(seq, i);
+        m_index = Lanes;
+    }
+
+    template <typename UIntType, int Lanes>
+    void XORShiftMultiLane<UIntType, Lanes>::write_state(detail::StateWriter& out) const
+    {
+        out.tag("XORShiftMultiLane");
+        out.put(uint8_t(sizeof(UIntType)));
+        out.put(uint8_t(Lanes));
+        out.put(m_state, Lanes);
+        // Only the outputs of the last step that are still to be handed out
+        out.put(uint8_t(m_index));
+        out.put(m_buffer + m_index, Lanes - m_index);
+    }
+
+    template <typename UIntType, int Lanes>
+    void XORShiftMultiLane<UIntType, Lanes>::read_state(detail::StateReader& in)
+    {
+        in.tag("XORShiftMultiLane");
+        in.expect(uint8_t(sizeof(UIntType)));
+        in.expect(uint8_t(Lanes));
+        UIntType state[Lanes];
+        in.get(state, Lanes);
+        const int index = in.get<uint8_t>();
+        if (index > Lanes)
+            throw std::invalid_argument("The saved state does not fit this object");
+        UIntType buffer[Lanes];
+        in.get(buffer + index, Lanes - index);
+        in.end();
+        std::copy(buffer + index, buffer + Lanes, m_buffer + index);
+        std::copy(state, state + Lanes, m_state);
+        m_index = index;
+    }
+
+    template <typename UIntType, int Lanes>
+    void XORShiftMultiLane<UIntType, Lanes>::advance(UIntType* out, size_t steps)
+    {
+        typedef XORShiftShifts<UIntType> Sh;
+        const UIntType mult = UIntType(0x2545F4914F6CDD1DULL);
+#if defined(DF_SIMD)
+        typedef simd::Lanes<UIntType> L;
+        if constexpr (Lanes % L::width == 0)
+        {
+            // The states are kept in registers for all the steps
+            constexpr int V = Lanes / L::width;
+            typename L::vec s[V];
+            const typename L::vec m = L::set1(mult);
+            for (int v = 0; v < V; v++)
+                s[v] = L::load(m_state + v * L::width);
+            for (size_t i = 0; i < steps; i++, out += Lanes)
+            {
+                for (int v = 0; v < V; v++)
+                {
+                    s[v] = L::bxor(s[v], L::sll(s[v], Sh::a));
+                    s[v] = L::bxor(s[v], L::srl(s[v], Sh::b));
+                    s[v] = L::bxor(s[v], L::sll(s[v], Sh::c));
+                    L::store(out + v * L::width, L::mul(s[v], m));
+                }
+            }
+            for (int v = 0; v < V; v++)
+                L::store(m_state + v * L::width, s[v]);
+            return;
+        }
+#endif
+        for (size_t i = 0; i < steps; i++, out += Lanes)
+        {
+            for (int j = 0; j < Lanes; j++)
+            {
+                UIntType& s = m_state[j];
+                s ^= s << Sh::a;
+                s ^= s >> Sh::b;
+                s ^= s << Sh::c;
+                out[j] = s * mult;
+            }
+        }
+    }
+
+    template <typename UIntType, int Lanes>
+    void XORShiftMultiLane<UIntType, Lanes>::generate_block(UIntType* out, size_t n)
+    {
+        // Use up what is left of the last step first, so that the stream is the same as with next()
+        while (n > 0 && m_index < Lanes)
+        {
+            *out++ = m_buffer[m_index++];
+            n--;
+        }
+        size_t steps = n / Lanes;
+        advance(out, steps);
+        out += steps * Lanes;
+        n -= steps * Lanes;
+        if (n > 0)
+        {
+            advance(m_buffer, 1);
+            for (m_index = 0; size_t(m_index) < n; m_index++)
+                out[m_index] = m_buffer[m_index];
+        }
+    }
+
+    template <typename UIntType, int Lanes>
+    void XORShiftMultiLane<UIntType, Lanes>::jump_ahead(uint64_t steps)
+    {
+        // Outputs left over from the last step come first
+        uint64_t left = Lanes - m_index;
+        if (steps <= left)
+        {
+            m_index += int(steps);
+            return;
+        }
+        steps -= left;
+        // Then whole steps of all the lanes, and finally part of one more step
+        for (int j = 0; j < Lanes; j++)
+            m_state[j] = jump_state(m_state[j], steps / Lanes);
+        m_index = Lanes;
+        if (steps % Lanes != 0)
+        {
+            advance(m_buffer, 1);
+            m_index = int(steps % Lanes);
+        }
+    }
+
+    template class XORShiftMultiLane<uint64_t, 4>;
+    template class XORShiftMultiLane<uint32_t, 8>;
+}
+
+// src/Distributions/Discrete/Bernoulli/Bernoulli.cpp
+
+#include <iostream>
+#include <cmath>
+
+namespace DiceForge{
+
+    // Constructor
+    Bernoulli::Bernoulli(real_t p)
+    : p(p)
+    {
+        if (p < 0 || p > 1) {
+            throw std::invalid_argument("Error: Invalid probability value for Bernoulli distribution!");
+        }
+        // p < 1 has at most 53 significant bits, so p * 2^64 is exact
+        cut = (p < 1) ? uint64_t(std::ldexp(p, 64)) : ~uint64_t(0);
+        low = 0;
+        while (low < 63 && cut != 0 && ((cut >> low) & 1) == 0) {
+            low++;
+        }
+    }
+    
+    int_t Bernoulli::next(real_t r) 
+    {  // Generate a random integer based on the Bernoulli distribution
+        if (r>p) { 
+            return 0;
+        }
+        else {
+            return 1;
+        }
+    }
+    
+    real_t Bernoulli::variance() const{
+        // Variance of Bernoulli distribution: p * (1 - p)
+        return p * (1 - p);
+    }
+
+    real_t Bernoulli::expectation() const {
+        // Expectation value of Bernoulli distribution: p
+        return p;
+    }
+
+    int_t Bernoulli::minValue() const  {
+        // Smallest value that can be generated in Bernoulli distribution: 0
+        return 0;
+    }
+
+    int_t Bernoulli::maxValue() const  {
+        // Largest value that can be generated in Bernoulli distribution: 1
+        return 1;
+    }
+
+    real_t Bernoulli::pmf(int_t x) const  {
+        // Probability mass function of Bernoulli distribution
+        return x == 1 ? p : 1 - p;
+    }
+
+    real_t Bernoulli::cdf(int_t x) const  {
+        // Cumulative distribution function of Bernoulli distribution
+        return x == 0 ? 1 - p : 1.0;
+    }    
+
+    int_t Bernoulli::quantile(real_t u) const {
+        detail::check_probability(u);
+        return (u <= 1 - p) ? 0 : 1;
+    }
+};
+
+// src/Distributions/Discrete/Binomial/Binomial.cpp
+
+#include <algorithm>
+
+namespace DiceForge {
+namespace {
+    // Stirling series correction, as in the BTPE acceptance test
+    inline real_t stirling(real_t a, real_t a2) {
+        return (13860. - (462. - (132. - (99. - 140. / a2) / a2) / a2) / a2) / a / 166320.;
+    }
+}
+
+Binomial::Binomial(uint_t n, real_t p)
+    : n(n), p(p) {
+    if (!(p >= 0 && p <= 1)) {
+        throw std::invalid_argument("Expected n > 0 and 0 <= p <= 1");
+    }
+
+    flipped = p > 0.5;
+    s = flipped ? 1 - p : p;
+    lns = std::log(s);
+    lnq = std::log1p(-s);
+
+    const real_t q = 1 - s, mean = n * s;
+    if (mean < inversion_limit) {
+        // Running sums of p(k + 1) = p(k) (n - k) / (k + 1) s / q, until the terms stop changing them
+        real_t pk = std::exp(n * lnq), sum = pk;
+        table.push_back(sum);
+        for (uint_t k = 0; k < n && (k <= mean || pk > sum * 1e-17); k++) {
+            pk *= real_t(n - k) / (k + 1) * s / q;
+            sum += pk;
+            table.push_back(sum);
+        }
+        guide.resize(table.size());
+        size_t k = 0;
+        for (size_t j = 0; j < guide.size(); j++) {
+            while (k + 1 < table.size() && table[k] <= real_t(j) / guide.size()) k++;
+            guide[j] = k;
+        }
+    }
+    else {
+        real_t fm = mean + s;
+        m = int_t(std::floor(fm));
+        p1 = std::floor(2.195 * std::sqrt(mean * q) - 4.6 * q) + 0.5;
+        xm = m + 0.5;
+        xl = xm - p1;
+        xr = xm + p1;
+        c = 0.134 + 20.5 / (15.3 + m);
+        real_t a = (fm - xl) / (fm - xl * s);
+        laml = a * (1 + a / 2);
+        a = (xr - fm) / (xr * q);
+        lamr = a * (1 + a / 2);
+        p2 = p1 * (1 + 2 * c);
+        p3 = p2 + c / laml;
+        p4 = p3 + c / lamr;
+    }
+}
+
+int_t Binomial::btpe(real_t u, real_t v) const {
+    if (v <= 0)
+        return -1;
+    const real_t q = 1 - s, nrq = n * s * q;
+    u *= p4;
+    int_t y;
+
+    // Triangular centre, accepted outright
+    if (u <= p1)
+        return int_t(std::floor(xm - p1 * v + u));
+
+    if (u <= p2) {
+        // Parallelograms
+        real_t x = xl + (u - p1) / c;
+        v = v * c + 1 - std::fabs(m - x + 0.5) / p1;
+        if (v > 1)
+            return -1;
+        y = int_t(std::floor(x));
+    }
+    else if (u <= p3) {
+        // Left exponential tail
+        real_t x = std::floor(xl + std::log(v) / laml);
+        if (x < 0)
+            return -1;
+        y = int_t(x);
+        v *= (u - p2) * laml;
+    }
+    else {
+        // Right exponential tail
+        real_t x = std::floor(xr - std::log(v) / lamr);
+        if (x > n)
+            return -1;
+        y = int_t(x);
+        v *= (u - p3) * lamr;
+    }
+
+    int_t k = std::abs(y - m);
+    if (k <= 20 || k >= nrq / 2 - 1) {
+        // Explicit ratio p(y) / p(m) by the recurrence
+        real_t r = s / q, a = r * (n + 1), f = 1;
+        if (m < y)
+            for (int_t i = m + 1; i <= y; i++) f *= a / i - r;
+        else if (m > y)
+            for (int_t i = y + 1; i <= m; i++) f /= a / i - r;
+        return (v <= f) ? y : -1;
+    }
+
+    // Squeeze on log(v), then the bound with Stirling's formula
+    real_t rho = (k / nrq) * ((k * (k / 3. + 0.625) + 0.16666666666666666) / nrq + 0.5);
+    real_t t = -real_t(k) * k / (2 * nrq);
+    real_t A = std::log(v);
+    if (A < t - rho)
+        return y;
+    if (A > t + rho)
+        return -1;
+
+    real_t x1 = y + 1, f1 = m + 1, z = n + 1 - m, w = n - y + 1;
+    real_t bound = xm * std::log(f1 / x1) + (n - m + 0.5) * std::log(z / w) + (y - m) * std::log(w * s / (x1 * q))
+                   + stirling(f1, f1 * f1) + stirling(z, z * z) + stirling(x1, x1 * x1) + stirling(w, w * w);
+    return (A <= bound) ? y : -1;
+}
+
+int_t Binomial::next(real_t r) {
+    // Inverting Y at 1 - r keeps X = n - Y nondecreasing in r
+    if (flipped)
+        r = 1 - r;
+    int_t y;
+    if (!table.empty())
+        y = from_table(std::min(r, real_t(1) - std::numeric_limits<real_t>::epsilon() / 2));
+    else {
+        // Walk from the mode, with the cdf there from the incomplete beta function
+        const real_t ratio = s / (1 - s);
+        y = m;
+        real_t pk = std::exp(log_nCr(n, m) + m * lns + (n - m) * lnq);
+        real_t F = cdf_y(m);
+        if (r < F) {
+            while (y > 0 && r < F - pk) {
+                F -= pk;
+                pk *= y / (real_t(n - y + 1) * ratio);
+                y--;
+            }
+        }
+        else {
+            while (y < int_t(n) && r >= F) {
+                y++;
+                pk *= real_t(n - y + 1) / y * ratio;
+                F += pk;
+            }
+        }
+    }
+    return flipped ? int_t(n) - y : y;
+}
+
+real_t Binomial::variance() const {
+    return n * p * (1-p);
+}
+
+real_t Binomial::expectation() const {
+    return n * p;
+}
+
+int_t Binomial::minValue() const {
+    return 0;
+}
+
+int_t Binomial::maxValue() const {
+    return n;
+}
+
+real_t Binomial::logpmf(int_t k) const {
+    if (k > int_t(n) || k < 0)
+    {
+        return -std::numeric_limits<real_t>::infinity();
+    }
+    // p^k and (1-p)^(n-k) separately, so that p = 0 and p = 1 give 0^0 = 1
+    real_t l = log_nCr(n, k);
+    if (k > 0) l += k * std::log(p);
+    if (k < int_t(n)) l += (n - k) * std::log1p(-p);
+    return l;
+}
+
+real_t Binomial::pmf(int_t k) const {
+    return std::exp(logpmf(k));
+}
+
+real_t Binomial::cdf_y(int_t k) const {
+    if (k < 0)
+        return 0;
+    if (k >= int_t(n))
+        return 1;
+    if (!table.empty())
+        return (size_t(k) < table.size()) ? table[k] : table.back();
+    return special::beta_inc(n - k, k + 1.0, 1 - s);
+}
+
+real_t Binomial::cdf(int_t k) const {
+    if (k < 0)
+        return 0;
+    if (k >= int_t(n))
+        return 1;
+    if (!flipped)
+        return cdf_y(k);
+    // X <= k exactly when Y >= n - k
+    if (table.empty())
+        return special::beta_inc(n - k, k + 1.0, 1 - p);
+    return 1 - cdf_y(int_t(n) - k - 1);
+}
+} // namespace DiceForge
+
+// src/Distributions/Discrete/Gibbs/Gibbs.cpp
+
+
+namespace DiceForge
+{
+    void Gibbs::init(std::vector<std::pair<int_t, real_t>>& xy, real_t beta){
+        // Sort the pmf in increasing order of x (required for constructing cdf)
+        std::sort(xy.begin(), xy.end());
+
+        // Display error if x values are not unique
+        for (size_t i = 1; i < xy.size(); i++) {
+            if (xy[i].first == xy[i - 1].first) {
+                throw std::invalid_argument("All x values in x_arr must be unique!");
+            }
+        }
+
+        n = xy.size();
+        x_array.resize(n);
+        energy_array.resize(n);
+        for (int_t i = 0; i < n; i++){
+            x_array[i] = xy[i].first;
+            energy_array[i] = xy[i].second;
+        }
+        pmf_array.resize(n);
+        cdf_array.resize(n);
+        alias_prob.resize(n);
+        alias_index.resize(n);
+        work.resize(n);
+        setBeta(beta);
+    }
+
+    void Gibbs::setBeta(real_t beta){
+        current_beta = beta;
+
+        // exp(- beta * E) relative to the largest one, so that large beta neither overflows nor underflows to 0
+        real_t least = beta * energy_array[0];
+        for (int_t i = 1; i < n; i++){
+            least = std::min(least, beta * energy_array[i]);
+        }
+
+        // Store pmf_array and cdf_array (prefix sum array of pmf_array)
+        real_t prev = 0;
+        for (int_t i = 0; i < n; i++){
+            pmf_array[i] = exp(- (beta * energy_array[i] - least));
+            cdf_array[i] = prev + pmf_array[i];
+            prev = cdf_array[i];
+        }
+
+        // Divide by Z(beta) = cdf_array[n - 1] for normalisation
+        real_t Z = cdf_array[n - 1];
+        for (int_t i = 0; i < n; i++){
+            pmf_array[i] /= Z;
+            cdf_array[i] /= Z;
+        }
+
+        // Alias table (Vose): columns below 1 are kept at the front of work and those above 1 at the back,
+        // then every column below 1 is topped up from one above 1
+        int_t small = 0, large = n;
+        for (int_t i = 0; i < n; i++){
+            alias_prob[i] = pmf_array[i] * n;
+            alias_index[i] = i;
+            if (alias_prob[i] < 1)
+                work[small++] = i;
+            else
+                work[--large] = i;
+        }
+        int_t s_end = small, l_begin = large;
+        small = 0;
+        while (small < s_end && l_begin < n){
+            int_t s = work[small++], l = work[l_begin];
+            alias_index[s] = l;
+            alias_prob[l] -= 1 - alias_prob[s];
+            if (alias_prob[l] < 1){
+                // l moves to the small side, into the slot just freed
+                work[--small] = l;
+                l_begin++;
+            }
+        }
+        // Whatever is left is 1 up to rounding
+        for (int_t i = small; i < s_end; i++){
+            alias_prob[work[i]] = 1;
+        }
+        for (int_t i = l_begin; i < n; i++){
+            alias_prob[work[i]] = 1;
+        }
+    }
+
+    real_t Gibbs::getBeta() const{
+        return current_beta;
+    }
+
+    int_t Gibbs::next(real_t r){
+        // Binary search for x such that : P(X < x) <= r < P(X <= x)
+        int_t i = std::upper_bound(cdf_array.begin(), cdf_array.end(), r) - cdf_array.begin();
+        return x_array[std::min(i, n - 1)];
+    }
+
+    real_t Gibbs::variance() const{
+        real_t exp = expectation();
+        real_t v = 0;
+        // var(X) = sum{ p_i * (x_i - E(X))^2 }
+        for (int i = 0; i < n; i++){
+            v += pmf_array[i] * (x_array[i] - exp) * (x_array[i] - exp);
+        }
+        return v;
+    }
+
+    real_t Gibbs::expectation() const{
+        // E(x) = sum{ p_i * x_i }
+        real_t e = 0;
+        for (int i = 0; i < n; i++){
+            e += pmf_array[i] * x_array[i];
+        }
+        return e;
+    }
+
+    int_t Gibbs::minValue() const{
+        // Since x_array is sorted, return first element
+        return x_array[0];
+    }
+
+
+    int_t Gibbs::maxValue() const{
+        // Since x_array is sorted, return last element
+        return x_array[n - 1];
+    }
+
+
+    real_t Gibbs::pmf(int_t x) const{
+        // Binary search for x in x_array and return corresponding pmf
+        auto ptr = std::upper_bound(x_array.begin(), x_array.end(), x);
+        if (ptr == x_array.begin() or *(ptr-1) != x){
+            return 0;
+        }
+        return pmf_array[ptr - x_array.begin() - 1];
+    }
+
+
+    real_t Gibbs::cdf(int_t x) const{
+        // Binary search for x in x_array and return corresponding cdf
+        auto ptr = std::upper_bound(x_array.begin(), x_array.end(), x);
+        if (ptr == x_array.begin()){
+            return 0;
+        }
+        return cdf_array[ptr - x_array.begin() - 1];
+    }
+
+    int_t Gibbs::quantile(real_t p) const{
+        detail::check_probability(p);
+        int_t i = std::lower_bound(cdf_array.begin(), cdf_array.end(), p) - cdf_array.begin();
+        return x_array[std::min(i, n - 1)];
+    }
+}
+
+// src/Distributions/Discrete/DynamicDiscrete/DynamicDiscrete.cpp
+
+
+namespace DiceForge
+{
+    DynamicDiscrete::DynamicDiscrete(size_t n)
+    : n(n)
+    {
+        levels.assign(1, std::vector<real_t>(n, 0));
+        build();
+    }
+
+    void DynamicDiscrete::check_weight(real_t w){
+        if (!(w >= 0) || !std::isfinite(w)) {
+            throw std::invalid_argument("Weights must be finite and not negative!");
+        }
+    }
+
+    void DynamicDiscrete::build(){
+        // Each level padded to a multiple of fanout (at least one group), down to a single group under the total
+        std::vector<real_t> weights = std::move(levels[0]);
+        weights.resize(std::max(fanout, (n + fanout - 1) / fanout * fanout), 0);
+        levels.assign(1, std::move(weights));
+        while (levels.back().size() > fanout) {
+            const size_t groups = levels.back().size() / fanout;
+            levels.emplace_back(std::max(fanout, (groups + fanout - 1) / fanout * fanout), 0);
+        }
+        levels.emplace_back(1, 0);
+        for (size_t l = 0; l + 1 < levels.size(); l++) {
+            const std::vector<real_t>& below = levels[l];
+            std::vector<real_t>& above = levels[l + 1];
+            for (size_t j = 0; j < below.size() / fanout; j++) {
+                real_t s = 0;
+                for (size_t c = 0; c < fanout; c++)
+                    s += below[fanout * j + c];
+                above[j] = s;
+            }
+        }
+    }
+
+    void DynamicDiscrete::repair(size_t i){
+        for (size_t l = 0; l + 1 < levels.size(); l++) {
+            i /= fanout;
+            const real_t* s = levels[l].data() + fanout * i;
+            real_t sum = 0;
+            for (size_t c = 0; c < fanout; c++)
+                sum += s[c];
+            levels[l + 1][i] = sum;
+        }
+    }
+
+    void DynamicDiscrete::repair(const size_t* index, size_t m){
+        if (m > n / fanout) {
+            build();
+            return;
+        }
+        // The parents of the changed nodes, level by level, each recomputed once
+        std::vector<size_t> dirty(index, index + m);
+        for (size_t l = 0; l + 1 < levels.size(); l++) {
+            for (size_t& j : dirty)
+                j /= fanout;
+            std::sort(dirty.begin(), dirty.end());
+            dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+            for (size_t j : dirty) {
+                const real_t* s = levels[l].data() + fanout * j;
+                real_t sum = 0;
+                for (size_t c = 0; c < fanout; c++)
+                    sum += s[c];
+                levels[l + 1][j] = sum;
+            }
+        }
+    }
+
+    size_t DynamicDiscrete::previous_positive(size_t i) const{
+        // Up to the first level where a sibling before the path holds a positive sum, then down its last positive
+        // children: a sum is positive exactly when a weight under it is
+        for (size_t l = 0; l + 1 < levels.size(); l++) {
+            for (size_t k = i; k-- > i - i % fanout;) {
+                if (levels[l][k] > 0) {
+                    for (; l > 0; l--) {
+                        size_t c = fanout;
+                        while (!(levels[l - 1][fanout * k + --c] > 0));
+                        k = fanout * k + c;
+                    }
+                    return k;
+                }
+            }
+            i /= fanout;
+        }
+        return n;
+    }
+
+    size_t DynamicDiscrete::next_positive(size_t i) const{
+        for (size_t l = 0; l + 1 < levels.size(); l++) {
+            for (size_t k = i + 1; k < i - i % fanout + fanout; k++) {
+                if (levels[l][k] > 0) {
+                    for (; l > 0; l--) {
+                        size_t c = 0;
+                        while (!(levels[l - 1][fanout * k + c] > 0))
+                            c++;
+                        k = fanout * k + c;
+                    }
+                    return k;
+                }
+            }
+            i /= fanout;
+        }
+        return n;
+    }
+
+    real_t DynamicDiscrete::prefix(size_t i) const{
+        // The siblings before the node on the path of index i, at every level
+        real_t s = 0;
+        for (size_t l = 0; l + 1 < levels.size(); l++) {
+            for (size_t k = i - i % fanout; k < i; k++)
+                s += levels[l][k];
+            i /= fanout;
+        }
+        return s;
+    }
+
+    void DynamicDiscrete::update(size_t i, real_t w){
+        if (i >= n) {
+            throw std::out_of_range("Index out of range!");
+        }
+        check_weight(w);
+        const real_t old = levels[0][i];
+        levels[0][i] = w;
+        repair(i);
+        if (!std::isfinite(total())) {
+            levels[0][i] = old;
+            repair(i);
+            throw std::invalid_argument("The sum of the weights must be finite!");
+        }
+    }
+
+    void DynamicDiscrete::update(const size_t* index, const real_t* weight, size_t m){
+        for (size_t k = 0; k < m; k++) {
+            if (index[k] >= n) {
+                throw std::out_of_range("Index out of range!");
+            }
+            check_weight(weight[k]);
+        }
+        std::vector<real_t> old(m);
+        for (size_t k = 0; k < m; k++) {
+            old[k] = levels[0][index[k]];
+            levels[0][index[k]] = weight[k];
+        }
+        repair(index, m);
+        if (!std::isfinite(total())) {
+            // Backwards, so that an index given twice gets its first weight back
+            for (size_t k = m; k-- > 0;)
+                levels[0][index[k]] = old[k];
+            repair(index, m);
+            throw std::invalid_argument("The sum of the weights must be finite!");
+        }
+    }
+
+    void DynamicDiscrete::resize(size_t size){
+        levels[0].resize(size);
+        // The padding of a smaller size must be 0 again
+        std::fill(levels[0].begin() + std::min(size, n), levels[0].end(), 0);
+        n = size;
+        build();
+    }
+
+    size_t DynamicDiscrete::size() const{
+        return n;
+    }
+
+    real_t DynamicDiscrete::weight(size_t i) const{
+        if (i >= n) {
+            throw std::out_of_range("Index out of range!");
+        }
+        return levels[0][i];
+    }
+
+    real_t DynamicDiscrete::total() const{
+        return levels.back()[0];
+    }
+
+    int_t DynamicDiscrete::next(real_t r) const{
+        const real_t sum = total();
+        if (!(sum > 0)) {
+            throw std::invalid_argument("All the weights are zero!");
+        }
+        return int_t(find<false>(r * sum));
+    }
+
+    real_t DynamicDiscrete::variance() const{
+        const real_t mean = expectation();
+        real_t s = 0;
+        for (size_t i = 0; i < n; i++)
+            s += levels[0][i] * (real_t(i) - mean) * (real_t(i) - mean);
+        return s / total();
+    }
+
+    real_t DynamicDiscrete::expectation() const{
+        real_t s = 0;
+        for (size_t i = 0; i < n; i++)
+            s += levels[0][i] * real_t(i);
+        return s / total();
+    }
+
+    int_t DynamicDiscrete::minValue() const{
+        return 0;
+    }
+
+    int_t DynamicDiscrete::maxValue() const{
+        return int_t(n) - 1;
+    }
+
+    real_t DynamicDiscrete::pmf(int_t x) const{
+        if (x < 0 || x >= int_t(n))
+            return 0;
+        return levels[0][x] / total();
+    }
+
+    real_t DynamicDiscrete::cdf(int_t x) const{
+        if (x < 0)
+            return 0;
+        if (x >= int_t(n) - 1)
+            return 1;
+        return std::min(prefix(size_t(x) + 1) / total(), real_t(1));
+    }
+
+    int_t DynamicDiscrete::quantile(real_t p) const{
+        detail::check_probability(p);
+        if (p == 0)
+            return 0;
+        // The descent subtracts where cdf adds up, so the two may round apart by an ulp: a step to the positive
+        // weight either side settles it (the cdf of a weight of 0 is that of the one before, up to rounding),
+        // found through the sums so that runs of zero weights are skipped in O(log n)
+        size_t k = find<true>(p * total());
+        for (size_t j = previous_positive(k); j < n && !(cdf(int_t(j)) < p); j = previous_positive(j))
+            k = j;
+        while (k + 1 < n && cdf(int_t(k)) < p){
+            const size_t j = next_positive(k);
+            k = (j < n) ? j : n - 1;
+        }
+        return int_t(k);
+    }
+}
+
+// src/Distributions/Discrete/Hypergeometric/Hypergeometric.cpp
+
+#include <algorithm>
+#include <vector>
+namespace DiceForge
+{
+    Hypergeometric::Hypergeometric(int32_t N, int32_t K, int32_t n) : N(N), K(K), n(n)
+    {
+        // constraints handling
+        if (n > N || K > N || n < 0 || K < 0)
+        {
+           throw std::invalid_argument("invalid parameters (N, K, n)!"\
+           "n and K must be positive, and n and K must not be larger than N");
+        }
+
+        lo = std::max(n + K - N, (int32_t)0);
+        first = lo;
+        hi = std::min(n, K);
+        mode = std::min(hi, std::max(lo, int_t(std::floor((n + 1.0) * (K + 1.0) / (N + 2.0)))));
+        lnorm = log_factorial(K) + log_factorial(N - K) - log_nCr(N, n);
+        lpmode = logpmf(mode);
+
+        real_t var = variance();
+        if (std::sqrt(var) < inversion_limit)
+        {
+            // using the recurrence outwards from the mode, until the probabilities are negligible next to it
+            std::vector<real_t> below;
+            real_t pk = 1;
+            for (int_t k = mode; k > lo; k--)
+            {
+                pk *= ratio_down(k);
+                if (pk < 1e-20)
+                    break;
+                below.push_back(pk);
+            }
+            first = mode - int_t(below.size());
+            pmfs.assign(below.rbegin(), below.rend());
+            pmfs.push_back(1);
+            pk = 1;
+            for (int_t k = mode; k < hi; k++)
+            {
+                pk *= ratio_up(k);
+                if (pk < 1e-20)
+                    break;
+                pmfs.push_back(pk);
+            }
+
+            real_t sum = 0;
+            for (real_t p : pmfs)
+                sum += p;
+            cumulative.resize(pmfs.size());
+            real_t cdf = 0;
+            for (size_t i = 0; i < pmfs.size(); i++)
+            {
+                pmfs[i] /= sum;
+                cdf += pmfs[i];
+                cumulative[i] = cdf;
+            }
+
+            guide.resize(cumulative.size());
+            size_t k = 0;
+            for (size_t j = 0; j < guide.size(); j++)
+            {
+                while (k + 1 < cumulative.size() && cumulative[k] <= real_t(j) / guide.size()) k++;
+                guide[j] = k;
+            }
+        }
+        else
+        {
+            real_t sd = std::sqrt(var + 0.5);
+            centre = expectation() + 0.5;
+            width = 1.7155277699214135 * sd + 0.8989161620588988;
+            cutoff = std::min(hi + 1.0, std::floor(centre + 16 * sd));
+        }
+    }
+
+    // pmf(k + 1) / pmf(k)
+    real_t Hypergeometric::ratio_up(int_t k) const
+    {
+        return ((real_t)(K - k) * (n - k)) / ((real_t)(k + 1) * (N - K - n + k + 1));
+    }
+
+    // pmf(k - 1) / pmf(k)
+    real_t Hypergeometric::ratio_down(int_t k) const
+    {
+        return ((real_t)k * (N - K - n + k)) / ((real_t)(K - k + 1) * (n - k + 1));
+    }
+
+    int_t Hypergeometric::attempt(real_t u, real_t v) const
+    {
+        if (u <= 0)
+            return -1;
+        real_t w = centre + width * (v - 0.5) / u;
+        if (w < lo || w >= cutoff)
+            return -1;
+        int_t k = int_t(std::floor(w));
+        real_t t = logpmf(k) - lpmode;
+        // Squeezes on 2 log(u) <= t
+        if (u * (4 - u) - 3 <= t)
+            return k;
+        if (u * (u - t) >= 1)
+            return -1;
+        return (2 * std::log(u) <= t) ? k : -1;
+    }
+
+    real_t Hypergeometric::tail(int_t x, int step) const
+    {
+        real_t pk = pmf(x), sum = 0;
+        for (int_t k = x; k >= lo && k <= hi; k += step)
+        {
+            sum += pk;
+            if (pk <= sum * 1e-17)
+                break;
+            pk *= (step > 0) ? ratio_up(k) : ratio_down(k);
+        }
+        return sum;
+    }
+
+    // next function returns the first value whose cdf is greater than r
+    int_t Hypergeometric::next(real_t r)
+    {
+        if (!cumulative.empty())
+            return from_table(r);
+
+        // walking from the mode
+        int_t k = mode;
+        real_t pk = std::exp(lpmode), F = cdf(mode);
+        if (r < F)
+        {
+            while (k > lo && r < F - pk)
+            {
+                F -= pk;
+                pk *= ratio_down(k);
+                k--;
+            }
+        }
+        else
+        {
+            while (k < hi && r >= F)
+            {
+                pk *= ratio_up(k);
+                k++;
+                F += pk;
+            }
+        }
+        return k;
+    }
+
+    // theoritical expectation
+    real_t Hypergeometric::expectation() const
+    {
+        return (real_t)n * K / N;
+    }
+
+    // theoritical variance
+    real_t Hypergeometric::variance() const
+    {
+        if (N <= 1)
+            return 0;
+        real_t num = (real_t)n * K * (N - K) * (N - n);
+        real_t den = (real_t)N * N * (N - 1);
+        return num / den;
+    }
+
+    // theoritical minimum
+    int_t Hypergeometric::minValue() const
+    {
+        return lo;
+    }
+
+    // theoritical maximum
+    int_t Hypergeometric::maxValue() const
+    {
+        return hi;
+    }
+
+    // returns log pmf of any value x
+    real_t Hypergeometric::logpmf(int_t x) const
+    {
+        if (x < lo || x > hi)
+            return -std::numeric_limits<real_t>::infinity();
+        return lnorm - log_factorial(x) - log_factorial(K - x)
+               - log_factorial(n - x) - log_factorial(N - K - n + x);
+    }
+
+    // returns pmf of any value x
+    real_t Hypergeometric::pmf(int_t x) const
+    {
+        if (x >= first && x < first + int_t(pmfs.size()))
+            return pmfs[x - first];
+        return std::exp(logpmf(x));
+    }
+
+    // returns cdf of any value x
+    real_t
+    Hypergeometric::cdf(int_t x) const
+    {
+        if (x < lo)
+            return 0;
+        if (x >= hi)
+            return 1;
+        if (x >= first && x + 1 < first + int_t(cumulative.size()))
+            return cumulative[x - first];
+        // summing the shorter tail
+        if (x < mode)
+            return tail(x, -1);
+        return 1 - tail(x + 1, 1);
+    }
+
+}
+
+// src/Distributions/Discrete/Negative-Hypergeometric/NegHypergeometric.cpp
+
+#include <algorithm>
+
+namespace DiceForge {
+    
+    NegHypergeometric::NegHypergeometric(uint_t N, uint_t K, uint_t r)
+        : N(N), K(K), r(r)
+    {
+        if (K > N || r > N - K || N <= 0)
+        {
+            throw std::invalid_argument("Received invalid parameters (N, K, r)!"\
+            "K, r must be positive, N must be non negative"\
+            "K must not be larger than N and r must not be larger than N - K");
+        }
+
+        // with r = 0 the experiment stops at once
+        hi = (r == 0) ? 0 : K;
+        first = 0;
+        lnorm = (r == 0) ? -INFINITY : -log_factorial(r - 1) - log_factorial(N - r - K) - log_nCr(N, K);
+
+        // the pmf is log-concave, so the mode is within one step of the mean
+        mode = std::min(hi, int_t(expectation()));
+        while (mode < hi && ratio_up(mode) > 1)
+            mode++;
+        while (mode > 0 && ratio_down(mode) > 1)
+            mode--;
+        lpmode = logpmf(mode);
+
+        real_t var = variance();
+        if (std::sqrt(var) < inversion_limit)
+        {
+            // precalculate pmfs by the recurrence outwards from the mode, until they are negligible next to it
+            std::vector<real_t> below;
+            real_t pk = 1;
+            for (int_t k = mode; k > 0; k--)
+            {
+                pk *= ratio_down(k);
+                if (pk < 1e-20)
+                    break;
+                below.push_back(pk);
+            }
+            first = mode - int_t(below.size());
+            pmfs.assign(below.rbegin(), below.rend());
+            pmfs.push_back(1);
+            pk = 1;
+            for (int_t k = mode; k < hi; k++)
+            {
+                pk *= ratio_up(k);
+                if (pk < 1e-20)
+                    break;
+                pmfs.push_back(pk);
+            }
+
+            real_t sum = 0;
+            for (real_t p : pmfs)
+                sum += p;
+            cumulative.resize(pmfs.size());
+            real_t cdf = 0;
+            for (size_t i = 0; i < pmfs.size(); i++)
+            {
+                pmfs[i] /= sum;
+                cdf += pmfs[i];
+                cumulative[i] = cdf;
+            }
+
+            guide.resize(cumulative.size());
+            size_t k = 0;
+            for (size_t j = 0; j < guide.size(); j++)
+            {
+                while (k + 1 < cumulative.size() && cumulative[k] <= real_t(j) / guide.size()) k++;
+                guide[j] = k;
+            }
+        }
+        else
+        {
+            real_t sd = std::sqrt(var + 0.5);
+            centre = expectation() + 0.5;
+            width = 1.7155277699214135 * sd + 0.8989161620588988;
+            cutoff = std::min(hi + 1.0, std::floor(centre + 16 * sd));
+        }
+    }
+
+    real_t NegHypergeometric::ratio_up(int_t k) const
+    {
+        return (real_t(k + r) * (K - k)) / (real_t(k + 1) * (N - r - k));
+    }
+
+    real_t NegHypergeometric::ratio_down(int_t k) const
+    {
+        return (real_t(k) * (N - r - k + 1)) / (real_t(k + r - 1) * (K - k + 1));
+    }
+
+    int_t NegHypergeometric::attempt(real_t u, real_t v) const
+    {
+        if (u <= 0)
+            return -1;
+        real_t w = centre + width * (v - 0.5) / u;
+        if (w < 0 || w >= cutoff)
+            return -1;
+        int_t k = int_t(std::floor(w));
+        real_t t = logpmf(k) - lpmode;
+        // Squeezes on 2 log(u) <= t
+        if (u * (4 - u) - 3 <= t)
+            return k;
+        if (u * (u - t) >= 1)
+            return -1;
+        return (2 * std::log(u) <= t) ? k : -1;
+    }
+
+    real_t NegHypergeometric::tail(int_t x, int step) const
+    {
+        real_t pk = pmf(x), sum = 0;
+        for (int_t k = x; k >= 0 && k <= hi; k += step)
+        {
+            sum += pk;
+            if (pk <= sum * 1e-17)
+                break;
+            pk *= (step > 0) ? ratio_up(k) : ratio_down(k);
+        }
+        return sum;
+    }
+
+    int_t NegHypergeometric::next(real_t r) 
+    {
+        if (!cumulative.empty())
+            return from_table(r);
+
+        // walking from the mode
+        int_t k = mode;
+        real_t pk = std::exp(lpmode), F = cdf(mode);
+        if (r < F)
+        {
+            while (k > 0 && r < F - pk)
+            {
+                F -= pk;
+                pk *= ratio_down(k);
+                k--;
+            }
+        }
+        else
+        {
+            while (k < hi && r >= F)
+            {
+                pk *= ratio_up(k);
+                k++;
+                F += pk;
+            }
+        }
+        return k;
+    }
+
+    real_t NegHypergeometric::variance() const
+    {
+        real_t a = r / real_t(N - K + 1);
+        return a * (1 - a) * K * real_t(N + 1) / real_t(N - K + 2);
+    }
+
+    real_t NegHypergeometric::expectation() const 
+    {
+        return real_t(r) * K / real_t(N - K + 1);
+    }
+
+    int_t NegHypergeometric::minValue() const
+    {
+        return 0;
+    }
+
+    int_t NegHypergeometric::maxValue() const
+    {
+        return K;
+    }
+
+    real_t NegHypergeometric::logpmf(int_t k) const 
+    {
+        if (k > hi || k < 0)
+        {
+            return -std::numeric_limits<real_t>::infinity();
+        }
+        if (r == 0)
+        {
+            return 0;
+        }
+        return lnorm + log_factorial(k + r - 1) - log_factorial(k)
+               + log_factorial(N - r - k) - log_factorial(K - k);
+    }
+
+    real_t NegHypergeometric::pmf(int_t k) const 
+    {
+        if (k >= first && k < first + int_t(pmfs.size()))
+        {
+            return pmfs[k - first];
+        }
+        return std::exp(logpmf(k));
+    }
+
+    real_t NegHypergeometric::cdf(int_t k) const 
+    {
+        if (k < 0)
+        {
+            return 0;
+        }
+        if (k >= hi)
+        {
+            return 1;
+        }
+        if (k >= first && k + 1 < first + int_t(cumulative.size()))
+        {
+            return cumulative[k - first];
+        }
+        // summing the shorter tail
+        if (k < mode)
+        {
+            return tail(k, -1);
+        }
+        return 1 - tail(k + 1, 1);
+    }
+}
+
+// src/Distributions/Discrete/Poisson/Poisson.cpp
+
+#include <algorithm>
+
+DiceForge::Poisson::Poisson(DiceForge::real_t lambda)
+{
+    if (!(lambda >= 0)) {
+        throw std::invalid_argument("Lambda must not be negative!");
+    }
+    
+    l=lambda;
+    sq=sqrt(2);
+    lnl=log(l);
+    g=l*lnl-lgamma(l+1);
+
+    if (l<table_limit){
+        // Same running sums as cdf(x), until the terms stop changing them
+        DiceForge::real_t p=exp(-l),sum=p;
+        table.push_back(sum);
+        for (int k=1; k<=l || p>sum*1e-17; k++){
+            p=p*(l/k);
+            sum+=p;
+            table.push_back(sum);
+        }
+        guide.resize(table.size());
+        size_t k=0;
+        for (size_t j=0; j<guide.size(); j++){
+            while (k+1<table.size() && table[k]<=DiceForge::real_t(j)/guide.size()) k++;
+            guide[j]=k;
+        }
+    }
+    else{
+        DiceForge::real_t smu=sqrt(l);
+        b=0.931+2.53*smu;
+        a=-0.059+0.02483*b;
+        inv_alpha=1.1239+1.1328/(b-3.4);
+        vr=0.9277-3.6224/(b-2);
+    }
+}
+
+void DiceForge::Poisson::invert_each(const DiceForge::real_t* u, const DiceForge::real_t* lambda, DiceForge::int_t* out, size_t n){
+    // e^-lambda, the first term of every search, lanes at a time
+    DiceForge::real_t first[256];
+    size_t i=0;
+#if defined(DF_SIMD_REAL)
+    typedef DiceForge::simd::vreal V;
+    for (; i+V::width<=n; i+=V::width)
+        simd::exp(-simd::min(V::load(lambda+i),V(table_limit))).store(first+i);
+#endif
+    for (; i<n; i++) first[i]=exp(-std::min(lambda[i],table_limit));
+    for (i=0; i<n; i++){
+        const DiceForge::real_t l=lambda[i];
+        if (!(l<table_limit)) continue;
+        DiceForge::real_t p=first[i], sum=p;
+        DiceForge::int_t k=0;
+        while (u[i]>=sum && p>sum*1e-17){
+            k++;
+            p*=l/k;
+            sum+=p;
+        }
+        out[i]=k;
+    }
+}
+
+DiceForge::real_t DiceForge::Poisson::variance() const{
+    return l;
+}
+
+DiceForge::real_t DiceForge::Poisson::expectation() const{
+    return l;
+}
+
+DiceForge::int_t DiceForge::Poisson::minValue() const{
+    return 0;
+}
+
+DiceForge::int_t DiceForge::Poisson::maxValue() const{
+    return std::numeric_limits<int_t>::max();
+}
+
+
+DiceForge::real_t DiceForge::Poisson::pmf(DiceForge::int_t x) const{
+    // In logarithms, as l^x and x! overflow long before their ratio does
+    return exp(logpmf(x));
+}
+
+DiceForge::real_t DiceForge::Poisson::cdf(DiceForge::int_t x) const{
+   if (x<0) return 0;
+   if (!table.empty()) return table[std::min(x,DiceForge::int_t(table.size())-1)];
+   return DiceForge::special::gamma_q(x+1.0,l);
+}
+
+DiceForge::real_t DiceForge::Poisson::logpmf(DiceForge::int_t x) const{
+    // x*lnl alone is 0*-inf for lambda = 0
+    return (x<0) ? -INFINITY : (x==0) ? -l : x*lnl-l-log_factorial(x);
+}
+
+void DiceForge::Poisson::pmf(const DiceForge::int_t* x, DiceForge::real_t* out, size_t n) const{
+    logpmf(x,out,n);
+    for (size_t i=0; i<n; i++){
+        out[i]=exp(out[i]);
+    }
+}
+
+void DiceForge::Poisson::logpmf(const DiceForge::int_t* x, DiceForge::real_t* out, size_t n) const{
+    const DiceForge::real_t ln=lnl, m=l;
+    for (size_t i=0; i<n; i++){
+        out[i]=(x[i]<0) ? -INFINITY : (x[i]==0) ? -m : x[i]*ln-m-log_factorial(x[i]);
+    }
+}
+
+void DiceForge::Poisson::cdf(const DiceForge::int_t* x, DiceForge::real_t* out, size_t n) const{
+    for (size_t i=0; i<n; i++){
+        out[i]=cdf(x[i]);
+    }
+}
+
+DiceForge::int_t DiceForge::Poisson::quantile(DiceForge::real_t p) const{
+    if (table.empty()) return Discrete::quantile(p);
+    detail::check_probability(p);
+    DiceForge::int_t k=std::lower_bound(table.begin(),table.end(),p)-table.begin();
+    return std::min(k,DiceForge::int_t(table.size())-1);
+}
+
+// src/Distributions/Discrete/Geometric/Geometric.cpp
+
+#include <iostream>
+
+namespace DiceForge
+{
+    // Constructor
+    Geometric::Geometric(real_t p)
+    : p(p)
+    {
+        if (p < 0 || p > 1) {
+            throw std::invalid_argument("Invalid 'success' probability value for Geometric distribution!");
+        }
+        inv_log_q = 1/log1p(-p);
+    }
+
+    int_t Geometric::next(real_t r) 
+    {  
+        // Inversion: the smallest k with 1 - (1-p)^(k+1) > r
+        return int_t(floor(log1p(-r)*inv_log_q));
+    }
+    
+    void Geometric::invert_each(const real_t* u, const real_t* p, int_t* out, size_t n)
+    {
+        size_t i = 0;
+#if defined(DF_SIMD_REAL)
+        typedef simd::vreal V;
+        real_t t[V::width];
+        for (; i + V::width <= n; i += V::width) {
+            const V x = V::load(u + i), q = V::load(p + i);
+            // p = 1 gives 0, as log1p(-u) / -inf does
+            simd::select(q < V(1.0), simd::log1p(-x) / simd::log1p(-q), V(0.0)).store(t);
+            for (int j = 0; j < V::width; j++)
+                out[i + j] = int_t(floor(t[j]));
+        }
+#endif
+        for (; i < n; i++)
+            out[i] = int_t(floor(log1p(-u[i]) / log1p(-p[i])));
+    }
+
+    real_t Geometric::variance() const{
+        // Variance of Geometric distribution: (1-p)/(p*p)
+        return (1-p)/(p*p);
+    }
+
+    real_t Geometric::expectation() const {
+        // Expectation value of Geometric distribution: (1-p)/p
+        return (1-p)/p;
+    }
+
+    int_t Geometric::minValue() const  {
+        // Smallest value that can be generated in Geometric distribution: 0
+        return 0;
+    }
+
+    int_t Geometric::maxValue() const  {
+        // Largest value that can be generated in Geometric distribution: infinity
+        return std::numeric_limits<int_t>::max();
+    }
+
+    real_t Geometric::pmf(int_t x) const  {
+        // Probability mass function of Geometric distribution
+        real_t f =(1-p); 
+	    return (1-f)*pow(f,x);
+    }
+
+    real_t Geometric::cdf(int_t x) const  {
+        // Cumulative distribution function of Geometric distribution, 1 - (1-p)^(x+1)
+        return (x < 0) ? 0 : -expm1((1+real_t(x))*log1p(-p));
+    }
+
+    real_t Geometric::logpmf(int_t x) const  {
+        real_t f = (1-p);
+        return log(1-f) + x*log(f);
+    }
+
+    void Geometric::pmf(const int_t* x, real_t* out, size_t n) const  {
+        const real_t f = (1-p), lp = log(1-f), lf = log(f);
+        for (size_t i = 0; i < n; i++) {
+            out[i] = exp(lp + x[i]*lf);
+        }
+    }
+
+    void Geometric::logpmf(const int_t* x, real_t* out, size_t n) const  {
+        const real_t f = (1-p), lp = log(1-f), lf = log(f);
+        for (size_t i = 0; i < n; i++) {
+            out[i] = lp + x[i]*lf;
+        }
+    }
+
+    void Geometric::cdf(const int_t* x, real_t* out, size_t n) const  {
+        const real_t lf = log(1-real_t(p));
+        for (size_t i = 0; i < n; i++) {
+            out[i] = -expm1((1+x[i])*lf);
+        }
+    }
+
+    int_t Geometric::quantile(real_t u) const  {
+        detail::check_probability(u);
+        const real_t guess = ceil(log1p(-u)*inv_log_q) - 1;
+        // u = 1 (or p = 1) leaves the search to the cdf
+        if (!(guess < real_t(maxValue())))
+            return Discrete::quantile(u);
+        int_t k = (guess > 0) ? int_t(guess) : 0;
+        while (k > 0 && cdf(k-1) >= u) k--;
+        while (cdf(k) < u) k++;
+        return k;
+    }
+} 
+
+// src/Distributions/Continuous/Cauchy/Cauchy.cpp
+
+#include <algorithm>
+
+namespace DiceForge
+{            
+    Cauchy::Cauchy(real_t x0, real_t gamma)
+    : x0(x0), gamma(gamma), inv_gamma(1 / gamma)
+    {
+        if (gamma < std::numeric_limits<real_t>().epsilon())
+        {
+            throw std::invalid_argument("gamma must be positive!");
+        }
+    }
+
+    real_t Cauchy::next(real_t r) 
+    {
+        return gamma * tan(M_PI * (r - 0.5)) + x0;
+    }
+
+    void Cauchy::transform(real_t* r, size_t n) const
+    {
+        // Kept free of branches and calls other than tan so that it can be vectorised
+        const real_t g = gamma, x = x0;
+        for (size_t i = 0; i < n; i++)
+            r[i] = g * tan(M_PI * (r[i] - 0.5)) + x;
+    }
+
+    void Cauchy::transform(float* r, size_t n) const
+    {
+        const float g = float(gamma), x = float(x0), pi = float(M_PI);
+        for (size_t i = 0; i < n; i++)
+            r[i] = g * std::tan(pi * (r[i] - 0.5f)) + x;
+    }
+
+    real_t Cauchy::variance() const 
+    {
+        return std::numeric_limits<real_t>().quiet_NaN();
+    }
+
+    real_t Cauchy::expectation() const 
+    {
+        return std::numeric_limits<real_t>().quiet_NaN();
+    }
+
+    real_t Cauchy::minValue() const 
+    {
+        return std::numeric_limits<real_t>().lowest();
+    }
+
+    real_t Cauchy::maxValue() const 
+    {
+        return std::numeric_limits<real_t>().max();
+    }
+
+    real_t Cauchy::pdf(real_t x) const 
+    {
+        return M_1_PI * inv_gamma / (1 + (x - x0) * (x - x0) * inv_gamma * inv_gamma);
+    }
+
+    real_t Cauchy::cdf(real_t x) const 
+    {        
+        // 1/2 + atan(z) / pi = atan(-1 / z) / pi for z < 0, without the cancellation in the lower tail
+        real_t z = (x - x0) * inv_gamma;
+        return (z < 0) ? M_1_PI * atan(-1 / z) : M_1_PI * atan(z) + 0.5;
+    }
+
+    real_t Cauchy::logpdf(real_t x) const
+    {
+        real_t z = (x - x0) * inv_gamma;
+        return log(M_1_PI * inv_gamma) - log1p(z * z);
+    }
+
+    void Cauchy::pdf(const real_t* x, real_t* out, size_t n) const
+    {
+        const real_t c = M_1_PI * inv_gamma, s = inv_gamma, m = x0;
+        for (size_t i = 0; i < n; i++)
+        {
+            real_t z = (x[i] - m) * s;
+            out[i] = c / (1 + z * z);
+        }
+    }
+
+    void Cauchy::logpdf(const real_t* x, real_t* out, size_t n) const
+    {
+        const real_t c = log(M_1_PI * inv_gamma), s = inv_gamma, m = x0;
+        for (size_t i = 0; i < n; i++)
+        {
+            real_t z = (x[i] - m) * s;
+            out[i] = c - log1p(z * z);
+        }
+    }
+
+    void Cauchy::cdf(const real_t* x, real_t* out, size_t n) const
+    {
+        const real_t s = inv_gamma, m = x0;
+        for (size_t i = 0; i < n; i++)
+        {
+            real_t z = (x[i] - m) * s;
+            out[i] = (z < 0) ? M_1_PI * atan(-1 / z) : M_1_PI * atan(z) + 0.5;
+        }
+    }
+
+    real_t Cauchy::quantile(real_t p) const
+    {
+        detail::check_probability(p);
+        // tan(pi (p - 1/2)) = -1 / tan(pi p), in whichever tail p is, as 1 - p is exact above 1/2
+        return (p < 0.5) ? x0 - gamma / tan(M_PI * p) : x0 + gamma / tan(M_PI * (1 - p));
+    }
+
+    void Cauchy::quantile(const real_t* p, real_t* out, size_t n) const
+    {
+        for (size_t i = 0; i < n; i++)
+            out[i] = quantile(p[i]);
+    }
+
+    real_t Cauchy::get_x0() const 
+    {
+        return x0;
+    }
+
+    real_t Cauchy::get_gamma() const 
+    {        
+        return gamma;
+    }
+
+    Cauchy fitToCauchy(std::vector<real_t> x, std::vector<real_t> y, int max_iter, real_t epsilon)
+    {
+        if (x.size() != y.size())
+        {
+            throw std::invalid_argument("Number of x-coordinates and y-coordinates provided in the data do not match!");
+        }
+
+        const int N = x.size();
+
+        // sort the points in increasing x
+        std::vector<size_t> order(N);
+        for (size_t i = 0; i < N; i++)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), [&x](size_t a, size_t b) { return x[a] < x[b]; });
+        {
+            std::vector<real_t> xs(N), ys(N);
+            for (size_t i = 0; i < N; i++)
+            {
+                xs[i] = x[order[i]];
+                ys[i] = y[order[i]];
+            }
+            x.swap(xs);
+            y.swap(ys);
+        }
+
+        // initial guessing of x0, gamma
+        real_t x0 = 0, gamma = 1;
+
+        real_t ysum = 0;
+        real_t y2sum = 0;
+        for (size_t i = 0; i < N; i++)
+        {
+            ysum += y[i];
+            y2sum += y[i] * y[i];
+        }
+        real_t mu = ysum / N;
+        real_t stdev = sqrt((y2sum / N) - mu*mu);
+
+        real_t ymax = -INFINITY;
+        for (size_t i = 0; i < N; i++)
+        {
+            // check for outliers
+            if (y[i] > ymax && y[i] - mu < 3 * stdev) 
+            {
+                ymax = y[i];
+
+                // guess x0 as the x value corresponding to maximum y
+                x0 = x[i];
+            }
+        }
+
+        // interquartile guess works reasonably well for gamma
+        gamma = (x[(int)round(3 * N/4.0)] - x[(int)round(N/4.0)]) * 0.4;
+
+        // r_i = y[i] - pdf(x0, gamma, x[i]), minimise sum (r_i)^2 over (x0, gamma)
+        auto model = [](auto x, const real_t* theta, auto* grad)
+        {
+            typedef decltype(x) V;
+            real_t x0 = theta[0], gamma = theta[1];
+            if (!(gamma > 0))
+                return V(NAN);
+            V dx = x - x0, dx2 = dx * dx;
+            V inv_D = 1 / (dx2 + gamma * gamma);
+            V pdf = inv_D * (M_1_PI * gamma);
+            grad[0] = dx * inv_D * inv_D * (2 * M_1_PI * gamma);
+            grad[1] = (dx2 - gamma * gamma) * inv_D * inv_D * M_1_PI;
+            return pdf;
+        };
+
+        real_t theta[2] = {x0, gamma};
+        levenberg_marquardt<2>(model, x.data(), y.data(), N, theta, max_iter, epsilon);
+        x0 = theta[0];
+        gamma = theta[1];
+
+        if (gamma < 0 || std::isnan(x0) || std::isnan(gamma))
+        {
+            throw std::runtime_error("Could not fit data to Cauchy! Data is probably too noisy or not Cauchy!");
+        }
+
+        return Cauchy(x0, gamma);
+    }
+
+    Cauchy fitCauchyFromSamples(const std::vector<real_t>& samples, int max_iter, real_t epsilon)
+    {
+        const size_t N = samples.size();
+        if (N < 4)
+        {
+            throw std::runtime_error("Could not fit samples to Cauchy! At least four samples are needed!");
+        }
+
+        // median and quartiles in linear time
+        std::vector<real_t> s(samples);
+        auto quantile = [&](size_t i)
+        {
+            std::nth_element(s.begin(), s.begin() + i, s.end());
+            return s[i];
+        };
+        real_t x0 = quantile(N / 2);
+        real_t gamma = 0.5 * (quantile(3 * N / 4) - quantile(N / 4));
+        if (!(gamma > 0))
+        {
+            throw std::runtime_error("Could not fit samples to Cauchy! Samples are probably not Cauchy!");
+        }
+
+        // log-likelihood l = sum log(gamma) - log(gamma^2 + d^2), d = x - x0, with its gradient
+        auto pass = [&](real_t x0, real_t gamma, real_t& dx0, real_t& dgamma)
+        {
+            real_t l = 0, g2 = gamma * gamma;
+            dx0 = dgamma = 0;
+            for (size_t i = 0; i < N; i++)
+            {
+                real_t d = samples[i] - x0, D = g2 + d * d;
+                l -= log(D);
+                dx0 += 2 * d / D;
+                dgamma -= 2 * gamma / D;
+            }
+            dgamma += N / gamma;
+            return l + N * log(gamma);
+        };
+
+        // Fisher scoring: the information is N / (2 gamma^2) times the identity, so the step is the gradient scaled by
+        // 2 gamma^2 / N, halved until the likelihood increases
+        real_t dx0, dgamma;
+        real_t l = pass(x0, gamma, dx0, dgamma);
+        for (int i = 0; i < max_iter; i++)
+        {
+            real_t scale = 2 * gamma * gamma / N;
+            real_t step_x0 = scale * dx0, step_gamma = scale * dgamma;
+            bool accepted = false;
+            for (int halving = 0; halving < 30; halving++)
+            {
+                real_t trial_x0 = x0 + step_x0, trial_gamma = gamma + step_gamma;
+                if (trial_gamma > 0)
+                {
+                    real_t tx0, tgamma;
+                    real_t tl = pass(trial_x0, trial_gamma, tx0, tgamma);
+                    if (tl >= l)
+                    {
+                        x0 = trial_x0;
+                        gamma = trial_gamma;
+                        l = tl;
+                        dx0 = tx0;
+                        dgamma = tgamma;
+                        accepted = true;
+                        break;
+                    }
+                }
+                step_x0 *= 0.5;
+                step_gamma *= 0.5;
+            }
+            if (!accepted || (fabs(step_x0) <= epsilon * gamma && fabs(step_gamma) <= epsilon * gamma))
+                break;
+        }
+
+        if (!(gamma > 0) || std::isnan(x0))
+        {
+            throw std::runtime_error("Could not fit samples to Cauchy! Samples are probably not Cauchy!");
+        }
+
+        return Cauchy(x0, gamma);
+    }
+}
+
+// src/Distributions/Continuous/Exponential/Exponential.cpp
+
+
+namespace DiceForge {
+
+    Exponential::Exponential(real_t k, real_t x0) : k(k), x0(x0) {
+        // Check if k is positive
+        if (k <= 0) {
+            throw std::invalid_argument("Rate parameter (k) must be positive");
+        }
+    }
+
+    real_t Exponential::next(real_t r) {
+        // Inverse transform sampling for exponential distribution, the quantile at r
+        return x0 - log1p(-r) / k;
+    }
+
+    void Exponential::scale_each(const real_t* k, real_t* e, size_t n) {
+        size_t j = 0;
+#if defined(DF_SIMD_REAL)
+        typedef simd::vreal V;
+        for (; j + V::width <= n; j += V::width)
+            (V::load(e + j) / V::load(k + j)).store(e + j);
+#endif
+        for (; j < n; j++)
+            e[j] /= k[j];
+    }
+
+    real_t Exponential::variance() const {
+        // Variance formula for exponential distribution
+        return 1 / (k * k);
+    }
+
+    real_t Exponential::expectation() const {
+        // Expectation formula for exponential distribution
+        return x0 + 1 / k;
+    }
+
+    real_t Exponential::minValue() const {
+        // Minimum value for exponential distribution
+        return x0;
+    }
+
+    real_t Exponential::maxValue() const {
+        // Maximum value for exponential distribution
+        return std::numeric_limits<real_t>().max();
+    }
+
+    real_t Exponential::pdf(real_t x) const {
+        if (x < x0) {
+            return 0; // PDF is defined only for x > x0
+        } else {
+            // PDF formula for exponential distribution
+            // Normalized
+            return k * exp(-k * (x - x0));
+        }
+    }
+
+    real_t Exponential::cdf(real_t x) const {
+        // CDF formula for exponential distribution, 0 below the origin
+        return (x < x0) ? 0 : -expm1(-k * (x - x0));
+    }
+
+    real_t Exponential::logpdf(real_t x) const {
+        return (x < x0) ? -INFINITY : log(k) - k * (x - x0);
+    }
+
+    void Exponential::pdf(const real_t* x, real_t* out, size_t n) const {
+        const real_t rate = k, origin = x0;
+        for (size_t i = 0; i < n; i++) {
+            out[i] = (x[i] < origin) ? 0 : rate * exp(-rate * (x[i] - origin));
+        }
+    }
+
+    void Exponential::logpdf(const real_t* x, real_t* out, size_t n) const {
+        const real_t rate = k, origin = x0, log_rate = log(k);
+        for (size_t i = 0; i < n; i++) {
+            out[i] = (x[i] < origin) ? -INFINITY : log_rate - rate * (x[i] - origin);
+        }
+    }
+
+    void Exponential::cdf(const real_t* x, real_t* out, size_t n) const {
+        const real_t rate = k, origin = x0;
+        for (size_t i = 0; i < n; i++) {
+            out[i] = (x[i] < origin) ? 0 : -expm1(-rate * (x[i] - origin));
+        }
+    }
+
+    real_t Exponential::quantile(real_t p) const {
+        detail::check_probability(p);
+        return x0 - log1p(-p) / k;
+    }
+
+    void Exponential::quantile(const real_t* p, real_t* out, size_t n) const {
+        const real_t rate = k, origin = x0;
+        for (size_t i = 0; i < n; i++) {
+            detail::check_probability(p[i]);
+            out[i] = origin - log1p(-p[i]) / rate;
+        }
+    }
+
+    real_t Exponential::get_k() const {
+        return k;
+    }
+    real_t Exponential::get_x0() const {
+        return x0;
+    }
+
+    // fit to exponential distribution using linear regression after taking log
+    Exponential fitToExponential(const std::vector<real_t>& x, const std::vector<real_t>& y, int max_iter, real_t epsilon) {
+        if (x.size() != y.size()) {
+            throw "Number of x-coordinates and y-coordinates provided in the data do not match!";
+        }
+
+        const int N = x.size();
+
+        std::vector<real_t> z, xr;
+        z.reserve(N);
+        xr.reserve(N);
+
+        int valid_N = 0;
+        real_t zmean = 0, xrmean = 0, x0_est = 0, ymax = 0;
+        for (size_t i = 0; i < N; i++)
+        {
+            // Pick out only non-zero pdf data for log regression
+            if (y[i] > 1e-12)
+            {
+                real_t zval = log(y[i]);
+                z.push_back(zval);
+                xr.push_back(x[i]);
+                zmean += zval;
+                xrmean += x[i];
+                valid_N++;
+            }
+
+            if (y[i] > ymax)
+            {
+                ymax = y[i];
+                x0_est = x[i];
+            }
+        }
+        zmean /= valid_N;
+        xrmean /= valid_N;
+
+        // y = k*e^(-k*(x-x0))
+        // ln(y) = ln(k) - k*(x-x0)
+        // ln(y) = -k*x + ln(k) + k*x0
+        // ln(y) = -k*x + c
+        // z = -k*x + c
+        // Perform linear regression to find initial guess
+
+        real_t Sxz = 0, Sxx = 0;
+        for (size_t i = 0; i < valid_N; i++)
+        {
+            Sxz += (xr[i] - xrmean)*(z[i] - zmean);
+            Sxx += (xr[i] - xrmean)*(xr[i] - xrmean);
+        }
+
+        real_t slope = Sxz/Sxx;
+        real_t intercept = zmean - xrmean * slope;
+
+        // Initial guess for k
+        real_t k = -slope;
+        // Initial guess for c
+        real_t c = intercept;
+        
+        // Refine on the pdf itself, y = e^(-k*x + c), over the same non-zero points
+        std::vector<real_t> yr;
+        yr.reserve(valid_N);
+        for (size_t i = 0; i < valid_N; i++)
+            yr.push_back(exp(z[i]));
+
+        auto model = [](auto x, const real_t* theta, auto* grad)
+        {
+            typedef decltype(x) V;
+            V f = simd::exp(x * -theta[0] + theta[1]);
+            grad[0] = -x * f;
+            grad[1] = f;
+            return f;
+        };
+
+        real_t theta[2] = {k, c};
+        levenberg_marquardt<2>(model, xr.data(), yr.data(), valid_N, theta, max_iter, epsilon);
+        k = theta[0];
+        c = theta[1];
+
+        real_t x0 = fmin((c - log(k)) / k, x0_est);
+
+        if (k < 0 || std::isnan(k) || std::isnan(x0))
+        {
+            throw std::runtime_error("Could not fit data to Exponential! Data is probably too noisy or not Exponential!");
+        }
+
+        return Exponential(k, x0);
+    }
+
+    void ExponentialAccumulator::add(real_t x)
+    {
+        n++;
+        sum += x;
+        min = fmin(min, x);
+    }
+
+    void ExponentialAccumulator::add(const real_t* x, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+            add(x[i]);
+    }
+
+    void ExponentialAccumulator::merge(const ExponentialAccumulator& other)
+    {
+        n += other.n;
+        sum += other.sum;
+        min = fmin(min, other.min);
+    }
+
+    size_t ExponentialAccumulator::count() const
+    {
+        return n;
+    }
+
+    void ExponentialAccumulator::write_state(detail::StateWriter& out) const
+    {
+        out.tag("ExponentialAccumulator");
+        out.put(uint64_t(n));
+        out.put(sum);
+        out.put(min);
+    }
+
+    void ExponentialAccumulator::read_state(detail::StateReader& in)
+    {
+        in.tag("ExponentialAccumulator");
+        ExponentialAccumulator loaded;
+        loaded.n = size_t(in.get<uint64_t>());
+        loaded.sum = in.get<real_t>();
+        loaded.min = in.get<real_t>();
+        in.end();
+        *this = loaded;
+    }
+
+    Exponential ExponentialAccumulator::fit() const
+    {
+        real_t excess = n > 0 ? sum / n - min : 0;
+        if (n < 2 || !(excess > 0))
+        {
+            throw std::runtime_error("Could not fit samples to Exponential! At least two distinct samples are needed!");
+        }
+        return Exponential(1 / excess, min);
+    }
+
+    Exponential fitExponentialFromSamples(const std::vector<real_t>& samples)
+    {
+        ExponentialAccumulator acc;
+        acc.add(samples.data(), samples.size());
+        return acc.fit();
+    }
+}
+
+// src/Distributions/Continuous/Gaussian/Gaussian.cpp
+
+
+namespace DiceForge
+{
+    Gaussian::Gaussian(real_t mu, real_t sigma)
+        : mu(mu), sigma(sigma)
+    {
+        if (sigma < std::numeric_limits<real_t>().epsilon())
+        {
+            throw std::invalid_argument("Value of sigma must be positive!");
+        }
+        inv_sigma = 1 / sigma;
+        norm = inv_sigma / sqrt(2.0 * M_PI);
+        log_norm = log(norm);
+    }
+
+    real_t Gaussian::next(real_t r1, real_t r2)
+    {
+        return (sqrt(-2.0 * log(r1)) * cos(2 * M_PI * r2)) * sigma + mu;
+    }
+
+    std::pair<real_t, real_t> Gaussian::next_pair(real_t r1, real_t r2)
+    {
+        // The sine half of Box-Muller is independent of the cosine half
+        real_t r = sqrt(-2.0 * log(r1)) * sigma;
+        return std::make_pair(r * cos(2 * M_PI * r2) + mu, r * sin(2 * M_PI * r2) + mu);
+    }
+
+    void Gaussian::scale_each(const real_t* mu, const real_t* sigma, real_t* z, size_t n)
+    {
+        size_t j = 0;
+#if defined(DF_SIMD_REAL)
+        typedef simd::vreal V;
+        for (; j + V::width <= n; j += V::width)
+            (V::load(z + j) * V::load(sigma + j) + V::load(mu + j)).store(z + j);
+#endif
+        for (; j < n; j++)
+            z[j] = z[j] * sigma[j] + mu[j];
+    }
+
+    real_t Gaussian::variance() const
+    {
+        return sigma * sigma;
+    }
+
+    real_t Gaussian::expectation() const
+    {
+        return mu;
+    }
+
+    real_t Gaussian::minValue() const
+    {
+        return std::numeric_limits<real_t>().lowest();
+    }
+
+    real_t Gaussian::maxValue() const
+    {
+        return std::numeric_limits<real_t>().max();
+    }
+
+    real_t Gaussian::pdf(real_t x) const
+    {
+        real_t z = (x - mu) * inv_sigma;
+        return norm * exp(-0.5 * z * z);
+    }
+
+    real_t Gaussian::cdf(real_t x) const
+    {
+        return special::normal_cdf((x - mu) * inv_sigma);
+    }
+
+    real_t Gaussian::logpdf(real_t x) const
+    {
+        real_t z = (x - mu) * inv_sigma;
+        return log_norm - 0.5 * z * z;
+    }
+
+    void Gaussian::pdf(const real_t* x, real_t* out, size_t n) const
+    {
+        const real_t m = mu, s = inv_sigma, c = norm;
+        for (size_t i = 0; i < n; i++)
+        {
+            real_t z = (x[i] - m) * s;
+            out[i] = c * exp(-0.5 * z * z);
+        }
+    }
+
+    void Gaussian::logpdf(const real_t* x, real_t* out, size_t n) const
+    {
+        const real_t m = mu, s = inv_sigma, c = log_norm;
+        for (size_t i = 0; i < n; i++)
+        {
+            real_t z = (x[i] - m) * s;
+            out[i] = c - 0.5 * z * z;
+        }
+    }
+
+    void Gaussian::cdf(const real_t* x, real_t* out, size_t n) const
+    {
+        const real_t m = mu, s = inv_sigma;
+        for (size_t i = 0; i < n; i++)
+            out[i] = (x[i] - m) * s;
+        special::normal_cdf(out, out, n);
+    }
+
+    real_t Gaussian::quantile(real_t p) const
+    {
+        detail::check_probability(p);
+        return mu + sigma * special::normal_quantile(p);
+    }
+
+    void Gaussian::quantile(const real_t* p, real_t* out, size_t n) const
+    {
+        for (size_t i = 0; i < n; i++)
+            detail::check_probability(p[i]);
+        special::normal_quantile(p, out, n);
+        const real_t m = mu, s = sigma;
+        for (size_t i = 0; i < n; i++)
+            out[i] = m + s * out[i];
+    }
+
+    real_t Gaussian::get_mu() const
+    {
+        return mu;
+    }
+
+    real_t Gaussian::get_sigma() const
+    {
+        return sigma;
+    }
+
+    void Gaussian::write_state(detail::StateWriter& out) const
+    {
+        out.tag("Gaussian");
+        out.put(mu);
+        out.put(sigma);
+        out.put(uint8_t(has_cached));
+        out.put(cached);
+    }
+
+    void Gaussian::read_state(detail::StateReader& in)
+    {
+        in.tag("Gaussian");
+        const real_t m = in.get<real_t>(), s = in.get<real_t>();
+        const bool c = in.get<uint8_t>() != 0;
+        const real_t z = in.get<real_t>();
+        in.end();
+        // Through the constructor, which checks sigma and derives the constants of the pdf
+        *this = Gaussian(m, s);
+        has_cached = c;
+        cached = z;
+    }
+
+    Gaussian fitToGaussian(const std::vector<real_t> &x, const std::vector<real_t> &y, int max_iter, real_t epsilon)
+    {
+        if (x.size() != y.size())
+        {
+            throw "Number of x-coordinates and y-coordinates provided in the data do not match!";
+        }
+
+        const int N = x.size();
+
+        // Initial guessing of mu, sigma
+        real_t mu = 1, sigma = 1;
+
+        real_t ysum = 0;
+        real_t y2sum = 0;
+        for (size_t i = 0; i < N; i++)
+        {
+            ysum += y[i];
+            y2sum += y[i] * y[i];
+        }
+        real_t mu_guess = ysum / N;
+        real_t sigma_guess = sqrt((y2sum / N) - mu_guess * mu_guess);
+
+        real_t ymax = -INFINITY;
+        for (size_t i = 0; i < N; i++)
+        {
+            // Check for outliers
+            if (y[i] > ymax && y[i] - mu_guess < 3 * sigma_guess)
+            {
+                ymax = y[i];
+
+                // Guess mu as the x value corresponding to maximum y
+                mu = x[i];
+            }
+        }
+        //computing max and min x values from given data
+        real_t xmax = x[0], xmin = x[0];
+        for (size_t i = 0; i < N; i++)
+        {
+            if (x[i] > xmax)
+                xmax = x[i];
+            if (x[i] < xmin)
+                xmin = x[i];
+        }
+        //setting initial guess of sigma
+        sigma = (xmax - xmin) / 6;
+
+        // r_i = y[i] - pdf(mu, sigma, x[i]), minimise sum (r_i)^2 over (mu, sigma)
+        auto model = [](auto x, const real_t* theta, auto* grad)
+        {
+            typedef decltype(x) V;
+            real_t mu = theta[0], sigma = theta[1];
+            if (!(sigma > 0))
+                return V(NAN);
+            real_t inv_sigma = 1 / sigma;
+            V z = (x - mu) * inv_sigma;
+            V pdf = simd::exp(z * z * -0.5) * (inv_sigma / sqrt(2 * M_PI));
+
+            // Partial derivatives of the Gaussian function with respect to mu and sigma
+            grad[0] = z * inv_sigma * pdf;
+            grad[1] = (z * z - 1) * inv_sigma * pdf;
+            return pdf;
+        };
+
+        real_t theta[2] = {mu, sigma};
+        levenberg_marquardt<2>(model, x.data(), y.data(), N, theta, max_iter, epsilon);
+        mu = theta[0];
+        sigma = theta[1];
+
+        if (sigma < 0 || std::isnan(sigma))
+        {
+            throw std::runtime_error("Could not fit data to Gaussian! Data is probably too noisy or not Gaussian!");
+        }
+
+        return Gaussian(mu, sigma);
+    }
+
+    void GaussianAccumulator::add(real_t x)
+    {
+        // Welford's update
+        n++;
+        real_t delta = x - mean;
+        mean += delta / n;
+        m2 += delta * (x - mean);
+    }
+
+    void GaussianAccumulator::add(const real_t* x, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+            add(x[i]);
+    }
+
+    void GaussianAccumulator::merge(const GaussianAccumulator& other)
+    {
+        if (other.n == 0)
+            return;
+        size_t total = n + other.n;
+        real_t delta = other.mean - mean;
+        mean += delta * other.n / total;
+        m2 += other.m2 + delta * delta * n * other.n / total;
+        n = total;
+    }
+
+    size_t GaussianAccumulator::count() const
+    {
+        return n;
+    }
+
+    void GaussianAccumulator::write_state(detail::StateWriter& out) const
+    {
+        out.tag("GaussianAccumulator");
+        out.put(uint64_t(n));
+        out.put(mean);
+        out.put(m2);
+    }
+
+    void GaussianAccumulator::read_state(detail::StateReader& in)
+    {
+        in.tag("GaussianAccumulator");
+        GaussianAccumulator loaded;
+        loaded.n = size_t(in.get<uint64_t>());
+        loaded.mean = in.get<real_t>();
+        loaded.m2 = in.get<real_t>();
+        in.end();
+        *this = loaded;
+    }
+
+    Gaussian GaussianAccumulator::fit() const
+    {
+        if (n < 2 || !(m2 > 0))
+        {
+            throw std::runtime_error("Could not fit samples to Gaussian! At least two distinct samples are needed!");
+        }
+        return Gaussian(mean, sqrt(m2 / n));
+    }
+
+    Gaussian fitGaussianFromSamples(const std::vector<real_t>& samples)
+    {
+        GaussianAccumulator acc;
+        acc.add(samples.data(), samples.size());
+        return acc.fit();
+    }
+}
+
+// src/Distributions/Continuous/Maxwell/Maxwell.cpp
+
+#include <math.h>
+
+namespace DiceForge
+{            
+    Maxwell::Maxwell(real_t a) : a(a)
+    {
+        if (a<=0)
+        {
+            throw std::invalid_argument("Scaling factor a must be positive!");
+        }
+    }
+
+    real_t Maxwell::next(real_t r1, real_t r2, real_t r3) 
+    {
+        // x1^2 + x2^2 for a Box-Muller pair from (r1, r) is -2 log(r1) whatever r is
+        real_t x3 = sqrt(-2.0 * log(r2)) * cos(2 * M_PI * r3);
+
+        return a * sqrt(-2.0 * log(r1) + x3 * x3);
+    }
+
+    real_t Maxwell::variance() const 
+    {
+        return (a * a) * (3 * M_PI - 8)/ M_PI;
+    }
+
+    real_t Maxwell::expectation() const 
+    {
+        return (2 * a) * sqrt(2 / M_PI);
+    }
+
+    real_t Maxwell::minValue() const 
+    {
+        return 0;
+    }
+
+    real_t Maxwell::maxValue() const 
+    {
+        return std::numeric_limits<real_t>().max();
+    }
+
+    real_t Maxwell::pdf(real_t x) const 
+    {
+        return sqrt(2 / M_PI) * x * x * exp(-1 * x * x / (2 * a * a)) / (a * a * a);
+    }
+
+    real_t Maxwell::cdf(real_t x) const 
+    {        
+        return (x > 0) ? special::gamma_p(1.5, x * x / (2 * a * a)) : 0;
+    } 
+
+    real_t Maxwell::logpdf(real_t x) const
+    {
+        return log(sqrt(2 / M_PI) / (a * a * a)) + log(x * x) - x * x / (2 * a * a);
+    }
+
+    void Maxwell::pdf(const real_t* x, real_t* out, size_t n) const
+    {
+        const real_t c = sqrt(2 / M_PI) / (a * a * a), h = 1 / (2 * a * a);
+        for (size_t i = 0; i < n; i++)
+            out[i] = c * x[i] * x[i] * exp(-h * x[i] * x[i]);
+    }
+
+    void Maxwell::logpdf(const real_t* x, real_t* out, size_t n) const
+    {
+        const real_t c = log(sqrt(2 / M_PI) / (a * a * a)), h = 1 / (2 * a * a);
+        for (size_t i = 0; i < n; i++)
+            out[i] = c + log(x[i] * x[i]) - h * x[i] * x[i];
+    }
+
+    void Maxwell::cdf(const real_t* x, real_t* out, size_t n) const
+    {
+        const real_t h = 1 / (2 * a * a);
+        for (size_t i = 0; i < n; i++)
+            out[i] = (x[i] > 0) ? special::gamma_p(1.5, x[i] * x[i] * h) : 0;
+    }
+
+    real_t Maxwell::quantile(real_t p) const
+    {
+        detail::check_probability(p);
+        return a * sqrt(2 * special::gamma_p_inverse(1.5, p));
+    }
+
+    void Maxwell::quantile(const real_t* p, real_t* out, size_t n) const
+    {
+        for (size_t i = 0; i < n; i++)
+            out[i] = quantile(p[i]);
+    }
+
+    real_t Maxwell::get_a() const
+    {
+        return a;
+    }
+
+    void Maxwell::write_state(detail::StateWriter& out) const
+    {
+        out.tag("Maxwell");
+        out.put(a);
+        out.put(uint8_t(has_cached));
+        out.put(cached);
+    }
+
+    void Maxwell::read_state(detail::StateReader& in)
+    {
+        in.tag("Maxwell");
+        const real_t scale = in.get<real_t>();
+        const bool c = in.get<uint8_t>() != 0;
+        const real_t z = in.get<real_t>();
+        in.end();
+        // Through the constructor, which checks the scale
+        *this = Maxwell(scale);
+        has_cached = c;
+        cached = z;
+    }
+
+    Maxwell fitToMaxwell(const std::vector<real_t>& x, const std::vector<real_t>& y, int max_iter, real_t epsilon)
+    {
+        if (x.size() != y.size())
+        {
+            throw std::invalid_argument("Number of x-coordinates and y-coordinates provided in the data do no match!");
+        }
+
+        const int N=x.size();
+
+        //initial guess of a using the fact that mode of the distribution is sqrt2 * a;
+        real_t a = 1;
+        real_t ymax = -INFINITY;
+        for (size_t i = 0; i < N; i++)
+        {
+            if (y[i] > ymax) 
+            {
+                ymax = y[i];
+                a = x[i] * M_SQRT1_2;
+            }
+        }
+
+        // r_i = y[i] - pdf(a, x[i]), minimise sum (r_i)^2 over a
+        auto model = [](auto x, const real_t* theta, auto* grad)
+        {
+            typedef decltype(x) V;
+            real_t a = theta[0];
+            if (!(a > 0))
+                return V(NAN);
+            V x2 = x * x;
+            V f = x2 * simd::exp(x2 * (-1 / (2 * a * a))) * (sqrt(2 / M_PI) / (a * a * a));
+            grad[0] = f * (x2 * (1 / (a * a * a)) - 3 / a);
+            return f;
+        };
+
+        levenberg_marquardt<1>(model, x.data(), y.data(), N, &a, max_iter, epsilon);
+
+        if (a < 0 || std::isnan(a))
+        {
+            throw std::runtime_error("Could not fit data to Maxwell distribution! Data is probably too noisy or not Maxwell!");
+        }
+
+        return Maxwell(a);
+    }
+
+    void MaxwellAccumulator::add(real_t x)
+    {
+        n++;
+        sum2 += x * x;
+    }
+
+    void MaxwellAccumulator::add(const real_t* x, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+            add(x[i]);
+    }
+
+    void MaxwellAccumulator::merge(const MaxwellAccumulator& other)
+    {
+        n += other.n;
+        sum2 += other.sum2;
+    }
+
+    size_t MaxwellAccumulator::count() const
+    {
+        return n;
+    }
+
+    void MaxwellAccumulator::write_state(detail::StateWriter& out) const
+    {
+        out.tag("MaxwellAccumulator");
+        out.put(uint64_t(n));
+        out.put(sum2);
+    }
+
+    void MaxwellAccumulator::read_state(detail::StateReader& in)
+    {
+        in.tag("MaxwellAccumulator");
+        MaxwellAccumulator loaded;
+        loaded.n = size_t(in.get<uint64_t>());
+        loaded.sum2 = in.get<real_t>();
+        in.end();
+        *this = loaded;
+    }
+
+    Maxwell MaxwellAccumulator::fit() const
+    {
+        if (n < 1 || !(sum2 > 0))
+        {
+            throw std::runtime_error("Could not fit samples to Maxwell distribution! At least one non-zero sample is needed!");
+        }
+        return Maxwell(sqrt(sum2 / (3 * n)));
+    }
+
+    Maxwell fitMaxwellFromSamples(const std::vector<real_t>& samples)
+    {
+        MaxwellAccumulator acc;
+        acc.add(samples.data(), samples.size());
+        return acc.fit();
+    }
+}
+
+// src/Distributions/Continuous/MultivariateGaussian/MultivariateGaussian.cpp
+
+#include <algorithm>
+#include <cmath>
+
+namespace DiceForge {
+
+    namespace {
+        // Loads and stores with the same spelling for real_t and simd::vreal
+        template <typename V>
+        struct lanes
+        {
+            static constexpr size_t width = 1;
+            static V load(const real_t* p) { return *p; }
+            static void store(real_t* p, V v) { *p = v; }
+        };
+#if defined(DF_SIMD_REAL)
+        template <>
+        struct lanes<simd::vreal>
+        {
+            static constexpr size_t width = simd::vreal::width;
+            static simd::vreal load(const real_t* p) { return simd::vreal::load(p); }
+            static void store(real_t* p, simd::vreal v) { v.store(p); }
+        };
+#endif
+
+        // One tile of 4 rows of the factor times the block of standard normals zt (one row of block reals per
+        // dimension), over its K columns: y[r * block + c] = sum_k l[4 k + r] zt[k * block + c]
+        template <typename V>
+        void multiply_tile(const real_t* l, size_t K, const real_t* zt, real_t* y)
+        {
+            constexpr size_t w = lanes<V>::width, block = MultivariateGaussian::block;
+            for (size_t c = 0; c < block; c += 2 * w)
+            {
+                V a00(0.0), a01(0.0), a10(0.0), a11(0.0), a20(0.0), a21(0.0), a30(0.0), a31(0.0);
+                for (size_t k = 0; k < K; k++)
+                {
+                    const V z0 = lanes<V>::load(zt + k * block + c), z1 = lanes<V>::load(zt + k * block + c + w);
+                    const V l0(l[4 * k]), l1(l[4 * k + 1]), l2(l[4 * k + 2]), l3(l[4 * k + 3]);
+                    a00 += l0 * z0, a01 += l0 * z1;
+                    a10 += l1 * z0, a11 += l1 * z1;
+                    a20 += l2 * z0, a21 += l2 * z1;
+                    a30 += l3 * z0, a31 += l3 * z1;
+                }
+                lanes<V>::store(y + c, a00), lanes<V>::store(y + c + w, a01);
+                lanes<V>::store(y + block + c, a10), lanes<V>::store(y + block + c + w, a11);
+                lanes<V>::store(y + 2 * block + c, a20), lanes<V>::store(y + 2 * block + c + w, a21);
+                lanes<V>::store(y + 3 * block + c, a30), lanes<V>::store(y + 3 * block + c + w, a31);
+            }
+        }
+    }
+
+    MultivariateGaussian::MultivariateGaussian(const std::vector<real_t>& mean, const std::vector<real_t>& covariance)
+        : d(mean.size()), mu(mean), sigma(covariance), factor(mean.size() * mean.size(), 0.0)
+    {
+        if (d == 0 || covariance.size() != d * d)
+            throw std::invalid_argument("Expected a non-empty mean and a d x d covariance!");
+
+        // Cholesky-Banachiewicz, row by row
+        real_t log_det = 0;
+        for (size_t i = 0; i < d; i++) {
+            for (size_t j = 0; j <= i; j++) {
+                real_t s = covariance[i * d + j];
+                for (size_t k = 0; k < j; k++)
+                    s -= factor[i * d + k] * factor[j * d + k];
+                if (j < i)
+                    factor[i * d + j] = s / factor[j * d + j];
+                else {
+                    if (!(s > 0))
+                        throw std::invalid_argument("The covariance must be positive definite!");
+                    factor[i * d + i] = std::sqrt(s);
+                    log_det += 2 * std::log(factor[i * d + i]);
+                }
+            }
+        }
+        log_norm = -0.5 * (d * std::log(2 * M_PI) + log_det);
+
+        const size_t tiles = (d + 3) / 4;
+        offset.resize(tiles + 1);
+        offset[0] = 0;
+        for (size_t t = 0; t < tiles; t++)
+            offset[t + 1] = offset[t] + 4 * std::min(4 * t + 4, d);
+        packed.assign(offset[tiles], 0.0);
+        for (size_t t = 0; t < tiles; t++)
+            for (size_t r = 0; r < 4 && 4 * t + r < d; r++)
+                for (size_t k = 0; k <= 4 * t + r; k++)
+                    packed[offset[t] + 4 * k + r] = factor[(4 * t + r) * d + k];
+    }
+
+    size_t MultivariateGaussian::dimensions() const {
+        return d;
+    }
+
+    void MultivariateGaussian::transform(real_t* z, size_t n) const {
+        // A few vectors are not worth the transposes: x_i = mu_i + sum_k<=i L_ik z_k, from the last component down
+        // so that every z_k is still there when it is needed
+        if (n < 8) {
+            for (size_t v = 0; v < n; v++) {
+                real_t* x = z + v * d;
+                for (size_t i = d; i-- > 0;) {
+                    real_t s = 0;
+                    for (size_t k = 0; k <= i; k++)
+                        s += factor[i * d + k] * x[k];
+                    x[i] = mu[i] + s;
+                }
+            }
+            return;
+        }
+
+        const size_t tiles = (d + 3) / 4;
+        std::vector<real_t> zt(d * block, 0.0), y(4 * tiles * block);
+        for (size_t first = 0; first < n; first += block) {
+            const size_t m = std::min(block, n - first);
+            real_t* x = z + first * d;
+            // Transpose the block, one row per dimension (the columns past m stay 0 in the last block)
+            if (m < block)
+                std::fill(zt.begin(), zt.end(), 0.0);
+            for (size_t v = 0; v < m; v++)
+                for (size_t k = 0; k < d; k++)
+                    zt[k * block + v] = x[v * d + k];
+
+            for (size_t t = 0; t < tiles; t++) {
+#if defined(DF_SIMD_REAL)
+                multiply_tile<simd::vreal>(packed.data() + offset[t], std::min(4 * t + 4, d), zt.data(),
+                                           y.data() + 4 * t * block);
+#else
+                multiply_tile<real_t>(packed.data() + offset[t], std::min(4 * t + 4, d), zt.data(),
+                                      y.data() + 4 * t * block);
+#endif
+            }
+
+            for (size_t v = 0; v < m; v++)
+                for (size_t k = 0; k < d; k++)
+                    x[v * d + k] = mu[k] + y[k * block + v];
+        }
+    }
+
+    real_t MultivariateGaussian::logpdf(const real_t* x) const {
+        // |L^-1 (x - mu)|^2 by forward substitution
+        std::vector<real_t> y(d);
+        real_t q = 0;
+        for (size_t i = 0; i < d; i++) {
+            real_t s = x[i] - mu[i];
+            for (size_t k = 0; k < i; k++)
+                s -= factor[i * d + k] * y[k];
+            y[i] = s / factor[i * d + i];
+            q += y[i] * y[i];
+        }
+        return log_norm - 0.5 * q;
+    }
+
+    real_t MultivariateGaussian::pdf(const real_t* x) const {
+        return std::exp(logpdf(x));
+    }
+
+    const std::vector<real_t>& MultivariateGaussian::get_mu() const {
+        return mu;
+    }
+
+    const std::vector<real_t>& MultivariateGaussian::get_sigma() const {
+        return sigma;
+    }
+
+    const std::vector<real_t>& MultivariateGaussian::get_cholesky() const {
+        return factor;
+    }
+}
+
+// src/Distributions/Continuous/Weibull/Weibull.cpp
+
+#include <algorithm>
+
+namespace DiceForge{            
+    Weibull::Weibull(real_t lambda, real_t k)
+            : k(k), lambda(lambda) {
+        if (lambda < std::numeric_limits<real_t>().epsilon()){
+            throw std::invalid_argument("Value of lambda(scale factor) must be positive!");
+        }
+
+        if (k < std::numeric_limits<real_t>().epsilon()){
+            throw std::invalid_argument("Value of k(shape factor) must be positive!");
+        }
+    }
+
+    real_t Weibull::next(real_t r) {
+        return lambda * std::pow(-std::log(1 - r), 1/k);
+    }
+
+    void Weibull::scale_exponentials(real_t* x, size_t n) const {
+        const real_t l = lambda, inv_k = 1 / k;
+        if (k == 1) {
+            for (size_t i = 0; i < n; i++)
+                x[i] *= l;
+        }
+        else if (k == 2) {
+            for (size_t i = 0; i < n; i++)
+                x[i] = l * std::sqrt(x[i]);
+        }
+        else {
+            for (size_t i = 0; i < n; i++)
+                x[i] = l * std::pow(x[i], inv_k);
+        }
+    }
+
+    void Weibull::scale_exponentials(float* x, size_t n) const {
+        const float l = float(lambda), inv_k = float(1 / k);
+        if (k == 1) {
+            for (size_t i = 0; i < n; i++)
+                x[i] *= l;
+        }
+        else if (k == 2) {
+            for (size_t i = 0; i < n; i++)
+                x[i] = l * std::sqrt(x[i]);
+        }
+        else {
+            for (size_t i = 0; i < n; i++)
+                x[i] = l * std::pow(x[i], inv_k);
+        }
+    }
+
+    real_t Weibull::variance() const{
+        return pow(lambda, 2) * (std::tgamma(1 + 2/k) - pow(std::tgamma(1 + 1/k), 2));
+    }
+
+    real_t Weibull::expectation() const {
+        return lambda * std::tgamma(1 + 1/k);
+    }
+
+    real_t Weibull::minValue() const{
+        return 0;
+    }
+
+    real_t Weibull::maxValue() const{
+        return std::numeric_limits<real_t>().max();
+    }
+
+    real_t Weibull::pdf(real_t x) const {
+        if(x < 0)
+            return 0;
+        x = x / lambda;
+        return (k/lambda) * std::pow(x, k-1) * exp(-std::pow(x, k));
+    }
+
+    real_t Weibull::cdf(real_t x) const{        
+        if(x < 0)
+            return 0;
+        x = x / lambda;
+        return -expm1(-std::pow(x, k));
+    }
+
+    real_t Weibull::logpdf(real_t x) const {
+        if(x < 0)
+            return -INFINITY;
+        x = x / lambda;
+        return std::log(k / lambda) + (k - 1) * std::log(x) - std::pow(x, k);
+    }
+
+    void Weibull::pdf(const real_t* x, real_t* out, size_t n) const {
+        const real_t s = 1 / lambda, c = k / lambda, e = k;
+        for (size_t i = 0; i < n; i++) {
+            real_t z = x[i] * s;
+            out[i] = (x[i] < 0) ? 0 : c * std::pow(z, e - 1) * exp(-std::pow(z, e));
+        }
+    }
+
+    void Weibull::logpdf(const real_t* x, real_t* out, size_t n) const {
+        const real_t s = 1 / lambda, c = std::log(k / lambda), e = k;
+        for (size_t i = 0; i < n; i++) {
+            real_t z = x[i] * s;
+            out[i] = (x[i] < 0) ? -INFINITY : c + (e - 1) * std::log(z) - std::pow(z, e);
+        }
+    }
+
+    void Weibull::cdf(const real_t* x, real_t* out, size_t n) const {
+        const real_t s = 1 / lambda, e = k;
+        for (size_t i = 0; i < n; i++) {
+            out[i] = (x[i] < 0) ? 0 : -expm1(-std::pow(x[i] * s, e));
+        }
+    }
+
+    real_t Weibull::quantile(real_t p) const
+    {
+        detail::check_probability(p);
+        return lambda * std::pow(-log1p(-p), 1 / k);
+    }
+
+    void Weibull::quantile(const real_t* p, real_t* out, size_t n) const
+    {
+        const real_t s = lambda, e = 1 / k;
+        for (size_t i = 0; i < n; i++) {
+            detail::check_probability(p[i]);
+            out[i] = s * std::pow(-log1p(-p[i]), e);
+        }
+    }
+
+    real_t Weibull::get_lambda() const
+    {
+        return lambda;
+    }
+
+    real_t Weibull::get_k() const
+    {
+        return k;
+    }
+
+    Weibull fitToWeibull(std::vector<real_t> x, std::vector<real_t> y, int max_iter, real_t epsilon) 
+    {
+        if (x.size() != y.size())
+        {
+            throw std::invalid_argument("Number of x-coordinates and y-coordinates provided in the data do not match!");
+        }
+
+        const int N = x.size();        
+
+        // sort the points in increasing x
+        std::vector<size_t> order(N);
+        for (size_t i = 0; i < N; i++)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), [&x](size_t a, size_t b) { return x[a] < x[b]; });
+        {
+            std::vector<real_t> xs(N), ys(N);
+            for (size_t i = 0; i < N; i++)
+            {
+                xs[i] = x[order[i]];
+                ys[i] = y[order[i]];
+            }
+            x.swap(xs);
+            y.swap(ys);
+        }
+
+        real_t yr_mean = 0, xr_mean = 0;
+
+        std::vector<real_t> yreg, xreg;
+        yreg.reserve(N); xreg.reserve(N);
+        int valid_N = 0;
+
+        // running trapezoidal estimate of the cdf
+        real_t cdf = 0;
+        for (size_t i = 1; i < N; i++)
+        {
+            cdf += 0.5 * (y[i] + y[i-1]) * (x[i] - x[i-1]);
+
+            if (cdf > 1e-12 && cdf < 1)
+            {
+                real_t yr = log(-log(1-cdf)), xr = log(x[i]);
+                yreg.emplace_back(yr);
+                xreg.emplace_back(xr);
+                yr_mean += yr;
+                xr_mean += xr;
+                valid_N++;
+            }
+        }
+
+        yr_mean /= valid_N;
+        xr_mean /= valid_N;
+
+        real_t Sxy = 0, Sxx = 0;
+        for (size_t i = 0; i < valid_N; i++)
+        {
+            Sxy += (xreg[i] - xr_mean)*(yreg[i] - yr_mean);
+            Sxx += (xreg[i] - xr_mean)*(xreg[i] - xr_mean);
+        }
+
+        real_t slope = Sxy/Sxx;
+        real_t intercept = yr_mean - xr_mean * slope;
+
+        real_t k = slope;
+        real_t lambda = pow(exp(intercept / (-slope)), 0.7);
+        real_t shift = 0;
+
+        // r_i = y[i] - pdf(lambda, k, x[i]), minimise sum (r_i)^2 over (lambda, k)
+        auto model = [shift](auto x, const real_t* theta, auto* grad)
+        {
+            typedef decltype(x) V;
+            real_t lambda = theta[0], k = theta[1];
+            if (!(lambda > 0 && k > 0))
+                return V(NAN);
+            V z = (x - shift) * (1 / lambda);
+
+            // the pdf (and its gradient) vanishes for z <= 0, where z is replaced by 1 to keep the log finite
+            auto positive = z > 0;
+            z = simd::select(positive, z, V(1));
+            V log_z = simd::log(z);
+            V zk = simd::exp(log_z * k);
+            V pdfexpr = simd::select(positive, zk / z * simd::exp(-zk) * (k/lambda), V(0));
+
+            grad[0] = pdfexpr * (zk - 1) * (k/lambda);
+            grad[1] = pdfexpr * (log_z * (1 - zk) + 1/k);
+            return pdfexpr;
+        };
+
+        real_t theta[2] = {lambda, k};
+        levenberg_marquardt<2>(model, x.data(), y.data(), N, theta, max_iter, epsilon);
+        lambda = theta[0];
+        k = theta[1];
+
+        if (lambda <= 0 || k <= 0 || std::isnan(lambda) || std::isnan(k))
+        {
+            throw std::runtime_error("Could not fit data to Weibull! Data is probably too noisy or not Weibull!");
+        }
+
+        return Weibull(lambda, k);
+    }
+
+    void WeibullAccumulator::add(real_t x)
+    {
+        if (!(x > 0))
+        {
+            throw std::invalid_argument("Samples of a Weibull distribution have to be positive!");
+        }
+        real_t l = log(x);
+        n++;
+        real_t delta = l - mean;
+        mean += delta / n;
+        m2 += delta * (l - mean);
+        max = fmax(max, l);
+    }
+
+    void WeibullAccumulator::add(const real_t* x, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+            add(x[i]);
+    }
+
+    void WeibullAccumulator::merge(const WeibullAccumulator& other)
+    {
+        if (other.n == 0)
+            return;
+        size_t total = n + other.n;
+        real_t delta = other.mean - mean;
+        mean += delta * other.n / total;
+        m2 += other.m2 + delta * delta * n * other.n / total;
+        max = fmax(max, other.max);
+        n = total;
+    }
+
+    size_t WeibullAccumulator::count() const
+    {
+        return n;
+    }
+
+    void WeibullAccumulator::write_state(detail::StateWriter& out) const
+    {
+        out.tag("WeibullAccumulator");
+        out.put(uint64_t(n));
+        out.put(mean);
+        out.put(m2);
+        out.put(max);
+    }
+
+    void WeibullAccumulator::read_state(detail::StateReader& in)
+    {
+        in.tag("WeibullAccumulator");
+        WeibullAccumulator loaded;
+        loaded.n = size_t(in.get<uint64_t>());
+        loaded.mean = in.get<real_t>();
+        loaded.m2 = in.get<real_t>();
+        loaded.max = in.get<real_t>();
+        in.end();
+        *this = loaded;
+    }
+
+    real_t WeibullAccumulator::log_mean() const
+    {
+        return mean;
+    }
+
+    real_t WeibullAccumulator::log_max() const
+    {
+        return max;
+    }
+
+    Weibull WeibullAccumulator::fit() const
+    {
+        if (n < 2 || !(m2 > 0))
+        {
+            throw std::runtime_error("Could not fit samples to Weibull! At least two distinct samples are needed!");
+        }
+        const real_t euler_gamma = 0.57721566490153286061;
+        real_t k = M_PI / (sqrt(6 * m2 / n));
+        return Weibull(exp(mean + euler_gamma / k), k);
+    }
+
+    Weibull fitWeibullFromSamples(const std::vector<real_t>& samples, int max_iter, real_t epsilon)
+    {
+        WeibullAccumulator acc;
+        acc.add(samples.data(), samples.size());
+        real_t k = acc.fit().get_k();
+
+        // With u = log(x) - max log(x) and w = e^(k u), the likelihood is maximised over lambda by
+        // lambda^k = mean of x^k, leaving g(k) = sum(w u) / sum(w) + max log(x) - mean log(x) - 1/k = 0,
+        // whose derivative sum(w u^2) / sum(w) - (sum(w u) / sum(w))^2 + 1/k^2 is positive
+        const size_t N = samples.size();
+        const real_t shift = acc.log_max(), offset = shift - acc.log_mean();
+        real_t S0 = 0;
+        auto pass = [&](real_t k, real_t& S1, real_t& S2)
+        {
+            S0 = S1 = S2 = 0;
+            for (size_t i = 0; i < N; i++)
+            {
+                real_t u = log(samples[i]) - shift, w = exp(k * u);
+                S0 += w;
+                S1 += w * u;
+                S2 += w * u * u;
+            }
+        };
+
+        real_t S1, S2;
+        for (int i = 0; i < max_iter; i++)
+        {
+            pass(k, S1, S2);
+            real_t r1 = S1 / S0;
+            real_t g = r1 + offset - 1 / k;
+            real_t dg = S2 / S0 - r1 * r1 + 1 / (k * k);
+            real_t next = k - g / dg;
+            if (!(next > 0))
+                next = 0.5 * k;
+            bool converged = fabs(next - k) <= epsilon * k;
+            k = next;
+            if (converged)
+                break;
+        }
+        pass(k, S1, S2);
+        real_t lambda = exp(shift + log(S0 / N) / k);
+
+        if (!(lambda > 0) || !(k > 0) || std::isinf(lambda) || std::isinf(k))
+        {
+            throw std::runtime_error("Could not fit samples to Weibull! Samples are probably not Weibull!");
+        }
+
+        return Weibull(lambda, k);
+    }
+}
+
+// src/Distributions/Continuous/Custom/Custom.cpp
+
+#include <functional>
+#include <algorithm>
+#include <cmath>
+
+namespace DiceForge {
+
+    void CustomDistribution::build(std::vector<real_t>& f, bool smooth)
+    {
+        const int n = int(f.size() / 2);
+        const real_t h = (upper_limit - lower_limit) / real_t(n); // Step size between knots
+
+        // Simpson's rule for CDF calculation, segment by segment over the shared grid
+        std::vector<real_t> grid(n + 1), F(n + 1);
+        grid[0] = lower_limit;
+        F[0] = 0;
+        for (int i = 1; i <= n; i++) {
+            grid[i] = (i == n) ? upper_limit : lower_limit + i * h;
+            F[i] = F[i - 1] + h * (f[2 * i - 2] + 4 * f[2 * i - 1] + f[2 * i]) / 6;
+        }
+
+        // Normalise, so that every r in [0, 1) falls in some segment
+        real_t total = F[n];
+        if (!(total > 0))
+            throw std::invalid_argument("The pdf must have a positive integral over the range!");
+        for (int i = 1; i <= n; i++)
+            F[i] /= total;
+        for (real_t& v : f)
+            v /= total;
+
+        // Expectation and variance of the pdf itself by adaptive Gauss-Kronrod integration, normalised by its
+        // integral, as the grid values only give them to the accuracy of Simpson's rule
+        const PDF_Function& p = pdf_function;
+        real_t mass = integrate_adaptive<real_t>(p, lower_limit, upper_limit).value;
+        if (!(mass > 0))
+            mass = total;
+        m_expectation = integrate_adaptive<real_t>([&](real_t x) { return x * p(x); }, lower_limit, upper_limit).value / mass;
+        const real_t mean = m_expectation;
+        m_variance = integrate_adaptive<real_t>([&](real_t x) { return (x - mean) * (x - mean) * p(x); },
+                                                lower_limit, upper_limit).value / mass;
+
+        // Slopes of the inverse cdf, dx/dcdf = 1/pdf, limited as in Fritsch-Carlson so that every segment stays
+        // monotone; segments where the pdf vanishes at an end are interpolated linearly
+        std::vector<real_t> left(n), right(n);
+        for (int i = 0; i < n; i++) {
+            real_t d = F[i + 1] - F[i];
+            real_t secant = (d > 0) ? (grid[i + 1] - grid[i]) / d : 0;
+            left[i] = right[i] = secant;
+            real_t f_prev = f[2 * i], f_next = f[2 * i + 2];
+            if (smooth && d > 0 && f_prev > 0 && f_next > 0) {
+                real_t a = 1 / (f_prev * secant), b = 1 / (f_next * secant);
+                real_t tau = (a * a + b * b > 9) ? 3 / std::sqrt(a * a + b * b) : 1;
+                left[i] = tau * a * secant;
+                right[i] = tau * b * secant;
+            }
+        }
+
+        // g[j] = the last segment starting at or below j / n
+        std::vector<uint64_t> g(n);
+        size_t k = 0;
+        for (size_t j = 0; j < g.size(); j++) {
+            while (k + 1 < size_t(n) && F[k + 1] <= real_t(j) / g.size())
+                k++;
+            g[j] = k;
+        }
+
+        density = detail::TableArray<real_t>(std::move(f));
+        knots = detail::TableArray<real_t>(std::move(grid));
+        knot_cdf = detail::TableArray<real_t>(std::move(F));
+        slope_left = detail::TableArray<real_t>(std::move(left));
+        slope_right = detail::TableArray<real_t>(std::move(right));
+        guide = detail::TableArray<uint64_t>(std::move(g));
+    }
+
+    CustomDistribution::CustomDistribution(const std::string& path, PDF_Function pdf) : pdf_function(pdf)
+    {
+        // Array 0 holds the limits and the moments, the others the tables in the order of save_table
+        auto file = std::make_shared<const TableFile>(path);
+        file->expect("CustomDistribution");
+        std::pair<const real_t*, size_t> parameters = file->array<real_t>(0);
+        if (file->arrays() != 7 || parameters.second != 4)
+            throw std::invalid_argument("The table file does not fit a CustomDistribution");
+        lower_limit = parameters.first[0];
+        upper_limit = parameters.first[1];
+        m_expectation = parameters.first[2];
+        m_variance = parameters.first[3];
+        density = detail::TableArray<real_t>(file, 1);
+        knots = detail::TableArray<real_t>(file, 2);
+        knot_cdf = detail::TableArray<real_t>(file, 3);
+        slope_left = detail::TableArray<real_t>(file, 4);
+        slope_right = detail::TableArray<real_t>(file, 5);
+        guide = detail::TableArray<uint64_t>(file, 6);
+        const size_t n = guide.size();
+        if (!(upper_limit > lower_limit) || n < 1 || density.size() != 2 * n + 1 || knots.size() != n + 1
+            || knot_cdf.size() != n + 1 || slope_left.size() != n || slope_right.size() != n)
+            throw std::invalid_argument("The table file does not fit a CustomDistribution");
+        // invert indexes the tables with the guide, which must hold segments at or below those of j / n
+        for (size_t j = 0; j < n; j++)
+            if (!(guide[j] < n) || !(knot_cdf[size_t(guide[j])] <= real_t(j) / n))
+                throw std::invalid_argument("The guide table of the file is damaged");
+    }
+
+    void CustomDistribution::save_table(const std::string& path) const
+    {
+        const real_t parameters[4] = {lower_limit, upper_limit, m_expectation, m_variance};
+        detail::TableWriter writer("CustomDistribution");
+        writer.add(parameters, 4);
+        writer.add(density.data(), density.size());
+        writer.add(knots.data(), knots.size());
+        writer.add(knot_cdf.data(), knot_cdf.size());
+        writer.add(slope_left.data(), slope_left.size());
+        writer.add(slope_right.data(), slope_right.size());
+        writer.add(guide.data(), guide.size());
+        writer.write(path);
+    }
+
+    real_t CustomDistribution::invert(real_t u) const
+    {
+        // The guide table gives a segment at or below the one holding u, which is at most a few steps away
+        size_t i = size_t(guide[std::min(size_t(u * guide.size()), guide.size() - 1)]);
+        while (i + 1 < guide.size() && knot_cdf[i + 1] <= u)
+            i++;
+        real_t d = knot_cdf[i + 1] - knot_cdf[i];
+        if (!(d > 0))
+            return knots[i];
+
+        // Cubic Hermite interpolation (linear when the slopes equal the secant)
+        real_t t = (u - knot_cdf[i]) / d, t2 = t * t, t3 = t2 * t;
+        return (2 * t3 - 3 * t2 + 1) * knots[i] + (-2 * t3 + 3 * t2) * knots[i + 1]
+               + d * ((t3 - 2 * t2 + t) * slope_left[i] + (t3 - t2) * slope_right[i]);
+    }
+
+    real_t CustomDistribution::next(real_t r)
+    {
+        return invert(r);
+    }
+
+    void CustomDistribution::transform(real_t* r, size_t n) const
+    {
+        for (size_t i = 0; i < n; i++)
+            r[i] = invert(r[i]);
+    }
+        
+    real_t CustomDistribution::expectation() const 
+    {
+        return m_expectation;
+    }
+
+    real_t CustomDistribution::variance() const 
+    {
+        return m_variance;
+    }
+
+    real_t CustomDistribution::minValue() const 
+    {
+        return lower_limit;
+    }
+    
+    real_t CustomDistribution::maxValue() const 
+    {
+        return upper_limit;
+    }
+
+    real_t CustomDistribution::pdf(real_t x) const 
+    {
+        if (x>upper_limit || x<lower_limit)
+            throw std::invalid_argument("Enter a value within the domain of this pdf!");
+
+        if (pdf_function)
+            return pdf_function(x);
+
+        // The quadratic through the three pdf values of the segment holding x
+        const size_t n = guide.size();
+        const real_t h = (upper_limit - lower_limit) / real_t(n);
+        size_t i = std::min(size_t((x - lower_limit) / h), n - 1);
+        real_t s = (x - knots[i]) / h;
+        real_t f0 = density[2 * i], fm = density[2 * i + 1], f1 = density[2 * i + 2];
+        return f0 + s * ((-3 * f0 + 4 * fm - f1) + s * (2 * f0 - 4 * fm + 2 * f1));
+    }
+
+    real_t CustomDistribution::cdf(real_t x) const 
+    {   
+        if (x>upper_limit || x<lower_limit)
+            throw std::invalid_argument("Enter a value within the domain of this pdf!");
+
+        // Segment holding x, and the integral of the quadratic through its three pdf values up to x
+        const size_t n = guide.size();
+        const real_t h = (upper_limit - lower_limit) / real_t(n);
+        size_t i = std::min(size_t((x - lower_limit) / h), n - 1);
+        real_t s = (x - knots[i]) / h;
+        real_t f0 = density[2 * i], fm = density[2 * i + 1], f1 = density[2 * i + 2];
+        real_t area = h * s * (f0 + s * ((-3 * f0 + 4 * fm - f1) / 2 + s * (2 * f0 - 4 * fm + 2 * f1) / 3));
+        return std::min(real_t(1), knot_cdf[i] + area);
+    }
+
+} // namespace DiceForge
+
+
+
+#endif
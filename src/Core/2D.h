@@ -5,6 +5,8 @@
 
 #include <iostream>
 #include <vector>
+#include <array>
+#include <tuple>
 #include <type_traits>
 #include <concepts>
 
@@ -12,123 +14,118 @@
 #include <cmath>
 
 #include "basicfxn.h"
+#include "quadrature.h"
 
 namespace DiceForge
 {
     /* Helper functions for integration */
 
-    template <typename valuetype = long double>
-    auto weights()
+    namespace detail
     {
-        using pair_t = std::pair<valuetype, valuetype>;
-        using wts = std::vector<pair_t>;
+        // cos by its Taylor series, accurate for |x| <= pi, for the compile time starting guesses below
+        constexpr long double cos_series(long double x)
+        {
+            long double term = 1, sum = 1;
+            for (int k = 1; k < 40; k++)
+            {
+                term *= -x * x / ((2 * k - 1) * (2 * k));
+                sum += term;
+            }
+            return sum;
+        }
 
-        return wts
+        template <int N, typename T>
+        struct gauss_legendre_table
         {
-                std::make_pair(0.0486909570091397, -0.024350292663424),
-                std::make_pair(0.0486909570091397, 0.0243502926634244),
-                std::make_pair(0.0485754674415034, -0.072993121787799),
-                std::make_pair(0.0485754674415034, 0.0729931217877990),
-                std::make_pair(0.0483447622348030, -0.121462819296120),
-                std::make_pair(0.0483447622348030, 0.1214628192961206),
-                std::make_pair(0.0479993885964583, -0.169644420423992),
-                std::make_pair(0.0479993885964583, 0.1696444204239928),
-                std::make_pair(0.0475401657148303, -0.217423643740007),
-                std::make_pair(0.0475401657148303, 0.2174236437400071),
-                std::make_pair(0.0469681828162100, -0.264687162208767),
-                std::make_pair(0.0469681828162100, 0.2646871622087674),
-                std::make_pair(0.0462847965813144, -0.311322871990211),
-                std::make_pair(0.0462847965813144, 0.3113228719902110),
-                std::make_pair(0.0454916279274181, -0.357220158337668),
-                std::make_pair(0.0454916279274181, 0.3572201583376681),
-                std::make_pair(0.0445905581637566, -0.402270157963991),
-                std::make_pair(0.0445905581637566, 0.4022701579639916),
-                std::make_pair(0.0435837245293235, -0.446366017253464),
-                std::make_pair(0.0435837245293235, 0.4463660172534641),
-                std::make_pair(0.0424735151236536, -0.489403145707053),
-                std::make_pair(0.0424735151236536, 0.4894031457070530),
-                std::make_pair(0.0412625632426235, -0.531279464019894),
-                std::make_pair(0.0412625632426235, 0.5312794640198946),
-                std::make_pair(0.0399537411327203, -0.571895646202634),
-                std::make_pair(0.0399537411327203, 0.5718956462026340),
-                std::make_pair(0.0385501531786156, -0.611155355172393),
-                std::make_pair(0.0385501531786156, 0.6111553551723933),
-                std::make_pair(0.0370551285402400, -0.648965471254657),
-                std::make_pair(0.0370551285402400, 0.6489654712546573),
-                std::make_pair(0.0354722132568824, -0.685236313054233),
-                std::make_pair(0.0354722132568824, 0.6852363130542333),
-                std::make_pair(0.0338051618371416, -0.719881850171610),
-                std::make_pair(0.0338051618371416, 0.7198818501716109),
-                std::make_pair(0.0320579283548516, -0.752819907260531),
-                std::make_pair(0.0320579283548516, 0.7528199072605319),
-                std::make_pair(0.0302346570724025, -0.783972358943341),
-                std::make_pair(0.0302346570724025, 0.7839723589433414),
-                std::make_pair(0.0283396726142595, -0.813265315122797),
-                std::make_pair(0.0283396726142595, 0.8132653151227975),
-                std::make_pair(0.0263774697150547, -0.840629296252580),
-                std::make_pair(0.0263774697150547, 0.8406292962525803),
-                std::make_pair(0.0243527025687109, -0.865999398154092),
-                std::make_pair(0.0243527025687109, 0.8659993981540928),
-                std::make_pair(0.0222701738083833, -0.889315445995114),
-                std::make_pair(0.0222701738083833, 0.8893154459951141),
-                std::make_pair(0.0201348231535302, -0.910522137078502),
-                std::make_pair(0.0201348231535302, 0.9105221370785028),
-                std::make_pair(0.0179517157756973, -0.929569172131939),
-                std::make_pair(0.0179517157756973, 0.9295691721319396),
-                std::make_pair(0.0157260304760247, -0.946411374858402),
-                std::make_pair(0.0157260304760247, 0.9464113748584028),
-                std::make_pair(0.0134630478967186, -0.961008799652053),
-                std::make_pair(0.0134630478967186, 0.9610087996520538),
-                std::make_pair(0.0111681394601311, -0.973326827789911),
-                std::make_pair(0.0111681394601311, 0.9733268277899110),
-                std::make_pair(0.0088467598263639, -0.983336253884626),
-                std::make_pair(0.0088467598263639, 0.9833362538846260),
-                std::make_pair(0.0065044579689784, -0.991013371476744),
-                std::make_pair(0.0065044579689784, 0.9910133714767443),
-                std::make_pair(0.0041470332605625, -0.996340116771955),
-                std::make_pair(0.0041470332605625, 0.9963401167719553),
-                std::make_pair(0.0017832807216964, -0.999305041735772),
-                std::make_pair(0.0017832807216964, 0.9993050417357722)
-            
+            std::array<T, N> nodes{};   // roots of the Legendre polynomial P_N, increasing
+            std::array<T, N> weights{};
         };
+
+        // Newton's method on P_N (evaluated by its three term recurrence) from the approximation
+        // cos(pi (i + 3/4) / (N + 1/2)) of the i-th largest root, carried out in long double
+        template <int N, typename T>
+        constexpr gauss_legendre_table<N, T> make_gauss_legendre()
+        {
+            static_assert(N >= 1, "a Gauss-Legendre rule needs at least one node");
+            constexpr long double pi = 3.141592653589793238462643383279502884L;
+            gauss_legendre_table<N, T> table;
+            for (int i = 0; i < (N + 1) / 2; i++)
+            {
+                long double x = (2 * i + 1 == N) ? 0 : cos_series(pi * (i + 0.75L) / (N + 0.5L)), dp = 0;
+                for (int iter = 0; iter < 100; iter++)
+                {
+                    long double p0 = 1, p1 = x;
+                    for (int k = 2; k <= N; k++)
+                    {
+                        long double p2 = ((2 * k - 1) * x * p1 - (k - 1) * p0) / k;
+                        p0 = p1;
+                        p1 = p2;
+                    }
+                    // P_N'(x) from P_N and P_(N-1)
+                    dp = (N == 1) ? 1 : N * (x * p1 - p0) / (x * x - 1);
+                    long double dx = p1 / dp;
+                    x -= dx;
+                    if (dx <= 1e-18L && dx >= -1e-18L)
+                        break;
+                }
+                long double w = 2 / ((1 - x * x) * dp * dp);
+                table.nodes[i] = T(-x);
+                table.nodes[N - 1 - i] = T(x);
+                table.weights[i] = table.weights[N - 1 - i] = T(w);
+            }
+            return table;
+        }
+
+        // Integrands evaluated in batches, f(const T* x, T* out, size_t n) as for the pdf of a distribution
+        template <typename F, typename T>
+        concept batch_integrand_c = std::is_invocable_v<F&, const T*, T*, size_t>;
+    }
+
+    /// @brief Nodes and weights of the N-point Gauss-Legendre rule on [-1, 1] in the type T, computed at compile time
+    template <int N, typename T = double>
+    inline constexpr detail::gauss_legendre_table<N, T> gauss_legendre_rule = detail::make_gauss_legendre<N, T>();
+
+    /// @brief N-point Gauss-Legendre quadrature of f over [x1, x2], exact for polynomials of degree below 2N
+    /// @param f the integrand, either f(x) or a batch integrand f(const T* x, T* out, size_t n) evaluating all the
+    /// nodes in one call (e.g. a vectorized pdf), no copies of it are made
+    /// @note Needs no heap memory; the nodes are mapped to [x1, x2] and the weighted sum is taken over arrays on the stack
+    template <int N, typename T, typename F>
+    T gauss_legendre(F &&f, T x1, T x2)
+    {
+        constexpr const detail::gauss_legendre_table<N, T>& rule = gauss_legendre_rule<N, T>;
+        const T a = (x2 - x1) / 2, b = (x2 + x1) / 2;
+        T x[N], y[N];
+        for (int i = 0; i < N; i++)
+            x[i] = a * rule.nodes[i] + b;
+
+        if constexpr (detail::batch_integrand_c<F, T>)
+            f(static_cast<const T*>(x), y, size_t(N));
+        else
+            for (int i = 0; i < N; i++)
+                y[i] = f(x[i]);
+
+        T I{};
+        for (int i = 0; i < N; i++)
+            I += rule.weights[i] * y[i];
+        return a * I;
     }
 
+    /// @brief 64-point Gauss-Legendre quadrature of f over [x1, x2] (see gauss_legendre)
     template <typename T1 = double, typename T2 = double (&)(double)>
     T1 gaussian_quadrature(T2 &&f, T1 x1, T1 x2)
     {
-        auto weight = weights();
-        auto a = (x2 - x1) / 2.0;
-        auto b = (x2 + x1) / 2.0;
-        T1 I{};
-        for (auto &&[w, t] : weight)
-        {
-            I += w * f(a * t + b);
-        }
-        I *= a;
-        return I;
+        using value_t = std::conditional_t<std::is_floating_point_v<T1>, T1, double>;
+        return T1(gauss_legendre<64>(f, value_t(x1), value_t(x2)));
     }
     
+    /// @brief Adaptive Gauss-Kronrod quadrature of f over [a, b] to a relative error of about 100 epsilon of T1
+    /// (see integrate_adaptive for control over the tolerances and the evaluation budget)
     template <typename T1 = double, typename T2 = double (&)(double)>
     T1 adaptive_gaussian_quadrature(T2 &&f, T1 a, T1 b)
     {
-        constexpr T1 tolerance = std::numeric_limits<T1>::epsilon();
-
-        auto c = (a + b) / 2;
-
-        auto s1 = gaussian_quadrature(f, a, b);
-
-        auto s2 = gaussian_quadrature(f, a, c) + gaussian_quadrature(f, c, b);
-
-        auto diff = std::abs(s1 - s2);
-
-        if (diff <= tolerance)
-        {
-            return s2;
-        }
-        else
-        {
-            return adaptive_gaussian_quadrature(f, a, c) + adaptive_gaussian_quadrature(f, c, b);
-        }
+        using value_t = std::conditional_t<std::is_floating_point_v<T1>, T1, double>;
+        constexpr value_t tolerance = std::numeric_limits<value_t>::epsilon();
+        return T1(integrate_adaptive<value_t>(f, value_t(a), value_t(b), 100 * tolerance, tolerance).value);
     }
     
     // defining a concept which is a predicate to constrain template type T is of arithmetic type
@@ -207,6 +204,228 @@ namespace DiceForge
 
         return DiceForge::integrate(F0, bounds_0);
     }
+
+    /// @brief Asks the two variable integrators below to spread their work over threads
+    struct parallel_t
+    {
+        int threads = 0; // total number of threads, 0 for std::thread::hardware_concurrency, 1 to stay serial
+    };
+    // Parallel execution on all hardware threads, parallel_t{n} for n threads
+    inline constexpr parallel_t parallel{};
+
+    namespace detail
+    {
+        // Calls f with v0 and v1 placed as the variables First and Second
+        template <auto First, auto Second, typename T, typename FuncType>
+        auto apply_ordered(FuncType &f, T v0, T v1)
+        {
+            std::tuple<T, T> args{};
+            std::get<First>(args) = v0;
+            std::get<Second>(args) = v1;
+            return std::apply(f, args);
+        }
+    }
+
+    /// @brief The two variable integrate(f, bounds_0, bounds_1, integration sequence) with the inner integrals of the
+    /// 64 outer nodes computed in parallel, e.g. integrate(f, bounds_0, bounds_1, DiceForge::dy_dx, DiceForge::parallel)
+    /// @param policy number of threads to use (f and the bounds are called from all of them at once)
+    /// @return The same value as the serial integrate, as every node is integrated on its own and the weighted sum is
+    /// taken in order
+    template <auto First, auto Second, typename FuncType,
+              typename Lower_0, typename Upper_0,
+              typename Lower_1, typename Upper_1>
+    std::common_type_t<Lower_0, Upper_0>
+    integrate(FuncType &&f,
+             std::tuple<Lower_0, Upper_0> bounds_0,
+             std::tuple<Lower_1, Upper_1> bounds_1, std::integer_sequence<int, First, Second> integration_sequence,
+             parallel_t policy)
+    {
+        using bound_t = std::common_type_t<Lower_0, Upper_0>;
+        using value_t = std::conditional_t<std::is_floating_point_v<bound_t>, bound_t, double>;
+        constexpr int N = 64;
+        constexpr const detail::gauss_legendre_table<N, value_t>& rule = gauss_legendre_rule<N, value_t>;
+
+        const value_t x1 = value_t(std::get<0>(bounds_0)), x2 = value_t(std::get<1>(bounds_0));
+        const value_t a = (x2 - x1) / 2, b = (x2 + x1) / 2;
+        value_t y[N];
+        auto node = [&](size_t i)
+        {
+            value_t v0 = a * rule.nodes[i] + b;
+            auto F1 = [&](auto v1) { return detail::apply_ordered<First, Second, bound_t>(f, v0, v1); };
+            y[i] = value_t(DiceForge::integrate(F1, evaluate(bounds_1, v0)));
+        };
+        detail::parallel_for(N, policy.threads, node);
+
+        value_t I{};
+        for (int i = 0; i < N; i++)
+            I += rule.weights[i] * y[i];
+        return bound_t(a * I);
+    }
+
+    namespace detail
+    {
+        // Genz-Malik degree 7 rule on a rectangle with its embedded degree 5 rule, the 17 points being the centre,
+        // 2 x 4 points on the axes at +-lambda_2 and +-lambda_3, and 2 x 4 on the diagonals at +-lambda_4 and +-lambda_5
+        // (all as fractions of the half widths)
+        constexpr long double genz_malik_lambda2 = 0.358568582800318091990645153907937L; // sqrt(9/70)
+        constexpr long double genz_malik_lambda3 = 0.948683298050513799599668063329816L; // sqrt(9/10)
+        constexpr long double genz_malik_lambda5 = 0.688247201611685297721628734293624L; // sqrt(9/19)
+        // weights of the degree 7 rule in two dimensions, for a unit volume
+        constexpr long double genz_malik_w7[5] = {-3816.0L / 19683, 980.0L / 6561, 1020.0L / 19683, 200.0L / 19683,
+                                                  6859.0L / 78732};
+        // and of the degree 5 rule, which has no lambda_5 points
+        constexpr long double genz_malik_w5[4] = {-971.0L / 729, 245.0L / 486, 65.0L / 1458, 25.0L / 729};
+
+        template <typename T>
+        struct cubature_region
+        {
+            T c[2], h[2];  // centre and half widths
+            T value, error;
+            int split;     // axis along which the integrand varies the most
+            bool operator<(const cubature_region& other) const { return error < other.error; }
+        };
+
+        // Genz-Malik estimate of the integral of g(u, v) over the rectangle, the error being |degree 7 - degree 5|
+        template <typename T, typename G>
+        cubature_region<T> genz_malik(G &g, T c0, T c1, T h0, T h1)
+        {
+            const T l2 = T(genz_malik_lambda2), l3 = T(genz_malik_lambda3), l4 = l3, l5 = T(genz_malik_lambda5);
+            const T f0 = g(c0, c1);
+
+            const T a2 = g(c0 + l2 * h0, c1), b2 = g(c0 - l2 * h0, c1);
+            const T a3 = g(c0 + l3 * h0, c1), b3 = g(c0 - l3 * h0, c1);
+            const T c2 = g(c0, c1 + l2 * h1), d2 = g(c0, c1 - l2 * h1);
+            const T c3 = g(c0, c1 + l3 * h1), d3 = g(c0, c1 - l3 * h1);
+            const T s4 = g(c0 + l4 * h0, c1 + l4 * h1) + g(c0 + l4 * h0, c1 - l4 * h1) +
+                         g(c0 - l4 * h0, c1 + l4 * h1) + g(c0 - l4 * h0, c1 - l4 * h1);
+            const T s5 = g(c0 + l5 * h0, c1 + l5 * h1) + g(c0 + l5 * h0, c1 - l5 * h1) +
+                         g(c0 - l5 * h0, c1 + l5 * h1) + g(c0 - l5 * h0, c1 - l5 * h1);
+            const T s2 = a2 + b2 + c2 + d2, s3 = a3 + b3 + c3 + d3;
+
+            // fourth differences along each axis (lambda_2^2 / lambda_3^2 = 1/7) pick the axis to split
+            const T diff0 = std::fabs(a2 + b2 - 2 * f0 - (a3 + b3 - 2 * f0) / 7);
+            const T diff1 = std::fabs(c2 + d2 - 2 * f0 - (c3 + d3 - 2 * f0) / 7);
+
+            const T volume = 4 * h0 * h1;
+            const T I7 = volume * (T(genz_malik_w7[0]) * f0 + T(genz_malik_w7[1]) * s2 + T(genz_malik_w7[2]) * s3 +
+                                   T(genz_malik_w7[3]) * s4 + T(genz_malik_w7[4]) * s5);
+            const T I5 = volume * (T(genz_malik_w5[0]) * f0 + T(genz_malik_w5[1]) * s2 + T(genz_malik_w5[2]) * s3 +
+                                   T(genz_malik_w5[3]) * s4);
+            return {{c0, c1}, {h0, h1}, I7, std::fabs(I7 - I5), diff1 > diff0 ? 1 : 0};
+        }
+    }
+
+    // Regions bisected per round of the adaptive cubature
+    constexpr size_t cubature_batch = 16;
+
+    /// @brief Adaptive Genz-Malik cubature of f over a two variable domain, to be used as
+    /// cubature(f, bounds_0, bounds_1, integration sequence), with the same bounds as the two variable integrate
+    /// @param f the function to be integrated f(x, y)
+    /// @param bounds_0 constant integration bounds of the outer variable as a tuple
+    /// @param bounds_1 integration bounds of the inner variable as a tuple of constants or functions of the outer one,
+    /// which makes domains such as triangles and discs possible
+    /// @param integration_sequence dx_dy or dy_dx (using DiceForge::dx_dy, DiceForge::dy_dx)
+    /// @param rel_tol requested error relative to the magnitude of the integral
+    /// @param abs_tol requested absolute error (the looser of the two is used)
+    /// @param max_evaluations evaluation budget, after which the best estimate so far is returned
+    /// @param policy threads to evaluate the regions with, serial by default (f and the bounds are called from all of
+    /// them at once otherwise)
+    /// @return The integral with its error estimate, the evaluations used and whether the tolerance was met
+    /// @note The inner variable is mapped linearly onto [0, 1] between its bounds, which turns the domain into a
+    /// rectangle. The regions are kept in a heap ordered by their error and every round bisects up to
+    /// cubature_batch of the worst ones along the axis where f varies the most, the new regions being evaluated in
+    /// parallel. The rounds do not depend on the number of threads, and neither does the result.
+    template <auto First, auto Second, typename FuncType,
+              typename Lower_0, typename Upper_0,
+              typename Lower_1, typename Upper_1,
+              typename T = std::conditional_t<std::is_floating_point_v<std::common_type_t<Lower_0, Upper_0>>,
+                                              std::common_type_t<Lower_0, Upper_0>, double>>
+    quadrature_result<T> cubature(FuncType &&f,
+                                  std::tuple<Lower_0, Upper_0> bounds_0,
+                                  std::tuple<Lower_1, Upper_1> bounds_1,
+                                  std::integer_sequence<int, First, Second> integration_sequence,
+                                  T rel_tol = T(1e-10), T abs_tol = T(1e-14), size_t max_evaluations = 1000000,
+                                  parallel_t policy = parallel_t{1})
+    {
+        using bound_t = std::common_type_t<Lower_0, Upper_0>;
+        constexpr size_t points = 17;
+
+        // f on the rectangle [x1, x2] x [0, 1], with the Jacobian of the inner variable's mapping
+        auto g = [&](T v0, T t)
+        {
+            auto [lower, upper] = evaluate(bounds_1, v0);
+            const T lo = T(lower), width = T(upper) - lo;
+            return T(detail::apply_ordered<First, Second, bound_t>(f, v0, lo + width * t)) * width;
+        };
+
+        const T x1 = T(std::get<0>(bounds_0)), x2 = T(std::get<1>(bounds_0));
+        std::vector<detail::cubature_region<T>> heap;
+        heap.push_back(detail::genz_malik<T>(g, (x1 + x2) / 2, T(0.5), (x2 - x1) / 2, T(0.5)));
+        T value = heap[0].value, error = heap[0].error;
+        size_t evaluations = points;
+
+        std::vector<detail::cubature_region<T>> children;
+        bool converged = false;
+        while (true)
+        {
+            if (error <= std::max(abs_tol, rel_tol * std::fabs(value)))
+            {
+                converged = true;
+                break;
+            }
+            const size_t batch = std::min({cubature_batch, heap.size(), (max_evaluations - std::min(max_evaluations, evaluations)) / (2 * points)});
+            if (batch == 0)
+                break;
+
+            // the halves of the worst regions, set up here and evaluated below
+            children.resize(2 * batch);
+            bool splittable = true;
+            for (size_t k = 0; k < batch; k++)
+            {
+                std::pop_heap(heap.begin(), heap.end());
+                detail::cubature_region<T> worst = heap.back();
+                heap.pop_back();
+                value -= worst.value;
+                error -= worst.error;
+
+                const int axis = worst.split;
+                const T h = worst.h[axis] / 2;
+                splittable = splittable && worst.c[axis] - h != worst.c[axis] && worst.c[axis] + h != worst.c[axis];
+                children[2 * k] = children[2 * k + 1] = worst;
+                children[2 * k].h[axis] = children[2 * k + 1].h[axis] = h;
+                children[2 * k].c[axis] -= h;
+                children[2 * k + 1].c[axis] += h;
+            }
+
+            auto job = [&](size_t k)
+            {
+                const detail::cubature_region<T>& r = children[k];
+                children[k] = detail::genz_malik<T>(g, r.c[0], r.c[1], r.h[0], r.h[1]);
+            };
+            detail::parallel_for(children.size(), policy.threads, job);
+            evaluations += points * children.size();
+
+            for (const detail::cubature_region<T>& child : children)
+            {
+                value += child.value;
+                error += child.error;
+                heap.push_back(child);
+                std::push_heap(heap.begin(), heap.end());
+            }
+            // the regions can not be split any further in this precision
+            if (!splittable)
+                break;
+        }
+
+        // the running sums drift, so the final totals are added up again
+        value = error = T(0);
+        for (const detail::cubature_region<T>& region : heap)
+        {
+            value += region.value;
+            error += region.error;
+        }
+        return {value, error, evaluations, converged};
+    }
 }
 
 #endif
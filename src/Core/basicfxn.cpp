@@ -1,138 +1,112 @@
 #include "basicfxn.h"
 #include <limits>
+#include <algorithm>
 
 namespace DiceForge
 {
     matrix_t::matrix_t(int r, int c)
-        : r(r), c(c)
+        : data(size_t(r) * c, 0), r(r), c(c)
     {
-        m = new real_t*[r];
-        for (size_t i = 0; i < r; i++)
-        {
-            m[i] = new real_t[c];
-            for (size_t j = 0; j < c; j++)
-            {
-                m[i][j] = 0;
-            }
-        }
     }
 
-    matrix_t::matrix_t(matrix_t& other)
-        : r(other.r), c(other.c)
+    matrix_t matrix_t::operator*(const matrix_t& other) const
     {
-        m = new real_t*[r];
-        for (size_t i = 0; i < r; i++)
+        matrix_t pdt = matrix_t(r, other.c);
+        for (int i = 0; i < r; i++)
         {
-            m[i] = new real_t[c];
-            for (size_t j = 0; j < c; j++)
+            real_t* out = pdt[i];
+            // i-k-j order, so that the inner loop runs along rows of both
+            for (int k = 0; k < c; k++)
             {
-                m[i][j] = other.m[i][j];
+                const real_t a = (*this)[i][k];
+                const real_t* row = other[k];
+                for (int j = 0; j < other.c; j++)
+                {
+                    out[j] += a * row[j];
+                }
             }
-        }
-    }
+        }            
 
-    matrix_t::matrix_t(const matrix_t& other)
-        : r(other.r), c(other.c)
-    {
-        m = new real_t*[r];
-        for (size_t i = 0; i < r; i++)
-        {
-            m[i] = new real_t[c];
-            for (size_t j = 0; j < c; j++)
-            {
-                m[i][j] = other.m[i][j];
-            }
-        }
+        return pdt;
     }
 
-    matrix_t::~matrix_t()
+    matrix_t matrix_t::operator+(const matrix_t& other) const
     {
-        for (size_t i = 0; i < r; i++)
-        {
-            delete[] m[i];
-        }
-        delete[] m;
+        matrix_t sum = *this;
+        sum += other;
+        return sum;
     }
 
-    const real_t* matrix_t::operator[](int i) const
+    matrix_t matrix_t::operator-(const matrix_t& other) const
     {
-        return m[i];
+        matrix_t diff = *this;
+        diff -= other;
+        return diff;
     }
 
-    real_t* matrix_t::operator[](int i)
+    matrix_t matrix_t::operator-() const
     {
-        return m[i];
+        matrix_t neg = *this;
+        neg *= -1;
+        return neg;
     }
-
-    matrix_t matrix_t::operator*(const matrix_t& other) const
+    
+    matrix_t matrix_t::transpose() const
     {
-        matrix_t pdt = matrix_t(r, other.c);
-        for (size_t i = 0; i < r; i++)
+        matrix_t t = matrix_t(c, r);
+        for (int i = 0; i < r; i++)
         {
-            for (size_t j = 0; j < other.c; j++)
+            for (int j = 0; j < c; j++)
             {
-                pdt[i][j] = 0;
-
-                for (size_t k = 0; k < c; k++)
-                {
-                    pdt[i][j] += m[i][k] * other.m[k][j];
-                }                    
+                t[j][i] = (*this)[i][j];
             }
-        }            
+        }
 
-        return pdt;
+        return t;
     }
 
-    matrix_t matrix_t::operator+(const matrix_t& other) const
+    matrix_t& matrix_t::operator+=(const matrix_t& other)
     {
-        matrix_t sum = matrix_t(r, c);
-        for (size_t i = 0; i < r; i++)
+        for (size_t i = 0; i < data.size(); i++)
         {
-            for (size_t j = 0; j < c; j++)
-            {
-                sum.m[i][j] = m[i][j] + other.m[j][i];
-            }
+            data[i] += other.data[i];
         }
-        return sum;
+        return *this;
     }
 
-    matrix_t matrix_t::operator-(const matrix_t& other) const
+    matrix_t& matrix_t::operator-=(const matrix_t& other)
     {
-        matrix_t diff = matrix_t(r, c);
-        for (size_t i = 0; i < r; i++)
+        for (size_t i = 0; i < data.size(); i++)
         {
-            for (size_t j = 0; j < c; j++)
-            {
-                diff.m[i][j] = m[i][j] - other.m[j][i];
-            }
+            data[i] -= other.data[i];
         }
-        return diff;
+        return *this;
     }
 
-    matrix_t matrix_t::operator-() const
+    matrix_t& matrix_t::operator*=(real_t k)
     {
-        matrix_t neg = matrix_t(r, c);
-        for (size_t i = 0; i < r; i++)
+        for (real_t& x : data)
         {
-            for (size_t j = 0; j < c; j++)
-            {
-                neg.m[i][j] = -m[i][j];
-            }
+            x *= k;
         }
-        return neg;
+        return *this;
     }
-    
-    matrix_t matrix_t::transpose() const
+
+    void multiply_transposed(const matrix_t& A, const matrix_t& B, matrix_t& out)
     {
-        matrix_t t = matrix_t(c, r);
-        for (size_t i = 0; i < r; i++)
+        std::fill(out.data.begin(), out.data.end(), 0);
+        for (int k = 0; k < A.r; k++)
         {
-            for (size_t j = 0; j < c; j++)
+            const real_t* a = A[k];
+            const real_t* b = B[k];
+            for (int i = 0; i < A.c; i++)
             {
-                t.m[j][i] = m[i][j];
+                real_t* row = out[i];
+                for (int j = 0; j < B.c; j++)
+                {
+                    row[j] += a[i] * b[j];
+                }
             }
         }
-
-        return t;
     }
 }
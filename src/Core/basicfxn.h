@@ -5,11 +5,14 @@
 #include <functional>
 #include <vector>
 #include <limits>
+#include <stdexcept>
 
 #define _USE_MATH_DEFINES
 #include <cmath>
 
 #include "types.h"
+#include "quadrature.h"
+#include "combinatorics.h"
 
 namespace DiceForge
 {
@@ -19,15 +22,16 @@ namespace DiceForge
     * and columns while performing binary operations on two matrices and 
     * you will not abuse this poor struct */
 
+    /* The elements are stored contiguously, row after row. Copies and moves are those of
+    * the std::vector, and the in-place operators and multiply_transposed() let a loop
+    * reuse its matrices instead of allocating new ones on every pass */
+
     struct matrix_t
     {
         matrix_t(int r, int c);
-        matrix_t(matrix_t& other);
-        matrix_t(const matrix_t& other);
-        ~matrix_t();
 
-        const real_t* operator[](int i) const;
-        real_t* operator[](int i);
+        const real_t* operator[](int i) const { return data.data() + size_t(i) * c; }
+        real_t* operator[](int i) { return data.data() + size_t(i) * c; }
 
         matrix_t operator*(const matrix_t& other) const;
         matrix_t operator+(const matrix_t& other) const;
@@ -35,29 +39,132 @@ namespace DiceForge
         matrix_t operator-() const;        
         matrix_t transpose() const;
 
-        real_t** m;
+        matrix_t& operator+=(const matrix_t& other);
+        matrix_t& operator-=(const matrix_t& other);
+        matrix_t& operator*=(real_t k);
+
+        std::vector<real_t> data;
 
-        const int r; // rows
-        const int c; // cols
+        int r; // rows
+        int c; // cols
     };
 
+    /* out = A^T * B, without forming the transpose (out has to be A.c x B.c) */
+    void multiply_transposed(const matrix_t& A, const matrix_t& B, matrix_t& out);
+
+    /* Small matrices of fixed size, kept on the stack */
+
+    template <int R, int C>
+    struct fixed_matrix_t
+    {
+        real_t m[R][C] = {};
+
+        const real_t* operator[](int i) const { return m[i]; }
+        real_t* operator[](int i) { return m[i]; }
+
+        template <int K>
+        fixed_matrix_t<R, K> operator*(const fixed_matrix_t<C, K>& other) const
+        {
+            fixed_matrix_t<R, K> pdt;
+            for (int i = 0; i < R; i++)
+                for (int j = 0; j < K; j++)
+                    for (int k = 0; k < C; k++)
+                        pdt.m[i][j] += m[i][k] * other.m[k][j];
+            return pdt;
+        }
+
+        fixed_matrix_t operator+(const fixed_matrix_t& other) const
+        {
+            fixed_matrix_t sum;
+            for (int i = 0; i < R; i++)
+                for (int j = 0; j < C; j++)
+                    sum.m[i][j] = m[i][j] + other.m[i][j];
+            return sum;
+        }
+
+        fixed_matrix_t operator-(const fixed_matrix_t& other) const
+        {
+            fixed_matrix_t diff;
+            for (int i = 0; i < R; i++)
+                for (int j = 0; j < C; j++)
+                    diff.m[i][j] = m[i][j] - other.m[i][j];
+            return diff;
+        }
+
+        fixed_matrix_t<C, R> transpose() const
+        {
+            fixed_matrix_t<C, R> t;
+            for (int i = 0; i < R; i++)
+                for (int j = 0; j < C; j++)
+                    t.m[j][i] = m[i][j];
+            return t;
+        }
+    };
+
+    typedef fixed_matrix_t<2, 2> matrix2_t;
+    typedef fixed_matrix_t<3, 3> matrix3_t;
+
+    /* J^T * J for a matrix J with C columns */
+    template <int C>
+    fixed_matrix_t<C, C> gram(const matrix_t& J)
+    {
+        fixed_matrix_t<C, C> g;
+        for (int i = 0; i < J.r; i++)
+        {
+            const real_t* row = J[i];
+            for (int a = 0; a < C; a++)
+                for (int b = a; b < C; b++)
+                    g.m[a][b] += row[a] * row[b];
+        }
+        for (int a = 0; a < C; a++)
+            for (int b = 0; b < a; b++)
+                g.m[a][b] = g.m[b][a];
+        return g;
+    }
+
+    /* J^T * R for a matrix J with C columns and a column vector R */
+    template <int C>
+    fixed_matrix_t<C, 1> transpose_times(const matrix_t& J, const matrix_t& R)
+    {
+        fixed_matrix_t<C, 1> v;
+        for (int i = 0; i < J.r; i++)
+        {
+            const real_t* row = J[i];
+            for (int a = 0; a < C; a++)
+                v.m[a][0] += row[a] * R[i][0];
+        }
+        return v;
+    }
+
+    /* Exact k-permutations and k-combinations of n, which throw std::overflow_error when the
+    * result does not fit (see combinatorics.h for their logarithms, which never overflow) */
+
     /* k-permutations of n */
     static inline uint_t nPr(uint_t n, uint_t r)
     {
+        if (r > n)
+            return 0;
+
         uint_t p = 1;
         for (uint_t i = n; i > n - r; i--)
+        {
+            if (p > std::numeric_limits<uint_t>::max() / i)
+                throw std::overflow_error("nPr(n, r) does not fit in 64 bits");
             p *= i;
+        }
 
         return p;
     }
 
     /* uint128_t returns a 128-bit value
-    * Moreover, this reduces the chance of overflow by applying division at each step
-    * instead of performing it once at the last. */
+    * Every step multiplies by (n - r + i) / i, with the common factors of the running product
+    * and i taken out first, so that only a result too large for 128 bits can overflow. */
 
     /* k-combinations of n */
     static inline uint128_t nCr(uint128_t n, uint128_t r)
     {
+        if (r > n)
+            return 0;
         if (r > n - r)
             r = n - r; // because C(n, r) == C(n, n - r)
 
@@ -66,51 +173,73 @@ namespace DiceForge
 
         for (i = 1; i <= r; i++)
         {
-            ans *= (uint128_t)(n - r + i);
-            ans /= i;
+            // ans * (n - r + i) is divisible by i, and i / gcd(ans, i) divides n - r + i
+            uint128_t g = ans, h = i;
+            while (h != 0)
+            {
+                uint128_t t = g % h;
+                g = h;
+                h = t;
+            }
+            uint128_t factor = (n - r + i) / (i / g);
+            if (ans / g > ~uint128_t(0) / factor)
+                throw std::overflow_error("nCr(n, r) does not fit in 128 bits");
+            ans = ans / g * factor;
         }
 
         return ans;
     }
 
     /* inverse of a 2x2 matrix */
-    static matrix_t inverse2x2(const matrix_t& M)
+    static inline matrix_t inverse2x2(const matrix_t& M)
     {
         real_t inv_det = 1 / (M[0][0] * M[1][1] - M[1][0] * M[0][1]);
         matrix_t inv = matrix_t(2, 2);
-        inv.m[0][0] = M.m[1][1] * inv_det;
-        inv.m[0][1] = -M.m[0][1] * inv_det;
-        inv.m[1][0] = -M.m[1][0] * inv_det;
-        inv.m[1][1] = M.m[0][0] * inv_det;
+        inv[0][0] = M[1][1] * inv_det;
+        inv[0][1] = -M[0][1] * inv_det;
+        inv[1][0] = -M[1][0] * inv_det;
+        inv[1][1] = M[0][0] * inv_det;
         
         return inv;
     }
+
+    /* inverse of a 2x2 matrix */
+    static inline matrix2_t inverse(const matrix2_t& M)
+    {
+        real_t inv_det = 1 / (M[0][0] * M[1][1] - M[1][0] * M[0][1]);
+        matrix2_t inv;
+        inv[0][0] = M[1][1] * inv_det;
+        inv[0][1] = -M[0][1] * inv_det;
+        inv[1][0] = -M[1][0] * inv_det;
+        inv[1][1] = M[0][0] * inv_det;
+        return inv;
+    }
+
+    /* inverse of a 3x3 matrix (adjugate over determinant) */
+    static inline matrix3_t inverse(const matrix3_t& M)
+    {
+        matrix3_t inv;
+        inv[0][0] = M[1][1] * M[2][2] - M[1][2] * M[2][1];
+        inv[0][1] = M[0][2] * M[2][1] - M[0][1] * M[2][2];
+        inv[0][2] = M[0][1] * M[1][2] - M[0][2] * M[1][1];
+        inv[1][0] = M[1][2] * M[2][0] - M[1][0] * M[2][2];
+        inv[1][1] = M[0][0] * M[2][2] - M[0][2] * M[2][0];
+        inv[1][2] = M[0][2] * M[1][0] - M[0][0] * M[1][2];
+        inv[2][0] = M[1][0] * M[2][1] - M[1][1] * M[2][0];
+        inv[2][1] = M[0][1] * M[2][0] - M[0][0] * M[2][1];
+        inv[2][2] = M[0][0] * M[1][1] - M[0][1] * M[1][0];
+        real_t inv_det = 1 / (M[0][0] * inv[0][0] + M[0][1] * inv[1][0] + M[0][2] * inv[2][0]);
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++)
+                inv[i][j] *= inv_det;
+        return inv;
+    }
     
-    static real_t simpson(std::function<real_t(real_t)> f, real_t a, real_t b, size_t partitions = 1000000)
+    /* integral of f over [a, b]; partitions is the evaluation budget of the adaptive Gauss-Kronrod
+    * integration (see quadrature.h) that replaced the fixed composite Simpson rule */
+    static inline real_t simpson(std::function<real_t(real_t)> f, real_t a, real_t b, size_t partitions = 1000000)
     {
-        /*
-        f = function we want to integrate
-        a = start point on x axis
-        b = end point on x axis
-        h = step size, taken as a millionth of the diff btw a and b
-        n = number of partitions, taken as a million here by default
-        area = numerical area approximation using simpson's 1/3rd rule
-        */
-        real_t h, area, sum1, sum2, sum3, n;
-        n = partitions;
-        h = (b - a) / n;
-        sum1 = f(a) + f(b);
-        sum2 = sum3 = 0;
-        for (int i = 1; i < n; i = i + 2)
-        {
-            sum2 += f(a + i * h);
-        }
-        for (int i = 2; i <= n; i = i + 2)
-        {
-            sum3 += f(a + i * h);
-        }
-        area = h * (sum1 + 4 * sum2 + 2 * sum3) / 3;
-        return area;
+        return integrate_adaptive<real_t>(f, a, b, 1e-12, 1e-15, std::max(partitions + 1, size_t(15))).value;
     }
 }
 
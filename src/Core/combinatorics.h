@@ -0,0 +1,72 @@
+#ifndef DF_COMBINATORICS_H
+#define DF_COMBINATORICS_H
+
+#include <cmath>
+
+#include "types.h"
+
+namespace DiceForge
+{
+    /* Factorials, binomial coefficients and permutations in log space, in O(1) and without overflow */
+
+    namespace detail
+    {
+        // log(n!) is looked up for n below this, and follows from Stirling's series above
+        constexpr uint64_t log_factorial_table_size = 256;
+        extern const real_t log_factorial_table[log_factorial_table_size];
+
+        // log(2 pi) / 2
+        constexpr real_t half_log_2pi = 0.918938533204672741780329736405618;
+
+        // Error of Stirling's formula, log(n!) - ((n + 1/2) log(n) - n + log(2 pi) / 2), for n >= 1. Beyond the
+        // table the series 1/(12n) - 1/(360n^3) + 1/(1260n^5) - 1/(1680n^7) is exact to double precision.
+        inline real_t stirling_error(uint64_t n)
+        {
+            const real_t x = real_t(n);
+            if (n < log_factorial_table_size)
+                return log_factorial_table[n] - ((x + 0.5) * std::log(x) - x + half_log_2pi);
+            const real_t r = 1 / x, r2 = r * r;
+            return r * (1.0 / 12 - r2 * (1.0 / 360 - r2 * (1.0 / 1260 - r2 * (1.0 / 1680))));
+        }
+    }
+
+    /// @brief Returns log(n!)
+    /// @note A table lookup for n < 256 and Stirling's series beyond, both to double precision
+    inline real_t log_factorial(uint64_t n)
+    {
+        if (n < detail::log_factorial_table_size)
+            return detail::log_factorial_table[n];
+        const real_t x = real_t(n);
+        return (x + 0.5) * std::log(x) - x + detail::half_log_2pi + detail::stirling_error(n);
+    }
+
+    /// @brief Returns the logarithm of the binomial coefficient C(n, r), -infinity for r > n
+    /// @note Large n are handled in the form k log(n/k) - (n-k) log1p(-k/n) + log(n / (k (n-k))) / 2 - log(2 pi) / 2
+    /// plus the Stirling errors of n, k and n - k (k = min(r, n - r)), which does not lose the small C(n, r) of a
+    /// large n to cancellation as the difference of the three log factorials would
+    inline real_t log_nCr(uint64_t n, uint64_t r)
+    {
+        if (r > n)
+            return -INFINITY;
+        if (r > n - r)
+            r = n - r; // because C(n, r) == C(n, n - r)
+        if (r == 0)
+            return 0;
+        if (n < detail::log_factorial_table_size)
+            return detail::log_factorial_table[n] - detail::log_factorial_table[r] - detail::log_factorial_table[n - r];
+
+        const real_t x = real_t(n), k = real_t(r), m = real_t(n - r);
+        return k * std::log(x / k) - m * std::log1p(-k / x) + 0.5 * std::log(x / (k * m)) - detail::half_log_2pi
+               + detail::stirling_error(n) - detail::stirling_error(r) - detail::stirling_error(n - r);
+    }
+
+    /// @brief Returns the logarithm of the number of r-permutations of n, n! / (n - r)!, -infinity for r > n
+    inline real_t log_nPr(uint64_t n, uint64_t r)
+    {
+        if (r > n)
+            return -INFINITY;
+        return log_nCr(n, r) + log_factorial(r);
+    }
+}
+
+#endif
@@ -0,0 +1,46 @@
+/***RUNTIME CPU DISPATCH***/
+/*with the CMake option DICEFORGE_DISPATCH, the files of SIMD kernels are also
+compiled for AVX2 with FMA, their functions going into a namespace avx2 (the
+value of DF_DISPATCH_VARIANT in that compilation), and the functions of the
+baseline compilation hand their work over to those when the CPU running them
+has both instruction sets*/
+
+#ifndef DF_DISPATCH_H
+#define DF_DISPATCH_H
+
+// A variant must not odr-use any inline function that the baseline uses too (standard algorithms included), since
+// the linker keeps one copy of each, maybe compiled for the wrong CPU: it calls the functions of simd.h, which
+// are in a namespace named after the instruction set, of its own file, in an unnamed namespace, or none at all.
+#if defined(DF_DISPATCH_VARIANT)
+#define DF_DISPATCH_BEGIN namespace DF_DISPATCH_VARIANT {
+#define DF_DISPATCH_END }
+#define DF_DISPATCH(call) ((void)0)
+#elif defined(DF_RUNTIME_DISPATCH) && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define DF_DISPATCH_BEGIN
+#define DF_DISPATCH_END
+// Returns the value of the AVX2 variant of the call when the CPU has AVX2 and FMA
+#define DF_DISPATCH(call) if (::DiceForge::detail::has_avx2()) return avx2::call
+#define DF_DISPATCH_AVX2
+
+namespace DiceForge
+{
+    namespace detail
+    {
+        // Whether the CPU running the program has AVX2 and FMA, found out once
+        inline bool has_avx2()
+        {
+            static const bool avx2 = []() {
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+            }();
+            return avx2;
+        }
+    }
+}
+#else
+#define DF_DISPATCH_BEGIN
+#define DF_DISPATCH_END
+#define DF_DISPATCH(call) ((void)0)
+#endif
+
+#endif
@@ -4,14 +4,33 @@
 #include <limits>
 #include <iostream>
 #include <vector>
+#include <cstddef>
+#include <stdexcept>
 
 #define _USE_MATH_DEFINES
 #include <cmath>
 
+#if __cplusplus >= 202002L && __has_include(<span>)
+#include <span>
+// Set when std::span overloads are available
+#define DF_SPAN
+#endif
+
 #include "types.h"
+#include "special.h"
 
 namespace DiceForge
 {    
+    namespace detail
+    {
+        // Quantile functions take probabilities in [0, 1]
+        inline void check_probability(real_t p)
+        {
+            if (!(p >= 0 && p <= 1))
+                throw std::invalid_argument("Expected a probability in [0, 1]!");
+        }
+    }
+
     /// @brief DiceForge::Continuous - A generic class for distributions describing continuous random variables
     class Continuous
     {
@@ -30,6 +49,116 @@ namespace DiceForge
         /// @brief Cumulative distribution function (cdf) of the distribution
         /// @param x location where the cdf is to be evaluated [P(X <= x)]
         virtual real_t cdf(real_t x) const = 0;
+        /// @brief Natural logarithm of the probability density function (pdf) of the distribution
+        /// @param x location where the log-pdf is to be evaluated
+        virtual real_t logpdf(real_t x) const
+        {
+            return log(pdf(x));
+        }
+        /// @brief Evaluates the pdf at n locations
+        /// @param x pointer to the first of the locations
+        /// @param out pointer to the first element of the buffer receiving pdf(x[i])
+        /// @param n number of locations
+        virtual void pdf(const real_t* x, real_t* out, size_t n) const
+        {
+            for (size_t i = 0; i < n; i++)
+                out[i] = pdf(x[i]);
+        }
+        /// @brief Evaluates the log-pdf at n locations (see pdf(const real_t*, real_t*, size_t))
+        virtual void logpdf(const real_t* x, real_t* out, size_t n) const
+        {
+            for (size_t i = 0; i < n; i++)
+                out[i] = logpdf(x[i]);
+        }
+        /// @brief Evaluates the cdf at n locations (see pdf(const real_t*, real_t*, size_t))
+        virtual void cdf(const real_t* x, real_t* out, size_t n) const
+        {
+            for (size_t i = 0; i < n; i++)
+                out[i] = cdf(x[i]);
+        }
+        /// @brief Quantile function (inverse of the cdf) of the distribution, the x with cdf(x) = p
+        /// @param p probability, in [0, 1] (std::invalid_argument otherwise)
+        /// @note minValue() for p = 0 and maxValue() for p = 1. By default cdf(x) = p is solved numerically: the
+        /// normal approximation expectation + sqrt(variance) z(p) is bracketed in steps doubling from the standard
+        /// deviation and the bracket closed by regula falsi (Illinois) to a few ulp. Closed forms override it.
+        virtual real_t quantile(real_t p) const
+        {
+            detail::check_probability(p);
+            const real_t lower = minValue(), upper = maxValue();
+            if (p == 0)
+                return lower;
+            if (p == 1)
+                return upper;
+            real_t scale = std::sqrt(variance()), x = expectation();
+            if (!(scale > 0 && scale < INFINITY))
+                scale = 1;
+            if (!std::isfinite(x))
+                x = 0;
+            x += scale * special::normal_quantile(p);
+            if (!(x > lower))
+                x = lower;
+            else if (!(x < upper))
+                x = upper;
+
+            // cdf(lo) < p <= cdf(hi)
+            real_t lo = x, hi = x, flo = cdf(x) - p, fhi = flo;
+            if (flo < 0)
+                for (real_t step = scale; fhi < 0 && hi < upper; step *= 2)
+                {
+                    lo = hi, flo = fhi;
+                    hi = (upper - lo > step) ? lo + step : upper;
+                    fhi = cdf(hi) - p;
+                }
+            else
+                for (real_t step = scale; flo >= 0 && lo > lower; step *= 2)
+                {
+                    hi = lo, fhi = flo;
+                    lo = (lo - lower > step) ? lo - step : lower;
+                    flo = cdf(lo) - p;
+                }
+            if (flo >= 0)
+                return lo;
+            if (fhi < 0)
+                return hi;
+
+            // Regula falsi, halving the value kept at the same end twice in a row
+            int side = 0;
+            for (int i = 0; i < 100; i++)
+            {
+                const real_t mid = lo + (hi - lo) / 2;
+                if (!(mid > lo && mid < hi) || hi - lo <= 4 * std::numeric_limits<real_t>::epsilon() * std::fabs(mid))
+                    break;
+                real_t t = lo - flo * ((hi - lo) / (fhi - flo));
+                if (!(t > lo && t < hi))
+                    t = mid;
+                const real_t ft = cdf(t) - p;
+                if (ft < 0)
+                {
+                    lo = t, flo = ft;
+                    if (side < 0)
+                        fhi /= 2;
+                    side = -1;
+                }
+                else
+                {
+                    hi = t, fhi = ft;
+                    if (side > 0)
+                        flo /= 2;
+                    side = 1;
+                }
+            }
+            const real_t mid = lo + (hi - lo) / 2;
+            return (mid > lo && mid < hi) ? mid : hi;
+        }
+        /// @brief Evaluates the quantile function at n probabilities (out may be p)
+        /// @param p pointer to the first of the probabilities
+        /// @param out pointer to the first element of the buffer receiving quantile(p[i])
+        /// @param n number of probabilities
+        virtual void quantile(const real_t* p, real_t* out, size_t n) const
+        {
+            for (size_t i = 0; i < n; i++)
+                out[i] = quantile(p[i]);
+        }
     };
 
     /// @brief DiceForge::Discrete - A generic class for distributions describing discrete random variables
@@ -50,6 +179,90 @@ namespace DiceForge
         /// @brief Cumulative distribution function (cdf) of the distribution
         /// @param x location where the cdf is to be evaluated [P(X <= x)]
         virtual real_t cdf(int_t x) const = 0;
+        /// @brief Natural logarithm of the probability mass function (pmf) of the distribution
+        /// @param x location where the log-pmf is to be evaluated
+        virtual real_t logpmf(int_t x) const
+        {
+            return log(pmf(x));
+        }
+        /// @brief Evaluates the pmf at n locations
+        /// @param x pointer to the first of the locations
+        /// @param out pointer to the first element of the buffer receiving pmf(x[i])
+        /// @param n number of locations
+        virtual void pmf(const int_t* x, real_t* out, size_t n) const
+        {
+            for (size_t i = 0; i < n; i++)
+                out[i] = pmf(x[i]);
+        }
+        /// @brief Evaluates the log-pmf at n locations (see pmf(const int_t*, real_t*, size_t))
+        virtual void logpmf(const int_t* x, real_t* out, size_t n) const
+        {
+            for (size_t i = 0; i < n; i++)
+                out[i] = logpmf(x[i]);
+        }
+        /// @brief Evaluates the cdf at n locations (see pmf(const int_t*, real_t*, size_t))
+        virtual void cdf(const int_t* x, real_t* out, size_t n) const
+        {
+            for (size_t i = 0; i < n; i++)
+                out[i] = cdf(x[i]);
+        }
+        /// @brief Quantile function (generalised inverse of the cdf) of the distribution, the smallest x with cdf(x) >= p
+        /// @param p probability, in [0, 1] (std::invalid_argument otherwise)
+        /// @note By default the normal approximation expectation + sqrt(variance) z(p) is bracketed in steps
+        /// doubling from 1, and the bracket closed by binary search on the cdf, with O(log) cdf evaluations
+        virtual int_t quantile(real_t p) const
+        {
+            detail::check_probability(p);
+            const int_t lower = minValue(), upper = maxValue();
+            const real_t guess = expectation() + std::sqrt(variance()) * special::normal_quantile(p);
+            int_t k;
+            if (!(guess > real_t(lower)))
+                k = lower;
+            else if (!(guess < real_t(upper)))
+                k = upper;
+            else
+                k = int_t(std::floor(guess));
+
+            // cdf(lo) < p <= cdf(hi), with the distances in unsigned arithmetic as the support may span all of int_t
+            int_t lo, hi;
+            uint64_t step = 1;
+            if (cdf(k) >= p)
+                for (hi = k;; hi = lo, step *= 2)
+                {
+                    if (hi == lower)
+                        return lower;
+                    lo = (uint64_t(hi) - uint64_t(lower) > step) ? int_t(uint64_t(hi) - step) : lower;
+                    if (cdf(lo) < p)
+                        break;
+                }
+            else
+                for (lo = k;; lo = hi, step *= 2)
+                {
+                    if (lo == upper)
+                        return upper;
+                    hi = (uint64_t(upper) - uint64_t(lo) > step) ? int_t(uint64_t(lo) + step) : upper;
+                    if (cdf(hi) >= p)
+                        break;
+                }
+            while (uint64_t(hi) - uint64_t(lo) > 1)
+            {
+                const int_t mid = int_t(uint64_t(lo) + (uint64_t(hi) - uint64_t(lo)) / 2);
+                if (cdf(mid) >= p)
+                    hi = mid;
+                else
+                    lo = mid;
+            }
+            return hi;
+        }
+        /// @brief Evaluates the quantile function at n probabilities
+        /// @param p pointer to the first of the probabilities
+        /// @param out pointer to the first element of the buffer receiving quantile(p[i])
+        /// @param n number of probabilities
+        virtual void quantile(const real_t* p, int_t* out, size_t n) const
+        {
+            for (size_t i = 0; i < n; i++)
+                out[i] = quantile(p[i]);
+        }
     };
 }
 
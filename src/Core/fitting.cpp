@@ -0,0 +1,73 @@
+#include "fitting.h"
+
+namespace DiceForge
+{
+    namespace fitting
+    {
+        Workers::Workers(int count)
+        {
+            if (count <= 0)
+                count = std::max(1, int(std::thread::hardware_concurrency()));
+            for (int i = 1; i < count; i++)
+                threads.emplace_back(&Workers::work, this);
+        }
+
+        Workers::~Workers()
+        {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                stop = true;
+            }
+            wake.notify_all();
+            for (std::thread& t : threads)
+                t.join();
+        }
+
+        void Workers::run(size_t count, const std::function<void(size_t)>& task)
+        {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                job = &task;
+                jobs = count;
+                next = 0;
+                busy = int(threads.size());
+                generation++;
+            }
+            wake.notify_all();
+
+            // the caller takes chunks as well
+            for (size_t i = next++; i < count; i = next++)
+                task(i);
+
+            std::unique_lock<std::mutex> guard(lock);
+            done.wait(guard, [this] { return busy == 0; });
+            job = nullptr;
+        }
+
+        void Workers::work()
+        {
+            unsigned long seen = 0;
+            while (true)
+            {
+                const std::function<void(size_t)>* task;
+                size_t count;
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    wake.wait(guard, [&] { return stop || generation != seen; });
+                    if (stop)
+                        return;
+                    seen = generation;
+                    task = job;
+                    count = jobs;
+                }
+
+                for (size_t i = next++; i < count; i = next++)
+                    (*task)(i);
+
+                std::lock_guard<std::mutex> guard(lock);
+                if (--busy == 0)
+                    done.notify_one();
+            }
+        }
+    }
+}
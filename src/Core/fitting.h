@@ -0,0 +1,279 @@
+#ifndef DF_FITTING_H
+#define DF_FITTING_H
+
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "types.h"
+#include "basicfxn.h"
+#include "simd.h"
+
+namespace DiceForge
+{
+    /* Shared non-linear least squares core for the fitTo* functions */
+
+    /* The model is a callable V model(V x, const real_t* theta, V* grad) returning f(x; theta) and
+    * writing the P partial derivatives df/dtheta into grad, for V = real_t and (when DF_SIMD_REAL is
+    * defined) V = simd::vreal, i.e. a generic lambda written with simd::exp, simd::log and simd::select.
+    * It should return NaN for parameters outside its domain (e.g. a non-positive scale), which rejects
+    * the step. */
+
+    namespace fitting
+    {
+        // Points per chunk of a data pass: every chunk is summed on its own and the chunk sums are added
+        // in order, so the result does not depend on the number of threads
+        constexpr size_t chunk_size = 8192;
+        // Passes over fewer points than this stay on the calling thread
+        constexpr size_t parallel_threshold = 65536;
+
+        /// @brief A fixed set of threads that run the chunks of a data pass together with the caller
+        class Workers
+        {
+        public:
+            /// @param threads total number of threads including the caller, 0 for std::thread::hardware_concurrency
+            explicit Workers(int threads = 0);
+            ~Workers();
+
+            Workers(const Workers&) = delete;
+            Workers& operator=(const Workers&) = delete;
+
+            /// @brief Calls job(i) for every i < jobs, spread over the threads, and returns once all are done
+            void run(size_t jobs, const std::function<void(size_t)>& job);
+
+            int size() const { return int(threads.size()) + 1; }
+
+        private:
+            void work();
+
+            std::vector<std::thread> threads;
+            std::mutex lock;
+            std::condition_variable wake, done;
+            const std::function<void(size_t)>* job = nullptr;
+            size_t jobs = 0;
+            std::atomic<size_t> next{0};
+            int busy = 0;
+            unsigned long generation = 0;
+            bool stop = false;
+        };
+
+        /* Sums of one chunk: squared residuals and the normal equations */
+        template <int P>
+        struct Partial
+        {
+            real_t sse;
+            fixed_matrix_t<P, P> A;
+            fixed_matrix_t<P, 1> g;
+        };
+
+        /* Accumulates the points [begin, end) into an (upper triangular) partial sum, the model being
+        * evaluated over whole SIMD lanes where possible */
+        template <int P, typename Model>
+        void accumulate_chunk(Model& model, const real_t* x, const real_t* y, size_t begin, size_t end,
+                              const real_t* theta, Partial<P>& out)
+        {
+            out.sse = 0;
+            out.A = fixed_matrix_t<P, P>();
+            out.g = fixed_matrix_t<P, 1>();
+            size_t i = begin;
+#if defined(DF_SIMD_REAL)
+            typedef simd::vreal V;
+            V sse(0.0), grad[P], g[P], A[P][P];
+            for (int a = 0; a < P; a++)
+            {
+                g[a] = V(0.0);
+                for (int b = a; b < P; b++)
+                    A[a][b] = V(0.0);
+            }
+            for (; i + V::width <= end; i += V::width)
+            {
+                V r = V::load(y + i) - model(V::load(x + i), theta, grad);
+                sse += r * r;
+                for (int a = 0; a < P; a++)
+                {
+                    g[a] += grad[a] * r;
+                    for (int b = a; b < P; b++)
+                        A[a][b] += grad[a] * grad[b];
+                }
+            }
+            out.sse = simd::sum(sse);
+            for (int a = 0; a < P; a++)
+            {
+                out.g.m[a][0] = simd::sum(g[a]);
+                for (int b = a; b < P; b++)
+                    out.A.m[a][b] = simd::sum(A[a][b]);
+            }
+#endif
+            real_t grad1[P];
+            for (; i < end; i++)
+            {
+                real_t r = y[i] - model(x[i], theta, grad1);
+                out.sse += r * r;
+                for (int a = 0; a < P; a++)
+                {
+                    out.g.m[a][0] += grad1[a] * r;
+                    for (int b = a; b < P; b++)
+                        out.A.m[a][b] += grad1[a] * grad1[b];
+                }
+            }
+        }
+
+        /* One pass over the data: sum of squared residuals r_i = y_i - f(x_i), together with
+        * the normal equations A = G^T G and g = G^T r of the gradient rows G, without storing G.
+        * parts has one entry per chunk, workers may be null to stay on the calling thread. */
+        template <int P, typename Model>
+        real_t accumulate(Model& model, const real_t* x, const real_t* y, size_t n, const real_t* theta,
+                          fixed_matrix_t<P, P>& A, fixed_matrix_t<P, 1>& g,
+                          std::vector<Partial<P>>& parts, Workers* workers)
+        {
+            auto job = [&](size_t c)
+            {
+                accumulate_chunk<P>(model, x, y, c * chunk_size, std::min(n, (c + 1) * chunk_size), theta, parts[c]);
+            };
+            if (workers)
+                workers->run(parts.size(), job);
+            else
+                for (size_t c = 0; c < parts.size(); c++)
+                    job(c);
+
+            A = fixed_matrix_t<P, P>();
+            g = fixed_matrix_t<P, 1>();
+            real_t sse = 0;
+            for (const Partial<P>& part : parts)
+            {
+                sse += part.sse;
+                for (int a = 0; a < P; a++)
+                {
+                    g.m[a][0] += part.g.m[a][0];
+                    for (int b = a; b < P; b++)
+                        A.m[a][b] += part.A.m[a][b];
+                }
+            }
+            for (int a = 0; a < P; a++)
+                for (int b = 0; b < a; b++)
+                    A.m[a][b] = A.m[b][a];
+            return sse;
+        }
+
+        /* Solves M d = v by Cholesky decomposition, false if M is not positive definite */
+        template <int P>
+        bool cholesky_solve(fixed_matrix_t<P, P> M, const fixed_matrix_t<P, 1>& v, real_t* d)
+        {
+            for (int j = 0; j < P; j++)
+            {
+                real_t s = M.m[j][j];
+                for (int k = 0; k < j; k++)
+                    s -= M.m[j][k] * M.m[j][k];
+                if (!(s > 0))
+                    return false;
+                M.m[j][j] = sqrt(s);
+                for (int i = j + 1; i < P; i++)
+                {
+                    real_t t = M.m[i][j];
+                    for (int k = 0; k < j; k++)
+                        t -= M.m[i][k] * M.m[j][k];
+                    M.m[i][j] = t / M.m[j][j];
+                }
+            }
+            for (int i = 0; i < P; i++)
+            {
+                real_t t = v.m[i][0];
+                for (int k = 0; k < i; k++)
+                    t -= M.m[i][k] * d[k];
+                d[i] = t / M.m[i][i];
+            }
+            for (int i = P - 1; i >= 0; i--)
+            {
+                real_t t = d[i];
+                for (int k = i + 1; k < P; k++)
+                    t -= M.m[k][i] * d[k];
+                d[i] = t / M.m[i][i];
+            }
+            return true;
+        }
+    }
+
+    /// @brief Levenberg-Marquardt minimisation of sum (y_i - f(x_i; theta))^2 over the P parameters theta
+    /// @param model callable evaluating f and its gradient, see above
+    /// @param x, y the n data points
+    /// @param theta initial guess on entry, best parameters found on return
+    /// @param max_iter maximum number of iterations (each is one pass over the data)
+    /// @param epsilon the fit has converged once an accepted step moves no parameter by more than epsilon
+    /// @param threads threads for the data passes, 0 for all hardware threads (passes over fewer than
+    /// fitting::parallel_threshold points always run on the calling thread)
+    /// @return true if the fit converged within max_iter iterations
+    /// @note Only the P x P normal equations are kept, so the memory used does not grow with n. A step is
+    /// taken only if it lowers the sum of squared residuals; the damping lambda * diag(G^T G) moves between
+    /// gradient descent (rejected steps) and Gauss-Newton (accepted steps). The result is the same for any
+    /// number of threads.
+    template <int P, typename Model>
+    bool levenberg_marquardt(Model model, const real_t* x, const real_t* y, size_t n, real_t* theta,
+                             int max_iter, real_t epsilon, int threads = 0)
+    {
+        std::vector<fitting::Partial<P>> parts((n + fitting::chunk_size - 1) / fitting::chunk_size);
+        std::unique_ptr<fitting::Workers> workers;
+        if (n >= fitting::parallel_threshold && threads != 1)
+        {
+            workers.reset(new fitting::Workers(threads));
+            if (workers->size() == 1)
+                workers.reset();
+        }
+
+        fixed_matrix_t<P, P> A, A_trial, M;
+        fixed_matrix_t<P, 1> g, g_trial;
+        real_t trial[P], d[P];
+        real_t lambda = 1e-3;
+
+        real_t sse = fitting::accumulate<P>(model, x, y, n, theta, A, g, parts, workers.get());
+        if (!std::isfinite(sse))
+            return false;
+
+        for (int iter = 0; iter < max_iter; iter++)
+        {
+            M = A;
+            for (int a = 0; a < P; a++)
+                M.m[a][a] += lambda * (A.m[a][a] > 0 ? A.m[a][a] : 1);
+
+            real_t sse_trial = INFINITY;
+            if (fitting::cholesky_solve<P>(M, g, d))
+            {
+                for (int a = 0; a < P; a++)
+                    trial[a] = theta[a] + d[a];
+                sse_trial = fitting::accumulate<P>(model, x, y, n, trial, A_trial, g_trial, parts, workers.get());
+            }
+
+            if (sse_trial <= sse)
+            {
+                bool small = true;
+                for (int a = 0; a < P; a++)
+                {
+                    small = small && fabs(d[a]) < epsilon;
+                    theta[a] = trial[a];
+                }
+                A = A_trial;
+                g = g_trial;
+                sse = sse_trial;
+                lambda = fmax(lambda * 0.1, 1e-12);
+                if (small)
+                    return true;
+            }
+            else
+            {
+                // no step along any direction lowers the error any more
+                lambda *= 10;
+                if (lambda > 1e16)
+                    return true;
+            }
+        }
+        return false;
+    }
+}
+
+#endif
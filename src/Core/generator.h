@@ -5,45 +5,233 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <thread>
+#include <iterator>
+#include <unordered_set>
+#include <initializer_list>
 
 #define _USE_MATH_DEFINES
 #include <cmath>
 
 #include "types.h"
+#include "state.h"
+#include "instrument.h"
 
 namespace DiceForge
 {
-    /// @brief DiceForge::Generator<T> - A generic class for RNGs
+    namespace detail
+    {
+        /// @brief Returns 64 random bits, from one or more outputs of the RNG
+        template <typename Engine>
+        uint64_t bits64(Engine& rng)
+        {
+            typedef decltype(rng.next()) word_t;
+            if constexpr (sizeof(word_t) >= sizeof(uint64_t))
+                return uint64_t(rng.next());
+            else {
+                uint64_t x = 0;
+                for (size_t b = 0; b < 64; b += 8 * sizeof(word_t))
+                    x = (x << (8 * sizeof(word_t))) | uint64_t(rng.next());
+                return x;
+            }
+        }
+
+        /// @brief Returns a random index in [0, n), n > 0, using as many outputs of the RNG as needed
+        /// when n exceeds its range
+        template <typename Engine>
+        uint64_t uniform_index(Engine& rng, uint64_t n)
+        {
+            typedef decltype(rng.next()) word_t;
+            if (n - 1 <= uint64_t(std::numeric_limits<word_t>::max()))
+                return uint64_t(rng.next_in_range(0, word_t(n - 1)));
+            if constexpr (sizeof(word_t) < sizeof(uint64_t)) {
+                // Multiply-shift (as in next_in_range) on 64-bit words made of several outputs
+                uint128_t m = uint128_t(bits64(rng)) * n;
+                if (uint64_t(m) < n) {
+                    const uint64_t threshold = (0 - n) % n;
+                    while (uint64_t(m) < threshold) {
+                        DF_INSTRUMENT_METHOD_REJECT("uniform_index");
+                        m = uint128_t(bits64(rng)) * n;
+                    }
+                }
+                return uint64_t(m >> 64);
+            }
+            return 0;
+        }
+
+        /// @brief Merges the shuffled ranges [first, mid) and [mid, last) into a shuffled [first, last)
+        /// @note Picks the next element from either range by a coin flip until one runs out, then inserts
+        /// the rest at random positions (MergeShuffle, Bacher et al.)
+        template <typename RandomAccessIterator, typename Engine>
+        void merge_shuffled(RandomAccessIterator first, RandomAccessIterator mid, RandomAccessIterator last, Engine& rng)
+        {
+            typedef decltype(rng.next()) word_t;
+            word_t coins = 0;
+            size_t left = 0;
+            auto i = first, j = mid;
+            for (;; ++i) {
+                if (left == 0) {
+                    coins = rng.next();
+                    left = 8 * sizeof(word_t);
+                }
+                bool second = coins & 1;
+                coins >>= 1;
+                left--;
+                if (second) {
+                    if (j == last)
+                        break;
+                    std::iter_swap(i, j);
+                    ++j;
+                }
+                else if (i == j)
+                    break;
+            }
+            for (; i != last; ++i)
+                std::iter_swap(i, first + uniform_index(rng, uint64_t(i - first) + 1));
+        }
+
+        // Smallest number of elements per thread worth shuffling in parallel
+        constexpr size_t parallel_shuffle_block = size_t(1) << 16;
+
+        // Longest jump asked of an RNG that discards the integers one by one (a second or so for MT32)
+        constexpr uint64_t slow_jump_limit = uint64_t(1) << 30;
+        // Engines that tell whether they jump fast (those derived from DiceForge::Generator)
+        template <typename Engine, typename = void>
+        struct reports_jump : std::false_type {};
+        template <typename Engine>
+        struct reports_jump<Engine, std::void_t<decltype(std::declval<const Engine&>().has_fast_jump())>>
+            : std::true_type {};
+        // Throws std::invalid_argument when the engine would discard more than slow_jump_limit integers to jump by
+        // steps; engines that do not tell are assumed to jump fast
+        template <typename Engine>
+        void check_jump(const Engine& engine, uint128_t steps)
+        {
+            if constexpr (reports_jump<Engine>::value) {
+                if (steps > slow_jump_limit && !engine.has_fast_jump())
+                    throw std::invalid_argument("This RNG has no fast jump, so its streams must start at most 2^30 "
+                                                "integers apart");
+            }
+        }
+    }
+
+    /// @brief Advances x by the golden gamma and returns the next output of SplitMix64 (Steele, Lea and Flood)
+    /// @note Every output is a bijection of x, so distinct seeds never give the same first output
+    inline uint64_t splitmix64(uint64_t& x)
+    {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    /// @brief DiceForge::SeedSequence - Expands seed material of any length into the words of the state of an RNG
+    /// @note The material is folded into one 64-bit key, and word i of the expansion is output i of SplitMix64
+    /// started at the key, so a sequence made of a single seed s gives the outputs of SplitMix64 seeded with s.
+    /// Every RNG of DiceForge fills its whole state from a SeedSequence (reset_seed(seed) uses SeedSequence(seed)),
+    /// so that any seed, 0 included, gives a well mixed state without a warm-up.
+    class SeedSequence
+    {
+    private:
+        uint64_t key = 0;
+    public:
+        /// @brief The sequence of a single seed
+        explicit SeedSequence(uint64_t seed) : key(seed) {}
+        /// @brief The sequence of the given words of seed material
+        SeedSequence(std::initializer_list<uint64_t> material) : SeedSequence(material.begin(), material.end()) {}
+        /// @brief The sequence of the seed material in [first, last), converted to 64-bit words
+        template <typename InputIterator>
+        SeedSequence(InputIterator first, InputIterator last)
+        {
+            // key = m_0, then key = splitmix64(key) ^ m_j, a bijection of every word given the ones before it
+            for (bool start = true; first != last; ++first, start = false)
+                key = (start ? 0 : splitmix64(key)) ^ uint64_t(*first);
+        }
+        /// @brief Returns word i of the expansion
+        uint64_t word(size_t i) const
+        {
+            uint64_t x = key + uint64_t(i) * 0x9E3779B97F4A7C15ULL;
+            return splitmix64(x);
+        }
+        /// @brief Fills the buffer with the first n words of the expansion, cut into pieces of U
+        /// @note Words are cut as by StaticGenerator::fill_fixed, the high piece first
+        template <typename U>
+        void generate(U* out, size_t n) const
+        {
+            static_assert(std::is_unsigned<U>::value && sizeof(U) <= sizeof(uint64_t), "Expected an unsigned word");
+            constexpr size_t pieces = sizeof(uint64_t) / sizeof(U);
+            uint64_t x = key, w = 0;
+            for (size_t i = 0; i < n; i++) {
+                if (i % pieces == 0)
+                    w = splitmix64(x);
+                out[i] = U(w >> (8 * sizeof(U) * (pieces - 1 - i % pieces)));
+            }
+        }
+    };
+
+    /// @brief DiceForge::StaticGenerator<Derived, T> - The interface shared by every RNG, resolved at compile time (CRTP)
+    /// @tparam Derived class providing generate() and generate_block(T*, size_t)
     /// @tparam T datatype of random number generated (RNG implementation specific)
-    /// @note Every RNG implemented in DiceForge is derived from this base class.
-    /// @note For writing your own RNG it is advisable to use this as the base class for compatibility with other features.
-    template <typename T>
-    class Generator
+    /// @note Generator<T> builds on this class with virtual generate() for runtime choice of RNG, while
+    /// StaticView<Engine> builds on it with direct calls into a concrete RNG, so that hot loops can be inlined.
+    template <typename Derived, typename T>
+    class StaticGenerator
     {
     public:
+        /// @brief Datatype of the random integers generated by the RNG
+        typedef T result_type;
+
         /// @brief Returns a random integer generated by the RNG
         /// @returns An unsigned integer (usually 32 or 64 bit)
         T next()
         {
-            return generate();
+            return draw();
         };
         /// @brief Returns a random real between 0 and 1
-        /// @returns An floating-point real number (64 bit)
+        /// @returns An floating-point real number (64 bit) in [0, 1)
+        /// @note Built from the top 53 bits of a 64-bit integer (all 32 bits of a 32-bit one), with no division or retries
         real_t next_unit()
         {
-            real_t x = 1.0;
-            while (x == 1.0) {
-                x = generate() / real_t(std::numeric_limits<T>().max());
-            }
-            return x;
+            return to_unit(draw());
+        }
+        /// @brief Returns a random single precision real between 0 and 1
+        /// @returns A floating-point real number (32 bit) in [0, 1)
+        /// @note Built from the top 24 bits of one random integer (filled out from more of them for RNGs narrower
+        /// than 24 bits), the full mantissa of a float, so it is never rounded up to 1
+        float next_unit_float()
+        {
+            if constexpr (sizeof(T) * 8 >= 24)
+                return float(draw() >> (sizeof(T) * 8 - 24)) * (1.0f / 16777216.0f);
+            else
+                return float(detail::bits64(derived()) >> 40) * (1.0f / 16777216.0f);
         }
         /// @brief Returns a random integer in the specified range
         /// @param min minimum value of the random number (inclusive)
         /// @param max maximum value of the random number (inclusive)
         /// @returns An signed integer (64 bit)
+        /// @note Unbiased, using Lemire's multiply-shift method (integer arithmetic only, rarely retries)
         int64_t next_in_range(T min, T max)
         {
-            return (int64_t)floor(next_unit() * (max - min + 1)) + min;
+            typedef typename std::conditional<sizeof(T) <= 4, uint64_t, uint128_t>::type wide_t;
+            DF_INSTRUMENT_METHOD("next_in_range", 1);
+            const T range = T(max - min + 1);
+            // The whole range of T
+            if (range == 0)
+                return (int64_t)(T)(draw() + min);
+            wide_t m = wide_t(draw()) * range;
+            T low = T(m);
+            if (low < range) {
+                // Reject the values that would make low multiples of the range more likely
+                const T threshold = T(0 - range) % range;
+                while (low < threshold) {
+                    DF_INSTRUMENT_METHOD_REJECT("next_in_range");
+                    m = wide_t(draw()) * range;
+                    low = T(m);
+                }
+            }
+            return (int64_t)(T)(T(m >> (8 * sizeof(T))) + min);
         };
         /// @brief Returns a random real number in the specified range
         /// @param min minimum value of the random number
@@ -51,19 +239,98 @@ namespace DiceForge
         /// @returns An signed floating-point real number (64 bit)
         real_t next_in_crange(real_t min, real_t max)
         {
-            real_t x = (real_t)max;
+            DF_INSTRUMENT_METHOD("next_in_crange", 1);
+            real_t x = (max - min) * next_unit() + min;
+            // Rounding can reach max, which is excluded
             while (x == max) {
+                DF_INSTRUMENT_METHOD_REJECT("next_in_crange");
                 x = (max - min) * next_unit() + min;
             }
             return x;
         };
-        /// @brief Re-initializes the RNG with specified seed
-        /// @param seed seed provided for initialization
-        void reset_seed(T seed)
+        /// @brief Fills the buffer with random integers generated by the RNG
+        /// @param out Pointer to the first element of the buffer
+        /// @param n Number of random integers to be written
+        /// @note Equivalent to n calls of next(), but costs a single (virtual) call for the whole block
+        void fill(T* out, size_t n)
         {
-            reseed(seed);
+            draw_block(out, n);
+        }
+        /// @brief Fills the buffer with random reals between 0 and 1
+        /// @param out Pointer to the first element of the buffer
+        /// @param n Number of random reals to be written
+        void fill_unit(real_t* out, size_t n)
+        {
+            T block[block_size];
+            while (n > 0) {
+                size_t m = std::min(n, block_size);
+                draw_block(block, m);
+                for (size_t i = 0; i < m; i++) {
+                    out[i] = to_unit(block[i]);
+                }
+                out += m;
+                n -= m;
+            }
+        }
+        /// @brief Fills the buffer with random single precision reals between 0 and 1
+        /// @param out Pointer to the first element of the buffer
+        /// @param n Number of random reals to be written
+        /// @note Each one takes 32 random bits (see fill_fixed), of which the top 24 make the mantissa, so a 64-bit
+        /// RNG fills two floats per integer
+        void fill_unit(float* out, size_t n)
+        {
+            uint32_t block[block_size];
+            while (n > 0) {
+                size_t m = std::min(n, block_size);
+                fill_fixed(block, m);
+                for (size_t i = 0; i < m; i++) {
+                    out[i] = float(block[i] >> 8) * (1.0f / 16777216.0f);
+                }
+                out += m;
+                n -= m;
+            }
+        }
+        /// @brief Fills the buffer with random fixed-point fractions, all of whose bits follow the binary point
+        /// (x / 2^bits is uniform in [0, 1)), e.g. 0.16 fixed-point values for U = uint16_t
+        /// @tparam U an unsigned integer type
+        /// @param out Pointer to the first element of the buffer
+        /// @param n Number of random fractions to be written
+        /// @note Integers wider than U are cut into sizeof(T) / sizeof(U) pieces, the high one first, and narrower
+        /// ones are joined, so that no random bits are wasted except for the unused pieces of the last integer
+        template <typename U>
+        void fill_fixed(U* out, size_t n)
+        {
+            static_assert(std::is_unsigned<U>::value, "Fixed-point fractions are unsigned integers");
+            T block[block_size];
+            if constexpr (sizeof(U) <= sizeof(T)) {
+                constexpr size_t pieces = sizeof(T) / sizeof(U);
+                while (n > 0) {
+                    size_t words = std::min(block_size, (n + pieces - 1) / pieces);
+                    size_t m = std::min(n, words * pieces);
+                    draw_block(block, words);
+                    for (size_t i = 0; i < m; i++) {
+                        out[i] = U(block[i / pieces] >> (8 * sizeof(U) * (pieces - 1 - i % pieces)));
+                    }
+                    out += m;
+                    n -= m;
+                }
+            }
+            else {
+                constexpr size_t words = sizeof(U) / sizeof(T);
+                while (n > 0) {
+                    size_t m = std::min(n, block_size / words);
+                    draw_block(block, m * words);
+                    for (size_t i = 0; i < m; i++) {
+                        U x = 0;
+                        for (size_t j = 0; j < words; j++)
+                            x = U(x << (8 * sizeof(T))) | U(block[i * words + j]);
+                        out[i] = x;
+                    }
+                    out += m;
+                    n -= m;
+                }
+            }
         }
-        
         /// @brief Returns a uniformly chosen random element from the sequence
         /// @param first Iterator of first element (like .begin() of vectors)
         /// @param last Iterator after last element (like .end() of vectors)
@@ -76,8 +343,10 @@ namespace DiceForge
         /// @brief Returns a uniformly chosen random element from the sequence
         /// @param first Iterator of first element (like .begin() of vectors)
         /// @param last Iterator after last element (like .end() of vectors)
-        /// @param first Iterator of weight of first element (like .begin() of vectors)
-        /// @param last Iterator after weight of last element (like .end() of vectors)
+        /// @param weights_first Iterator of first element of the weights list
+        /// @param weights_last Iterator after last element of the weights list
+        /// @note weights here refer to an array containing the probability weights for each element in the input sequence
+        /// @note Takes O(n) per call, use DiceForge::WeightedSampler to draw repeatedly from the same weights
         template <typename RandomAccessIterator1, typename RandomAccessIterator2>
         auto choice(RandomAccessIterator1 first, RandomAccessIterator1 last,
                     RandomAccessIterator2 weights_first, RandomAccessIterator2 weights_last)
@@ -88,16 +357,22 @@ namespace DiceForge
             else if (last == first){
                 throw std::invalid_argument("Sequence must have non-zero length!");
             }
-            auto cumulative_weights = (decltype(&(*weights_first)))malloc(sizeof(*weights_first) * (last - first));
-            auto prev = *weights_first;
-            prev = 0;
+            // A single pass for the total and one for the index, without allocating
+            real_t total = 0;
+            for (auto it = weights_first; it != weights_last; it++){
+                total += *it;
+            }
+            real_t target = next_unit() * total, cumulative = 0;
+            auto chosen = first;
             for (auto it = weights_first; it != weights_last; it++){
-                cumulative_weights[it - weights_first] = prev + *it;
-                prev = cumulative_weights[it - weights_first];
+                cumulative += *it;
+                if (*it > 0){
+                    chosen = first + (it - weights_first);
+                    if (cumulative > target)
+                        break;
+                }
             }
-            auto ans = *(first + (std::upper_bound(cumulative_weights, &(cumulative_weights[last - first - 1]) + 1, next_unit() * cumulative_weights[last - first - 1]) - cumulative_weights));
-            free(cumulative_weights);
-            return ans;
+            return *chosen;
         };
 
         /// @brief Shuffles the sequence in place
@@ -106,38 +381,465 @@ namespace DiceForge
         template <typename RandomAccessIterator>
         void shuffle(RandomAccessIterator first, RandomAccessIterator last)
         {
-            auto temp = (decltype(&(*first)))malloc(sizeof(*first) * (last - first));
-            for (auto it = first; it != last; it++){
-                temp[it - first] = *it;
+            // Fisher-Yates: the element placed at n - 1 is drawn from the first n
+            for (auto n = last - first; n > 1; n--)
+                std::iter_swap(first + (n - 1), first + detail::uniform_index(derived(), uint64_t(n)));
+        };
+
+        /// @brief Writes k distinct elements of the sequence, chosen uniformly at random, to out
+        /// @param first Iterator of first element (like .begin() of vectors)
+        /// @param last Iterator after last element (like .end() of vectors)
+        /// @param out Iterator to write the chosen elements to
+        /// @param k Number of elements to be chosen (at most the length of the sequence)
+        /// @returns Iterator after the last element written
+        /// @note For random access sequences much longer than k, Floyd's algorithm is used (O(k) time and memory,
+        /// chosen elements in no particular order). Otherwise the sequence is walked once with Vitter's
+        /// Algorithm D (O(k) random numbers, chosen elements in their original order).
+        template <typename ForwardIterator, typename OutputIterator>
+        OutputIterator sample(ForwardIterator first, ForwardIterator last, OutputIterator out, size_t k)
+        {
+            typedef typename std::iterator_traits<ForwardIterator>::iterator_category category;
+            const uint64_t n = uint64_t(std::distance(first, last));
+            if (k > n){
+                throw std::invalid_argument("Sample larger than sequence!");
             }
-            shuffle_array(temp, last - first);
-            for (auto it = first; it!= last; it++){
-                *it = temp[it - first];
+            if constexpr (std::is_base_of<std::random_access_iterator_tag, category>::value) {
+                if (k <= n / floyd_ratio) {
+                    // Floyd: the j-th pick is uniform over the first n - k + j + 1 indices, taking
+                    // the last of them instead if it was already chosen
+                    std::unordered_set<uint64_t> chosen;
+                    chosen.reserve(k);
+                    for (uint64_t j = n - k; j < n; j++) {
+                        uint64_t t = detail::uniform_index(derived(), j + 1);
+                        if (!chosen.insert(t).second) {
+                            chosen.insert(j);
+                            t = j;
+                        }
+                        *out++ = *(first + t);
+                    }
+                    return out;
+                }
             }
-        };
+            sequential_sample(n, k, [&](uint64_t skip) {
+                std::advance(first, skip);
+                *out++ = *first;
+                ++first;
+            });
+            return out;
+        }
+
+        /// @brief Writes k distinct indices in [0, n), chosen uniformly at random, to out in increasing order
+        /// @param n Number of indices to choose from
+        /// @param k Number of indices to be chosen (at most n)
+        /// @param out Iterator to write the chosen indices to
+        /// @returns Iterator after the last index written
+        /// @note Vitter's Algorithm D: O(k) time and random numbers, no memory besides the output
+        template <typename OutputIterator>
+        OutputIterator sample_indices(uint64_t n, size_t k, OutputIterator out)
+        {
+            if (k > n){
+                throw std::invalid_argument("Sample larger than sequence!");
+            }
+            uint64_t next = 0;
+            sequential_sample(n, k, [&](uint64_t skip) {
+                next += skip;
+                *out++ = next++;
+            });
+            return out;
+        }
+
+        /// @brief Keeps k elements chosen uniformly at random from a sequence read only once (reservoir sampling)
+        /// @param first Iterator of first element (any input iterator, e.g. over a stream)
+        /// @param last Iterator after last element
+        /// @param reservoir Iterator of first element of a buffer with room for k elements
+        /// @param k Number of elements to be kept
+        /// @returns Number of elements kept, k unless the sequence was shorter
+        /// @note Li's Algorithm L: after the first k elements, jumps straight to the next element to be kept,
+        /// so that only O(k log(n / k)) random numbers are used
+        template <typename InputIterator, typename RandomAccessIterator>
+        size_t reservoir_sample(InputIterator first, InputIterator last, RandomAccessIterator reservoir, size_t k)
+        {
+            size_t filled = 0;
+            for (; filled < k && first != last; ++first, ++filled) {
+                reservoir[filled] = *first;
+            }
+            if (first == last || k == 0)
+                return filled;
+            // w is the largest of k uniform keys, elements are kept while their key is below it
+            real_t w = std::exp(std::log(open_unit()) / k);
+            while (true) {
+                real_t skip = std::floor(std::log(open_unit()) / std::log1p(-w));
+                for (uint64_t s = (skip < 9.2e18) ? uint64_t(skip) : uint64_t(9.2e18); s > 0 && first != last; s--) {
+                    ++first;
+                }
+                if (first == last)
+                    break;
+                reservoir[detail::uniform_index(derived(), k)] = *first;
+                ++first;
+                w *= std::exp(std::log(open_unit()) / k);
+            }
+            return k;
+        }
+    protected:
+        /// @brief Returns the RNG this interface is resolved against
+        Derived& derived()
+        {
+            return static_cast<Derived&>(*this);
+        }
+    private:
+        // Number of integers generated per block while filling buffers of other types
+        static constexpr size_t block_size = 256;
+        // Every integer of the RNG goes through these two, which count them per engine with DF_INSTRUMENT
+        T draw()
+        {
+#if defined(DF_INSTRUMENT)
+            const size_t site = derived().instrument_site();
+            detail::instrument::add(site, detail::instrument::count, 1);
+            detail::instrument::add(site, detail::instrument::calls, 1);
+#endif
+            return derived().generate();
+        }
+        void draw_block(T* out, size_t n)
+        {
+#if defined(DF_INSTRUMENT)
+            const size_t site = derived().instrument_site();
+            detail::instrument::add(site, detail::instrument::count, n);
+#if defined(DF_INSTRUMENT_CYCLES)
+            detail::instrument::Scope scope(site);
+#else
+            detail::instrument::add(site, detail::instrument::calls, 1);
+#endif
+#endif
+            derived().generate_block(out, n);
+        }
+        // Maps a random integer to [0, 1): the top 53 bits (or all the bits, if fewer) scaled by a power of two
+        static real_t to_unit(T x)
+        {
+            if constexpr (sizeof(T) * 8 > 53)
+                return real_t(x >> (sizeof(T) * 8 - 53)) * (1.0 / 9007199254740992.0);
+            else
+                return real_t(x) * (1.0 / real_t(uint64_t(1) << (sizeof(T) * 8)));
+        }
+        // sample() uses Floyd's algorithm when the sequence is at least this many times longer than the sample
+        static constexpr uint64_t floyd_ratio = 16;
+        // Returns a random real in (0, 1], safe to take the logarithm of
+        real_t open_unit()
+        {
+            return 1.0 - next_unit();
+        }
+        /// @brief Chooses k out of n positions in order (Vitter's Algorithm D, falling back to Algorithm A
+        /// once k is a large fraction of what is left)
+        /// @param select called with the number of positions skipped before each chosen one
+        template <typename Select>
+        void sequential_sample(uint64_t n, uint64_t k, Select select)
+        {
+            if (k == 0)
+                return;
+            // Algorithm D while n > 13 k, the point beyond which Algorithm A is faster
+            const real_t alpha_inv = 13;
+            real_t kr = real_t(k), nr = real_t(n), k_inv = 1.0 / kr;
+            real_t v = std::exp(std::log(open_unit()) * k_inv);
+            uint64_t q1 = n - k + 1;
+            real_t q1r = nr - kr + 1;
+            real_t threshold = alpha_inv * kr;
+            while (k > 1 && threshold < nr) {
+                real_t k1_inv = 1.0 / (kr - 1);
+                uint64_t s;
+                while (true) {
+                    // Step D2: propose a skip s from the approximating continuous distribution
+                    real_t x;
+                    while (true) {
+                        x = nr * (1.0 - v);
+                        s = uint64_t(x);
+                        if (s < q1)
+                            break;
+                        v = std::exp(std::log(open_unit()) * k_inv);
+                    }
+                    real_t u = open_unit(), sr = real_t(s);
+                    real_t y1 = std::exp(std::log(u * nr / q1r) * k1_inv);
+                    v = y1 * (1.0 - x / nr) * (q1r / (q1r - sr));
+                    if (v <= 1.0)
+                        break;
+                    // Step D3: exact acceptance test
+                    real_t y2 = 1.0, top = nr - 1, bottom;
+                    uint64_t limit;
+                    if (k - 1 > s) {
+                        bottom = nr - kr;
+                        limit = n - s;
+                    }
+                    else {
+                        bottom = nr - sr - 1;
+                        limit = q1;
+                    }
+                    for (uint64_t t = n - 1; t >= limit; t--) {
+                        y2 = (y2 * top) / bottom;
+                        top--;
+                        bottom--;
+                    }
+                    if (nr / (nr - x) >= y1 * std::exp(std::log(y2) * k1_inv)) {
+                        v = std::exp(std::log(open_unit()) * k1_inv);
+                        break;
+                    }
+                    v = std::exp(std::log(open_unit()) * k_inv);
+                }
+                select(s);
+                n -= s + 1;
+                nr -= real_t(s) + 1;
+                k--;
+                kr--;
+                k_inv = k1_inv;
+                q1 -= s;
+                q1r -= real_t(s);
+                threshold -= alpha_inv;
+            }
+            if (k == 1) {
+                select(uint64_t(nr * v) < n ? uint64_t(nr * v) : n - 1);
+                return;
+            }
+            // Algorithm A: the probability of skipping s positions is built up term by term
+            uint64_t top = n - k;
+            while (k >= 2) {
+                real_t u = next_unit(), quot = real_t(top) / real_t(n);
+                uint64_t s = 0;
+                while (quot > u) {
+                    s++;
+                    top--;
+                    n--;
+                    quot = quot * real_t(top) / real_t(n);
+                }
+                select(s);
+                n--;
+                k--;
+            }
+            select(detail::uniform_index(derived(), n));
+        }
+    };
+
+    /// @brief DiceForge::Generator<T> - A generic class for RNGs
+    /// @tparam T datatype of random number generated (RNG implementation specific)
+    /// @note Every RNG implemented in DiceForge is derived from this base class.
+    /// @note For writing your own RNG it is advisable to use this as the base class for compatibility with other features.
+    /// @note The state of every RNG of DiceForge can be saved and restored with save_state and load_state (see
+    /// DiceForge::Serializable), to checkpoint a long simulation and carry on from where it stopped.
+    template <typename T>
+    class Generator : public StaticGenerator<Generator<T>, T>, public Serializable<Generator<T>>
+    {
+        friend class StaticGenerator<Generator<T>, T>;
+        friend class Serializable<Generator<T>>;
+    public:
+        /// @brief Re-initializes the RNG with specified seed
+        /// @param seed seed provided for initialization
+        void reset_seed(T seed)
+        {
+            reseed(seed);
+        }
+        /// @brief Re-initializes the RNG from seed material of any length
+        /// @param seq seed material (see DiceForge::SeedSequence)
+        void reset_seed(const SeedSequence& seq)
+        {
+            reseed_from(seq);
+        }
+        /// @brief Advances the RNG as if steps random integers had been generated
+        /// @param steps number of random integers to skip
+        /// @note Takes O(log steps) time for most RNGs (see each RNG); the others discard steps integers one by one
+        void jump(uint64_t steps)
+        {
+            jump_ahead(steps);
+        }
+        /// @brief Whether jump takes much less time than generating the integers skipped
+        bool has_fast_jump() const
+        {
+            return fast_jump();
+        }
+        /// @brief Default destructor
+        virtual ~Generator() = default;
+#if defined(DF_INSTRUMENT)
+        /// @brief Index of the counters of this kind of RNG (see instrument::stats), registered on the first call
+        size_t instrument_site() const
+        {
+            return detail::instrument::engine_site(typeid(*this));
+        }
+#endif
         /*** Note: These are the only functions to be implemented by the implementation RNG ***/
     private:
         /// @brief Should return a random integer generated by the RNG
         virtual T generate() = 0;
         /// @brief Should initialize the seed for the RNG
         virtual void reseed(T seed) = 0;
-        /// @brief Shuffles the array in place
-        /// @param arr Pointer to the first element
-        /// @param len Length of the array
-        template <typename other_T>
-        void shuffle_array(other_T arr[], T len) {
-            T ind;
-            std::vector<other_T> v;
-            for (int i = 0; i < len; i++) {
-                v.push_back(arr[i]);
-            }
-            for (int i = 0; i < len; i++) {
-                ind = next_in_range(0, len - i - 1);
-                arr[i] = v[ind];
-                v.erase(v.begin() + ind);
+        /// @brief Should initialize the state of the RNG from the seed material
+        /// @note The default implementation reseeds with the first word of the sequence, the RNGs of DiceForge fill
+        /// their whole state from it
+        virtual void reseed_from(const SeedSequence& seq)
+        {
+            reseed(T(seq.word(0)));
+        }
+        /// @brief Should fill the buffer with n random integers generated by the RNG
+        /// @note The default implementation calls generate() n times, RNGs override it to produce whole blocks at once
+        virtual void generate_block(T* out, size_t n)
+        {
+            for (size_t i = 0; i < n; i++) {
+                out[i] = generate();
             }
-        };
+        }
+        /// @brief Should advance the RNG as if steps random integers had been generated
+        /// @note The default implementation calls generate() steps times, RNGs override it to jump directly
+        virtual void jump_ahead(uint64_t steps)
+        {
+            for (uint64_t i = 0; i < steps; i++) {
+                generate();
+            }
+        }
+        /// @brief Should return true when jump_ahead does not discard the integers one by one
+        virtual bool fast_jump() const
+        {
+            return false;
+        }
+        /// @brief Should append the name of the RNG and its whole state to the saved state
+        /// @note The default implementation throws std::logic_error, RNGs that can be checkpointed override it
+        virtual void write_state(detail::StateWriter&) const
+        {
+            throw std::logic_error("This RNG cannot save its state");
+        }
+        /// @brief Should check the name written by write_state and restore the state that follows it
+        /// @note Overrides read the whole state and call StateReader::end() before changing the RNG
+        virtual void read_state(detail::StateReader&)
+        {
+            throw std::logic_error("This RNG cannot restore its state");
+        }
     };
+
+    /// @brief DiceForge::StaticView<Engine> - A non-virtual view of a concrete RNG (like MT64 or XORShift64)
+    /// @tparam Engine RNG derived from Generator<T> (it must declare StaticView<Engine> as a friend)
+    /// @note All calls are resolved at compile time, so templated code using the view (and the distributions)
+    /// can inline the RNG into its loops. The view shares the state of the RNG it was made from.
+    template <typename Engine>
+    class StaticView : public StaticGenerator<StaticView<Engine>, typename Engine::result_type>
+    {
+        typedef typename Engine::result_type T;
+        friend class StaticGenerator<StaticView<Engine>, T>;
+    public:
+        /// @brief Creates a view of the given RNG
+        /// @param engine RNG to be viewed, it must outlive the view
+        explicit StaticView(Engine& engine) : engine(engine) {}
+        /// @brief Re-initializes the viewed RNG with specified seed
+        /// @param seed seed provided for initialization
+        void reset_seed(T seed)
+        {
+            engine.reset_seed(seed);
+        }
+        /// @brief Re-initializes the viewed RNG from seed material of any length
+        /// @param seq seed material (see DiceForge::SeedSequence)
+        void reset_seed(const SeedSequence& seq)
+        {
+            engine.reset_seed(seq);
+        }
+        /// @brief Advances the viewed RNG as if steps random integers had been generated
+        /// @param steps number of random integers to skip
+        void jump(uint64_t steps)
+        {
+            engine.jump(steps);
+        }
+    private:
+        Engine& engine;
+#if defined(DF_INSTRUMENT)
+        // The viewed RNG is counted as itself
+        size_t instrument_site()
+        {
+            return engine.instrument_site();
+        }
+#endif
+        // Qualified calls bypass the vtable of the viewed RNG
+        T generate()
+        {
+            return engine.Engine::generate();
+        }
+        void generate_block(T* out, size_t n)
+        {
+            engine.Engine::generate_block(out, n);
+        }
+    };
+
+    /// @brief Returns a non-virtual view of the given RNG (see DiceForge::StaticView)
+    /// @param engine RNG to be viewed, it must outlive the view
+    template <typename Engine>
+    StaticView<Engine> make_static(Engine& engine)
+    {
+        return StaticView<Engine>(engine);
+    }
+
+    /// @brief Splits the stream of the given RNG into k substreams, e.g. one per worker thread
+    /// @param engine RNG whose stream is split (it is not modified)
+    /// @param k number of substreams
+    /// @param stride distance between the starts of consecutive substreams (2^64 / k by default)
+    /// @returns k copies of the RNG, the i-th one jumped ahead by i * stride random integers
+    /// @note The substreams do not overlap as long as each one is used for at most stride random integers
+    /// and k * stride does not exceed the period of the RNG
+    /// @note Throws std::invalid_argument for an RNG without a fast jump (MT32, the plain Blum Blum Shub) and a stride
+    /// above 2^30, which includes the default one, as the RNG would discard the whole stride
+    template <typename Engine>
+    std::vector<Engine> split(const Engine& engine, size_t k, uint64_t stride = 0)
+    {
+        if (k == 0)
+            throw std::invalid_argument("Expected k > 0");
+        if (stride == 0)
+            stride = std::numeric_limits<uint64_t>::max() / k;
+        if (k > 1)
+            detail::check_jump(engine, stride);
+        std::vector<Engine> streams;
+        streams.reserve(k);
+        streams.push_back(engine);
+        for (size_t i = 1; i < k; i++) {
+            streams.push_back(streams.back());
+            streams.back().jump(stride);
+        }
+        return streams;
+    }
+
+    /// @brief Shuffles a range in place on several threads
+    /// @param first iterator to the first element
+    /// @param last iterator past the last element
+    /// @param engine RNG whose stream is split among the threads (it is not modified)
+    /// @param threads maximum number of threads (the hardware concurrency by default)
+    /// @note Blocks are shuffled on their own threads and then merged pairwise at random (MergeShuffle),
+    /// every permutation being equally likely. The result is reproducible for a given RNG, range and
+    /// number of threads.
+    /// @note The RNG is split with DiceForge::split, so it must have a fast jump (any engine but the
+    /// plain Blum Blum Shub and MT32, which throw std::invalid_argument)
+    template <typename RandomAccessIterator, typename Engine>
+    void parallel_shuffle(RandomAccessIterator first, RandomAccessIterator last, const Engine& engine, size_t threads = 0)
+    {
+        if (threads == 0)
+            threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        const size_t n = size_t(last - first);
+        // A power of two number of blocks, k, merged over log2(k) rounds
+        size_t k = 1;
+        while (k < threads && n / (2 * k) >= detail::parallel_shuffle_block)
+            k *= 2;
+
+        std::vector<Engine> streams = split(engine, 2 * k - 1);
+        std::vector<size_t> bounds(k + 1);
+        for (size_t b = 0; b <= k; b++)
+            bounds[b] = size_t(uint128_t(n) * b / k);
+
+        auto run = [](size_t tasks, const auto& task) {
+            std::vector<std::thread> pool;
+            for (size_t t = 1; t < tasks; t++)
+                pool.emplace_back(task, t);
+            task(0);
+            for (auto& thread : pool)
+                thread.join();
+        };
+
+        run(k, [&](size_t b) {
+            streams[b].shuffle(first + bounds[b], first + bounds[b + 1]);
+        });
+        for (size_t width = 1, s = k; width < k; s += k / (2 * width), width *= 2) {
+            run(k / (2 * width), [&, width, s](size_t p) {
+                detail::merge_shuffled(first + bounds[2 * p * width], first + bounds[(2 * p + 1) * width],
+                                       first + bounds[(2 * p + 2) * width], streams[s + p]);
+            });
+        }
+    }
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,188 @@
+#include "geometry.h"
+#include "simd.h"
+#include "dispatch.h"
+
+namespace DiceForge
+{
+    namespace geometry
+    {
+#if defined(DF_DISPATCH_AVX2)
+        // The same transforms compiled for AVX2 and FMA
+        namespace avx2
+        {
+            void circle_from_unit(real_t* x, real_t* y, size_t n);
+            void disk_from_unit(real_t* x, real_t* y, size_t n);
+            void sphere_from_unit(real_t* x, real_t* y, real_t* z, size_t n);
+            void hemisphere_from_unit(real_t* x, real_t* y, real_t* z, size_t n);
+            void cosine_hemisphere_from_unit(real_t* x, real_t* y, real_t* z, size_t n);
+            void triangle_from_unit(real_t* u, real_t* v, size_t n);
+            void simplex_from_unit(size_t d, real_t* out, size_t n);
+        }
+#endif
+
+        DF_DISPATCH_BEGIN
+        namespace
+        {
+            // Every transform is a kernel written once over the value type V, run over whole lanes first and
+            // then over the values left, and reading its inputs from the arrays it writes
+            template <typename V>
+            void circle_kernel(V t, V& x, V& y)
+            {
+                simd::sincos_turn(t, y, x);
+            }
+
+            template <typename V>
+            void disk_kernel(V r2, V t, V& x, V& y)
+            {
+                V s, c;
+                simd::sincos_turn(t, s, c);
+                const V r = simd::sqrt(r2);
+                x = r * c;
+                y = r * s;
+            }
+
+            // z is the height, and the circle of radius sqrt(1 - z^2) = sqrt((1 - z)(1 + z)) at that height
+            template <typename V>
+            void sphere_kernel(V z, V t, V& x, V& y)
+            {
+                V s, c;
+                simd::sincos_turn(t, s, c);
+                const V r = simd::sqrt(simd::max(V(0.0), (V(1.0) - z) * (V(1.0) + z)));
+                x = r * c;
+                y = r * s;
+            }
+
+            template <typename V>
+            void cosine_kernel(V r2, V t, V& x, V& y, V& z)
+            {
+                disk_kernel(r2, t, x, y);
+                z = simd::sqrt(V(1.0) - r2);
+            }
+        }
+
+        void circle_from_unit(real_t* x, real_t* y, size_t n)
+        {
+            DF_DISPATCH(circle_from_unit(x, y, n));
+            size_t i = 0;
+#if defined(DF_SIMD_REAL)
+            typedef simd::vreal V;
+            for (; i + V::width <= n; i += V::width) {
+                V vx, vy;
+                circle_kernel(V::load(x + i), vx, vy);
+                vx.store(x + i);
+                vy.store(y + i);
+            }
+#endif
+            for (; i < n; i++)
+                circle_kernel(x[i], x[i], y[i]);
+        }
+
+        void disk_from_unit(real_t* x, real_t* y, size_t n)
+        {
+            DF_DISPATCH(disk_from_unit(x, y, n));
+            size_t i = 0;
+#if defined(DF_SIMD_REAL)
+            typedef simd::vreal V;
+            for (; i + V::width <= n; i += V::width) {
+                V vx, vy;
+                disk_kernel(V::load(x + i), V::load(y + i), vx, vy);
+                vx.store(x + i);
+                vy.store(y + i);
+            }
+#endif
+            for (; i < n; i++)
+                disk_kernel(x[i], y[i], x[i], y[i]);
+        }
+
+        void hemisphere_from_unit(real_t* x, real_t* y, real_t* z, size_t n)
+        {
+            DF_DISPATCH(hemisphere_from_unit(x, y, z, n));
+            size_t i = 0;
+#if defined(DF_SIMD_REAL)
+            typedef simd::vreal V;
+            for (; i + V::width <= n; i += V::width) {
+                V vx, vy;
+                sphere_kernel(V::load(z + i), V::load(x + i), vx, vy);
+                vx.store(x + i);
+                vy.store(y + i);
+            }
+#endif
+            for (; i < n; i++)
+                sphere_kernel(z[i], x[i], x[i], y[i]);
+        }
+
+        void sphere_from_unit(real_t* x, real_t* y, real_t* z, size_t n)
+        {
+            DF_DISPATCH(sphere_from_unit(x, y, z, n));
+            for (size_t i = 0; i < n; i++)
+                z[i] = 2 * z[i] - 1;
+            hemisphere_from_unit(x, y, z, n);
+        }
+
+        void cosine_hemisphere_from_unit(real_t* x, real_t* y, real_t* z, size_t n)
+        {
+            DF_DISPATCH(cosine_hemisphere_from_unit(x, y, z, n));
+            size_t i = 0;
+#if defined(DF_SIMD_REAL)
+            typedef simd::vreal V;
+            for (; i + V::width <= n; i += V::width) {
+                V vx, vy, vz;
+                cosine_kernel(V::load(x + i), V::load(y + i), vx, vy, vz);
+                vx.store(x + i);
+                vy.store(y + i);
+                vz.store(z + i);
+            }
+#endif
+            for (; i < n; i++)
+                cosine_kernel(x[i], y[i], x[i], y[i], z[i]);
+        }
+
+        void triangle_from_unit(real_t* u, real_t* v, size_t n)
+        {
+            DF_DISPATCH(triangle_from_unit(u, v, n));
+            // Points past the diagonal u + v = 1 are mirrored through the centre of the square
+            for (size_t i = 0; i < n; i++) {
+                const bool fold = u[i] + v[i] > 1;
+                u[i] = fold ? 1 - u[i] : u[i];
+                v[i] = fold ? 1 - v[i] : v[i];
+            }
+        }
+
+        void simplex_from_unit(size_t d, real_t* out, size_t n)
+        {
+            DF_DISPATCH(simplex_from_unit(d, out, n));
+            if (d == 1) {
+                for (size_t i = 0; i < n; i++)
+                    out[i] = 1;
+                return;
+            }
+            // 1 - u is in (0, 1], so that every variate is finite
+            size_t i = 0;
+            const size_t m = d * n;
+#if defined(DF_SIMD_REAL)
+            typedef simd::vreal V;
+            for (; i + V::width <= m; i += V::width)
+                (-simd::log(V(1.0) - V::load(out + i))).store(out + i);
+#endif
+            for (; i < m; i++)
+                out[i] = -std::log(1 - out[i]);
+
+            // The sums of the points a block at a time, the rows read one after the other
+            real_t sum[256];
+            for (size_t first = 0; first < n; first += 256) {
+                const size_t b = (n - first < 256) ? n - first : 256;
+                for (size_t k = 0; k < b; k++)
+                    sum[k] = out[first + k];
+                for (size_t j = 1; j < d; j++)
+                    for (size_t k = 0; k < b; k++)
+                        sum[k] += out[j * n + first + k];
+                for (size_t k = 0; k < b; k++)
+                    sum[k] = 1 / sum[k];
+                for (size_t j = 0; j < d; j++)
+                    for (size_t k = 0; k < b; k++)
+                        out[j * n + first + k] *= sum[k];
+            }
+        }
+        DF_DISPATCH_END
+    }
+}
@@ -0,0 +1,163 @@
+/***GEOMETRIC SAMPLING***/
+/*points drawn uniformly on or in the usual shapes of Monte Carlo rendering and
+particle emission, written as separate arrays of coordinates (x[i], y[i], z[i]
+being point i), so that a batch is a few passes of vector arithmetic over the
+uniforms of fill_unit*/
+
+#ifndef DF_GEOMETRY_H
+#define DF_GEOMETRY_H
+
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+
+#include "types.h"
+#include "generator.h"
+
+namespace DiceForge
+{
+    namespace geometry
+    {
+        /// @brief The transforms of the samplers below, turning the uniforms already written in the arrays into
+        /// points in place (for circle, x holds the angles; for disk and cosine_hemisphere, x the squared radii and
+        /// y the angles; for sphere and hemisphere, z the heights and x the angles)
+        /// @note Over SIMD lanes where available, with the sines and cosines of simd::sincos_turn
+        void circle_from_unit(real_t* x, real_t* y, size_t n);
+        void disk_from_unit(real_t* x, real_t* y, size_t n);
+        void sphere_from_unit(real_t* x, real_t* y, real_t* z, size_t n);
+        void hemisphere_from_unit(real_t* x, real_t* y, real_t* z, size_t n);
+        void cosine_hemisphere_from_unit(real_t* x, real_t* y, real_t* z, size_t n);
+        void triangle_from_unit(real_t* u, real_t* v, size_t n);
+        /// @brief Replaces the d rows of n uniforms with the exponential variates -log(1 - u), normalised point by point
+        void simplex_from_unit(size_t d, real_t* out, size_t n);
+
+        // Candidates drawn at a time by the rejection samplers
+        constexpr size_t rejection_block = 256;
+
+        /// @brief Points uniformly distributed on the unit circle
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @param x, y the coordinates of the n points
+        /// @note One uniform per point, the angle
+        template <typename Derived, typename T>
+        void circle(StaticGenerator<Derived, T>& rng, real_t* x, real_t* y, size_t n)
+        {
+            DF_INSTRUMENT_METHOD("geometry circle", n);
+            rng.fill_unit(x, n);
+            circle_from_unit(x, y, n);
+        }
+
+        /// @brief Points uniformly distributed in the unit disk
+        /// @param rng A random number generator
+        /// @param x, y the coordinates of the n points
+        /// @note Two uniforms per point, by the radius sqrt(u) and the angle 2 pi v: with vector sin and cos this
+        /// is as fast as rejection from the square, which needs 2.5 uniforms per point and a branch on each
+        template <typename Derived, typename T>
+        void disk(StaticGenerator<Derived, T>& rng, real_t* x, real_t* y, size_t n)
+        {
+            DF_INSTRUMENT_METHOD("geometry disk", n);
+            rng.fill_unit(x, n);
+            rng.fill_unit(y, n);
+            disk_from_unit(x, y, n);
+        }
+
+        /// @brief Points uniformly distributed on the unit sphere
+        /// @param rng A random number generator
+        /// @param x, y, z the coordinates of the n points
+        /// @note Two uniforms per point (Archimedes): z uniform in [-1, 1), and the angle around the z axis
+        template <typename Derived, typename T>
+        void sphere(StaticGenerator<Derived, T>& rng, real_t* x, real_t* y, real_t* z, size_t n)
+        {
+            DF_INSTRUMENT_METHOD("geometry sphere", n);
+            rng.fill_unit(z, n);
+            rng.fill_unit(x, n);
+            sphere_from_unit(x, y, z, n);
+        }
+
+        /// @brief Points uniformly distributed on the unit hemisphere z >= 0
+        /// @note As sphere, with z uniform in [0, 1)
+        template <typename Derived, typename T>
+        void hemisphere(StaticGenerator<Derived, T>& rng, real_t* x, real_t* y, real_t* z, size_t n)
+        {
+            DF_INSTRUMENT_METHOD("geometry hemisphere", n);
+            rng.fill_unit(z, n);
+            rng.fill_unit(x, n);
+            hemisphere_from_unit(x, y, z, n);
+        }
+
+        /// @brief Directions on the unit hemisphere z >= 0 with density cos(theta) / pi, about the normal z
+        /// @note Malley's method: a point of the unit disk lifted to the hemisphere, z = sqrt(1 - x^2 - y^2)
+        template <typename Derived, typename T>
+        void cosine_hemisphere(StaticGenerator<Derived, T>& rng, real_t* x, real_t* y, real_t* z, size_t n)
+        {
+            DF_INSTRUMENT_METHOD("geometry cosine hemisphere", n);
+            rng.fill_unit(x, n);
+            rng.fill_unit(y, n);
+            cosine_hemisphere_from_unit(x, y, z, n);
+        }
+
+        /// @brief Points uniformly distributed in the unit ball
+        /// @param rng A random number generator
+        /// @param x, y, z the coordinates of the n points
+        /// @note Rejection from the cube [-1, 1)^3, which keeps pi / 6 of the candidates: 5.7 uniforms per point
+        /// without a square root or a cube root. The candidates are drawn in blocks of 256, of which those past
+        /// the n-th point are dropped.
+        template <typename Derived, typename T>
+        void ball(StaticGenerator<Derived, T>& rng, real_t* x, real_t* y, real_t* z, size_t n)
+        {
+            DF_INSTRUMENT_METHOD("geometry ball", n);
+            real_t u[3 * rejection_block];
+            real_t px[rejection_block], py[rejection_block], pz[rejection_block];
+            size_t done = 0;
+            while (done < n) {
+                rng.fill_unit(u, 3 * rejection_block);
+                // Every candidate is written, and the count moves on past those inside the ball
+                size_t k = 0;
+                for (size_t i = 0; i < rejection_block; i++) {
+                    const real_t a = 2 * u[3 * i] - 1, b = 2 * u[3 * i + 1] - 1, c = 2 * u[3 * i + 2] - 1;
+                    px[k] = a;
+                    py[k] = b;
+                    pz[k] = c;
+                    k += (a * a + b * b + c * c < 1);
+                }
+                DF_INSTRUMENT_METHOD_REJECTS("geometry ball", rejection_block - k);
+                k = std::min(k, n - done);
+                std::copy(px, px + k, x + done);
+                std::copy(py, py + k, y + done);
+                std::copy(pz, pz + k, z + done);
+                done += k;
+            }
+        }
+
+        /// @brief Barycentric coordinates of points uniformly distributed in a triangle
+        /// @param rng A random number generator
+        /// @param u, v the weights of the second and the third vertices: the point of the triangle ABC is
+        /// A + u (B - A) + v (C - A), with u, v >= 0 and u + v <= 1
+        /// @note Two uniforms per point, the unit square folded onto the triangle along its diagonal
+        template <typename Derived, typename T>
+        void triangle(StaticGenerator<Derived, T>& rng, real_t* u, real_t* v, size_t n)
+        {
+            DF_INSTRUMENT_METHOD("geometry triangle", n);
+            rng.fill_unit(u, n);
+            rng.fill_unit(v, n);
+            triangle_from_unit(u, v, n);
+        }
+
+        /// @brief Points uniformly distributed on the standard simplex of d weights, w_j >= 0 summing to 1
+        /// (the Dirichlet distribution with all its parameters 1)
+        /// @param rng A random number generator
+        /// @param d number of weights of each point (d = 3 gives the barycentric coordinates of a triangle)
+        /// @param out d rows of n values, weight j of point i being out[j n + i]
+        /// @note d uniforms per point, normalised exponential variates
+        template <typename Derived, typename T>
+        void simplex(StaticGenerator<Derived, T>& rng, size_t d, real_t* out, size_t n)
+        {
+            if (d == 0)
+                throw std::invalid_argument("A simplex has at least one weight!");
+            DF_INSTRUMENT_METHOD("geometry simplex", n);
+            rng.fill_unit(out, d * n);
+            simplex_from_unit(d, out, n);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,462 @@
+#ifndef DF_INSTRUMENT_H
+#define DF_INSTRUMENT_H
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <cctype>
+#include <chrono>
+
+#include "types.h"
+
+// Opt-in instrumentation of the hot paths, compiled out entirely unless DF_INSTRUMENT is defined (for the library
+// and for the code using it alike). DF_INSTRUMENT_CYCLES adds cycle timers to the bulk calls.
+#if defined(DF_INSTRUMENT_CYCLES) && !defined(DF_INSTRUMENT)
+#define DF_INSTRUMENT
+#endif
+
+#if defined(DF_INSTRUMENT)
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <typeinfo>
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+#if defined(DF_INSTRUMENT_CYCLES) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#elif defined(DF_INSTRUMENT_CYCLES) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace DiceForge
+{
+    namespace instrument
+    {
+        /// @brief What the counters of a site measure
+        enum class Kind
+        {
+            engine,         // count: random integers consumed, calls: next() and bulk calls
+            distribution,   // count: values produced, calls: next() and sample() calls, retries: rejected candidates
+            method,         // shared samplers (ziggurat, polar, next_in_range...): count: values, retries: rejections
+            timer           // a scope timed with DF_INSTRUMENT_SCOPE: calls and cycles
+        };
+
+        /// @brief Counters of one instrumented site, summed over all threads
+        struct Counters
+        {
+            Kind kind;
+            std::string name;
+            uint64_t count = 0, calls = 0, retries = 0, cycles = 0;
+            /// @brief Rejected candidates per value produced
+            real_t retry_rate() const
+            {
+                return count ? real_t(retries) / real_t(count) : 0;
+            }
+            /// @brief Cycles (or nanoseconds without a cycle counter) per value, with DF_INSTRUMENT_CYCLES
+            real_t cycles_per_item() const
+            {
+                return count ? real_t(cycles) / real_t(count) : (calls ? real_t(cycles) / real_t(calls) : 0);
+            }
+        };
+
+        /// @brief A snapshot of all the counters (see instrument::stats)
+        struct Stats
+        {
+            std::vector<Counters> sites;
+            /// @brief The counters of the named site, nullptr if it has not been reached
+            const Counters* find(const std::string& name) const
+            {
+                for (const Counters& c : sites)
+                    if (c.name == name)
+                        return &c;
+                return nullptr;
+            }
+            /// @brief Random integers consumed by all the engines
+            uint64_t words() const
+            {
+                uint64_t total = 0;
+                for (const Counters& c : sites)
+                    total += (c.kind == Kind::engine) ? c.count : 0;
+                return total;
+            }
+        };
+
+        /// @brief Whether the library was built with DF_INSTRUMENT
+#if defined(DF_INSTRUMENT)
+        constexpr bool enabled = true;
+#else
+        constexpr bool enabled = false;
+#endif
+    }
+
+#if defined(DF_INSTRUMENT)
+    namespace detail
+    {
+        namespace instrument
+        {
+            using DiceForge::instrument::Kind;
+
+            // Sites beyond this share the last slot
+            constexpr size_t max_sites = 256;
+            enum Field { count, calls, retries, cycles, fields };
+
+            // Counters of one thread, written by it alone (relaxed loads and stores, no locked instructions) and
+            // read by the snapshots
+            struct Thread
+            {
+                std::atomic<uint64_t> c[max_sites][fields] = {};
+                Thread();
+                ~Thread();
+            };
+
+            struct Registry
+            {
+                std::mutex mutex;
+                std::vector<std::pair<Kind, std::string>> sites;
+                std::vector<Thread*> threads;
+                // Counts of the threads that have ended
+                uint64_t retired[max_sites][fields] = {};
+            };
+
+            inline Registry& registry()
+            {
+                static Registry r;
+                return r;
+            }
+
+            inline Thread::Thread()
+            {
+                std::lock_guard<std::mutex> lock(registry().mutex);
+                registry().threads.push_back(this);
+            }
+
+            inline Thread::~Thread()
+            {
+                Registry& r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                for (size_t s = 0; s < max_sites; s++)
+                    for (size_t f = 0; f < fields; f++)
+                        r.retired[s][f] += c[s][f].load(std::memory_order_relaxed);
+                r.threads.erase(std::find(r.threads.begin(), r.threads.end(), this));
+            }
+
+            inline Thread& local()
+            {
+                thread_local Thread t;
+                return t;
+            }
+
+            /// @brief Index of the site of the given kind and name, registered on the first call
+            inline size_t site(Kind kind, const std::string& name)
+            {
+                Registry& r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                for (size_t s = 0; s < r.sites.size(); s++)
+                    if (r.sites[s].first == kind && r.sites[s].second == name)
+                        return s;
+                if (r.sites.size() == max_sites - 1)
+                    r.sites.emplace_back(kind, "(other sites)");
+                if (r.sites.size() == max_sites)
+                    return max_sites - 1;
+                r.sites.emplace_back(kind, name);
+                return r.sites.size() - 1;
+            }
+
+            inline void add(size_t s, Field f, uint64_t v)
+            {
+                std::atomic<uint64_t>& a = local().c[s][f];
+                a.store(a.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+            }
+
+            /// @brief Readable name of a type: without the namespace, with the widths of the integer types and only
+            /// the first argument of a template (MT64 is MersenneTwisterEngine<uint64_t>)
+            inline std::string type_name(const std::type_info& type)
+            {
+                std::string name = type.name();
+#if defined(__GNUG__)
+                int status = 0;
+                char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+                if (status == 0 && demangled != nullptr)
+                    name = demangled;
+                std::free(demangled);
+#endif
+                const std::pair<const char*, const char*> replace[] = {
+                    {"DiceForge::", ""}, {"class ", ""}, {"unsigned long long", "uint64_t"},
+                    {"unsigned __int64", "uint64_t"}, {"unsigned long", "uint64_t"}, {"unsigned int", "uint32_t"}};
+                for (const auto& r : replace)
+                    for (size_t at = name.find(r.first); at != std::string::npos; at = name.find(r.first, at))
+                        name.replace(at, std::strlen(r.first), r.second);
+                // Integer literals of template arguments, 4ul -> 4, and the arguments after the first
+                std::string out;
+                int depth = 0;
+                bool skip = false;
+                for (size_t i = 0; i < name.size(); i++)
+                {
+                    depth += (name[i] == '<') - (name[i] == '>');
+                    if (name[i] == ',' && depth == 1)
+                        skip = true;
+                    else if (depth == 0)
+                        skip = false;
+                    if (skip)
+                        continue;
+                    if ((name[i] == 'u' || name[i] == 'l') && i > 0 && std::isdigit((unsigned char)name[i - 1]))
+                    {
+                        while (i + 1 < name.size() && (name[i + 1] == 'u' || name[i + 1] == 'l'))
+                            i++;
+                        continue;
+                    }
+                    out += name[i];
+                }
+                return out;
+            }
+
+            /// @brief Index of the site of an engine type, cached per thread
+            /// @note The engines hold no counter state of their own, so their layout does not depend on the flag
+            /// and code built with it can use a library built without it (whose own draws go uncounted)
+            inline size_t engine_site(const std::type_info& type)
+            {
+                thread_local std::vector<std::pair<const std::type_info*, size_t>> known;
+                for (const auto& k : known)
+                    if (*k.first == type)
+                        return k.second;
+                known.emplace_back(&type, site(Kind::engine, type_name(type)));
+                return known.back().second;
+            }
+
+            /// @brief Reads the cycle counter (the steady clock in nanoseconds where there is none)
+            inline uint64_t ticks()
+            {
+#if defined(DF_INSTRUMENT_CYCLES) && (defined(__x86_64__) || defined(__i386__) || defined(_MSC_VER))
+                return __rdtsc();
+#else
+                return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+            }
+
+            // Depth of the instrumented sampling calls of the thread: sample() looping over next(), or a
+            // distribution drawing from another, counts once, for the outermost call
+            inline int& depth()
+            {
+                thread_local int d = 0;
+                return d;
+            }
+
+            /// @brief Counts a call of a distribution producing n values, and times it with DF_INSTRUMENT_CYCLES
+            class Sampling
+            {
+            private:
+                size_t s;
+                bool outer;
+#if defined(DF_INSTRUMENT_CYCLES)
+                uint64_t start = 0;
+#endif
+            public:
+                Sampling(size_t s, uint64_t n) : s(s), outer(depth()++ == 0)
+                {
+                    if (outer)
+                    {
+                        add(s, count, n);
+                        add(s, calls, 1);
+#if defined(DF_INSTRUMENT_CYCLES)
+                        start = ticks();
+#endif
+                    }
+                }
+                ~Sampling()
+                {
+                    depth()--;
+#if defined(DF_INSTRUMENT_CYCLES)
+                    if (outer)
+                        add(s, cycles, ticks() - start);
+#endif
+                }
+                Sampling(const Sampling&) = delete;
+                Sampling& operator=(const Sampling&) = delete;
+            };
+
+            /// @brief Counts and times a scope (DF_INSTRUMENT_SCOPE), or an engine filling a block
+            class Scope
+            {
+            private:
+                size_t s;
+                uint64_t start;
+            public:
+                explicit Scope(size_t s) : s(s), start(ticks())
+                {
+                    add(s, calls, 1);
+                }
+                ~Scope()
+                {
+                    add(s, cycles, ticks() - start);
+                }
+                Scope(const Scope&) = delete;
+                Scope& operator=(const Scope&) = delete;
+            };
+        }
+    }
+
+// Index of a site, looked up once per place in the code
+#define DF_INSTRUMENT_SITE(kind, name) ([]() { \
+        static const size_t df_site = ::DiceForge::detail::instrument::site(::DiceForge::instrument::Kind::kind, name); \
+        return df_site; }())
+#define DF_INSTRUMENT_ADD(kind, name, field, n) \
+    ::DiceForge::detail::instrument::add(DF_INSTRUMENT_SITE(kind, name), ::DiceForge::detail::instrument::field, (n))
+/// Counts a call of a distribution producing n values (for the outermost call only, see detail::instrument::depth)
+#define DF_INSTRUMENT_SAMPLES(name, n) \
+    ::DiceForge::detail::instrument::Sampling df_sampling(DF_INSTRUMENT_SITE(distribution, name), uint64_t(n))
+/// Counts a rejected candidate of a distribution
+#define DF_INSTRUMENT_REJECT(name) DF_INSTRUMENT_ADD(distribution, name, retries, 1)
+/// Counts n values of a shared sampling method
+#define DF_INSTRUMENT_METHOD(name, n) DF_INSTRUMENT_ADD(method, name, count, n)
+/// Counts a rejection of a shared sampling method
+#define DF_INSTRUMENT_METHOD_REJECT(name) DF_INSTRUMENT_ADD(method, name, retries, 1)
+/// Counts n rejections of a shared sampling method
+#define DF_INSTRUMENT_METHOD_REJECTS(name, n) DF_INSTRUMENT_ADD(method, name, retries, n)
+/// Counts the calls of the enclosing scope and the cycles spent in it
+#define DF_INSTRUMENT_SCOPE(name) \
+    ::DiceForge::detail::instrument::Scope df_scope(DF_INSTRUMENT_SITE(timer, name))
+#else
+#define DF_INSTRUMENT_SAMPLES(name, n) ((void)0)
+#define DF_INSTRUMENT_REJECT(name) ((void)0)
+#define DF_INSTRUMENT_METHOD(name, n) ((void)0)
+#define DF_INSTRUMENT_METHOD_REJECT(name) ((void)0)
+#define DF_INSTRUMENT_METHOD_REJECTS(name, n) ((void)0)
+#define DF_INSTRUMENT_SCOPE(name) ((void)0)
+#endif
+
+    namespace instrument
+    {
+        /// @brief Returns the counters of every site reached so far, summed over the threads (empty without
+        /// DF_INSTRUMENT)
+        /// @note Safe to call while other threads draw; their latest increments may be missing
+        inline Stats stats()
+        {
+            Stats out;
+#if defined(DF_INSTRUMENT)
+            namespace di = detail::instrument;
+            di::Registry& r = di::registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            for (size_t s = 0; s < r.sites.size(); s++)
+            {
+                uint64_t total[di::fields];
+                for (size_t f = 0; f < di::fields; f++)
+                {
+                    total[f] = r.retired[s][f];
+                    for (const di::Thread* t : r.threads)
+                        total[f] += t->c[s][f].load(std::memory_order_relaxed);
+                }
+                Counters c;
+                c.kind = r.sites[s].first;
+                c.name = r.sites[s].second;
+                c.count = total[di::count];
+                c.calls = total[di::calls];
+                c.retries = total[di::retries];
+                c.cycles = total[di::cycles];
+                out.sites.push_back(c);
+            }
+#endif
+            return out;
+        }
+
+        /// @brief Sets every counter back to 0 (the sites stay registered)
+        /// @note Counts added by other threads during the reset may survive it
+        inline void reset()
+        {
+#if defined(DF_INSTRUMENT)
+            namespace di = detail::instrument;
+            di::Registry& r = di::registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            for (size_t s = 0; s < di::max_sites; s++)
+                for (size_t f = 0; f < di::fields; f++)
+                {
+                    r.retired[s][f] = 0;
+                    for (di::Thread* t : r.threads)
+                        t->c[s][f].store(0, std::memory_order_relaxed);
+                }
+#endif
+        }
+
+        /// @brief Writes the counters as a table, one site per line
+        inline void dump(std::ostream& out, const Stats& stats)
+        {
+            if (!enabled) {
+                out << "DiceForge instrumentation is off (build with DF_INSTRUMENT)" << std::endl;
+                return;
+            }
+            static const char* kinds[] = {"engine", "distribution", "method", "timer"};
+            const std::ios_base::fmtflags flags = out.flags();
+            out << std::left << std::setw(14) << "kind" << std::setw(44) << "site" << std::right << std::setw(16)
+                << "count" << std::setw(14) << "calls" << std::setw(16) << "retries/value"
+#if defined(DF_INSTRUMENT_CYCLES)
+                << std::setw(16) << "cycles/value"
+#endif
+                << "\n";
+            for (const Counters& c : stats.sites)
+            {
+                out << std::left << std::setw(14) << kinds[int(c.kind)] << std::setw(44) << c.name << std::right
+                    << std::setw(16) << c.count << std::setw(14) << c.calls << std::setw(16) << c.retry_rate()
+#if defined(DF_INSTRUMENT_CYCLES)
+                    << std::setw(16) << c.cycles_per_item()
+#endif
+                    << "\n";
+            }
+            out.flags(flags);
+            out.flush();
+        }
+
+        /// @brief Writes the current counters as a table
+        inline void dump(std::ostream& out = std::cerr)
+        {
+            dump(out, stats());
+        }
+
+        /// @brief DiceForge::instrument::PeriodicDump - Writes the counters to a stream at regular intervals, from
+        /// a thread of its own, until it is destroyed (does nothing without DF_INSTRUMENT)
+        class PeriodicDump
+        {
+#if defined(DF_INSTRUMENT)
+        private:
+            std::mutex mutex;
+            std::condition_variable wake;
+            bool stopping = false;
+            std::thread worker;
+        public:
+            /// @param out stream to write to, which must outlive this object
+            /// @param interval time between two dumps
+            PeriodicDump(std::ostream& out, std::chrono::milliseconds interval)
+            {
+                worker = std::thread([this, &out, interval]() {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    while (!wake.wait_for(lock, interval, [this]() { return stopping; }))
+                        dump(out);
+                });
+            }
+            ~PeriodicDump()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stopping = true;
+                }
+                wake.notify_one();
+                worker.join();
+            }
+#else
+        public:
+            PeriodicDump(std::ostream&, std::chrono::milliseconds) {}
+#endif
+            PeriodicDump(const PeriodicDump&) = delete;
+            PeriodicDump& operator=(const PeriodicDump&) = delete;
+        };
+    }
+}
+
+#endif
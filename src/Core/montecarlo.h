@@ -0,0 +1,229 @@
+#ifndef DF_MONTECARLO_H
+#define DF_MONTECARLO_H
+
+#include <vector>
+#include <utility>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+#include "types.h"
+#include "generator.h"
+#include "quadrature.h"
+
+namespace DiceForge
+{
+    /// @brief Outcome of a Monte Carlo integration
+    struct monte_carlo_result
+    {
+        real_t value;       // estimate of the integral
+        real_t error;       // standard error of the estimate (one standard deviation)
+        size_t evaluations; // number of integrand evaluations used
+    };
+
+    /// @brief Variance reduction and threading for monte_carlo_integrate
+    struct monte_carlo_options
+    {
+        bool antithetic = false; // pair every point with its reflection through the centre of its stratum
+        size_t strata = 1;       // strata per dimension, 1 for plain sampling, 0 for about n / 8 strata in all
+        int threads = 0;         // threads for the chunks, 0 for std::thread::hardware_concurrency
+    };
+
+    namespace detail
+    {
+        // Sampling units (points, or antithetic pairs) per chunk, every chunk drawing from its own substream
+        constexpr size_t monte_carlo_chunk = 65536;
+        // Units whose uniforms are drawn in one bulk call
+        constexpr size_t monte_carlo_block = 256;
+
+        // Mean and sum of squared deviations of the units drawn in one stratum
+        struct stratum_stats
+        {
+            size_t stratum = 0, n = 0;
+            real_t mean = 0, m2 = 0;
+
+            void add(real_t y)
+            {
+                n++;
+                real_t delta = y - mean;
+                mean += delta / real_t(n);
+                m2 += delta * (y - mean);
+            }
+            void merge(const stratum_stats& other)
+            {
+                size_t total = n + other.n;
+                real_t delta = other.mean - mean;
+                mean += delta * real_t(other.n) / real_t(total);
+                m2 += other.m2 + delta * delta * real_t(n) * real_t(other.n) / real_t(total);
+                n = total;
+            }
+        };
+
+        // One chunk: the strata it starts and ends in, which may carry on into the neighbouring chunks, and the
+        // sums of the means and of the variances of the means over the strata lying wholly inside it
+        struct monte_carlo_part
+        {
+            stratum_stats first, last;
+            bool has_last = false;
+            real_t means = 0, variances = 0;
+        };
+    }
+
+    /// @brief Monte Carlo integration of f over a box in any number of dimensions
+    /// @param f the integrand f(const real_t* x), x holding one coordinate per dimension
+    /// @param domain lower and upper limit of every dimension
+    /// @param n number of evaluations of f
+    /// @param rng RNG the points are drawn with, advanced past all the random numbers used
+    /// @param options antithetic pairs, stratification and threads (see monte_carlo_options)
+    /// @return The integral with its standard error and the evaluations used
+    /// @note The box is cut into strata^d equal cells with the same number of points each, and the error is estimated
+    /// from the spread within the cells. The points are drawn in chunks, each from its own substream of rng (see
+    /// DiceForge::split) laid end to end, so the result does not depend on the number of threads. f is called from
+    /// all the threads at once. As with split, rng should have a fast jump.
+    template <typename F, typename Engine>
+    monte_carlo_result monte_carlo_integrate(F &&f, const std::vector<std::pair<real_t, real_t>>& domain, size_t n,
+                                             Engine& rng, monte_carlo_options options = {})
+    {
+        const size_t d = domain.size();
+        if (d == 0)
+            throw std::invalid_argument("Expected a domain of at least one dimension");
+        real_t volume = 1;
+        for (const std::pair<real_t, real_t>& bounds : domain)
+        {
+            if (!(std::isfinite(bounds.first) && std::isfinite(bounds.second)))
+                throw std::invalid_argument("Expected finite integration limits");
+            volume *= bounds.second - bounds.first;
+        }
+
+        const size_t units = options.antithetic ? n / 2 : n;
+        size_t k = options.strata;
+        if (k == 0)
+        {
+            // the largest k with k^d cells holding 8 units or more each
+            for (k = 1;; k++)
+            {
+                size_t cells = 1;
+                for (size_t j = 0; j < d && cells <= units / 8; j++)
+                    cells *= k + 1;
+                if (cells > units / 8)
+                    break;
+            }
+        }
+        size_t cells = 1;
+        for (size_t j = 0; j < d; j++)
+        {
+            if (cells > units / k / 2)
+                throw std::invalid_argument("Expected at least two points per stratum");
+            cells *= k;
+        }
+        const size_t per_cell = units / cells;
+        const size_t total = cells * per_cell;
+
+        const size_t chunks = (total + detail::monte_carlo_chunk - 1) / detail::monte_carlo_chunk;
+        std::vector<Engine> streams = split(rng, chunks, uint64_t(detail::monte_carlo_chunk) * d);
+        std::vector<detail::monte_carlo_part> parts(chunks);
+
+        auto job = [&](size_t c)
+        {
+            Engine& stream = streams[c];
+            detail::monte_carlo_part& part = parts[c];
+            const size_t begin = c * detail::monte_carlo_chunk, end = std::min(total, begin + detail::monte_carlo_chunk);
+            std::vector<real_t> u(detail::monte_carlo_block * d), x(d), lower(d), width(d);
+            for (size_t j = 0; j < d; j++)
+                width[j] = (domain[j].second - domain[j].first) / real_t(k);
+
+            detail::stratum_stats current;
+            bool has_first = false;
+            auto enter = [&](size_t stratum)
+            {
+                current = detail::stratum_stats();
+                current.stratum = stratum;
+                for (size_t j = 0; j < d; j++, stratum /= k)
+                    lower[j] = domain[j].first + real_t(stratum % k) * width[j];
+            };
+            enter(begin / per_cell);
+
+            for (size_t i = begin; i < end; i += detail::monte_carlo_block)
+            {
+                const size_t m = std::min(detail::monte_carlo_block, end - i);
+                stream.fill_unit(u.data(), m * d);
+                for (size_t t = 0; t < m; t++)
+                {
+                    const size_t stratum = (i + t) / per_cell;
+                    if (stratum != current.stratum)
+                    {
+                        if (!has_first)
+                        {
+                            part.first = current;
+                            has_first = true;
+                        }
+                        else
+                        {
+                            part.means += current.mean;
+                            part.variances += current.m2 / real_t(current.n - 1) / real_t(current.n);
+                        }
+                        enter(stratum);
+                    }
+
+                    const real_t* v = u.data() + t * d;
+                    for (size_t j = 0; j < d; j++)
+                        x[j] = lower[j] + v[j] * width[j];
+                    real_t y = f(static_cast<const real_t*>(x.data()));
+                    if (options.antithetic)
+                    {
+                        for (size_t j = 0; j < d; j++)
+                            x[j] = lower[j] + (1 - v[j]) * width[j];
+                        y = (y + f(static_cast<const real_t*>(x.data()))) / 2;
+                    }
+                    current.add(y);
+                }
+            }
+            if (!has_first)
+                part.first = current;
+            else
+            {
+                part.last = current;
+                part.has_last = true;
+            }
+        };
+        detail::parallel_for(chunks, options.threads, job);
+        // the last substream ends where the whole run does
+        rng = streams.back();
+
+        // strata cut by chunk boundaries are merged back together, in order
+        real_t means = 0, variances = 0;
+        auto close = [&](const detail::stratum_stats& s)
+        {
+            means += s.mean;
+            variances += s.m2 / real_t(s.n - 1) / real_t(s.n);
+        };
+        detail::stratum_stats open = parts[0].first;
+        for (size_t c = 0; c < chunks; c++)
+        {
+            const detail::monte_carlo_part& part = parts[c];
+            if (c > 0)
+            {
+                if (part.first.stratum == open.stratum)
+                    open.merge(part.first);
+                else
+                {
+                    close(open);
+                    open = part.first;
+                }
+            }
+            if (part.has_last)
+            {
+                close(open);
+                means += part.means;
+                variances += part.variances;
+                open = part.last;
+            }
+        }
+        close(open);
+
+        return {volume * means / real_t(cells), volume * std::sqrt(variances) / real_t(cells),
+                total * (options.antithetic ? 2 : 1)};
+    }
+}
+
+#endif
@@ -0,0 +1,40 @@
+/***MARSAGLIA'S POLAR METHOD***/
+/*a point drawn uniformly in the unit disc, scaled by sqrt(-2 log(s) / s) where
+s is its squared distance from the centre, gives two independent standard
+normals for one logarithm and one square root, without any trigonometry*/
+
+#ifndef DF_POLAR_H
+#define DF_POLAR_H
+
+#include <utility>
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include "types.h"
+#include "generator.h"
+
+namespace DiceForge
+{
+    namespace polar
+    {
+        /// @brief Returns a pair of independent standard normal variates
+        template <typename Derived, typename T>
+        std::pair<real_t, real_t> normal_pair(StaticGenerator<Derived, T>& rng)
+        {
+            real_t u, v, s;
+            DF_INSTRUMENT_METHOD("polar", 2);
+            do {
+                u = 2 * rng.next_unit() - 1;
+                v = 2 * rng.next_unit() - 1;
+                s = u * u + v * v;
+                if (s >= 1 || s == 0)
+                    DF_INSTRUMENT_METHOD_REJECT("polar");
+            } while (s >= 1 || s == 0);
+            real_t f = std::sqrt(-2.0 * std::log(s) / s);
+            return std::make_pair(u * f, v * f);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef DF_POOL_H
+#define DF_POOL_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <optional>
+#include <limits>
+#include <cstddef>
+#include <stdexcept>
+
+#include "types.h"
+#include "generator.h"
+#include "quadrature.h"
+
+namespace DiceForge
+{
+    namespace detail
+    {
+        // Values per chunk of parallel_fill and parallel_sample, every chunk drawing from its own stream
+        constexpr size_t pool_chunk = 65536;
+        // Distinguishes the pools in the per-thread tables of GeneratorPool::local
+        inline std::atomic<uint64_t> pool_count{0};
+    }
+
+    /// @brief DiceForge::GeneratorPool<Engine> - A fixed number of independent streams of one RNG, for threads
+    /// @tparam Engine RNG derived from Generator<T> (like MT64 or XORShift64)
+    /// @note Stream i is the master RNG jumped ahead by i * stride random integers, as with DiceForge::split, and is
+    /// only made the first time it is asked for. It then lives in a slot of its own cache line(s), so that threads
+    /// drawing from neighbouring streams do not write to the same line.
+    /// @note The streams are independent of the order in which threads ask for them, so results are reproducible as
+    /// long as work is tied to stream indices (as in parallel_fill and parallel_sample) rather than to threads.
+    /// Engine should have a fast jump (any but the plain Blum Blum Shub and MT32): without one, the pool throws
+    /// std::invalid_argument unless its last stream starts at most 2^30 integers ahead.
+    template <typename Engine>
+    class GeneratorPool
+    {
+    private:
+        struct alignas(64) Slot
+        {
+            std::once_flag made;
+            std::optional<Engine> engine;
+        };
+        Engine master;
+        size_t count;
+        uint64_t stride;
+        std::unique_ptr<Slot[]> slots;
+        uint64_t id = detail::pool_count++;
+        std::atomic<size_t> handed{0};
+
+    public:
+        /// @brief Creates a pool of streams of the given RNG
+        /// @param engine master RNG, copied (stream 0 starts where it is)
+        /// @param streams number of streams
+        /// @param stride distance between the starts of consecutive streams (2^64 / streams by default)
+        /// @note The streams do not overlap as long as each one is used for at most stride random integers
+        /// @note Throws std::invalid_argument for an RNG without a fast jump and (streams - 1) * stride above 2^30
+        GeneratorPool(const Engine& engine, size_t streams, uint64_t stride = 0)
+            : master(engine), count(streams), stride(stride), slots(new Slot[streams])
+        {
+            if (streams == 0)
+                throw std::invalid_argument("Expected at least one stream");
+            if (this->stride == 0)
+                this->stride = std::numeric_limits<uint64_t>::max() / streams;
+            detail::check_jump(engine, uint128_t(streams - 1) * this->stride);
+        }
+        GeneratorPool(const GeneratorPool&) = delete;
+        GeneratorPool& operator=(const GeneratorPool&) = delete;
+
+        /// @brief Number of streams in the pool
+        size_t size() const
+        {
+            return count;
+        }
+        /// @brief Returns stream i, making it on the first call
+        /// @note Safe to call from several threads at once, but a stream should only be drawn from by one thread at
+        /// a time
+        Engine& stream(size_t i)
+        {
+            if (i >= count)
+                throw std::out_of_range("No such stream in the pool");
+            Slot& slot = slots[i];
+            std::call_once(slot.made, [&]() {
+                slot.engine.emplace(master);
+                slot.engine->jump(uint64_t(i) * stride);
+            });
+            return *slot.engine;
+        }
+        /// @brief Returns the stream of the calling thread, handing it the next unused stream on its first call
+        /// @note Which thread gets which stream depends on the order of the first calls; use stream(i) with a worker
+        /// index for results that do not depend on scheduling. Throws std::out_of_range once every stream is taken.
+        Engine& local()
+        {
+            // (pool, stream) pairs of the calling thread; a pool is never reused, so stale entries are harmless
+            thread_local std::vector<std::pair<uint64_t, size_t>> taken;
+            for (const std::pair<uint64_t, size_t>& entry : taken)
+                if (entry.first == id)
+                    return stream(entry.second);
+            const size_t i = handed++;
+            if (i >= count)
+                throw std::out_of_range("Every stream of the pool has been handed out");
+            taken.emplace_back(id, i);
+            return stream(i);
+        }
+    };
+
+    /// @brief Fills the buffer with random reals between 0 and 1 on several threads
+    /// @param pool streams to draw from, chunk c of the buffer drawing from stream c % pool.size()
+    /// @param out Pointer to the first element of the buffer
+    /// @param n Number of random reals to be written
+    /// @param threads maximum number of threads, 0 for std::thread::hardware_concurrency
+    /// @note The buffer is cut into chunks of detail::pool_chunk values, and the chunks sharing a stream are filled
+    /// in order by one thread, so the result depends on the pool but not on the number of threads
+    template <typename Engine>
+    void parallel_fill(GeneratorPool<Engine>& pool, real_t* out, size_t n, int threads = 0)
+    {
+        const size_t chunks = (n + detail::pool_chunk - 1) / detail::pool_chunk;
+        auto job = [&](size_t s) {
+            auto rng = make_static(pool.stream(s));
+            for (size_t c = s; c < chunks; c += pool.size()) {
+                const size_t begin = c * detail::pool_chunk;
+                rng.fill_unit(out + begin, std::min(detail::pool_chunk, n - begin));
+            }
+        };
+        detail::parallel_for(std::min(chunks, pool.size()), threads, job);
+    }
+
+    /// @brief Fills the buffer with values of a distribution on several threads
+    /// @param pool streams to draw from, chunk c of the buffer drawing from stream c % pool.size()
+    /// @param distribution a distribution with a batch sample(rng, out, n), of a concrete (copyable) type
+    /// @param out Pointer to the first element of the buffer
+    /// @param n Number of values to be written
+    /// @param threads maximum number of threads, 0 for std::thread::hardware_concurrency
+    /// @note Each stream draws from its own copy of the distribution, so that samplers keeping a state between
+    /// draws (the hull of AdaptiveRejection, a cached normal) are never shared between threads, and the copy of
+    /// stream s fills its chunks in order. As parallel_fill, the result depends on the pool but not on the number
+    /// of threads; the state gathered by the copies is dropped, the distribution itself being left unchanged.
+    template <typename Engine, typename Distribution, typename V>
+    void parallel_sample(GeneratorPool<Engine>& pool, const Distribution& distribution, V* out, size_t n, int threads = 0)
+    {
+        const size_t chunks = (n + detail::pool_chunk - 1) / detail::pool_chunk;
+        auto job = [&](size_t s) {
+            auto rng = make_static(pool.stream(s));
+            Distribution local(distribution);
+            for (size_t c = s; c < chunks; c += pool.size()) {
+                const size_t begin = c * detail::pool_chunk;
+                local.sample(rng, out + begin, std::min(detail::pool_chunk, n - begin));
+            }
+        };
+        detail::parallel_for(std::min(chunks, pool.size()), threads, job);
+    }
+}
+
+#endif
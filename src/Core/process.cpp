@@ -0,0 +1,174 @@
+#include "process.h"
+#include "simd.h"
+
+namespace DiceForge
+{
+    PoissonProcess::PoissonProcess(real_t rate, real_t start) : m_rate(rate), inv_rate(1 / rate), t(start)
+    {
+        if (!(rate > 0) || !std::isfinite(rate))
+            throw std::invalid_argument("The rate must be positive and finite!");
+    }
+
+    real_t PoissonProcess::time() const
+    {
+        return t;
+    }
+
+    void PoissonProcess::reset(real_t start)
+    {
+        t = start;
+    }
+
+    real_t PoissonProcess::rate() const
+    {
+        return m_rate;
+    }
+
+    void PoissonProcess::write_state(detail::StateWriter& out) const
+    {
+        out.tag("PoissonProcess");
+        out.put(m_rate);
+        out.put(t);
+    }
+
+    void PoissonProcess::read_state(detail::StateReader& in)
+    {
+        in.tag("PoissonProcess");
+        const real_t rate = in.get<real_t>(), time = in.get<real_t>();
+        in.end();
+        *this = PoissonProcess(rate, time);
+    }
+
+    GaussianRandomWalk::GaussianRandomWalk(size_t paths, real_t mu, real_t sigma, real_t x0)
+        : PathProcess(paths, x0), mu(mu), sigma(sigma)
+    {
+        if (!(sigma >= 0))
+            throw std::invalid_argument("Value of sigma must not be negative!");
+    }
+
+    void GaussianRandomWalk::step(real_t* z)
+    {
+        real_t* x = state.data();
+        for (size_t p = 0; p < state.size(); p++)
+            z[p] = x[p] = x[p] + mu + sigma * z[p];
+    }
+
+    GeometricBrownianMotion::GeometricBrownianMotion(size_t paths, real_t s0, real_t mu, real_t sigma, real_t dt)
+        : PathProcess(paths, s0), mu(mu), sigma(sigma), dt(dt)
+    {
+        if (!(s0 > 0) || !(sigma >= 0) || !(dt > 0))
+            throw std::invalid_argument("Expected s0 > 0, sigma >= 0 and dt > 0!");
+        drift = (mu - sigma * sigma / 2) * dt;
+        volatility = sigma * std::sqrt(dt);
+    }
+
+    void GeometricBrownianMotion::step(real_t* z)
+    {
+        real_t* s = state.data();
+        const size_t n = state.size();
+        size_t p = 0;
+#if defined(DF_SIMD_REAL)
+        typedef simd::vreal V;
+        for (; p + V::width <= n; p += V::width) {
+            const V next = V::load(s + p) * simd::exp(V(drift) + V(volatility) * V::load(z + p));
+            next.store(s + p);
+            next.store(z + p);
+        }
+#endif
+        for (; p < n; p++)
+            z[p] = s[p] = s[p] * std::exp(drift + volatility * z[p]);
+    }
+
+    OrnsteinUhlenbeck::OrnsteinUhlenbeck(size_t paths, real_t theta, real_t mu, real_t sigma, real_t dt, real_t x0)
+        : PathProcess(paths, x0), theta(theta), mu(mu), sigma(sigma), dt(dt)
+    {
+        if (!(theta > 0) || !(sigma >= 0) || !(dt > 0))
+            throw std::invalid_argument("Expected theta > 0, sigma >= 0 and dt > 0!");
+        decay = std::exp(-theta * dt);
+        // 1 - e^(-2 theta dt) without the cancellation of small steps
+        deviation = sigma * std::sqrt(-std::expm1(-2 * theta * dt) / (2 * theta));
+    }
+
+    void OrnsteinUhlenbeck::step(real_t* z)
+    {
+        real_t* x = state.data();
+        for (size_t p = 0; p < state.size(); p++)
+            z[p] = x[p] = mu + (x[p] - mu) * decay + deviation * z[p];
+    }
+
+    real_t OrnsteinUhlenbeck::stationary_deviation() const
+    {
+        return sigma / std::sqrt(2 * theta);
+    }
+
+    // The states hold the parameters, the number of steps and the values of the paths, whose number must match
+
+    void GaussianRandomWalk::write_state(detail::StateWriter& out) const
+    {
+        out.tag("GaussianRandomWalk");
+        out.put(uint64_t(state.size()));
+        out.put(mu);
+        out.put(sigma);
+        out.put(m_steps);
+        out.put(state.data(), state.size());
+    }
+
+    void GaussianRandomWalk::read_state(detail::StateReader& in)
+    {
+        in.tag("GaussianRandomWalk");
+        in.expect(uint64_t(state.size()));
+        const real_t m = in.get<real_t>(), s = in.get<real_t>();
+        GaussianRandomWalk walk(state.size(), m, s);
+        walk.m_steps = in.get<uint64_t>();
+        in.get(walk.state.data(), walk.state.size());
+        in.end();
+        *this = walk;
+    }
+
+    void GeometricBrownianMotion::write_state(detail::StateWriter& out) const
+    {
+        out.tag("GeometricBrownianMotion");
+        out.put(uint64_t(state.size()));
+        out.put(mu);
+        out.put(sigma);
+        out.put(dt);
+        out.put(m_steps);
+        out.put(state.data(), state.size());
+    }
+
+    void GeometricBrownianMotion::read_state(detail::StateReader& in)
+    {
+        in.tag("GeometricBrownianMotion");
+        in.expect(uint64_t(state.size()));
+        const real_t m = in.get<real_t>(), s = in.get<real_t>(), d = in.get<real_t>();
+        GeometricBrownianMotion motion(state.size(), 1, m, s, d);
+        motion.m_steps = in.get<uint64_t>();
+        in.get(motion.state.data(), motion.state.size());
+        in.end();
+        *this = motion;
+    }
+
+    void OrnsteinUhlenbeck::write_state(detail::StateWriter& out) const
+    {
+        out.tag("OrnsteinUhlenbeck");
+        out.put(uint64_t(state.size()));
+        out.put(theta);
+        out.put(mu);
+        out.put(sigma);
+        out.put(dt);
+        out.put(m_steps);
+        out.put(state.data(), state.size());
+    }
+
+    void OrnsteinUhlenbeck::read_state(detail::StateReader& in)
+    {
+        in.tag("OrnsteinUhlenbeck");
+        in.expect(uint64_t(state.size()));
+        const real_t t = in.get<real_t>(), m = in.get<real_t>(), s = in.get<real_t>(), d = in.get<real_t>();
+        OrnsteinUhlenbeck process(state.size(), t, m, s, d);
+        process.m_steps = in.get<uint64_t>();
+        in.get(process.state.data(), process.state.size());
+        in.end();
+        *this = process;
+    }
+}
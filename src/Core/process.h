@@ -0,0 +1,287 @@
+/***STOCHASTIC PROCESSES***/
+/*processes that keep their state between calls, so that a path of any length
+is generated block by block into the buffers of the caller: arrival times of
+Poisson processes, and many independent paths of random walks, geometric
+Brownian motions and Ornstein-Uhlenbeck processes advanced side by side*/
+
+#ifndef DF_PROCESS_H
+#define DF_PROCESS_H
+
+#include <vector>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+
+#include "types.h"
+#include "generator.h"
+#include "ziggurat.h"
+#include "state.h"
+
+namespace DiceForge
+{
+    /// @brief DiceForge::PoissonProcess - Arrival times of a homogeneous Poisson process of the given rate
+    /// @note The time of the last arrival is kept between calls, and can be saved with save_state
+    class PoissonProcess : public Serializable<PoissonProcess>
+    {
+        friend class Serializable<PoissonProcess>;
+    private:
+        real_t m_rate, inv_rate, t;
+        void write_state(detail::StateWriter& out) const;
+        void read_state(detail::StateReader& in);
+    public:
+        /// @brief A process of rate events per unit of time, started at time start
+        /// @note rate > 0
+        explicit PoissonProcess(real_t rate, real_t start = 0);
+
+        /// @brief Returns the time of the next arrival
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        template <typename Derived, typename T>
+        real_t next(StaticGenerator<Derived, T>& rng)
+        {
+            t += ziggurat::next_exponential(rng) * inv_rate;
+            return t;
+        }
+        /// @brief Writes the times of the next n arrivals
+        template <typename Derived, typename T>
+        void sample(StaticGenerator<Derived, T>& rng, real_t* times, size_t n)
+        {
+            for (size_t i = 0; i < n; i++)
+                times[i] = next(rng);
+        }
+        /// @brief Writes the times of the next arrivals before end, at most capacity of them, and returns their number
+        /// @note When fewer than capacity are written the process has reached end, and goes on from there; otherwise
+        /// call again for the rest. A gap drawn past end is dropped, which leaves the distribution of the arrivals
+        /// unchanged as the gaps are memoryless.
+        template <typename Derived, typename T>
+        size_t sample_until(StaticGenerator<Derived, T>& rng, real_t end, real_t* times, size_t capacity)
+        {
+            size_t count = 0;
+            while (count < capacity) {
+                const real_t candidate = t + ziggurat::next_exponential(rng) * inv_rate;
+                if (candidate >= end) {
+                    t = end;
+                    break;
+                }
+                t = candidate;
+                times[count++] = t;
+            }
+            return count;
+        }
+        /// @brief Time of the last arrival (or the start)
+        real_t time() const;
+        /// @brief Restarts the process at the given time
+        void reset(real_t start = 0);
+        /// @brief Rate of the arrivals
+        real_t rate() const;
+    };
+
+    /// @brief DiceForge::InhomogeneousPoissonProcess - Arrival times of a Poisson process whose rate varies in time
+    /// @note Thinning (Lewis and Shedler): the arrivals of a homogeneous process of rate bound are kept with
+    /// probability intensity(t) / bound, so the cost per arrival is bound over the mean intensity
+    class InhomogeneousPoissonProcess
+    {
+    private:
+        std::function<real_t(real_t)> intensity;
+        real_t m_bound, inv_bound, t;
+        // Whether the candidate at time t is kept, given a uniform u
+        bool keep(real_t u) const
+        {
+            const real_t rate = intensity(t);
+            if (!(rate <= m_bound))
+                throw std::invalid_argument("The intensity exceeds its bound!");
+            return u * m_bound < rate;
+        }
+    public:
+        /// @brief A process of instantaneous rate intensity(t), started at time start
+        /// @param intensity rate of the arrivals at time t, between 0 and bound
+        /// @param bound upper bound of the intensity (> 0), the rate of the candidates
+        /// @note std::invalid_argument is thrown when the intensity is found above its bound
+        template <typename Function>
+        InhomogeneousPoissonProcess(Function intensity, real_t bound, real_t start = 0)
+            : intensity(intensity), m_bound(bound), inv_bound(1 / bound), t(start)
+        {
+            if (!(bound > 0) || !std::isfinite(bound))
+                throw std::invalid_argument("The bound of the intensity must be positive and finite!");
+        }
+        /// @brief Returns the time of the next arrival
+        template <typename Derived, typename T>
+        real_t next(StaticGenerator<Derived, T>& rng)
+        {
+            DF_INSTRUMENT_METHOD("thinning", 1);
+            while (true) {
+                t += ziggurat::next_exponential(rng) * inv_bound;
+                if (keep(rng.next_unit()))
+                    return t;
+                DF_INSTRUMENT_METHOD_REJECT("thinning");
+            }
+        }
+        /// @brief Writes the times of the next n arrivals
+        template <typename Derived, typename T>
+        void sample(StaticGenerator<Derived, T>& rng, real_t* times, size_t n)
+        {
+            for (size_t i = 0; i < n; i++)
+                times[i] = next(rng);
+        }
+        /// @brief Writes the times of the next arrivals before end, at most capacity of them, and returns their number
+        /// @note As PoissonProcess::sample_until
+        template <typename Derived, typename T>
+        size_t sample_until(StaticGenerator<Derived, T>& rng, real_t end, real_t* times, size_t capacity)
+        {
+            size_t count = 0;
+            while (count < capacity) {
+                const real_t candidate = t + ziggurat::next_exponential(rng) * inv_bound;
+                if (candidate >= end) {
+                    t = end;
+                    break;
+                }
+                t = candidate;
+                if (keep(rng.next_unit())) {
+                    DF_INSTRUMENT_METHOD("thinning", 1);
+                    times[count++] = t;
+                }
+                else
+                    DF_INSTRUMENT_METHOD_REJECT("thinning");
+            }
+            return count;
+        }
+        /// @brief Time of the last candidate (or the start)
+        real_t time() const
+        {
+            return t;
+        }
+        /// @brief Restarts the process at the given time
+        void reset(real_t start = 0)
+        {
+            t = start;
+        }
+    };
+
+    namespace detail
+    {
+        /// @brief The paths of a process advanced side by side, a step at a time of all the paths
+        /// @tparam Derived class providing step(z), which replaces the standard normal variates z[p] with the
+        /// values of the paths p after one more step and stores them in the state
+        template <typename Derived>
+        class PathProcess
+        {
+        protected:
+            // The current value of every path, and the number of steps taken
+            std::vector<real_t> state;
+            uint64_t m_steps = 0;
+            PathProcess(size_t paths, real_t x0) : state(paths, x0)
+            {
+                if (paths == 0)
+                    throw std::invalid_argument("Expected at least one path!");
+            }
+            ~PathProcess() = default;
+        public:
+            /// @brief Number of paths
+            size_t paths() const
+            {
+                return state.size();
+            }
+            /// @brief The current values of the paths
+            const real_t* values() const
+            {
+                return state.data();
+            }
+            /// @brief Number of steps taken since construction (or the last reset)
+            uint64_t steps() const
+            {
+                return m_steps;
+            }
+            /// @brief Restarts every path at x0
+            void reset(real_t x0)
+            {
+                std::fill(state.begin(), state.end(), x0);
+                m_steps = 0;
+            }
+            /// @brief Advances every path by the given number of steps, writing the values along the way
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param out steps rows of paths() values: out[s paths() + p] is path p after s + 1 more steps
+            /// @note The paths resume where the last call left them, so a long simulation can be streamed
+            /// through a buffer of a few steps. Each step draws paths() standard normals and updates the paths
+            /// in one pass over SIMD lanes.
+            template <typename D, typename T>
+            void advance(StaticGenerator<D, T>& rng, real_t* out, size_t steps)
+            {
+                const size_t n = state.size();
+                for (size_t s = 0; s < steps; s++) {
+                    real_t* row = out + s * n;
+                    for (size_t p = 0; p < n; p++)
+                        row[p] = ziggurat::next_normal(rng);
+                    static_cast<Derived*>(this)->step(row);
+                }
+                m_steps += steps;
+            }
+            /// @brief Advances every path by the given number of steps, keeping only their final values
+            template <typename D, typename T>
+            void advance(StaticGenerator<D, T>& rng, size_t steps)
+            {
+                std::vector<real_t> row(state.size());
+                for (size_t s = 0; s < steps; s++)
+                    advance(rng, row.data(), 1);
+            }
+        };
+    }
+
+    /// @brief DiceForge::GaussianRandomWalk - Independent random walks with normal steps of mean mu and deviation sigma
+    /// @note x_(k+1) = x_k + mu + sigma z; the state (the paths and the parameters) can be saved with save_state
+    class GaussianRandomWalk : public detail::PathProcess<GaussianRandomWalk>, public Serializable<GaussianRandomWalk>
+    {
+        friend class detail::PathProcess<GaussianRandomWalk>;
+        friend class Serializable<GaussianRandomWalk>;
+    private:
+        real_t mu, sigma;
+        void step(real_t* z);
+        void write_state(detail::StateWriter& out) const;
+        void read_state(detail::StateReader& in);
+    public:
+        /// @brief paths walks started at x0, with steps of mean mu and standard deviation sigma (>= 0)
+        GaussianRandomWalk(size_t paths, real_t mu, real_t sigma, real_t x0 = 0);
+    };
+
+    /// @brief DiceForge::GeometricBrownianMotion - Independent paths of dS = mu S dt + sigma S dW sampled every dt
+    /// @note Exact in distribution at the sampled times: S_(k+1) = S_k exp((mu - sigma^2 / 2) dt + sigma sqrt(dt) z),
+    /// with the exponential over SIMD lanes; the state can be saved with save_state
+    class GeometricBrownianMotion : public detail::PathProcess<GeometricBrownianMotion>,
+                                    public Serializable<GeometricBrownianMotion>
+    {
+        friend class detail::PathProcess<GeometricBrownianMotion>;
+        friend class Serializable<GeometricBrownianMotion>;
+    private:
+        real_t mu, sigma, dt;
+        // Drift and volatility of the logarithm over one step
+        real_t drift, volatility;
+        void step(real_t* z);
+        void write_state(detail::StateWriter& out) const;
+        void read_state(detail::StateReader& in);
+    public:
+        /// @brief paths motions started at s0 (> 0), of drift mu and volatility sigma (>= 0), with steps of dt (> 0)
+        GeometricBrownianMotion(size_t paths, real_t s0, real_t mu, real_t sigma, real_t dt);
+    };
+
+    /// @brief DiceForge::OrnsteinUhlenbeck - Independent paths of dX = theta (mu - X) dt + sigma dW sampled every dt
+    /// @note Exact in distribution at the sampled times: X_(k+1) = mu + (X_k - mu) e^(-theta dt)
+    /// + sigma sqrt((1 - e^(-2 theta dt)) / (2 theta)) z, whatever the step; the state can be saved with save_state
+    class OrnsteinUhlenbeck : public detail::PathProcess<OrnsteinUhlenbeck>, public Serializable<OrnsteinUhlenbeck>
+    {
+        friend class detail::PathProcess<OrnsteinUhlenbeck>;
+        friend class Serializable<OrnsteinUhlenbeck>;
+    private:
+        real_t theta, mu, sigma, dt;
+        // Decay of the distance to mu and deviation of the noise over one step
+        real_t decay, deviation;
+        void step(real_t* z);
+        void write_state(detail::StateWriter& out) const;
+        void read_state(detail::StateReader& in);
+    public:
+        /// @brief paths processes started at x0, reverting to mu at the rate theta (> 0), of volatility sigma (>= 0),
+        /// with steps of dt (> 0)
+        OrnsteinUhlenbeck(size_t paths, real_t theta, real_t mu, real_t sigma, real_t dt, real_t x0 = 0);
+        /// @brief Standard deviation of the stationary distribution, sigma / sqrt(2 theta)
+        real_t stationary_deviation() const;
+    };
+}
+
+#endif
@@ -0,0 +1,181 @@
+#ifndef DF_QUADRATURE_H
+#define DF_QUADRATURE_H
+
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <cstddef>
+#include <cmath>
+#include <atomic>
+#include <thread>
+
+#include "types.h"
+
+namespace DiceForge
+{
+    /// @brief Outcome of an adaptive integration
+    template <typename T = real_t>
+    struct quadrature_result
+    {
+        T value;            // estimate of the integral
+        T error;            // estimate of the absolute error
+        size_t evaluations; // number of integrand evaluations used
+        bool converged;     // whether the requested tolerance was met within the evaluation budget
+    };
+
+    namespace detail
+    {
+        // 15-point Kronrod extension of the 7-point Gauss rule (abscissae of the upper half, the Gauss nodes being
+        // the odd ones, and the centre last)
+        constexpr long double kronrod_nodes[8] = {
+            0.991455371120812639206854697526329L, 0.949107912342758524526189684047851L,
+            0.864864423359769072789712788640926L, 0.741531185599394439863864773280788L,
+            0.586087235467691130294144845693013L, 0.405845151377397166906606412076961L,
+            0.207784955007898467600689403773245L, 0.0L};
+        constexpr long double kronrod_weights[8] = {
+            0.022935322010529224963732008058970L, 0.063092092629978553290700663189204L,
+            0.104790010322250183839876322541518L, 0.140653259715525918745189590510238L,
+            0.169004726639267902826583426598550L, 0.190350578064785409913256402421014L,
+            0.204432940075298892414161999234649L, 0.209482141084727828012999174891714L};
+        constexpr long double gauss7_weights[4] = {
+            0.129484966168869693270611432679082L, 0.279705391489276667901467771423780L,
+            0.381830050505118944950369775488975L, 0.417959183673469387755102040816327L};
+
+        template <typename T>
+        struct kronrod_panel
+        {
+            T a, b, value, error;
+            bool operator<(const kronrod_panel& other) const { return error < other.error; }
+        };
+
+        // G7-K15 estimate over [a, b], the error being |K15 - G7|. Integrands of the form
+        // f(const T* x, T* out, size_t n) get all 15 nodes in one call.
+        template <typename T, typename F>
+        kronrod_panel<T> kronrod15(F& f, T a, T b)
+        {
+            const T h = (b - a) / 2, c = (a + b) / 2;
+            T x[15], y[15];
+            for (int i = 0; i < 7; i++)
+            {
+                x[i] = c - h * T(kronrod_nodes[i]);
+                x[14 - i] = c + h * T(kronrod_nodes[i]);
+            }
+            x[7] = c;
+
+            if constexpr (std::is_invocable_v<F&, const T*, T*, size_t>)
+                f(static_cast<const T*>(x), y, size_t(15));
+            else
+                for (int i = 0; i < 15; i++)
+                    y[i] = f(x[i]);
+
+            T kronrod = T(kronrod_weights[7]) * y[7], gauss = T(gauss7_weights[3]) * y[7];
+            for (int i = 0; i < 7; i++)
+            {
+                T pair = y[i] + y[14 - i];
+                kronrod += T(kronrod_weights[i]) * pair;
+                if (i % 2 == 1)
+                    gauss += T(gauss7_weights[i / 2]) * pair;
+            }
+            return {a, b, kronrod * h, std::fabs((kronrod - gauss) * h)};
+        }
+
+        // Calls job(i) for every i < n on up to `threads` threads (the caller being one of them)
+        template <typename Job>
+        void parallel_for(size_t n, int threads, Job &job)
+        {
+            if (threads <= 0)
+                threads = std::max(1, int(std::thread::hardware_concurrency()));
+            const size_t count = std::min(size_t(threads), n);
+            if (count <= 1)
+            {
+                for (size_t i = 0; i < n; i++)
+                    job(i);
+                return;
+            }
+
+            std::atomic<size_t> next{0};
+            auto work = [&]()
+            {
+                for (size_t i = next++; i < n; i = next++)
+                    job(i);
+            };
+            std::vector<std::thread> pool;
+            for (size_t t = 1; t < count; t++)
+                pool.emplace_back(work);
+            work();
+            for (std::thread &t : pool)
+                t.join();
+        }
+    }
+
+    /// @brief Adaptive Gauss-Kronrod (G7-K15) integration of f over the finite interval [a, b]
+    /// @param f the integrand, either f(x) or f(const T* x, T* out, size_t n) evaluating n points in one call
+    /// @param a lower limit of integration
+    /// @param b upper limit of integration
+    /// @param rel_tol requested error relative to the magnitude of the integral
+    /// @param abs_tol requested absolute error (the looser of the two is used)
+    /// @param max_evaluations evaluation budget, after which the best estimate so far is returned
+    /// @return The integral with its error estimate, the evaluations used and whether the tolerance was met
+    /// @note The panels are kept in a heap ordered by their error, and the worst one is bisected until the total
+    /// error is small enough. Only the two new halves are evaluated, every other panel keeps its estimate.
+    template <typename T = real_t, typename F>
+    quadrature_result<T> integrate_adaptive(F &&f, T a, T b, T rel_tol = T(1e-10), T abs_tol = T(1e-14),
+                                            size_t max_evaluations = 100000)
+    {
+        if (b < a)
+        {
+            quadrature_result<T> r = integrate_adaptive<T>(f, b, a, rel_tol, abs_tol, max_evaluations);
+            r.value = -r.value;
+            return r;
+        }
+
+        std::vector<detail::kronrod_panel<T>> heap;
+        heap.push_back(detail::kronrod15<T>(f, a, b));
+        T value = heap[0].value, error = heap[0].error;
+        size_t evaluations = 15;
+
+        bool converged = false;
+        while (true)
+        {
+            if (error <= std::max(abs_tol, rel_tol * std::fabs(value)))
+            {
+                converged = true;
+                break;
+            }
+            if (evaluations + 30 > max_evaluations)
+                break;
+
+            std::pop_heap(heap.begin(), heap.end());
+            detail::kronrod_panel<T> worst = heap.back();
+            T mid = (worst.a + worst.b) / 2;
+            // the panel can not be split any further in this precision
+            if (!(mid > worst.a && mid < worst.b))
+            {
+                std::push_heap(heap.begin(), heap.end());
+                break;
+            }
+
+            detail::kronrod_panel<T> left = detail::kronrod15<T>(f, worst.a, mid);
+            detail::kronrod_panel<T> right = detail::kronrod15<T>(f, mid, worst.b);
+            evaluations += 30;
+            value += left.value + right.value - worst.value;
+            error += left.error + right.error - worst.error;
+
+            heap.back() = left;
+            std::push_heap(heap.begin(), heap.end());
+            heap.push_back(right);
+            std::push_heap(heap.begin(), heap.end());
+        }
+
+        // the running sums drift, so the final totals are added up again
+        value = error = T(0);
+        for (const detail::kronrod_panel<T>& panel : heap)
+        {
+            value += panel.value;
+            error += panel.error;
+        }
+        return {value, error, evaluations, converged};
+    }
+}
+
+#endif
@@ -0,0 +1,102 @@
+#include "sampler.h"
+
+#include <cmath>
+
+namespace DiceForge
+{
+    WeightedSampler::WeightedSampler(std::vector<real_t> weights)
+    {
+        if (weights.empty())
+            throw std::invalid_argument("Weight sequence must have non-zero length!");
+        for (real_t w : weights)
+            check_weight(w);
+        build(std::move(weights));
+    }
+
+    size_t WeightedSampler::size() const
+    {
+        return m_weights.size();
+    }
+
+    real_t WeightedSampler::weight(size_t i) const
+    {
+        return m_weights.at(i);
+    }
+
+    real_t WeightedSampler::probability(size_t i) const
+    {
+        return m_weights.at(i) / m_total;
+    }
+
+    void WeightedSampler::update(size_t i, real_t weight)
+    {
+        std::vector<real_t> weights = m_weights;
+        set_weight(weights, i, weight);
+        build(std::move(weights));
+    }
+
+    size_t WeightedSampler::index(real_t r) const
+    {
+        real_t x = r * m_prob.size();
+        size_t i = size_t(x);
+        if (i >= m_prob.size())
+            i = m_prob.size() - 1;
+        return (x - i < m_prob[i]) ? i : m_alias[i];
+    }
+
+    void WeightedSampler::check_weight(real_t weight)
+    {
+        if (!(weight >= 0) || !std::isfinite(weight))
+            throw std::invalid_argument("Weights must be finite and not negative!");
+    }
+
+    void WeightedSampler::set_weight(std::vector<real_t>& weights, size_t i, real_t weight)
+    {
+        if (i >= weights.size())
+            throw std::invalid_argument("Index out of range!");
+        check_weight(weight);
+        weights[i] = weight;
+    }
+
+    void WeightedSampler::build(std::vector<real_t> weights)
+    {
+        const size_t n = weights.size();
+        real_t total = 0;
+        for (real_t w : weights)
+            total += w;
+        if (!(total > 0))
+            throw std::invalid_argument("Weights must not all be zero!");
+        if (!std::isfinite(total))
+            throw std::invalid_argument("The sum of the weights must be finite!");
+
+        // Scale the weights to average 1, then repeatedly top up a column below 1 from one above 1
+        std::vector<real_t> prob(n);
+        std::vector<size_t> alias(n);
+        std::vector<size_t> small, large;
+        for (size_t i = 0; i < n; i++) {
+            prob[i] = weights[i] * n / total;
+            alias[i] = i;
+            (prob[i] < 1 ? small : large).push_back(i);
+        }
+        while (!small.empty() && !large.empty()) {
+            size_t s = small.back(), l = large.back();
+            small.pop_back();
+            alias[s] = l;
+            prob[l] -= 1 - prob[s];
+            if (prob[l] < 1) {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+        // Whatever is left is 1 up to rounding
+        for (size_t i : large)
+            prob[i] = 1;
+        for (size_t i : small)
+            prob[i] = 1;
+
+        m_weights = std::move(weights);
+        m_total = total;
+        m_prob = std::move(prob);
+        m_alias = std::move(alias);
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef DF_SAMPLER_H
+#define DF_SAMPLER_H
+
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+#include "types.h"
+#include "generator.h"
+
+namespace DiceForge
+{
+    /// @brief DiceForge::WeightedSampler - Draws indices in [0, n) with probabilities proportional to the given weights
+    /// @note Built once in O(n) (Vose's alias method), after which every draw takes O(1) regardless of n.
+    /// Changing weights rebuilds the table, so batch the changes with update(indices, weights) when possible.
+    class WeightedSampler
+    {
+    public:
+        /// @brief Builds the sampler from a sequence of finite non-negative weights (not all zero)
+        /// @param weights_first Iterator of first element of the weights list
+        /// @param weights_last Iterator after last element of the weights list
+        template <typename InputIterator>
+        WeightedSampler(InputIterator weights_first, InputIterator weights_last)
+            : WeightedSampler(std::vector<real_t>(weights_first, weights_last)) {}
+        /// @brief Builds the sampler from a list of finite non-negative weights (not all zero)
+        explicit WeightedSampler(std::vector<real_t> weights);
+
+        /// @brief Number of indices that can be drawn
+        size_t size() const;
+        /// @brief Weight of index i
+        real_t weight(size_t i) const;
+        /// @brief Probability of drawing index i
+        real_t probability(size_t i) const;
+
+        /// @brief Changes the weight of index i and rebuilds the table (O(n))
+        /// @note Throws std::invalid_argument, leaving the sampler as it was, for an index out of range, a weight
+        /// that is negative or not finite, or weights that would all be zero
+        void update(size_t i, real_t weight);
+        /// @brief Changes the weights of several indices and rebuilds the table once
+        /// @param indices_first Iterator of first element of the indices list
+        /// @param indices_last Iterator after last element of the indices list
+        /// @param weights_first Iterator of first element of the new weights (as many as indices)
+        /// @note The whole batch is checked as update(i, weight) before any weight changes
+        template <typename InputIterator1, typename InputIterator2>
+        void update(InputIterator1 indices_first, InputIterator1 indices_last, InputIterator2 weights_first)
+        {
+            std::vector<real_t> weights = m_weights;
+            for (; indices_first != indices_last; ++indices_first, ++weights_first)
+                set_weight(weights, *indices_first, *weights_first);
+            build(std::move(weights));
+        }
+
+        /// @brief Returns a random index, drawn with the given RNG
+        template <typename Engine>
+        size_t sample(Engine& rng) const
+        {
+            size_t i = size_t(detail::uniform_index(rng, uint64_t(m_prob.size())));
+            return (rng.next_unit() < m_prob[i]) ? i : m_alias[i];
+        }
+        /// @brief Fills out with k random indices, drawn with the given RNG
+        template <typename Engine>
+        void sample(Engine& rng, size_t* out, size_t k) const
+        {
+            for (size_t j = 0; j < k; j++)
+                out[j] = sample(rng);
+        }
+        /// @brief Maps a uniformly distributed unit random variable r to an index
+        /// @note The integer part of r * n picks a column of the table and its fractional part decides
+        /// between the column and its alias, so precision is lost for very large n
+        size_t index(real_t r) const;
+
+    private:
+        // Weights as given and their sum
+        std::vector<real_t> m_weights;
+        real_t m_total = 0;
+        // Probability of keeping each column, and the index it is paired with otherwise
+        std::vector<real_t> m_prob;
+        std::vector<size_t> m_alias;
+
+        static void check_weight(real_t weight);
+        // Checks index and weight, then writes the weight to weights
+        static void set_weight(std::vector<real_t>& weights, size_t i, real_t weight);
+        // Builds the table of the weights and takes them, changing nothing when it throws
+        void build(std::vector<real_t> weights);
+    };
+}
+
+#endif
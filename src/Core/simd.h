@@ -0,0 +1,388 @@
+/***SIMD LANE WRAPPER***/
+/*a thin layer over the vector instructions (AVX2, SSE2 or NEON, whichever
+is available at compile time) shared by the SIMD kernels of the generators
+and, for lanes of real_t, by the data passes of the fitters*/
+
+#ifndef DF_SIMD_H
+#define DF_SIMD_H
+
+#include "types.h"
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define DF_SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define DF_SIMD_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define DF_SIMD_NEON
+#endif
+
+#if defined(DF_SIMD_AVX2) || defined(DF_SIMD_SSE2) || defined(DF_SIMD_NEON)
+#define DF_SIMD
+#endif
+
+// The instruction set of the lanes, naming the inline namespace below: files compiled for different instruction
+// sets (see dispatch.h) each get their own copy of the inline functions, which the linker cannot mix up
+#if defined(DF_SIMD_AVX2)
+#define DF_SIMD_ISA avx2
+#elif defined(DF_SIMD_SSE2)
+#define DF_SIMD_ISA sse2
+#elif defined(DF_SIMD_NEON)
+#define DF_SIMD_ISA neon
+#else
+#define DF_SIMD_ISA scalar
+#endif
+
+namespace DiceForge
+{
+    namespace simd
+    {
+    inline namespace DF_SIMD_ISA
+    {
+        // Lanes<W> - thin wrapper over the vector instructions for lanes of the word type W
+        template <typename W>
+        struct Lanes;
+
+#if defined(DF_SIMD_AVX2)
+        template <>
+        struct Lanes<uint32_t>
+        {
+            typedef __m256i vec;
+            static constexpr int width = 8;
+            static vec load(const uint32_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+            static void store(uint32_t* p, vec v) { _mm256_storeu_si256((__m256i*)p, v); }
+            static vec set1(uint32_t x) { return _mm256_set1_epi32((int)x); }
+            static vec srl(vec v, int n) { return _mm256_srl_epi32(v, _mm_cvtsi32_si128(n)); }
+            static vec sll(vec v, int n) { return _mm256_sll_epi32(v, _mm_cvtsi32_si128(n)); }
+            static vec neg(vec v) { return _mm256_sub_epi32(_mm256_setzero_si256(), v); }
+            static vec band(vec a, vec b) { return _mm256_and_si256(a, b); }
+            static vec bor(vec a, vec b) { return _mm256_or_si256(a, b); }
+            static vec bxor(vec a, vec b) { return _mm256_xor_si256(a, b); }
+            static vec add(vec a, vec b) { return _mm256_add_epi32(a, b); }
+            static vec mul(vec a, vec b) { return _mm256_mullo_epi32(a, b); }
+        };
+
+        template <>
+        struct Lanes<uint64_t>
+        {
+            typedef __m256i vec;
+            static constexpr int width = 4;
+            static vec load(const uint64_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+            static void store(uint64_t* p, vec v) { _mm256_storeu_si256((__m256i*)p, v); }
+            static vec set1(uint64_t x) { return _mm256_set1_epi64x((long long)x); }
+            static vec srl(vec v, int n) { return _mm256_srl_epi64(v, _mm_cvtsi32_si128(n)); }
+            static vec sll(vec v, int n) { return _mm256_sll_epi64(v, _mm_cvtsi32_si128(n)); }
+            static vec neg(vec v) { return _mm256_sub_epi64(_mm256_setzero_si256(), v); }
+            static vec band(vec a, vec b) { return _mm256_and_si256(a, b); }
+            static vec bor(vec a, vec b) { return _mm256_or_si256(a, b); }
+            static vec bxor(vec a, vec b) { return _mm256_xor_si256(a, b); }
+            static vec add(vec a, vec b) { return _mm256_add_epi64(a, b); }
+            // Low 64 bits of the products, built from 32x32 -> 64 bit multiplies (there is no 64-bit mullo in AVX2)
+            static vec mul(vec a, vec b)
+            {
+                vec cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b), _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+                return _mm256_add_epi64(_mm256_mul_epu32(a, b), _mm256_slli_epi64(cross, 32));
+            }
+        };
+#elif defined(DF_SIMD_SSE2)
+        template <>
+        struct Lanes<uint32_t>
+        {
+            typedef __m128i vec;
+            static constexpr int width = 4;
+            static vec load(const uint32_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+            static void store(uint32_t* p, vec v) { _mm_storeu_si128((__m128i*)p, v); }
+            static vec set1(uint32_t x) { return _mm_set1_epi32((int)x); }
+            static vec srl(vec v, int n) { return _mm_srl_epi32(v, _mm_cvtsi32_si128(n)); }
+            static vec sll(vec v, int n) { return _mm_sll_epi32(v, _mm_cvtsi32_si128(n)); }
+            static vec neg(vec v) { return _mm_sub_epi32(_mm_setzero_si128(), v); }
+            static vec band(vec a, vec b) { return _mm_and_si128(a, b); }
+            static vec bor(vec a, vec b) { return _mm_or_si128(a, b); }
+            static vec bxor(vec a, vec b) { return _mm_xor_si128(a, b); }
+            static vec add(vec a, vec b) { return _mm_add_epi32(a, b); }
+            // SSE2 has no 32-bit mullo, so the even and odd lanes are multiplied separately and interleaved back
+            static vec mul(vec a, vec b)
+            {
+                vec even = _mm_mul_epu32(a, b);
+                vec odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+                return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+            }
+        };
+
+        template <>
+        struct Lanes<uint64_t>
+        {
+            typedef __m128i vec;
+            static constexpr int width = 2;
+            static vec load(const uint64_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+            static void store(uint64_t* p, vec v) { _mm_storeu_si128((__m128i*)p, v); }
+            static vec set1(uint64_t x) { return _mm_set1_epi64x((long long)x); }
+            static vec srl(vec v, int n) { return _mm_srl_epi64(v, _mm_cvtsi32_si128(n)); }
+            static vec sll(vec v, int n) { return _mm_sll_epi64(v, _mm_cvtsi32_si128(n)); }
+            static vec neg(vec v) { return _mm_sub_epi64(_mm_setzero_si128(), v); }
+            static vec band(vec a, vec b) { return _mm_and_si128(a, b); }
+            static vec bor(vec a, vec b) { return _mm_or_si128(a, b); }
+            static vec bxor(vec a, vec b) { return _mm_xor_si128(a, b); }
+            static vec add(vec a, vec b) { return _mm_add_epi64(a, b); }
+            // Low 64 bits of the products, built from 32x32 -> 64 bit multiplies
+            static vec mul(vec a, vec b)
+            {
+                vec cross = _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(a, 32), b), _mm_mul_epu32(a, _mm_srli_epi64(b, 32)));
+                return _mm_add_epi64(_mm_mul_epu32(a, b), _mm_slli_epi64(cross, 32));
+            }
+        };
+#elif defined(DF_SIMD_NEON)
+        template <>
+        struct Lanes<uint32_t>
+        {
+            typedef uint32x4_t vec;
+            static constexpr int width = 4;
+            static vec load(const uint32_t* p) { return vld1q_u32((const ::uint32_t*)p); }
+            static void store(uint32_t* p, vec v) { vst1q_u32((::uint32_t*)p, v); }
+            static vec set1(uint32_t x) { return vdupq_n_u32(x); }
+            static vec srl(vec v, int n) { return vshlq_u32(v, vdupq_n_s32(-n)); }
+            static vec sll(vec v, int n) { return vshlq_u32(v, vdupq_n_s32(n)); }
+            static vec neg(vec v) { return vsubq_u32(vdupq_n_u32(0), v); }
+            static vec band(vec a, vec b) { return vandq_u32(a, b); }
+            static vec bor(vec a, vec b) { return vorrq_u32(a, b); }
+            static vec bxor(vec a, vec b) { return veorq_u32(a, b); }
+            static vec add(vec a, vec b) { return vaddq_u32(a, b); }
+            static vec mul(vec a, vec b) { return vmulq_u32(a, b); }
+        };
+
+        template <>
+        struct Lanes<uint64_t>
+        {
+            typedef uint64x2_t vec;
+            static constexpr int width = 2;
+            static vec load(const uint64_t* p) { return vld1q_u64((const ::uint64_t*)p); }
+            static void store(uint64_t* p, vec v) { vst1q_u64((::uint64_t*)p, v); }
+            static vec set1(uint64_t x) { return vdupq_n_u64(x); }
+            static vec srl(vec v, int n) { return vshlq_u64(v, vdupq_n_s64(-n)); }
+            static vec sll(vec v, int n) { return vshlq_u64(v, vdupq_n_s64(n)); }
+            static vec neg(vec v) { return vsubq_u64(vdupq_n_u64(0), v); }
+            static vec band(vec a, vec b) { return vandq_u64(a, b); }
+            static vec bor(vec a, vec b) { return vorrq_u64(a, b); }
+            static vec bxor(vec a, vec b) { return veorq_u64(a, b); }
+            static vec add(vec a, vec b) { return vaddq_u64(a, b); }
+            // Low 64 bits of the products, built from 32x32 -> 64 bit multiplies
+            static vec mul(vec a, vec b)
+            {
+                uint32x2_t al = vmovn_u64(a), ah = vshrn_n_u64(a, 32), bl = vmovn_u64(b), bh = vshrn_n_u64(b, 32);
+                uint64x2_t cross = vmlal_u32(vmull_u32(ah, bl), al, bh);
+                return vaddq_u64(vmull_u32(al, bl), vshlq_n_u64(cross, 32));
+            }
+        };
+#endif
+
+        // Elementary functions with the same spelling for real_t and vreal, so that a kernel written
+        // once as a template over the value type runs both on single values and on whole lanes
+        inline real_t exp(real_t x) { return ::exp(x); }
+        inline real_t log(real_t x) { return ::log(x); }
+        inline real_t log1p(real_t x) { return ::log1p(x); }
+        inline real_t sqrt(real_t x) { return ::sqrt(x); }
+        // min and max keep the operand order of the vector instructions, giving b when either is NaN
+        inline real_t min(real_t a, real_t b) { return (a < b) ? a : b; }
+        inline real_t max(real_t a, real_t b) { return (a > b) ? a : b; }
+        inline real_t select(bool c, real_t a, real_t b) { return c ? a : b; }
+
+#if defined(DF_SIMD_AVX2) || defined(DF_SIMD_SSE2) || (defined(DF_SIMD_NEON) && defined(__aarch64__))
+#define DF_SIMD_REAL
+        // vreal - lanes of real_t with the arithmetic operators, comparisons giving a vmask
+#if defined(DF_SIMD_AVX2)
+        struct vreal
+        {
+            typedef __m256d native;
+            static constexpr int width = 4;
+            native v;
+            vreal() {}
+            vreal(native v) : v(v) {}
+            vreal(real_t x) : v(_mm256_set1_pd(x)) {}
+            static vreal load(const real_t* p) { return _mm256_loadu_pd(p); }
+            void store(real_t* p) const { _mm256_storeu_pd(p, v); }
+        };
+        typedef __m256d vmask;
+
+        inline vreal operator+(vreal a, vreal b) { return _mm256_add_pd(a.v, b.v); }
+        inline vreal operator-(vreal a, vreal b) { return _mm256_sub_pd(a.v, b.v); }
+        inline vreal operator*(vreal a, vreal b) { return _mm256_mul_pd(a.v, b.v); }
+        inline vreal operator/(vreal a, vreal b) { return _mm256_div_pd(a.v, b.v); }
+        inline vmask operator<(vreal a, vreal b) { return _mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ); }
+        inline vmask operator>(vreal a, vreal b) { return _mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ); }
+        inline vreal select(vmask c, vreal a, vreal b) { return _mm256_blendv_pd(b.v, a.v, c); }
+        inline vreal min(vreal a, vreal b) { return _mm256_min_pd(a.v, b.v); }
+        inline vreal max(vreal a, vreal b) { return _mm256_max_pd(a.v, b.v); }
+        inline vreal sqrt(vreal a) { return _mm256_sqrt_pd(a.v); }
+        // Integer view of the bit patterns (64-bit lanes)
+        inline Lanes<uint64_t>::vec bits(vreal a) { return _mm256_castpd_si256(a.v); }
+        inline vreal from_bits(Lanes<uint64_t>::vec b) { return _mm256_castsi256_pd(b); }
+#elif defined(DF_SIMD_SSE2)
+        struct vreal
+        {
+            typedef __m128d native;
+            static constexpr int width = 2;
+            native v;
+            vreal() {}
+            vreal(native v) : v(v) {}
+            vreal(real_t x) : v(_mm_set1_pd(x)) {}
+            static vreal load(const real_t* p) { return _mm_loadu_pd(p); }
+            void store(real_t* p) const { _mm_storeu_pd(p, v); }
+        };
+        typedef __m128d vmask;
+
+        inline vreal operator+(vreal a, vreal b) { return _mm_add_pd(a.v, b.v); }
+        inline vreal operator-(vreal a, vreal b) { return _mm_sub_pd(a.v, b.v); }
+        inline vreal operator*(vreal a, vreal b) { return _mm_mul_pd(a.v, b.v); }
+        inline vreal operator/(vreal a, vreal b) { return _mm_div_pd(a.v, b.v); }
+        inline vmask operator<(vreal a, vreal b) { return _mm_cmplt_pd(a.v, b.v); }
+        inline vmask operator>(vreal a, vreal b) { return _mm_cmpgt_pd(a.v, b.v); }
+        inline vreal select(vmask c, vreal a, vreal b) { return _mm_or_pd(_mm_and_pd(c, a.v), _mm_andnot_pd(c, b.v)); }
+        inline vreal min(vreal a, vreal b) { return _mm_min_pd(a.v, b.v); }
+        inline vreal max(vreal a, vreal b) { return _mm_max_pd(a.v, b.v); }
+        inline vreal sqrt(vreal a) { return _mm_sqrt_pd(a.v); }
+        inline Lanes<uint64_t>::vec bits(vreal a) { return _mm_castpd_si128(a.v); }
+        inline vreal from_bits(Lanes<uint64_t>::vec b) { return _mm_castsi128_pd(b); }
+#else
+        struct vreal
+        {
+            typedef float64x2_t native;
+            static constexpr int width = 2;
+            native v;
+            vreal() {}
+            vreal(native v) : v(v) {}
+            vreal(real_t x) : v(vdupq_n_f64(x)) {}
+            static vreal load(const real_t* p) { return vld1q_f64(p); }
+            void store(real_t* p) const { vst1q_f64(p, v); }
+        };
+        typedef uint64x2_t vmask;
+
+        inline vreal operator+(vreal a, vreal b) { return vaddq_f64(a.v, b.v); }
+        inline vreal operator-(vreal a, vreal b) { return vsubq_f64(a.v, b.v); }
+        inline vreal operator*(vreal a, vreal b) { return vmulq_f64(a.v, b.v); }
+        inline vreal operator/(vreal a, vreal b) { return vdivq_f64(a.v, b.v); }
+        inline vmask operator<(vreal a, vreal b) { return vcltq_f64(a.v, b.v); }
+        inline vmask operator>(vreal a, vreal b) { return vcgtq_f64(a.v, b.v); }
+        inline vreal select(vmask c, vreal a, vreal b) { return vbslq_f64(c, a.v, b.v); }
+        inline vreal min(vreal a, vreal b) { return vminq_f64(a.v, b.v); }
+        inline vreal max(vreal a, vreal b) { return vmaxq_f64(a.v, b.v); }
+        inline vreal sqrt(vreal a) { return vsqrtq_f64(a.v); }
+        inline Lanes<uint64_t>::vec bits(vreal a) { return vreinterpretq_u64_f64(a.v); }
+        inline vreal from_bits(Lanes<uint64_t>::vec b) { return vreinterpretq_f64_u64(b); }
+#endif
+        inline vreal operator-(vreal a) { return vreal(0.0) - a; }
+        inline vreal& operator+=(vreal& a, vreal b) { return a = a + b; }
+        inline vreal& operator-=(vreal& a, vreal b) { return a = a - b; }
+        inline vreal& operator*=(vreal& a, vreal b) { return a = a * b; }
+
+        /// @brief Sum of the lanes, always added up in the same order
+        inline real_t sum(vreal a)
+        {
+            real_t l[vreal::width], s = 0;
+            a.store(l);
+            for (int i = 0; i < vreal::width; i++)
+                s += l[i];
+            return s;
+        }
+
+        /// @brief Clears the upper halves of the AVX registers, before scalar code calling the C library in the
+        /// middle of a vector loop: its SSE instructions would otherwise wait on those halves, call after call
+        inline void zero_upper()
+        {
+#if defined(DF_SIMD_AVX2)
+            _mm256_zeroupper();
+#endif
+        }
+
+        /// @brief e^x in every lane (within a couple of ulp), flushing to 0 below -708 and overflowing to infinity
+        /// @note x is split as n ln2 + r with |r| <= ln2 / 2; e^r is a degree 13 Taylor polynomial and 2^n is
+        /// assembled in the exponent field
+        inline vreal exp(vreal x)
+        {
+            typedef Lanes<uint64_t> U;
+            const vreal shifter(6755399441055744.0);         // 1.5 * 2^52, rounds to the nearest integer
+            vreal xc = min(max(x, vreal(-708.0)), vreal(709.78));
+            vreal t = xc * vreal(M_LOG2E) + shifter;
+            vreal n = t - shifter;
+            vreal r = xc - n * vreal(6.93145751953125e-1) - n * vreal(1.42860682030941723212e-6);
+
+            vreal p(1.0 / 6227020800.0);
+            const real_t inv_factorial[13] = {1.0 / 479001600.0, 1.0 / 39916800.0, 1.0 / 3628800.0, 1.0 / 362880.0,
+                                              1.0 / 40320.0, 1.0 / 5040.0, 1.0 / 720.0, 1.0 / 120.0, 1.0 / 24.0,
+                                              1.0 / 6.0, 0.5, 1.0, 1.0};
+            for (int k = 0; k < 13; k++)
+                p = p * r + vreal(inv_factorial[k]);
+
+            // the low bits of t hold n; 2^(n - 1) has the biased exponent n + 1022, which stays finite for n = 1024
+            U::vec e = U::sll(U::add(U::add(bits(t), U::set1(0ULL - 0x4338000000000000ULL)), U::set1(1022)), 52);
+            vreal y = p * from_bits(e) * vreal(2.0);
+            y = select(x > vreal(709.78), vreal(INFINITY), y);
+            return select(x < vreal(-708.0), vreal(0.0), y);
+        }
+
+        /// @brief Natural logarithm in every lane, for positive normal x
+        /// @note With x = 2^e m and m in [sqrt(1/2), sqrt(2)), log m = 2 atanh(s) for s = (m - 1) / (m + 1),
+        /// |s| < 0.172, summed to s^23
+        inline vreal log(vreal x)
+        {
+            typedef Lanes<uint64_t> U;
+            U::vec b = bits(x);
+            vreal m = from_bits(U::bor(U::band(b, U::set1(0x000FFFFFFFFFFFFFULL)), U::set1(0x3FF0000000000000ULL)));
+            // 2^52 + biased exponent, as a real
+            vreal e = from_bits(U::bor(U::srl(b, 52), U::set1(0x4330000000000000ULL))) - vreal(4503599627371519.0);
+            vmask big = m > vreal(M_SQRT2);
+            m = select(big, m * vreal(0.5), m);
+            e = select(big, e + vreal(1.0), e);
+
+            vreal s = (m - vreal(1.0)) / (m + vreal(1.0)), s2 = s * s;
+            vreal p(1.0 / 23);
+            for (int k = 21; k >= 1; k -= 2)
+                p = p * s2 + vreal(1.0 / k);
+            return e * vreal(6.93145751953125e-1) + (vreal(2.0) * s * p + e * vreal(1.42860682030941723212e-6));
+        }
+
+        /// @brief log(1 + x) in every lane, for x > -1 with 1 + x normal
+        /// @note The logarithm of w = 1 + x rounded, less the rounding error (w - 1) - x divided by w
+        inline vreal log1p(vreal x)
+        {
+            const vreal w = vreal(1.0) + x;
+            return log(w) - ((w - vreal(1.0)) - x) / w;
+        }
+#endif
+
+        /// @brief sin(2 pi x) and cos(2 pi x), for V = real_t or vreal (within a few ulp, for |x| < 2^51)
+        /// @note x is reduced to r in [-1/2, 1/2] by removing the nearest integer, so that the angles of uniform
+        /// variates need no range reduction in radians; sin and cos of pi r / 2, in [-pi/4, pi/4], are Taylor
+        /// polynomials of degree 17 and 16, and two doublings give those of 2 pi r
+        template <typename V>
+        inline void sincos_turn(V x, V& s, V& c)
+        {
+            const V shifter(6755399441055744.0);             // 1.5 * 2^52, rounds to the nearest integer
+            const V a = (x - ((x + shifter) - shifter)) * V(M_PI / 2), a2 = a * a;
+            // (-1)^k / (2k + 1)! and (-1)^k / (2k)!, from k = 8 down to 0
+            const real_t sin_terms[9] = {1.0 / 355687428096000.0, -1.0 / 1307674368000.0, 1.0 / 6227020800.0,
+                                         -1.0 / 39916800.0, 1.0 / 362880.0, -1.0 / 5040.0, 1.0 / 120.0, -1.0 / 6.0, 1.0};
+            const real_t cos_terms[9] = {1.0 / 20922789888000.0, -1.0 / 87178291200.0, 1.0 / 479001600.0,
+                                         -1.0 / 3628800.0, 1.0 / 40320.0, -1.0 / 720.0, 1.0 / 24.0, -0.5, 1.0};
+            V ps(sin_terms[0]), pc(cos_terms[0]);
+            for (int k = 1; k < 9; k++) {
+                ps = ps * a2 + V(sin_terms[k]);
+                pc = pc * a2 + V(cos_terms[k]);
+            }
+            s = ps * a;
+            c = pc;
+            for (int k = 0; k < 2; k++) {
+                const V s2 = V(2.0) * s * c;
+                c = (c - s) * (c + s);
+                s = s2;
+            }
+        }
+    }
+    }
+}
+
+#endif
@@ -0,0 +1,561 @@
+#include "special.h"
+#include "combinatorics.h"
+#include "simd.h"
+#include "dispatch.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace DiceForge
+{
+namespace special
+{
+#if defined(DF_DISPATCH_AVX2)
+    // The batch functions compiled for AVX2 and FMA
+    namespace avx2
+    {
+        void erf(const real_t* x, real_t* out, size_t n);
+        void erfc(const real_t* x, real_t* out, size_t n);
+        void normal_cdf(const real_t* z, real_t* out, size_t n);
+        void normal_quantile(const real_t* p, real_t* out, size_t n);
+    }
+#endif
+
+    DF_DISPATCH_BEGIN
+    namespace
+    {
+        // Polynomials sum a_k u^k in u = v * scale - shift, for
+        //   erf(x) / x             in v = x^2 for |x| < 1
+        //   erfc(x) e^(x^2)        in v = x on [0.5, 1], [1, 2], [2, 3.5] and [3.5, 6]
+        //   x erfc(x) e^(x^2)      in v = 1 / x^2 for x >= 6
+        // converted from Chebyshev expansions fitted in 90 digit arithmetic and cut off where the terms fall below
+        // 1e-19. The coefficients alternate and add up to less than twice the smallest value on |u| <= 1, so the
+        // power form loses nothing to cancellation and evaluates with more instruction-level parallelism.
+        constexpr int max_terms = 21;
+        struct polynomial_piece
+        {
+            real_t scale, shift;
+            int terms;
+            real_t a[max_terms];
+        };
+
+        constexpr polynomial_piece pieces[6] = {
+            {2.0, 1.0, 14,
+             {9.65468738669867265756e-01, -1.40536089022717108898e-01, 1.98524966889837076178e-02,
+              -2.28548556114406727080e-03, 2.17517156041601079268e-04, -1.75371694414920990313e-05,
+              1.22338273835240093022e-06, -7.51156916067813822249e-08, 4.11580059766495968551e-09,
+              -2.03524939202478536928e-10, 9.16760674606944502151e-12, -3.79109303927172170678e-13,
+              1.45481707596067904631e-14, -5.16606161680598076402e-16}},
+            {4.0, 3.0, 16,
+             {5.06937650293144859148e-01, -9.19931729139488452152e-02, 1.44348832219561434842e-02,
+              -2.02868846867001713721e-03, 2.60900556748306852728e-04, -3.11496699606254385173e-05,
+              3.48857389311855623390e-06, -3.69356219320466672692e-07, 3.71953940324303402631e-08,
+              -3.58013936662367072479e-09, 3.30687768670661627797e-10, -2.94100278501381327140e-11,
+              2.52492769854139230995e-12, -2.09877560325673482913e-13, 1.73366132943734678340e-14,
+              -1.35866642003184424488e-15}},
+            {2.0, 3.0, 18,
+             {3.21585416454317485346e-01, -8.18114588662800373831e-02, 1.90377599638693467687e-02,
+              -4.11636316244532850933e-03, 8.36083809566782153178e-04, -1.60811173374564883413e-04,
+              2.94708574524389269695e-05, -5.17132864357793881120e-06, 8.72304476034927648280e-07,
+              -1.41911958548499374912e-07, 2.23284128800710492717e-08, -3.40575474429394271400e-09,
+              5.04660297632011433416e-10, -7.27683737113064985099e-11, 1.01981701662763113800e-11,
+              -1.39881721619153167911e-12, 2.02921511637611651703e-13, -2.66418417346076753375e-14}},
+            {4.0 / 3, 11.0 / 3, 19,
+             {1.93662096279068690619e-01, -4.74282281704761290997e-02, 1.11142085553691104954e-02,
+              -2.50354880029600608549e-03, 5.44086455892283608199e-04, -1.14427153955736851947e-04,
+              2.33475421355103277498e-05, -4.63170526801472153986e-06, 8.95025082283777466692e-07,
+              -1.68743338498511473285e-07, 3.10837006828605971749e-08, -5.60142977778186391642e-09,
+              9.88592276073748777497e-10, -1.71088003486480988223e-10, 2.90484032109230475470e-11,
+              -4.80958588122338375960e-12, 7.87898324241981307008e-13, -1.43968632961225710827e-13,
+              2.28925370780666517761e-14}},
+            {0.8, 3.8, 21,
+             {1.16302707210247310843e-01, -2.93793107477039391884e-02, 7.28332245151928122512e-03,
+              -1.77363065826111705389e-03, 4.24629648536757001859e-04, -1.00023746138343778782e-04,
+              2.31976110472795492333e-05, -5.30036792854462928998e-06, 1.19383317248503706782e-06,
+              -2.65208980643889230314e-07, 5.81371971395507886844e-08, -1.25817235889070126760e-08,
+              2.68924424668368963677e-09, -5.67910833193717701787e-10, 1.18544257747461759847e-10,
+              -2.44941924363187033400e-11, 5.00076192420014874999e-12, -9.87956069176927902394e-13,
+              1.97192426586793410188e-13, -4.88127375048108068058e-14, 9.61698852074753442763e-15}},
+            {72.0, 1.0, 13,
+             {5.60350520556021081120e-01, -3.76272487307751420799e-03, 7.38713831321358106383e-05,
+              -2.35783333071174875607e-06, 1.02864657556038075170e-07, -5.63765510572339897647e-09,
+              3.69264968089351789595e-10, -2.79697016254181523095e-11, 2.39345157074314132656e-12,
+              -2.27233364577764864547e-13, 2.36441066421901805530e-14, -2.81354982296859576907e-15,
+              3.45171965870255511508e-16}}};
+
+        // erfc(x) is below the smallest subnormal from here on
+        constexpr real_t erfc_cutoff = 27.3;
+
+        // Estrin's scheme for sum a(k) u^k over lo <= k < lo + n, split in two halves of which the upper one is
+        // scaled by u^h (h the largest power of two below n, powers[j] = u^(2^j)), unrolled at compile time
+        template <int lo, int n, typename V, typename Coefficient>
+        V estrin(const V* powers, Coefficient a)
+        {
+            if constexpr (n == 1)
+                return V(a(lo));
+            else
+            {
+                constexpr int level = (n > 16) ? 4 : (n > 8) ? 3 : (n > 4) ? 2 : (n > 2) ? 1 : 0;
+                constexpr int h = 1 << level;
+                return estrin<lo, h>(powers, a) + powers[level] * estrin<lo + h, n - h>(powers, a);
+            }
+        }
+
+        template <int n, typename V, typename Coefficient>
+        V estrin(V u, Coefficient a)
+        {
+            static_assert(n <= 32, "the powers of u go up to u^16");
+            V powers[5] = {u};
+            for (int j = 1; j < 5; j++)
+                powers[j] = powers[j - 1] * powers[j - 1];
+            return estrin<0, n>(powers, a);
+        }
+
+        template <int i, typename V>
+        V piece(V v)
+        {
+            return estrin<pieces[i].terms>(v * pieces[i].scale - pieces[i].shift,
+                                           [](int k) { return pieces[i].a[k]; });
+        }
+
+        // Which expansion covers y >= 0: 0 (erf(y) / y) below `small`, which is 1 for erf and 1/2 for erfc, whose
+        // relative accuracy would suffer from 1 - erf(y) beyond; 1 to 5 (erfc(y) e^(y^2)) above. NaN gives 0.
+        int piece_index(real_t y, real_t small)
+        {
+            return (y < small) ? 0 : (y < 1) ? 1 : (y < 2) ? 2 : (y < 3.5) ? 3 : (y < 6) ? 4 : 5;
+        }
+
+        // The value of expansion i at y, in every lane
+        template <typename V>
+        V piece_value(int i, V y)
+        {
+            switch (i)
+            {
+            case 0:
+                return piece<0>(y * y);
+            case 1:
+                return piece<1>(y);
+            case 2:
+                return piece<2>(y);
+            case 3:
+                return piece<3>(y);
+            case 4:
+                return piece<4>(y);
+            default:
+                return piece<5>(V(1.0) / (y * y)) / y;
+            }
+        }
+
+        // e^(-scale y^2) for 0 <= y < 64 and scale 1 or 1/2: y = hi + lo with hi a multiple of 2^-20, so that
+        // hi^2 is exact and the rounding of y^2 (up to 4000 ulp of e^(-y^2) in the far tail) is avoided. The
+        // remaining factor e^(-scale lo (y + hi)), within 3e-5 of 1, is its cubic Taylor polynomial.
+        template <typename V>
+        V exp_minus_square(V y, real_t scale)
+        {
+            const V shifter(4294967296.0); // 2^32, whose ulp is 2^-20
+            V hi = (y + shifter) - shifter;
+            V t = (y - hi) * (y + hi) * -scale;
+            return simd::exp(hi * hi * -scale) * (V(1.0) + t * (V(1.0) + t * (V(0.5) + t * (1.0 / 6))));
+        }
+
+        // Horner's scheme, highest coefficient first
+        template <typename V, int N>
+        V polynomial(const real_t (&c)[N], V t)
+        {
+            V r(c[0]);
+            for (int k = 1; k < N; k++)
+                r = r * t + V(c[k]);
+            return r;
+        }
+
+        // Acklam's approximation of the normal quantile, in r = q - 1/2, r^2 below and t = sqrt(-2 log q) in the tail
+        constexpr real_t acklam_a[6] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                                        1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+        constexpr real_t acklam_b[6] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                                        6.680131188771972e+01, -1.328068155288572e+01, 1.0};
+        constexpr real_t acklam_c[6] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                                        -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+        constexpr real_t acklam_d[5] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                                        3.754408661907416e+00, 1.0};
+        constexpr real_t acklam_low = 0.02425;
+        constexpr real_t sqrt_2pi = 2.50662827463100050242;
+
+        // erf, erfc and normal_cdf in every lane of x, all the lanes falling in expansion k (see piece_index) of |x|,
+        // or of |z| / sqrt(2) for normal_cdf; on real_t they are the scalar functions
+        template <typename V>
+        V erf_kernel(int k, V x)
+        {
+            const V y = simd::min(V(erfc_cutoff), simd::max(x, -x));
+            const V f = piece_value(k, y);
+            if (k == 0)
+                return x * f;
+            const V tail = exp_minus_square(y, 1.0) * f;
+            return simd::select(x < V(0.0), tail - V(1.0), V(1.0) - tail);
+        }
+
+        template <typename V>
+        V erfc_kernel(int k, V x)
+        {
+            const V y = simd::min(V(erfc_cutoff), simd::max(x, -x));
+            const V f = piece_value(k, y);
+            if (k == 0)
+                return V(1.0) - x * f;
+            const V tail = exp_minus_square(y, 1.0) * f;
+            return simd::select(x < V(0.0), V(2.0) - tail, tail);
+        }
+
+        template <typename V>
+        V normal_cdf_kernel(int k, V z)
+        {
+            // 0.5 erfc(x), with e^(-x^2) taken as e^(-z^2 / 2) from z itself
+            const V x = z * -M_SQRT1_2;
+            const V y = simd::min(V(erfc_cutoff), simd::max(x, -x));
+            const V f = piece_value(k, y);
+            if (k == 0)
+                return V(0.5) - x * f * 0.5;
+            const V tail = exp_minus_square(simd::min(V(erfc_cutoff * M_SQRT2), simd::max(z, -z)), 0.5) * f * 0.5;
+            return simd::select(x < V(0.0), V(1.0) - tail, tail);
+        }
+
+        // Runs kernel(k, x) over the n values, a vector at a time where all the lanes fall in the same expansion k
+        // of |x| * scale and lane by lane elsewhere (out may be x)
+        template <typename Kernel>
+        void apply(Kernel kernel, real_t scale, real_t small, const real_t* x, real_t* out, size_t n)
+        {
+            size_t i = 0;
+#if defined(DF_SIMD_REAL)
+            typedef simd::vreal V;
+            for (; i + V::width <= n; i += V::width)
+            {
+                int k[V::width];
+                bool same = true;
+                for (int j = 0; j < V::width; j++)
+                {
+                    k[j] = piece_index(std::fabs(x[i + j]) * scale, small);
+                    same = same && k[j] == k[0];
+                }
+                if (same)
+                    kernel(k[0], V::load(x + i)).store(out + i);
+                else
+                {
+                    simd::zero_upper();
+                    for (int j = 0; j < V::width; j++)
+                        out[i + j] = kernel(k[j], x[i + j]);
+                }
+            }
+#endif
+            for (; i < n; i++)
+                out[i] = kernel(piece_index(std::fabs(x[i]) * scale, small), x[i]);
+        }
+
+        // Acklam's guess for the lower tail probability q <= 1/2, in the tail and in the middle
+        template <typename V>
+        V acklam_tail(V q)
+        {
+            const V t = simd::sqrt(simd::log(q) * -2.0);
+            return polynomial(acklam_c, t) / polynomial(acklam_d, t);
+        }
+
+        template <typename V>
+        V acklam_central(V q)
+        {
+            const V r = q - V(0.5);
+            return polynomial(acklam_a, r * r) * r / polynomial(acklam_b, r * r);
+        }
+
+        // Halley's step on normal_cdf(x) = q, from c = normal_cdf(x)
+        template <typename V>
+        V halley(V x, V q, V c)
+        {
+            const V u = (c - q) * sqrt_2pi * simd::exp(x * x * 0.5);
+            return x - u / (V(1.0) + x * u * 0.5);
+        }
+
+#if !defined(DF_DISPATCH_VARIANT)
+        /* Incomplete gamma and beta functions */
+
+        constexpr real_t epsilon = std::numeric_limits<real_t>::epsilon();
+        constexpr real_t tiny = 1e-300;
+        constexpr int max_iterations = 10000000;
+
+        // log Gamma(a) - ((a - 1/2) log a - a + log(2 pi) / 2), the error of Stirling's formula for real a > 0
+        real_t log_gamma_error(real_t a)
+        {
+            if (a < 10)
+                return std::lgamma(a) - ((a - 0.5) * std::log(a) - a + detail::half_log_2pi);
+            const real_t r = 1 / a, r2 = r * r;
+            return r * (1.0 / 12 - r2 * (1.0 / 360 - r2 * (1.0 / 1260 - r2 * (1.0 / 1680 - r2 * (1.0 / 1188
+                   - r2 * (691.0 / 360360))))));
+        }
+
+        // a log(y / a), through log1p when y is close to a
+        real_t log_ratio(real_t a, real_t y)
+        {
+            const real_t t = (y - a) / a;
+            return a * ((std::fabs(t) < 0.5) ? std::log1p(t) : std::log(y / a));
+        }
+
+        // log(x^a e^-x / Gamma(a)) = a log(x / a) - (x - a) + log(a) / 2 - log(2 pi) / 2 - log_gamma_error(a)
+        real_t log_gamma_front(real_t a, real_t x)
+        {
+            const real_t t = (x - a) / a;
+            const real_t l = (std::fabs(t) < 0.5) ? a * (std::log1p(t) - t) : a * std::log(x / a) - (x - a);
+            return l + 0.5 * std::log(a) - detail::half_log_2pi - log_gamma_error(a);
+        }
+
+        // P(a, x) by the power series x^a e^-x / Gamma(a) sum x^n / (a (a + 1) ... (a + n))
+        real_t gamma_series(real_t a, real_t x)
+        {
+            real_t term = 1 / a, sum = term;
+            for (int n = 1; n < max_iterations; n++)
+            {
+                term *= x / (a + n);
+                sum += term;
+                if (term < sum * epsilon)
+                    break;
+            }
+            return sum * std::exp(log_gamma_front(a, x));
+        }
+
+        // Q(a, x) by its continued fraction (modified Lentz), for x >= a + 1
+        real_t gamma_fraction(real_t a, real_t x)
+        {
+            real_t b = x + 1 - a, c = 1 / tiny, d = 1 / b, h = d;
+            for (int i = 1; i < max_iterations; i++)
+            {
+                real_t an = -i * (i - a);
+                b += 2;
+                d = an * d + b;
+                if (std::fabs(d) < tiny)
+                    d = tiny;
+                c = b + an / c;
+                if (std::fabs(c) < tiny)
+                    c = tiny;
+                d = 1 / d;
+                real_t delta = d * c;
+                h *= delta;
+                if (std::fabs(delta - 1) < epsilon)
+                    break;
+            }
+            return h * std::exp(log_gamma_front(a, x));
+        }
+
+        // Continued fraction of I_x(a, b) (modified Lentz), without the prefactor x^a (1-x)^b / (a B(a, b))
+        real_t beta_fraction(real_t a, real_t b, real_t x)
+        {
+            real_t c = 1, d = 1 - (a + b) * x / (a + 1);
+            if (std::fabs(d) < tiny)
+                d = tiny;
+            d = 1 / d;
+            real_t h = d;
+            for (int m = 1; m < max_iterations; m++)
+            {
+                real_t m2 = 2 * m;
+                real_t t = m * (b - m) * x / ((a + m2 - 1) * (a + m2));
+                d = 1 + t * d;
+                if (std::fabs(d) < tiny)
+                    d = tiny;
+                c = 1 + t / c;
+                if (std::fabs(c) < tiny)
+                    c = tiny;
+                d = 1 / d;
+                h *= d * c;
+                t = -(a + m) * (a + b + m) * x / ((a + m2) * (a + m2 + 1));
+                d = 1 + t * d;
+                if (std::fabs(d) < tiny)
+                    d = tiny;
+                c = 1 + t / c;
+                if (std::fabs(c) < tiny)
+                    c = tiny;
+                d = 1 / d;
+                real_t delta = d * c;
+                h *= delta;
+                if (std::fabs(delta - 1) < epsilon)
+                    break;
+            }
+            return h;
+        }
+
+        // log(x^a (1-x)^b / B(a, b)), with log B(a, b) from Stirling's formula as in log_gamma_front
+        real_t log_beta_front(real_t a, real_t b, real_t x)
+        {
+            const real_t c = a + b;
+            return log_ratio(a, x * c) + log_ratio(b, (1 - x) * c) + 0.5 * std::log(a * b / c) - detail::half_log_2pi
+                   - log_gamma_error(a) - log_gamma_error(b) + log_gamma_error(c);
+        }
+#endif
+    }
+
+#if !defined(DF_DISPATCH_VARIANT)
+    real_t erf(real_t x)
+    {
+        return erf_kernel(piece_index(std::fabs(x), 1.0), x);
+    }
+
+    real_t erfc(real_t x)
+    {
+        return erfc_kernel(piece_index(std::fabs(x), 0.5), x);
+    }
+
+    real_t normal_cdf(real_t z)
+    {
+        return normal_cdf_kernel(piece_index(std::fabs(z) * M_SQRT1_2, 0.5), z);
+    }
+
+    real_t normal_quantile(real_t p)
+    {
+        if (!(p > 0 && p < 1))
+            return (p == 0) ? -INFINITY : (p == 1) ? INFINITY : NAN;
+        // the lower tail probability, 1 - p being exact for p >= 1/2
+        const real_t q = std::min(p, 1 - p);
+        real_t x = (q < acklam_low) ? acklam_tail(q) : acklam_central(q);
+        const real_t r = halley(x, q, normal_cdf(x));
+        if (std::isfinite(r))
+            x = r;
+        return (p > 0.5) ? -x : x;
+    }
+#endif
+
+    void erf(const real_t* x, real_t* out, size_t n)
+    {
+        DF_DISPATCH(erf(x, out, n));
+        apply([](int k, auto v) { return erf_kernel(k, v); }, 1.0, 1.0, x, out, n);
+    }
+
+    void erfc(const real_t* x, real_t* out, size_t n)
+    {
+        DF_DISPATCH(erfc(x, out, n));
+        apply([](int k, auto v) { return erfc_kernel(k, v); }, 1.0, 0.5, x, out, n);
+    }
+
+    void normal_cdf(const real_t* z, real_t* out, size_t n)
+    {
+        DF_DISPATCH(normal_cdf(z, out, n));
+        apply([](int k, auto v) { return normal_cdf_kernel(k, v); }, M_SQRT1_2, 0.5, z, out, n);
+    }
+
+    void normal_quantile(const real_t* p, real_t* out, size_t n)
+    {
+        DF_DISPATCH(normal_quantile(p, out, n));
+        // In blocks: the initial guesses, then their normal_cdf in one batch, then the Halley steps
+        constexpr size_t block = 64;
+        constexpr real_t smallest = std::numeric_limits<real_t>::min();
+        real_t pb[block], q[block], x[block], c[block];
+        for (size_t i = 0; i < n; i += block)
+        {
+            const size_t m = (n - i < block) ? n - i : block;
+            for (size_t j = 0; j < m; j++)
+            {
+                pb[j] = p[i + j];
+                // everything outside [smallest normal, 1) gets a harmless stand-in and is redone at the end
+                q[j] = (pb[j] >= smallest && pb[j] < 1) ? ((pb[j] < 0.5) ? pb[j] : 1 - pb[j]) : 0.5;
+            }
+            size_t j = 0;
+#if defined(DF_SIMD_REAL)
+            typedef simd::vreal V;
+            for (; j + V::width <= m; j += V::width)
+            {
+                const V qv = V::load(q + j);
+                simd::select(qv < V(acklam_low), acklam_tail(qv), acklam_central(qv)).store(x + j);
+            }
+#endif
+            for (; j < m; j++)
+                x[j] = (q[j] < acklam_low) ? acklam_tail(q[j]) : acklam_central(q[j]);
+
+            normal_cdf(x, c, m);
+            j = 0;
+#if defined(DF_SIMD_REAL)
+            for (; j + V::width <= m; j += V::width)
+                halley(V::load(x + j), V::load(q + j), V::load(c + j)).store(x + j);
+#endif
+            for (; j < m; j++)
+                x[j] = halley(x[j], q[j], c[j]);
+
+            for (j = 0; j < m; j++)
+                out[i + j] = (pb[j] >= smallest && pb[j] < 1)
+                             ? ((pb[j] > 0.5) ? -x[j] : x[j]) : special::normal_quantile(pb[j]);
+        }
+    }
+
+#if !defined(DF_DISPATCH_VARIANT)
+
+    real_t gamma_p(real_t a, real_t x)
+    {
+        if (!(a > 0 && x >= 0))
+            return NAN;
+        if (x == 0)
+            return 0;
+        if (std::isinf(x))
+            return 1;
+        return (x < a + 1) ? gamma_series(a, x) : 1 - gamma_fraction(a, x);
+    }
+
+    real_t gamma_q(real_t a, real_t x)
+    {
+        if (!(a > 0 && x >= 0))
+            return NAN;
+        if (x == 0)
+            return 1;
+        if (std::isinf(x))
+            return 0;
+        return (x < a + 1) ? 1 - gamma_series(a, x) : gamma_fraction(a, x);
+    }
+
+    real_t gamma_p_inverse(real_t a, real_t p)
+    {
+        if (!(a > 0 && p >= 0 && p <= 1))
+            return NAN;
+        if (p == 0)
+            return 0;
+        if (p == 1)
+            return INFINITY;
+        real_t x;
+        if (a > 1)
+        {
+            // a (1 - 1/(9a) + z / (3 sqrt(a)))^3, or x^a / Gamma(a + 1) = p far in the lower tail
+            const real_t w = 1 - 1 / (9 * a) + normal_quantile(p) / (3 * std::sqrt(a));
+            x = (w > 0) ? a * w * w * w : std::exp((std::log(p) + std::lgamma(a + 1)) / a);
+        }
+        else
+        {
+            const real_t t = 1 - a * (0.253 + a * 0.12);
+            x = (p < t) ? std::pow(p / t, 1 / a) : 1 - std::log1p(-(p - t) / (1 - t));
+        }
+        // 1 - p is exact above the median
+        const bool upper = p > 0.5;
+        const real_t q = 1 - p;
+        for (int i = 0; i < 32; i++)
+        {
+            const real_t f = upper ? q - gamma_q(a, x) : gamma_p(a, x) - p;
+            const real_t density = std::exp(log_gamma_front(a, x)) / x;
+            if (!(density > 0))
+                break;
+            const real_t u = f / density;
+            real_t next = x - u / (1 - 0.5 * std::min(real_t(1), u * ((a - 1) / x - 1)));
+            if (!(next > 0))
+                next = x / 2;
+            const bool done = std::fabs(next - x) <= 4 * epsilon * next;
+            x = next;
+            if (done)
+                break;
+        }
+        return x;
+    }
+
+    real_t beta_inc(real_t a, real_t b, real_t x)
+    {
+        if (!(a > 0 && b > 0 && x >= 0 && x <= 1))
+            return NAN;
+        if (x == 0)
+            return 0;
+        if (x == 1)
+            return 1;
+        const real_t front = std::exp(log_beta_front(a, b, x));
+        if (x < (a + 1) / (a + b + 2))
+            return front * beta_fraction(a, b, x) / a;
+        return 1 - front * beta_fraction(b, a, 1 - x) / b;
+    }
+#endif
+    DF_DISPATCH_END
+}
+}
@@ -0,0 +1,67 @@
+#ifndef DF_SPECIAL_H
+#define DF_SPECIAL_H
+
+#include <cstddef>
+
+#include "types.h"
+
+namespace DiceForge
+{
+    /* Special functions behind the cumulative distribution functions, accurate to a few ulp */
+
+    namespace special
+    {
+        /// @brief The error function erf(x)
+        /// @note Polynomial fits of erf(x) / x for |x| < 1 and of erfc(x) e^(x^2) on [0.5, 1], [1, 2], [2, 3.5],
+        /// [3.5, 6] and in 1 / x^2 beyond (erfc switching over at 0.5), with e^(-x^2) computed from x split in two
+        /// halves, so that the tails keep their relative accuracy down to the smallest subnormal
+        real_t erf(real_t x);
+        /// @brief The complementary error function erfc(x) = 1 - erf(x), without the cancellation of the difference
+        real_t erfc(real_t x);
+        /// @brief Standard normal cumulative distribution function, P(Z <= z)
+        /// @note 0.5 erfc(-z / sqrt(2)), with e^(-z^2 / 2) taken from z itself to keep the lower tail accurate
+        real_t normal_cdf(real_t z);
+        /// @brief Inverse of normal_cdf: the z with P(Z <= z) = p, -infinity for p = 0 and infinity for p = 1
+        /// @note Acklam's rational approximation (relative error 1.15e-9) polished by one Halley step on normal_cdf
+        real_t normal_quantile(real_t p);
+
+        /// @brief erf of n values, out[i] = erf(x[i]) (out may be x)
+        /// @note A vector of values is evaluated at once when all of them fall in the same piece of the fit, as is
+        /// usual for sorted or clustered data, and one by one otherwise; results agree with the scalar function to
+        /// an ulp or two, but underflow to 0 below the smallest normal
+        void erf(const real_t* x, real_t* out, size_t n);
+        /// @brief erfc of n values, out[i] = erfc(x[i]) (out may be x), vectorised as erf
+        void erfc(const real_t* x, real_t* out, size_t n);
+        /// @brief normal_cdf of n values, out[i] = normal_cdf(z[i]) (out may be z), vectorised as erf
+        void normal_cdf(const real_t* z, real_t* out, size_t n);
+        /// @brief normal_quantile of n values, out[i] = normal_quantile(p[i]) (out may be p), vectorised as erf
+        void normal_quantile(const real_t* p, real_t* out, size_t n);
+
+        /// @brief Regularized lower incomplete gamma function P(a, x) = (1 / Gamma(a)) int_0^x t^(a-1) e^-t dt
+        /// @param a shape, positive
+        /// @param x upper limit, non-negative
+        /// @return P(a, x), or NaN outside the domain
+        /// @note The power series below x = a + 1 and the continued fraction of Q(a, x) above, both of which take on
+        /// the order of sqrt(a) terms near x = a. The prefactor x^a e^-x / Gamma(a) is built from Stirling's series
+        /// in (x - a) / a, so large shapes (e.g. the Poisson CDF of a large mean) do not lose digits to log Gamma.
+        real_t gamma_p(real_t a, real_t x);
+        /// @brief Regularized upper incomplete gamma function Q(a, x) = 1 - P(a, x), without the cancellation
+        real_t gamma_q(real_t a, real_t x);
+        /// @brief Inverse of gamma_p in x: the x with P(a, x) = p, 0 for p = 0 and infinity for p = 1
+        /// @param a shape, positive
+        /// @param p probability, in [0, 1]
+        /// @return x, or NaN outside the domain
+        /// @note Wilson and Hilferty's normal approximation (or the leading terms of the tails for a <= 1) polished
+        /// by Halley's method on P, or on Q above the median so that the upper tail keeps its relative accuracy
+        real_t gamma_p_inverse(real_t a, real_t p);
+        /// @brief Regularized incomplete beta function I_x(a, b)
+        /// @param a, b shapes, positive
+        /// @param x in [0, 1]
+        /// @return I_x(a, b), or NaN outside the domain
+        /// @note The continued fraction (modified Lentz) in x or in 1 - x, whichever converges faster, with the
+        /// prefactor x^a (1-x)^b / B(a, b) built from Stirling's series as in gamma_p
+        real_t beta_inc(real_t a, real_t b, real_t x);
+    }
+}
+
+#endif
@@ -0,0 +1,227 @@
+#ifndef DF_STATE_H
+#define DF_STATE_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include "types.h"
+
+namespace DiceForge
+{
+    namespace detail
+    {
+        // Saved states start with the magic "DFst", the version of the format and the length of the payload (4 bytes)
+        constexpr unsigned char state_magic[4] = {'D', 'F', 's', 't'};
+        constexpr unsigned char state_version = 1;
+        constexpr size_t state_header = 9;
+        // Reading a stream, the payload grows by at most this much per read, so that a corrupt length asks for no
+        // more memory than the stream holds
+        constexpr size_t state_chunk = 1 << 16;
+
+        /// @brief Appends the fields of a saved state to a byte buffer, integers in little-endian order
+        class StateWriter
+        {
+        private:
+            std::vector<unsigned char>& out;
+        public:
+            explicit StateWriter(std::vector<unsigned char>& out) : out(out) {}
+            /// @brief Appends an unsigned integer (or a real, by its bits)
+            template <typename U>
+            void put(U x)
+            {
+                if constexpr (std::is_floating_point<U>::value) {
+                    uint64_t bits;
+                    static_assert(sizeof(U) <= sizeof(bits), "Expected a float or a double");
+                    double d = double(x);
+                    std::memcpy(&bits, &d, sizeof(bits));
+                    put(bits);
+                }
+                else {
+                    static_assert(std::is_unsigned<U>::value, "Expected an unsigned integer");
+                    for (size_t b = 0; b < sizeof(U); b++)
+                        out.push_back((unsigned char)(x >> (8 * b)));
+                }
+            }
+            /// @brief Appends n values
+            template <typename U>
+            void put(const U* x, size_t n)
+            {
+                for (size_t i = 0; i < n; i++)
+                    put(x[i]);
+            }
+            /// @brief Appends raw bytes, preceded by their number
+            void bytes(const unsigned char* data, size_t n)
+            {
+                put(uint32_t(n));
+                out.insert(out.end(), data, data + n);
+            }
+            /// @brief Appends the name of the saved object, which load_state checks before anything else
+            void tag(const char* name)
+            {
+                const size_t n = std::strlen(name);
+                put((unsigned char)(n));
+                out.insert(out.end(), name, name + n);
+            }
+        };
+
+        /// @brief Reads back the fields appended by a StateWriter, throwing std::invalid_argument past the end
+        class StateReader
+        {
+        private:
+            const unsigned char* data;
+            size_t size, position = 0;
+            const unsigned char* take(size_t n)
+            {
+                if (n > size - position)
+                    throw std::invalid_argument("The saved state is truncated");
+                position += n;
+                return data + position - n;
+            }
+        public:
+            StateReader(const unsigned char* data, size_t size) : data(data), size(size) {}
+            /// @brief Reads an unsigned integer (or a real)
+            template <typename U>
+            U get()
+            {
+                if constexpr (std::is_floating_point<U>::value) {
+                    const uint64_t bits = get<uint64_t>();
+                    double d;
+                    std::memcpy(&d, &bits, sizeof(d));
+                    return U(d);
+                }
+                else {
+                    const unsigned char* p = take(sizeof(U));
+                    U x = 0;
+                    for (size_t b = 0; b < sizeof(U); b++)
+                        x |= U(p[b]) << (8 * b);
+                    return x;
+                }
+            }
+            /// @brief Reads n values
+            template <typename U>
+            void get(U* x, size_t n)
+            {
+                for (size_t i = 0; i < n; i++)
+                    x[i] = get<U>();
+            }
+            /// @brief Reads an integer and throws unless it is the expected one (a size or a parameter of the type)
+            template <typename U>
+            void expect(U x)
+            {
+                if (get<U>() != x)
+                    throw std::invalid_argument("The saved state does not fit this object");
+            }
+            /// @brief Reads raw bytes written by StateWriter::bytes, returns their number
+            size_t bytes(const unsigned char*& out)
+            {
+                const size_t n = get<uint32_t>();
+                out = take(n);
+                return n;
+            }
+            /// @brief Reads the name of the saved object and throws unless it is the given one
+            void tag(const char* name)
+            {
+                const size_t n = get<unsigned char>();
+                if (n != std::strlen(name) || std::memcmp(take(n), name, n) != 0)
+                    throw std::invalid_argument(std::string("The saved state is not that of a ") + name);
+            }
+            /// @brief Number of bytes not read yet
+            size_t remaining() const
+            {
+                return size - position;
+            }
+            /// @brief Throws unless the whole payload has been read, for read_state to call before it changes anything
+            void end() const
+            {
+                if (position != size)
+                    throw std::invalid_argument("The saved state does not fit this object");
+            }
+        };
+    }
+
+    /// @brief DiceForge::Serializable<Derived> - Saves and restores the state of an object in a compact binary format
+    /// @tparam Derived class providing write_state(detail::StateWriter&) const and read_state(detail::StateReader&)
+    /// (it must declare Serializable<Derived> as a friend), which reads every field into temporaries and calls
+    /// in.end() before changing the object
+    /// @note A saved state is the magic "DFst", a version byte, the length of the payload and the payload: the name
+    /// of the object followed by its fields, integers in little-endian order, so it can be restored on any machine.
+    template <typename Derived>
+    class Serializable
+    {
+    public:
+        /// @brief Returns the state of the object
+        std::vector<unsigned char> save_state() const
+        {
+            std::vector<unsigned char> out(std::begin(detail::state_magic), std::end(detail::state_magic));
+            out.push_back(detail::state_version);
+            out.resize(detail::state_header);
+            detail::StateWriter writer(out);
+            static_cast<const Derived&>(*this).write_state(writer);
+            const size_t n = out.size() - detail::state_header;
+            for (size_t b = 0; b < 4; b++)
+                out[5 + b] = (unsigned char)(n >> (8 * b));
+            return out;
+        }
+        /// @brief Writes the state of the object to the stream
+        void save_state(std::ostream& out) const
+        {
+            const std::vector<unsigned char> state = save_state();
+            out.write(reinterpret_cast<const char*>(state.data()), std::streamsize(state.size()));
+        }
+        /// @brief Restores a state returned by save_state()
+        /// @note Throws std::invalid_argument if the bytes are not a state of the same kind of object (with the same
+        /// sizes), the object being left as it was
+        void load_state(const unsigned char* data, size_t size)
+        {
+            if (size < detail::state_header || payload(data) != size - detail::state_header)
+                throw std::invalid_argument("The saved state is truncated");
+            detail::StateReader reader(data + detail::state_header, size - detail::state_header);
+            static_cast<Derived&>(*this).read_state(reader);
+            if (reader.remaining() != 0)
+                throw std::invalid_argument("The saved state does not fit this object");
+        }
+        /// @brief Restores a state returned by save_state()
+        void load_state(const std::vector<unsigned char>& state)
+        {
+            load_state(state.data(), state.size());
+        }
+        /// @brief Reads a state written by save_state(std::ostream&) from the stream and restores it
+        void load_state(std::istream& in)
+        {
+            std::vector<unsigned char> state(detail::state_header);
+            if (!in.read(reinterpret_cast<char*>(state.data()), std::streamsize(state.size())))
+                throw std::invalid_argument("The saved state is truncated");
+            for (size_t left = payload(state.data()); left > 0;)
+            {
+                const size_t at = state.size(), n = (left < detail::state_chunk) ? left : detail::state_chunk;
+                state.resize(at + n);
+                if (!in.read(reinterpret_cast<char*>(state.data() + at), std::streamsize(n)))
+                    throw std::invalid_argument("The saved state is truncated");
+                left -= n;
+            }
+            load_state(state.data(), state.size());
+        }
+    protected:
+        ~Serializable() = default;
+    private:
+        // Checks the magic and the version, returns the length of the payload
+        static size_t payload(const unsigned char* header)
+        {
+            if (std::memcmp(header, detail::state_magic, 4) != 0)
+                throw std::invalid_argument("Expected a state saved by DiceForge");
+            if (header[4] != detail::state_version)
+                throw std::invalid_argument("The saved state is of an unknown version");
+            size_t n = 0;
+            for (size_t b = 0; b < 4; b++)
+                n |= size_t(header[5 + b]) << (8 * b);
+            return n;
+        }
+    };
+}
+
+#endif
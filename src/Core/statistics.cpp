@@ -0,0 +1,451 @@
+#include "statistics.h"
+#include "special.h"
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace DiceForge
+{
+    namespace
+    {
+        // Values per block of Moments::add, merged into the totals one block at a time
+        constexpr size_t moments_block = 1024;
+
+        // Pearson's statistic over the cells (below lo, the bins, above hi) given P(X < edge) at the edges,
+        // pooling neighbouring cells until each expects at least 5 values
+        TestResult pearson(const std::vector<uint64_t>& counts, uint64_t below, uint64_t above,
+                           const std::vector<real_t>& edges, size_t fitted)
+        {
+            uint64_t n = below + above;
+            for (uint64_t c : counts)
+                n += c;
+            const real_t total = real_t(n);
+            const size_t cells = counts.size() + 2;
+            real_t statistic = 0, observed = 0, expected = 0, last_observed = 0, last_expected = 0;
+            size_t groups = 0;
+            bool impossible = false;
+            for (size_t i = 0; i < cells; i++)
+            {
+                const real_t o = real_t(i == 0 ? below : (i == cells - 1 ? above : counts[i - 1]));
+                const real_t p = (i == 0) ? edges.front() : (i == cells - 1 ? 1 - edges.back() : edges[i] - edges[i - 1]);
+                const real_t e = total * std::max(real_t(0), p);
+                impossible = impossible || (e == 0 && o > 0);
+                observed += o;
+                expected += e;
+                if (expected >= 5)
+                {
+                    statistic += (observed - expected) * (observed - expected) / expected;
+                    last_observed = observed;
+                    last_expected = expected;
+                    groups++;
+                    observed = expected = 0;
+                }
+            }
+            // What is left joins the last group
+            if (expected > 0 || observed > 0)
+            {
+                if (groups > 0)
+                {
+                    statistic -= (last_observed - last_expected) * (last_observed - last_expected) / last_expected;
+                    observed += last_observed;
+                    expected += last_expected;
+                }
+                else
+                    groups = 1;
+                statistic += (expected > 0) ? (observed - expected) * (observed - expected) / expected : 0;
+            }
+            TestResult result;
+            result.dof = (groups > 1 + fitted) ? groups - 1 - fitted : 0;
+            if (impossible)
+            {
+                result.statistic = std::numeric_limits<real_t>::infinity();
+                result.p_value = 0;
+            }
+            else
+            {
+                result.statistic = statistic;
+                result.p_value = (result.dof > 0) ? special::gamma_q(real_t(result.dof) / 2, statistic / 2)
+                                                  : std::numeric_limits<real_t>::quiet_NaN();
+            }
+            return result;
+        }
+
+        // Kolmogorov's distribution, P(K > lambda), by whichever of its two series converges faster
+        real_t kolmogorov_q(real_t lambda)
+        {
+            if (lambda <= 0)
+                return 1;
+            const real_t pi = 3.14159265358979323846;
+            real_t sum = 0;
+            if (lambda < 1.18)
+            {
+                const real_t a = -pi * pi / (8 * lambda * lambda);
+                for (int k = 1; k < 20; k += 2)
+                    sum += std::exp(a * k * k);
+                return std::min(real_t(1), std::max(real_t(0), 1 - std::sqrt(2 * pi) / lambda * sum));
+            }
+            for (int k = 1; k < 100; k++)
+            {
+                const real_t term = std::exp(-2 * k * k * lambda * lambda);
+                sum += (k % 2 == 1) ? term : -term;
+                if (term < 1e-17)
+                    break;
+            }
+            return std::min(real_t(1), std::max(real_t(0), 2 * sum));
+        }
+
+        // Largest distance between the empirical and the hypothesised P(X < edge) over the edges
+        TestResult kolmogorov(const std::vector<uint64_t>& counts, uint64_t below, uint64_t above,
+                              const std::vector<real_t>& edges)
+        {
+            uint64_t total = below + above;
+            for (uint64_t c : counts)
+                total += c;
+            uint64_t cumulative = below;
+            real_t d = std::abs(real_t(cumulative) / real_t(total) - edges[0]);
+            for (size_t i = 0; i < counts.size(); i++)
+            {
+                cumulative += counts[i];
+                d = std::max(d, std::abs(real_t(cumulative) / real_t(total) - edges[i + 1]));
+            }
+            const real_t root = std::sqrt(real_t(total));
+            return {d, kolmogorov_q((root + 0.12 + 0.11 / root) * d), 0};
+        }
+    }
+
+    /* Moments */
+
+    void Moments::merge(uint64_t count, real_t mean, real_t c2, real_t c3, real_t c4, real_t total, real_t lo,
+                        real_t hi)
+    {
+        if (count == 0)
+            return;
+        if (n == 0)
+        {
+            n = count;
+            m1 = mean;
+            m2 = c2;
+            m3 = c3;
+            m4 = c4;
+            sum = total;
+            compensation = 0;
+            low = lo;
+            high = hi;
+            return;
+        }
+        // Chan et al. for the mean and m2, Pébay for the higher moments
+        const real_t na = real_t(n), nb = real_t(count), nt = na + nb;
+        const real_t d = mean - m1, dn = d / nt;
+        m4 += c4 + d * dn * dn * dn * na * nb * (na * na - na * nb + nb * nb) + 6 * dn * dn * (na * na * c2 + nb * nb * m2)
+              + 4 * dn * (na * c3 - nb * m3);
+        m3 += c3 + d * dn * dn * na * nb * (na - nb) + 3 * dn * (na * c2 - nb * m2);
+        m2 += c2 + d * dn * na * nb;
+        m1 += dn * nb;
+        n += count;
+        // Neumaier's compensated sum
+        const real_t t = sum + total;
+        compensation += (std::abs(sum) >= std::abs(total)) ? (sum - t) + total : (total - t) + sum;
+        sum = t;
+        low = std::min(low, lo);
+        high = std::max(high, hi);
+    }
+
+    void Moments::add(real_t x)
+    {
+        merge(1, x, 0, 0, 0, x, x, x);
+    }
+
+    void Moments::add(const real_t* x, size_t count)
+    {
+        for (size_t begin = 0; begin < count; begin += moments_block)
+        {
+            const size_t m = std::min(moments_block, count - begin);
+            const real_t* b = x + begin;
+            // Four partial sums, so the passes are not held up by the latency of the additions
+            real_t s[4] = {0, 0, 0, 0};
+            real_t lo = b[0], hi = b[0];
+            size_t i = 0;
+            for (; i + 4 <= m; i += 4)
+                for (int j = 0; j < 4; j++)
+                {
+                    s[j] += b[i + j];
+                    lo = std::min(lo, b[i + j]);
+                    hi = std::max(hi, b[i + j]);
+                }
+            for (; i < m; i++)
+            {
+                s[0] += b[i];
+                lo = std::min(lo, b[i]);
+                hi = std::max(hi, b[i]);
+            }
+            const real_t total = (s[0] + s[1]) + (s[2] + s[3]);
+            const real_t mean = total / real_t(m);
+            real_t c2[4] = {0, 0, 0, 0}, c3[4] = {0, 0, 0, 0}, c4[4] = {0, 0, 0, 0};
+            for (i = 0; i + 4 <= m; i += 4)
+                for (int j = 0; j < 4; j++)
+                {
+                    const real_t d = b[i + j] - mean, d2 = d * d;
+                    c2[j] += d2;
+                    c3[j] += d2 * d;
+                    c4[j] += d2 * d2;
+                }
+            for (; i < m; i++)
+            {
+                const real_t d = b[i] - mean, d2 = d * d;
+                c2[0] += d2;
+                c3[0] += d2 * d;
+                c4[0] += d2 * d2;
+            }
+            merge(m, mean, (c2[0] + c2[1]) + (c2[2] + c2[3]), (c3[0] + c3[1]) + (c3[2] + c3[3]),
+                  (c4[0] + c4[1]) + (c4[2] + c4[3]), total, lo, hi);
+        }
+    }
+
+    void Moments::add(const int_t* x, size_t count)
+    {
+        real_t block[moments_block];
+        for (size_t begin = 0; begin < count; begin += moments_block)
+        {
+            const size_t m = std::min(moments_block, count - begin);
+            for (size_t i = 0; i < m; i++)
+                block[i] = real_t(x[begin + i]);
+            add(block, m);
+        }
+    }
+
+    void Moments::merge(const Moments& other)
+    {
+        merge(other.n, other.m1, other.m2, other.m3, other.m4, other.sum, other.low, other.high);
+        compensation += other.compensation;
+    }
+
+    uint64_t Moments::count() const
+    {
+        return n;
+    }
+
+    real_t Moments::total() const
+    {
+        return sum + compensation;
+    }
+
+    real_t Moments::mean() const
+    {
+        return m1;
+    }
+
+    real_t Moments::variance() const
+    {
+        return (n < 2) ? 0 : m2 / real_t(n - 1);
+    }
+
+    real_t Moments::skewness() const
+    {
+        return std::sqrt(real_t(n)) * m3 / std::pow(m2, real_t(1.5));
+    }
+
+    real_t Moments::kurtosis() const
+    {
+        return real_t(n) * m4 / (m2 * m2) - 3;
+    }
+
+    real_t Moments::min() const
+    {
+        return low;
+    }
+
+    real_t Moments::max() const
+    {
+        return high;
+    }
+
+    TestResult Moments::mean_test(real_t expectation, real_t variance) const
+    {
+        const real_t z = (m1 - expectation) / std::sqrt(variance / real_t(n));
+        return {z, special::erfc(std::abs(z) / std::sqrt(real_t(2))), 0};
+    }
+
+    void Moments::write_state(detail::StateWriter& out) const
+    {
+        out.tag("Moments");
+        out.put(n);
+        out.put(m1);
+        out.put(m2);
+        out.put(m3);
+        out.put(m4);
+        out.put(sum);
+        out.put(compensation);
+        out.put(low);
+        out.put(high);
+    }
+
+    void Moments::read_state(detail::StateReader& in)
+    {
+        in.tag("Moments");
+        Moments loaded;
+        loaded.n = in.get<uint64_t>();
+        loaded.m1 = in.get<real_t>();
+        loaded.m2 = in.get<real_t>();
+        loaded.m3 = in.get<real_t>();
+        loaded.m4 = in.get<real_t>();
+        loaded.sum = in.get<real_t>();
+        loaded.compensation = in.get<real_t>();
+        loaded.low = in.get<real_t>();
+        loaded.high = in.get<real_t>();
+        in.end();
+        *this = loaded;
+    }
+
+    /* Histogram */
+
+    Histogram::Histogram(real_t lo, real_t hi, size_t bins) : lo(lo), hi(hi), scale(real_t(bins) / (hi - lo)), counts(bins)
+    {
+        if (bins == 0)
+            throw std::invalid_argument("Expected at least one bin");
+        if (!(lo < hi))
+            throw std::invalid_argument("Expected lo < hi");
+    }
+
+    void Histogram::add(const real_t* x, size_t n)
+    {
+        for (size_t i = 0; i < n; i++)
+            add(x[i]);
+    }
+
+    void Histogram::add(const int_t* x, size_t n)
+    {
+        for (size_t i = 0; i < n; i++)
+            add(real_t(x[i]));
+    }
+
+    void Histogram::merge(const Histogram& other)
+    {
+        if (other.lo != lo || other.hi != hi || other.counts.size() != counts.size())
+            throw std::invalid_argument("Only histograms of the same bins can be merged");
+        for (size_t i = 0; i < counts.size(); i++)
+            counts[i] += other.counts[i];
+        below += other.below;
+        above += other.above;
+    }
+
+    size_t Histogram::bins() const
+    {
+        return counts.size();
+    }
+
+    uint64_t Histogram::operator[](size_t i) const
+    {
+        if (i >= counts.size())
+            throw std::out_of_range("No such bin in the histogram");
+        return counts[i];
+    }
+
+    uint64_t Histogram::underflow() const
+    {
+        return below;
+    }
+
+    uint64_t Histogram::overflow() const
+    {
+        return above;
+    }
+
+    uint64_t Histogram::count() const
+    {
+        uint64_t total = below + above;
+        for (uint64_t c : counts)
+            total += c;
+        return total;
+    }
+
+    std::vector<real_t> Histogram::edges(const Continuous& distribution) const
+    {
+        std::vector<real_t> x(counts.size() + 1);
+        for (size_t i = 0; i <= counts.size(); i++)
+            x[i] = lo + (hi - lo) * real_t(i) / real_t(counts.size());
+        distribution.cdf(x.data(), x.data(), x.size());
+        return x;
+    }
+
+    std::vector<real_t> Histogram::edges(const Discrete& distribution) const
+    {
+        // P(X < e) = P(X <= ceil(e) - 1)
+        std::vector<real_t> f(counts.size() + 1);
+        for (size_t i = 0; i <= counts.size(); i++)
+        {
+            const real_t k = std::ceil(lo + (hi - lo) * real_t(i) / real_t(counts.size())) - 1;
+            if (k < real_t(distribution.minValue()))
+                f[i] = 0;
+            else if (k >= real_t(distribution.maxValue()))
+                f[i] = 1;
+            else
+                f[i] = distribution.cdf(int_t(k));
+        }
+        return f;
+    }
+
+    std::vector<real_t> Histogram::edges() const
+    {
+        std::vector<real_t> f(counts.size() + 1);
+        for (size_t i = 0; i <= counts.size(); i++)
+            f[i] = real_t(i) / real_t(counts.size());
+        return f;
+    }
+
+    TestResult Histogram::chi_square(const Continuous& distribution, size_t fitted) const
+    {
+        return pearson(counts, below, above, edges(distribution), fitted);
+    }
+
+    TestResult Histogram::chi_square(const Discrete& distribution, size_t fitted) const
+    {
+        return pearson(counts, below, above, edges(distribution), fitted);
+    }
+
+    TestResult Histogram::chi_square() const
+    {
+        return pearson(counts, below, above, edges(), 0);
+    }
+
+    TestResult Histogram::kolmogorov_smirnov(const Continuous& distribution) const
+    {
+        return kolmogorov(counts, below, above, edges(distribution));
+    }
+
+    TestResult Histogram::kolmogorov_smirnov(const Discrete& distribution) const
+    {
+        return kolmogorov(counts, below, above, edges(distribution));
+    }
+
+    TestResult Histogram::kolmogorov_smirnov() const
+    {
+        return kolmogorov(counts, below, above, edges());
+    }
+
+    void Histogram::write_state(detail::StateWriter& out) const
+    {
+        out.tag("Histogram");
+        out.put(lo);
+        out.put(hi);
+        out.put(uint64_t(counts.size()));
+        out.put(below);
+        out.put(above);
+        out.put(counts.data(), counts.size());
+    }
+
+    void Histogram::read_state(detail::StateReader& in)
+    {
+        in.tag("Histogram");
+        const real_t l = in.get<real_t>(), h = in.get<real_t>();
+        const uint64_t bins = in.get<uint64_t>();
+        if (bins == 0 || !(l < h) || in.remaining() < 16 || bins > (in.remaining() - 16) / 8)
+            throw std::invalid_argument("The saved state does not fit this object");
+        Histogram loaded(l, h, size_t(bins));
+        loaded.below = in.get<uint64_t>();
+        loaded.above = in.get<uint64_t>();
+        in.get(loaded.counts.data(), loaded.counts.size());
+        in.end();
+        *this = loaded;
+    }
+}
@@ -0,0 +1,224 @@
+#ifndef DF_STATISTICS_H
+#define DF_STATISTICS_H
+
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include "types.h"
+#include "state.h"
+#include "distribution.h"
+#include "pool.h"
+
+namespace DiceForge
+{
+    /// @brief Outcome of a goodness of fit test
+    struct TestResult
+    {
+        /// @brief Value of the test statistic (chi-square, Kolmogorov-Smirnov distance or z score)
+        real_t statistic;
+        /// @brief Probability of a statistic at least as extreme under the hypothesis
+        real_t p_value;
+        /// @brief Degrees of freedom of the chi-square test, 0 for the others
+        size_t dof;
+    };
+
+    /// @brief DiceForge::Moments - Streaming count, mean, variance, skewness, kurtosis, minimum, maximum and sum of a
+    /// sample, in constant memory
+    /// @note Values are taken in blocks: a block's own mean and central moments are computed in two passes over it
+    /// and merged into the totals with the pairwise formulas of Chan et al. and Pébay, so the variance keeps its
+    /// accuracy far beyond the 1e8 values where the naive sum of squares breaks down. The sum itself is compensated
+    /// (Kahan-Babuska). Accumulators over parts of a sample (e.g. one per thread) can be merged.
+    class Moments : public Serializable<Moments>
+    {
+        friend class Serializable<Moments>;
+    private:
+        uint64_t n = 0;
+        real_t m1 = 0, m2 = 0, m3 = 0, m4 = 0;
+        real_t sum = 0, compensation = 0;
+        real_t low = 0, high = 0;
+        void merge(uint64_t count, real_t mean, real_t c2, real_t c3, real_t c4, real_t total, real_t lo, real_t hi);
+        // The statistics, for save_state and load_state (see DiceForge::Serializable)
+        void write_state(detail::StateWriter& out) const;
+        void read_state(detail::StateReader& in);
+    public:
+        /// @brief Adds one value
+        void add(real_t x);
+        /// @brief Adds the n values x
+        void add(const real_t* x, size_t n);
+        /// @brief Adds the n integers x
+        void add(const int_t* x, size_t n);
+        /// @brief Adds all the values seen by other
+        void merge(const Moments& other);
+        /// @brief Number of values added
+        uint64_t count() const;
+        /// @brief Sum of the values
+        real_t total() const;
+        /// @brief Sample mean
+        real_t mean() const;
+        /// @brief Unbiased sample variance (0 below two values)
+        real_t variance() const;
+        /// @brief Sample skewness, m3 / m2^1.5 of the central moments (NaN without two distinct values)
+        real_t skewness() const;
+        /// @brief Sample excess kurtosis, m4 / m2^2 - 3 of the central moments (NaN without two distinct values)
+        real_t kurtosis() const;
+        /// @brief Smallest value added (0 if none)
+        real_t min() const;
+        /// @brief Largest value added (0 if none)
+        real_t max() const;
+        /// @brief z test of the mean against the expectation of a distribution with the given variance
+        /// @return z = (mean - expectation) / sqrt(variance / n) and its two-sided p value
+        TestResult mean_test(real_t expectation, real_t variance) const;
+    };
+
+    /// @brief DiceForge::Histogram - Counts of a sample in equal bins of [lo, hi), with the values below and above,
+    /// for chi-square and Kolmogorov-Smirnov tests against a distribution in constant memory
+    /// @note Integers k fall into bin k - lo of a histogram of [lo, hi) with hi - lo bins, so the same class tallies
+    /// discrete samples (residues, dice...) one value per bin.
+    class Histogram : public Serializable<Histogram>
+    {
+        friend class Serializable<Histogram>;
+    private:
+        real_t lo, hi, scale;
+        std::vector<uint64_t> counts;
+        uint64_t below = 0, above = 0;
+        // P(X < edge) at the bin edges, for the tests
+        std::vector<real_t> edges(const Continuous& distribution) const;
+        std::vector<real_t> edges(const Discrete& distribution) const;
+        std::vector<real_t> edges() const;
+        // The statistics, for save_state and load_state (see DiceForge::Serializable)
+        void write_state(detail::StateWriter& out) const;
+        void read_state(detail::StateReader& in);
+    public:
+        /// @brief Histogram of [lo, hi) in the given number of bins
+        Histogram(real_t lo = 0, real_t hi = 1, size_t bins = 100);
+        /// @brief Adds one value
+        void add(real_t x)
+        {
+            const real_t t = (x - lo) * scale;
+            if (t < 0)
+                below++;
+            else if (t < real_t(counts.size()))
+                counts[size_t(t)]++;
+            else
+                above++;    // NaN included
+        }
+        /// @brief Adds the n values x
+        void add(const real_t* x, size_t n);
+        /// @brief Adds the n integers x
+        void add(const int_t* x, size_t n);
+        /// @brief Adds all the values seen by other, a histogram of the same bins
+        void merge(const Histogram& other);
+        /// @brief Number of bins
+        size_t bins() const;
+        /// @brief Count of bin i, values in [lo + i (hi - lo) / bins, lo + (i + 1) (hi - lo) / bins)
+        uint64_t operator[](size_t i) const;
+        /// @brief Number of values below lo
+        uint64_t underflow() const;
+        /// @brief Number of values at or above hi (or NaN)
+        uint64_t overflow() const;
+        /// @brief Number of values added
+        uint64_t count() const;
+        /// @brief Pearson's chi-square test of the counts against a distribution
+        /// @param fitted number of parameters of the distribution estimated from the same sample
+        /// @note The values below lo and above hi count as two more bins, and neighbouring bins are pooled until
+        /// each expects at least 5 values. A value where the distribution expects none gives an infinite statistic.
+        TestResult chi_square(const Continuous& distribution, size_t fitted = 0) const;
+        /// @brief Pearson's chi-square test of the counts against a discrete distribution
+        TestResult chi_square(const Discrete& distribution, size_t fitted = 0) const;
+        /// @brief Pearson's chi-square test of the counts against the uniform distribution on [lo, hi)
+        TestResult chi_square() const;
+        /// @brief Kolmogorov-Smirnov test of the counts against a distribution
+        /// @note The distance is taken at the bin edges only, so it is at most that of the raw sample, short of it
+        /// by no more than the largest probability of a bin: with fine bins the test is nearly as sensitive as on
+        /// the sorted sample, without storing it. The p value is the asymptotic one with Stephens' correction.
+        TestResult kolmogorov_smirnov(const Continuous& distribution) const;
+        /// @brief Kolmogorov-Smirnov test of the counts against a discrete distribution (at the bin edges)
+        TestResult kolmogorov_smirnov(const Discrete& distribution) const;
+        /// @brief Kolmogorov-Smirnov test of the counts against the uniform distribution on [lo, hi)
+        TestResult kolmogorov_smirnov() const;
+    };
+
+    /// @brief DiceForge::SampleSummary - Moments and histogram of one sample, filled together
+    struct SampleSummary
+    {
+        Moments moments;
+        Histogram histogram;
+        /// @brief An empty summary with a histogram of [lo, hi) in the given number of bins
+        SampleSummary(real_t lo = 0, real_t hi = 1, size_t bins = 100) : histogram(lo, hi, bins) {}
+        /// @brief Adds the n values x
+        template <typename V>
+        void add(const V* x, size_t n)
+        {
+            moments.add(x, n);
+            histogram.add(x, n);
+        }
+        /// @brief Adds all the values seen by other
+        void merge(const SampleSummary& other)
+        {
+            moments.merge(other.moments);
+            histogram.merge(other.histogram);
+        }
+    };
+
+    /// @brief Draws n values on several threads and gathers them into an accumulator, in constant memory
+    /// @param pool streams to draw from, chunk c of the sample drawing from stream c % pool.size()
+    /// @param n number of values
+    /// @param empty accumulator to start every stream from, providing add(const V*, size_t) and merge (Moments,
+    /// Histogram, SampleSummary, GaussianAccumulator...)
+    /// @param draw draw(rng, out, m) writing m values of type V, rng being a StaticView of a stream
+    /// @param threads maximum number of threads, 0 for std::thread::hardware_concurrency
+    /// @return the accumulator of all the values
+    /// @note Each stream works through its chunks (of detail::pool_chunk values) with a buffer of its own and an
+    /// accumulator of its own, and the accumulators are merged in the order of the streams, so the result depends
+    /// on the pool but not on the number of threads. Only a chunk per stream is kept in memory, whatever n is.
+    template <typename V = real_t, typename Engine, typename Accumulator, typename Draw>
+    Accumulator parallel_accumulate(GeneratorPool<Engine>& pool, uint64_t n, const Accumulator& empty, Draw draw,
+                                    int threads = 0)
+    {
+        const uint64_t chunks = (n + detail::pool_chunk - 1) / detail::pool_chunk;
+        const size_t used = size_t(std::min<uint64_t>(chunks, pool.size()));
+        std::vector<Accumulator> partial(used, empty);
+        auto job = [&](size_t s) {
+            auto rng = make_static(pool.stream(s));
+            std::vector<V> buffer(size_t(std::min<uint64_t>(detail::pool_chunk, n)));
+            for (uint64_t c = s; c < chunks; c += pool.size()) {
+                const size_t m = size_t(std::min<uint64_t>(detail::pool_chunk, n - c * detail::pool_chunk));
+                draw(rng, buffer.data(), m);
+                partial[s].add(buffer.data(), m);
+            }
+        };
+        detail::parallel_for(used, threads, job);
+        Accumulator result = empty;
+        for (const Accumulator& p : partial)
+            result.merge(p);
+        return result;
+    }
+
+    /// @brief Summary of n random reals between 0 and 1 of the pool, drawn on several threads
+    /// @param bins bins of the histogram of [0, 1)
+    /// @note See parallel_accumulate
+    template <typename Engine>
+    SampleSummary parallel_summary(GeneratorPool<Engine>& pool, uint64_t n, size_t bins = 1000, int threads = 0)
+    {
+        return parallel_accumulate(pool, n, SampleSummary(0, 1, bins),
+                                   [](auto& rng, real_t* out, size_t m) { rng.fill_unit(out, m); }, threads);
+    }
+
+    /// @brief Summary of n values of a distribution drawn on several threads
+    /// @param distribution any distribution with a batch sample(rng, out, n), called from all the threads at once (of
+    /// integers for those derived from Discrete, of reals otherwise)
+    /// @param lo, hi, bins the bins of the histogram
+    /// @note See parallel_accumulate
+    template <typename Engine, typename Distribution>
+    SampleSummary parallel_summary(GeneratorPool<Engine>& pool, Distribution& distribution, uint64_t n, real_t lo,
+                                   real_t hi, size_t bins, int threads = 0)
+    {
+        typedef typename std::conditional<std::is_base_of<Discrete, Distribution>::value, int_t, real_t>::type V;
+        return parallel_accumulate<V>(pool, n, SampleSummary(lo, hi, bins),
+                                   [&](auto& rng, V* out, size_t m) { distribution.sample(rng, out, m); }, threads);
+    }
+}
+
+#endif
@@ -0,0 +1,69 @@
+#include "streams.h"
+
+namespace DiceForge
+{
+    StreamPlan::StreamPlan(uint64_t root, unsigned node_bits, unsigned thread_bits, unsigned substream_bits)
+        : m_root(root), m_node_bits(node_bits), m_thread_bits(thread_bits), m_substream_bits(substream_bits)
+    {
+        if (uint64_t(node_bits) + thread_bits + substream_bits > 64)
+            throw std::invalid_argument("The widths of the key must add up to at most 64 bits!");
+    }
+
+    uint64_t StreamPlan::root() const
+    {
+        return m_root;
+    }
+
+    uint64_t StreamPlan::index(const StreamKey& key) const
+    {
+        // Whether x fits in the given number of bits
+        auto fits = [](uint64_t x, unsigned bits) {
+            return bits >= 64 || (x >> bits) == 0;
+        };
+        if (!fits(key.node, m_node_bits) || !fits(key.thread, m_thread_bits) || !fits(key.substream, m_substream_bits))
+            throw std::out_of_range("A coordinate of the key does not fit in its width!");
+        // In 128 bits, as a width may be 64
+        const uint128_t i = (((uint128_t(key.node) << m_thread_bits) | key.thread) << m_substream_bits) | key.substream;
+        return uint64_t(i);
+    }
+
+    unsigned StreamPlan::stride_bits() const
+    {
+        return 64 - (m_node_bits + m_thread_bits + m_substream_bits);
+    }
+
+    SeedSequence StreamPlan::job_seed(uint64_t job) const
+    {
+        return SeedSequence{m_root, job};
+    }
+
+    SeedSequence StreamPlan::seed(const StreamKey& key) const
+    {
+        return SeedSequence{m_root, key.job, key.node, key.thread, key.substream};
+    }
+
+    std::pair<uint64_t, uint64_t> StreamPlan::shards(uint64_t count, uint64_t node, uint64_t nodes)
+    {
+        if (nodes == 0 || node >= nodes)
+            throw std::out_of_range("Expected node < nodes!");
+        return {uint64_t(uint128_t(count) * node / nodes), uint64_t(uint128_t(count) * (node + 1) / nodes)};
+    }
+
+    void StreamPlan::write_state(detail::StateWriter& out) const
+    {
+        out.tag("StreamPlan");
+        out.put(m_root);
+        out.put(uint8_t(m_node_bits));
+        out.put(uint8_t(m_thread_bits));
+        out.put(uint8_t(m_substream_bits));
+    }
+
+    void StreamPlan::read_state(detail::StateReader& in)
+    {
+        in.tag("StreamPlan");
+        const uint64_t root = in.get<uint64_t>();
+        const unsigned node_bits = in.get<uint8_t>(), thread_bits = in.get<uint8_t>(), substream_bits = in.get<uint8_t>();
+        in.end();
+        *this = StreamPlan(root, node_bits, thread_bits, substream_bits);
+    }
+}
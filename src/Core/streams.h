@@ -0,0 +1,107 @@
+/***STREAM PLANS***/
+/*the random streams of a run spread over many machines and threads, derived
+from one root seed and the key of each stream with no coordination between
+them: counter-based engines get the key as their stream index, the others
+jump ahead to a slice of their period of their own*/
+
+#ifndef DF_STREAMS_H
+#define DF_STREAMS_H
+
+#include <cstddef>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+
+#include "types.h"
+#include "generator.h"
+#include "state.h"
+
+namespace DiceForge
+{
+    /// @brief DiceForge::StreamKey - The coordinates of a stream in a run
+    /// @note For results that do not depend on the number of machines, node and thread should name shards of the
+    /// work rather than the machines and threads themselves (see StreamPlan::shards)
+    struct StreamKey
+    {
+        uint64_t job = 0;       // Run, or simulation, sharing the root seed
+        uint64_t node = 0;      // Shard of the job
+        uint64_t thread = 0;    // Part of the shard
+        uint64_t substream = 0; // Stream of the part, e.g. one per kind of draw
+    };
+
+    /// @brief DiceForge::StreamPlan - Derives the engines of every stream of a run from one root seed and the key of
+    /// the stream, the same on every machine
+    /// @note The node, thread and substream of a key are packed into a stream index of node_bits + thread_bits +
+    /// substream_bits bits (at most 64). A counter-based engine (Philox) is keyed with SeedSequence{root, job} and
+    /// takes the index as its stream, giving each stream 2^64 blocks of its own. Any other engine is seeded with
+    /// SeedSequence{root, job} and jumped ahead by index * 2^stride_bits(), the remaining bits: its streams are
+    /// disjoint as long as each one draws at most 2^stride_bits() integers and the period of the engine is at least
+    /// 2^64 (not so for the 32-bit XORShift and LFSR), and should have a fast jump (not Blum Blum Shub or MT32; the
+    /// jump of MT64 takes a fraction of a second, that of XORShift64 a microsecond and Philox none at all).
+    /// Distinct jobs are distinct seeds. The plan is saved and restored with save_state and load_state.
+    class StreamPlan : public Serializable<StreamPlan>
+    {
+        friend class Serializable<StreamPlan>;
+    private:
+        uint64_t m_root;
+        unsigned m_node_bits, m_thread_bits, m_substream_bits;
+        void write_state(detail::StateWriter& out) const;
+        void read_state(detail::StateReader& in);
+        // Engines taking a stream index next to their seed and seeking to any element of it
+        template <typename Engine, typename = void>
+        struct counter_based : std::false_type {};
+        template <typename Engine>
+        struct counter_based<Engine, std::void_t<decltype(std::declval<Engine&>().seek(uint64_t(0)))>>
+            : std::is_constructible<Engine, typename Engine::result_type, uint64_t> {};
+    public:
+        /// @brief A plan for the streams of the given root seed
+        /// @param root seed shared by every machine of the run
+        /// @param node_bits, thread_bits, substream_bits widths of the coordinates of a key in the stream index
+        /// @note Throws std::invalid_argument when the widths add up to more than 64
+        explicit StreamPlan(uint64_t root, unsigned node_bits = 16, unsigned thread_bits = 8, unsigned substream_bits = 8);
+
+        /// @brief Returns the root seed
+        uint64_t root() const;
+        /// @brief Returns the stream index of the key, (node, thread, substream) packed from the highest bits down
+        /// @note Throws std::out_of_range when a coordinate does not fit in its width
+        uint64_t index(const StreamKey& key) const;
+        /// @brief Returns log2 of the number of integers between the starts of consecutive jumped streams
+        unsigned stride_bits() const;
+        /// @brief Returns the seed material of all the streams of a job
+        SeedSequence job_seed(uint64_t job) const;
+        /// @brief Returns seed material of the key alone, SeedSequence{root, job, node, thread, substream}
+        /// @note For engines without a fast jump: engine.reset_seed(plan.seed(key)) gives streams that are
+        /// independent seedings, though not provably disjoint
+        SeedSequence seed(const StreamKey& key) const;
+
+        /// @brief Returns the engine of the stream of the given key
+        /// @tparam Engine RNG constructible from a seed (for instance MT64, XORShift64 or Philox)
+        /// @note Throws std::invalid_argument when an RNG without a fast jump would discard more than 2^30 integers
+        template <typename Engine>
+        Engine engine(const StreamKey& key) const
+        {
+            const uint64_t i = index(key);
+            typedef typename Engine::result_type T;
+            if constexpr (counter_based<Engine>::value) {
+                Engine rng(T(0), i);
+                rng.reset_seed(job_seed(key.job));
+                return rng;
+            }
+            else {
+                Engine rng(T(0));
+                rng.reset_seed(job_seed(key.job));
+                if (i != 0) {
+                    detail::check_jump(rng, uint128_t(i) << stride_bits());
+                    rng.jump(i << stride_bits());
+                }
+                return rng;
+            }
+        }
+
+        /// @brief Returns the range [first, last) of the shards 0 to count - 1 handled by node of nodes
+        /// @note Consecutive nodes get consecutive ranges, of sizes differing by at most one
+        static std::pair<uint64_t, uint64_t> shards(uint64_t count, uint64_t node, uint64_t nodes);
+    };
+}
+
+#endif
@@ -0,0 +1,193 @@
+#include "table.h"
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <chrono>
+#include <fstream>
+
+#if defined(_WIN32)
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace DiceForge
+{
+    namespace
+    {
+        // Written in the representation of the machine, read back as 0x01020304 only on one of the same byte order
+        constexpr uint32_t byte_order_mark = 0x01020304;
+        constexpr size_t name_offset = 24, name_length = 32, entry_size = 24;
+
+        template <typename U>
+        U read_at(const unsigned char* data, size_t offset)
+        {
+            U x;
+            std::memcpy(&x, data + offset, sizeof(U));
+            return x;
+        }
+
+        template <typename U>
+        void write_at(std::vector<unsigned char>& out, size_t offset, U x)
+        {
+            std::memcpy(out.data() + offset, &x, sizeof(U));
+        }
+    }
+
+    TableFile::TableFile(const std::string& path)
+    {
+#if defined(_WIN32)
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            throw std::runtime_error("Cannot open the table file " + path);
+        buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        data = buffer.data();
+        length = buffer.size();
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("Cannot open the table file " + path);
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot open the table file " + path);
+        }
+        length = size_t(st.st_size);
+        if (length > 0) {
+            void* map = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+            if (map == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Cannot map the table file " + path);
+            }
+            data = static_cast<const unsigned char*>(map);
+        }
+        // The mapping stays valid once the descriptor is closed
+        ::close(fd);
+#endif
+        try {
+            if (length < detail::table_header || std::memcmp(data, detail::table_magic, 4) != 0)
+                throw std::invalid_argument("Expected a table file written by DiceForge");
+            if (data[4] != detail::table_version)
+                throw std::invalid_argument("The table file is of an unknown version");
+            if (data[5] != sizeof(real_t) || read_at<uint32_t>(data, 8) != byte_order_mark)
+                throw std::invalid_argument("The table file was written on a machine of another kind");
+            if (read_at<uint64_t>(data, 16) != length)
+                throw std::invalid_argument("The table file is truncated");
+            const char* name = reinterpret_cast<const char*>(data + name_offset);
+            m_name.assign(name, strnlen(name, name_length));
+
+            const size_t m = read_at<uint32_t>(data, 12);
+            if (m > (length - detail::table_header) / entry_size)
+                throw std::invalid_argument("The table file is truncated");
+            directory.resize(m);
+            for (size_t k = 0; k < m; k++) {
+                const size_t at = detail::table_header + k * entry_size;
+                const uint64_t offset = read_at<uint64_t>(data, at), count = read_at<uint64_t>(data, at + 8);
+                const uint32_t element = read_at<uint32_t>(data, at + 16);
+                if (element == 0 || offset % detail::table_alignment != 0 || offset > length
+                    || count > (length - offset) / element)
+                    throw std::invalid_argument("The table file is truncated");
+                directory[k] = {size_t(offset), size_t(count), size_t(element)};
+            }
+        }
+        catch (...) {
+#if !defined(_WIN32)
+            if (data != nullptr)
+                ::munmap(const_cast<unsigned char*>(data), length);
+#endif
+            throw;
+        }
+    }
+
+    TableFile::~TableFile()
+    {
+#if !defined(_WIN32)
+        if (data != nullptr)
+            ::munmap(const_cast<unsigned char*>(data), length);
+#endif
+    }
+
+    const std::string& TableFile::name() const
+    {
+        return m_name;
+    }
+
+    void TableFile::expect(const char* distribution) const
+    {
+        if (m_name != distribution)
+            throw std::invalid_argument("The table file holds the tables of a " + m_name + ", not of a " + distribution);
+    }
+
+    size_t TableFile::arrays() const
+    {
+        return directory.size();
+    }
+
+    const TableFile::Entry& TableFile::entry(size_t k, size_t element) const
+    {
+        if (k >= directory.size())
+            throw std::out_of_range("The table file has no such array");
+        if (directory[k].element != element)
+            throw std::invalid_argument("The array of the table file is not of the expected type");
+        return directory[k];
+    }
+
+    namespace detail
+    {
+        TableWriter::TableWriter(const char* name) : name(name)
+        {
+            if (this->name.size() >= name_length)
+                throw std::invalid_argument("The name of a table file has at most 31 characters");
+        }
+
+        void TableWriter::write(const std::string& path) const
+        {
+            // Header, directory, then the arrays each at an aligned offset
+            size_t length = table_header + arrays.size() * entry_size;
+            std::vector<size_t> offsets;
+            for (const Array& a : arrays) {
+                length = (length + table_alignment - 1) / table_alignment * table_alignment;
+                offsets.push_back(length);
+                length += a.bytes.size();
+            }
+            std::vector<unsigned char> out(length, 0);
+            std::memcpy(out.data(), table_magic, 4);
+            out[4] = table_version;
+            out[5] = (unsigned char)(sizeof(real_t));
+            write_at(out, 8, byte_order_mark);
+            write_at(out, 12, uint32_t(arrays.size()));
+            write_at(out, 16, uint64_t(length));
+            std::memcpy(out.data() + name_offset, name.data(), name.size());
+            for (size_t k = 0; k < arrays.size(); k++) {
+                const size_t at = table_header + k * entry_size;
+                write_at(out, at, uint64_t(offsets[k]));
+                write_at(out, at + 8, uint64_t(arrays[k].count));
+                write_at(out, at + 16, uint32_t(arrays[k].element));
+                if (!arrays[k].bytes.empty())
+                    std::memcpy(out.data() + offsets[k], arrays[k].bytes.data(), arrays[k].bytes.size());
+            }
+
+            // A name of its own for every writer, as several processes may write the same tables at once
+            const std::string temporary = path + ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count())
+                                        + std::to_string(reinterpret_cast<uintptr_t>(this));
+            {
+                std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+                if (!file.write(reinterpret_cast<const char*>(out.data()), std::streamsize(out.size())) || !file.flush()) {
+                    file.close();
+                    std::remove(temporary.c_str());
+                    throw std::runtime_error("Cannot write the table file " + path);
+                }
+            }
+#if defined(_WIN32)
+            std::remove(path.c_str());
+#endif
+            if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+                std::remove(temporary.c_str());
+                throw std::runtime_error("Cannot write the table file " + path);
+            }
+        }
+    }
+}
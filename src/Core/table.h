@@ -0,0 +1,141 @@
+#ifndef DF_TABLE_H
+#define DF_TABLE_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+#include "types.h"
+
+namespace DiceForge
+{
+    /// @brief DiceForge::TableFile - A file of precomputed sampling tables, mapped read-only into memory
+    /// @note A table file is the magic "DFtb", a version byte, the size of real_t and a byte order mark, the name
+    /// of the distribution that wrote it and a directory of arrays, each stored in the representation of the
+    /// machine at an offset aligned to 64 bytes, so that a distribution samples straight from the mapping. The
+    /// pages are shared through the page cache by every process mapping the same file, and are only read in as
+    /// they are used. Only the header and the directory are checked on opening (std::invalid_argument if they do
+    /// not fit the file or this machine), not the values of the arrays.
+    class TableFile
+    {
+    private:
+        const unsigned char* data = nullptr;
+        size_t length = 0;
+        // The copy read into memory where files cannot be mapped
+        std::vector<unsigned char> buffer;
+        struct Entry
+        {
+            size_t offset, count, element;
+        };
+        std::vector<Entry> directory;
+        std::string m_name;
+    public:
+        /// @brief Maps the table file at path (std::runtime_error if it cannot be opened)
+        explicit TableFile(const std::string& path);
+        ~TableFile();
+        TableFile(const TableFile&) = delete;
+        TableFile& operator=(const TableFile&) = delete;
+
+        /// @brief Name of the distribution that wrote the tables
+        const std::string& name() const;
+        /// @brief Throws std::invalid_argument unless the tables were written by the named distribution
+        void expect(const char* distribution) const;
+        /// @brief Number of arrays in the file
+        size_t arrays() const;
+        /// @brief Array k of the file, as a pointer into the mapping and its number of elements
+        /// @note std::out_of_range if there is no array k, std::invalid_argument if its elements are not of type U
+        template <typename U>
+        std::pair<const U*, size_t> array(size_t k) const
+        {
+            const Entry& e = entry(k, sizeof(U));
+            return {reinterpret_cast<const U*>(data + e.offset), e.count};
+        }
+    private:
+        const Entry& entry(size_t k, size_t element) const;
+    };
+
+    namespace detail
+    {
+        // Table files start with the magic "DFtb" and a version byte, then a 64 byte header and the directory
+        constexpr unsigned char table_magic[4] = {'D', 'F', 't', 'b'};
+        constexpr unsigned char table_version = 1;
+        constexpr size_t table_header = 64;
+        constexpr size_t table_alignment = 64;
+
+        /// @brief Collects the arrays of a table file and writes it
+        class TableWriter
+        {
+        private:
+            std::string name;
+            struct Array
+            {
+                std::vector<unsigned char> bytes;
+                size_t count, element;
+            };
+            std::vector<Array> arrays;
+        public:
+            /// @brief Tables of the named distribution (at most 31 characters)
+            explicit TableWriter(const char* name);
+            /// @brief Appends an array of n values, which will be array arrays() - 1 of the file
+            template <typename U>
+            void add(const U* values, size_t n)
+            {
+                const unsigned char* p = reinterpret_cast<const unsigned char*>(values);
+                arrays.push_back({std::vector<unsigned char>(p, p + n * sizeof(U)), n, sizeof(U)});
+            }
+            /// @brief Writes the file, to a temporary name first and then renamed to path, so that a process
+            /// mapping path never sees it half written (std::runtime_error if it cannot be written)
+            void write(const std::string& path) const;
+        };
+
+        /// @brief A read-only array of a sampling table, held in memory or read in place from a TableFile
+        /// @note Copies share the values (and keep the file mapped) rather than copy them
+        template <typename U>
+        class TableArray
+        {
+        private:
+            std::shared_ptr<const void> owner;
+            const U* p = nullptr;
+            size_t n = 0;
+        public:
+            TableArray() = default;
+            /// @brief Takes over the values of a vector
+            explicit TableArray(std::vector<U>&& values)
+            {
+                auto held = std::make_shared<const std::vector<U>>(std::move(values));
+                p = held->data();
+                n = held->size();
+                owner = std::move(held);
+            }
+            /// @brief Array k of a mapped file
+            TableArray(const std::shared_ptr<const TableFile>& file, size_t k)
+            {
+                std::pair<const U*, size_t> a = file->template array<U>(k);
+                p = a.first;
+                n = a.second;
+                owner = file;
+            }
+            const U& operator[](size_t i) const
+            {
+                return p[i];
+            }
+            const U* data() const
+            {
+                return p;
+            }
+            size_t size() const
+            {
+                return n;
+            }
+            bool empty() const
+            {
+                return n == 0;
+            }
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,282 @@
+#ifndef DF_VIEWS_H
+#define DF_VIEWS_H
+
+// Lazy views of random streams, for range pipelines and coroutine consumers (C++20)
+#if (__cplusplus >= 202002L) && __has_include(<ranges>)
+
+#include <vector>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#if __has_include(<coroutine>) && defined(__cpp_impl_coroutine)
+#include <coroutine>
+// Set when DiceForge::Stream and the coroutine streams are available
+#define DF_COROUTINES
+#endif
+
+#include "types.h"
+#include "generator.h"
+#include "distribution.h"
+
+namespace DiceForge
+{
+    namespace detail
+    {
+        // Values drawn at a time by the views and streams: 8 KiB of reals, which stay in L1 while a pipeline
+        // consumes them
+        constexpr size_t view_block = 1024;
+
+        // The values a distribution samples: integers for those derived from Discrete, reals otherwise
+        template <typename Distribution>
+        using sample_t = std::conditional_t<std::is_base_of_v<Discrete, Distribution>, int_t, real_t>;
+
+        // Fills for block_view: reals of fill_unit, integers of fill, values of sample (pointers, so that the views
+        // stay default constructible and copyable)
+        template <typename Derived, typename T>
+        struct unit_fill
+        {
+            StaticGenerator<Derived, T>* rng = nullptr;
+            void operator()(real_t* out, size_t n) const { rng->fill_unit(out, n); }
+        };
+
+        template <typename Derived, typename T>
+        struct integer_fill
+        {
+            StaticGenerator<Derived, T>* rng = nullptr;
+            void operator()(T* out, size_t n) const { rng->fill(out, n); }
+        };
+
+        template <typename Distribution, typename Derived, typename T>
+        struct sample_fill
+        {
+            Distribution* distribution = nullptr;
+            StaticGenerator<Derived, T>* rng = nullptr;
+            void operator()(sample_t<Distribution>* out, size_t n) const { distribution->sample(*rng, out, n); }
+        };
+
+        /// @brief An endless input view handing out the values of a buffer, refilled a block at a time by fill
+        /// @note As std::ranges::istream_view, the view holds the buffer and its iterators point to the view: the
+        /// first block is drawn by begin(), and the values are those of a single pass
+        template <typename V, typename Fill>
+        class block_view : public std::ranges::view_interface<block_view<V, Fill>>
+        {
+        private:
+            Fill fill;
+            std::vector<V> buffer;
+            void refill()
+            {
+                fill(buffer.data(), buffer.size());
+            }
+        public:
+            class iterator
+            {
+            private:
+                // The current value and the end of the buffer, kept here rather than in the view so that the
+                // loop of a pipeline runs on registers
+                block_view* parent = nullptr;
+                const V* current = nullptr;
+                const V* last = nullptr;
+            public:
+                typedef V value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef std::input_iterator_tag iterator_concept;
+                iterator() = default;
+                explicit iterator(block_view* parent)
+                    : parent(parent), current(parent->buffer.data()), last(current + parent->buffer.size()) {}
+                const V& operator*() const
+                {
+                    return *current;
+                }
+                iterator& operator++()
+                {
+                    if (++current == last) {
+                        parent->refill();
+                        current = parent->buffer.data();
+                    }
+                    return *this;
+                }
+                void operator++(int)
+                {
+                    ++*this;
+                }
+            };
+
+            block_view() = default;
+            block_view(Fill fill, size_t block) : fill(fill), buffer(block > 0 ? block : 1) {}
+            iterator begin()
+            {
+                refill();
+                return iterator(this);
+            }
+            std::unreachable_sentinel_t end() const
+            {
+                return std::unreachable_sentinel;
+            }
+        };
+    }
+
+    namespace views
+    {
+        /// @brief An endless view of random reals between 0 and 1
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of
+        /// one), which must outlive the view
+        /// @param block number of values drawn at a time with fill_unit
+        /// @note Compose with std::views::take for a finite range; the last block is drawn whole, so the RNG moves
+        /// on by a multiple of the block
+        template <typename Derived, typename T>
+        auto uniform(StaticGenerator<Derived, T>& rng, size_t block = detail::view_block)
+        {
+            return detail::block_view<real_t, detail::unit_fill<Derived, T>>({&rng}, block);
+        }
+
+        /// @brief An endless view of the random integers of the RNG
+        /// @note As uniform, drawn with fill
+        template <typename Derived, typename T>
+        auto integers(StaticGenerator<Derived, T>& rng, size_t block = detail::view_block)
+        {
+            return detail::block_view<T, detail::integer_fill<Derived, T>>({&rng}, block);
+        }
+
+        /// @brief An endless view of values of a distribution
+        /// @param distribution any distribution with a batch sample(rng, out, n) (of integers for those derived from
+        /// Discrete, of reals otherwise), which must outlive the view
+        /// @param rng A random number generator, which must outlive the view
+        /// @note As uniform, drawn with distribution.sample
+        template <typename Distribution, typename Derived, typename T>
+        auto sample(Distribution& distribution, StaticGenerator<Derived, T>& rng, size_t block = detail::view_block)
+        {
+            typedef detail::sample_t<Distribution> V;
+            return detail::block_view<V, detail::sample_fill<Distribution, Derived, T>>({&distribution, &rng}, block);
+        }
+    }
+
+#if defined(DF_COROUTINES)
+    /// @brief DiceForge::Stream - A coroutine generating values of type V one at a time, and an input range of them
+    /// @note The coroutine runs up to its first value when begin() (or next()) is first called, and on to the
+    /// next one at each increment. A Stream is moved, not copied.
+    template <typename V>
+    class Stream : public std::ranges::view_interface<Stream<V>>
+    {
+    public:
+        struct promise_type
+        {
+            const V* current = nullptr;
+            Stream get_return_object()
+            {
+                return Stream(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            std::suspend_always yield_value(const V& value) noexcept
+            {
+                current = std::addressof(value);
+                return {};
+            }
+            void return_void() {}
+            void unhandled_exception() { throw; }
+        };
+
+        class iterator
+        {
+        private:
+            std::coroutine_handle<promise_type> handle;
+        public:
+            typedef V value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef std::input_iterator_tag iterator_concept;
+            iterator() = default;
+            explicit iterator(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+            const V& operator*() const
+            {
+                return *handle.promise().current;
+            }
+            iterator& operator++()
+            {
+                handle.resume();
+                return *this;
+            }
+            void operator++(int)
+            {
+                ++*this;
+            }
+            friend bool operator==(const iterator& i, std::default_sentinel_t)
+            {
+                return !i.handle || i.handle.done();
+            }
+        };
+
+        Stream() = default;
+        Stream(Stream&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+        Stream& operator=(Stream&& other) noexcept
+        {
+            if (this != &other) {
+                if (handle)
+                    handle.destroy();
+                handle = std::exchange(other.handle, nullptr);
+            }
+            return *this;
+        }
+        ~Stream()
+        {
+            if (handle)
+                handle.destroy();
+        }
+        /// @brief Runs the coroutine up to its first value
+        iterator begin()
+        {
+            if (handle && !handle.done() && handle.promise().current == nullptr)
+                handle.resume();
+            return iterator(handle);
+        }
+        std::default_sentinel_t end() const
+        {
+            return std::default_sentinel;
+        }
+        /// @brief Returns the next value of the coroutine, which must not have ended
+        V next()
+        {
+            handle.resume();
+            return *handle.promise().current;
+        }
+    private:
+        std::coroutine_handle<promise_type> handle = nullptr;
+        explicit Stream(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+    };
+
+    /// @brief An endless stream of random reals between 0 and 1, drawn block by block with fill_unit
+    /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one),
+    /// which must outlive the stream
+    template <typename Derived, typename T>
+    Stream<real_t> uniform_stream(StaticGenerator<Derived, T>& rng, size_t block = detail::view_block)
+    {
+        std::vector<real_t> buffer(block > 0 ? block : 1);
+        while (true) {
+            rng.fill_unit(buffer.data(), buffer.size());
+            for (const real_t& x : buffer)
+                co_yield x;
+        }
+    }
+
+    /// @brief An endless stream of values of a distribution, drawn block by block with its batch sample
+    /// @param distribution any distribution with a batch sample(rng, out, n), which must outlive the stream
+    /// @param rng A random number generator, which must outlive the stream
+    template <typename Distribution, typename Derived, typename T>
+    Stream<detail::sample_t<Distribution>> sample_stream(Distribution& distribution, StaticGenerator<Derived, T>& rng,
+                                                          size_t block = detail::view_block)
+    {
+        std::vector<detail::sample_t<Distribution>> buffer(block > 0 ? block : 1);
+        while (true) {
+            distribution.sample(rng, buffer.data(), buffer.size());
+            for (const auto& x : buffer)
+                co_yield x;
+        }
+    }
+#endif
+}
+
+#endif
+
+#endif
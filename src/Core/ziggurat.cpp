@@ -0,0 +1,70 @@
+#include "ziggurat.h"
+
+namespace DiceForge
+{
+    namespace ziggurat
+    {
+        namespace
+        {
+            /// @brief Builds the layers of a decreasing density f with inverse f_inv
+            /// @param r start of the tail
+            /// @param v area of every layer (including the base one, with its tail)
+            template <typename F, typename FInv>
+            Tables build(real_t r, real_t v, F f, FInv f_inv)
+            {
+                Tables t;
+                t.x[0] = v / f(r);
+                t.x[1] = r;
+                for (int i = 2; i < layers; i++)
+                    t.x[i] = f_inv(f(t.x[i - 1]) + v / t.x[i - 1]);
+                t.x[layers] = 0;
+                for (int i = 0; i <= layers; i++)
+                    t.f[i] = f(t.x[i]);
+                return t;
+            }
+        }
+
+        const Tables& normal()
+        {
+            static const Tables tables = build(3.6541528853610088, 0.00492867323399,
+                [](real_t x) { return std::exp(-0.5 * x * x); },
+                [](real_t y) { return std::sqrt(-2.0 * std::log(y)); });
+            return tables;
+        }
+
+        const Tables& exponential()
+        {
+            static const Tables tables = build(7.69711747013104972, 0.0039496598225815571993,
+                [](real_t x) { return std::exp(-x); },
+                [](real_t y) { return -std::log(y); });
+            return tables;
+        }
+
+        namespace
+        {
+            // Rounded towards 0, so that a candidate accepted straight away is always inside its layer
+            FloatTables narrow(const Tables& t)
+            {
+                FloatTables f;
+                for (int i = 0; i <= layers; i++) {
+                    f.x[i] = float(t.x[i]);
+                    if (f.x[i] > t.x[i])
+                        f.x[i] = std::nextafter(f.x[i], 0.0f);
+                }
+                return f;
+            }
+        }
+
+        const FloatTables& normal_float()
+        {
+            static const FloatTables tables = narrow(normal());
+            return tables;
+        }
+
+        const FloatTables& exponential_float()
+        {
+            static const FloatTables tables = narrow(exponential());
+            return tables;
+        }
+    }
+}
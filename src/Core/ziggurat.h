@@ -0,0 +1,185 @@
+/***ZIGGURAT SAMPLERS***/
+/*the density is covered by 256 horizontal layers of equal area, so a random
+layer and a random point across it are accepted straight away unless the point
+falls in the part of the layer overhanging the curve (Marsaglia and Tsang)*/
+
+#ifndef DF_ZIGGURAT_H
+#define DF_ZIGGURAT_H
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include "types.h"
+#include "generator.h"
+
+namespace DiceForge
+{
+    namespace ziggurat
+    {
+        // Number of layers, the index of a layer is read from the low bits of a random integer
+        constexpr int layers = 256;
+
+        /// @brief Layer edges x[0] > x[1] > ... > x[layers] = 0 and the density f[i] at x[i]
+        /// @note Layer i spans [0, x[i]) and lies between heights f[i] and f[i + 1], x[1] is where the tail
+        /// starts and x[0] is the width the base layer would have if the tail were a rectangle
+        struct Tables
+        {
+            real_t x[layers + 1];
+            real_t f[layers + 1];
+        };
+
+        /// @brief Tables for the standard normal density exp(-x^2 / 2)
+        const Tables& normal();
+        /// @brief Tables for the standard exponential density exp(-x)
+        const Tables& exponential();
+
+        /// @brief The layer edges of Tables in single precision, for the float samplers
+        struct FloatTables
+        {
+            float x[layers + 1];
+        };
+
+        /// @brief normal().x in single precision
+        const FloatTables& normal_float();
+        /// @brief exponential().x in single precision
+        const FloatTables& exponential_float();
+
+        // Variates drawn at a time by the float samplers
+        constexpr size_t float_block = 256;
+
+        /// @brief Returns a standard normal variate
+        template <typename Derived, typename T>
+        real_t next_normal(StaticGenerator<Derived, T>& rng)
+        {
+            const Tables& t = normal();
+            DF_INSTRUMENT_METHOD("ziggurat normal", 1);
+            while (true) {
+                // Bits 0-7 pick the layer, bit 8 the sign and the top 53 bits the position across the layer
+                uint64_t bits = detail::bits64(rng);
+                int i = int(bits & 0xFF);
+                real_t x = real_t(bits >> 11) * (1.0 / 9007199254740992.0) * t.x[i];
+                real_t sign = (bits & 0x100) ? -1.0 : 1.0;
+                if (x < t.x[i + 1])
+                    return sign * x;
+                if (i == 0) {
+                    // Tail beyond x[1], by Marsaglia's method
+                    real_t r = t.x[1], a, b;
+                    do {
+                        a = -std::log(1.0 - rng.next_unit()) / r;
+                        b = -std::log(1.0 - rng.next_unit());
+                        if (2 * b < a * a)
+                            DF_INSTRUMENT_METHOD_REJECT("ziggurat normal");
+                    } while (2 * b < a * a);
+                    return sign * (r + a);
+                }
+                if (t.f[i] + rng.next_unit() * (t.f[i + 1] - t.f[i]) < std::exp(-0.5 * x * x))
+                    return sign * x;
+                DF_INSTRUMENT_METHOD_REJECT("ziggurat normal");
+            }
+        }
+
+        /// @brief Returns a standard exponential variate
+        template <typename Derived, typename T>
+        real_t next_exponential(StaticGenerator<Derived, T>& rng)
+        {
+            const Tables& t = exponential();
+            DF_INSTRUMENT_METHOD("ziggurat exponential", 1);
+            while (true) {
+                uint64_t bits = detail::bits64(rng);
+                int i = int(bits & 0xFF);
+                real_t x = real_t(bits >> 11) * (1.0 / 9007199254740992.0) * t.x[i];
+                if (x < t.x[i + 1])
+                    return x;
+                if (i == 0) {
+                    // The tail beyond x[1] is the distribution itself, shifted
+                    return t.x[1] - std::log(1.0 - rng.next_unit());
+                }
+                if (t.f[i] + rng.next_unit() * (t.f[i + 1] - t.f[i]) < std::exp(-x))
+                    return x;
+                DF_INSTRUMENT_METHOD_REJECT("ziggurat exponential");
+            }
+        }
+
+        /// @brief Fills the buffer with standard normal variates in single precision
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @param out Pointer to the first element of the buffer
+        /// @param n Number of variates to be written
+        /// @note A candidate takes 32 random bits (two per 64-bit integer, see fill_fixed): bits 0-7 pick the
+        /// layer, bit 8 the sign and the top 23 the position across the layer. The candidates of a block are
+        /// computed without branches, then the few outside the inner part of their layer go through the wedge or
+        /// tail test, and are redrawn in double precision by next_normal when they fail it.
+        template <typename Derived, typename T>
+        void fill_normal(StaticGenerator<Derived, T>& rng, float* out, size_t n)
+        {
+            const Tables& t = normal();
+            const FloatTables& ft = normal_float();
+            uint32_t bits[float_block];
+            DF_INSTRUMENT_METHOD("ziggurat normal float", n);
+            while (n > 0) {
+                size_t m = std::min(n, float_block);
+                rng.fill_fixed(bits, m);
+                for (size_t j = 0; j < m; j++) {
+                    // 1 - 2 * (bit 8) rather than a branch on the sign, which would be mispredicted half the time
+                    float sign = 1.0f - float((bits[j] >> 7) & 2);
+                    out[j] = sign * float(bits[j] >> 9) * (1.0f / 8388608.0f) * ft.x[bits[j] & 0xFF];
+                }
+                for (size_t j = 0; j < m; j++) {
+                    int i = int(bits[j] & 0xFF);
+                    real_t x = std::fabs(out[j]);
+                    if (x < ft.x[i + 1])
+                        continue;
+                    if (i == 0) {
+                        real_t r = t.x[1], a, b;
+                        do {
+                            a = -std::log(1.0 - rng.next_unit()) / r;
+                            b = -std::log(1.0 - rng.next_unit());
+                            if (2 * b < a * a)
+                                DF_INSTRUMENT_METHOD_REJECT("ziggurat normal float");
+                        } while (2 * b < a * a);
+                        // The candidate is past x[1] > 0, so it still carries the sign
+                        out[j] = std::copysign(float(r + a), out[j]);
+                    }
+                    else if (!(t.f[i] + rng.next_unit() * (t.f[i + 1] - t.f[i]) < std::exp(-0.5 * x * x))) {
+                        DF_INSTRUMENT_METHOD_REJECT("ziggurat normal float");
+                        out[j] = float(next_normal(rng));
+                    }
+                }
+                out += m;
+                n -= m;
+            }
+        }
+
+        /// @brief Fills the buffer with standard exponential variates in single precision
+        /// @note As fill_normal, with bits 0-7 picking the layer and the top 24 the position across it
+        template <typename Derived, typename T>
+        void fill_exponential(StaticGenerator<Derived, T>& rng, float* out, size_t n)
+        {
+            const Tables& t = exponential();
+            const FloatTables& ft = exponential_float();
+            uint32_t bits[float_block];
+            DF_INSTRUMENT_METHOD("ziggurat exponential float", n);
+            while (n > 0) {
+                size_t m = std::min(n, float_block);
+                rng.fill_fixed(bits, m);
+                for (size_t j = 0; j < m; j++)
+                    out[j] = float(bits[j] >> 8) * (1.0f / 16777216.0f) * ft.x[bits[j] & 0xFF];
+                for (size_t j = 0; j < m; j++) {
+                    int i = int(bits[j] & 0xFF);
+                    real_t x = out[j];
+                    if (x < ft.x[i + 1])
+                        continue;
+                    if (i == 0)
+                        out[j] = float(t.x[1] - std::log(1.0 - rng.next_unit()));
+                    else if (!(t.f[i] + rng.next_unit() * (t.f[i + 1] - t.f[i]) < std::exp(-x))) {
+                        DF_INSTRUMENT_METHOD_REJECT("ziggurat exponential float");
+                        out[j] = float(next_exponential(rng));
+                    }
+                }
+                out += m;
+                n -= m;
+            }
+        }
+    }
+}
+
+#endif
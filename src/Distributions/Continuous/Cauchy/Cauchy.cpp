@@ -1,5 +1,6 @@
 #include "Cauchy.h"
-#include "basicfxn.h"
+#include "fitting.h"
+#include <algorithm>
 
 namespace DiceForge
 {            
@@ -17,6 +18,21 @@ namespace DiceForge
         return gamma * tan(M_PI * (r - 0.5)) + x0;
     }
 
+    void Cauchy::transform(real_t* r, size_t n) const
+    {
+        // Kept free of branches and calls other than tan so that it can be vectorised
+        const real_t g = gamma, x = x0;
+        for (size_t i = 0; i < n; i++)
+            r[i] = g * tan(M_PI * (r[i] - 0.5)) + x;
+    }
+
+    void Cauchy::transform(float* r, size_t n) const
+    {
+        const float g = float(gamma), x = float(x0), pi = float(M_PI);
+        for (size_t i = 0; i < n; i++)
+            r[i] = g * std::tan(pi * (r[i] - 0.5f)) + x;
+    }
+
     real_t Cauchy::variance() const 
     {
         return std::numeric_limits<real_t>().quiet_NaN();
@@ -29,7 +45,7 @@ namespace DiceForge
 
     real_t Cauchy::minValue() const 
     {
-        return std::numeric_limits<real_t>().min();
+        return std::numeric_limits<real_t>().lowest();
     }
 
     real_t Cauchy::maxValue() const 
@@ -44,7 +60,58 @@ namespace DiceForge
 
     real_t Cauchy::cdf(real_t x) const 
     {        
-        return M_1_PI * atan((x - x0) * inv_gamma) + 0.5;
+        // 1/2 + atan(z) / pi = atan(-1 / z) / pi for z < 0, without the cancellation in the lower tail
+        real_t z = (x - x0) * inv_gamma;
+        return (z < 0) ? M_1_PI * atan(-1 / z) : M_1_PI * atan(z) + 0.5;
+    }
+
+    real_t Cauchy::logpdf(real_t x) const
+    {
+        real_t z = (x - x0) * inv_gamma;
+        return log(M_1_PI * inv_gamma) - log1p(z * z);
+    }
+
+    void Cauchy::pdf(const real_t* x, real_t* out, size_t n) const
+    {
+        const real_t c = M_1_PI * inv_gamma, s = inv_gamma, m = x0;
+        for (size_t i = 0; i < n; i++)
+        {
+            real_t z = (x[i] - m) * s;
+            out[i] = c / (1 + z * z);
+        }
+    }
+
+    void Cauchy::logpdf(const real_t* x, real_t* out, size_t n) const
+    {
+        const real_t c = log(M_1_PI * inv_gamma), s = inv_gamma, m = x0;
+        for (size_t i = 0; i < n; i++)
+        {
+            real_t z = (x[i] - m) * s;
+            out[i] = c - log1p(z * z);
+        }
+    }
+
+    void Cauchy::cdf(const real_t* x, real_t* out, size_t n) const
+    {
+        const real_t s = inv_gamma, m = x0;
+        for (size_t i = 0; i < n; i++)
+        {
+            real_t z = (x[i] - m) * s;
+            out[i] = (z < 0) ? M_1_PI * atan(-1 / z) : M_1_PI * atan(z) + 0.5;
+        }
+    }
+
+    real_t Cauchy::quantile(real_t p) const
+    {
+        detail::check_probability(p);
+        // tan(pi (p - 1/2)) = -1 / tan(pi p), in whichever tail p is, as 1 - p is exact above 1/2
+        return (p < 0.5) ? x0 - gamma / tan(M_PI * p) : x0 + gamma / tan(M_PI * (1 - p));
+    }
+
+    void Cauchy::quantile(const real_t* p, real_t* out, size_t n) const
+    {
+        for (size_t i = 0; i < n; i++)
+            out[i] = quantile(p[i]);
     }
 
     real_t Cauchy::get_x0() const 
@@ -66,23 +133,21 @@ namespace DiceForge
 
         const int N = x.size();
 
-        // sort the arrays in increasing x
-        for (size_t i = 0; i < N-1; i++)
+        // sort the points in increasing x
+        std::vector<size_t> order(N);
+        for (size_t i = 0; i < N; i++)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), [&x](size_t a, size_t b) { return x[a] < x[b]; });
         {
-            for (size_t j = 0; j < N-1-i; j++)
+            std::vector<real_t> xs(N), ys(N);
+            for (size_t i = 0; i < N; i++)
             {
-                if (x[j] > x[j+1])
-                {
-                    real_t tx = x[j];
-                    x[j] = x[j+1];
-                    x[j+1] = tx;
-
-                    real_t ty = y[j];
-                    y[j] = y[j+1];
-                    y[j+1] = ty;
-                }
+                xs[i] = x[order[i]];
+                ys[i] = y[order[i]];
             }
-        }     
+            x.swap(xs);
+            y.swap(ys);
+        }
 
         // initial guessing of x0, gamma
         real_t x0 = 0, gamma = 1;
@@ -113,63 +178,111 @@ namespace DiceForge
         // interquartile guess works reasonably well for gamma
         gamma = (x[(int)round(3 * N/4.0)] - x[(int)round(N/4.0)]) * 0.4;
 
-        // start iterative updation
-        for (size_t i = 0; i < max_iter; i++)
+        // r_i = y[i] - pdf(x0, gamma, x[i]), minimise sum (r_i)^2 over (x0, gamma)
+        auto model = [](auto x, const real_t* theta, auto* grad)
         {
-            real_t inv_gamma = 1 / gamma;
+            typedef decltype(x) V;
+            real_t x0 = theta[0], gamma = theta[1];
+            if (!(gamma > 0))
+                return V(NAN);
+            V dx = x - x0, dx2 = dx * dx;
+            V inv_D = 1 / (dx2 + gamma * gamma);
+            V pdf = inv_D * (M_1_PI * gamma);
+            grad[0] = dx * inv_D * inv_D * (2 * M_1_PI * gamma);
+            grad[1] = (dx2 - gamma * gamma) * inv_D * inv_D * M_1_PI;
+            return pdf;
+        };
+
+        real_t theta[2] = {x0, gamma};
+        levenberg_marquardt<2>(model, x.data(), y.data(), N, theta, max_iter, epsilon);
+        x0 = theta[0];
+        gamma = theta[1];
 
-            // r_i = y[i] - pdf(x0, gamma, x[i])
-            // we try to minimize sum (r_i)^2 and iteratively update x0, inv_gamma
+        if (gamma < 0 || std::isnan(x0) || std::isnan(gamma))
+        {
+            throw std::runtime_error("Could not fit data to Cauchy! Data is probably too noisy or not Cauchy!");
+        }
 
-            matrix_t J = matrix_t(N, 2);    // Jacobian matrix
-            matrix_t R = matrix_t(N, 1);    // Error vector R = (r_0, r_1, ..., r_N)
+        return Cauchy(x0, gamma);
+    }
 
-            for (size_t i = 0; i < N; i++)
-            {
-                real_t q1 = (x[i] - x0) * inv_gamma;
-                real_t q2 = (1 + q1 * q1) * (1 + q1 * q1);      
-                real_t dpdf_dx0 = 2 * M_1_PI * q1 * inv_gamma * inv_gamma / q2; 
-                real_t dpdf_dgamma = - M_1_PI * (1 + 3 * q1 * q1) * inv_gamma * inv_gamma / q2;
+    Cauchy fitCauchyFromSamples(const std::vector<real_t>& samples, int max_iter, real_t epsilon)
+    {
+        const size_t N = samples.size();
+        if (N < 4)
+        {
+            throw std::runtime_error("Could not fit samples to Cauchy! At least four samples are needed!");
+        }
 
-                J[i][0] = -dpdf_dx0;
-                J[i][1] = -dpdf_dgamma;
+        // median and quartiles in linear time
+        std::vector<real_t> s(samples);
+        auto quantile = [&](size_t i)
+        {
+            std::nth_element(s.begin(), s.begin() + i, s.end());
+            return s[i];
+        };
+        real_t x0 = quantile(N / 2);
+        real_t gamma = 0.5 * (quantile(3 * N / 4) - quantile(N / 4));
+        if (!(gamma > 0))
+        {
+            throw std::runtime_error("Could not fit samples to Cauchy! Samples are probably not Cauchy!");
+        }
 
-                R[i][0] = y[i] - M_1_PI * inv_gamma / (1 + (x[i] - x0) * (x[i] - x0) * inv_gamma * inv_gamma);
+        // log-likelihood l = sum log(gamma) - log(gamma^2 + d^2), d = x - x0, with its gradient
+        auto pass = [&](real_t x0, real_t gamma, real_t& dx0, real_t& dgamma)
+        {
+            real_t l = 0, g2 = gamma * gamma;
+            dx0 = dgamma = 0;
+            for (size_t i = 0; i < N; i++)
+            {
+                real_t d = samples[i] - x0, D = g2 + d * d;
+                l -= log(D);
+                dx0 += 2 * d / D;
+                dgamma -= 2 * gamma / D;
             }
-
-            matrix_t JT = J.transpose();
-
-            // move direction
-            matrix_t d = inverse2x2(JT * J) * JT * R;
-
-            // stop when error minimization is too little
-            if (fabs(d[0][0]) < epsilon && fabs(d[1][0]) < epsilon)
-                break;
-
-            // make finer refinements later on
-            // c/sqrt(i) works as a reasonable good learning rate for a cauchy fit
-            real_t alpha = 1/sqrt(i+1); 
-            
-            real_t pred_x0, pred_gamma;
-            pred_x0 = x0 - alpha * d[0][0];
-            pred_gamma = gamma - alpha * d[1][0];
-
-            // prevent possible incorrect jumping
-            if ((pred_x0 / x0 > 10 || pred_gamma / gamma > 10 || pred_x0 / x0 < 0.1 || pred_gamma / gamma < 0.1))
+            dgamma += N / gamma;
+            return l + N * log(gamma);
+        };
+
+        // Fisher scoring: the information is N / (2 gamma^2) times the identity, so the step is the gradient scaled by
+        // 2 gamma^2 / N, halved until the likelihood increases
+        real_t dx0, dgamma;
+        real_t l = pass(x0, gamma, dx0, dgamma);
+        for (int i = 0; i < max_iter; i++)
+        {
+            real_t scale = 2 * gamma * gamma / N;
+            real_t step_x0 = scale * dx0, step_gamma = scale * dgamma;
+            bool accepted = false;
+            for (int halving = 0; halving < 30; halving++)
             {
-                alpha = alpha * 0.01;
+                real_t trial_x0 = x0 + step_x0, trial_gamma = gamma + step_gamma;
+                if (trial_gamma > 0)
+                {
+                    real_t tx0, tgamma;
+                    real_t tl = pass(trial_x0, trial_gamma, tx0, tgamma);
+                    if (tl >= l)
+                    {
+                        x0 = trial_x0;
+                        gamma = trial_gamma;
+                        l = tl;
+                        dx0 = tx0;
+                        dgamma = tgamma;
+                        accepted = true;
+                        break;
+                    }
+                }
+                step_x0 *= 0.5;
+                step_gamma *= 0.5;
             }
-
-            // Gauss-Newton method
-            x0 = x0 - alpha * d[0][0];
-            gamma = gamma - alpha * d[1][0];
+            if (!accepted || (fabs(step_x0) <= epsilon * gamma && fabs(step_gamma) <= epsilon * gamma))
+                break;
         }
 
-        if (gamma < 0 || std::isnan(x0) || std::isnan(gamma))
+        if (!(gamma > 0) || std::isnan(x0))
         {
-            throw std::runtime_error("Could not fit data to Cauchy! Data is probably too noisy or not Cauchy!");
+            throw std::runtime_error("Could not fit samples to Cauchy! Samples are probably not Cauchy!");
         }
 
         return Cauchy(x0, gamma);
     }
-} 
\ No newline at end of file
+}
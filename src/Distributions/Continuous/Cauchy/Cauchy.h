@@ -2,6 +2,7 @@
 #define DF_CAUCHY_H
 
 #include "distribution.h"
+#include "generator.h"
 
 namespace DiceForge {
     /// @brief DiceForge::Cauchy - A Continuous Probability Distribution (Cauchy) 
@@ -17,6 +18,48 @@ namespace DiceForge {
             /// @brief Returns the next value of the random variable described by the distribution
             /// @param r A random real number uniformly distributed between 0 and 1
             real_t next(real_t r);
+            /// @brief Replaces n uniformly distributed unit random variables in place with values of the random variable
+            /// @param r Pointer to the first of the random variables, each as would be passed to next(r)
+            /// @param n Number of random variables
+            void transform(real_t* r, size_t n) const;
+            /// @brief Replaces n uniformly distributed unit random variables in place with values of the random
+            /// variable, in single precision
+            void transform(float* r, size_t n) const;
+            /// @brief Fills the buffer with values of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param out Pointer to the first element of the buffer
+            /// @param n Number of values to be written
+            /// @note The uniforms are drawn in bulk and transformed in one pass (see transform)
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, real_t* out, size_t n)
+            {
+                DF_INSTRUMENT_SAMPLES("Cauchy", n);
+                rng.fill_unit(out, n);
+                transform(out, n);
+            }
+            /// @brief Fills the buffer with single precision values of the random variable
+            /// @note Single precision uniforms (see StaticGenerator::fill_unit), transformed in single precision
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, float* out, size_t n)
+            {
+                DF_INSTRUMENT_SAMPLES("Cauchy", n);
+                rng.fill_unit(out, n);
+                transform(out, n);
+            }
+#if defined(DF_SPAN)
+            /// @brief Fills the span with values of the random variable described by the distribution
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<real_t> out)
+            {
+                sample(rng, out.data(), out.size());
+            }
+            /// @brief Fills the span with single precision values of the random variable
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<float> out)
+            {
+                sample(rng, out.data(), out.size());
+            }
+#endif
             /// @brief Returns the theoretical variance of the distribution
             /// @note The variation of a Cauchy distribution is undefined
             /// @returns NaN
@@ -35,6 +78,19 @@ namespace DiceForge {
             real_t pdf(real_t x) const override final;
             /// @brief Cumulative distribution function of the Cauchy distribution
             real_t cdf(real_t x) const override final;
+            /// @brief Natural logarithm of the probability density function of the Cauchy distribution
+            real_t logpdf(real_t x) const override final;
+            /// @brief Probability density function of the Cauchy distribution at the n locations x, written to out
+            void pdf(const real_t* x, real_t* out, size_t n) const override final;
+            /// @brief Logarithm of the probability density function at the n locations x, written to out
+            void logpdf(const real_t* x, real_t* out, size_t n) const override final;
+            /// @brief Cumulative distribution function at the n locations x, written to out
+            void cdf(const real_t* x, real_t* out, size_t n) const override final;
+            /// @brief Quantile function (inverse cdf) of the Cauchy distribution
+            /// @note x0 + gamma tan(pi (p - 1/2)), as -gamma / tan(pi p) or gamma / tan(pi (1 - p)) from the nearer tail
+            real_t quantile(real_t p) const override final;
+            /// @brief Quantile function at the n probabilities p, written to out (out may be p)
+            void quantile(const real_t* p, real_t* out, size_t n) const override final;
             /// @brief Returns x0 (centre of the distribution) 
             real_t get_x0() const;
             /// @brief Returns gamma (scale factor of the distribution) 
@@ -49,6 +105,17 @@ namespace DiceForge {
     /// @param epsilon minimum acceptable error tolerance while attempting to fit the data (smaller to try for better fits)
     /// @return A Cauchy distribution fit to the given sample points
     Cauchy fitToCauchy(std::vector<real_t> x, std::vector<real_t> y, int max_iter = 10000, real_t epsilon = 1e-6);
+
+    /// @brief Fits a Cauchy distribution to raw samples by maximum likelihood, with no binning. The sample median and
+    /// half the interquartile range (found in linear time) start Fisher scoring on the log-likelihood, each iteration
+    /// being one pass over the samples.
+    /// @param samples list of samples
+    /// @param max_iter maximum scoring iterations
+    /// @param epsilon change in x0 and gamma, relative to gamma, below which the fit has converged
+    /// @return The maximum likelihood Cauchy distribution of the samples
+    /// @note The Cauchy distribution has no finite sufficient statistics, so unlike the other distributions there is no
+    /// mergeable accumulator for it
+    Cauchy fitCauchyFromSamples(const std::vector<real_t>& samples, int max_iter = 100, real_t epsilon = 1e-12);
 }
 
 
@@ -0,0 +1,577 @@
+#ifndef DF_COMPOSITE_H
+#define DF_COMPOSITE_H
+
+#include "distribution.h"
+#include "generator.h"
+#include "quadrature.h"
+#include "types.h"
+#include <array>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace DiceForge {
+    namespace detail
+    {
+        // Values handled at a time by the batch functions of the composite distributions
+        constexpr size_t composite_block = 256;
+
+        // A uniform of next_unit or fill_unit (at most 53 bits in [0, 1)) moved up by 2^-54, into (0, 1)
+        inline real_t open_unit(real_t u)
+        {
+            return u + real_t(0.5) * std::numeric_limits<real_t>::epsilon() / 2;
+        }
+    }
+
+    /// @brief DiceForge::Mixture - A distribution drawing each value from one of its components, chosen at random
+    /// with the given weights (such as 95% Gaussian + 5% Exponential for a latency with a heavy tail)
+    /// @details The components are kept by value and their types are known at compile time, so that next and
+    /// sample call their own next and sample directly rather than through Continuous. sample(rng, out, n) takes a
+    /// block of uniforms to choose the components, groups the positions of the block by component and fills
+    /// them with one call to the sample of each component, so every component fills its share in a batch.
+    /// @tparam D the types of the components (such as Gaussian, Exponential, or Truncated<Cauchy>)
+    template <typename... D>
+    class Mixture : public Continuous {
+        static_assert(sizeof...(D) >= 1 && sizeof...(D) <= 255, "A Mixture has between 1 and 255 components");
+        static_assert((std::is_base_of_v<Continuous, D> && ...), "The components of a Mixture are Continuous");
+    public:
+        static constexpr size_t size = sizeof...(D);
+    private:
+        std::tuple<D...> components;
+        std::array<real_t, size> weights;
+        // cumulative[k] = weights[0] + ... + weights[k], the last one being exactly 1
+        std::array<real_t, size> cumulative;
+
+        // Index of the component chosen by the uniform u, the number of cumulative weights below or at u
+        size_t choose(real_t u) const
+        {
+            size_t k = 0;
+            for (size_t j = 0; j + 1 < size; j++)
+                k += (u >= cumulative[j]);
+            return k;
+        }
+        // Calls f(component, index) for every component in turn
+        template <typename F, size_t... I>
+        void each(F&& f, std::index_sequence<I...>) const
+        {
+            (f(std::get<I>(components), I), ...);
+        }
+        template <typename F, size_t... I>
+        void each(F&& f, std::index_sequence<I...>)
+        {
+            (f(std::get<I>(components), I), ...);
+        }
+        // Returns f(component k)
+        template <size_t I = 0, typename F>
+        real_t visit(size_t k, F&& f)
+        {
+            if constexpr (I + 1 < size) {
+                if (k != I)
+                    return visit<I + 1>(k, f);
+            }
+            return f(std::get<I>(components));
+        }
+        // Sums w_k f(component k, x, tmp, n) over the components, a block at a time, for the batch pdf and cdf
+        template <typename F>
+        void weighted_sum(F f, const real_t* x, real_t* out, size_t n) const
+        {
+            real_t tmp[detail::composite_block], sum[detail::composite_block];
+            for (size_t first = 0; first < n; first += detail::composite_block) {
+                const size_t b = std::min(n - first, detail::composite_block);
+                std::fill(sum, sum + b, real_t(0));
+                each([&](const auto& d, size_t k) {
+                    f(d, x + first, tmp, b);
+                    for (size_t i = 0; i < b; i++)
+                        sum[i] += weights[k] * tmp[i];
+                }, std::index_sequence_for<D...>());
+                std::copy(sum, sum + b, out + first);
+            }
+        }
+    public:
+        /// @brief A mixture of the components with the given weights
+        /// @param weights the relative weights of the components (>= 0, not all 0), normalised to sum to 1
+        /// @param components the distributions mixed
+        /// @note std::invalid_argument is thrown for negative or infinite weights, or weights summing to 0
+        Mixture(const std::array<real_t, size>& weights, const D&... components)
+            : components(components...), weights(weights)
+        {
+            real_t total = 0;
+            for (real_t w : weights) {
+                if (!(w >= 0) || !std::isfinite(w))
+                    throw std::invalid_argument("The weights of a Mixture must be non-negative and finite!");
+                total += w;
+            }
+            if (!(total > 0))
+                throw std::invalid_argument("The weights of a Mixture must not all be 0!");
+            real_t sum = 0;
+            for (size_t k = 0; k < size; k++) {
+                this->weights[k] = weights[k] / total;
+                sum += this->weights[k];
+                cumulative[k] = sum;
+            }
+            cumulative[size - 1] = 1;
+        }
+
+        /// @brief Returns the next value of the random variable described by the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @note One uniform to choose the component, then the next value of that component
+        template <typename Derived, typename T>
+        real_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+        {
+            DF_INSTRUMENT_SAMPLES("Mixture", 1);
+            return visit(choose(rng.next_unit()), [&](auto& d) { return real_t(d.next(rng)); });
+        }
+        /// @brief Fills the buffer with values of the random variable described by the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @param out Pointer to the first element of the buffer
+        /// @param n Number of values to be written
+        /// @note A block of 256 uniforms chooses the components of 256 values; the positions are sorted by
+        /// component (a counting sort), and each component fills its positions from one call to its sample
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, real_t* out, size_t n)
+        {
+            DF_INSTRUMENT_SAMPLES("Mixture", n);
+            constexpr size_t block = detail::composite_block;
+            real_t u[block], values[block];
+            unsigned char label[block];
+            unsigned short order[block];
+            for (size_t first = 0; first < n; first += block) {
+                const size_t b = std::min(n - first, block);
+                rng.fill_unit(u, b);
+                size_t start[size + 1] = {};
+                for (size_t i = 0; i < b; i++) {
+                    label[i] = (unsigned char)(choose(u[i]));
+                    start[label[i] + 1]++;
+                }
+                for (size_t k = 0; k < size; k++)
+                    start[k + 1] += start[k];
+                size_t slot[size];
+                std::copy(start, start + size, slot);
+                for (size_t i = 0; i < b; i++)
+                    order[slot[label[i]]++] = (unsigned short)(i);
+
+                real_t* block_out = out + first;
+                each([&](auto& d, size_t k) {
+                    const size_t count = start[k + 1] - start[k];
+                    if (count == 0)
+                        return;
+                    d.sample(rng, values, count);
+                    for (size_t j = 0; j < count; j++)
+                        block_out[order[start[k] + j]] = values[j];
+                }, std::index_sequence_for<D...>());
+            }
+        }
+#if defined(DF_SPAN)
+        /// @brief Fills the span with values of the random variable described by the distribution
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<real_t> out)
+        {
+            sample(rng, out.data(), out.size());
+        }
+#endif
+
+        /// @brief Returns component I
+        template <size_t I>
+        const auto& get_component() const
+        {
+            return std::get<I>(components);
+        }
+        /// @brief Returns the (normalised) weight of component k
+        real_t get_weight(size_t k) const
+        {
+            if (k >= size)
+                throw std::out_of_range("No such component in the Mixture!");
+            return weights[k];
+        }
+
+        /// @brief The weighted sum of the expectations of the components
+        real_t expectation() const override final
+        {
+            real_t mean = 0;
+            each([&](const auto& d, size_t k) { mean += weights[k] * d.expectation(); }, std::index_sequence_for<D...>());
+            return mean;
+        }
+        /// @brief The weighted variances of the components plus the variance of their expectations
+        real_t variance() const override final
+        {
+            const real_t mean = expectation();
+            real_t var = 0;
+            each([&](const auto& d, size_t k) {
+                const real_t offset = d.expectation() - mean;
+                var += weights[k] * (d.variance() + offset * offset);
+            }, std::index_sequence_for<D...>());
+            return var;
+        }
+        /// @brief The smallest minimum of the components of positive weight
+        real_t minValue() const override final
+        {
+            real_t lower = INFINITY;
+            each([&](const auto& d, size_t k) {
+                if (weights[k] > 0)
+                    lower = std::min(lower, d.minValue());
+            }, std::index_sequence_for<D...>());
+            return lower;
+        }
+        /// @brief The largest maximum of the components of positive weight
+        real_t maxValue() const override final
+        {
+            real_t upper = -INFINITY;
+            each([&](const auto& d, size_t k) {
+                if (weights[k] > 0)
+                    upper = std::max(upper, d.maxValue());
+            }, std::index_sequence_for<D...>());
+            return upper;
+        }
+        /// @brief The weighted sum of the pdfs of the components
+        real_t pdf(real_t x) const override final
+        {
+            real_t p = 0;
+            each([&](const auto& d, size_t k) { p += weights[k] * d.pdf(x); }, std::index_sequence_for<D...>());
+            return p;
+        }
+        /// @brief The weighted sum of the cdfs of the components
+        real_t cdf(real_t x) const override final
+        {
+            real_t p = 0;
+            each([&](const auto& d, size_t k) { p += weights[k] * d.cdf(x); }, std::index_sequence_for<D...>());
+            return std::min(p, real_t(1));
+        }
+        /// @brief Evaluates the pdf at n locations, with the batch pdf of every component
+        void pdf(const real_t* x, real_t* out, size_t n) const override final
+        {
+            weighted_sum([](const auto& d, const real_t* x, real_t* y, size_t b) { d.pdf(x, y, b); }, x, out, n);
+        }
+        /// @brief Evaluates the cdf at n locations, with the batch cdf of every component
+        void cdf(const real_t* x, real_t* out, size_t n) const override final
+        {
+            weighted_sum([](const auto& d, const real_t* x, real_t* y, size_t b) { d.cdf(x, y, b); }, x, out, n);
+            for (size_t i = 0; i < n; i++)
+                out[i] = std::min(out[i], real_t(1));
+        }
+    };
+
+    /// @brief DiceForge::Truncated - A distribution restricted to an interval [lower, upper], its density there
+    /// divided by the probability of the interval
+    /// @details Sampled by the inverse cdf rather than by rejection: a uniform u becomes
+    /// quantile(cdf(lower) + u (cdf(upper) - cdf(lower))), so the cost does not depend on the probability of the
+    /// interval and sample(rng, out, n) is one fill_unit and one call to the batch quantile of the distribution.
+    /// The interval must hold a probability the cdf resolves: far in a tail where cdf rounds to 0 or 1 the
+    /// values are only as fine as the doubles near that probability.
+    /// @tparam D the type of the distribution (such as Gaussian or Cauchy)
+    template <typename D>
+    class Truncated : public Continuous {
+        static_assert(std::is_base_of_v<Continuous, D>, "A Truncated distribution is Continuous");
+    private:
+        D dist;
+        real_t lower, upper;
+        // cdf(lower) and the probability of [lower, upper]
+        real_t cdf_lower, mass;
+
+        // The value of probability p in [0, 1] in the distribution, clamped to the interval
+        real_t inverse(real_t p) const
+        {
+            return std::clamp(dist.quantile(std::min(cdf_lower + p * mass, real_t(1))), lower, upper);
+        }
+        // The expectation of f(x) by quadrature over the probabilities, x = quantile(p) being finite inside (0, 1)
+        template <typename F>
+        real_t integrate(F f) const
+        {
+            return integrate_adaptive([&](const real_t* p, real_t* out, size_t n) {
+                quantile(p, out, n);
+                for (size_t i = 0; i < n; i++)
+                    out[i] = f(out[i]);
+            }, real_t(0), real_t(1)).value;
+        }
+    public:
+        /// @brief The distribution dist restricted to [lower, upper] (met with its own support)
+        /// @note std::invalid_argument is thrown when the interval is empty or has no probability
+        Truncated(const D& dist, real_t lower, real_t upper)
+            : dist(dist), lower(std::max(lower, dist.minValue())), upper(std::min(upper, dist.maxValue()))
+        {
+            if (!(this->lower < this->upper))
+                throw std::invalid_argument("The interval of a Truncated distribution must not be empty!");
+            cdf_lower = std::isfinite(this->lower) ? dist.cdf(this->lower) : 0;
+            const real_t cdf_upper = std::isfinite(this->upper) ? dist.cdf(this->upper) : 1;
+            mass = cdf_upper - cdf_lower;
+            if (!(mass > 0))
+                throw std::invalid_argument("The interval of a Truncated distribution has no probability!");
+        }
+
+        /// @brief Returns the next value of the random variable described by the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @note One uniform, through the quantile of the distribution
+        template <typename Derived, typename T>
+        real_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+        {
+            DF_INSTRUMENT_SAMPLES("Truncated", 1);
+            return inverse(detail::open_unit(rng.next_unit()));
+        }
+        /// @brief Fills the buffer with values of the random variable described by the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @param out Pointer to the first element of the buffer
+        /// @param n Number of values to be written
+        /// @note fill_unit, then the batch quantile of the distribution in place. The uniforms are moved up by
+        /// 2^-54, into (0, 1), so that no value falls on an infinite end.
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, real_t* out, size_t n)
+        {
+            DF_INSTRUMENT_SAMPLES("Truncated", n);
+            rng.fill_unit(out, n);
+            const real_t c = cdf_lower, m = mass;
+            for (size_t i = 0; i < n; i++)
+                out[i] = std::min(c + detail::open_unit(out[i]) * m, real_t(1));
+            dist.quantile(out, out, n);
+            for (size_t i = 0; i < n; i++)
+                out[i] = std::clamp(out[i], lower, upper);
+        }
+#if defined(DF_SPAN)
+        /// @brief Fills the span with values of the random variable described by the distribution
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<real_t> out)
+        {
+            sample(rng, out.data(), out.size());
+        }
+#endif
+
+        // The batch pdf, cdf and log-pdf of Continuous, over the ones below
+        using Continuous::pdf;
+        using Continuous::cdf;
+        using Continuous::logpdf;
+
+        /// @brief Returns the distribution before truncation
+        const D& get_distribution() const
+        {
+            return dist;
+        }
+        /// @brief Returns the probability of the interval in the distribution before truncation
+        real_t get_mass() const
+        {
+            return mass;
+        }
+
+        /// @brief Expectation, by adaptive quadrature of the quantile over (0, 1)
+        real_t expectation() const override final
+        {
+            return integrate([](real_t x) { return x; });
+        }
+        /// @brief Variance, by adaptive quadrature of the quantile over (0, 1)
+        real_t variance() const override final
+        {
+            const real_t mean = expectation();
+            return integrate([mean](real_t x) { return (x - mean) * (x - mean); });
+        }
+        real_t minValue() const override final
+        {
+            return lower;
+        }
+        real_t maxValue() const override final
+        {
+            return upper;
+        }
+        real_t pdf(real_t x) const override final
+        {
+            return (x < lower || x > upper) ? 0 : dist.pdf(x) / mass;
+        }
+        real_t cdf(real_t x) const override final
+        {
+            if (x <= lower)
+                return 0;
+            if (x >= upper)
+                return 1;
+            return std::clamp((dist.cdf(x) - cdf_lower) / mass, real_t(0), real_t(1));
+        }
+        real_t logpdf(real_t x) const override final
+        {
+            return (x < lower || x > upper) ? -INFINITY : dist.logpdf(x) - std::log(mass);
+        }
+        /// @brief Quantile function, the quantile of the distribution at cdf(lower) + p (cdf(upper) - cdf(lower))
+        real_t quantile(real_t p) const override final
+        {
+            detail::check_probability(p);
+            if (p == 0)
+                return lower;
+            if (p == 1)
+                return upper;
+            return inverse(p);
+        }
+        /// @brief Quantile function at n probabilities at once, with the batch quantile of the distribution
+        /// (out may be p)
+        void quantile(const real_t* p, real_t* out, size_t n) const override final
+        {
+            for (size_t i = 0; i < n; i++)
+                detail::check_probability(p[i]);
+            const real_t c = cdf_lower, m = mass;
+            for (size_t i = 0; i < n; i++)
+                out[i] = std::min(c + p[i] * m, real_t(1));
+            dist.quantile(out, out, n);
+            for (size_t i = 0; i < n; i++)
+                out[i] = std::clamp(out[i], lower, upper);
+        }
+    };
+
+    /// @brief DiceForge::Affine - The distribution of location + scale X, X being drawn from another distribution
+    /// @details sample(rng, out, n) is the sample of the distribution followed by one multiply-add per value
+    /// @tparam D the type of the distribution (such as Exponential or Weibull)
+    template <typename D>
+    class Affine : public Continuous {
+        static_assert(std::is_base_of_v<Continuous, D>, "An Affine distribution is Continuous");
+    private:
+        D dist;
+        real_t location, scale;
+
+        // The value x of the transform as a value of the distribution
+        real_t inverse(real_t x) const
+        {
+            return (x - location) / scale;
+        }
+        // Applies f(const real_t* y, real_t* out, size_t b) to the values y of the distribution for the n values
+        // x, a block at a time
+        template <typename F>
+        void blocks(F f, const real_t* x, real_t* out, size_t n) const
+        {
+            real_t y[detail::composite_block];
+            for (size_t first = 0; first < n; first += detail::composite_block) {
+                const size_t b = std::min(n - first, detail::composite_block);
+                for (size_t i = 0; i < b; i++)
+                    y[i] = inverse(x[first + i]);
+                f(y, out + first, b);
+            }
+        }
+    public:
+        /// @brief The distribution of location + scale X, for X drawn from dist
+        /// @note scale may be negative, which mirrors the distribution; std::invalid_argument is thrown when it
+        /// is 0 or either parameter is not finite
+        Affine(const D& dist, real_t location, real_t scale)
+            : dist(dist), location(location), scale(scale)
+        {
+            if (!(scale != 0) || !std::isfinite(scale) || !std::isfinite(location))
+                throw std::invalid_argument("An Affine distribution needs a finite location and a finite, non-zero scale!");
+        }
+
+        /// @brief Returns the next value of the random variable described by the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        template <typename Derived, typename T>
+        real_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+        {
+            DF_INSTRUMENT_SAMPLES("Affine", 1);
+            return location + scale * real_t(dist.next(rng));
+        }
+        /// @brief Fills the buffer with values of the random variable described by the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @param out Pointer to the first element of the buffer
+        /// @param n Number of values to be written
+        /// @note The sample of the distribution, then a multiply-add per value in a separate loop
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, real_t* out, size_t n)
+        {
+            DF_INSTRUMENT_SAMPLES("Affine", n);
+            dist.sample(rng, out, n);
+            const real_t a = location, s = scale;
+            for (size_t i = 0; i < n; i++)
+                out[i] = a + s * out[i];
+        }
+#if defined(DF_SPAN)
+        /// @brief Fills the span with values of the random variable described by the distribution
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<real_t> out)
+        {
+            sample(rng, out.data(), out.size());
+        }
+#endif
+
+        // The batch log-pdf of Continuous, over the one below
+        using Continuous::logpdf;
+
+        /// @brief Returns the distribution transformed
+        const D& get_distribution() const
+        {
+            return dist;
+        }
+        /// @brief Returns the location (the shift)
+        real_t get_location() const
+        {
+            return location;
+        }
+        /// @brief Returns the scale (negative for a mirrored distribution)
+        real_t get_scale() const
+        {
+            return scale;
+        }
+
+        real_t expectation() const override final
+        {
+            return location + scale * dist.expectation();
+        }
+        real_t variance() const override final
+        {
+            return scale * scale * dist.variance();
+        }
+        real_t minValue() const override final
+        {
+            return location + scale * (scale > 0 ? dist.minValue() : dist.maxValue());
+        }
+        real_t maxValue() const override final
+        {
+            return location + scale * (scale > 0 ? dist.maxValue() : dist.minValue());
+        }
+        real_t pdf(real_t x) const override final
+        {
+            return dist.pdf(inverse(x)) / std::fabs(scale);
+        }
+        real_t cdf(real_t x) const override final
+        {
+            const real_t p = dist.cdf(inverse(x));
+            return scale > 0 ? p : 1 - p;
+        }
+        real_t logpdf(real_t x) const override final
+        {
+            return dist.logpdf(inverse(x)) - std::log(std::fabs(scale));
+        }
+        void pdf(const real_t* x, real_t* out, size_t n) const override final
+        {
+            const real_t factor = 1 / std::fabs(scale);
+            blocks([&](const real_t* y, real_t* o, size_t b) {
+                dist.pdf(y, o, b);
+                for (size_t i = 0; i < b; i++)
+                    o[i] *= factor;
+            }, x, out, n);
+        }
+        void cdf(const real_t* x, real_t* out, size_t n) const override final
+        {
+            blocks([&](const real_t* y, real_t* o, size_t b) {
+                dist.cdf(y, o, b);
+                if (scale < 0)
+                    for (size_t i = 0; i < b; i++)
+                        o[i] = 1 - o[i];
+            }, x, out, n);
+        }
+        /// @brief Quantile function, location + scale quantile(p) (quantile(1 - p) for a negative scale)
+        real_t quantile(real_t p) const override final
+        {
+            detail::check_probability(p);
+            return location + scale * dist.quantile(scale > 0 ? p : 1 - p);
+        }
+        /// @brief Quantile function at n probabilities at once, with the batch quantile of the distribution
+        /// (out may be p)
+        void quantile(const real_t* p, real_t* out, size_t n) const override final
+        {
+            if (scale > 0)
+                dist.quantile(p, out, n);
+            else {
+                for (size_t i = 0; i < n; i++)
+                    detail::check_probability(p[i]);
+                for (size_t i = 0; i < n; i++)
+                    out[i] = 1 - p[i];
+                dist.quantile(out, out, n);
+            }
+            const real_t a = location, s = scale;
+            for (size_t i = 0; i < n; i++)
+                out[i] = a + s * out[i];
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,238 @@
+#ifndef DF_ADAPTIVE_REJECTION_H
+#define DF_ADAPTIVE_REJECTION_H
+
+#include "types.h"
+#include "generator.h"
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <cmath>
+
+namespace DiceForge {
+    /// @brief DiceForge::AdaptiveRejection - Samples a log-concave density, customised by the user, over any interval
+    /// (unbounded ones included) by derivative-free adaptive rejection sampling (Gilks, 1992)
+    /// @details The envelope is made of the secants through the points where the log density is known, extended
+    /// past their ends, which lie above a concave function everywhere outside their own interval. Every value
+    /// rejected by the chords below (the squeeze) costs one call to the log density, and that point is added
+    /// to the envelope, so both close in on the density and nearly every later value is accepted at once.
+    /// @tparam LogDensity any callable returning the logarithm of a (not necessarily normalised) density at x
+    template <typename LogDensity>
+    class AdaptiveRejection {
+    public:
+        /// @brief Builds the initial envelope
+        /// @param log_density the logarithm of the density, concave over (lower, upper)
+        /// @param points at least 3 distinct points in (lower, upper) where the log density is finite. With an
+        /// unbounded lower (upper) limit the log density must increase between the two smallest (decrease between
+        /// the two largest) points, i.e. they must lie on both sides of the mode
+        /// @param lower lower limit of the support (may be -infinity)
+        /// @param upper upper limit of the support (may be +infinity)
+        /// @param max_points the envelope stops growing at this many points
+        AdaptiveRejection(LogDensity log_density, std::vector<real_t> points,
+                          real_t lower = -std::numeric_limits<real_t>::infinity(),
+                          real_t upper = std::numeric_limits<real_t>::infinity(), size_t max_points = 64)
+            : h(log_density), lower(lower), upper(upper), max_points(max_points)
+        {
+            std::sort(points.begin(), points.end());
+            points.erase(std::unique(points.begin(), points.end()), points.end());
+            if (points.size() < 3)
+                throw std::invalid_argument("At least 3 distinct starting points are needed!");
+            if (!(points.front() > lower) || !(points.back() < upper))
+                throw std::invalid_argument("The starting points must lie strictly inside (lower, upper)!");
+            for (real_t x : points) {
+                real_t y = h(x);
+                if (!std::isfinite(y))
+                    throw std::invalid_argument("The log density must be finite at the starting points!");
+                xs.push_back(x);
+                hs.push_back(y);
+            }
+            build();
+            if (std::isinf(lower) && !(slope(0) > 0))
+                throw std::invalid_argument("With an unbounded lower limit the log density must increase between the two smallest points!");
+            if (std::isinf(upper) && !(slope(xs.size() - 2) < 0))
+                throw std::invalid_argument("With an unbounded upper limit the log density must decrease between the two largest points!");
+        }
+
+        /// @brief Returns the next value of the random variable described by the density
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        template <typename Derived, typename T>
+        real_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+        {
+            DF_INSTRUMENT_SAMPLES("AdaptiveRejection", 1);
+            while (true) {
+                size_t i;
+                real_t x = from_envelope(rng.next_unit(), i);
+                real_t e = line_at(pieces[i], x), lv = std::log(rng.next_unit());
+                attempts++;
+                if (lv <= squeeze(x) - e) {
+                    accepted++;
+                    return x;
+                }
+                real_t y = h(x);
+                if (y > e + 1e-9 * (1 + std::fabs(e)))
+                    throw std::invalid_argument("The density is not log-concave!");
+                if (xs.size() < max_points && std::isfinite(y))
+                    insert(x, y);
+                if (lv <= y - e) {
+                    accepted++;
+                    return x;
+                }
+                DF_INSTRUMENT_REJECT("AdaptiveRejection");
+            }
+        }
+
+        /// @brief Fills the buffer with values of the random variable described by the density
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @param out Pointer to the first element of the buffer
+        /// @param n Number of values to be written
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, real_t* out, size_t n)
+        {
+            DF_INSTRUMENT_SAMPLES("AdaptiveRejection", n);
+            for (size_t i = 0; i < n; i++)
+                out[i] = next(rng);
+        }
+#if defined(DF_SPAN)
+        /// @brief Fills the span with values of the random variable described by the density
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<real_t> out)
+        {
+            sample(rng, out.data(), out.size());
+        }
+#endif
+
+        /// @brief Number of points the envelope is built on
+        size_t size() const { return xs.size(); }
+
+        /// @brief Fraction of the attempts so far that were accepted
+        real_t acceptance() const { return attempts ? real_t(accepted) / attempts : 1; }
+
+        /// @brief Fraction of the envelope's mass below the squeeze, an estimate of the acceptance rate to come
+        /// without any call to the log density
+        real_t efficiency() const
+        {
+            real_t inner = 0;
+            for (size_t i = 0; i + 1 < xs.size(); i++)
+                inner += mass(Piece{xs[i], xs[i + 1], xs[i], hs[i] - top, slope(i)});
+            return inner / total;
+        }
+
+    private:
+        // A piece of the envelope: the line y(x) = y0 + s (x - x0) over [a, b], shifted down by top
+        struct Piece { real_t a, b, x0, y0, s; };
+
+        LogDensity h;
+        real_t lower, upper;
+        size_t max_points;
+        // Points of the envelope, sorted, and the log density there
+        std::vector<real_t> xs, hs;
+        // Pieces of the envelope, the running sums of their masses, the total and the largest log value
+        std::vector<Piece> pieces;
+        std::vector<real_t> sums;
+        real_t total = 0, top = 0;
+        size_t attempts = 0, accepted = 0;
+
+        // Slope of the secant through points i and i + 1
+        real_t slope(size_t i) const { return (hs[i + 1] - hs[i]) / (xs[i + 1] - xs[i]); }
+
+        static real_t line_at(const Piece& p, real_t x) { return p.y0 + p.s * (x - p.x0); }
+
+        // Integral of exp(y(x)) over the piece
+        static real_t mass(const Piece& p)
+        {
+            if (std::isinf(p.a))
+                return std::exp(line_at(p, p.b)) / p.s;
+            if (std::isinf(p.b))
+                return -std::exp(line_at(p, p.a)) / p.s;
+            real_t w = p.b - p.a, t = p.s * w;
+            if (std::fabs(t) < 1e-10)
+                return std::exp(line_at(p, p.a)) * w * (1 + t / 2);
+            return std::exp(line_at(p, p.a)) * std::expm1(t) / p.s;
+        }
+
+        // The chord below the log density, or -infinity outside the points
+        real_t squeeze(real_t x) const
+        {
+            if (x < xs.front() || x > xs.back())
+                return -std::numeric_limits<real_t>::infinity();
+            size_t i = std::upper_bound(xs.begin(), xs.end(), x) - xs.begin();
+            i = std::min(std::max(i, size_t(1)), xs.size() - 1) - 1;
+            return hs[i] + slope(i) * (x - xs[i]);
+        }
+
+        // Adds the line through points j and j + 1 over [a, b] (nothing if it is empty)
+        void add(real_t a, real_t b, size_t j)
+        {
+            if (b > a)
+                pieces.push_back(Piece{a, b, xs[j], hs[j], slope(j)});
+        }
+
+        void build()
+        {
+            const size_t k = xs.size();
+            pieces.clear();
+            // Left tail, then each interval, then the right tail
+            add(lower, xs[0], 0);
+            add(xs[0], xs[1], 1);
+            for (size_t i = 1; i + 2 < k; i++) {
+                // min of the secants from the left (i - 1, i) and from the right (i + 1, i + 2); the first is the
+                // lower one at xs[i] and the second at xs[i + 1], so they cross once in between
+                real_t sa = slope(i - 1), sb = slope(i + 1);
+                real_t z = xs[i];
+                if (sa != sb)
+                    z = std::min(xs[i + 1], std::max(xs[i], ((hs[i + 1] - sb * xs[i + 1]) - (hs[i] - sa * xs[i])) / (sa - sb)));
+                add(xs[i], z, i - 1);
+                add(z, xs[i + 1], i + 1);
+            }
+            add(xs[k - 2], xs[k - 1], k - 3);
+            add(xs[k - 1], upper, k - 2);
+
+            // Shift by the largest value of the envelope, which is at an end of some piece
+            top = -std::numeric_limits<real_t>::infinity();
+            for (const Piece& p : pieces) {
+                if (!std::isinf(p.a)) top = std::max(top, line_at(p, p.a));
+                if (!std::isinf(p.b)) top = std::max(top, line_at(p, p.b));
+            }
+            sums.resize(pieces.size());
+            total = 0;
+            for (size_t i = 0; i < pieces.size(); i++) {
+                pieces[i].y0 -= top;
+                total += mass(pieces[i]);
+                sums[i] = total;
+            }
+            for (Piece& p : pieces)
+                p.y0 += top;
+        }
+
+        void insert(real_t x, real_t y)
+        {
+            size_t i = std::upper_bound(xs.begin(), xs.end(), x) - xs.begin();
+            if ((i > 0 && xs[i - 1] == x) || (i < xs.size() && xs[i] == x))
+                return;
+            xs.insert(xs.begin() + i, x);
+            hs.insert(hs.begin() + i, y);
+            build();
+        }
+
+        // Draws from the envelope by inversion, and tells which piece the value came from
+        real_t from_envelope(real_t u, size_t& i) const
+        {
+            real_t m = u * total;
+            i = std::min(size_t(std::upper_bound(sums.begin(), sums.end(), m) - sums.begin()), pieces.size() - 1);
+            const Piece& p = pieces[i];
+            // Fraction of the piece's own mass to the left of the value
+            real_t prev = (i == 0) ? 0 : sums[i - 1];
+            real_t f = std::min(real_t(1), std::max(real_t(0), (m - prev) / (sums[i] - prev)));
+            if (std::isinf(p.a))
+                return p.b + std::log(f) / p.s;
+            if (std::isinf(p.b))
+                return p.a + std::log1p(-f) / p.s;
+            real_t w = p.b - p.a, t = p.s * w;
+            if (std::fabs(t) < 1e-10)
+                return p.a + f * w;
+            return std::min(p.b, p.a + std::log1p(f * std::expm1(t)) / p.s);
+        }
+    };
+}
+
+#endif
@@ -1,64 +1,145 @@
 #include "Custom.h"
-#include "basicfxn.h"
+#include "quadrature.h"
 #include <functional>
+#include <algorithm>
+#include <cmath>
 
 namespace DiceForge {
 
-    CustomDistribution::CustomDistribution(real_t lower, real_t upper, PDF_Function pdf, int n) 
-        : lower_limit(lower), upper_limit(upper), pdf_function(pdf)
+    void CustomDistribution::build(std::vector<real_t>& f, bool smooth)
     {
-        // Simpson's rule for CDF calculation
-        real_t h = (upper - lower) / real_t(n); // Step size, subject to change 
-        real_t sum = 0.0;
-        real_t x2 = 0.0;
-        real_t cdf = 0;
-
-        for (real_t x = lower_limit; x < upper_limit; x += h) {
-            x2=x+h; 
-            sum = simpson(pdf_function, x, x2);
-            cdf+=sum ;
-            cdf_values.push_back(std::make_pair(x, cdf));
+        const int n = int(f.size() / 2);
+        const real_t h = (upper_limit - lower_limit) / real_t(n); // Step size between knots
+
+        // Simpson's rule for CDF calculation, segment by segment over the shared grid
+        std::vector<real_t> grid(n + 1), F(n + 1);
+        grid[0] = lower_limit;
+        F[0] = 0;
+        for (int i = 1; i <= n; i++) {
+            grid[i] = (i == n) ? upper_limit : lower_limit + i * h;
+            F[i] = F[i - 1] + h * (f[2 * i - 2] + 4 * f[2 * i - 1] + f[2 * i]) / 6;
         }
 
-        sum = 0.0;
-        for (real_t x = lower_limit; x < upper_limit; x += h) {
-            sum += h * x * pdf_function(x);
+        // Normalise, so that every r in [0, 1) falls in some segment
+        real_t total = F[n];
+        if (!(total > 0))
+            throw std::invalid_argument("The pdf must have a positive integral over the range!");
+        for (int i = 1; i <= n; i++)
+            F[i] /= total;
+        for (real_t& v : f)
+            v /= total;
+
+        // Expectation and variance of the pdf itself by adaptive Gauss-Kronrod integration, normalised by its
+        // integral, as the grid values only give them to the accuracy of Simpson's rule
+        const PDF_Function& p = pdf_function;
+        real_t mass = integrate_adaptive<real_t>(p, lower_limit, upper_limit).value;
+        if (!(mass > 0))
+            mass = total;
+        m_expectation = integrate_adaptive<real_t>([&](real_t x) { return x * p(x); }, lower_limit, upper_limit).value / mass;
+        const real_t mean = m_expectation;
+        m_variance = integrate_adaptive<real_t>([&](real_t x) { return (x - mean) * (x - mean) * p(x); },
+                                                lower_limit, upper_limit).value / mass;
+
+        // Slopes of the inverse cdf, dx/dcdf = 1/pdf, limited as in Fritsch-Carlson so that every segment stays
+        // monotone; segments where the pdf vanishes at an end are interpolated linearly
+        std::vector<real_t> left(n), right(n);
+        for (int i = 0; i < n; i++) {
+            real_t d = F[i + 1] - F[i];
+            real_t secant = (d > 0) ? (grid[i + 1] - grid[i]) / d : 0;
+            left[i] = right[i] = secant;
+            real_t f_prev = f[2 * i], f_next = f[2 * i + 2];
+            if (smooth && d > 0 && f_prev > 0 && f_next > 0) {
+                real_t a = 1 / (f_prev * secant), b = 1 / (f_next * secant);
+                real_t tau = (a * a + b * b > 9) ? 3 / std::sqrt(a * a + b * b) : 1;
+                left[i] = tau * a * secant;
+                right[i] = tau * b * secant;
+            }
         }
-        m_expectation = (sum/n);
 
-        sum = 0.0;        
-        for (real_t x = lower_limit; x < upper_limit; x += h) {
-            real_t diff = x - m_expectation;
-            sum += h * diff * diff * pdf_function(x); // Integrate (x - mean)^2 * f(x)
+        // g[j] = the last segment starting at or below j / n
+        std::vector<uint64_t> g(n);
+        size_t k = 0;
+        for (size_t j = 0; j < g.size(); j++) {
+            while (k + 1 < size_t(n) && F[k + 1] <= real_t(j) / g.size())
+                k++;
+            g[j] = k;
         }
-        m_variance = (sum/n);
+
+        density = detail::TableArray<real_t>(std::move(f));
+        knots = detail::TableArray<real_t>(std::move(grid));
+        knot_cdf = detail::TableArray<real_t>(std::move(F));
+        slope_left = detail::TableArray<real_t>(std::move(left));
+        slope_right = detail::TableArray<real_t>(std::move(right));
+        guide = detail::TableArray<uint64_t>(std::move(g));
+    }
+
+    CustomDistribution::CustomDistribution(const std::string& path, PDF_Function pdf) : pdf_function(pdf)
+    {
+        // Array 0 holds the limits and the moments, the others the tables in the order of save_table
+        auto file = std::make_shared<const TableFile>(path);
+        file->expect("CustomDistribution");
+        std::pair<const real_t*, size_t> parameters = file->array<real_t>(0);
+        if (file->arrays() != 7 || parameters.second != 4)
+            throw std::invalid_argument("The table file does not fit a CustomDistribution");
+        lower_limit = parameters.first[0];
+        upper_limit = parameters.first[1];
+        m_expectation = parameters.first[2];
+        m_variance = parameters.first[3];
+        density = detail::TableArray<real_t>(file, 1);
+        knots = detail::TableArray<real_t>(file, 2);
+        knot_cdf = detail::TableArray<real_t>(file, 3);
+        slope_left = detail::TableArray<real_t>(file, 4);
+        slope_right = detail::TableArray<real_t>(file, 5);
+        guide = detail::TableArray<uint64_t>(file, 6);
+        const size_t n = guide.size();
+        if (!(upper_limit > lower_limit) || n < 1 || density.size() != 2 * n + 1 || knots.size() != n + 1
+            || knot_cdf.size() != n + 1 || slope_left.size() != n || slope_right.size() != n)
+            throw std::invalid_argument("The table file does not fit a CustomDistribution");
+        // invert indexes the tables with the guide, which must hold segments at or below those of j / n
+        for (size_t j = 0; j < n; j++)
+            if (!(guide[j] < n) || !(knot_cdf[size_t(guide[j])] <= real_t(j) / n))
+                throw std::invalid_argument("The guide table of the file is damaged");
+    }
+
+    void CustomDistribution::save_table(const std::string& path) const
+    {
+        const real_t parameters[4] = {lower_limit, upper_limit, m_expectation, m_variance};
+        detail::TableWriter writer("CustomDistribution");
+        writer.add(parameters, 4);
+        writer.add(density.data(), density.size());
+        writer.add(knots.data(), knots.size());
+        writer.add(knot_cdf.data(), knot_cdf.size());
+        writer.add(slope_left.data(), slope_left.size());
+        writer.add(slope_right.data(), slope_right.size());
+        writer.add(guide.data(), guide.size());
+        writer.write(path);
+    }
+
+    real_t CustomDistribution::invert(real_t u) const
+    {
+        // The guide table gives a segment at or below the one holding u, which is at most a few steps away
+        size_t i = size_t(guide[std::min(size_t(u * guide.size()), guide.size() - 1)]);
+        while (i + 1 < guide.size() && knot_cdf[i + 1] <= u)
+            i++;
+        real_t d = knot_cdf[i + 1] - knot_cdf[i];
+        if (!(d > 0))
+            return knots[i];
+
+        // Cubic Hermite interpolation (linear when the slopes equal the secant)
+        real_t t = (u - knot_cdf[i]) / d, t2 = t * t, t3 = t2 * t;
+        return (2 * t3 - 3 * t2 + 1) * knots[i] + (-2 * t3 + 3 * t2) * knots[i + 1]
+               + d * ((t3 - 2 * t2 + t) * slope_left[i] + (t3 - t2) * slope_right[i]);
     }
 
     real_t CustomDistribution::next(real_t r)
     {
-        // Find the two CDF values between which the random number lies
-        real_t prev_cdf = 0.0, next_cdf = 0.0;
-        for (const auto& pair : cdf_values) {
-            if (pair.second > r) {
-                next_cdf = pair.second;
-                break;
-            }
-            prev_cdf = pair.second;
-        }
-    
-        // Linear interpolation to find the corresponding input value
-        real_t prev_input = 0.0, next_input = 0.0;
-        for (const auto& pair : cdf_values) {
-            if (pair.second == prev_cdf)
-                prev_input = pair.first;
-            else if (pair.second == next_cdf) {
-                next_input = pair.first;
-                break;
-            }
-        }
+        return invert(r);
+    }
 
-        // Interpolate
-        return prev_input + ((r - prev_cdf) / (next_cdf - prev_cdf)) * (next_input - prev_input);
+    void CustomDistribution::transform(real_t* r, size_t n) const
+    {
+        for (size_t i = 0; i < n; i++)
+            r[i] = invert(r[i]);
     }
         
     real_t CustomDistribution::expectation() const 
@@ -86,15 +167,31 @@ namespace DiceForge {
         if (x>upper_limit || x<lower_limit)
             throw std::invalid_argument("Enter a value within the domain of this pdf!");
 
-        return (pdf_function(x));
+        if (pdf_function)
+            return pdf_function(x);
+
+        // The quadratic through the three pdf values of the segment holding x
+        const size_t n = guide.size();
+        const real_t h = (upper_limit - lower_limit) / real_t(n);
+        size_t i = std::min(size_t((x - lower_limit) / h), n - 1);
+        real_t s = (x - knots[i]) / h;
+        real_t f0 = density[2 * i], fm = density[2 * i + 1], f1 = density[2 * i + 2];
+        return f0 + s * ((-3 * f0 + 4 * fm - f1) + s * (2 * f0 - 4 * fm + 2 * f1));
     }
 
     real_t CustomDistribution::cdf(real_t x) const 
     {   
         if (x>upper_limit || x<lower_limit)
             throw std::invalid_argument("Enter a value within the domain of this pdf!");
-            
-        return (simpson(pdf_function,lower_limit, x, 1000));    // number of iterations in Simpson is subject to change
+
+        // Segment holding x, and the integral of the quadratic through its three pdf values up to x
+        const size_t n = guide.size();
+        const real_t h = (upper_limit - lower_limit) / real_t(n);
+        size_t i = std::min(size_t((x - lower_limit) / h), n - 1);
+        real_t s = (x - knots[i]) / h;
+        real_t f0 = density[2 * i], fm = density[2 * i + 1], f1 = density[2 * i + 2];
+        real_t area = h * s * (f0 + s * ((-3 * f0 + 4 * fm - f1) / 2 + s * (2 * f0 - 4 * fm + 2 * f1) / 3));
+        return std::min(real_t(1), knot_cdf[i] + area);
     }
 
 } // namespace DiceForge
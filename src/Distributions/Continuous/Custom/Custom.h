@@ -2,9 +2,14 @@
 #define DF_CUSTOM_DISTRIBUTION_H
 
 #include "distribution.h"
+#include "generator.h"
 #include "types.h"
+#include "table.h"
 #include <vector>
+#include <string>
 #include <functional>
+#include <stdexcept>
+#include <algorithm>
 
 namespace DiceForge {
     using PDF_Function = std::function<real_t(real_t)>;
@@ -17,25 +22,124 @@ namespace DiceForge {
         real_t lower_limit;
         real_t upper_limit;
         real_t m_expectation, m_variance;
-        std::vector<std::pair<real_t, real_t> > cdf_values; // (input, cdf)
+        // The tables, held in memory or read in place from a table file (see save_table), and shared by copies
+        // The pdf (normalised) at the knots and the midpoints between them, 2 n + 1 values
+        detail::TableArray<real_t> density;
+        // Inverse cdf table: the grid knots, the cdf at each of them (normalised to end at 1), and for each
+        // segment the slopes dx/dcdf at its two ends (Hermite interpolation, equal to the secant when linear)
+        detail::TableArray<real_t> knots;
+        detail::TableArray<real_t> knot_cdf;
+        detail::TableArray<real_t> slope_left;
+        detail::TableArray<real_t> slope_right;
+        // guide[j] = the segment holding the cdf value j / guide.size()
+        detail::TableArray<uint64_t> guide;
         PDF_Function pdf_function; // Declare pdf_function as a member variable
 
+        // Value of the inverse cdf at u
+        real_t invert(real_t u) const;
+        // Builds the tables from the pdf at the 2 n + 1 points of the half-step grid
+        void build(std::vector<real_t>& f, bool smooth);
+
     public:
         /// @brief Constructor for Custom Distribution
         /// @param lower lower bound for the random variable (finite)
         /// @param upper upper bound for the random variable (finite)
         /// @param pdf probability density function describing the distribution
         /// @param n number of points where the pdf should be sampled for expectation, variance and cdf calculations (higher n provides better accuracy) 
-        CustomDistribution(real_t lower, real_t upper, PDF_Function pdf, int n = 1000);
+        /// @param smooth inverts the cdf by monotone cubic Hermite interpolation, using the pdf at the knots, instead of linearly
+        /// @note The pdf is evaluated once at each of the 2 n + 1 points of a half-step grid, and the cdf (by Simpson's
+        /// rule) and the sampling tables are computed from those values. The expectation and variance are
+        /// integrated from the pdf by adaptive Gauss-Kronrod quadrature (see integrate_adaptive).
+        template <typename Function>
+        CustomDistribution(real_t lower, real_t upper, Function pdf, int n = 1000, bool smooth = false)
+            : lower_limit(lower), upper_limit(upper), pdf_function(pdf)
+        {
+            if (!(upper > lower) || n < 1)
+                throw std::invalid_argument("Expected lower < upper and n >= 1!");
+
+            std::vector<real_t> f(2 * size_t(n) + 1);
+            const real_t h = (upper - lower) / (2 * real_t(n));
+            for (size_t i = 0; i < f.size(); i++)
+                f[i] = pdf((i + 1 == f.size()) ? upper : lower + i * h);
+            build(f, smooth);
+        }
+
+        /// @brief Constructor from the tables saved by save_table, sampling straight from the mapped file
+        /// @param path table file written by save_table
+        /// @param pdf the pdf the tables were built from, for pdf(x); when not given, pdf(x) interpolates the
+        /// normalised pdf from the table instead
+        /// @note Costs the mapping of the file and a check of its header, with neither a pdf evaluation nor an
+        /// integration. The values drawn are those of the distribution that saved the tables. Every process
+        /// mapping the file shares one copy of it in the page cache. std::invalid_argument if the file does not
+        /// hold the tables of a CustomDistribution.
+        explicit CustomDistribution(const std::string& path, PDF_Function pdf = PDF_Function());
 
+        /// @brief Writes the tables to a file, for the constructor from a path
+        /// @note The file is written under a temporary name and then renamed, so processes starting meanwhile
+        /// map either the whole old file or the whole new one. It holds doubles in the representation of this
+        /// machine, for machines of the same kind.
+        void save_table(const std::string& path) const;
+
+        /// @brief Returns the next value of the random variable described by the distribution
+        /// @param r A random real number uniformly distributed between 0 and 1
+        /// @note O(1): a guide table picks the segment of the inverse cdf table, which is then interpolated
         real_t next(real_t r);
+
+        /// @brief Replaces n uniformly distributed unit random variables in place with values of the random variable
+        /// @param r Pointer to the first of the random variables, each as would be passed to next(r)
+        /// @param n Number of random variables
+        void transform(real_t* r, size_t n) const;
+
+        /// @brief Fills the buffer with values of the random variable described by the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @param out Pointer to the first element of the buffer
+        /// @param n Number of values to be written
+        /// @note The uniforms are drawn in bulk and transformed in one pass (see transform)
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, real_t* out, size_t n)
+        {
+            DF_INSTRUMENT_SAMPLES("Custom", n);
+            rng.fill_unit(out, n);
+            transform(out, n);
+        }
+        /// @brief Fills the buffer with single precision values of the random variable
+        /// @note The table is inverted in double precision, a block at a time
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, float* out, size_t n)
+        {
+            DF_INSTRUMENT_SAMPLES("Custom", n);
+            real_t u[256];
+            while (n > 0) {
+                size_t m = std::min(n, size_t(256));
+                rng.fill_unit(u, m);
+                transform(u, m);
+                for (size_t j = 0; j < m; j++)
+                    out[j] = float(u[j]);
+                out += m;
+                n -= m;
+            }
+        }
+#if defined(DF_SPAN)
+        /// @brief Fills the span with values of the random variable described by the distribution
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<real_t> out)
+        {
+            sample(rng, out.data(), out.size());
+        }
+        /// @brief Fills the span with single precision values of the random variable
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<float> out)
+        {
+            sample(rng, out.data(), out.size());
+        }
+#endif
         
         /// @brief Returns the expected value of the distribution
-        /// @note The expectation value is approximate
+        /// @note The expectation value is integrated numerically, to a relative error of about 1e-10
         real_t expectation() const override final;
         
         /// @brief Returns the variance of the distribution
-        /// @note The variance is an approximatation 
+        /// @note The variance is integrated numerically, to a relative error of about 1e-10
         real_t variance() const override final;
 
         /// @brief Returns the minimum possible value of the random variable described by the distribution
@@ -46,12 +150,17 @@ namespace DiceForge {
 
         /// @brief Probabiliity density function (pdf) of the distribution
         /// @param x location where the pdf is to be evaluated
+        /// @note The pdf as given, or for a distribution read from a table file without one, the quadratic through
+        /// the normalised values of the table (the same interpolant as the cdf)
         real_t pdf(real_t x) const override final;
 
         /// @brief Cummalative density function (cdf) of the distribution
         /// @param x location where the pdf is to be evaluated
-        /// @note Numerical methods of inegration are emplyed to find the cdf value. This does not ensure that the function itself is integrable over the given range.
+        /// @note Integrates the quadratic through the pdf values of the segment holding x (the same interpolant as
+        /// Simpson's rule), so it costs O(1) and agrees with the table used for sampling
         real_t cdf(real_t x) const override final;
+        using Continuous::pdf;
+        using Continuous::cdf;
     };
 } // namespace DiceForge
 
@@ -1,4 +1,6 @@
 #include "Exponential.h"
+#include "fitting.h"
+#include "simd.h"
 
 namespace DiceForge {
 
@@ -10,8 +12,19 @@ namespace DiceForge {
     }
 
     real_t Exponential::next(real_t r) {
-        // Inverse transform sampling for exponential distribution
-        return -(log(1 - r) / k);
+        // Inverse transform sampling for exponential distribution, the quantile at r
+        return x0 - log1p(-r) / k;
+    }
+
+    void Exponential::scale_each(const real_t* k, real_t* e, size_t n) {
+        size_t j = 0;
+#if defined(DF_SIMD_REAL)
+        typedef simd::vreal V;
+        for (; j + V::width <= n; j += V::width)
+            (V::load(e + j) / V::load(k + j)).store(e + j);
+#endif
+        for (; j < n; j++)
+            e[j] /= k[j];
     }
 
     real_t Exponential::variance() const {
@@ -26,7 +39,7 @@ namespace DiceForge {
 
     real_t Exponential::minValue() const {
         // Minimum value for exponential distribution
-        return std::numeric_limits<real_t>().min();
+        return x0;
     }
 
     real_t Exponential::maxValue() const {
@@ -40,13 +53,51 @@ namespace DiceForge {
         } else {
             // PDF formula for exponential distribution
             // Normalized
-            return (exp(-k * (x - x0)));
+            return k * exp(-k * (x - x0));
         }
     }
 
     real_t Exponential::cdf(real_t x) const {
-        // CDF formula for exponential distribution
-        return (1 - exp(-k * (x - x0)));
+        // CDF formula for exponential distribution, 0 below the origin
+        return (x < x0) ? 0 : -expm1(-k * (x - x0));
+    }
+
+    real_t Exponential::logpdf(real_t x) const {
+        return (x < x0) ? -INFINITY : log(k) - k * (x - x0);
+    }
+
+    void Exponential::pdf(const real_t* x, real_t* out, size_t n) const {
+        const real_t rate = k, origin = x0;
+        for (size_t i = 0; i < n; i++) {
+            out[i] = (x[i] < origin) ? 0 : rate * exp(-rate * (x[i] - origin));
+        }
+    }
+
+    void Exponential::logpdf(const real_t* x, real_t* out, size_t n) const {
+        const real_t rate = k, origin = x0, log_rate = log(k);
+        for (size_t i = 0; i < n; i++) {
+            out[i] = (x[i] < origin) ? -INFINITY : log_rate - rate * (x[i] - origin);
+        }
+    }
+
+    void Exponential::cdf(const real_t* x, real_t* out, size_t n) const {
+        const real_t rate = k, origin = x0;
+        for (size_t i = 0; i < n; i++) {
+            out[i] = (x[i] < origin) ? 0 : -expm1(-rate * (x[i] - origin));
+        }
+    }
+
+    real_t Exponential::quantile(real_t p) const {
+        detail::check_probability(p);
+        return x0 - log1p(-p) / k;
+    }
+
+    void Exponential::quantile(const real_t* p, real_t* out, size_t n) const {
+        const real_t rate = k, origin = x0;
+        for (size_t i = 0; i < n; i++) {
+            detail::check_probability(p[i]);
+            out[i] = origin - log1p(-p[i]) / rate;
+        }
     }
 
     real_t Exponential::get_k() const {
@@ -57,7 +108,7 @@ namespace DiceForge {
     }
 
     // fit to exponential distribution using linear regression after taking log
-    Exponential fitToExponential(const std::vector<real_t>& x, const std::vector<real_t>& y, int max_iter = 10000, real_t epsilon = 1e-6) {
+    Exponential fitToExponential(const std::vector<real_t>& x, const std::vector<real_t>& y, int max_iter, real_t epsilon) {
         if (x.size() != y.size()) {
             throw "Number of x-coordinates and y-coordinates provided in the data do not match!";
         }
@@ -92,9 +143,9 @@ namespace DiceForge {
         zmean /= valid_N;
         xrmean /= valid_N;
 
-        // y = e^(-k*(x-x0))
-        // ln(y) = -k*(x-x0)
-        // ln(y) = -k*x + k*x0
+        // y = k*e^(-k*(x-x0))
+        // ln(y) = ln(k) - k*(x-x0)
+        // ln(y) = -k*x + ln(k) + k*x0
         // ln(y) = -k*x + c
         // z = -k*x + c
         // Perform linear regression to find initial guess
@@ -114,42 +165,27 @@ namespace DiceForge {
         // Initial guess for c
         real_t c = intercept;
         
-        // Gradient Descent for Noisy Data
-        for (int i = 0; i < max_iter; i++) {
-            real_t k_grad = 0;
-            real_t c_grad = 0;
-
-            real_t alpha = 1 / sqrt(i + 1);
-
-            // Calculate the total gradient with respect to k and c
-            for (int j = 0; j < valid_N; j++) {
-                real_t z_est = -k * xr[j] + c;
-                k_grad += (z_est - z[j]) * z_est / k;
-                c_grad += (z_est - z[j]);
-            }
-
-            k_grad /= valid_N;
-            c_grad /= valid_N;
+        // Refine on the pdf itself, y = e^(-k*x + c), over the same non-zero points
+        std::vector<real_t> yr;
+        yr.reserve(valid_N);
+        for (size_t i = 0; i < valid_N; i++)
+            yr.push_back(exp(z[i]));
 
-            if (std::abs(alpha * k_grad) < epsilon && abs(alpha * c_grad) < epsilon) {
-                // std::cout << alpha * k_grad << " " << alpha * c_grad << std::endl;
-                // std::cout << "Converged in " << i << " iterations" << std::endl;
-                break;
-            }
-          
-            real_t pred_k = k - alpha * k_grad;
-            real_t pred_c = c - alpha * c_grad;
+        auto model = [](auto x, const real_t* theta, auto* grad)
+        {
+            typedef decltype(x) V;
+            V f = simd::exp(x * -theta[0] + theta[1]);
+            grad[0] = -x * f;
+            grad[1] = f;
+            return f;
+        };
 
-            // prevent possible incorrect jumping
-            if ((pred_c / pred_c > 10 || pred_k / k > 10 || pred_c / c < 0.1 || pred_k / k < 0.1)) {
-                alpha = alpha * 0.01;
-            }
-            
-            k -= alpha * k_grad;
-            c -= alpha * c_grad;
-        }
+        real_t theta[2] = {k, c};
+        levenberg_marquardt<2>(model, xr.data(), yr.data(), valid_N, theta, max_iter, epsilon);
+        k = theta[0];
+        c = theta[1];
 
-        real_t x0 = fmin(c / k, x0_est);
+        real_t x0 = fmin((c - log(k)) / k, x0_est);
 
         if (k < 0 || std::isnan(k) || std::isnan(x0))
         {
@@ -158,4 +194,65 @@ namespace DiceForge {
 
         return Exponential(k, x0);
     }
-}
\ No newline at end of file
+
+    void ExponentialAccumulator::add(real_t x)
+    {
+        n++;
+        sum += x;
+        min = fmin(min, x);
+    }
+
+    void ExponentialAccumulator::add(const real_t* x, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+            add(x[i]);
+    }
+
+    void ExponentialAccumulator::merge(const ExponentialAccumulator& other)
+    {
+        n += other.n;
+        sum += other.sum;
+        min = fmin(min, other.min);
+    }
+
+    size_t ExponentialAccumulator::count() const
+    {
+        return n;
+    }
+
+    void ExponentialAccumulator::write_state(detail::StateWriter& out) const
+    {
+        out.tag("ExponentialAccumulator");
+        out.put(uint64_t(n));
+        out.put(sum);
+        out.put(min);
+    }
+
+    void ExponentialAccumulator::read_state(detail::StateReader& in)
+    {
+        in.tag("ExponentialAccumulator");
+        ExponentialAccumulator loaded;
+        loaded.n = size_t(in.get<uint64_t>());
+        loaded.sum = in.get<real_t>();
+        loaded.min = in.get<real_t>();
+        in.end();
+        *this = loaded;
+    }
+
+    Exponential ExponentialAccumulator::fit() const
+    {
+        real_t excess = n > 0 ? sum / n - min : 0;
+        if (n < 2 || !(excess > 0))
+        {
+            throw std::runtime_error("Could not fit samples to Exponential! At least two distinct samples are needed!");
+        }
+        return Exponential(1 / excess, min);
+    }
+
+    Exponential fitExponentialFromSamples(const std::vector<real_t>& samples)
+    {
+        ExponentialAccumulator acc;
+        acc.add(samples.data(), samples.size());
+        return acc.fit();
+    }
+}
@@ -2,6 +2,7 @@
 #define DF_EXPONENTIAL_H
 
 #include "distribution.h"
+#include "ziggurat.h"
 
 namespace DiceForge {
     /// @brief DiceForge::Exponential - A continuous exponential probability distribution
@@ -9,6 +10,8 @@ namespace DiceForge {
     private:
         real_t k;  // Rate parameter
         real_t x0; // Origin of the distribution
+        // e[j] / k[j] for the standard variates e of sample_each, on lanes of simd::vreal
+        static void scale_each(const real_t* k, real_t* e, size_t n);
     public:
         /**
          * @brief Constructor for Exponential distribution.
@@ -22,6 +25,72 @@ namespace DiceForge {
          * @returns Random number from the exponential distribution.
          */
         real_t next(real_t r);
+        /// @brief Returns the next value of the random variable described by the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @note Uses the Ziggurat method, mostly one random integer, a table lookup and a multiply per value
+        template <typename Derived, typename T>
+        real_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+        {
+            DF_INSTRUMENT_SAMPLES("Exponential", 1);
+            return x0 + ziggurat::next_exponential(rng) / k;
+        }
+        /// @brief Fills the buffer with values of the random variable described by the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @param out Pointer to the first element of the buffer
+        /// @param n Number of values to be written
+        /// @note Ziggurat method, as in next(rng)
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, real_t* out, size_t n)
+        {
+            DF_INSTRUMENT_SAMPLES("Exponential", n);
+            for (size_t j = 0; j < n; j++)
+                out[j] = next(rng);
+        }
+        /// @brief Fills the buffer with single precision values of the random variable
+        /// @note ziggurat::fill_exponential, 32 random bits per value in the common case
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, float* out, size_t n)
+        {
+            DF_INSTRUMENT_SAMPLES("Exponential", n);
+            ziggurat::fill_exponential(rng, out, n);
+            const float origin = float(x0), scale = float(1 / k);
+            for (size_t j = 0; j < n; j++)
+                out[j] = origin + out[j] * scale;
+        }
+        /// @brief Fills the buffer with one value of each of n Exponential distributions (of origin 0), without
+        /// constructing them
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @param k Pointer to the n rate parameters (> 0)
+        /// @param out Pointer to the first element of the buffer
+        /// @param n Number of values to be written
+        /// @note Standard variates by the Ziggurat method, then divided by the rates lanes at a time
+        template <typename Derived, typename T>
+        static void sample_each(DiceForge::StaticGenerator<Derived, T>& rng, const real_t* k, real_t* out, size_t n)
+        {
+            DF_INSTRUMENT_SAMPLES("Exponential", n);
+            bool valid = true;
+            for (size_t j = 0; j < n; j++)
+                valid &= (k[j] > 0);
+            if (!valid)
+                throw std::invalid_argument("Rate parameter (k) must be positive");
+            for (size_t j = 0; j < n; j++)
+                out[j] = ziggurat::next_exponential(rng);
+            scale_each(k, out, n);
+        }
+#if defined(DF_SPAN)
+        /// @brief Fills the span with values of the random variable described by the distribution
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<real_t> out)
+        {
+            sample(rng, out.data(), out.size());
+        }
+        /// @brief Fills the span with single precision values of the random variable
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<float> out)
+        {
+            sample(rng, out.data(), out.size());
+        }
+#endif
         /**
          * @brief Calculate the variance of the distribution.
          * @returns Variance of the exponential distribution.
@@ -54,6 +123,37 @@ namespace DiceForge {
          * @returns CDF value at point x.
          */
         real_t cdf(real_t x) const override final;
+        /**
+         * @brief Calculate the natural logarithm of the PDF of the distribution at a given point x.
+         * @param x Point at which to calculate the log-PDF.
+         * @returns log-PDF value at point x.
+         */
+        real_t logpdf(real_t x) const override final;
+        /**
+         * @brief Calculate the PDF at n points at once.
+         * @param x Points at which to calculate the PDF.
+         * @param out Buffer receiving the n PDF values.
+         * @param n Number of points.
+         */
+        void pdf(const real_t* x, real_t* out, size_t n) const override final;
+        /**
+         * @brief Calculate the log-PDF at n points at once (see pdf).
+         */
+        void logpdf(const real_t* x, real_t* out, size_t n) const override final;
+        /**
+         * @brief Calculate the CDF at n points at once (see pdf).
+         */
+        void cdf(const real_t* x, real_t* out, size_t n) const override final;
+        /**
+         * @brief Calculate the quantile function (inverse CDF) of the distribution, x0 - log(1 - p) / k.
+         * @param p Probability, in [0, 1].
+         * @returns The x with CDF(x) = p.
+         */
+        real_t quantile(real_t p) const override final;
+        /**
+         * @brief Calculate the quantile function at n probabilities at once (out may be p).
+         */
+        void quantile(const real_t* p, real_t* out, size_t n) const override final;
 
         /// @brief Returns the rate parameter of the distribution
         real_t get_k() const;
@@ -69,7 +169,36 @@ namespace DiceForge {
     /// @param max_iter maximum iterations to attempt to fit the data (higher to try for better fits)
     /// @param epsilon minimum acceptable error tolerance while attempting to fit the data (smaller to try for better fits)
     /// @returns An Exponential distribution fit to the given sample points
-    Exponential fitToExponential(const std::vector<real_t>& x, const std::vector<real_t>& y, int max_iter, real_t epsilon);
+    Exponential fitToExponential(const std::vector<real_t>& x, const std::vector<real_t>& y, int max_iter = 10000, real_t epsilon = 1e-6);
+
+    /// @brief Streaming sufficient statistics of a sample (count, sum and minimum), from which the maximum likelihood
+    /// Exponential follows in closed form. Accumulators over parts of a sample can be merged.
+    /// @note The statistics can be saved with save_state, to carry on with a sample from a checkpoint
+    class ExponentialAccumulator : public Serializable<ExponentialAccumulator> {
+        friend class Serializable<ExponentialAccumulator>;
+        private:
+            size_t n = 0;
+            real_t sum = 0, min = INFINITY;
+            // The statistics, for save_state and load_state (see DiceForge::Serializable)
+            void write_state(detail::StateWriter& out) const;
+            void read_state(detail::StateReader& in);
+        public:
+            /// @brief Adds one sample
+            void add(real_t x);
+            /// @brief Adds the n samples x
+            void add(const real_t* x, size_t n);
+            /// @brief Adds all the samples seen by other
+            void merge(const ExponentialAccumulator& other);
+            /// @brief Number of samples added
+            size_t count() const;
+            /// @brief Maximum likelihood Exponential of the samples added (x0 = smallest sample, k = 1 / (mean - x0))
+            Exponential fit() const;
+    };
+
+    /// @brief Fits an Exponential distribution to raw samples by maximum likelihood, in one pass with no binning
+    /// @param samples list of samples
+    /// @return The maximum likelihood Exponential distribution of the samples
+    Exponential fitExponentialFromSamples(const std::vector<real_t>& samples);
 }
 
 #endif
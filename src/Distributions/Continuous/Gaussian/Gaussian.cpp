@@ -1,5 +1,7 @@
 #include "Gaussian.h"
-#include "basicfxn.h"
+#include "fitting.h"
+#include "special.h"
+#include "simd.h"
 
 namespace DiceForge
 {
@@ -10,6 +12,9 @@ namespace DiceForge
         {
             throw std::invalid_argument("Value of sigma must be positive!");
         }
+        inv_sigma = 1 / sigma;
+        norm = inv_sigma / sqrt(2.0 * M_PI);
+        log_norm = log(norm);
     }
 
     real_t Gaussian::next(real_t r1, real_t r2)
@@ -17,6 +22,25 @@ namespace DiceForge
         return (sqrt(-2.0 * log(r1)) * cos(2 * M_PI * r2)) * sigma + mu;
     }
 
+    std::pair<real_t, real_t> Gaussian::next_pair(real_t r1, real_t r2)
+    {
+        // The sine half of Box-Muller is independent of the cosine half
+        real_t r = sqrt(-2.0 * log(r1)) * sigma;
+        return std::make_pair(r * cos(2 * M_PI * r2) + mu, r * sin(2 * M_PI * r2) + mu);
+    }
+
+    void Gaussian::scale_each(const real_t* mu, const real_t* sigma, real_t* z, size_t n)
+    {
+        size_t j = 0;
+#if defined(DF_SIMD_REAL)
+        typedef simd::vreal V;
+        for (; j + V::width <= n; j += V::width)
+            (V::load(z + j) * V::load(sigma + j) + V::load(mu + j)).store(z + j);
+#endif
+        for (; j < n; j++)
+            z[j] = z[j] * sigma[j] + mu[j];
+    }
+
     real_t Gaussian::variance() const
     {
         return sigma * sigma;
@@ -29,7 +53,7 @@ namespace DiceForge
 
     real_t Gaussian::minValue() const
     {
-        return std::numeric_limits<real_t>().min();
+        return std::numeric_limits<real_t>().lowest();
     }
 
     real_t Gaussian::maxValue() const
@@ -39,20 +63,63 @@ namespace DiceForge
 
     real_t Gaussian::pdf(real_t x) const
     {
-        return exp(-0.5 * pow((x - mu) / sigma, 2)) / (sqrt(2.0 * M_PI) * sigma);
+        real_t z = (x - mu) * inv_sigma;
+        return norm * exp(-0.5 * z * z);
     }
 
     real_t Gaussian::cdf(real_t x) const
     {
-        real_t erf = myerf((x - mu) / (sigma * sqrt(2)));
-        return 0.5 * (1 + erf);
+        return special::normal_cdf((x - mu) * inv_sigma);
+    }
+
+    real_t Gaussian::logpdf(real_t x) const
+    {
+        real_t z = (x - mu) * inv_sigma;
+        return log_norm - 0.5 * z * z;
+    }
+
+    void Gaussian::pdf(const real_t* x, real_t* out, size_t n) const
+    {
+        const real_t m = mu, s = inv_sigma, c = norm;
+        for (size_t i = 0; i < n; i++)
+        {
+            real_t z = (x[i] - m) * s;
+            out[i] = c * exp(-0.5 * z * z);
+        }
+    }
+
+    void Gaussian::logpdf(const real_t* x, real_t* out, size_t n) const
+    {
+        const real_t m = mu, s = inv_sigma, c = log_norm;
+        for (size_t i = 0; i < n; i++)
+        {
+            real_t z = (x[i] - m) * s;
+            out[i] = c - 0.5 * z * z;
+        }
+    }
+
+    void Gaussian::cdf(const real_t* x, real_t* out, size_t n) const
+    {
+        const real_t m = mu, s = inv_sigma;
+        for (size_t i = 0; i < n; i++)
+            out[i] = (x[i] - m) * s;
+        special::normal_cdf(out, out, n);
+    }
+
+    real_t Gaussian::quantile(real_t p) const
+    {
+        detail::check_probability(p);
+        return mu + sigma * special::normal_quantile(p);
     }
 
-    real_t Gaussian::myerf(real_t x) const
+    void Gaussian::quantile(const real_t* p, real_t* out, size_t n) const
     {
-        real_t erf;
-        erf = tanh((2 / sqrt(M_PI)) * (x + (11 / 123) * pow(x, 3)));
-        return erf;
+        for (size_t i = 0; i < n; i++)
+            detail::check_probability(p[i]);
+        special::normal_quantile(p, out, n);
+        const real_t m = mu, s = sigma;
+        for (size_t i = 0; i < n; i++)
+            out[i] = m + s * out[i];
     }
 
     real_t Gaussian::get_mu() const
@@ -65,6 +132,28 @@ namespace DiceForge
         return sigma;
     }
 
+    void Gaussian::write_state(detail::StateWriter& out) const
+    {
+        out.tag("Gaussian");
+        out.put(mu);
+        out.put(sigma);
+        out.put(uint8_t(has_cached));
+        out.put(cached);
+    }
+
+    void Gaussian::read_state(detail::StateReader& in)
+    {
+        in.tag("Gaussian");
+        const real_t m = in.get<real_t>(), s = in.get<real_t>();
+        const bool c = in.get<uint8_t>() != 0;
+        const real_t z = in.get<real_t>();
+        in.end();
+        // Through the constructor, which checks sigma and derives the constants of the pdf
+        *this = Gaussian(m, s);
+        has_cached = c;
+        cached = z;
+    }
+
     Gaussian fitToGaussian(const std::vector<real_t> &x, const std::vector<real_t> &y, int max_iter, real_t epsilon)
     {
         if (x.size() != y.size())
@@ -111,61 +200,99 @@ namespace DiceForge
         //setting initial guess of sigma
         sigma = (xmax - xmin) / 6;
 
-        // Start iterative updation
-        for (size_t iter = 0; iter < max_iter; iter++)
+        // r_i = y[i] - pdf(mu, sigma, x[i]), minimise sum (r_i)^2 over (mu, sigma)
+        auto model = [](auto x, const real_t* theta, auto* grad)
         {
-            // Compute Jacobian matrix and error vector
-            matrix_t J(N, 2); // Jacobian matrix
-            matrix_t R(N, 1); // Error vector
+            typedef decltype(x) V;
+            real_t mu = theta[0], sigma = theta[1];
+            if (!(sigma > 0))
+                return V(NAN);
+            real_t inv_sigma = 1 / sigma;
+            V z = (x - mu) * inv_sigma;
+            V pdf = simd::exp(z * z * -0.5) * (inv_sigma / sqrt(2 * M_PI));
 
-            for (size_t i = 0; i < N; i++)
-            {
-                real_t pdf = exp(-(x[i] - mu) * (x[i] - mu) / (2 * sigma * sigma)) / (sqrt(2 * M_PI) * sigma);
+            // Partial derivatives of the Gaussian function with respect to mu and sigma
+            grad[0] = z * inv_sigma * pdf;
+            grad[1] = (z * z - 1) * inv_sigma * pdf;
+            return pdf;
+        };
 
-                //  Partial derivatives of the Gaussian function with respect to mu and sigma
-                real_t dpdf_dmu = (x[i] - mu) / (sigma * sigma) * pdf;
-                real_t dpdf_dsigma = ((x[i] - mu) * (x[i] - mu) / (sigma * sigma * sigma) - 1 / sigma) * pdf;
+        real_t theta[2] = {mu, sigma};
+        levenberg_marquardt<2>(model, x.data(), y.data(), N, theta, max_iter, epsilon);
+        mu = theta[0];
+        sigma = theta[1];
 
-                J[i][0] = -dpdf_dmu;
-                J[i][1] = -dpdf_dsigma;
-
-                R[i][0] = y[i] - pdf;
-            }
+        if (sigma < 0 || std::isnan(sigma))
+        {
+            throw std::runtime_error("Could not fit data to Gaussian! Data is probably too noisy or not Gaussian!");
+        }
 
-            // Compute the transpose of the Jacobian matrix
-            matrix_t JT = J.transpose();
+        return Gaussian(mu, sigma);
+    }
 
-            // Compute the move direction using the Gauss-Newton method
-            matrix_t d = inverse2x2(JT * J) * JT * R;
+    void GaussianAccumulator::add(real_t x)
+    {
+        // Welford's update
+        n++;
+        real_t delta = x - mean;
+        mean += delta / n;
+        m2 += delta * (x - mean);
+    }
 
-            // Stop when error minimization is too little
-            if (fabs(d[0][0]) < epsilon && fabs(d[1][0]) < epsilon)
-            {
-                break;
-            }
+    void GaussianAccumulator::add(const real_t* x, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+            add(x[i]);
+    }
 
-            real_t alpha = 0.001;
+    void GaussianAccumulator::merge(const GaussianAccumulator& other)
+    {
+        if (other.n == 0)
+            return;
+        size_t total = n + other.n;
+        real_t delta = other.mean - mean;
+        mean += delta * other.n / total;
+        m2 += other.m2 + delta * delta * n * other.n / total;
+        n = total;
+    }
 
-            real_t pred_mu, pred_sigma;
-            pred_mu = mu - alpha * d[0][0];
-            pred_sigma = sigma - alpha * d[1][0];
+    size_t GaussianAccumulator::count() const
+    {
+        return n;
+    }
 
-            // prevent possible incorrect jumping
-            if ((pred_mu / mu > 10 || pred_sigma / sigma > 10 || pred_mu / mu < 0.1 || pred_sigma / sigma < 0.1))
-            {
-                alpha = alpha * 0.0001;
-            }
+    void GaussianAccumulator::write_state(detail::StateWriter& out) const
+    {
+        out.tag("GaussianAccumulator");
+        out.put(uint64_t(n));
+        out.put(mean);
+        out.put(m2);
+    }
 
-            // Gauss-Newton method
-            mu = mu - alpha * d[0][0];
-            sigma = sigma - alpha * d[1][0];
-        }
+    void GaussianAccumulator::read_state(detail::StateReader& in)
+    {
+        in.tag("GaussianAccumulator");
+        GaussianAccumulator loaded;
+        loaded.n = size_t(in.get<uint64_t>());
+        loaded.mean = in.get<real_t>();
+        loaded.m2 = in.get<real_t>();
+        in.end();
+        *this = loaded;
+    }
 
-        if (sigma < 0 || std::isnan(sigma))
+    Gaussian GaussianAccumulator::fit() const
+    {
+        if (n < 2 || !(m2 > 0))
         {
-            throw std::runtime_error("Could not fit data to Gaussian! Data is probably too noisy or not Gaussian!");
+            throw std::runtime_error("Could not fit samples to Gaussian! At least two distinct samples are needed!");
         }
+        return Gaussian(mean, sqrt(m2 / n));
+    }
 
-        return Gaussian(mu, sigma);
+    Gaussian fitGaussianFromSamples(const std::vector<real_t>& samples)
+    {
+        GaussianAccumulator acc;
+        acc.add(samples.data(), samples.size());
+        return acc.fit();
     }
 }
@@ -2,13 +2,26 @@
 #define DF_GAUSSIAN_H
 
 #include "distribution.h"
+#include "polar.h"
+#include "ziggurat.h"
 
 namespace DiceForge {
     /// @brief DiceForge::Gaussian - A Continuous Probability Distribution (Gaussian) 
-    class Gaussian : public Continuous {
+    /// @note The state (the parameters and the variate cached by next_cached) can be saved with save_state
+    class Gaussian : public Continuous, public Serializable<Gaussian> {
+        friend class Serializable<Gaussian>;
         private:
             real_t mu, sigma;
-            real_t myerf(real_t x) const;
+            // 1 / sigma and the normalisation 1 / (sqrt(2 pi) sigma) of the pdf, with its logarithm
+            real_t inv_sigma, norm, log_norm;
+            // Second variate of the last pair drawn by next_cached()
+            real_t cached = 0;
+            bool has_cached = false;
+            // The parameters and the cached variate, for save_state and load_state (see DiceForge::Serializable)
+            void write_state(detail::StateWriter& out) const;
+            void read_state(detail::StateReader& in);
+            // z[j] * sigma[j] + mu[j] for the standard variates z of sample_each, on lanes of simd::vreal
+            static void scale_each(const real_t* mu, const real_t* sigma, real_t* z, size_t n);
         public:
             /// @brief Initializes the Gaussian distribution about location x = mu with standard deviation sigma
             /// @param mu mean of the distribution
@@ -18,6 +31,102 @@ namespace DiceForge {
             /// @param r1 A random real number uniformly distributed between 0 and 1
             /// @param r2 A random real number uniformly distributed between 0 and 1
             real_t next(real_t r1, real_t r2);
+            /// @brief Returns the next value of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @note Uses the Ziggurat method, mostly one random integer, a table lookup and a multiply per value
+            template <typename Derived, typename T>
+            real_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+            {
+                DF_INSTRUMENT_SAMPLES("Gaussian", 1);
+                return ziggurat::next_normal(rng) * sigma + mu;
+            }
+            /// @brief Fills the buffer with values of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param out Pointer to the first element of the buffer
+            /// @param n Number of values to be written
+            /// @note Ziggurat method, as in next(rng)
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, real_t* out, size_t n)
+            {
+                DF_INSTRUMENT_SAMPLES("Gaussian", n);
+                for (size_t j = 0; j < n; j++)
+                    out[j] = next(rng);
+            }
+            /// @brief Fills the buffer with single precision values of the random variable
+            /// @note ziggurat::fill_normal, 32 random bits per value in the common case
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, float* out, size_t n)
+            {
+                DF_INSTRUMENT_SAMPLES("Gaussian", n);
+                ziggurat::fill_normal(rng, out, n);
+                const float m = float(mu), s = float(sigma);
+                for (size_t j = 0; j < n; j++)
+                    out[j] = out[j] * s + m;
+            }
+            /// @brief Fills the buffer with one value of each of n Gaussian distributions, without constructing them
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param mu Pointer to the n means
+            /// @param sigma Pointer to the n standard deviations (> 0)
+            /// @param out Pointer to the first element of the buffer
+            /// @param n Number of values to be written
+            /// @note Standard variates by the Ziggurat method, then scaled and shifted lanes at a time
+            template <typename Derived, typename T>
+            static void sample_each(DiceForge::StaticGenerator<Derived, T>& rng, const real_t* mu, const real_t* sigma,
+                                    real_t* out, size_t n)
+            {
+                DF_INSTRUMENT_SAMPLES("Gaussian", n);
+                bool valid = true;
+                for (size_t j = 0; j < n; j++)
+                    valid &= (sigma[j] > 0);
+                if (!valid)
+                    throw std::invalid_argument("Value of sigma must be positive!");
+                for (size_t j = 0; j < n; j++)
+                    out[j] = ziggurat::next_normal(rng);
+                scale_each(mu, sigma, out, n);
+            }
+#if defined(DF_SPAN)
+            /// @brief Fills the span with values of the random variable described by the distribution
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<real_t> out)
+            {
+                sample(rng, out.data(), out.size());
+            }
+            /// @brief Fills the span with single precision values of the random variable
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<float> out)
+            {
+                sample(rng, out.data(), out.size());
+            }
+#endif
+            /// @brief Returns two independent values of the random variable from one pair of uniforms (Box-Muller)
+            /// @param r1 A random real number uniformly distributed between 0 and 1
+            /// @param r2 A random real number uniformly distributed between 0 and 1
+            std::pair<real_t, real_t> next_pair(real_t r1, real_t r2);
+            /// @brief Returns two independent values of the random variable (Marsaglia's polar method)
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            template <typename Derived, typename T>
+            std::pair<real_t, real_t> next_pair(DiceForge::StaticGenerator<Derived, T>& rng)
+            {
+                DF_INSTRUMENT_SAMPLES("Gaussian", 2);
+                std::pair<real_t, real_t> z = polar::normal_pair(rng);
+                return std::make_pair(z.first * sigma + mu, z.second * sigma + mu);
+            }
+            /// @brief Returns the next value of the random variable, drawing a new pair (polar method) every other call
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @note The second value of each pair is kept in this object, so a copy of it continues the same sequence
+            template <typename Derived, typename T>
+            real_t next_cached(DiceForge::StaticGenerator<Derived, T>& rng)
+            {
+                DF_INSTRUMENT_SAMPLES("Gaussian", 1);
+                if (has_cached) {
+                    has_cached = false;
+                    return cached;
+                }
+                std::pair<real_t, real_t> z = next_pair(rng);
+                cached = z.second;
+                has_cached = true;
+                return z.first;
+            }
             /// @brief Returns the theoretical variance of the distribution
             real_t variance() const override final;
             /// @brief Returns the theoretical expectation value of the distribution
@@ -33,6 +142,20 @@ namespace DiceForge {
             real_t pdf(real_t x) const override final;
             /// @brief Cumulative distribution function of the Gaussian distribution
             real_t cdf(real_t x) const override final;
+            /// @brief Natural logarithm of the probability density function of the Gaussian distribution
+            real_t logpdf(real_t x) const override final;
+            /// @brief Probability density function of the Gaussian distribution at the n locations x, written to out
+            void pdf(const real_t* x, real_t* out, size_t n) const override final;
+            /// @brief Logarithm of the probability density function at the n locations x, written to out
+            void logpdf(const real_t* x, real_t* out, size_t n) const override final;
+            /// @brief Cumulative distribution function at the n locations x, written to out
+            void cdf(const real_t* x, real_t* out, size_t n) const override final;
+            /// @brief Quantile function (inverse cdf) of the Gaussian distribution
+            /// @note mu + sigma special::normal_quantile(p)
+            real_t quantile(real_t p) const override final;
+            /// @brief Quantile function at the n probabilities p, written to out (out may be p)
+            /// @note Through the vectorised special::normal_quantile
+            void quantile(const real_t* p, real_t* out, size_t n) const override final;
             /// @brief Returns mean of the distribution
             real_t get_mu() const;
             /// @brief Returns standard deviation of the distribution
@@ -47,6 +170,35 @@ namespace DiceForge {
     /// @param epsilon minimum acceptable error tolerance while attempting to fit the data (smaller to try for better fits)
     /// @return A Gaussian distribution fit to the given sample points
     Gaussian fitToGaussian(const std::vector<real_t>& x, const std::vector<real_t>& y, int max_iter = 10000, real_t epsilon = 1e-6);
+
+    /// @brief Streaming sufficient statistics of a sample (count, mean and sum of squared deviations), from which
+    /// the maximum likelihood Gaussian follows in closed form. Accumulators over parts of a sample can be merged.
+    /// @note The statistics can be saved with save_state, to carry on with a sample from a checkpoint
+    class GaussianAccumulator : public Serializable<GaussianAccumulator> {
+        friend class Serializable<GaussianAccumulator>;
+        private:
+            size_t n = 0;
+            real_t mean = 0, m2 = 0;
+            // The statistics, for save_state and load_state (see DiceForge::Serializable)
+            void write_state(detail::StateWriter& out) const;
+            void read_state(detail::StateReader& in);
+        public:
+            /// @brief Adds one sample
+            void add(real_t x);
+            /// @brief Adds the n samples x
+            void add(const real_t* x, size_t n);
+            /// @brief Adds all the samples seen by other
+            void merge(const GaussianAccumulator& other);
+            /// @brief Number of samples added
+            size_t count() const;
+            /// @brief Maximum likelihood Gaussian of the samples added (mu = sample mean, sigma^2 = mean squared deviation)
+            Gaussian fit() const;
+    };
+
+    /// @brief Fits a Gaussian distribution to raw samples by maximum likelihood, in one pass with no binning
+    /// @param samples list of samples
+    /// @return The maximum likelihood Gaussian distribution of the samples
+    Gaussian fitGaussianFromSamples(const std::vector<real_t>& samples);
 }
 
 
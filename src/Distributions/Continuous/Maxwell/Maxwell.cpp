@@ -1,5 +1,6 @@
 #include "Maxwell.h"
-#include "basicfxn.h"
+#include "fitting.h"
+#include "special.h"
 #include <math.h>
 
 namespace DiceForge
@@ -14,11 +15,10 @@ namespace DiceForge
 
     real_t Maxwell::next(real_t r1, real_t r2, real_t r3) 
     {
-        real_t x1 = (sqrt(-2.0 * log(r1)) * cos(2 * M_PI * r2)) * a;
-        real_t x2 = (sqrt(-2.0 * log(r1)) * sin(2 * M_PI * r2)) * a;
-        real_t x3 = (sqrt(-2.0 * log(r2)) * cos(2 * M_PI * r3)) * a;
-    
-        return sqrt(x1*x1 + x2*x2 + x3*x3);
+        // x1^2 + x2^2 for a Box-Muller pair from (r1, r) is -2 log(r1) whatever r is
+        real_t x3 = sqrt(-2.0 * log(r2)) * cos(2 * M_PI * r3);
+
+        return a * sqrt(-2.0 * log(r1) + x3 * x3);
     }
 
     real_t Maxwell::variance() const 
@@ -48,15 +48,73 @@ namespace DiceForge
 
     real_t Maxwell::cdf(real_t x) const 
     {        
-        real_t beta = 1/(2*a*a);
-        return beta * sqrt(beta)*sqrt(x)*exp(-x*beta)/tgamma(1.5);
+        return (x > 0) ? special::gamma_p(1.5, x * x / (2 * a * a)) : 0;
     } 
 
+    real_t Maxwell::logpdf(real_t x) const
+    {
+        return log(sqrt(2 / M_PI) / (a * a * a)) + log(x * x) - x * x / (2 * a * a);
+    }
+
+    void Maxwell::pdf(const real_t* x, real_t* out, size_t n) const
+    {
+        const real_t c = sqrt(2 / M_PI) / (a * a * a), h = 1 / (2 * a * a);
+        for (size_t i = 0; i < n; i++)
+            out[i] = c * x[i] * x[i] * exp(-h * x[i] * x[i]);
+    }
+
+    void Maxwell::logpdf(const real_t* x, real_t* out, size_t n) const
+    {
+        const real_t c = log(sqrt(2 / M_PI) / (a * a * a)), h = 1 / (2 * a * a);
+        for (size_t i = 0; i < n; i++)
+            out[i] = c + log(x[i] * x[i]) - h * x[i] * x[i];
+    }
+
+    void Maxwell::cdf(const real_t* x, real_t* out, size_t n) const
+    {
+        const real_t h = 1 / (2 * a * a);
+        for (size_t i = 0; i < n; i++)
+            out[i] = (x[i] > 0) ? special::gamma_p(1.5, x[i] * x[i] * h) : 0;
+    }
+
+    real_t Maxwell::quantile(real_t p) const
+    {
+        detail::check_probability(p);
+        return a * sqrt(2 * special::gamma_p_inverse(1.5, p));
+    }
+
+    void Maxwell::quantile(const real_t* p, real_t* out, size_t n) const
+    {
+        for (size_t i = 0; i < n; i++)
+            out[i] = quantile(p[i]);
+    }
+
     real_t Maxwell::get_a() const
     {
         return a;
     }
 
+    void Maxwell::write_state(detail::StateWriter& out) const
+    {
+        out.tag("Maxwell");
+        out.put(a);
+        out.put(uint8_t(has_cached));
+        out.put(cached);
+    }
+
+    void Maxwell::read_state(detail::StateReader& in)
+    {
+        in.tag("Maxwell");
+        const real_t scale = in.get<real_t>();
+        const bool c = in.get<uint8_t>() != 0;
+        const real_t z = in.get<real_t>();
+        in.end();
+        // Through the constructor, which checks the scale
+        *this = Maxwell(scale);
+        has_cached = c;
+        cached = z;
+    }
+
     Maxwell fitToMaxwell(const std::vector<real_t>& x, const std::vector<real_t>& y, int max_iter, real_t epsilon)
     {
         if (x.size() != y.size())
@@ -78,52 +136,82 @@ namespace DiceForge
             }
         }
 
-        // starting iterative updation 
-        for (size_t i=0; i < max_iter; i++)
+        // r_i = y[i] - pdf(a, x[i]), minimise sum (r_i)^2 over a
+        auto model = [](auto x, const real_t* theta, auto* grad)
         {
-            real_t J[N];                    // Jacobian matrix 
-            real_t R[N];                    // Error vector R = (r_0, r_1, ..., r_N)
-            real_t JTJ = 0, JTR = 0;
+            typedef decltype(x) V;
+            real_t a = theta[0];
+            if (!(a > 0))
+                return V(NAN);
+            V x2 = x * x;
+            V f = x2 * simd::exp(x2 * (-1 / (2 * a * a))) * (sqrt(2 / M_PI) / (a * a * a));
+            grad[0] = f * (x2 * (1 / (a * a * a)) - 3 / a);
+            return f;
+        };
+
+        levenberg_marquardt<1>(model, x.data(), y.data(), N, &a, max_iter, epsilon);
 
-            for (size_t j = 0; j < N; j++)
-            {
-                real_t f = sqrt(2 / M_PI) * x[j] * x[j] * exp(-1 * x[j] * x[j] / (2 * a * a)) / (a * a * a);
-                real_t dpdf_da = f * ((-3 / a) + (x[j] * x[j]) / (a * a * a));
+        if (a < 0 || std::isnan(a))
+        {
+            throw std::runtime_error("Could not fit data to Maxwell distribution! Data is probably too noisy or not Maxwell!");
+        }
 
-                J[j] = -dpdf_da;
-                R[j] = y[j] - f;
-                JTJ += J[j] * J[j];
-                JTR += J[j] * R[j];
-            }
+        return Maxwell(a);
+    }
 
-            // move direction 
-            real_t d = JTR / JTJ;
+    void MaxwellAccumulator::add(real_t x)
+    {
+        n++;
+        sum2 += x * x;
+    }
 
-            // stop when error minimization is too little 
-            if (fabs(d) < epsilon){
-                break;
-            }
+    void MaxwellAccumulator::add(const real_t* x, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+            add(x[i]);
+    }
 
-            real_t alpha = 1; 
-            
-            real_t pred_a;
-            pred_a = a - alpha * d;
+    void MaxwellAccumulator::merge(const MaxwellAccumulator& other)
+    {
+        n += other.n;
+        sum2 += other.sum2;
+    }
 
-            // prevent possible incorrect jumping
-            if ((pred_a / a > 100 || pred_a / a < 0.01))
-            {
-                alpha = alpha * 0.01;
-            }
+    size_t MaxwellAccumulator::count() const
+    {
+        return n;
+    }
 
-            // Gauss-Newton method
-            a = a - alpha * d;
-        }
+    void MaxwellAccumulator::write_state(detail::StateWriter& out) const
+    {
+        out.tag("MaxwellAccumulator");
+        out.put(uint64_t(n));
+        out.put(sum2);
+    }
 
-        if (a < 0 || std::isnan(a))
+    void MaxwellAccumulator::read_state(detail::StateReader& in)
+    {
+        in.tag("MaxwellAccumulator");
+        MaxwellAccumulator loaded;
+        loaded.n = size_t(in.get<uint64_t>());
+        loaded.sum2 = in.get<real_t>();
+        in.end();
+        *this = loaded;
+    }
+
+    Maxwell MaxwellAccumulator::fit() const
+    {
+        if (n < 1 || !(sum2 > 0))
         {
-            throw std::runtime_error("Could not fit data to Maxwell distribution! Data is probably too noisy or not Maxwell!");
+            throw std::runtime_error("Could not fit samples to Maxwell distribution! At least one non-zero sample is needed!");
         }
+        return Maxwell(sqrt(sum2 / (3 * n)));
+    }
 
-        return Maxwell(a);
+    Maxwell fitMaxwellFromSamples(const std::vector<real_t>& samples)
+    {
+        MaxwellAccumulator acc;
+        acc.add(samples.data(), samples.size());
+        return acc.fit();
     }
 }
@@ -2,13 +2,24 @@
 #define DF_MAXWELL_H
 
 #include "distribution.h"
+#include "polar.h"
+#include "ziggurat.h"
+#include <algorithm>
 
 namespace DiceForge {
     /// @brief DiceForge::Maxwell - A Continuous Probability Distribution (Maxwell) 
-    class Maxwell : public Continuous
+    /// @note The state (the scale and the cached normal) can be saved with save_state
+    class Maxwell : public Continuous, public Serializable<Maxwell>
     {
+        friend class Serializable<Maxwell>;
         private:
             real_t a;
+            // Second normal of the last pair drawn by next(rng)
+            real_t cached = 0;
+            bool has_cached = false;
+            // The parameters and the cached normal, for save_state and load_state (see DiceForge::Serializable)
+            void write_state(detail::StateWriter& out) const;
+            void read_state(detail::StateReader& in);
         public:
             /// @brief Initializes the Maxwell distribution with scale "a"
             /// @param a scale factor of the distribution
@@ -18,7 +29,80 @@ namespace DiceForge {
             /// @param r1 A random real number uniformly distributed between 0 and 1
             /// @param r2 A random real number uniformly distributed between 0 and 1
             /// @param r3 A random real number uniformly distributed between 0 and 1
+            /// @note The squared speed is the sum of -2 log(r1), for two of the components, and the square of a
+            /// normal built from r2 and r3 for the third, so the components are independent
             real_t next(real_t r1, real_t r2, real_t r3);
+            /// @brief Generates a random number from the Maxwell Distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @note Two components contribute -2 log(u) to the squared speed and the third is one half of a normal
+            /// pair (polar method), the other half being kept in this object for the next call
+            template <typename Derived, typename T>
+            real_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+            {
+                DF_INSTRUMENT_SAMPLES("Maxwell", 1);
+                real_t z;
+                if (has_cached) {
+                    z = cached;
+                    has_cached = false;
+                }
+                else {
+                    std::pair<real_t, real_t> p = polar::normal_pair(rng);
+                    z = p.first;
+                    cached = p.second;
+                    has_cached = true;
+                }
+                return a * sqrt(z * z - 2.0 * log(1.0 - rng.next_unit()));
+            }
+            /// @brief Fills the buffer with values of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param out Pointer to the first element of the buffer
+            /// @param n Number of values to be written
+            /// @note Draws as next(rng) would from a fresh object, both halves of each normal pair going to consecutive
+            /// values; the cached normal of next(rng) is neither used nor changed, so a call draws from this rng only
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, real_t* out, size_t n)
+            {
+                DF_INSTRUMENT_SAMPLES("Maxwell", n);
+                for (size_t j = 0; j < n; j += 2) {
+                    std::pair<real_t, real_t> p = polar::normal_pair(rng);
+                    out[j] = a * sqrt(p.first * p.first - 2.0 * log(1.0 - rng.next_unit()));
+                    if (j + 1 < n)
+                        out[j + 1] = a * sqrt(p.second * p.second - 2.0 * log(1.0 - rng.next_unit()));
+                }
+            }
+            /// @brief Fills the buffer with single precision values of the random variable
+            /// @note a sqrt(z^2 + 2 e) for a normal z and an exponential e, drawn in blocks by ziggurat::fill_normal and
+            /// ziggurat::fill_exponential
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, float* out, size_t n)
+            {
+                DF_INSTRUMENT_SAMPLES("Maxwell", n);
+                float e[ziggurat::float_block];
+                const float s = float(a);
+                while (n > 0) {
+                    size_t m = std::min(n, ziggurat::float_block);
+                    ziggurat::fill_normal(rng, out, m);
+                    ziggurat::fill_exponential(rng, e, m);
+                    for (size_t j = 0; j < m; j++)
+                        out[j] = s * std::sqrt(out[j] * out[j] + 2 * e[j]);
+                    out += m;
+                    n -= m;
+                }
+            }
+#if defined(DF_SPAN)
+            /// @brief Fills the span with values of the random variable described by the distribution
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<real_t> out)
+            {
+                sample(rng, out.data(), out.size());
+            }
+            /// @brief Fills the span with single precision values of the random variable
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<float> out)
+            {
+                sample(rng, out.data(), out.size());
+            }
+#endif
             /// @brief Returns the theoretical variance of the distribution
             real_t variance() const override final;
             /// @brief Returns the theoretical expectation value of the distribution
@@ -32,7 +116,21 @@ namespace DiceForge {
             /// @brief Probability density function of the Maxwell distribution
             real_t pdf(real_t x) const override final;
             /// @brief Cumulative distribution function of the Maxwell distribution
+            /// @note The regularized incomplete gamma function P(3/2, x^2 / (2 a^2))
             real_t cdf(real_t x) const override final;
+            /// @brief Natural logarithm of the probability density function of the Maxwell distribution
+            real_t logpdf(real_t x) const override final;
+            /// @brief Probability density function of the Maxwell distribution at the n locations x, written to out
+            void pdf(const real_t* x, real_t* out, size_t n) const override final;
+            /// @brief Logarithm of the probability density function at the n locations x, written to out
+            void logpdf(const real_t* x, real_t* out, size_t n) const override final;
+            /// @brief Cumulative distribution function at the n locations x, written to out
+            void cdf(const real_t* x, real_t* out, size_t n) const override final;
+            /// @brief Quantile function (inverse cdf) of the Maxwell distribution
+            /// @note a sqrt(2 special::gamma_p_inverse(3/2, p))
+            real_t quantile(real_t p) const override final;
+            /// @brief Quantile function at the n probabilities p, written to out (out may be p)
+            void quantile(const real_t* p, real_t* out, size_t n) const override final;
             /// @brief Returns the scale factor of the distribution 
             real_t get_a() const;
     };
@@ -45,6 +143,35 @@ namespace DiceForge {
     /// @param epsilon minimum acceptable error tolerance while attempting to fit the data (smaller to try for better fits)
     /// @return A Maxwell distribution fit to the given sample points
     Maxwell fitToMaxwell(const std::vector<real_t>& x, const std::vector<real_t>& y, int max_iter, real_t epsilon);
+
+    /// @brief Streaming sufficient statistics of a sample (count and sum of squares), from which the maximum likelihood
+    /// Maxwell distribution follows in closed form. Accumulators over parts of a sample can be merged.
+    /// @note The statistics can be saved with save_state, to carry on with a sample from a checkpoint
+    class MaxwellAccumulator : public Serializable<MaxwellAccumulator> {
+        friend class Serializable<MaxwellAccumulator>;
+        private:
+            size_t n = 0;
+            real_t sum2 = 0;
+            // The statistics, for save_state and load_state (see DiceForge::Serializable)
+            void write_state(detail::StateWriter& out) const;
+            void read_state(detail::StateReader& in);
+        public:
+            /// @brief Adds one sample
+            void add(real_t x);
+            /// @brief Adds the n samples x
+            void add(const real_t* x, size_t n);
+            /// @brief Adds all the samples seen by other
+            void merge(const MaxwellAccumulator& other);
+            /// @brief Number of samples added
+            size_t count() const;
+            /// @brief Maximum likelihood Maxwell distribution of the samples added (a^2 = mean of x^2 / 3)
+            Maxwell fit() const;
+    };
+
+    /// @brief Fits a Maxwell distribution to raw samples by maximum likelihood, in one pass with no binning
+    /// @param samples list of samples
+    /// @return The maximum likelihood Maxwell distribution of the samples
+    Maxwell fitMaxwellFromSamples(const std::vector<real_t>& samples);
 }
 
 
@@ -0,0 +1,167 @@
+#include "MultivariateGaussian.h"
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+
+namespace DiceForge {
+
+    namespace {
+        // Loads and stores with the same spelling for real_t and simd::vreal
+        template <typename V>
+        struct lanes
+        {
+            static constexpr size_t width = 1;
+            static V load(const real_t* p) { return *p; }
+            static void store(real_t* p, V v) { *p = v; }
+        };
+#if defined(DF_SIMD_REAL)
+        template <>
+        struct lanes<simd::vreal>
+        {
+            static constexpr size_t width = simd::vreal::width;
+            static simd::vreal load(const real_t* p) { return simd::vreal::load(p); }
+            static void store(real_t* p, simd::vreal v) { v.store(p); }
+        };
+#endif
+
+        // One tile of 4 rows of the factor times the block of standard normals zt (one row of block reals per
+        // dimension), over its K columns: y[r * block + c] = sum_k l[4 k + r] zt[k * block + c]
+        template <typename V>
+        void multiply_tile(const real_t* l, size_t K, const real_t* zt, real_t* y)
+        {
+            constexpr size_t w = lanes<V>::width, block = MultivariateGaussian::block;
+            for (size_t c = 0; c < block; c += 2 * w)
+            {
+                V a00(0.0), a01(0.0), a10(0.0), a11(0.0), a20(0.0), a21(0.0), a30(0.0), a31(0.0);
+                for (size_t k = 0; k < K; k++)
+                {
+                    const V z0 = lanes<V>::load(zt + k * block + c), z1 = lanes<V>::load(zt + k * block + c + w);
+                    const V l0(l[4 * k]), l1(l[4 * k + 1]), l2(l[4 * k + 2]), l3(l[4 * k + 3]);
+                    a00 += l0 * z0, a01 += l0 * z1;
+                    a10 += l1 * z0, a11 += l1 * z1;
+                    a20 += l2 * z0, a21 += l2 * z1;
+                    a30 += l3 * z0, a31 += l3 * z1;
+                }
+                lanes<V>::store(y + c, a00), lanes<V>::store(y + c + w, a01);
+                lanes<V>::store(y + block + c, a10), lanes<V>::store(y + block + c + w, a11);
+                lanes<V>::store(y + 2 * block + c, a20), lanes<V>::store(y + 2 * block + c + w, a21);
+                lanes<V>::store(y + 3 * block + c, a30), lanes<V>::store(y + 3 * block + c + w, a31);
+            }
+        }
+    }
+
+    MultivariateGaussian::MultivariateGaussian(const std::vector<real_t>& mean, const std::vector<real_t>& covariance)
+        : d(mean.size()), mu(mean), sigma(covariance), factor(mean.size() * mean.size(), 0.0)
+    {
+        if (d == 0 || covariance.size() != d * d)
+            throw std::invalid_argument("Expected a non-empty mean and a d x d covariance!");
+
+        // Cholesky-Banachiewicz, row by row
+        real_t log_det = 0;
+        for (size_t i = 0; i < d; i++) {
+            for (size_t j = 0; j <= i; j++) {
+                real_t s = covariance[i * d + j];
+                for (size_t k = 0; k < j; k++)
+                    s -= factor[i * d + k] * factor[j * d + k];
+                if (j < i)
+                    factor[i * d + j] = s / factor[j * d + j];
+                else {
+                    if (!(s > 0))
+                        throw std::invalid_argument("The covariance must be positive definite!");
+                    factor[i * d + i] = std::sqrt(s);
+                    log_det += 2 * std::log(factor[i * d + i]);
+                }
+            }
+        }
+        log_norm = -0.5 * (d * std::log(2 * M_PI) + log_det);
+
+        const size_t tiles = (d + 3) / 4;
+        offset.resize(tiles + 1);
+        offset[0] = 0;
+        for (size_t t = 0; t < tiles; t++)
+            offset[t + 1] = offset[t] + 4 * std::min(4 * t + 4, d);
+        packed.assign(offset[tiles], 0.0);
+        for (size_t t = 0; t < tiles; t++)
+            for (size_t r = 0; r < 4 && 4 * t + r < d; r++)
+                for (size_t k = 0; k <= 4 * t + r; k++)
+                    packed[offset[t] + 4 * k + r] = factor[(4 * t + r) * d + k];
+    }
+
+    size_t MultivariateGaussian::dimensions() const {
+        return d;
+    }
+
+    void MultivariateGaussian::transform(real_t* z, size_t n) const {
+        // A few vectors are not worth the transposes: x_i = mu_i + sum_k<=i L_ik z_k, from the last component down
+        // so that every z_k is still there when it is needed
+        if (n < 8) {
+            for (size_t v = 0; v < n; v++) {
+                real_t* x = z + v * d;
+                for (size_t i = d; i-- > 0;) {
+                    real_t s = 0;
+                    for (size_t k = 0; k <= i; k++)
+                        s += factor[i * d + k] * x[k];
+                    x[i] = mu[i] + s;
+                }
+            }
+            return;
+        }
+
+        const size_t tiles = (d + 3) / 4;
+        std::vector<real_t> zt(d * block, 0.0), y(4 * tiles * block);
+        for (size_t first = 0; first < n; first += block) {
+            const size_t m = std::min(block, n - first);
+            real_t* x = z + first * d;
+            // Transpose the block, one row per dimension (the columns past m stay 0 in the last block)
+            if (m < block)
+                std::fill(zt.begin(), zt.end(), 0.0);
+            for (size_t v = 0; v < m; v++)
+                for (size_t k = 0; k < d; k++)
+                    zt[k * block + v] = x[v * d + k];
+
+            for (size_t t = 0; t < tiles; t++) {
+#if defined(DF_SIMD_REAL)
+                multiply_tile<simd::vreal>(packed.data() + offset[t], std::min(4 * t + 4, d), zt.data(),
+                                           y.data() + 4 * t * block);
+#else
+                multiply_tile<real_t>(packed.data() + offset[t], std::min(4 * t + 4, d), zt.data(),
+                                      y.data() + 4 * t * block);
+#endif
+            }
+
+            for (size_t v = 0; v < m; v++)
+                for (size_t k = 0; k < d; k++)
+                    x[v * d + k] = mu[k] + y[k * block + v];
+        }
+    }
+
+    real_t MultivariateGaussian::logpdf(const real_t* x) const {
+        // |L^-1 (x - mu)|^2 by forward substitution
+        std::vector<real_t> y(d);
+        real_t q = 0;
+        for (size_t i = 0; i < d; i++) {
+            real_t s = x[i] - mu[i];
+            for (size_t k = 0; k < i; k++)
+                s -= factor[i * d + k] * y[k];
+            y[i] = s / factor[i * d + i];
+            q += y[i] * y[i];
+        }
+        return log_norm - 0.5 * q;
+    }
+
+    real_t MultivariateGaussian::pdf(const real_t* x) const {
+        return std::exp(logpdf(x));
+    }
+
+    const std::vector<real_t>& MultivariateGaussian::get_mu() const {
+        return mu;
+    }
+
+    const std::vector<real_t>& MultivariateGaussian::get_sigma() const {
+        return sigma;
+    }
+
+    const std::vector<real_t>& MultivariateGaussian::get_cholesky() const {
+        return factor;
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef DF_MULTIVARIATE_GAUSSIAN_H
+#define DF_MULTIVARIATE_GAUSSIAN_H
+
+#include "distribution.h"
+#include "generator.h"
+#include "ziggurat.h"
+#include <vector>
+#include <stdexcept>
+
+namespace DiceForge {
+    /// @brief DiceForge::MultivariateGaussian - The multivariate normal distribution N(mu, Sigma) of random vectors
+    /// @note The covariance is factored once as Sigma = L L^T (Cholesky), and a value is mu + L z for a vector z of
+    /// independent standard normals. Batches of vectors are transformed together, as a blocked product of the
+    /// triangular factor with a matrix of standard normals.
+    /// @note Vectors are stored one after the other, so that n of them take n * dimensions() reals
+    class MultivariateGaussian {
+        private:
+            size_t d;
+            std::vector<real_t> mu;
+            std::vector<real_t> sigma;
+            // Lower triangular Cholesky factor, row-major d x d with zeros above the diagonal
+            std::vector<real_t> factor;
+            // The factor in tiles of 4 rows, interleaved by column (row 4t + r, column k at offset[t] + 4 k + r),
+            // each tile ending at its last diagonal element and rows past d zero
+            std::vector<real_t> packed;
+            std::vector<size_t> offset;
+            // -(d log(2 pi) + log det Sigma) / 2
+            real_t log_norm;
+        public:
+            /// @brief Vectors transformed together by transform(), one block at a time
+            static constexpr size_t block = 64;
+
+            /// @brief Initializes the distribution with the given mean and covariance
+            /// @param mean mean vector, of d components
+            /// @param covariance covariance matrix, d x d in row-major order (only the lower triangle is read)
+            /// @note Throws std::invalid_argument if the sizes do not match or the covariance is not positive definite
+            MultivariateGaussian(const std::vector<real_t>& mean, const std::vector<real_t>& covariance);
+            /// @brief Number of components of the random vector
+            size_t dimensions() const;
+            /// @brief Replaces n vectors of independent standard normals in place with values of the random vector
+            /// @param z Pointer to the first of the n * dimensions() standard normals, vector after vector
+            /// @param n Number of vectors
+            /// @note Blocks of vectors are transposed, multiplied by the packed factor in register tiles of 4 rows by
+            /// two vectors of lanes, and transposed back
+            void transform(real_t* z, size_t n) const;
+            /// @brief Writes the next value of the random vector to x (dimensions() reals)
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            template <typename Derived, typename T>
+            void next(DiceForge::StaticGenerator<Derived, T>& rng, real_t* x)
+            {
+                DF_INSTRUMENT_SAMPLES("MultivariateGaussian", 1);
+                for (size_t j = 0; j < d; j++)
+                    x[j] = ziggurat::next_normal(rng);
+                transform(x, 1);
+            }
+            /// @brief Fills the buffer with n values of the random vector
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param out Pointer to the first element of the buffer, of n * dimensions() reals
+            /// @param n Number of vectors to be written
+            /// @note Standard normals by the Ziggurat method, then transform()
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, real_t* out, size_t n)
+            {
+                DF_INSTRUMENT_SAMPLES("MultivariateGaussian", n);
+                for (size_t i = 0; i < n * d; i++)
+                    out[i] = ziggurat::next_normal(rng);
+                transform(out, n);
+            }
+#if defined(DF_SPAN)
+            /// @brief Fills the span with values of the random vector (out.size() / dimensions() of them)
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<real_t> out)
+            {
+                sample(rng, out.data(), out.size() / d);
+            }
+#endif
+            /// @brief Natural logarithm of the probability density function at x (dimensions() reals)
+            /// @note Forward substitution with the factor, in O(d^2)
+            real_t logpdf(const real_t* x) const;
+            /// @brief Probability density function at x (dimensions() reals)
+            real_t pdf(const real_t* x) const;
+            /// @brief Returns the mean vector
+            const std::vector<real_t>& get_mu() const;
+            /// @brief Returns the covariance matrix, row-major
+            const std::vector<real_t>& get_sigma() const;
+            /// @brief Returns the lower triangular Cholesky factor L of the covariance (Sigma = L L^T), row-major
+            const std::vector<real_t>& get_cholesky() const;
+    };
+}
+
+#endif
@@ -1,9 +1,10 @@
 #include "Weibull.h"
-#include "basicfxn.h"
+#include "fitting.h"
+#include <algorithm>
 
 namespace DiceForge{            
     Weibull::Weibull(real_t lambda, real_t k)
-            : lambda(lambda), k(k) {
+            : k(k), lambda(lambda) {
         if (lambda < std::numeric_limits<real_t>().epsilon()){
             throw std::invalid_argument("Value of lambda(scale factor) must be positive!");
         }
@@ -17,6 +18,38 @@ namespace DiceForge{
         return lambda * std::pow(-std::log(1 - r), 1/k);
     }
 
+    void Weibull::scale_exponentials(real_t* x, size_t n) const {
+        const real_t l = lambda, inv_k = 1 / k;
+        if (k == 1) {
+            for (size_t i = 0; i < n; i++)
+                x[i] *= l;
+        }
+        else if (k == 2) {
+            for (size_t i = 0; i < n; i++)
+                x[i] = l * std::sqrt(x[i]);
+        }
+        else {
+            for (size_t i = 0; i < n; i++)
+                x[i] = l * std::pow(x[i], inv_k);
+        }
+    }
+
+    void Weibull::scale_exponentials(float* x, size_t n) const {
+        const float l = float(lambda), inv_k = float(1 / k);
+        if (k == 1) {
+            for (size_t i = 0; i < n; i++)
+                x[i] *= l;
+        }
+        else if (k == 2) {
+            for (size_t i = 0; i < n; i++)
+                x[i] = l * std::sqrt(x[i]);
+        }
+        else {
+            for (size_t i = 0; i < n; i++)
+                x[i] = l * std::pow(x[i], inv_k);
+        }
+    }
+
     real_t Weibull::variance() const{
         return pow(lambda, 2) * (std::tgamma(1 + 2/k) - pow(std::tgamma(1 + 1/k), 2));
     }
@@ -44,7 +77,52 @@ namespace DiceForge{
         if(x < 0)
             return 0;
         x = x / lambda;
-        return 1 - exp(-std::pow(x, k));
+        return -expm1(-std::pow(x, k));
+    }
+
+    real_t Weibull::logpdf(real_t x) const {
+        if(x < 0)
+            return -INFINITY;
+        x = x / lambda;
+        return std::log(k / lambda) + (k - 1) * std::log(x) - std::pow(x, k);
+    }
+
+    void Weibull::pdf(const real_t* x, real_t* out, size_t n) const {
+        const real_t s = 1 / lambda, c = k / lambda, e = k;
+        for (size_t i = 0; i < n; i++) {
+            real_t z = x[i] * s;
+            out[i] = (x[i] < 0) ? 0 : c * std::pow(z, e - 1) * exp(-std::pow(z, e));
+        }
+    }
+
+    void Weibull::logpdf(const real_t* x, real_t* out, size_t n) const {
+        const real_t s = 1 / lambda, c = std::log(k / lambda), e = k;
+        for (size_t i = 0; i < n; i++) {
+            real_t z = x[i] * s;
+            out[i] = (x[i] < 0) ? -INFINITY : c + (e - 1) * std::log(z) - std::pow(z, e);
+        }
+    }
+
+    void Weibull::cdf(const real_t* x, real_t* out, size_t n) const {
+        const real_t s = 1 / lambda, e = k;
+        for (size_t i = 0; i < n; i++) {
+            out[i] = (x[i] < 0) ? 0 : -expm1(-std::pow(x[i] * s, e));
+        }
+    }
+
+    real_t Weibull::quantile(real_t p) const
+    {
+        detail::check_probability(p);
+        return lambda * std::pow(-log1p(-p), 1 / k);
+    }
+
+    void Weibull::quantile(const real_t* p, real_t* out, size_t n) const
+    {
+        const real_t s = lambda, e = 1 / k;
+        for (size_t i = 0; i < n; i++) {
+            detail::check_probability(p[i]);
+            out[i] = s * std::pow(-log1p(-p[i]), e);
+        }
     }
 
     real_t Weibull::get_lambda() const
@@ -66,23 +144,21 @@ namespace DiceForge{
 
         const int N = x.size();        
 
-        // sort the arrays in increasing x
-        for (size_t i = 0; i < N-1; i++)
+        // sort the points in increasing x
+        std::vector<size_t> order(N);
+        for (size_t i = 0; i < N; i++)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), [&x](size_t a, size_t b) { return x[a] < x[b]; });
         {
-            for (size_t j = 0; j < N-1-i; j++)
+            std::vector<real_t> xs(N), ys(N);
+            for (size_t i = 0; i < N; i++)
             {
-                if (x[j] > x[j+1])
-                {
-                    real_t tx = x[j];
-                    x[j] = x[j+1];
-                    x[j+1] = tx;
-
-                    real_t ty = y[j];
-                    y[j] = y[j+1];
-                    y[j+1] = ty;
-                }
+                xs[i] = x[order[i]];
+                ys[i] = y[order[i]];
             }
-        } 
+            x.swap(xs);
+            y.swap(ys);
+        }
 
         real_t yr_mean = 0, xr_mean = 0;
 
@@ -90,13 +166,11 @@ namespace DiceForge{
         yreg.reserve(N); xreg.reserve(N);
         int valid_N = 0;
 
+        // running trapezoidal estimate of the cdf
+        real_t cdf = 0;
         for (size_t i = 1; i < N; i++)
         {
-            real_t cdf = 0;
-            for (size_t j = 1; j <= i; j++)
-            {
-                cdf += 0.5 * (y[j] + y[j-1]) * (x[j] - x[j-1]);   
-            }
+            cdf += 0.5 * (y[i] + y[i-1]) * (x[i] - x[i-1]);
 
             if (cdf > 1e-12 && cdf < 1)
             {
@@ -126,61 +200,166 @@ namespace DiceForge{
         real_t lambda = pow(exp(intercept / (-slope)), 0.7);
         real_t shift = 0;
 
-        // start iterative updation
-        for (size_t i = 0; i < max_iter; i++)
+        // r_i = y[i] - pdf(lambda, k, x[i]), minimise sum (r_i)^2 over (lambda, k)
+        auto model = [shift](auto x, const real_t* theta, auto* grad)
         {
-            // r_i = y[i] - pdf(k, lambda)
-            // we try to minimize sum (r_i)^2 and iteratively update k, lambda
+            typedef decltype(x) V;
+            real_t lambda = theta[0], k = theta[1];
+            if (!(lambda > 0 && k > 0))
+                return V(NAN);
+            V z = (x - shift) * (1 / lambda);
+
+            // the pdf (and its gradient) vanishes for z <= 0, where z is replaced by 1 to keep the log finite
+            auto positive = z > 0;
+            z = simd::select(positive, z, V(1));
+            V log_z = simd::log(z);
+            V zk = simd::exp(log_z * k);
+            V pdfexpr = simd::select(positive, zk / z * simd::exp(-zk) * (k/lambda), V(0));
+
+            grad[0] = pdfexpr * (zk - 1) * (k/lambda);
+            grad[1] = pdfexpr * (log_z * (1 - zk) + 1/k);
+            return pdfexpr;
+        };
+
+        real_t theta[2] = {lambda, k};
+        levenberg_marquardt<2>(model, x.data(), y.data(), N, theta, max_iter, epsilon);
+        lambda = theta[0];
+        k = theta[1];
 
-            matrix_t J = matrix_t(N, 2);    // Jacobian matrix
-            matrix_t R = matrix_t(N, 1);    // Error vector R = (r_0, r_1, ..., r_N)
+        if (lambda <= 0 || k <= 0 || std::isnan(lambda) || std::isnan(k))
+        {
+            throw std::runtime_error("Could not fit data to Weibull! Data is probably too noisy or not Weibull!");
+        }
 
-            for (size_t i = 0; i < N; i++)
-            {
-                real_t z = (x[i] - shift) / lambda;
-                real_t pdfexpr = (k/lambda) * pow(z, k-1) * exp( - pow(z, k));
+        return Weibull(lambda, k);
+    }
 
-                real_t dpdf_dlambda = pdfexpr * (pow(z, k) - 1) * (k/lambda); 
-                real_t dpdf_dk = pdfexpr * (1/k + log(z) * (1 - pow(z, k)));
+    void WeibullAccumulator::add(real_t x)
+    {
+        if (!(x > 0))
+        {
+            throw std::invalid_argument("Samples of a Weibull distribution have to be positive!");
+        }
+        real_t l = log(x);
+        n++;
+        real_t delta = l - mean;
+        mean += delta / n;
+        m2 += delta * (l - mean);
+        max = fmax(max, l);
+    }
 
-                J[i][0] = - dpdf_dlambda;
-                J[i][1] = - dpdf_dk;
+    void WeibullAccumulator::add(const real_t* x, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+            add(x[i]);
+    }
 
-                R[i][0] = y[i] - pdfexpr;
-            }
+    void WeibullAccumulator::merge(const WeibullAccumulator& other)
+    {
+        if (other.n == 0)
+            return;
+        size_t total = n + other.n;
+        real_t delta = other.mean - mean;
+        mean += delta * other.n / total;
+        m2 += other.m2 + delta * delta * n * other.n / total;
+        max = fmax(max, other.max);
+        n = total;
+    }
 
-            matrix_t JT = J.transpose();
+    size_t WeibullAccumulator::count() const
+    {
+        return n;
+    }
 
-            // move direction
-            matrix_t d = inverse2x2(JT * J) * JT * R;
+    void WeibullAccumulator::write_state(detail::StateWriter& out) const
+    {
+        out.tag("WeibullAccumulator");
+        out.put(uint64_t(n));
+        out.put(mean);
+        out.put(m2);
+        out.put(max);
+    }
 
-            // stop when error minimization is too little
-            if (fabs(d[0][0]) < epsilon && fabs(d[1][0]) < epsilon)
-                break;
+    void WeibullAccumulator::read_state(detail::StateReader& in)
+    {
+        in.tag("WeibullAccumulator");
+        WeibullAccumulator loaded;
+        loaded.n = size_t(in.get<uint64_t>());
+        loaded.mean = in.get<real_t>();
+        loaded.m2 = in.get<real_t>();
+        loaded.max = in.get<real_t>();
+        in.end();
+        *this = loaded;
+    }
 
-            // make finer refinements later on
-            // c/i^0.1 works as a reasonable good learning rate for a weibull fit
-            real_t alpha = 1/pow(i+1, 0.1); 
-            
-            real_t pred_lambda, pred_k;
-            pred_lambda = lambda - alpha * d[0][0];
-            pred_k = k - alpha * d[1][0];
-
-            // prevent possible incorrect jumping
-            if ((pred_lambda / lambda > 10 || pred_k / k > 10 || pred_lambda / lambda < 0.1 || pred_k / k < 0.1)) {
-                alpha = alpha * 0.01;
+    real_t WeibullAccumulator::log_mean() const
+    {
+        return mean;
+    }
+
+    real_t WeibullAccumulator::log_max() const
+    {
+        return max;
+    }
+
+    Weibull WeibullAccumulator::fit() const
+    {
+        if (n < 2 || !(m2 > 0))
+        {
+            throw std::runtime_error("Could not fit samples to Weibull! At least two distinct samples are needed!");
+        }
+        const real_t euler_gamma = 0.57721566490153286061;
+        real_t k = M_PI / (sqrt(6 * m2 / n));
+        return Weibull(exp(mean + euler_gamma / k), k);
+    }
+
+    Weibull fitWeibullFromSamples(const std::vector<real_t>& samples, int max_iter, real_t epsilon)
+    {
+        WeibullAccumulator acc;
+        acc.add(samples.data(), samples.size());
+        real_t k = acc.fit().get_k();
+
+        // With u = log(x) - max log(x) and w = e^(k u), the likelihood is maximised over lambda by
+        // lambda^k = mean of x^k, leaving g(k) = sum(w u) / sum(w) + max log(x) - mean log(x) - 1/k = 0,
+        // whose derivative sum(w u^2) / sum(w) - (sum(w u) / sum(w))^2 + 1/k^2 is positive
+        const size_t N = samples.size();
+        const real_t shift = acc.log_max(), offset = shift - acc.log_mean();
+        real_t S0 = 0;
+        auto pass = [&](real_t k, real_t& S1, real_t& S2)
+        {
+            S0 = S1 = S2 = 0;
+            for (size_t i = 0; i < N; i++)
+            {
+                real_t u = log(samples[i]) - shift, w = exp(k * u);
+                S0 += w;
+                S1 += w * u;
+                S2 += w * u * u;
             }
+        };
 
-            // Gauss-Newton method
-            lambda = lambda - alpha * d[0][0];
-            k = k - alpha * d[1][0];
+        real_t S1, S2;
+        for (int i = 0; i < max_iter; i++)
+        {
+            pass(k, S1, S2);
+            real_t r1 = S1 / S0;
+            real_t g = r1 + offset - 1 / k;
+            real_t dg = S2 / S0 - r1 * r1 + 1 / (k * k);
+            real_t next = k - g / dg;
+            if (!(next > 0))
+                next = 0.5 * k;
+            bool converged = fabs(next - k) <= epsilon * k;
+            k = next;
+            if (converged)
+                break;
         }
+        pass(k, S1, S2);
+        real_t lambda = exp(shift + log(S0 / N) / k);
 
-        if (lambda <= 0 || k <= 0 || std::isnan(lambda) || std::isnan(k))
+        if (!(lambda > 0) || !(k > 0) || std::isinf(lambda) || std::isinf(k))
         {
-            throw std::runtime_error("Could not fit data to Weibull! Data is probably too noisy or not Weibull!");
+            throw std::runtime_error("Could not fit samples to Weibull! Samples are probably not Weibull!");
         }
 
         return Weibull(lambda, k);
     }
-}
\ No newline at end of file
+}
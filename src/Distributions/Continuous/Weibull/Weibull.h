@@ -2,6 +2,8 @@
 #define DF_WEIBULL_H
 
 #include "distribution.h"
+#include "generator.h"
+#include "ziggurat.h"
 
 namespace DiceForge {
 
@@ -9,6 +11,9 @@ namespace DiceForge {
     class Weibull : public Continuous {
         private:
             real_t k, lambda;
+            // Turns standard exponential variates in place into values of the random variable
+            void scale_exponentials(real_t* x, size_t n) const;
+            void scale_exponentials(float* x, size_t n) const;
         public:
             /// @brief Initializes the Weibull distribution with scale gamma
             /// @param lambda scale factor of the distribution
@@ -19,6 +24,42 @@ namespace DiceForge {
             /// @brief Returns the next value of the random variable described by the distribution
             /// @param r A random real number uniformly distributed between 0 and 1
             real_t next(real_t r);
+            /// @brief Fills the buffer with values of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param out Pointer to the first element of the buffer
+            /// @param n Number of values to be written
+            /// @note Raises Ziggurat exponential variates to the power 1 / k (no logarithm, and no power at all for k = 1 or 2)
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, real_t* out, size_t n)
+            {
+                DF_INSTRUMENT_SAMPLES("Weibull", n);
+                for (size_t j = 0; j < n; j++)
+                    out[j] = ziggurat::next_exponential(rng);
+                scale_exponentials(out, n);
+            }
+            /// @brief Fills the buffer with single precision values of the random variable
+            /// @note Exponentials from ziggurat::fill_exponential, scaled in single precision
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, float* out, size_t n)
+            {
+                DF_INSTRUMENT_SAMPLES("Weibull", n);
+                ziggurat::fill_exponential(rng, out, n);
+                scale_exponentials(out, n);
+            }
+#if defined(DF_SPAN)
+            /// @brief Fills the span with values of the random variable described by the distribution
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<real_t> out)
+            {
+                sample(rng, out.data(), out.size());
+            }
+            /// @brief Fills the span with single precision values of the random variable
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, std::span<float> out)
+            {
+                sample(rng, out.data(), out.size());
+            }
+#endif
         
             /// @brief Returns the theoretical variance of the distribution
             /// @note The variation of a Weibull distribution is undefined
@@ -43,6 +84,19 @@ namespace DiceForge {
         
             /// @brief Cumulative distribution function of the Weibull distribution
             real_t cdf(real_t x) const override final;
+            /// @brief Natural logarithm of the probability density function of the Weibull distribution
+            real_t logpdf(real_t x) const override final;
+            /// @brief Probability density function of the Weibull distribution at the n locations x, written to out
+            void pdf(const real_t* x, real_t* out, size_t n) const override final;
+            /// @brief Logarithm of the probability density function at the n locations x, written to out
+            void logpdf(const real_t* x, real_t* out, size_t n) const override final;
+            /// @brief Cumulative distribution function at the n locations x, written to out
+            void cdf(const real_t* x, real_t* out, size_t n) const override final;
+            /// @brief Quantile function (inverse cdf) of the Weibull distribution
+            /// @note lambda (-log(1 - p))^(1/k)
+            real_t quantile(real_t p) const override final;
+            /// @brief Quantile function at the n probabilities p, written to out (out may be p)
+            void quantile(const real_t* p, real_t* out, size_t n) const override final;
 
             /// @brief Returns scale factor of the distribution
             real_t get_lambda() const;
@@ -59,6 +113,45 @@ namespace DiceForge {
     /// @param epsilon minimum acceptable error tolerance while attempting to fit the data (smaller to try for better fits)
     /// @return A Weibull distribution fit to the given sample points
     Weibull fitToWeibull(std::vector<real_t> x, std::vector<real_t> y, int max_iter, real_t epsilon);
+
+    /// @brief Streaming moments of the logarithm of a sample (count, mean, sum of squared deviations and maximum).
+    /// log(x) follows a Gumbel distribution, so these give a closed form estimate of the Weibull parameters, which
+    /// fitWeibullFromSamples refines to the maximum likelihood one. Accumulators over parts of a sample can be merged.
+    /// @note The statistics can be saved with save_state, to carry on with a sample from a checkpoint
+    class WeibullAccumulator : public Serializable<WeibullAccumulator> {
+        friend class Serializable<WeibullAccumulator>;
+        private:
+            size_t n = 0;
+            real_t mean = 0, m2 = 0, max = -INFINITY;
+            // The statistics, for save_state and load_state (see DiceForge::Serializable)
+            void write_state(detail::StateWriter& out) const;
+            void read_state(detail::StateReader& in);
+        public:
+            /// @brief Adds one (positive) sample
+            void add(real_t x);
+            /// @brief Adds the n (positive) samples x
+            void add(const real_t* x, size_t n);
+            /// @brief Adds all the samples seen by other
+            void merge(const WeibullAccumulator& other);
+            /// @brief Number of samples added
+            size_t count() const;
+            /// @brief Mean of log(x) over the samples added
+            real_t log_mean() const;
+            /// @brief Largest log(x) over the samples added
+            real_t log_max() const;
+            /// @brief Moment estimate from the log-samples: k = pi / (sqrt(6) s) and lambda = exp(m + gamma / k), where m and s
+            /// are their mean and standard deviation and gamma is the Euler-Mascheroni constant
+            Weibull fit() const;
+    };
+
+    /// @brief Fits a Weibull distribution to raw (positive) samples by maximum likelihood, with no binning. Newton's
+    /// method on the likelihood profiled over lambda is started from the moment estimate of WeibullAccumulator,
+    /// each iteration being one pass over the samples.
+    /// @param samples list of samples
+    /// @param max_iter maximum Newton iterations
+    /// @param epsilon relative change in k below which the fit has converged
+    /// @return The maximum likelihood Weibull distribution of the samples
+    Weibull fitWeibullFromSamples(const std::vector<real_t>& samples, int max_iter = 100, real_t epsilon = 1e-12);
 }
 
 
@@ -1,5 +1,6 @@
 #include "Bernoulli.h" // Include the abstract classes
 #include <iostream>
+#include <cmath>
 
 namespace DiceForge{
 
@@ -10,6 +11,12 @@ namespace DiceForge{
         if (p < 0 || p > 1) {
             throw std::invalid_argument("Error: Invalid probability value for Bernoulli distribution!");
         }
+        // p < 1 has at most 53 significant bits, so p * 2^64 is exact
+        cut = (p < 1) ? uint64_t(std::ldexp(p, 64)) : ~uint64_t(0);
+        low = 0;
+        while (low < 63 && cut != 0 && ((cut >> low) & 1) == 0) {
+            low++;
+        }
     }
     
     int_t Bernoulli::next(real_t r) 
@@ -51,4 +58,9 @@ namespace DiceForge{
         // Cumulative distribution function of Bernoulli distribution
         return x == 0 ? 1 - p : 1.0;
     }    
+
+    int_t Bernoulli::quantile(real_t u) const {
+        detail::check_probability(u);
+        return (u <= 1 - p) ? 0 : 1;
+    }
 };
\ No newline at end of file
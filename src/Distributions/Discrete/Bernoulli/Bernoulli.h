@@ -2,19 +2,111 @@
 #define DF_BERNOULLI_H
 
 #include "distribution.h"
+#include "generator.h"
 
 namespace DiceForge {
     /// @brief DiceForge::Bernoulli - A Discrete Probability Distribution (Bernoulli) 
     class Bernoulli : public Discrete {
         private:
-            float p;
+            real_t p;
+            // p as a 64-bit fixed-point fraction, and the lowest set bit of it
+            uint64_t cut;
+            int low;
         public:
             /// @brief Constructor for the Bernoulli Distribution
-            /// @param p 
+            /// @param p probability of 1
             Bernoulli(real_t p);
             /// @brief Returns the next value of the random variable described by the distribution
             /// @param r A random real number uniformly distributed between 0 and 1
             int_t next(real_t r);
+            /// @brief Returns the next value of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @note Compares 64 random bits with p in fixed point, without going through a real number
+            template <typename Derived, typename T>
+            int_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+            {
+                DF_INSTRUMENT_SAMPLES("Bernoulli", 1);
+                return (p >= 1 || detail::bits64(rng) < cut) ? 1 : 0;
+            }
+            /// @brief Fills the buffer with trials packed 64 to a word, bit j of out[i] being trial 64 i + j
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param out Pointer to the first word of the buffer
+            /// @param words Number of words to be written
+            /// @note All 64 lanes compare their random bits with the bits of p together, from the most significant
+            /// one, and a lane is settled at the first bit that differs from p. That takes about 7 words of the RNG
+            /// for 64 trials (a single one for p = 1/2), and ends early when the remaining bits of p are zero.
+            template <typename Derived, typename T>
+            void sample_bits(DiceForge::StaticGenerator<Derived, T>& rng, uint64_t* out, size_t words)
+            {
+                DF_INSTRUMENT_SAMPLES("Bernoulli", 64 * words);
+                for (size_t w = 0; w < words; w++)
+                {
+                    if (p >= 1 || cut == 0)
+                    {
+                        out[w] = (p >= 1) ? ~uint64_t(0) : 0;
+                        continue;
+                    }
+                    uint64_t undecided = ~uint64_t(0), ones = 0;
+                    for (int i = 63; i >= low && undecided != 0; i--)
+                    {
+                        uint64_t u = detail::bits64(rng);
+                        if ((cut >> i) & 1)
+                        {
+                            // A 0 where p has a 1: that trial's number is below p
+                            ones |= undecided & ~u;
+                            undecided &= u;
+                        }
+                        else
+                            undecided &= ~u;
+                    }
+                    out[w] = ones;
+                }
+            }
+            /// @brief Fills the buffer with values of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param out Pointer to the first element of the buffer
+            /// @param count Number of values to be written
+            /// @note Unpacks the words of sample_bits
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, int_t* out, size_t count)
+            {
+                DF_INSTRUMENT_SAMPLES("Bernoulli", count);
+                uint64_t bits;
+                for (size_t i = 0; i < count; i += 64)
+                {
+                    sample_bits(rng, &bits, 1);
+                    for (size_t j = 0; j < 64 && i + j < count; j++)
+                        out[i + j] = int_t((bits >> j) & 1);
+                }
+            }
+            /// @brief Fills the buffer with one trial of each of n Bernoulli distributions, without constructing them
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param p Pointer to the n probabilities of 1 (in [0, 1])
+            /// @param out Pointer to the first element of the buffer
+            /// @param count Number of values to be written
+            /// @note A comparison of a block of uniforms from fill_unit with the probabilities, without branches
+            template <typename Derived, typename T>
+            static void sample_each(DiceForge::StaticGenerator<Derived, T>& rng, const real_t* p, int_t* out,
+                                    size_t count)
+            {
+                DF_INSTRUMENT_SAMPLES("Bernoulli", count);
+                bool valid = true;
+                for (size_t i = 0; i < count; i++)
+                    valid &= (p[i] >= 0) & (p[i] <= 1);
+                if (!valid)
+                    throw std::invalid_argument("Error: Invalid probability value for Bernoulli distribution!");
+                real_t u[256];
+                while (count > 0)
+                {
+                    size_t m = std::min(count, size_t(256));
+                    rng.fill_unit(u, m);
+                    for (size_t i = 0; i < m; i++)
+                        out[i] = int_t(u[i] < p[i]);
+                    p += m;
+                    out += m;
+                    count -= m;
+                }
+            }
             /// @brief Returns the theoretical variance of the distribution
             /// @returns p(1-p)
             real_t variance() const override final;
@@ -31,6 +123,11 @@ namespace DiceForge {
             real_t pmf(int_t k) const override final;            
             /// @brief Cumulative distribution function of the Bernoulli distribution
             real_t cdf(int_t k) const override final;
+            /// @brief Quantile function of the Bernoulli distribution, 0 for u <= 1 - p and 1 above
+            int_t quantile(real_t u) const override final;
+            using Discrete::pmf;
+            using Discrete::cdf;
+            using Discrete::quantile;
     };
 }
 
@@ -1,29 +1,153 @@
 #include "Binomial.h"
 #include "basicfxn.h"
+#include "special.h"
+#include <algorithm>
 
 namespace DiceForge {
+namespace {
+    // Stirling series correction, as in the BTPE acceptance test
+    inline real_t stirling(real_t a, real_t a2) {
+        return (13860. - (462. - (132. - (99. - 140. / a2) / a2) / a2) / a2) / a / 166320.;
+    }
+}
+
 Binomial::Binomial(uint_t n, real_t p)
     : n(n), p(p) {
-    if (n < 0 || p < 0 || p > 1) {
+    if (!(p >= 0 && p <= 1)) {
         throw std::invalid_argument("Expected n > 0 and 0 <= p <= 1");
     }
 
-    pmfs = std::vector<real_t>(n+1);
+    flipped = p > 0.5;
+    s = flipped ? 1 - p : p;
+    lns = std::log(s);
+    lnq = std::log1p(-s);
 
-    for (int i = 0; i <= n; i++) {
-        pmfs[i] = nCr(n, i) * std::pow(p, i) * std::pow((1-p), i);
+    const real_t q = 1 - s, mean = n * s;
+    if (mean < inversion_limit) {
+        // Running sums of p(k + 1) = p(k) (n - k) / (k + 1) s / q, until the terms stop changing them
+        real_t pk = std::exp(n * lnq), sum = pk;
+        table.push_back(sum);
+        for (uint_t k = 0; k < n && (k <= mean || pk > sum * 1e-17); k++) {
+            pk *= real_t(n - k) / (k + 1) * s / q;
+            sum += pk;
+            table.push_back(sum);
+        }
+        guide.resize(table.size());
+        size_t k = 0;
+        for (size_t j = 0; j < guide.size(); j++) {
+            while (k + 1 < table.size() && table[k] <= real_t(j) / guide.size()) k++;
+            guide[j] = k;
+        }
+    }
+    else {
+        real_t fm = mean + s;
+        m = int_t(std::floor(fm));
+        p1 = std::floor(2.195 * std::sqrt(mean * q) - 4.6 * q) + 0.5;
+        xm = m + 0.5;
+        xl = xm - p1;
+        xr = xm + p1;
+        c = 0.134 + 20.5 / (15.3 + m);
+        real_t a = (fm - xl) / (fm - xl * s);
+        laml = a * (1 + a / 2);
+        a = (xr - fm) / (xr * q);
+        lamr = a * (1 + a / 2);
+        p2 = p1 * (1 + 2 * c);
+        p3 = p2 + c / laml;
+        p4 = p3 + c / lamr;
     }
 }
 
-int_t Binomial::next(real_t r) {
-    real_t s = 0;
-    for (int i = 0; i <= n; i++) {
-        if (s < r <= s + pmfs[i]) 
-            return i;
-        s += pmfs[i];
+int_t Binomial::btpe(real_t u, real_t v) const {
+    if (v <= 0)
+        return -1;
+    const real_t q = 1 - s, nrq = n * s * q;
+    u *= p4;
+    int_t y;
+
+    // Triangular centre, accepted outright
+    if (u <= p1)
+        return int_t(std::floor(xm - p1 * v + u));
+
+    if (u <= p2) {
+        // Parallelograms
+        real_t x = xl + (u - p1) / c;
+        v = v * c + 1 - std::fabs(m - x + 0.5) / p1;
+        if (v > 1)
+            return -1;
+        y = int_t(std::floor(x));
+    }
+    else if (u <= p3) {
+        // Left exponential tail
+        real_t x = std::floor(xl + std::log(v) / laml);
+        if (x < 0)
+            return -1;
+        y = int_t(x);
+        v *= (u - p2) * laml;
+    }
+    else {
+        // Right exponential tail
+        real_t x = std::floor(xr - std::log(v) / lamr);
+        if (x > n)
+            return -1;
+        y = int_t(x);
+        v *= (u - p3) * lamr;
     }
 
-    return n;
+    int_t k = std::abs(y - m);
+    if (k <= 20 || k >= nrq / 2 - 1) {
+        // Explicit ratio p(y) / p(m) by the recurrence
+        real_t r = s / q, a = r * (n + 1), f = 1;
+        if (m < y)
+            for (int_t i = m + 1; i <= y; i++) f *= a / i - r;
+        else if (m > y)
+            for (int_t i = y + 1; i <= m; i++) f /= a / i - r;
+        return (v <= f) ? y : -1;
+    }
+
+    // Squeeze on log(v), then the bound with Stirling's formula
+    real_t rho = (k / nrq) * ((k * (k / 3. + 0.625) + 0.16666666666666666) / nrq + 0.5);
+    real_t t = -real_t(k) * k / (2 * nrq);
+    real_t A = std::log(v);
+    if (A < t - rho)
+        return y;
+    if (A > t + rho)
+        return -1;
+
+    real_t x1 = y + 1, f1 = m + 1, z = n + 1 - m, w = n - y + 1;
+    real_t bound = xm * std::log(f1 / x1) + (n - m + 0.5) * std::log(z / w) + (y - m) * std::log(w * s / (x1 * q))
+                   + stirling(f1, f1 * f1) + stirling(z, z * z) + stirling(x1, x1 * x1) + stirling(w, w * w);
+    return (A <= bound) ? y : -1;
+}
+
+int_t Binomial::next(real_t r) {
+    // Inverting Y at 1 - r keeps X = n - Y nondecreasing in r
+    if (flipped)
+        r = 1 - r;
+    int_t y;
+    if (!table.empty())
+        y = from_table(std::min(r, real_t(1) - std::numeric_limits<real_t>::epsilon() / 2));
+    else {
+        // Walk from the mode, with the cdf there from the incomplete beta function
+        const real_t ratio = s / (1 - s);
+        y = m;
+        real_t pk = std::exp(log_nCr(n, m) + m * lns + (n - m) * lnq);
+        real_t F = cdf_y(m);
+        if (r < F) {
+            while (y > 0 && r < F - pk) {
+                F -= pk;
+                pk *= y / (real_t(n - y + 1) * ratio);
+                y--;
+            }
+        }
+        else {
+            while (y < int_t(n) && r >= F) {
+                y++;
+                pk *= real_t(n - y + 1) / y * ratio;
+                F += pk;
+            }
+        }
+    }
+    return flipped ? int_t(n) - y : y;
 }
 
 real_t Binomial::variance() const {
@@ -42,21 +166,42 @@ int_t Binomial::maxValue() const {
     return n;
 }
 
-real_t Binomial::pmf(int_t k) const {
-    if (k > n || k < 0)
+real_t Binomial::logpmf(int_t k) const {
+    if (k > int_t(n) || k < 0)
     {
-        return 0;
+        return -std::numeric_limits<real_t>::infinity();
     }
-    return pmfs[k];
+    // p^k and (1-p)^(n-k) separately, so that p = 0 and p = 1 give 0^0 = 1
+    real_t l = log_nCr(n, k);
+    if (k > 0) l += k * std::log(p);
+    if (k < int_t(n)) l += (n - k) * std::log1p(-p);
+    return l;
+}
+
+real_t Binomial::pmf(int_t k) const {
+    return std::exp(logpmf(k));
+}
+
+real_t Binomial::cdf_y(int_t k) const {
+    if (k < 0)
+        return 0;
+    if (k >= int_t(n))
+        return 1;
+    if (!table.empty())
+        return (size_t(k) < table.size()) ? table[k] : table.back();
+    return special::beta_inc(n - k, k + 1.0, 1 - s);
 }
 
 real_t Binomial::cdf(int_t k) const {
-    real_t cdf = 0;
-    for (uint_t i = 0; i <= k; i++)
-    {
-        cdf += pmf(i);
-    }
-    
-    return cdf;
+    if (k < 0)
+        return 0;
+    if (k >= int_t(n))
+        return 1;
+    if (!flipped)
+        return cdf_y(k);
+    // X <= k exactly when Y >= n - k
+    if (table.empty())
+        return special::beta_inc(n - k, k + 1.0, 1 - p);
+    return 1 - cdf_y(int_t(n) - k - 1);
 }
 } // namespace DiceForge
@@ -2,6 +2,7 @@
 #define DF_BINOMIAL_H
 
 #include "distribution.h"
+#include "generator.h"
 #include <vector>
 
 namespace DiceForge {
@@ -10,16 +11,71 @@ namespace DiceForge {
         private:
             uint_t n;
             real_t p;
-            std::vector<real_t> pmfs;
+            // Values are drawn as Y ~ Binomial(n, s) with s = min(p, 1 - p), and X = n - Y when p > 1/2
+            real_t s, lns, lnq;
+            bool flipped;
+            // Below this n * s values are drawn by inversion, above it by BTPE
+            static constexpr real_t inversion_limit = 30;
+            // Inversion: cdf[k] = P(Y <= k) up to where the remaining terms no longer change the sum,
+            // and guide[j] = smallest k with cdf[k] > j / guide.size()
+            std::vector<real_t> table;
+            std::vector<int_t> guide;
+            // BTPE constants (Kachitvichyanukul and Schmeiser, "Binomial random variate generation")
+            int_t m;
+            real_t xm, xl, xr, c, laml, lamr, p1, p2, p3, p4;
+
+            int_t from_table(real_t u) const
+            {
+                int_t k = guide[size_t(u * guide.size())];
+                while (k + 1 < int_t(table.size()) && u >= table[k]) k++;
+                return k;
+            }
+            // One BTPE attempt with the uniforms u and v, Y if accepted and -1 otherwise
+            int_t btpe(real_t u, real_t v) const;
+            // P(Y <= k)
+            real_t cdf_y(int_t k) const;
         public:
             /// @brief Initializes the Binomial Distribution with (n, p)
             /// @param n number of trials 
             /// @param p probability of "success" in each trial
             /// @note 0 <= p <= 1
+            /// @note n * min(p, 1 - p) below 30 gets an inversion table with a guide table, sized by the
+            /// probabilities rather than n; above that values are drawn by BTPE in O(1) expected time
             Binomial(uint_t n, real_t p);
             /// @brief Returns the next value of the random variable described by the distribution
             /// @param r A random real number uniformly distributed between 0 and 1
+            /// @note Inversion, walking from the mode when there is no table
             int_t next(real_t r);
+            /// @brief Returns the next value of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            template <typename Derived, typename T>
+            int_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+            {
+                DF_INSTRUMENT_SAMPLES("Binomial", 1);
+                int_t y;
+                if (!table.empty())
+                    y = from_table(rng.next_unit());
+                else {
+                    do {
+                        real_t u = rng.next_unit();
+                        y = btpe(u, rng.next_unit());
+                        if (y < 0)
+                            DF_INSTRUMENT_REJECT("Binomial");
+                    } while (y < 0);
+                }
+                return flipped ? int_t(n) - y : y;
+            }
+            /// @brief Fills the buffer with values of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param out Pointer to the first element of the buffer
+            /// @param count Number of values to be written
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, int_t* out, size_t count)
+            {
+                DF_INSTRUMENT_SAMPLES("Binomial", count);
+                for (size_t i = 0; i < count; i++)
+                    out[i] = next(rng);
+            }
             /// @brief Returns the theoretical variance of the distribution
             real_t variance() const override final;
             /// @brief Returns the theoretical expectation value of the distribution
@@ -32,7 +88,13 @@ namespace DiceForge {
             /// @note Here it is the probability of encountering exactly k "success" trials
             real_t pmf(int_t k) const override final;
             /// @brief Cumulative distribution function of the Binomial distribution
+            /// @note A table lookup, or the regularized incomplete beta function I_(1-p)(n - k, k + 1)
             real_t cdf(int_t k) const override final;
+            /// @brief Natural logarithm of the probability mass function of the Binomial distribution
+            real_t logpmf(int_t k) const override final;
+            using Discrete::pmf;
+            using Discrete::logpmf;
+            using Discrete::cdf;
     };
 }
 
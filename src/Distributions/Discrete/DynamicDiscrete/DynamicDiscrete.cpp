@@ -0,0 +1,242 @@
+#include "DynamicDiscrete.h"
+
+namespace DiceForge
+{
+    DynamicDiscrete::DynamicDiscrete(size_t n)
+    : n(n)
+    {
+        levels.assign(1, std::vector<real_t>(n, 0));
+        build();
+    }
+
+    void DynamicDiscrete::check_weight(real_t w){
+        if (!(w >= 0) || !std::isfinite(w)) {
+            throw std::invalid_argument("Weights must be finite and not negative!");
+        }
+    }
+
+    void DynamicDiscrete::build(){
+        // Each level padded to a multiple of fanout (at least one group), down to a single group under the total
+        std::vector<real_t> weights = std::move(levels[0]);
+        weights.resize(std::max(fanout, (n + fanout - 1) / fanout * fanout), 0);
+        levels.assign(1, std::move(weights));
+        while (levels.back().size() > fanout) {
+            const size_t groups = levels.back().size() / fanout;
+            levels.emplace_back(std::max(fanout, (groups + fanout - 1) / fanout * fanout), 0);
+        }
+        levels.emplace_back(1, 0);
+        for (size_t l = 0; l + 1 < levels.size(); l++) {
+            const std::vector<real_t>& below = levels[l];
+            std::vector<real_t>& above = levels[l + 1];
+            for (size_t j = 0; j < below.size() / fanout; j++) {
+                real_t s = 0;
+                for (size_t c = 0; c < fanout; c++)
+                    s += below[fanout * j + c];
+                above[j] = s;
+            }
+        }
+    }
+
+    void DynamicDiscrete::repair(size_t i){
+        for (size_t l = 0; l + 1 < levels.size(); l++) {
+            i /= fanout;
+            const real_t* s = levels[l].data() + fanout * i;
+            real_t sum = 0;
+            for (size_t c = 0; c < fanout; c++)
+                sum += s[c];
+            levels[l + 1][i] = sum;
+        }
+    }
+
+    void DynamicDiscrete::repair(const size_t* index, size_t m){
+        if (m > n / fanout) {
+            build();
+            return;
+        }
+        // The parents of the changed nodes, level by level, each recomputed once
+        std::vector<size_t> dirty(index, index + m);
+        for (size_t l = 0; l + 1 < levels.size(); l++) {
+            for (size_t& j : dirty)
+                j /= fanout;
+            std::sort(dirty.begin(), dirty.end());
+            dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+            for (size_t j : dirty) {
+                const real_t* s = levels[l].data() + fanout * j;
+                real_t sum = 0;
+                for (size_t c = 0; c < fanout; c++)
+                    sum += s[c];
+                levels[l + 1][j] = sum;
+            }
+        }
+    }
+
+    size_t DynamicDiscrete::previous_positive(size_t i) const{
+        // Up to the first level where a sibling before the path holds a positive sum, then down its last positive
+        // children: a sum is positive exactly when a weight under it is
+        for (size_t l = 0; l + 1 < levels.size(); l++) {
+            for (size_t k = i; k-- > i - i % fanout;) {
+                if (levels[l][k] > 0) {
+                    for (; l > 0; l--) {
+                        size_t c = fanout;
+                        while (!(levels[l - 1][fanout * k + --c] > 0));
+                        k = fanout * k + c;
+                    }
+                    return k;
+                }
+            }
+            i /= fanout;
+        }
+        return n;
+    }
+
+    size_t DynamicDiscrete::next_positive(size_t i) const{
+        for (size_t l = 0; l + 1 < levels.size(); l++) {
+            for (size_t k = i + 1; k < i - i % fanout + fanout; k++) {
+                if (levels[l][k] > 0) {
+                    for (; l > 0; l--) {
+                        size_t c = 0;
+                        while (!(levels[l - 1][fanout * k + c] > 0))
+                            c++;
+                        k = fanout * k + c;
+                    }
+                    return k;
+                }
+            }
+            i /= fanout;
+        }
+        return n;
+    }
+
+    real_t DynamicDiscrete::prefix(size_t i) const{
+        // The siblings before the node on the path of index i, at every level
+        real_t s = 0;
+        for (size_t l = 0; l + 1 < levels.size(); l++) {
+            for (size_t k = i - i % fanout; k < i; k++)
+                s += levels[l][k];
+            i /= fanout;
+        }
+        return s;
+    }
+
+    void DynamicDiscrete::update(size_t i, real_t w){
+        if (i >= n) {
+            throw std::out_of_range("Index out of range!");
+        }
+        check_weight(w);
+        const real_t old = levels[0][i];
+        levels[0][i] = w;
+        repair(i);
+        if (!std::isfinite(total())) {
+            levels[0][i] = old;
+            repair(i);
+            throw std::invalid_argument("The sum of the weights must be finite!");
+        }
+    }
+
+    void DynamicDiscrete::update(const size_t* index, const real_t* weight, size_t m){
+        for (size_t k = 0; k < m; k++) {
+            if (index[k] >= n) {
+                throw std::out_of_range("Index out of range!");
+            }
+            check_weight(weight[k]);
+        }
+        std::vector<real_t> old(m);
+        for (size_t k = 0; k < m; k++) {
+            old[k] = levels[0][index[k]];
+            levels[0][index[k]] = weight[k];
+        }
+        repair(index, m);
+        if (!std::isfinite(total())) {
+            // Backwards, so that an index given twice gets its first weight back
+            for (size_t k = m; k-- > 0;)
+                levels[0][index[k]] = old[k];
+            repair(index, m);
+            throw std::invalid_argument("The sum of the weights must be finite!");
+        }
+    }
+
+    void DynamicDiscrete::resize(size_t size){
+        levels[0].resize(size);
+        // The padding of a smaller size must be 0 again
+        std::fill(levels[0].begin() + std::min(size, n), levels[0].end(), 0);
+        n = size;
+        build();
+    }
+
+    size_t DynamicDiscrete::size() const{
+        return n;
+    }
+
+    real_t DynamicDiscrete::weight(size_t i) const{
+        if (i >= n) {
+            throw std::out_of_range("Index out of range!");
+        }
+        return levels[0][i];
+    }
+
+    real_t DynamicDiscrete::total() const{
+        return levels.back()[0];
+    }
+
+    int_t DynamicDiscrete::next(real_t r) const{
+        const real_t sum = total();
+        if (!(sum > 0)) {
+            throw std::invalid_argument("All the weights are zero!");
+        }
+        return int_t(find<false>(r * sum));
+    }
+
+    real_t DynamicDiscrete::variance() const{
+        const real_t mean = expectation();
+        real_t s = 0;
+        for (size_t i = 0; i < n; i++)
+            s += levels[0][i] * (real_t(i) - mean) * (real_t(i) - mean);
+        return s / total();
+    }
+
+    real_t DynamicDiscrete::expectation() const{
+        real_t s = 0;
+        for (size_t i = 0; i < n; i++)
+            s += levels[0][i] * real_t(i);
+        return s / total();
+    }
+
+    int_t DynamicDiscrete::minValue() const{
+        return 0;
+    }
+
+    int_t DynamicDiscrete::maxValue() const{
+        return int_t(n) - 1;
+    }
+
+    real_t DynamicDiscrete::pmf(int_t x) const{
+        if (x < 0 || x >= int_t(n))
+            return 0;
+        return levels[0][x] / total();
+    }
+
+    real_t DynamicDiscrete::cdf(int_t x) const{
+        if (x < 0)
+            return 0;
+        if (x >= int_t(n) - 1)
+            return 1;
+        return std::min(prefix(size_t(x) + 1) / total(), real_t(1));
+    }
+
+    int_t DynamicDiscrete::quantile(real_t p) const{
+        detail::check_probability(p);
+        if (p == 0)
+            return 0;
+        // The descent subtracts where cdf adds up, so the two may round apart by an ulp: a step to the positive
+        // weight either side settles it (the cdf of a weight of 0 is that of the one before, up to rounding),
+        // found through the sums so that runs of zero weights are skipped in O(log n)
+        size_t k = find<true>(p * total());
+        for (size_t j = previous_positive(k); j < n && !(cdf(int_t(j)) < p); j = previous_positive(j))
+            k = j;
+        while (k + 1 < n && cdf(int_t(k)) < p){
+            const size_t j = next_positive(k);
+            k = (j < n) ? j : n - 1;
+        }
+        return int_t(k);
+    }
+}
@@ -0,0 +1,177 @@
+#ifndef DF_DYNAMIC_DISCRETE_H
+#define DF_DYNAMIC_DISCRETE_H
+
+#include "distribution.h"
+#include "generator.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace DiceForge {
+
+    /// @brief DiceForge::DynamicDiscrete - The distribution of an index i in [0, n) drawn with probability
+    /// proportional to its weight w[i], with weights that can change between draws (derived from Discrete)
+    /// @note The weights are the leaves of a tree of sums with 8 children per node, so that a draw descends from the
+    /// total to a leaf reading one cache line per level (7 levels for a million weights), and changing a weight
+    /// recomputes the sums on its path: O(log n) for both. The sums are recomputed from the children rather than
+    /// adjusted by differences, so they do not drift however many updates are made.
+    class DynamicDiscrete : public Discrete {
+    private:
+        static constexpr size_t fanout = 8;
+        // levels[0] holds the weights, padded with zeros to a multiple of fanout, and levels[l + 1][j] the sum of
+        // levels[l][fanout j] to levels[l][fanout j + fanout - 1], up to the last level whose only entry is the total
+        std::vector<std::vector<real_t>> levels;
+        size_t n = 0;
+
+        // Throws unless the weight is finite and not negative
+        static void check_weight(real_t w);
+        // Lays out the levels for n weights, keeping the existing ones, and computes all the sums
+        void build();
+        // Recomputes the sums on the path of weight i
+        void repair(size_t i);
+        // Recomputes the sums on the paths of the m weights index[k], or the whole tree when there are many
+        void repair(const size_t* index, size_t m);
+        // Sum of the weights before index i
+        real_t prefix(size_t i) const;
+        // Nearest index before (after) i with a positive weight, n if there is none, in O(log n) through the sums
+        size_t previous_positive(size_t i) const;
+        size_t next_positive(size_t i) const;
+
+        // Index of the weight where target u in [0, total) falls, or (inclusive) the first where the running sum
+        // reaches u; a weight of 0 is never chosen
+        template <bool inclusive>
+        size_t find(real_t u) const
+        {
+            size_t j = 0;
+            for (size_t l = levels.size() - 1; l-- > 0;){
+                const real_t* s = levels[l].data() + fanout * j;
+                size_t c = 0, last = 0;
+                for (; c < fanout; c++){
+                    if (s[c] > 0){
+                        if (inclusive ? u <= s[c] : u < s[c])
+                            break;
+                        last = c;
+                        u -= s[c];
+                    }
+                }
+                if (c == fanout){
+                    // Rounding took u past the sum of the children: the first positive weight under the last
+                    c = last;
+                    u = 0;
+                }
+                j = fanout * j + c;
+            }
+            return j;
+        }
+    public:
+        /// @brief Initialises n weights of 0 (to be set with update before sampling)
+        explicit DynamicDiscrete(size_t n = 0);
+
+        /// @brief Initialises the weights of the indices 0, 1, ... from a sequence
+        /// @note The weights must be finite and not negative, as must be their total (std::invalid_argument
+        /// otherwise)
+        template <typename InputIterator>
+        DynamicDiscrete(InputIterator first, InputIterator last){
+            std::vector<real_t> w(first, last);
+            for (real_t x : w)
+                check_weight(x);
+            n = w.size();
+            levels.assign(1, std::move(w));
+            build();
+            if (!std::isfinite(total()))
+                throw std::invalid_argument("The sum of the weights must be finite!");
+        }
+
+        /// @brief Sets the weight of index i, in O(log n)
+        /// @note std::out_of_range for i >= size(), std::invalid_argument for a negative or non-finite weight, or one
+        /// that takes the total to infinity (the weights then being left as they were)
+        void update(size_t i, real_t w);
+
+        /// @brief Sets the weights of the m indices index[k] to weight[k]
+        /// @note All the arguments are checked before anything changes, and the weights are put back if the total
+        /// overflows (std::invalid_argument as for update(i, w)). The paths of the changed weights are
+        /// recomputed once each, where their sums are shared, and the whole tree is rebuilt instead (in O(n)) when
+        /// there are more than n / fanout of them.
+        void update(const size_t* index, const real_t* weight, size_t m);
+
+        /// @brief Changes the number of weights, those added being 0
+        /// @note O(n)
+        void resize(size_t size);
+
+        /// @brief Number of weights
+        size_t size() const;
+
+        /// @brief Weight of index i
+        real_t weight(size_t i) const;
+
+        /// @brief Sum of the weights
+        real_t total() const;
+
+        /// @brief Returns a sample of the random variable following the distribution given a 'r'
+        /// @param r a uniformly distributed unit random variable
+        /// @note Nondecreasing in r; std::invalid_argument if all the weights are 0
+        int_t next(real_t r) const;
+
+        /// @brief Returns a sample of the random variable following the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @note O(log n) per value; std::invalid_argument if all the weights are 0
+        template <typename Derived, typename T>
+        int_t next(DiceForge::StaticGenerator<Derived, T>& rng) const {
+            DF_INSTRUMENT_SAMPLES("DynamicDiscrete", 1);
+            return next(rng.next_unit());
+        }
+
+        /// @brief Fills the buffer with samples of the random variable following the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @param out Pointer to the first element of the buffer
+        /// @param count Number of values to be written
+        /// @note Blocks of uniforms from fill_unit, each descending the tree
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, int_t* out, size_t count) const {
+            DF_INSTRUMENT_SAMPLES("DynamicDiscrete", count);
+            const real_t sum = total();
+            if (!(sum > 0))
+                throw std::invalid_argument("All the weights are zero!");
+            real_t u[256];
+            while (count > 0){
+                size_t m = std::min(count, size_t(256));
+                rng.fill_unit(u, m);
+                for (size_t i = 0; i < m; i++)
+                    out[i] = int_t(find<false>(u[i] * sum));
+                out += m;
+                count -= m;
+            }
+        }
+
+        /// @brief Returns the theoretical variance of the distribution
+        /// @note O(n)
+        real_t variance() const override;
+
+        /// @brief Returns the theoretical expectation value of the distribution
+        /// @note O(n)
+        real_t expectation() const override;
+
+        /// @brief Smallest number that can be generated in the distribution
+        /// @returns 0
+        int_t minValue() const override;
+
+        /// @brief Largest number that can be generated in the distribution
+        /// @returns size() - 1
+        int_t maxValue() const override;
+
+        /// @brief Probability mass function, w[x] / total()
+        real_t pmf(int_t x) const override;
+
+        /// @brief Cumulative distribution function, in O(log n) from the sums of the tree
+        real_t cdf(int_t x) const override;
+
+        /// @brief Quantile function, the first x whose cdf reaches p, in O(log n) by descending the tree
+        int_t quantile(real_t p) const override;
+        using Discrete::pmf;
+        using Discrete::cdf;
+        using Discrete::quantile;
+    };
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include "Geometric.h"
 #include <iostream>
+#include "simd.h"
 
 namespace DiceForge
 {
@@ -10,22 +11,41 @@ namespace DiceForge
         if (p < 0 || p > 1) {
             throw std::invalid_argument("Invalid 'success' probability value for Geometric distribution!");
         }
+        inv_log_q = 1/log1p(-p);
     }
 
     int_t Geometric::next(real_t r) 
     {  
-        // Cutpoint method of sampling a Geometric distribution
-        return floor(log(r)/log(1-p)) + 1;
+        // Inversion: the smallest k with 1 - (1-p)^(k+1) > r
+        return int_t(floor(log1p(-r)*inv_log_q));
     }
     
+    void Geometric::invert_each(const real_t* u, const real_t* p, int_t* out, size_t n)
+    {
+        size_t i = 0;
+#if defined(DF_SIMD_REAL)
+        typedef simd::vreal V;
+        real_t t[V::width];
+        for (; i + V::width <= n; i += V::width) {
+            const V x = V::load(u + i), q = V::load(p + i);
+            // p = 1 gives 0, as log1p(-u) / -inf does
+            simd::select(q < V(1.0), simd::log1p(-x) / simd::log1p(-q), V(0.0)).store(t);
+            for (int j = 0; j < V::width; j++)
+                out[i + j] = int_t(floor(t[j]));
+        }
+#endif
+        for (; i < n; i++)
+            out[i] = int_t(floor(log1p(-u[i]) / log1p(-p[i])));
+    }
+
     real_t Geometric::variance() const{
         // Variance of Geometric distribution: (1-p)/(p*p)
         return (1-p)/(p*p);
     }
 
     real_t Geometric::expectation() const {
-        // Expectation value of Geometric distribution: 1/p
-        return 1/p;
+        // Expectation value of Geometric distribution: (1-p)/p
+        return (1-p)/p;
     }
 
     int_t Geometric::minValue() const  {
@@ -35,7 +55,7 @@ namespace DiceForge
 
     int_t Geometric::maxValue() const  {
         // Largest value that can be generated in Geometric distribution: infinity
-        return std::numeric_limits<int_t>().infinity();
+        return std::numeric_limits<int_t>::max();
     }
 
     real_t Geometric::pmf(int_t x) const  {
@@ -45,9 +65,45 @@ namespace DiceForge
     }
 
     real_t Geometric::cdf(int_t x) const  {
-        // Cumulative distribution function of Geometric distribution
+        // Cumulative distribution function of Geometric distribution, 1 - (1-p)^(x+1)
+        return (x < 0) ? 0 : -expm1((1+real_t(x))*log1p(-p));
+    }
+
+    real_t Geometric::logpmf(int_t x) const  {
         real_t f = (1-p);
-	    int t = (1+floor(x));
-        return (1-pow(f,t));
-    }       
+        return log(1-f) + x*log(f);
+    }
+
+    void Geometric::pmf(const int_t* x, real_t* out, size_t n) const  {
+        const real_t f = (1-p), lp = log(1-f), lf = log(f);
+        for (size_t i = 0; i < n; i++) {
+            out[i] = exp(lp + x[i]*lf);
+        }
+    }
+
+    void Geometric::logpmf(const int_t* x, real_t* out, size_t n) const  {
+        const real_t f = (1-p), lp = log(1-f), lf = log(f);
+        for (size_t i = 0; i < n; i++) {
+            out[i] = lp + x[i]*lf;
+        }
+    }
+
+    void Geometric::cdf(const int_t* x, real_t* out, size_t n) const  {
+        const real_t lf = log(1-real_t(p));
+        for (size_t i = 0; i < n; i++) {
+            out[i] = -expm1((1+x[i])*lf);
+        }
+    }
+
+    int_t Geometric::quantile(real_t u) const  {
+        detail::check_probability(u);
+        const real_t guess = ceil(log1p(-u)*inv_log_q) - 1;
+        // u = 1 (or p = 1) leaves the search to the cdf
+        if (!(guess < real_t(maxValue())))
+            return Discrete::quantile(u);
+        int_t k = (guess > 0) ? int_t(guess) : 0;
+        while (k > 0 && cdf(k-1) >= u) k--;
+        while (cdf(k) < u) k++;
+        return k;
+    }
 } 
\ No newline at end of file
@@ -2,12 +2,19 @@
 #define DF_GEOMETRIC_H
 
 #include "distribution.h"
+#include "generator.h"
+#include <algorithm>
 
 namespace DiceForge {
     /// @brief DiceForge::Geometric - A Discrete Probability Distribution (Geometric) 
+    /// @note The number of failed trials before the first "success"
     class Geometric : public Discrete {
         private:
-            float p;
+            real_t p;
+            // 1 / log(1 - p), for inversion
+            real_t inv_log_q;
+            // floor(log(1 - u[i]) / log(1 - p[i])) for the uniforms u of sample_each, on lanes of simd::vreal
+            static void invert_each(const real_t* u, const real_t* p, int_t* out, size_t n);
         public:
             /// @brief Constructor for the Geometric distribution
             /// @param p probability of "success"
@@ -15,22 +22,89 @@ namespace DiceForge {
             /// @brief Returns the next value of the random variable described by the distribution
             /// @param r A random real number uniformly distributed between 0 and 1
             int_t next(real_t r);            
+            /// @brief Returns the next value of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            template <typename Derived, typename T>
+            int_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+            {
+                DF_INSTRUMENT_SAMPLES("Geometric", 1);
+                return int_t(std::floor(std::log1p(-rng.next_unit()) * inv_log_q));
+            }
+            /// @brief Fills the buffer with values of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param out Pointer to the first element of the buffer
+            /// @param count Number of values to be written
+            /// @note Inversion of blocks of uniforms from fill_unit
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, int_t* out, size_t count)
+            {
+                DF_INSTRUMENT_SAMPLES("Geometric", count);
+                real_t u[256];
+                while (count > 0)
+                {
+                    size_t m = std::min(count, size_t(256));
+                    rng.fill_unit(u, m);
+                    for (size_t i = 0; i < m; i++)
+                        out[i] = int_t(std::floor(std::log1p(-u[i]) * inv_log_q));
+                    out += m;
+                    count -= m;
+                }
+            }
+            /// @brief Fills the buffer with one value of each of n Geometric distributions, without constructing them
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param p Pointer to the n probabilities of "success" (in [0, 1])
+            /// @param out Pointer to the first element of the buffer
+            /// @param count Number of values to be written
+            /// @note Inversion of blocks of uniforms from fill_unit, as in sample, lanes at a time
+            template <typename Derived, typename T>
+            static void sample_each(DiceForge::StaticGenerator<Derived, T>& rng, const real_t* p, int_t* out,
+                                    size_t count)
+            {
+                DF_INSTRUMENT_SAMPLES("Geometric", count);
+                bool valid = true;
+                for (size_t i = 0; i < count; i++)
+                    valid &= (p[i] >= 0) & (p[i] <= 1);
+                if (!valid)
+                    throw std::invalid_argument("Invalid 'success' probability value for Geometric distribution!");
+                real_t u[256];
+                while (count > 0)
+                {
+                    size_t m = std::min(count, size_t(256));
+                    rng.fill_unit(u, m);
+                    invert_each(u, p, out, m);
+                    p += m;
+                    out += m;
+                    count -= m;
+                }
+            }
             /// @brief Returns the theoretical variance of the distribution
             /// @returns (1-p)/(p^2)
             real_t variance() const override;
             /// @brief Returns the theoretical expectation value of the distribution
-            /// @return 1/p
+            /// @return (1-p)/p
             real_t expectation() const override;
             /// @brief Returns the minimum possible value of the random variable described by the distribution
             /// @return 0
             int_t minValue() const override;
             /// @brief Returns the maximum possible value of the random variable described by the distribution
-            /// @return positive infinity
+            /// @return the largest int_t (the distribution is unbounded)
             int_t maxValue() const override;
             /// @brief Probability mass function of the Geometric distribution
             real_t pmf(int_t k) const override;        
             /// @brief Cumulative distribution function of the Geometric distribution 
             real_t cdf(int_t k) const override;
+            /// @brief Natural logarithm of the probability mass function of the Geometric distribution
+            real_t logpmf(int_t k) const override;
+            /// @brief Probability mass function of the Geometric distribution at the n locations k, written to out
+            void pmf(const int_t* k, real_t* out, size_t n) const override;
+            /// @brief Logarithm of the probability mass function at the n locations k, written to out
+            void logpmf(const int_t* k, real_t* out, size_t n) const override;
+            /// @brief Cumulative distribution function at the n locations k, written to out
+            void cdf(const int_t* k, real_t* out, size_t n) const override;
+            /// @brief Quantile function of the Geometric distribution, the smallest k with 1 - (1-p)^(k+1) >= u
+            /// @note In closed form, as in next(r), corrected by a step where the logarithms round the other way
+            int_t quantile(real_t u) const override;
+            using Discrete::quantile;
     };
 }
 
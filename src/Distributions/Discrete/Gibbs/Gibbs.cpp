@@ -2,16 +2,96 @@
 
 namespace DiceForge
 {
-    Gibbs::~Gibbs(){
-        // Free memory used by 3 arrays
-        free(cdf_array);
-        free(pmf_array);
-        free(x_array);
+    void Gibbs::init(std::vector<std::pair<int_t, real_t>>& xy, real_t beta){
+        // Sort the pmf in increasing order of x (required for constructing cdf)
+        std::sort(xy.begin(), xy.end());
+
+        // Display error if x values are not unique
+        for (size_t i = 1; i < xy.size(); i++) {
+            if (xy[i].first == xy[i - 1].first) {
+                throw std::invalid_argument("All x values in x_arr must be unique!");
+            }
+        }
+
+        n = xy.size();
+        x_array.resize(n);
+        energy_array.resize(n);
+        for (int_t i = 0; i < n; i++){
+            x_array[i] = xy[i].first;
+            energy_array[i] = xy[i].second;
+        }
+        pmf_array.resize(n);
+        cdf_array.resize(n);
+        alias_prob.resize(n);
+        alias_index.resize(n);
+        work.resize(n);
+        setBeta(beta);
+    }
+
+    void Gibbs::setBeta(real_t beta){
+        current_beta = beta;
+
+        // exp(- beta * E) relative to the largest one, so that large beta neither overflows nor underflows to 0
+        real_t least = beta * energy_array[0];
+        for (int_t i = 1; i < n; i++){
+            least = std::min(least, beta * energy_array[i]);
+        }
+
+        // Store pmf_array and cdf_array (prefix sum array of pmf_array)
+        real_t prev = 0;
+        for (int_t i = 0; i < n; i++){
+            pmf_array[i] = exp(- (beta * energy_array[i] - least));
+            cdf_array[i] = prev + pmf_array[i];
+            prev = cdf_array[i];
+        }
+
+        // Divide by Z(beta) = cdf_array[n - 1] for normalisation
+        real_t Z = cdf_array[n - 1];
+        for (int_t i = 0; i < n; i++){
+            pmf_array[i] /= Z;
+            cdf_array[i] /= Z;
+        }
+
+        // Alias table (Vose): columns below 1 are kept at the front of work and those above 1 at the back,
+        // then every column below 1 is topped up from one above 1
+        int_t small = 0, large = n;
+        for (int_t i = 0; i < n; i++){
+            alias_prob[i] = pmf_array[i] * n;
+            alias_index[i] = i;
+            if (alias_prob[i] < 1)
+                work[small++] = i;
+            else
+                work[--large] = i;
+        }
+        int_t s_end = small, l_begin = large;
+        small = 0;
+        while (small < s_end && l_begin < n){
+            int_t s = work[small++], l = work[l_begin];
+            alias_index[s] = l;
+            alias_prob[l] -= 1 - alias_prob[s];
+            if (alias_prob[l] < 1){
+                // l moves to the small side, into the slot just freed
+                work[--small] = l;
+                l_begin++;
+            }
+        }
+        // Whatever is left is 1 up to rounding
+        for (int_t i = small; i < s_end; i++){
+            alias_prob[work[i]] = 1;
+        }
+        for (int_t i = l_begin; i < n; i++){
+            alias_prob[work[i]] = 1;
+        }
+    }
+
+    real_t Gibbs::getBeta() const{
+        return current_beta;
     }
 
     int_t Gibbs::next(real_t r){
         // Binary search for x such that : P(X < x) <= r < P(X <= x)
-        return x_array[(std::upper_bound(cdf_array, cdf_array + n, r) - cdf_array)];
+        int_t i = std::upper_bound(cdf_array.begin(), cdf_array.end(), r) - cdf_array.begin();
+        return x_array[std::min(i, n - 1)];
     }
 
     real_t Gibbs::variance() const{
@@ -47,20 +127,26 @@ namespace DiceForge
 
     real_t Gibbs::pmf(int_t x) const{
         // Binary search for x in x_array and return corresponding pmf
-        int_t *ptr = std::upper_bound(x_array, x_array + n, x);
-        if (ptr == x_array or *(ptr-1) != x){
+        auto ptr = std::upper_bound(x_array.begin(), x_array.end(), x);
+        if (ptr == x_array.begin() or *(ptr-1) != x){
             return 0;
         }
-        return pmf_array[ptr - x_array - 1];
+        return pmf_array[ptr - x_array.begin() - 1];
     }
 
 
     real_t Gibbs::cdf(int_t x) const{
         // Binary search for x in x_array and return corresponding cdf
-        int_t *ptr = std::upper_bound(x_array, x_array + n, x);
-        if (ptr == x_array){
+        auto ptr = std::upper_bound(x_array.begin(), x_array.end(), x);
+        if (ptr == x_array.begin()){
             return 0;
         }
-        return cdf_array[ptr - x_array - 1];
+        return cdf_array[ptr - x_array.begin() - 1];
+    }
+
+    int_t Gibbs::quantile(real_t p) const{
+        detail::check_probability(p);
+        int_t i = std::lower_bound(cdf_array.begin(), cdf_array.end(), p) - cdf_array.begin();
+        return x_array[std::min(i, n - 1)];
     }
-}
\ No newline at end of file
+}
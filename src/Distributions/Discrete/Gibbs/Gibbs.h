@@ -2,21 +2,32 @@
 #define DF_GIBBS_H
 
 #include "distribution.h"
+#include "generator.h"
 #include <algorithm>
+#include <vector>
 
 namespace DiceForge {
 
     /// @brief DiceForge::Gibbs - Gibbs distribution class (derived from Discrete)
     class Gibbs : public Discrete {
     private:
-        // Array to store cdf
-        real_t *cdf_array = nullptr;
-        // Array to store pmf
-        real_t *pmf_array = nullptr;
-        // Array to store x values (output values)
-        int_t *x_array = nullptr;
-        // Length of all 3 arrays
+        // x values (output values), sorted, and the energies that go with them
+        std::vector<int_t> x_array;
+        std::vector<real_t> energy_array;
+        // pmf and cdf (prefix sum of the pmf) of each x value
+        std::vector<real_t> pmf_array;
+        std::vector<real_t> cdf_array;
+        // Alias table: probability of keeping each column, and the index it is paired with otherwise
+        std::vector<real_t> alias_prob;
+        std::vector<int_t> alias_index;
+        // Worklist for building the alias table, kept so that setBeta does not allocate
+        std::vector<int_t> work;
+        // Length of all the arrays
         int_t n = 0;
+        real_t current_beta = 0;
+
+        // Sorts the (x, energy) pairs and checks them, then computes the distribution for beta
+        void init(std::vector<std::pair<int_t, real_t>>& xy, real_t beta);
     public:
         /// @brief Constructor to initialise private attributes of the distribution
         template <typename RandomAccessIterator1, typename RandomAccessIterator2>
@@ -27,55 +38,52 @@ namespace DiceForge {
             if (sequence_last - sequence_first != function_last - function_first){
                 throw std::invalid_argument("Lengths of sequence and function sequence must match!");
             }
-            n = sequence_last - sequence_first;
             // Display error if n is not at least 1
-            if (n <= 0) {
+            if (sequence_last - sequence_first <= 0) {
                 throw std::invalid_argument("len must be positive!");
             }
 
-            // Sort the pmf in increasing order of x (required for constructing cdf)
-            std::pair<int_t, real_t> xy_arr[n];
-            for (int i = 0; i < n; i++){
-                xy_arr[i].first = sequence_first[i];
-                xy_arr[i].second = function_first[i];
-            }
-            std::sort(xy_arr, xy_arr + n);
-
-            // Display error if x values are not unique
-            for (int i = 1; i < n; i++) {
-                if (xy_arr[i].first == xy_arr[i - 1].first) {
-                    throw std::invalid_argument("All x values in x_arr must be unique!");
-                }
-            }
-
-            // Store x_array
-            x_array = (int_t*)malloc(n * sizeof(int_t));
-            for (int i = 0; i < n; i++){
-                x_array[i] = xy_arr[i].first;
+            std::vector<std::pair<int_t, real_t>> xy(sequence_last - sequence_first);
+            for (size_t i = 0; i < xy.size(); i++){
+                xy[i].first = sequence_first[i];
+                xy[i].second = function_first[i];
             }
+            init(xy, beta);
+        }
 
-            // Store pmf_array and cdf_array (prefix sum array of pmf_array)
-            pmf_array = (real_t *)malloc(n * sizeof(real_t));
-            cdf_array = (real_t *)malloc(n * sizeof(real_t));
-            real_t prev = 0;
-            for (int i = 0; i < n; i++){
-                pmf_array[i] = exp(- beta * xy_arr[i].second);
-                cdf_array[i] = prev + pmf_array[i];
-                prev = cdf_array[i];
-            }
+        /// @brief Recomputes the distribution for a new beta, reusing the sorted values and all the arrays
+        /// @note O(n), without sorting or allocating, for sweeping beta (as in simulated annealing)
+        void setBeta(real_t beta);
 
-            // Divide by Z(beta) = cdf_array[n - 1] for normalisation
-            for (int i = 0; i < n; i++){
-                pmf_array[i] /= cdf_array[n - 1];
-                cdf_array[i] /= cdf_array[n - 1];
-            }
-        }
-        // Destructor to free memory used by the 3 array attributes
-        ~Gibbs();
+        /// @brief The current beta
+        real_t getBeta() const;
         
         /// @brief Returns a sample of the random variable following the distribution given a 'r'
         /// @param r a uniformly distributed unit random variable
+        /// @note Inversion by binary search, so that the value is nondecreasing in r
         int_t next(real_t r);
+
+        /// @brief Returns a sample of the random variable following the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @note O(1) per value, by the alias method
+        template <typename Derived, typename T>
+        int_t next(DiceForge::StaticGenerator<Derived, T>& rng){
+            DF_INSTRUMENT_SAMPLES("Gibbs", 1);
+            size_t i = size_t(detail::uniform_index(rng, uint64_t(n)));
+            return x_array[(rng.next_unit() < alias_prob[i]) ? int_t(i) : alias_index[i]];
+        }
+
+        /// @brief Fills the buffer with samples of the random variable following the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @param out Pointer to the first element of the buffer
+        /// @param count Number of values to be written
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, int_t* out, size_t count){
+            DF_INSTRUMENT_SAMPLES("Gibbs", count);
+            for (size_t j = 0; j < count; j++){
+                out[j] = next(rng);
+            }
+        }
         
         /// @brief Returns the theoretical variance of the distribution
         real_t variance() const override;
@@ -94,6 +102,12 @@ namespace DiceForge {
         
         /// @brief Cumulative distribution function for the Gibbs distribution
         real_t cdf(int_t x) const override;
+
+        /// @brief Quantile function for the Gibbs distribution, the first x whose cdf reaches p (binary search)
+        int_t quantile(real_t p) const override;
+        using Discrete::pmf;
+        using Discrete::cdf;
+        using Discrete::quantile;
     };
 }
 
@@ -13,95 +13,198 @@ namespace DiceForge
            "n and K must be positive, and n and K must not be larger than N");
         }
 
-        pmfs.resize((std::min(n, K) + 1));       // pmf vector stores the probabilities
-        cumulative.resize((std::min(n, K) + 1)); // cumulative sum vector
-        if (n + K > N)
+        lo = std::max(n + K - N, (int32_t)0);
+        first = lo;
+        hi = std::min(n, K);
+        mode = std::min(hi, std::max(lo, int_t(std::floor((n + 1.0) * (K + 1.0) / (N + 2.0)))));
+        lnorm = log_factorial(K) + log_factorial(N - K) - log_nCr(N, n);
+        lpmode = logpmf(mode);
+
+        real_t var = variance();
+        if (std::sqrt(var) < inversion_limit)
         {
+            // using the recurrence outwards from the mode, until the probabilities are negligible next to it
+            std::vector<real_t> below;
+            real_t pk = 1;
+            for (int_t k = mode; k > lo; k--)
+            {
+                pk *= ratio_down(k);
+                if (pk < 1e-20)
+                    break;
+                below.push_back(pk);
+            }
+            first = mode - int_t(below.size());
+            pmfs.assign(below.rbegin(), below.rend());
+            pmfs.push_back(1);
+            pk = 1;
+            for (int_t k = mode; k < hi; k++)
+            {
+                pk *= ratio_up(k);
+                if (pk < 1e-20)
+                    break;
+                pmfs.push_back(pk);
+            }
 
-            for (int i = 0; i < std::max(n + K - N, (int32_t)0); i++)
+            real_t sum = 0;
+            for (real_t p : pmfs)
+                sum += p;
+            cumulative.resize(pmfs.size());
+            real_t cdf = 0;
+            for (size_t i = 0; i < pmfs.size(); i++)
             {
-                pmfs[i] = 0;
+                pmfs[i] /= sum;
+                cdf += pmfs[i];
+                cumulative[i] = cdf;
             }
+
+            guide.resize(cumulative.size());
+            size_t k = 0;
+            for (size_t j = 0; j < guide.size(); j++)
+            {
+                while (k + 1 < cumulative.size() && cumulative[k] <= real_t(j) / guide.size()) k++;
+                guide[j] = k;
+            }
+        }
+        else
+        {
+            real_t sd = std::sqrt(var + 0.5);
+            centre = expectation() + 0.5;
+            width = 1.7155277699214135 * sd + 0.8989161620588988;
+            cutoff = std::min(hi + 1.0, std::floor(centre + 16 * sd));
         }
-        int start = std::max(n + K - N, (int32_t)0);
+    }
 
-        real_t ta = (real_t)nCr(K, start);
-        real_t tb = (real_t)nCr(N - K, n - start);
-        real_t tc = (real_t)nCr(N, n);
+    // pmf(k + 1) / pmf(k)
+    real_t Hypergeometric::ratio_up(int_t k) const
+    {
+        return ((real_t)(K - k) * (n - k)) / ((real_t)(k + 1) * (N - K - n + k + 1));
+    }
 
-        pmfs[start] = (tb / tc) * ta;
+    // pmf(k - 1) / pmf(k)
+    real_t Hypergeometric::ratio_down(int_t k) const
+    {
+        return ((real_t)k * (N - K - n + k)) / ((real_t)(K - k + 1) * (n - k + 1));
+    }
 
-        // using recurrence to calculate the probabilities instead of calling pmf function everytime
-        for (int i = start + 1; i < std::min(n, K) + 1; i++)
-        {
-            pmfs[i] = pmfs[i - 1] * ((real_t)((K - i + 1) * (n - i + 1))) / (i * (N - K - n + i));
-        }
+    int_t Hypergeometric::attempt(real_t u, real_t v) const
+    {
+        if (u <= 0)
+            return -1;
+        real_t w = centre + width * (v - 0.5) / u;
+        if (w < lo || w >= cutoff)
+            return -1;
+        int_t k = int_t(std::floor(w));
+        real_t t = logpmf(k) - lpmode;
+        // Squeezes on 2 log(u) <= t
+        if (u * (4 - u) - 3 <= t)
+            return k;
+        if (u * (u - t) >= 1)
+            return -1;
+        return (2 * std::log(u) <= t) ? k : -1;
+    }
 
-        cumulative[0] = pmfs[0];
-        for (int i = 1; i < std::min(n, K) + 1; i++)
+    real_t Hypergeometric::tail(int_t x, int step) const
+    {
+        real_t pk = pmf(x), sum = 0;
+        for (int_t k = x; k >= lo && k <= hi; k += step)
         {
-            cumulative[i] = cumulative[i - 1] + pmfs[i];
+            sum += pk;
+            if (pk <= sum * 1e-17)
+                break;
+            pk *= (step > 0) ? ratio_up(k) : ratio_down(k);
         }
+        return sum;
     }
-    // next function returns the index where cumulative[index] is just greater than r
+
+    // next function returns the first value whose cdf is greater than r
     int_t Hypergeometric::next(real_t r)
     {
-        for (int i = 0; i < std::min(n, K); i++)
+        if (!cumulative.empty())
+            return from_table(r);
+
+        // walking from the mode
+        int_t k = mode;
+        real_t pk = std::exp(lpmode), F = cdf(mode);
+        if (r < F)
         {
-            /* code */
-            if (cumulative[i] >= r)
+            while (k > lo && r < F - pk)
             {
-                return i;
+                F -= pk;
+                pk *= ratio_down(k);
+                k--;
             }
         }
-        return (std::min(n, K));
+        else
+        {
+            while (k < hi && r >= F)
+            {
+                pk *= ratio_up(k);
+                k++;
+                F += pk;
+            }
+        }
+        return k;
     }
 
     // theoritical expectation
     real_t Hypergeometric::expectation() const
     {
-        return (real_t)(n * K) / N;
+        return (real_t)n * K / N;
     }
 
     // theoritical variance
     real_t Hypergeometric::variance() const
     {
-        real_t num = n * K * (N - K) * (N - n);
-        real_t den = N * N * (N - 1);
+        if (N <= 1)
+            return 0;
+        real_t num = (real_t)n * K * (N - K) * (N - n);
+        real_t den = (real_t)N * N * (N - 1);
         return num / den;
     }
 
     // theoritical minimum
     int_t Hypergeometric::minValue() const
     {
-        return std::max(n + K - N, (int32_t)0);
+        return lo;
     }
 
     // theoritical maximum
     int_t Hypergeometric::maxValue() const
     {
-        return (std::min(n, K));
+        return hi;
+    }
+
+    // returns log pmf of any value x
+    real_t Hypergeometric::logpmf(int_t x) const
+    {
+        if (x < lo || x > hi)
+            return -std::numeric_limits<real_t>::infinity();
+        return lnorm - log_factorial(x) - log_factorial(K - x)
+               - log_factorial(n - x) - log_factorial(N - K - n + x);
     }
 
     // returns pmf of any value x
     real_t Hypergeometric::pmf(int_t x) const
     {
-        if (x <= std::min(n, K) && x >= std::max(n + K - N, (int32_t)0))
-            return (pmfs[x]);
-        else
-            return 0;
+        if (x >= first && x < first + int_t(pmfs.size()))
+            return pmfs[x - first];
+        return std::exp(logpmf(x));
     }
 
     // returns cdf of any value x
     real_t
     Hypergeometric::cdf(int_t x) const
     {
-        if (x < std::max(n + K - N, (int32_t)0))
+        if (x < lo)
             return 0;
-        else if (x <= std::min(n, K))
-            return cumulative[x];
-        else
+        if (x >= hi)
             return 1;
+        if (x >= first && x + 1 < first + int_t(cumulative.size()))
+            return cumulative[x - first];
+        // summing the shorter tail
+        if (x < mode)
+            return tail(x, -1);
+        return 1 - tail(x + 1, 1);
     }
 
-}
\ No newline at end of file
+}
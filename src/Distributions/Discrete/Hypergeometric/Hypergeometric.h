@@ -2,6 +2,7 @@
 #define DF_HYPERGEOMETRIC_H
 
 #include "distribution.h"
+#include "generator.h"
 #include <vector>
 
 namespace DiceForge
@@ -11,28 +12,85 @@ namespace DiceForge
     /// replacement from an urn with two colors. n is the number of balls you take,
     /// K is the number of red balls in the urn, N is the total number of balls in
     /// the urn, and the return value is the number of red balls you get.
-    /// To regenerate samples of the variation this class uses inversion by chop-down
-    /// search from start when parameters are small
+    /// To regenerate samples of the variation this class uses inversion with a guide
+    /// table when the spread is small, and ratio-of-uniforms rejection otherwise
     class Hypergeometric : public Discrete
     {
     private:
         int32_t N, K, n;
-        std::vector<real_t> pmfs;
-        std::vector<real_t> cumulative;
         // N - total size of the population
         // K - occurence in the population (successes)
         // n - sample numbers
         // constraints-(n<=N and k<=N and n>=0 and k>=0)
+        // Support [lo, hi] and mode
+        int_t lo, hi, mode;
+        // log(K!) + log((N - K)!) - log(nCr(N, n)), the part of logpmf that does not depend on k
+        real_t lnorm;
+        // Below this standard deviation values are drawn by inversion, above it by ratio-of-uniforms
+        static constexpr real_t inversion_limit = 30;
+        // Inversion: pmfs and cumulative from first on, over the values whose probabilities are not negligible,
+        // and guide[j] = first index with cumulative > j / guide.size()
+        int_t first;
+        std::vector<real_t> pmfs;
+        std::vector<real_t> cumulative;
+        std::vector<int_t> guide;
+        // Ratio-of-uniforms (Stadlober): centre, width and cut-off of the hat, and logpmf at the mode
+        real_t centre, width, cutoff, lpmode;
+
+        int_t from_table(real_t u) const
+        {
+            int_t k = guide[size_t(u * guide.size())];
+            while (k + 1 < int_t(cumulative.size()) && u >= cumulative[k]) k++;
+            return first + k;
+        }
+        // pmf(k + 1) / pmf(k) and pmf(k - 1) / pmf(k)
+        real_t ratio_up(int_t k) const;
+        real_t ratio_down(int_t k) const;
+        // One ratio-of-uniforms attempt with the uniforms u and v, the value if accepted and -1 otherwise
+        int_t attempt(real_t u, real_t v) const;
+        // pmf(x) + pmf(x + step) + pmf(x + 2 step) + ... until the terms are negligible
+        real_t tail(int_t x, int step) const;
     public:
         /// @brief Constructor for the Hypergeometric distribution
         /// @param N total size of the population
         /// @param K occurence in the population (successes)
         /// @param n sample numbers
         /// @note n<=N, k<=N, n>=0, k>=0
+        /// @note The cost of construction follows the standard deviation, not the support. Below 30 it builds
+        /// tables for inversion with a guide table, above it values are drawn by ratio-of-uniforms in O(1)
+        /// expected time.
         Hypergeometric(int32_t N, int32_t K, int32_t n); 
         /// @brief Returns the next value of the random variable described by the distribution
         /// @param r A random real number uniformly distributed between 0 and 1
         int_t next(real_t r);        
+        /// @brief Returns the next value of the random variable described by the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        template <typename Derived, typename T>
+        int_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+        {
+            DF_INSTRUMENT_SAMPLES("Hypergeometric", 1);
+            if (!cumulative.empty())
+                return from_table(rng.next_unit());
+            int_t k;
+            do {
+                real_t u = rng.next_unit();
+                k = attempt(u, rng.next_unit());
+                if (k < 0)
+                    DF_INSTRUMENT_REJECT("Hypergeometric");
+            } while (k < 0);
+            return k;
+        }
+        /// @brief Fills the buffer with values of the random variable described by the distribution
+        /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+        /// @param out Pointer to the first element of the buffer
+        /// @param count Number of values to be written
+        template <typename Derived, typename T>
+        void sample(DiceForge::StaticGenerator<Derived, T>& rng, int_t* out, size_t count)
+        {
+            DF_INSTRUMENT_SAMPLES("Hypergeometric", count);
+            for (size_t i = 0; i < count; i++)
+                out[i] = next(rng);
+        }
         /// @brief Returns the theoretical variance of the distribution
         real_t variance() const override;
         /// @brief Returns the theoretical expectation value of the distribution
@@ -45,6 +103,11 @@ namespace DiceForge
         real_t pmf(int_t k) const override;       
         /// @brief Cumulative distribution function of the Hypergeometric distribution 
         real_t cdf(int_t k) const override;
+        /// @brief Natural logarithm of the probability mass function of the Hypergeometric distribution
+        real_t logpmf(int_t k) const override;
+        using Discrete::pmf;
+        using Discrete::logpmf;
+        using Discrete::cdf;
     };
 }
 
@@ -1,5 +1,6 @@
 #include "NegHypergeometric.h"
 #include "basicfxn.h"
+#include <algorithm>
 
 namespace DiceForge {
     
@@ -13,43 +14,151 @@ namespace DiceForge {
             "K must not be larger than N and r must not be larger than N - K");
         }
 
-        // precalculate pmfs for faster random number generation
-        pmfs = new real_t[K+1];
-        for (int k = 0; k <= K; k++)
+        // with r = 0 the experiment stops at once
+        hi = (r == 0) ? 0 : K;
+        first = 0;
+        lnorm = (r == 0) ? -INFINITY : -log_factorial(r - 1) - log_factorial(N - r - K) - log_nCr(N, K);
+
+        // the pmf is log-concave, so the mode is within one step of the mean
+        mode = std::min(hi, int_t(expectation()));
+        while (mode < hi && ratio_up(mode) > 1)
+            mode++;
+        while (mode > 0 && ratio_down(mode) > 1)
+            mode--;
+        lpmode = logpmf(mode);
+
+        real_t var = variance();
+        if (std::sqrt(var) < inversion_limit)
+        {
+            // precalculate pmfs by the recurrence outwards from the mode, until they are negligible next to it
+            std::vector<real_t> below;
+            real_t pk = 1;
+            for (int_t k = mode; k > 0; k--)
+            {
+                pk *= ratio_down(k);
+                if (pk < 1e-20)
+                    break;
+                below.push_back(pk);
+            }
+            first = mode - int_t(below.size());
+            pmfs.assign(below.rbegin(), below.rend());
+            pmfs.push_back(1);
+            pk = 1;
+            for (int_t k = mode; k < hi; k++)
+            {
+                pk *= ratio_up(k);
+                if (pk < 1e-20)
+                    break;
+                pmfs.push_back(pk);
+            }
+
+            real_t sum = 0;
+            for (real_t p : pmfs)
+                sum += p;
+            cumulative.resize(pmfs.size());
+            real_t cdf = 0;
+            for (size_t i = 0; i < pmfs.size(); i++)
+            {
+                pmfs[i] /= sum;
+                cdf += pmfs[i];
+                cumulative[i] = cdf;
+            }
+
+            guide.resize(cumulative.size());
+            size_t k = 0;
+            for (size_t j = 0; j < guide.size(); j++)
+            {
+                while (k + 1 < cumulative.size() && cumulative[k] <= real_t(j) / guide.size()) k++;
+                guide[j] = k;
+            }
+        }
+        else
         {
-            pmfs[k] = nCr(k + r - 1, k) * nCr(N - r - k, K - k) / real_t(nCr(N, K));    
+            real_t sd = std::sqrt(var + 0.5);
+            centre = expectation() + 0.5;
+            width = 1.7155277699214135 * sd + 0.8989161620588988;
+            cutoff = std::min(hi + 1.0, std::floor(centre + 16 * sd));
         }
     }
 
-    NegHypergeometric::~NegHypergeometric()
+    real_t NegHypergeometric::ratio_up(int_t k) const
+    {
+        return (real_t(k + r) * (K - k)) / (real_t(k + 1) * (N - r - k));
+    }
+
+    real_t NegHypergeometric::ratio_down(int_t k) const
+    {
+        return (real_t(k) * (N - r - k + 1)) / (real_t(k + r - 1) * (K - k + 1));
+    }
+
+    int_t NegHypergeometric::attempt(real_t u, real_t v) const
+    {
+        if (u <= 0)
+            return -1;
+        real_t w = centre + width * (v - 0.5) / u;
+        if (w < 0 || w >= cutoff)
+            return -1;
+        int_t k = int_t(std::floor(w));
+        real_t t = logpmf(k) - lpmode;
+        // Squeezes on 2 log(u) <= t
+        if (u * (4 - u) - 3 <= t)
+            return k;
+        if (u * (u - t) >= 1)
+            return -1;
+        return (2 * std::log(u) <= t) ? k : -1;
+    }
+
+    real_t NegHypergeometric::tail(int_t x, int step) const
     {
-        delete[] pmfs;
+        real_t pk = pmf(x), sum = 0;
+        for (int_t k = x; k >= 0 && k <= hi; k += step)
+        {
+            sum += pk;
+            if (pk <= sum * 1e-17)
+                break;
+            pk *= (step > 0) ? ratio_up(k) : ratio_down(k);
+        }
+        return sum;
     }
 
     int_t NegHypergeometric::next(real_t r) 
     {
-        real_t s = 0;
-        for (int i = 0; i <= K; i++)
+        if (!cumulative.empty())
+            return from_table(r);
+
+        // walking from the mode
+        int_t k = mode;
+        real_t pk = std::exp(lpmode), F = cdf(mode);
+        if (r < F)
         {
-            if (s < r <= s + pmfs[i])
+            while (k > 0 && r < F - pk)
             {
-                return i;
+                F -= pk;
+                pk *= ratio_down(k);
+                k--;
             }
-            s += pmfs[i];
         }
-
-        return K;
+        else
+        {
+            while (k < hi && r >= F)
+            {
+                pk *= ratio_up(k);
+                k++;
+                F += pk;
+            }
+        }
+        return k;
     }
 
     real_t NegHypergeometric::variance() const
     {
         real_t a = r / real_t(N - K + 1);
-        return a * (1 - a) * K * (N + 1) / real_t(N - K + 2);
+        return a * (1 - a) * K * real_t(N + 1) / real_t(N - K + 2);
     }
 
     real_t NegHypergeometric::expectation() const 
     {
-        return real_t(r * K) / real_t(N - K + 1);
+        return real_t(r) * K / real_t(N - K + 1);
     }
 
     int_t NegHypergeometric::minValue() const
@@ -62,23 +171,48 @@ namespace DiceForge {
         return K;
     }
 
-    real_t NegHypergeometric::pmf(int_t k) const 
+    real_t NegHypergeometric::logpmf(int_t k) const 
     {
-        if (k > K || k < 0)
+        if (k > hi || k < 0)
+        {
+            return -std::numeric_limits<real_t>::infinity();
+        }
+        if (r == 0)
         {
             return 0;
         }
-        return pmfs[k];
+        return lnorm + log_factorial(k + r - 1) - log_factorial(k)
+               + log_factorial(N - r - k) - log_factorial(K - k);
+    }
+
+    real_t NegHypergeometric::pmf(int_t k) const 
+    {
+        if (k >= first && k < first + int_t(pmfs.size()))
+        {
+            return pmfs[k - first];
+        }
+        return std::exp(logpmf(k));
     }
 
     real_t NegHypergeometric::cdf(int_t k) const 
     {
-        real_t cdf = 0;
-        for (uint_t i = 0; i <= k; i++)
+        if (k < 0)
+        {
+            return 0;
+        }
+        if (k >= hi)
+        {
+            return 1;
+        }
+        if (k >= first && k + 1 < first + int_t(cumulative.size()))
+        {
+            return cumulative[k - first];
+        }
+        // summing the shorter tail
+        if (k < mode)
         {
-            cdf += pmf(i);
+            return tail(k, -1);
         }
-        
-        return cdf;
+        return 1 - tail(k + 1, 1);
     }
-}
\ No newline at end of file
+}
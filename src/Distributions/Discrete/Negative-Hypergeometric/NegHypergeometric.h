@@ -2,25 +2,82 @@
 #define DF_NEGHYPERGEOMETIRC_H
 
 #include "distribution.h"
+#include "generator.h"
+#include <vector>
 
 namespace DiceForge {
     /// @brief DiceForge::NegHypergeometric - A Discrete Probability Distribution (Negative Hypergeometric) 
     class NegHypergeometric : public Discrete {
         private:
             uint_t N, K, r;
-            real_t* pmfs;
+            // Largest value with a non-zero probability, and the mode
+            int_t hi, mode;
+            // The part of logpmf that does not depend on k
+            real_t lnorm;
+            // Below this standard deviation values are drawn by inversion, above it by ratio-of-uniforms
+            static constexpr real_t inversion_limit = 30;
+            // Inversion: pmfs and cumulative from first on, over the values whose probabilities are not negligible,
+            // and guide[j] = first index with cumulative > j / guide.size()
+            int_t first;
+            std::vector<real_t> pmfs;
+            std::vector<real_t> cumulative;
+            std::vector<int_t> guide;
+            // Ratio-of-uniforms (Stadlober): centre, width and cut-off of the hat, and logpmf at the mode
+            real_t centre, width, cutoff, lpmode;
+
+            int_t from_table(real_t u) const
+            {
+                int_t k = guide[size_t(u * guide.size())];
+                while (k + 1 < int_t(cumulative.size()) && u >= cumulative[k]) k++;
+                return first + k;
+            }
+            // pmf(k + 1) / pmf(k) and pmf(k - 1) / pmf(k)
+            real_t ratio_up(int_t k) const;
+            real_t ratio_down(int_t k) const;
+            // One ratio-of-uniforms attempt with the uniforms u and v, the value if accepted and -1 otherwise
+            int_t attempt(real_t u, real_t v) const;
+            // pmf(x) + pmf(x + step) + pmf(x + 2 step) + ... until the terms are negligible
+            real_t tail(int_t x, int step) const;
         public:
             /// @brief Initializes the Negative Hypergeometric Distribution with (N, K, r)
             /// @param N size of the population 
             /// @param K number of "success" elements in the population
             /// @param r number of "failure" elements to be encountered before experiment is stopped
             /// @note 0 <= K <= N, 0 <= r <= N - K for a valid distribution
+            /// @note As for DiceForge::Hypergeometric, tables for inversion are only built when the standard
+            /// deviation is below 30, and values are drawn by ratio-of-uniforms otherwise
             NegHypergeometric(uint_t N, uint_t K, uint_t r);
-            /// @brief Default destuctor
-            ~NegHypergeometric();
             /// @brief Returns the next value of the random variable described by the distribution
             /// @param r A random real number uniformly distributed between 0 and 1
             int_t next(real_t r);
+            /// @brief Returns the next value of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            template <typename Derived, typename T>
+            int_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+            {
+                DF_INSTRUMENT_SAMPLES("NegHypergeometric", 1);
+                if (!cumulative.empty())
+                    return from_table(rng.next_unit());
+                int_t k;
+                do {
+                    real_t u = rng.next_unit();
+                    k = attempt(u, rng.next_unit());
+                    if (k < 0)
+                        DF_INSTRUMENT_REJECT("NegHypergeometric");
+                } while (k < 0);
+                return k;
+            }
+            /// @brief Fills the buffer with values of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param out Pointer to the first element of the buffer
+            /// @param count Number of values to be written
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, int_t* out, size_t count)
+            {
+                DF_INSTRUMENT_SAMPLES("NegHypergeometric", count);
+                for (size_t i = 0; i < count; i++)
+                    out[i] = next(rng);
+            }
             /// @brief Returns the theoretical variance of the distribution
             real_t variance() const override final;
             /// @brief Returns the theoretical expectation value of the distribution
@@ -35,6 +92,11 @@ namespace DiceForge {
             /// @brief Cumulative distribution function of the Negative hypergeometric distribution
             /// @note Here it is the probability of encountering at most k "success" elements when the experiment is stopped
             real_t cdf(int_t k) const override final;
+            /// @brief Natural logarithm of the probability mass function of the Negative hypergeometric distribution
+            real_t logpmf(int_t k) const override final;
+            using Discrete::pmf;
+            using Discrete::logpmf;
+            using Discrete::cdf;
     };
 }
 
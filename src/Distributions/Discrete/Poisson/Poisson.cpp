@@ -1,10 +1,12 @@
 #include "Poisson.h"
 #include <algorithm>
 #include "basicfxn.h"
+#include "special.h"
+#include "simd.h"
 
 DiceForge::Poisson::Poisson(DiceForge::real_t lambda)
 {
-    if (l < 0) {
+    if (!(lambda >= 0)) {
         throw std::invalid_argument("Lambda must not be negative!");
     }
     
@@ -12,6 +14,54 @@ DiceForge::Poisson::Poisson(DiceForge::real_t lambda)
     sq=sqrt(2);
     lnl=log(l);
     g=l*lnl-lgamma(l+1);
+
+    if (l<table_limit){
+        // Same running sums as cdf(x), until the terms stop changing them
+        DiceForge::real_t p=exp(-l),sum=p;
+        table.push_back(sum);
+        for (int k=1; k<=l || p>sum*1e-17; k++){
+            p=p*(l/k);
+            sum+=p;
+            table.push_back(sum);
+        }
+        guide.resize(table.size());
+        size_t k=0;
+        for (size_t j=0; j<guide.size(); j++){
+            while (k+1<table.size() && table[k]<=DiceForge::real_t(j)/guide.size()) k++;
+            guide[j]=k;
+        }
+    }
+    else{
+        DiceForge::real_t smu=sqrt(l);
+        b=0.931+2.53*smu;
+        a=-0.059+0.02483*b;
+        inv_alpha=1.1239+1.1328/(b-3.4);
+        vr=0.9277-3.6224/(b-2);
+    }
+}
+
+void DiceForge::Poisson::invert_each(const DiceForge::real_t* u, const DiceForge::real_t* lambda, DiceForge::int_t* out, size_t n){
+    // e^-lambda, the first term of every search, lanes at a time
+    DiceForge::real_t first[256];
+    size_t i=0;
+#if defined(DF_SIMD_REAL)
+    typedef DiceForge::simd::vreal V;
+    for (; i+V::width<=n; i+=V::width)
+        simd::exp(-simd::min(V::load(lambda+i),V(table_limit))).store(first+i);
+#endif
+    for (; i<n; i++) first[i]=exp(-std::min(lambda[i],table_limit));
+    for (i=0; i<n; i++){
+        const DiceForge::real_t l=lambda[i];
+        if (!(l<table_limit)) continue;
+        DiceForge::real_t p=first[i], sum=p;
+        DiceForge::int_t k=0;
+        while (u[i]>=sum && p>sum*1e-17){
+            k++;
+            p*=l/k;
+            sum+=p;
+        }
+        out[i]=k;
+    }
 }
 
 DiceForge::real_t DiceForge::Poisson::variance() const{
@@ -27,21 +77,49 @@ DiceForge::int_t DiceForge::Poisson::minValue() const{
 }
 
 DiceForge::int_t DiceForge::Poisson::maxValue() const{
-    return std::numeric_limits<int_t>().infinity();
+    return std::numeric_limits<int_t>::max();
 }
 
 
 DiceForge::real_t DiceForge::Poisson::pmf(DiceForge::int_t x) const{
-    return (pow(l,x)*exp(-l)/tgamma(x+1));
+    // In logarithms, as l^x and x! overflow long before their ratio does
+    return exp(logpmf(x));
 }
 
 DiceForge::real_t DiceForge::Poisson::cdf(DiceForge::int_t x) const{
-   DiceForge::real_t sum=0,a=exp(-l);
-   for (int i=1; i<=x; i++){
-    a = a*(l/i);
-    sum+=a;
-   }
-   return (sum);
+   if (x<0) return 0;
+   if (!table.empty()) return table[std::min(x,DiceForge::int_t(table.size())-1)];
+   return DiceForge::special::gamma_q(x+1.0,l);
 }
 
+DiceForge::real_t DiceForge::Poisson::logpmf(DiceForge::int_t x) const{
+    // x*lnl alone is 0*-inf for lambda = 0
+    return (x<0) ? -INFINITY : (x==0) ? -l : x*lnl-l-log_factorial(x);
+}
 
+void DiceForge::Poisson::pmf(const DiceForge::int_t* x, DiceForge::real_t* out, size_t n) const{
+    logpmf(x,out,n);
+    for (size_t i=0; i<n; i++){
+        out[i]=exp(out[i]);
+    }
+}
+
+void DiceForge::Poisson::logpmf(const DiceForge::int_t* x, DiceForge::real_t* out, size_t n) const{
+    const DiceForge::real_t ln=lnl, m=l;
+    for (size_t i=0; i<n; i++){
+        out[i]=(x[i]<0) ? -INFINITY : (x[i]==0) ? -m : x[i]*ln-m-log_factorial(x[i]);
+    }
+}
+
+void DiceForge::Poisson::cdf(const DiceForge::int_t* x, DiceForge::real_t* out, size_t n) const{
+    for (size_t i=0; i<n; i++){
+        out[i]=cdf(x[i]);
+    }
+}
+
+DiceForge::int_t DiceForge::Poisson::quantile(DiceForge::real_t p) const{
+    if (table.empty()) return Discrete::quantile(p);
+    detail::check_probability(p);
+    DiceForge::int_t k=std::lower_bound(table.begin(),table.end(),p)-table.begin();
+    return std::min(k,DiceForge::int_t(table.size())-1);
+}
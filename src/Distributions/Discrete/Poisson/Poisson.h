@@ -3,6 +3,9 @@
 
 #include "distribution.h"
 #include "generator.h"
+#include "combinatorics.h"
+#include <vector>
+#include <algorithm>
 
 namespace DiceForge {
     
@@ -10,27 +13,134 @@ namespace DiceForge {
     class Poisson : public Discrete {
         private:
             real_t l,sq,lnl,g;
+            // Below this lambda values are drawn from a table, above it by transformed rejection
+            static constexpr real_t table_limit = 10;
+            // Table mode: cdf[k] = P(X <= k) up to where the remaining terms no longer change the sum,
+            // and guide[j] = smallest k with cdf[k] > j / guide.size()
+            std::vector<real_t> table;
+            std::vector<int_t> guide;
+            // PTRS constants (Hormann, "The transformed rejection method for generating Poisson random variables")
+            real_t a,b,inv_alpha,vr;
+
+            int_t from_table(real_t u) const
+            {
+                int_t k=guide[size_t(u*guide.size())];
+                while (k+1<int_t(table.size()) && u>=table[k]) k++;
+                return k;
+            }
+            // Inversion by sequential search from 0, for a small lambda without a table
+            static int_t invert(real_t u, real_t lambda)
+            {
+                real_t p=std::exp(-lambda), sum=p;
+                int_t k=0;
+                while (u>=sum && p>sum*1e-17){
+                    k++;
+                    p*=lambda/k;
+                    sum+=p;
+                }
+                return k;
+            }
+            // invert(u[i], lambda[i]) for the means below table_limit, e^-lambda being worked out on lanes of
+            // simd::vreal; the others are left to sample_each (n <= 256)
+            static void invert_each(const real_t* u, const real_t* lambda, int_t* out, size_t n);
+            // PTRS with the constants of the given lambda, u being the first uniform
+            template <typename Derived, typename T>
+            static int_t ptrs(DiceForge::StaticGenerator<Derived, T>& rng, real_t u, real_t lambda, real_t lnl,
+                              real_t a, real_t b, real_t inv_alpha, real_t vr)
+            {
+                while (true){
+                    u-=0.5;
+                    real_t v=rng.next_unit();
+                    real_t us=0.5-fabs(u);
+                    int_t k=int_t(floor((2*a/us+b)*u+lambda+0.43));
+                    if (us>=0.07 && v<=vr)
+                        return k;
+                    if (k<0 || (us<0.013 && v>us)){
+                        DF_INSTRUMENT_REJECT("Poisson");
+                        u=rng.next_unit();
+                        continue;
+                    }
+                    if (log(v*inv_alpha/(a/(us*us)+b)) <= -lambda+k*lnl-log_factorial(k))
+                        return k;
+                    DF_INSTRUMENT_REJECT("Poisson");
+                    u=rng.next_unit();
+                }
+            }
         public:
             /// @brief Constructor for the Poisson Distribution
             /// @param lambda lambda (> 0)
+            /// @note Small lambda (< 10) get an inversion table with a guide table, so that a value costs one uniform
+            /// and about one comparison. Larger ones use PTRS, accepting nearly 90% of the first attempts without
+            /// any logarithm.
             Poisson(real_t lambda);
 
             /// @brief Returns the next value of the random variable described by the distribution
-            /// @param rng A random number generator (derived from DiceForge::Generator) 
-            template <typename T>
-            int_t next(DiceForge::Generator<T>& rng)
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            template <typename Derived, typename T>
+            int_t next(DiceForge::StaticGenerator<Derived, T>& rng)
+            {
+                DF_INSTRUMENT_SAMPLES("Poisson", 1);
+                if (!table.empty())
+                    return from_table(rng.next_unit());
+                return ptrs(rng, rng.next_unit(), l, lnl, a, b, inv_alpha, vr);
+            }
+
+            /// @brief Fills the buffer with values of the random variable described by the distribution
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param out Pointer to the first element of the buffer
+            /// @param n Number of values to be written
+            template <typename Derived, typename T>
+            void sample(DiceForge::StaticGenerator<Derived, T>& rng, int_t* out, size_t n)
+            {
+                DF_INSTRUMENT_SAMPLES("Poisson", n);
+                if (table.empty()){
+                    for (size_t i=0; i<n; i++) out[i]=next(rng);
+                    return;
+                }
+                // Uniforms in blocks, looked up in the table
+                real_t u[256];
+                while (n>0){
+                    size_t m=std::min(n,size_t(256));
+                    rng.fill_unit(u,m);
+                    for (size_t i=0; i<m; i++) out[i]=from_table(u[i]);
+                    out+=m;
+                    n-=m;
+                }
+            }
+
+            /// @brief Fills the buffer with one value of each of n Poisson distributions, without constructing them
+            /// @param rng A random number generator (derived from DiceForge::Generator, or a DiceForge::StaticView of one)
+            /// @param lambda Pointer to the n means (>= 0)
+            /// @param out Pointer to the first element of the buffer
+            /// @param n Number of values to be written
+            /// @note Means below 10 are inverted by a sequential search from 0 (one exponential and about lambda
+            /// steps), larger ones go through PTRS with its constants worked out on the spot (a square root
+            /// and a logarithm), both starting from a block of uniforms from fill_unit. The searches run lanes at a
+            /// time, each lane stepping until its own value is found.
+            template <typename Derived, typename T>
+            static void sample_each(DiceForge::StaticGenerator<Derived, T>& rng, const real_t* lambda, int_t* out,
+                                    size_t n)
             {
-                real_t t,x,c;
-                do{
-                    do{
-                        t=tan(M_PI*rng.next_unit());
-                        x=sq*t+l;
-                    } while (x<0);
-                    x=floor(x);
-                    c=0.9*(1+t*t)*exp(x*lnl-lgamma(x+1)-g);
-                } while(rng.next_unit()>c);
-
-                return int_t(x);
+                DF_INSTRUMENT_SAMPLES("Poisson", n);
+                bool valid=true;
+                for (size_t i=0; i<n; i++) valid&=(lambda[i]>=0);
+                if (!valid)
+                    throw std::invalid_argument("Lambda must not be negative!");
+                real_t u[256];
+                while (n>0){
+                    size_t m=std::min(n,size_t(256));
+                    rng.fill_unit(u,m);
+                    invert_each(u,lambda,out,m);
+                    for (size_t i=0; i<m; i++){
+                        const real_t l=lambda[i];
+                        if (l<table_limit) continue;
+                        const real_t b=0.931+2.53*std::sqrt(l), a=-0.059+0.02483*b;
+                        out[i]=ptrs(rng,u[i],l,std::log(l),a,b,1.1239+1.1328/(b-3.4),0.9277-3.6224/(b-2));
+                    }
+                    lambda+=m;
+                    out+=m;
+                    n-=m;
+                }
             }
 
             /// @brief Returns the theoretical variance of the distribution
@@ -51,7 +161,22 @@ namespace DiceForge {
             real_t pmf(int_t x) const override;
 
             /// @brief Cumulative distribution function of the Poisson distribution
+            /// @note A table lookup for small means, the regularized incomplete gamma function Q(x + 1, lambda)
+            /// otherwise
             real_t cdf(int_t x) const override;
+            /// @brief Natural logarithm of the probability mass function of the Poisson distribution
+            real_t logpmf(int_t k) const override;
+            /// @brief Probability mass function of the Poisson distribution at the n locations k, written to out
+            void pmf(const int_t* k, real_t* out, size_t n) const override;
+            /// @brief Logarithm of the probability mass function at the n locations k, written to out
+            void logpmf(const int_t* k, real_t* out, size_t n) const override;
+            /// @brief Cumulative distribution function at the n locations k, written to out
+            void cdf(const int_t* k, real_t* out, size_t n) const override;
+            /// @brief Quantile function of the Poisson distribution, the smallest k with cdf(k) >= p
+            /// @note A binary search of the table for small means, the search of Discrete::quantile on the
+            /// incomplete gamma function otherwise
+            int_t quantile(real_t p) const override;
+            using Discrete::quantile;
     };
 }
 
@@ -1,5 +1,7 @@
 #include "blumblumshub.h"
 #include <numeric>
+#include <algorithm>
+#include <stdexcept>
 
 namespace DiceForge
 {
@@ -36,10 +38,33 @@ namespace DiceForge
         return num;
     }
 
+    void BlumBlumShub32::generate_block(uint32_t* out, size_t n) {
+        // Qualified call, so the whole block is generated without virtual dispatch
+        for (size_t i = 0; i < n; i++)
+            out[i] = BlumBlumShub32::generate();
+    }
+
     void BlumBlumShub32::reseed(uint32_t seed) {
+        reseed_from(SeedSequence(seed));
+    }
+
+    void BlumBlumShub32::reseed_from(const SeedSequence& seq) {
         for(int i = 1; i < 4; i++)
             state.data[i] = 0;
-        state.data[0] = seed;
+        state.data[0] = uint32_t(seq.word(0));
+    }
+
+    void BlumBlumShub32::write_state(detail::StateWriter& out) const {
+        out.tag("BlumBlumShub32");
+        out.put(state.data, 4);
+    }
+
+    void BlumBlumShub32::read_state(detail::StateReader& in) {
+        in.tag("BlumBlumShub32");
+        uint64_t s[4];
+        in.get(s, 4);
+        in.end();
+        std::copy(s, s + 4, state.data);
     }
 
     inline void BlumBlumShub64::propagate(){
@@ -67,11 +92,168 @@ namespace DiceForge
         return num;
     }
 
+    void BlumBlumShub64::generate_block(uint64_t* out, size_t n) {
+        // Qualified call, so the whole block is generated without virtual dispatch
+        for (size_t i = 0; i < n; i++)
+            out[i] = BlumBlumShub64::generate();
+    }
+
     void BlumBlumShub64::reseed(uint64_t seed) {
+        reseed_from(SeedSequence(seed));
+    }
+
+    void BlumBlumShub64::reseed_from(const SeedSequence& seq) {
+        const uint64_t seed = seq.word(0);
         for(int i = 2; i < 4; i++)
             state.data[i] = 0;
         state.data[1] = seed >> 32;
         state.data[0] = seed & 0xFFFFFFFF;
     }
 
-}
\ No newline at end of file
+    void BlumBlumShub64::write_state(detail::StateWriter& out) const {
+        out.tag("BlumBlumShub64");
+        out.put(state.data, 4);
+    }
+
+    void BlumBlumShub64::read_state(detail::StateReader& in) {
+        in.tag("BlumBlumShub64");
+        uint64_t s[4];
+        in.get(s, 4);
+        in.end();
+        std::copy(s, s + 4, state.data);
+    }
+
+    namespace
+    {
+        // -1/n modulo 2^64 for an odd n, by Newton's iteration (each step doubles the correct low bits)
+        constexpr uint64_t montgomery_inverse(uint64_t n)
+        {
+            uint64_t inv = n;   // correct to 3 bits, since n * n = 1 mod 8
+            for (int i = 0; i < 5; i++)
+                inv *= 2 - n * inv;
+            return 0 - inv;
+        }
+
+        // b^e modulo m (m < 2^64)
+        uint64_t powmod(uint64_t b, uint64_t e, uint64_t m)
+        {
+            uint64_t result = 1 % m;
+            for (b %= m; e > 0; e >>= 1)
+            {
+                if (e & 1)
+                    result = (uint128_t(result) * b) % m;
+                b = (uint128_t(b) * b) % m;
+            }
+            return result;
+        }
+    }
+
+    template <typename UIntType>
+    const uint64_t BlumBlumShubMontgomery<UIntType>::p = 4294967291;
+    template <typename UIntType>
+    const uint64_t BlumBlumShubMontgomery<UIntType>::q = 4294967279;
+    template <typename UIntType>
+    const uint64_t BlumBlumShubMontgomery<UIntType>::n = 4294967291ULL * 4294967279ULL;
+    template <typename UIntType>
+    const uint64_t BlumBlumShubMontgomery<UIntType>::n_inv = montgomery_inverse(4294967291ULL * 4294967279ULL);
+    template <typename UIntType>
+    const uint64_t BlumBlumShubMontgomery<UIntType>::r2 = ((~uint128_t(0)) % (4294967291ULL * 4294967279ULL) + 1) % (4294967291ULL * 4294967279ULL);
+
+    template <typename UIntType>
+    const uint64_t BlumBlumShubMontgomery<UIntType>::lambda = (4294967290ULL * 4294967278ULL) / std::gcd(4294967290ULL, 4294967278ULL);
+
+    template <typename UIntType>
+    inline uint64_t BlumBlumShubMontgomery<UIntType>::redc(uint128_t t){
+        // t + m*n is divisible by 2^64; its low halves sum to 2^64 unless both are zero
+        uint64_t m = uint64_t(t) * n_inv;
+        uint128_t r = (t >> 64) + ((uint128_t(m) * n) >> 64) + (uint64_t(t) != 0);
+        return (r >= n) ? uint64_t(r - n) : uint64_t(r);
+    }
+
+    template <typename UIntType>
+    inline uint64_t BlumBlumShubMontgomery<UIntType>::propagate(){
+        state = redc(uint128_t(state) * state);
+        // Bits are taken from the state itself, not from its Montgomery form
+        return redc(state) & ((1ULL << bits_per_step) - 1);
+    }
+
+    template <typename UIntType>
+    BlumBlumShubMontgomery<UIntType>::BlumBlumShubMontgomery(UIntType seed, int bits_per_step): bits_per_step(bits_per_step){
+        if (bits_per_step < 1 || bits_per_step > 32)
+            throw std::invalid_argument("Expected 1 <= bits_per_step <= 32");
+        reseed(seed);
+    }
+
+    template <typename UIntType>
+    UIntType BlumBlumShubMontgomery<UIntType>::generate() {
+        // Bits of the first squaring that do not fit are shifted out at the top
+        uint64_t num = 0;
+        for (int filled = 0; filled < int(8 * sizeof(UIntType)); filled += bits_per_step)
+            num = (num << bits_per_step) | propagate();
+        return UIntType(num);
+    }
+
+    template <typename UIntType>
+    void BlumBlumShubMontgomery<UIntType>::generate_block(UIntType* out, size_t n) {
+        // Qualified call, so the whole block is generated without virtual dispatch
+        for (size_t i = 0; i < n; i++)
+            out[i] = BlumBlumShubMontgomery::generate();
+    }
+
+    template <typename UIntType>
+    void BlumBlumShubMontgomery<UIntType>::jump_ahead(uint64_t steps) {
+        // Every output takes ceil(bits / bits_per_step) squarings, so the state is raised to
+        // 2^(squarings * steps), an exponent that only matters modulo lambda as the state is coprime to n
+        uint64_t squarings = (8 * sizeof(UIntType) + bits_per_step - 1) / bits_per_step;
+        uint64_t e = powmod(powmod(2, squarings, lambda), steps, lambda);
+        // Montgomery square-and-multiply, starting from 1 in Montgomery form
+        uint64_t result = redc(r2), base = state;
+        for (; e > 0; e >>= 1)
+        {
+            if (e & 1)
+                result = redc(uint128_t(result) * base);
+            base = redc(uint128_t(base) * base);
+        }
+        state = result;
+    }
+
+    template <typename UIntType>
+    void BlumBlumShubMontgomery<UIntType>::reseed(UIntType seed) {
+        reseed_from(SeedSequence(seed));
+    }
+
+    template <typename UIntType>
+    void BlumBlumShubMontgomery<UIntType>::reseed_from(const SeedSequence& seq) {
+        uint64_t x = seq.word(0) % n;
+        // The seed must be coprime to n, and its square must not be 1 (or the state gets stuck at 1)
+        while (x < 2 || std::gcd(x, n) != 1 || (uint128_t(x) * x) % n == 1)
+            x = (x + 1) % n;
+        // Start from the square of the seed, in Montgomery form
+        state = redc(uint128_t((uint128_t(x) * x) % n) * r2);
+    }
+
+    // bits_per_step is saved with the state, as it decides how the states are cut into outputs
+    template <typename UIntType>
+    void BlumBlumShubMontgomery<UIntType>::write_state(detail::StateWriter& out) const {
+        out.tag("BlumBlumShubMontgomery");
+        out.put(uint8_t(sizeof(UIntType)));
+        out.put(state);
+        out.put(uint8_t(bits_per_step));
+    }
+
+    template <typename UIntType>
+    void BlumBlumShubMontgomery<UIntType>::read_state(detail::StateReader& in) {
+        in.tag("BlumBlumShubMontgomery");
+        in.expect(uint8_t(sizeof(UIntType)));
+        const uint64_t s = in.get<uint64_t>();
+        const int bits = in.get<uint8_t>();
+        if (s >= n || bits < 1 || bits > 32)
+            throw std::invalid_argument("The saved state does not fit this object");
+        in.end();
+        state = s;
+        bits_per_step = bits;
+    }
+
+    template class BlumBlumShubMontgomery<uint32_t>;
+    template class BlumBlumShubMontgomery<uint64_t>;
+}
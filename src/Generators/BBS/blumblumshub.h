@@ -12,6 +12,7 @@ namespace DiceForge
      */
     class BlumBlumShub32 : public Generator<uint32_t>
     {
+        friend class StaticView<BlumBlumShub32>;
         private:
             static const uint64_t p;
             static const uint64_t q;
@@ -30,18 +31,40 @@ namespace DiceForge
              */
             uint32_t generate() override;
 
+            /**
+             * @brief generate_block - Fills the buffer with random numbers using the Blum-Blum-Shub algorithm
+             * @param out Pointer to the first element of the buffer
+             * @param n Number of random numbers to be generated
+             */
+            void generate_block(uint32_t* out, size_t n) override;
+
             /**
              * @brief reseed - Reseeds the generator with a new seed
              * @param seed The new seed value
-             * @note if the seed is zero then a non-zero seed is adopted by default
+             * @note the state is expanded from the seed by DiceForge::SeedSequence, for any seed (zero included)
              */
             void reseed(uint32_t seed) override;
 
+            /**
+             * @brief reseed_from - Reseeds the generator from seed material of any length
+             */
+            void reseed_from(const SeedSequence& seq) override;
+
+            /**
+             * @brief write_state - Saves the internal state
+             */
+            void write_state(detail::StateWriter& out) const override;
+
+            /**
+             * @brief read_state - Restores the internal state saved by write_state
+             */
+            void read_state(detail::StateReader& in) override;
+
         public:
             /**
              * @brief Constructor for BlumBlumShub32
              * @param seed The initial seed value
-             * @note if the seed is zero then a non-zero seed is adopted by default
+             * @note the state is expanded from the seed by DiceForge::SeedSequence, for any seed (zero included)
              */
             BlumBlumShub32(uint32_t seed);
 
@@ -57,6 +80,7 @@ namespace DiceForge
      */
     class BlumBlumShub64 : public Generator<uint64_t>
     {
+        friend class StaticView<BlumBlumShub64>;
         private:
             static const uint64_t p;
             static const uint64_t q;
@@ -75,18 +99,40 @@ namespace DiceForge
              */
             uint64_t generate() override;
 
+            /**
+             * @brief generate_block - Fills the buffer with random numbers using the Blum-Blum-Shub algorithm
+             * @param out Pointer to the first element of the buffer
+             * @param n Number of random numbers to be generated
+             */
+            void generate_block(uint64_t* out, size_t n) override;
+
             /**
              * @brief reseed - Reseeds the generator with a new seed
              * @param seed The new seed value
-             * @note if the seed is zero then a non-zero seed is adopted by default
+             * @note the state is expanded from the seed by DiceForge::SeedSequence, for any seed (zero included)
              */
             void reseed(uint64_t seed) override;
 
+            /**
+             * @brief reseed_from - Reseeds the generator from seed material of any length
+             */
+            void reseed_from(const SeedSequence& seq) override;
+
+            /**
+             * @brief write_state - Saves the internal state
+             */
+            void write_state(detail::StateWriter& out) const override;
+
+            /**
+             * @brief read_state - Restores the internal state saved by write_state
+             */
+            void read_state(detail::StateReader& in) override;
+
         public:
             /**
              * @brief Constructor for BlumBlumShub64
              * @param seed The initial seed value
-             * @note if the seed is zero then a non-zero seed is adopted by default
+             * @note the state is expanded from the seed by DiceForge::SeedSequence, for any seed (zero included)
              */
             BlumBlumShub64(uint64_t seed);
 
@@ -96,6 +142,105 @@ namespace DiceForge
             ~BlumBlumShub64() = default;
     };
 
+    /**
+     * @brief DiceForge::BlumBlumShubMontgomery - A RNG utilizing the Blum-Blum-Shub algorithm,
+     * with the squarings done in Montgomery form using native 128-bit products
+     * @tparam UIntType uint32_t or uint64_t, the type of the generated integers
+     * @note Unlike BlumBlumShub32/64 the state is squared exactly modulo n = p*q, and up to
+     * bits_per_step low bits of every state are used (log2 log2 n = 6 by default)
+     */
+    template <typename UIntType>
+    class BlumBlumShubMontgomery : public Generator<UIntType>
+    {
+        friend class StaticView<BlumBlumShubMontgomery>;
+        private:
+            static const uint64_t p;
+            static const uint64_t q;
+            static const uint64_t n;
+            static const uint64_t n_inv;    // -1/n modulo 2^64
+            static const uint64_t r2;       // 2^128 modulo n
+            static const uint64_t lambda;   // lcm(p-1, q-1), the exponent of the group of units modulo n
+
+            uint64_t state;     // Internal state (in Montgomery form, state = x * 2^64 mod n)
+            int bits_per_step;  // Number of bits extracted from every state
+
+            /**
+             * @brief redc - Montgomery reduction
+             * @return t / 2^64 modulo n
+             */
+            static uint64_t redc(uint128_t t);
+
+            /**
+             * @brief propagate - Advances the internal state using the Blum-Blum-Shub algorithm
+             * @return The low bits_per_step bits of the new state
+             */
+            uint64_t propagate();
+
+            /**
+             * @brief generate - Generates a random number using the Blum-Blum-Shub algorithm
+             * @return The generated random number
+             */
+            UIntType generate() override;
+
+            /**
+             * @brief generate_block - Fills the buffer with random numbers using the Blum-Blum-Shub algorithm
+             * @param out Pointer to the first element of the buffer
+             * @param n Number of random numbers to be generated
+             */
+            void generate_block(UIntType* out, size_t n) override;
+
+            /**
+             * @brief jump_ahead - Skips the given number of outputs
+             * @note The state after s squarings is x^(2^s) mod n, and 2^s is reduced modulo lcm(p-1, q-1)
+             */
+            void jump_ahead(uint64_t steps) override;
+            bool fast_jump() const override { return true; }
+
+            /**
+             * @brief reseed - Reseeds the generator with a new seed
+             * @param seed The new seed value
+             * @note the state is expanded from the seed by DiceForge::SeedSequence, for any seed (zero included)
+             */
+            void reseed(UIntType seed) override;
+
+            /**
+             * @brief reseed_from - Reseeds the generator from seed material of any length
+             */
+            void reseed_from(const SeedSequence& seq) override;
+
+            /**
+             * @brief write_state - Saves the internal state
+             */
+            void write_state(detail::StateWriter& out) const override;
+
+            /**
+             * @brief read_state - Restores the internal state saved by write_state
+             */
+            void read_state(detail::StateReader& in) override;
+
+        public:
+            /**
+             * @brief Constructor for BlumBlumShubMontgomery
+             * @param seed The initial seed value
+             * @param bits_per_step Number of bits taken from every squaring, between 1 and 32. At most
+             * log2 log2 n = 6 bits keeps the security argument of the algorithm; more bits trade it for speed
+             * @note the state is expanded from the seed by DiceForge::SeedSequence, for any seed (zero included)
+             */
+            BlumBlumShubMontgomery(UIntType seed, int bits_per_step = 6);
+
+            /**
+             * @brief Destructor for BlumBlumShubMontgomery
+             */
+            ~BlumBlumShubMontgomery() = default;
+    };
+
+    // The members are compiled once in blumblumshub.cpp for these two engines
+    extern template class BlumBlumShubMontgomery<uint32_t>;
+    extern template class BlumBlumShubMontgomery<uint64_t>;
+
+    typedef BlumBlumShubMontgomery<uint32_t> BlumBlumShubMontgomery32;
+    typedef BlumBlumShubMontgomery<uint64_t> BlumBlumShubMontgomery64;
+
     // Typedef for convenience
 
     typedef BlumBlumShub64 BlumBlumShub;
@@ -0,0 +1,246 @@
+#ifndef DF_BUFFERED_H
+#define DF_BUFFERED_H
+
+#include "generator.h"
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+namespace DiceForge {
+    /// @brief DiceForge::BufferedGenerator<Engine> - Draws the random integers of a slow RNG ahead of time, into a
+    /// ring buffer
+    /// @tparam Engine RNG derived from Generator<T> (like BlumBlumShub64 or NaorReingold)
+    /// @note With a background thread, the thread fills the ring in chunks while the consumer reads it, so bursts of
+    /// draws are served from memory as long as the ring holds them. Without one, the ring is refilled in a single
+    /// bulk call whenever it runs dry. Either way the integers are those of the engine, in order.
+    /// @note The ring is a single producer, single consumer queue: only one thread may draw from the generator.
+    /// The fast path of next() is a compare, a load and an increment; the consumer publishes its position and the
+    /// producer sleeps or wakes up only once per chunk.
+    /// @note A saved state holds the state of the engine and the integers still in the ring, so the restored
+    /// generator hands out the same sequence (the ring must be large enough for them).
+    template <typename Engine>
+    class BufferedGenerator : public Generator<typename Engine::result_type>
+    {
+        typedef typename Engine::result_type T;
+        friend class StaticView<BufferedGenerator>;
+    private:
+        Engine engine;
+        const size_t capacity, mask, chunk;
+        const bool background;
+        std::unique_ptr<T[]> ring;
+        // Consumer side: next position to read and the end of what it may read without looking at the producer
+        uint64_t read = 0, limit = 0;
+        // Positions shared by the two sides, on lines of their own
+        alignas(64) std::atomic<uint64_t> head{0};   // everything before it has been read
+        alignas(64) std::atomic<uint64_t> tail{0};   // everything before it has been written
+        alignas(64) std::atomic<bool> sleeping{false}, stopping{false};
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::thread producer;
+
+        static size_t ring_size(size_t n)
+        {
+            if (n == 0)
+                throw std::invalid_argument("Expected a ring of at least one integer");
+            size_t s = 2;
+            while (s < n)
+                s *= 2;
+            return s;
+        }
+        void produce()
+        {
+            while (true) {
+                const uint64_t t = tail.load(std::memory_order_relaxed);
+                if (t + chunk - head.load() > capacity) {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    sleeping.store(true);
+                    wake.wait(lock, [&]() { return stopping.load() || t + chunk - head.load() <= capacity; });
+                    sleeping.store(false);
+                }
+                if (stopping.load())
+                    return;
+                if (t + chunk - head.load() <= capacity) {
+                    engine.fill(ring.get() + (t & mask), chunk);
+                    tail.store(t + chunk, std::memory_order_release);
+                }
+            }
+        }
+        void start()
+        {
+            if (background) {
+                stopping.store(false);
+                producer = std::thread(&BufferedGenerator::produce, this);
+            }
+        }
+        void stop()
+        {
+            if (producer.joinable()) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stopping.store(true);
+                }
+                wake.notify_one();
+                producer.join();
+            }
+        }
+        // Called when read reaches limit: hands the space read so far back to the producer and waits for more
+        void refill()
+        {
+            if (!background) {
+                engine.fill(ring.get(), capacity);
+                read = 0;
+                limit = capacity;
+                return;
+            }
+            head.store(read);
+            if (sleeping.load()) {
+                std::lock_guard<std::mutex> lock(mutex);
+                wake.notify_one();
+            }
+            uint64_t t;
+            while ((t = tail.load(std::memory_order_acquire)) == read)
+                std::this_thread::yield();
+            // At most a chunk at a time, so the producer gets space back while the consumer is still reading
+            limit = std::min(t, read + chunk);
+        }
+        T generate() override
+        {
+            if (read == limit)
+                refill();
+            return ring[read++ & mask];
+        }
+        void generate_block(T* out, size_t n) override
+        {
+            while (n > 0) {
+                if (read == limit)
+                    refill();
+                size_t m = std::min<uint64_t>({n, limit - read, capacity - (read & mask)});
+                std::copy(ring.get() + (read & mask), ring.get() + (read & mask) + m, out);
+                read += m;
+                out += m;
+                n -= m;
+            }
+        }
+        void jump_ahead(uint64_t steps) override
+        {
+            stop();
+            // What is in the ring is skipped first, the rest by the engine
+            const uint64_t buffered = (background ? tail.load() : limit) - read;
+            if (steps <= buffered)
+                read += steps;
+            else {
+                engine.jump(steps - buffered);
+                discard();
+            }
+            limit = background ? std::min(tail.load(), read + chunk) : limit;
+            start();
+        }
+        bool fast_jump() const override
+        {
+            return engine.has_fast_jump();
+        }
+        void reseed(T seed) override
+        {
+            stop();
+            engine.reset_seed(seed);
+            discard();
+            start();
+        }
+        void reseed_from(const SeedSequence& seq) override
+        {
+            stop();
+            engine.reset_seed(seq);
+            discard();
+            start();
+        }
+        void discard()
+        {
+            read = limit = 0;
+            head.store(0);
+            tail.store(0);
+        }
+        // The state of the engine followed by the integers of the ring that are still to be read
+        void write_state(detail::StateWriter& out) const override
+        {
+            // The producer is paused so that the engine and the ring agree (saving does not change the values)
+            BufferedGenerator& self = const_cast<BufferedGenerator&>(*this);
+            self.stop();
+            std::vector<unsigned char> state;
+            std::vector<T> buffered;
+            try {
+                state = engine.save_state();
+                const uint64_t end = background ? tail.load() : limit;
+                for (uint64_t i = read; i < end; i++)
+                    buffered.push_back(ring[i & mask]);
+            }
+            catch (...) {
+                self.start();
+                throw;
+            }
+            self.start();
+            out.tag("BufferedGenerator");
+            out.bytes(state.data(), state.size());
+            out.put(uint64_t(buffered.size()));
+            out.put(buffered.data(), buffered.size());
+        }
+        void read_state(detail::StateReader& in) override
+        {
+            in.tag("BufferedGenerator");
+            const unsigned char* state;
+            const size_t size = in.bytes(state);
+            const uint64_t count = in.get<uint64_t>();
+            // The producer writes whole chunks, so the integers are put right before a chunk boundary
+            const uint64_t base = background ? (chunk - count % chunk) % chunk : 0;
+            if (count > capacity - base || count > in.remaining() / sizeof(T))
+                throw std::invalid_argument("The saved state holds more integers than the ring");
+            std::vector<T> buffered(count);
+            in.get(buffered.data(), count);
+            in.end();
+            stop();
+            try {
+                engine.load_state(state, size);
+                std::copy(buffered.begin(), buffered.end(), ring.get() + base);
+            }
+            catch (...) {
+                start();
+                throw;
+            }
+            read = base;
+            head.store(base);
+            tail.store(base + count);
+            limit = background ? std::min(base + count, base + chunk) : count;
+            start();
+        }
+    public:
+        /// @brief Wraps a copy of the given RNG
+        /// @param engine RNG whose integers are buffered
+        /// @param capacity size of the ring, in random integers (rounded up to a power of two, at least 2 chunks)
+        /// @param background true to fill the ring on a thread of its own, false to refill it in bulk on demand
+        BufferedGenerator(const Engine& engine, size_t capacity = 65536, bool background = true)
+            : engine(engine), capacity(ring_size(capacity)), mask(this->capacity - 1),
+              chunk(std::min<size_t>(4096, this->capacity / 2)), background(background),
+              ring(new T[this->capacity])
+        {
+            start();
+        }
+        BufferedGenerator(const BufferedGenerator&) = delete;
+        BufferedGenerator& operator=(const BufferedGenerator&) = delete;
+        /// @brief Stops the background thread
+        ~BufferedGenerator()
+        {
+            stop();
+        }
+        /// @brief Number of random integers the ring holds
+        size_t size() const
+        {
+            return capacity;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,147 @@
+#include "Halton.h"
+#include <stdexcept>
+
+namespace DiceForge
+{
+    Halton::Halton(unsigned dimensions, uint64_t seed) : m_dimensions(dimensions)
+    {
+        if (dimensions == 0)
+            throw std::invalid_argument("Expected at least 1 dimension");
+
+        // the first primes, by trial division
+        for (uint64_t p = 2; m_bases.size() < dimensions; p++)
+        {
+            bool prime = true;
+            for (uint64_t q : m_bases)
+            {
+                if (q * q > p)
+                    break;
+                if (p % q == 0)
+                {
+                    prime = false;
+                    break;
+                }
+            }
+            if (prime)
+                m_bases.push_back(p);
+        }
+
+        // digit k is worth b^-(k+1), or floor(2^64 / b^(k+1)) as a 64 bit fraction
+        m_scale.assign(size_t(dimensions) * max_digits, 0);
+        for (unsigned j = 0; j < dimensions; j++)
+        {
+            uint128_t power = m_bases[j];
+            for (int k = 0; k < max_digits && (power >> 64) == 0; k++, power *= m_bases[j])
+                m_scale[size_t(j) * max_digits + k] = uint64_t((uint128_t(1) << 64) / power);
+        }
+
+        m_multiplier.assign(size_t(dimensions) * max_digits, 1);
+        m_addend.assign(size_t(dimensions) * max_digits, 0);
+        m_digits.assign(size_t(dimensions) * max_digits, 0);
+        m_point.assign(dimensions, 0);
+        reseed(seed);
+    }
+
+    void Halton::reseed(uint64_t seed)
+    {
+        m_seed = seed;
+        uint64_t x = seed;
+        for (unsigned j = 0; j < m_dimensions; j++)
+        {
+            const uint64_t b = m_bases[j];
+            for (int k = 0; k < max_digits; k++)
+            {
+                const size_t i = size_t(j) * max_digits + k;
+                m_multiplier[i] = seed == 0 ? 1 : 1 + splitmix64(x) % (b - 1);
+                m_addend[i] = seed == 0 ? 0 : splitmix64(x) % b;
+            }
+        }
+        seek(0);
+    }
+
+    void Halton::write_state(detail::StateWriter& out) const
+    {
+        out.tag("Halton");
+        out.put(uint32_t(m_dimensions));
+        out.put(m_seed);
+        out.put(position());
+    }
+
+    void Halton::read_state(detail::StateReader& in)
+    {
+        in.tag("Halton");
+        in.expect(uint32_t(m_dimensions));
+        const uint64_t seed = in.get<uint64_t>();
+        const uint64_t i = in.get<uint64_t>();
+        in.end();
+        reseed(seed);
+        seek(i);
+    }
+
+    void Halton::seek(uint64_t i)
+    {
+        m_index = i / m_dimensions;
+        m_coordinate = unsigned(i % m_dimensions);
+        for (unsigned j = 0; j < m_dimensions; j++)
+        {
+            const uint64_t b = m_bases[j];
+            const size_t first = size_t(j) * max_digits;
+            uint64_t n = m_index, x = 0;
+            for (int k = 0; k < max_digits; k++, n /= b)
+            {
+                m_digits[first + k] = n % b;
+                x += (m_multiplier[first + k] * (n % b) + m_addend[first + k]) % b * m_scale[first + k];
+            }
+            m_point[j] = x;
+        }
+    }
+
+    void Halton::jump_ahead(uint64_t steps)
+    {
+        seek(position() + steps);
+    }
+
+    void Halton::advance()
+    {
+        for (unsigned j = 0; j < m_dimensions; j++)
+        {
+            const uint64_t b = m_bases[j];
+            const size_t first = size_t(j) * max_digits;
+            uint64_t x = m_point[j];
+            // add one with carry, updating the coordinate by the change of every digit (modulo 2^64)
+            for (size_t i = first; i < first + max_digits; i++)
+            {
+                const uint64_t f = m_multiplier[i], g = m_addend[i], d = m_digits[i];
+                const uint64_t old = (f * d + g) % b;
+                m_digits[i] = d + 1 == b ? 0 : d + 1;
+                x += ((f * m_digits[i] + g) % b - old) * m_scale[i];
+                if (m_digits[i] != 0)
+                    break;
+            }
+            m_point[j] = x;
+        }
+        m_index++;
+        m_coordinate = 0;
+    }
+
+    void Halton::generate_block(uint64_t* out, size_t n)
+    {
+        // Finish the current point, then write whole points straight to the buffer
+        while (n > 0 && m_coordinate < m_dimensions)
+        {
+            *out++ = m_point[m_coordinate++];
+            n--;
+        }
+        while (n >= m_dimensions)
+        {
+            advance();
+            for (unsigned j = 0; j < m_dimensions; j++)
+                out[j] = m_point[j];
+            m_coordinate = m_dimensions;
+            out += m_dimensions;
+            n -= m_dimensions;
+        }
+        for (size_t i = 0; i < n; i++)
+            out[i] = Halton::generate();
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef DF_HALTON_H
+#define DF_HALTON_H
+
+#include "generator.h"
+#include <vector>
+
+namespace DiceForge
+{
+    /// @brief DiceForge::Halton - The Halton low-discrepancy sequence, optionally scrambled
+    /// @note Coordinate j of point n is the radical inverse of n in the j-th prime base: its base b digits
+    /// mirrored about the radix point. The coordinates are handed out like those of Sobol (point 0 in all
+    /// dimensions, then point 1, ...), as 64 bit fractions, so fill_unit(x, dimensions()) or next_point(x) draws
+    /// one point of the unit cube.
+    /// @note Every point is updated from the previous one by incrementing the digits of the index, and jump() /
+    /// seek() compute any point directly, so that threads can take disjoint ranges of points.
+    /// @note The plain sequence shows strong correlations between high dimensions with large bases; scrambling
+    /// replaces digit d at position k of dimension j by (f_jk * d + g_jk) mod b for random f_jk != 0 and g_jk,
+    /// which breaks them up while keeping the low discrepancy.
+    class Halton : public Generator<uint64_t>
+    {
+        friend class StaticView<Halton>;
+    private:
+        // Digits of the index per dimension, enough for any 64 bit index in base 2
+        static constexpr int max_digits = 64;
+        unsigned m_dimensions;
+        std::vector<uint64_t> m_bases;       // Prime base of each dimension
+        std::vector<uint64_t> m_scale;       // floor(2^64 / b^(k+1)), max_digits per dimension
+        std::vector<uint64_t> m_multiplier;  // Scrambling of each digit position, f_jk (1 when not scrambled)
+        std::vector<uint64_t> m_addend;      // and g_jk (0 when not scrambled)
+        std::vector<uint64_t> m_digits;      // Digits of m_index in the base of each dimension, lowest first
+        std::vector<uint64_t> m_point;       // Coordinates of point m_index
+        uint64_t m_index;                    // Index of the current point
+        unsigned m_coordinate;               // Next coordinate of the current point to be handed out
+        uint64_t m_seed;                     // Seed of the scrambling
+        // Moves on to the next point by incrementing the digits of the index
+        void advance();
+        uint64_t generate() override;
+        void generate_block(uint64_t* out, size_t n) override;
+        // Computes the point reached directly from the digits of its index
+        void jump_ahead(uint64_t steps) override;
+        bool fast_jump() const override { return true; }
+        void reseed(uint64_t seed) override;
+        // Saves the seed and the position, from which load_state rebuilds the scrambling and the point
+        void write_state(detail::StateWriter& out) const override;
+        void read_state(detail::StateReader& in) override;
+    public:
+        /// @brief Initializes the sequence in the given number of dimensions
+        /// @param dimensions number of coordinates of every point (at least 1), dimension j taking the j-th prime
+        /// as its base
+        /// @param seed 0 for the plain Halton sequence, any other seed for a scrambled one (see above)
+        Halton(unsigned dimensions, uint64_t seed = 0);
+        /// @brief Number of coordinates of every point
+        unsigned dimensions() const
+        {
+            return m_dimensions;
+        }
+        /// @brief Writes the next point of the unit cube to x (dimensions() reals)
+        void next_point(real_t* x)
+        {
+            fill_unit(x, m_dimensions);
+        }
+        /// @brief Returns the index of the next element of the stream
+        uint64_t position() const
+        {
+            return m_index * m_dimensions + m_coordinate;
+        }
+        /// @brief Moves to element i of the stream, e.g. seek(k * dimensions()) to start from point k
+        /// @param i index of the element
+        void seek(uint64_t i);
+        /// @brief Default destructor
+        ~Halton() = default;
+    };
+
+    // Defined here so that it can be inlined through StaticView<Halton>
+    inline uint64_t Halton::generate()
+    {
+        if (m_coordinate == m_dimensions)
+            advance();
+        return m_point[m_coordinate++];
+    }
+}
+
+#endif
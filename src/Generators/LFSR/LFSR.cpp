@@ -1,48 +1,150 @@
 #include "LFSR.h"
-#include <chrono>
 
 namespace DiceForge
 {
+    /*
+    Both LFSRs share one 128-bit Fibonacci register, curr_seed1 (upper half) : curr_seed2 (lower half).
+    Reading it as the bits b[t], ..., b[t + 127] of a sequence (b[t] being the lowest), every step
+    shifts it right and feeds in b[t + 128] = b[t] ^ b[t + 1] ^ b[t + 2] ^ b[t + 7], and outputs the
+    new lowest bit. Since all the taps lie in the lowest 8 bits, the next 64 bits of the sequence only
+    depend on bits already in the register, so a whole word of steps is a handful of shifts and xors.
+    */
+    namespace
+    {
+        // Feedback polynomial x^128 + x^7 + x^2 + x + 1, without its x^128 term
+        const uint128_t feedback = 0x87;
+
+        // The next 64 bits of the sequence, b[t + 128], ..., b[t + 191]
+        inline uint64_t feedback_word(uint64_t s1, uint64_t s2)
+        {
+            return s2 ^ ((s2 >> 1) | (s1 << 63)) ^ ((s2 >> 2) | (s1 << 62)) ^ ((s2 >> 7) | (s1 << 57));
+        }
+
+        // Reverses the order of the bits of x
+        inline uint64_t reverse_bits(uint64_t x)
+        {
+            x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+            x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+            x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+            x = ((x >> 8) & 0x00FF00FF00FF00FFULL) | ((x & 0x00FF00FF00FF00FFULL) << 8);
+            x = ((x >> 16) & 0x0000FFFF0000FFFFULL) | ((x & 0x0000FFFF0000FFFFULL) << 16);
+            return (x >> 32) | (x << 32);
+        }
+
+        // Product of the polynomials a and b over GF(2), modulo the feedback polynomial
+        uint128_t polymulmod(uint128_t a, uint128_t b)
+        {
+            uint128_t r = 0;
+            for (int i = 127; i >= 0; i--)
+            {
+                r = (r << 1) ^ ((r >> 127) ? feedback : 0);
+                if ((b >> i) & 1)
+                    r ^= a;
+            }
+            return r;
+        }
+
+        // base^e modulo the feedback polynomial
+        uint128_t polypowmod(uint128_t base, uint64_t e)
+        {
+            uint128_t result = 1;
+            for (; e > 0; e >>= 1)
+            {
+                if (e & 1)
+                    result = polymulmod(result, base);
+                base = polymulmod(base, base);
+            }
+            return result;
+        }
+
+        // x^(steps * step_bits) modulo the feedback polynomial. Its coefficients c[j] give the register that
+        // many steps ahead as the xor of the registers j steps ahead for which c[j] = 1 (j < 128)
+        uint128_t jump_polynomial(uint64_t steps, uint64_t step_bits = 1)
+        {
+            return polypowmod(polypowmod(2, step_bits), steps);
+        }
+
+        // Advances the register by the steps that the jump polynomial was computed for
+        void jump_register(uint64_t& s1, uint64_t& s2, uint128_t poly)
+        {
+            // 256 bits of the sequence, enough for the registers up to 127 steps ahead
+            uint64_t w[4] = {s2, s1, 0, 0};
+            w[2] = feedback_word(w[1], w[0]);
+            w[3] = feedback_word(w[2], w[1]);
+            // 64 bits of the sequence starting at bit o of w
+            auto word = [&w](int o) { return (o % 64 == 0) ? w[o / 64] : (w[o / 64] >> (o % 64)) | (w[o / 64 + 1] << (64 - o % 64)); };
+
+            uint64_t r1 = 0, r2 = 0;
+            for (int j = 0; j < 128; j++)
+            {
+                if ((poly >> j) & 1)
+                {
+                    r2 ^= word(j);
+                    r1 ^= word(j + 64);
+                }
+            }
+            s1 = r1;
+            s2 = r2;
+        }
+
+        // Fills the register with the first two words of the expansion that are not both zero (the all-zero register
+        // would stay zero). Being well mixed already, it needs no warm-up.
+        void seed_register(uint64_t& s1, uint64_t& s2, const SeedSequence& seq)
+        {
+            size_t i = 0;
+            do {
+                s1 = seq.word(i++);
+                s2 = seq.word(i++);
+            } while (s1 == 0 && s2 == 0);
+        }
+    }
+
     LFSR64::LFSR64(uint64_t seed)
     {
         reseed(seed);
     }
 
     uint64_t LFSR64::generate() {
-        uint64_t rand_num = 0;
-        uint64_t new_bit;
-
-        // For each bit to generate in rand_num,
-        for (int i = 0; i < 64; i++) {
-            // Calculate (by the series of taps) the new bit to be added to left of curr_seed
-            new_bit = (curr_seed2 ^ (curr_seed2 >> 1) ^ (curr_seed2 >> 2) ^ (curr_seed2 >> 7)) & 1;
-            // Shift curr_seed (both parts) to the right, and change the leftmost bit to new_bit
-            curr_seed2 = (curr_seed2 >> 1) | (curr_seed1 << 63);
-            curr_seed1 = (curr_seed1 >> 1) | (new_bit << 63);
-            // Take the last bit of curr_seed as the output, and add it to the right of rand_num
-            rand_num = rand_num * 2 + (curr_seed2 & 1);
-        }
+        // The 64 output bits are the register bits 1 to 64, taken lowest first into the highest bit of rand_num
+        uint64_t rand_num = reverse_bits((curr_seed2 >> 1) | (curr_seed1 << 63));
+        // Advance the register by 64 steps at once
+        uint64_t new_bits = feedback_word(curr_seed1, curr_seed2);
+        curr_seed2 = curr_seed1;
+        curr_seed1 = new_bits;
         return rand_num * 0x2545F4914F6CDD1DULL;
     }
 
+    void LFSR64::generate_block(uint64_t* out, size_t n) {
+        // Qualified call, so the whole block is generated without virtual dispatch
+        for (size_t i = 0; i < n; i++)
+            out[i] = LFSR64::generate();
+    }
+
+    void LFSR64::jump_ahead(uint64_t steps) {
+        // Each output advances the register by 64 steps
+        jump_register(curr_seed1, curr_seed2, jump_polynomial(steps, 64));
+    }
+
     void LFSR64::reseed(uint64_t seed) {
-        // If seed is zero, RNG will get stuck at zero. So set both parts of curr_seed to current times
-        if (seed == 0){
-            curr_seed1 = std::chrono::high_resolution_clock::now().time_since_epoch().count();
-            curr_seed2 = std::chrono::high_resolution_clock::now().time_since_epoch().count();
-        }
-        // If non-zero seed given, set both parts of curr_seed to that value
-        else {
-            curr_seed1 = seed;
-            curr_seed2 = seed;
-        }
-        // Important: First 128 bits generated will simply be curr_seed in reverse
-        // Get them out of the way while reseeding
-        generate();
-        generate();
-        for (int i = 0; i < 100; i++){
-            generate();
-        }
+        reseed_from(SeedSequence(seed));
+    }
+
+    void LFSR64::reseed_from(const SeedSequence& seq) {
+        seed_register(curr_seed1, curr_seed2, seq);
+    }
+
+    void LFSR64::write_state(detail::StateWriter& out) const {
+        out.tag("LFSR64");
+        out.put(curr_seed1);
+        out.put(curr_seed2);
+    }
+
+    void LFSR64::read_state(detail::StateReader& in) {
+        in.tag("LFSR64");
+        const uint64_t s1 = in.get<uint64_t>(), s2 = in.get<uint64_t>();
+        in.end();
+        curr_seed1 = s1;
+        curr_seed2 = s2;
     }
 
     DiceForge::LFSR32::LFSR32(uint32_t seed)
@@ -51,43 +153,45 @@ namespace DiceForge
     }
 
     uint32_t DiceForge::LFSR32::generate() {
-        uint32_t rand_num = 0;
-        uint64_t new_bit;
-
-        // For each bit to generate in rand_num,
-        for (int i = 0; i < 32; i++) {
-            // Calculate (by the series of taps) the new bit to be added to left of curr_seed
-            new_bit = (curr_seed2 ^ (curr_seed2 >> 1) ^ (curr_seed2 >> 2) ^ (curr_seed2 >> 7)) & 1;
-            // Shift curr_seed (both parts) to the right, and change the leftmost bit to new_bit
-            curr_seed2 = (curr_seed2 >> 1) | (curr_seed1 << 63);
-            curr_seed1 = (curr_seed1 >> 1) | (new_bit << 63);
-            // Take the last bit of curr_seed as the output, and add it to the right of rand_num
-            rand_num = rand_num * 2 + (curr_seed2 & 1);
-        }
+        // The 32 output bits are the register bits 1 to 32, taken lowest first into the highest bit of rand_num
+        uint32_t rand_num = reverse_bits((curr_seed2 >> 1) | (curr_seed1 << 63)) >> 32;
+        // Advance the register by 32 steps at once
+        uint64_t new_bits = feedback_word(curr_seed1, curr_seed2) & 0xFFFFFFFFULL;
+        curr_seed2 = (curr_seed2 >> 32) | (curr_seed1 << 32);
+        curr_seed1 = (curr_seed1 >> 32) | (new_bits << 32);
         return rand_num * 0x2545F4914F6CDD1DULL;
     }
 
+    void LFSR32::generate_block(uint32_t* out, size_t n) {
+        // Qualified call, so the whole block is generated without virtual dispatch
+        for (size_t i = 0; i < n; i++)
+            out[i] = LFSR32::generate();
+    }
+
+    void LFSR32::jump_ahead(uint64_t steps) {
+        // Each output advances the register by 32 steps
+        jump_register(curr_seed1, curr_seed2, jump_polynomial(steps, 32));
+    }
+
     void LFSR32::reseed(uint32_t seed) {
-        // If seed is zero, RNG will get stuck at zero. So set both parts of curr_seed to current times
-        if (seed == 0){
-            curr_seed1 = std::chrono::high_resolution_clock::now().time_since_epoch().count();
-            curr_seed2 = std::chrono::high_resolution_clock::now().time_since_epoch().count();
-        }
-            // If non-zero seed given, set both parts of curr_seed to that value
-        else {
-            uint64_t s = seed;
-            curr_seed1 = (s << 32) | s;
-            curr_seed2 = (s << 32) | s;
-        }
-        // Important: First 128 bits generated will simply be curr_seed in reverse
-        // Get them out of the way while reseeding
-        generate();
-        generate();
-        generate();
-        generate();
-            
-        for (int i = 0; i < 200; i++){
-            generate();
-        }
+        reseed_from(SeedSequence(seed));
+    }
+
+    void LFSR32::reseed_from(const SeedSequence& seq) {
+        seed_register(curr_seed1, curr_seed2, seq);
+    }
+
+    void LFSR32::write_state(detail::StateWriter& out) const {
+        out.tag("LFSR32");
+        out.put(curr_seed1);
+        out.put(curr_seed2);
+    }
+
+    void LFSR32::read_state(detail::StateReader& in) {
+        in.tag("LFSR32");
+        const uint64_t s1 = in.get<uint64_t>(), s2 = in.get<uint64_t>();
+        in.end();
+        curr_seed1 = s1;
+        curr_seed2 = s2;
     }
-}
\ No newline at end of file
+}
@@ -7,17 +7,28 @@ namespace DiceForge {
     /// @brief DiceForge::LFSR64 - Linear Feedback Shift Register class (derived from Generator)
     /// for generating 64-bit unsigned integers
     class LFSR64 : public DiceForge::Generator<uint64_t> {
+        friend class StaticView<LFSR64>;
     private:
         // Two curr_seeds, together forming a 128-bit seed
         uint64_t curr_seed1 = 0, curr_seed2 = 0;
         // Function to generate a random 64-bit positive integer
         uint64_t generate() override;
+        // Function to fill a buffer with random 64-bit positive integers
+        void generate_block(uint64_t* out, size_t n) override;
+        // Function to skip ahead by a number of outputs, with a polynomial jump of the register
+        void jump_ahead(uint64_t steps) override;
+        bool fast_jump() const override { return true; }
         // Function to reseed the RNG
         void reseed(uint64_t seed) override;
+        // Function to fill the register from seed material
+        void reseed_from(const SeedSequence& seq) override;
+        // Functions to save and restore the register
+        void write_state(detail::StateWriter& out) const override;
+        void read_state(detail::StateReader& in) override;
     public:
         /// @brief Initializes the LFSR with the specified seed
         /// @param seed seed to initialize the RNG with
-        /// @note if the seed provided is zero, then the current system time is taken as seed
+        /// @note Every seed, zero included, gives its own (non-zero) register, expanded from it by DiceForge::SeedSequence
         LFSR64(uint64_t seed);
         /// @brief Default destructor
         ~LFSR64() = default;
@@ -26,18 +37,28 @@ namespace DiceForge {
     /// @brief DiceForge::LFSR32 - Linear Feedback Shift Register class (derived from Generator)
     /// for generating 32-bit unsigned integers
     class LFSR32 : public DiceForge::Generator<uint32_t> {
+        friend class StaticView<LFSR32>;
     private:
         // Two curr_seeds, together forming a 128-bit seed
         uint64_t curr_seed1 = 0, curr_seed2 = 0;
         // Function to generate a random 32-bit positive integer
         uint32_t generate() override;
-        /// @brief Function to reseed the RNG
-        /// @note if the seed provided is zero, then the current system time is taken as seed
+        // Function to fill a buffer with random 32-bit positive integers
+        void generate_block(uint32_t* out, size_t n) override;
+        // Function to skip ahead by a number of outputs, with a polynomial jump of the register
+        void jump_ahead(uint64_t steps) override;
+        bool fast_jump() const override { return true; }
+        // Function to reseed the RNG
         void reseed(uint32_t seed) override;
+        // Function to fill the register from seed material
+        void reseed_from(const SeedSequence& seq) override;
+        // Functions to save and restore the register
+        void write_state(detail::StateWriter& out) const override;
+        void read_state(detail::StateReader& in) override;
     public:    
         /// @brief Initializes the LFSR with the specified seed
         /// @param seed seed to initialize the RNG with
-        /// @note if the seed provided is zero, then the current system time is taken as seed
+        /// @note Every seed, zero included, gives its own (non-zero) register, expanded from it by DiceForge::SeedSequence
         LFSR32(uint32_t seed);
         /// @brief Default destructor
         ~LFSR32() = default;
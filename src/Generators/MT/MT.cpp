@@ -1,182 +1,136 @@
 #include "MT.h"
+#include "MT_simd.h"
+#include "MT_jump.h"
 
 namespace DiceForge
 {
-    
-    // Constructor for 32-bit random number.
-    MT32::MT32(uint32_t _seed)
+    // Shorthand for the template header of the out-of-line members below
+    #define DF_MT_TEMPLATE template <typename UIntType, int N, int M, UIntType A, UIntType UpperBits, UIntType LowerBits, \
+                                     int U, int S, UIntType B, int T, UIntType C, int L>
+    #define DF_MT_ENGINE MersenneTwisterEngine<UIntType, N, M, A, UpperBits, LowerBits, U, S, B, T, C, L>
+
+    // Constructor
+    DF_MT_TEMPLATE
+    DF_MT_ENGINE::MersenneTwisterEngine(UIntType seed)
     {
-        if (_seed == 0)
-            _seed = time(NULL);
-
-        seed = _seed;
-
-        N = 624;
-        M = 397;
-        A = 2573724191;
-        upperbits = 0x80000000;
-        lowerbits = (int32_t)0x7ffffffff;
-        tempering_mask_B = 0x9d2c5680;
-        tempering_mask_C = 0xefc60000;
-        tempering_shift_U = 11;
-        tempering_shift_S = 7;
-        tempering_shift_T = 15;
-        tempering_shift_L = 18;
-        mt.resize(N);
         reseed(seed);
     }
 
     // Reset seed
-    void MT32::reseed(uint32_t seed)
-    {
-        if (seed == 0)
-            seed = time(NULL);
-
-        sgenrand(seed);
-        mti=N+1;
-    }
-
-    // Main program to get random number.
-    uint32_t MT32::generate()
+    DF_MT_TEMPLATE
+    void DF_MT_ENGINE::reseed(UIntType seed)
     {
-        trytransform();      
-        uint32_t y = temper(mt[mti]);
-        mti++;
-        return y;
+        reseed_from(SeedSequence(seed));
     }
 
-    // Generates initial vector.
-    void MT32::sgenrand(uint32_t iniseed)
+    // Fills the state vector with the expansion of the seed material, all N words at full width.
+    DF_MT_TEMPLATE
+    void DF_MT_ENGINE::reseed_from(const SeedSequence& seq)
     {
-        mt[0] = iniseed & 0x7FFFFFFFULL;
-        for (int mti = 1; mti < N; mti++)
-        {
-            mt[mti] = (mt[mti - 1] * 69069) & 0x7FFFFFFFULL;
-        }
-    }
-
-    // If mti>=N, MT algorithm is run to regenerate values.
-    void MT32::trytransform(){
-        if (mti >= N){
-            
-            uint32_t mtrx[2] = {0, A};
-            uint32_t y; // A temperory variable.
-            int k; // An iterative variable
-
-            for (k = 0; k < N - M; k++)
-            {
-                y = (mt[k] & upperbits) | (mt[k + 1] & lowerbits); // Performing the linear reccurence transformation
-                mt[k] = mt[k + M] ^ (y >> 1) ^ (mtrx[y & 1]);
-            }
-            for (; k < N - 1; k++)
-            {
-                y = (mt[k] & upperbits) | (mt[k + 1] & lowerbits);
-                mt[k] = mt[k + M - N] ^ (y >> 1) ^ (mtrx[y & 1]);
-            }
-
-            y = (mt[N - 1] & upperbits) | (mt[0] & lowerbits);
-            mt[N - 1] = mt[M - 1] ^ (y >> 1) ^ (mtrx[y & 1]);
-
-            mti = 0;
-        }
-    }
-
-    // Tempers generated value before returning.
-    uint32_t MT32::temper(uint32_t y){
-        //performing tempering
-        y ^= (y >> tempering_shift_U);
-        y ^= (y << tempering_shift_S) & tempering_mask_B;
-        y ^= (y << tempering_shift_T) & tempering_mask_C;
-        y ^= (y >> tempering_shift_L);
-        return y;
+        seq.generate(mt.data(), N);
+        // Of the first word only the upper bits enter the recurrence, and a state that is zero apart from them
+        // would stay zero
+        bool zero = (mt[0] & UpperBits) == 0;
+        for (int i = 1; i < N && zero; i++)
+            zero = (mt[i] == 0);
+        if (zero)
+            mt[0] = UpperBits;
+        mti=N+1;
     }
 
-
-    // Constructor for 64-bit random number.
-    MT64::MT64(uint64_t _seed)
+    // The word size and N tell MT32 from MT64, the index is at most N + 1 (right after reseeding)
+    DF_MT_TEMPLATE
+    void DF_MT_ENGINE::write_state(detail::StateWriter& out) const
     {
-        if (_seed == 0)
-            _seed = time(NULL);
-
-        seed = _seed;
-
-        N = 312;
-        M = 156;
-        A = 0xB5026F5AA96619E9;
-        upperbits = 0xFFFFFFFF80000000ULL;
-        lowerbits = 0x7FFFFFFFULL;
-        tempering_mask_B = 0xD66B5EF5B4DA0000;
-        tempering_mask_C = 0xFDED6BE000000000;
-        tempering_shift_U = 29;
-        tempering_shift_S = 17;
-        tempering_shift_T = 37;
-        tempering_shift_L = 41;
-        mt.resize(N);
-        reseed(seed);
+        out.tag("MersenneTwister");
+        out.put(uint8_t(sizeof(UIntType)));
+        out.put(uint32_t(N));
+        out.put(mt.data(), N);
+        out.put(uint32_t(mti));
     }
 
-    // Reset seed
-    void MT64::reseed(uint64_t seed)
+    DF_MT_TEMPLATE
+    void DF_MT_ENGINE::read_state(detail::StateReader& in)
     {
-        if (seed == 0)
-            seed = time(NULL);
-
-        sgenrand(seed);
-        mti=N+1;
+        in.tag("MersenneTwister");
+        in.expect(uint8_t(sizeof(UIntType)));
+        in.expect(uint32_t(N));
+        std::array<UIntType, N> state;
+        in.get(state.data(), N);
+        const uint32_t index = in.get<uint32_t>();
+        if (index > uint32_t(N) + 1)
+            throw std::invalid_argument("The saved state does not fit this object");
+        in.end();
+        mt = state;
+        mti = int(index);
     }
 
-    // Main program to get random number.
-    uint64_t MT64::generate()
+    // Tempers whole runs of the state vector at once, regenerating it whenever it is used up.
+    DF_MT_TEMPLATE
+    void DF_MT_ENGINE::generate_block(UIntType* out, size_t n)
     {
-        trytransform();      
-        uint64_t y = temper(mt[mti]);
-        mti++;
-        return y;
+        while (n > 0)
+        {
+            trytransform();
+            size_t m = std::min(n, size_t(N - mti));
+            MT_simd::temper(mt.data() + mti, out, m, U, S, B, T, C, L);
+            mti += m;
+            out += m;
+            n -= m;
+        }
     }
 
-    // Generates initial vector.
-    void MT64::sgenrand(uint64_t iniseed)
+    // Skips the given number of outputs.
+    DF_MT_TEMPLATE
+    void DF_MT_ENGINE::jump_ahead(uint64_t steps)
     {
-        mt[0] = iniseed & 0x7FFFFFFFULL;
-        for (int mti = 1; mti < N; mti++)
+        if constexpr ((UpperBits & LowerBits) != 0)
         {
-            mt[mti] = (mt[mti - 1] * 69069) & 0x7FFFFFFFULL;
+            // Overlapping masks make the twist non-linear, so the outputs are simply discarded
+            for (uint64_t i = 0; i < steps; i++)
+                generate();
+        }
+        else
+        {
+            // Output index (relative to the start of the current block) to jump to
+            uint128_t target = uint128_t(std::min(mti, N)) + steps;
+            if (target < uint128_t(N))
+            {
+                mti = int(target);
+                return;
+            }
+            uint128_t blocks = target / N;
+            mti = int(target % N);
+
+            static const MT_jump::Recurrence<UIntType> rec = {N, M, A, UpperBits, LowerBits};
+            static size_t degree;
+            static const MT_jump::Poly P = MT_jump::characteristic_polynomial(rec, degree);
+
+            // Jump to the window starting one word before the new block, since the lower bits of the first
+            // word of a jumped window are not determined, then step once to get the whole block
+            MT_jump::jump(rec, mt.data(), MT_jump::power_of_x(P, degree, blocks * N - 1), degree);
+            int i = 0;
+            rec.step(mt.data(), i);
+            std::rotate(mt.begin(), mt.begin() + 1, mt.end());
         }
     }
 
     // If mti>=N, MT algorithm is run to regenerate values.
-    void MT64::trytransform(){
+    DF_MT_TEMPLATE
+    void DF_MT_ENGINE::trytransform(){
         if (mti >= N){
-            
-            uint64_t mtrx[2] = {0, A};
-            uint64_t y; // A temperory variable.
-            int k; // An iterative variable
-
-            for (k = 0; k < N - M; k++)
-            {
-                y = (mt[k] & upperbits) | (mt[k + 1] & lowerbits); // Performing the linear reccurence transformation
-                mt[k] = mt[k + M] ^ (y >> 1) ^ (mtrx[y & 1]);
-            }
-            for (; k < N - 1; k++)
-            {
-                y = (mt[k] & upperbits) | (mt[k + 1] & lowerbits);
-                mt[k] = mt[k + M - N] ^ (y >> 1) ^ (mtrx[y & 1]);
-            }
-
-            y = (mt[N - 1] & upperbits) | (mt[0] & lowerbits);
-            mt[N - 1] = mt[M - 1] ^ (y >> 1) ^ (mtrx[y & 1]);
-
+            // Performing the linear reccurence transformation on whole runs of the state vector
+            MT_simd::regenerate(mt.data(), N, M, A, UpperBits, LowerBits);
             mti = 0;
         }
     }
 
-    // Tempers generated value before returning.
-    uint64_t MT64::temper(uint64_t y){
-        //performing tempering
-        y ^= (y >> tempering_shift_U);
-        y ^= (y << tempering_shift_S) & tempering_mask_B;
-        y ^= (y << tempering_shift_T) & tempering_mask_C;
-        y ^= (y >> tempering_shift_L);
-        return y;
-    }
+    #undef DF_MT_TEMPLATE
+    #undef DF_MT_ENGINE
+
+    // MT32 and MT64
+    template class MersenneTwisterEngine<uint32_t, 624, 397, 0x9967EA1FU, 0x80000000U, 0xFFFFFFFFU,
+                                         11, 7, 0x9D2C5680U, 15, 0xEFC60000U, 18>;
+    template class MersenneTwisterEngine<uint64_t, 312, 156, 0xB5026F5AA96619E9ULL, 0xFFFFFFFF80000000ULL, 0x7FFFFFFFULL,
+                                         29, 17, 0xD66B5EF5B4DA0000ULL, 37, 0xFDED6BE000000000ULL, 41>;
 }
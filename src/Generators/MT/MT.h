@@ -1,87 +1,101 @@
-/***MERSENNE TWISTER PRNG***/
-/*generates 64 bit integers*/
-/*Parameters involved
-(w,n,m,r)=(64,312,156,31)
-*/
-
-#ifndef DF_MT_H
-#define DF_MT_H
-
-#include "generator.h"
-
-namespace DiceForge{
-
-    /// @brief DiceForge::MT32 - A Mersenne Twister RNG for generating 32-bit unsigned integers
-    class MT32 : public Generator<uint32_t>
-    {
-    private:
-        // Main Parameters:
-        int N;                          // length of state value vector
-        int M;                          // optimum value as mid
-        uint32_t A;                     // vector in the matrix A
-        uint32_t upperbits, lowerbits;  // for obtaining first w-r bits of the number
-        // Tempering Parameters:
-        uint32_t tempering_mask_B;
-        uint32_t tempering_mask_C;
-        uint32_t tempering_shift_U;
-        uint32_t tempering_shift_S;
-        uint32_t tempering_shift_T;
-        uint32_t tempering_shift_L;
-        // Other Parameters:
-        std::vector<uint32_t> mt;       // State Vector
-        int mti;                // Used as index for the array MT.
-        uint32_t seed;                  // Seed given from main
-        // Funtcions to generate first N pseudo-random numbers as a seed for the algorithm.
-        void sgenrand(uint32_t);
-        void trytransform();
-        uint32_t temper(uint32_t);
-        uint32_t generate() override;
-        void reseed(uint32_t seed) override;
-    public:
-        /// @brief Initializes the Mersenne Twister RNG with the specified seed
-        /// @param seed seed to initialize the RNG with
-        /// @note if the seed provided is zero, then the current system time is taken as seed
-        MT32(uint32_t seed);
-        ~MT32() = default;
-    };
-    
-    /// @brief DiceForge::MT64 - A Mersenne Twister RNG for generating 64-bit unsigned integers
-    class MT64 : public Generator<uint64_t>
-    {
-    private:
-        // Main Parameters:
-        int N;                          // length of state value vector
-        int M;                          // optimum value as mid
-        uint64_t A;                     // vector in the matrix A
-        uint64_t upperbits, lowerbits;  // for obtaining first w-r bits of the number
-        // Tempering Parameters:
-        uint64_t tempering_mask_B;
-        uint64_t tempering_mask_C;
-        uint64_t tempering_shift_U;
-        uint64_t tempering_shift_S;
-        uint64_t tempering_shift_T;
-        uint64_t tempering_shift_L;
-        // Other Parameters:
-        std::vector<uint64_t> mt;       // State Vector
-        int mti;                // Used as index for the array MT.
-        uint64_t seed;                  // Seed given from main
-        // Funtcions to generate first N pseudo-random numbers as a seed for the algorithm.
-        void sgenrand(uint64_t);
-        void trytransform();
-        uint64_t temper(uint64_t);
-        uint64_t generate() override;
-        void reseed(uint64_t seed) override;
-    public:
-        /// @brief Initializes the Mersenne Twister RNG with the specified seed
-        /// @param seed seed to initialize the RNG with
-        /// @note if the seed provided is zero, then the current system time is taken as seed
-        MT64(uint64_t seed);
-        ~MT64() = default;
-    };
-    
-    // Typedef for convenience
-    
-    typedef MT64 MT;
-}
-
-#endif
\ No newline at end of file
+/***MERSENNE TWISTER PRNG***/
+/*generates 32 or 64 bit integers*/
+/*Parameters involved
+(w,n,m,r)=(32,624,397,31) for MT32
+(w,n,m,r)=(64,312,156,31) for MT64
+*/
+
+#ifndef DF_MT_H
+#define DF_MT_H
+
+#include "generator.h"
+#include <array>
+
+namespace DiceForge{
+
+    /// @brief DiceForge::MersenneTwisterEngine - A Mersenne Twister RNG with all of its parameters fixed at compile time
+    /// @tparam UIntType word type of the state and of the generated numbers (uint32_t or uint64_t)
+    /// @tparam N length of the state vector
+    /// @tparam M middle word offset used by the recurrence
+    /// @tparam A vector in the matrix A
+    /// @tparam UpperBits mask for obtaining the first w-r bits of a word
+    /// @tparam LowerBits mask for obtaining the last r bits of a word
+    /// @tparam U, S, B, T, C, L tempering shifts (U, S, T, L) and masks (B, C)
+    /// @note Since every parameter is a constant, the shifts and masks in the tempering and in the
+    /// recurrence are folded into the instructions, and the state lives inside the object itself.
+    template <typename UIntType, int N, int M, UIntType A, UIntType UpperBits, UIntType LowerBits,
+              int U, int S, UIntType B, int T, UIntType C, int L>
+    class MersenneTwisterEngine : public Generator<UIntType>
+    {
+        friend class StaticView<MersenneTwisterEngine>;
+    private:
+        std::array<UIntType, N> mt;     // State Vector
+        int mti;                        // Used as index for the array MT.
+        void trytransform();
+        static UIntType temper(UIntType);
+        UIntType generate() override;
+        void generate_block(UIntType* out, size_t n) override;
+        // Jumps with the characteristic polynomial of the recurrence (when it is linear, i.e. the masks do not overlap)
+        void jump_ahead(uint64_t steps) override;
+        bool fast_jump() const override { return (UpperBits & LowerBits) == 0; }
+        void reseed(UIntType seed) override;
+        // Fills the whole state vector from the seed material
+        void reseed_from(const SeedSequence& seq) override;
+        // Saves the state vector and the index into it
+        void write_state(detail::StateWriter& out) const override;
+        void read_state(detail::StateReader& in) override;
+    public:
+        /// @brief Initializes the Mersenne Twister RNG with the specified seed
+        /// @param seed seed to initialize the RNG with
+        /// @note Every seed, zero included, gives its own state, expanded from it by DiceForge::SeedSequence
+        MersenneTwisterEngine(UIntType seed);
+        ~MersenneTwisterEngine() = default;
+    };
+
+    // Main program to get random number.
+    // Defined here so that it can be inlined through StaticView<MersenneTwisterEngine<...>>
+    template <typename UIntType, int N, int M, UIntType A, UIntType UpperBits, UIntType LowerBits,
+              int U, int S, UIntType B, int T, UIntType C, int L>
+    inline UIntType MersenneTwisterEngine<UIntType, N, M, A, UpperBits, LowerBits, U, S, B, T, C, L>::generate()
+    {
+        if (mti >= N)
+            trytransform();
+        UIntType y = temper(mt[mti]);
+        mti++;
+        return y;
+    }
+
+    // Tempers generated value before returning.
+    template <typename UIntType, int N, int M, UIntType A, UIntType UpperBits, UIntType LowerBits,
+              int U, int S, UIntType B, int T, UIntType C, int L>
+    inline UIntType MersenneTwisterEngine<UIntType, N, M, A, UpperBits, LowerBits, U, S, B, T, C, L>::temper(UIntType y){
+        //performing tempering
+        y ^= (y >> U);
+        y ^= (y << S) & B;
+        y ^= (y << T) & C;
+        y ^= (y >> L);
+        return y;
+    }
+
+    /// @brief DiceForge::MT32 - A Mersenne Twister RNG for generating 32-bit unsigned integers
+    /// @note A and the lower mask (all ones rather than 0x7FFFFFFF) are kept as in earlier releases
+    /// (they also make its twist non-linear, so jump() discards the outputs one by one)
+    typedef MersenneTwisterEngine<uint32_t, 624, 397, 0x9967EA1FU, 0x80000000U, 0xFFFFFFFFU,
+                                  11, 7, 0x9D2C5680U, 15, 0xEFC60000U, 18> MT32;
+
+    /// @brief DiceForge::MT64 - A Mersenne Twister RNG for generating 64-bit unsigned integers
+    typedef MersenneTwisterEngine<uint64_t, 312, 156, 0xB5026F5AA96619E9ULL, 0xFFFFFFFF80000000ULL, 0x7FFFFFFFULL,
+                                  29, 17, 0xD66B5EF5B4DA0000ULL, 37, 0xFDED6BE000000000ULL, 41> MT64;
+
+    // The out-of-line members are compiled once in MT.cpp for these two engines
+    extern template class MersenneTwisterEngine<uint32_t, 624, 397, 0x9967EA1FU, 0x80000000U, 0xFFFFFFFFU,
+                                                11, 7, 0x9D2C5680U, 15, 0xEFC60000U, 18>;
+    extern template class MersenneTwisterEngine<uint64_t, 312, 156, 0xB5026F5AA96619E9ULL, 0xFFFFFFFF80000000ULL, 0x7FFFFFFFULL,
+                                                29, 17, 0xD66B5EF5B4DA0000ULL, 37, 0xFDED6BE000000000ULL, 41>;
+    
+    // Typedef for convenience
+    
+    typedef MT64 MT;
+}
+
+#endif
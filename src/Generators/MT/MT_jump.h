@@ -0,0 +1,184 @@
+/***JUMP AHEAD FOR THE MERSENNE TWISTER***/
+/*the words of the Mersenne Twister follow a linear recurrence over GF(2),
+so the state e steps ahead is p(T) applied to the current one, where T is the
+transition and p(x) = x^e modulo the characteristic polynomial of T*/
+
+#ifndef DF_MT_JUMP_H
+#define DF_MT_JUMP_H
+
+#include "types.h"
+#include <vector>
+#include <cstddef>
+
+namespace DiceForge
+{
+    namespace MT_jump
+    {
+        // Polynomial over GF(2): bit i % 64 of word i / 64 is the coefficient of x^i
+        typedef std::vector<uint64_t> Poly;
+
+        inline bool coefficient(const Poly& a, size_t i)
+        {
+            return i / 64 < a.size() && ((a[i / 64] >> (i % 64)) & 1);
+        }
+
+        // a ^= b * x^shift
+        inline void add_shifted(Poly& a, const Poly& b, size_t shift)
+        {
+            size_t ws = shift / 64, bs = shift % 64;
+            for (size_t w = 0; w < b.size() && w + ws < a.size(); w++)
+            {
+                a[w + ws] ^= b[w] << bs;
+                if (bs != 0 && w + ws + 1 < a.size())
+                    a[w + ws + 1] ^= b[w] >> (64 - bs);
+            }
+        }
+
+        /// @brief The recurrence x[k + N] = x[k + M] ^ twist(x[k], x[k + 1]) of the state words
+        template <typename W>
+        struct Recurrence
+        {
+            int N, M;
+            W A, upperbits, lowerbits;
+
+            /// @brief Computes the word N places after c[i] in the circular window c, stores it in c[i]
+            /// and moves i to the next word
+            void step(W* c, int& i) const
+            {
+                int i1 = (i + 1 == N) ? 0 : i + 1, im = (i + M >= N) ? i + M - N : i + M;
+                W y = (c[i] & upperbits) | (c[i1] & lowerbits);
+                c[i] = c[im] ^ (y >> 1) ^ ((W(0) - (y & 1)) & A);
+                i = i1;
+            }
+        };
+
+        /// @brief Characteristic polynomial of the transition, found as the minimal polynomial of the lowest
+        /// bit of the words (Berlekamp-Massey over 2 * N * w terms)
+        /// @param degree set to the degree of the polynomial
+        /// @note Both are the same for a primitive characteristic polynomial, as in the standard parameter sets
+        template <typename W>
+        Poly characteristic_polynomial(const Recurrence<W>& rec, size_t& degree)
+        {
+            const size_t terms = 2 * size_t(rec.N) * 8 * sizeof(W), words = terms / 64 + 2;
+
+            // Any non-zero starting state will do
+            std::vector<W> c(rec.N);
+            for (int k = 0; k < rec.N; k++)
+                c[k] = W(0x9E3779B97F4A7C15ULL * (k + 1));
+            int i = 0;
+            // The lower bits of the very first word are not part of the recurrence state
+            rec.step(c.data(), i);
+
+            // Connection polynomials C and B, and the sequence read backwards, R[j] = s[n - j]
+            Poly C(words, 0), B(words, 0), R(words, 0), T;
+            C[0] = B[0] = 1;
+            size_t L = 0, m = 1;
+            for (size_t n = 0; n < terms; n++)
+            {
+                uint64_t s = c[i] & 1;
+                rec.step(c.data(), i);
+                for (size_t w = words - 1; w > 0; w--)
+                    R[w] = (R[w] << 1) | (R[w - 1] >> 63);
+                R[0] = (R[0] << 1) | s;
+
+                // Discrepancy: parity of C . R over the first L + 1 terms
+                uint64_t d = 0;
+                for (size_t w = 0; w <= L / 64; w++)
+                    d ^= C[w] & R[w];
+                d ^= d >> 32; d ^= d >> 16; d ^= d >> 8; d ^= d >> 4; d ^= d >> 2; d ^= d >> 1;
+
+                if ((d & 1) == 0)
+                    m++;
+                else if (2 * L <= n)
+                {
+                    T = C;
+                    add_shifted(C, B, m);
+                    L = n + 1 - L;
+                    B = T;
+                    m = 1;
+                }
+                else
+                {
+                    add_shifted(C, B, m);
+                    m++;
+                }
+            }
+
+            // P(x) = x^L C(1/x)
+            Poly P(L / 64 + 1, 0);
+            for (size_t j = 0; j <= L; j++)
+                if (coefficient(C, L - j))
+                    P[j / 64] |= 1ULL << (j % 64);
+            degree = L;
+            return P;
+        }
+
+        /// @brief x^e modulo P, where P has the given degree
+        inline Poly power_of_x(const Poly& P, size_t degree, uint128_t e)
+        {
+            const size_t words = degree / 64 + 1;
+            Poly r(words, 0), sq(2 * words, 0);
+            r[0] = 1;
+            int top = 127;
+            while (top >= 0 && ((e >> top) & 1) == 0)
+                top--;
+            for (; top >= 0; top--)
+            {
+                // Squaring over GF(2) spreads the coefficients to the even powers
+                for (size_t w = 0; w < words; w++)
+                {
+                    for (int h = 0; h < 2; h++)
+                    {
+                        uint64_t x = (r[w] >> (32 * h)) & 0xFFFFFFFFULL;
+                        x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+                        x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+                        x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+                        x = (x | (x << 2)) & 0x3333333333333333ULL;
+                        x = (x | (x << 1)) & 0x5555555555555555ULL;
+                        sq[2 * w + h] = x;
+                    }
+                }
+                for (size_t i = 2 * degree; i-- > degree;)
+                    if (coefficient(sq, i))
+                        add_shifted(sq, P, i - degree);
+                for (size_t w = 0; w < words; w++)
+                    r[w] = sq[w];
+
+                // Multiplying by x is a shift
+                if ((e >> top) & 1)
+                {
+                    for (size_t w = words - 1; w > 0; w--)
+                        r[w] = (r[w] << 1) | (r[w - 1] >> 63);
+                    r[0] <<= 1;
+                    if (coefficient(r, degree))
+                        add_shifted(r, P, 0);
+                }
+            }
+            return r;
+        }
+
+        /// @brief Replaces the window of N consecutive words mt with the window e words further on
+        /// @param p x^e modulo the characteristic polynomial (see power_of_x)
+        /// @note The lower bits of the first word of the result are not determined by the recurrence
+        /// state and must not be used
+        template <typename W>
+        void jump(const Recurrence<W>& rec, W* mt, const Poly& p, size_t degree)
+        {
+            std::vector<W> c(mt, mt + rec.N), acc(rec.N, 0);
+            int i = 0;
+            for (size_t j = 0; j < degree; j++)
+            {
+                if (coefficient(p, j))
+                {
+                    for (int t = 0, k = i; t < rec.N; t++, k = (k + 1 == rec.N) ? 0 : k + 1)
+                        acc[t] ^= c[k];
+                }
+                rec.step(c.data(), i);
+            }
+            for (int t = 0; t < rec.N; t++)
+                mt[t] = acc[t];
+        }
+    }
+}
+
+#endif
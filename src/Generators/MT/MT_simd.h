@@ -0,0 +1,89 @@
+/***SIMD KERNELS FOR THE MERSENNE TWISTER***/
+/*regenerates the state vector and tempers whole blocks
+several words at a time (AVX2, SSE2 or NEON, whichever is available),
+producing exactly the same words as the scalar algorithm*/
+
+#ifndef DF_MT_SIMD_H
+#define DF_MT_SIMD_H
+
+#include "simd.h"
+#include <cstddef>
+
+namespace DiceForge
+{
+    namespace MT_simd
+    {
+        /// @brief Regenerates all N words of the state vector mt (the "twist")
+        /// @note While k < N - M every new word depends only on old words, and afterwards on new words
+        /// at least N - M places behind, so runs of Lanes<W>::width words can be computed at once.
+        template <typename W>
+        void regenerate(W* mt, int N, int M, W A, W upperbits, W lowerbits)
+        {
+            int k = 0;
+#if defined(DF_SIMD)
+            typedef simd::Lanes<W> L;
+            const typename L::vec upper = L::set1(upperbits), lower = L::set1(lowerbits);
+            const typename L::vec a = L::set1(A), one = L::set1(1);
+
+            auto twist = [&](int k, int m)
+            {
+                typename L::vec y = L::bor(L::band(L::load(mt + k), upper), L::band(L::load(mt + k + 1), lower));
+                typename L::vec mag = L::band(L::neg(L::band(y, one)), a);
+                L::store(mt + k, L::bxor(L::bxor(L::load(mt + m), L::srl(y, 1)), mag));
+            };
+
+            for (; k + L::width <= N - M; k += L::width)
+                twist(k, k + M);
+#endif
+            W y;
+            for (; k < N - M; k++)
+            {
+                y = (mt[k] & upperbits) | (mt[k + 1] & lowerbits);
+                mt[k] = mt[k + M] ^ (y >> 1) ^ ((W(0) - (y & 1)) & A);
+            }
+#if defined(DF_SIMD)
+            for (; k + L::width <= N - 1; k += L::width)
+                twist(k, k + M - N);
+#endif
+            for (; k < N - 1; k++)
+            {
+                y = (mt[k] & upperbits) | (mt[k + 1] & lowerbits);
+                mt[k] = mt[k + M - N] ^ (y >> 1) ^ ((W(0) - (y & 1)) & A);
+            }
+
+            y = (mt[N - 1] & upperbits) | (mt[0] & lowerbits);
+            mt[N - 1] = mt[M - 1] ^ (y >> 1) ^ ((W(0) - (y & 1)) & A);
+        }
+
+        /// @brief Tempers n words of in and writes them to out
+        template <typename W>
+        void temper(const W* in, W* out, size_t n, int u, int s, W b, int t, W c, int l)
+        {
+            size_t i = 0;
+#if defined(DF_SIMD)
+            typedef simd::Lanes<W> L;
+            const typename L::vec B = L::set1(b), C = L::set1(c);
+            for (; i + L::width <= n; i += L::width)
+            {
+                typename L::vec y = L::load(in + i);
+                y = L::bxor(y, L::srl(y, u));
+                y = L::bxor(y, L::band(L::sll(y, s), B));
+                y = L::bxor(y, L::band(L::sll(y, t), C));
+                y = L::bxor(y, L::srl(y, l));
+                L::store(out + i, y);
+            }
+#endif
+            for (; i < n; i++)
+            {
+                W y = in[i];
+                y ^= (y >> u);
+                y ^= (y << s) & b;
+                y ^= (y << t) & c;
+                y ^= (y >> l);
+                out[i] = y;
+            }
+        }
+    }
+}
+
+#endif
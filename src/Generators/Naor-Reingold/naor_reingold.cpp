@@ -1,24 +1,24 @@
 
 #include "naor_reingold.h"
-#include <chrono>
-
-typedef unsigned long long ull;
-typedef unsigned int uint32_t;
-
-// Refer wikipedia article for these numbers and their explanation
-static constexpr ull l = 9999929;
-static constexpr ull p = 4279969613;
-static constexpr ull g = 9999918;
-static constexpr ull a[] = {
-    650051,  3948705, 3142325, 4036110, 1141941, 5739231, 5725758,
-    8299330, 1776388, 1423550, 9260804, 156410,  1190436, 61218,
-    2382500, 1738876, 7978879, 6010478, 310917,  4280253, 24724,
-    7087659, 796099,  8383655, 7638286, 1390415, 7899225, 5628976,
-    1472292, 4284966, 9708041, 4179835, 3635954};
 
 namespace DiceForge {
 
-  ull power(ull a, ull b, ull mod) {
+  namespace {
+    typedef unsigned long long ull;
+
+    // Refer wikipedia article for these numbers and their explanation
+    constexpr ull l = 9999929;
+    constexpr ull p = 4279969613;
+    constexpr ull g = 9999918;
+    constexpr ull a[] = {
+        650051,  3948705, 3142325, 4036110, 1141941, 5739231, 5725758,
+        8299330, 1776388, 1423550, 9260804, 156410,  1190436, 61218,
+        2382500, 1738876, 7978879, 6010478, 310917,  4280253, 24724,
+        7087659, 796099,  8383655, 7638286, 1390415, 7899225, 5628976,
+        1472292, 4284966, 9708041, 4179835, 3635954};
+  }
+
+  constexpr ull power(ull a, ull b, ull mod) {
     ull result = 1;
     ull a_pwr = a % mod;
     while (b) {
@@ -32,32 +32,95 @@ namespace DiceForge {
     return result;
   }
 
+  namespace {
+    struct PowerTables {
+      ull factor[32];   // g^a[i] mod p, the factor contributed by bit i of the state
+      ull step[32];     // factor[k] / (factor[0] * ... * factor[k-1]) mod p
+    };
+
+    constexpr PowerTables make_tables() {
+      PowerTables t{};
+      ull inv_prefix = 1;   // 1 / (factor[0] * ... * factor[k-1]) mod p (p is prime)
+      for (int i = 0; i < 32; i++) {
+        t.factor[i] = power(g, a[i], p);
+        t.step[i] = (t.factor[i] * inv_prefix) % p;
+        inv_prefix = (inv_prefix * power(t.factor[i], p - 2, p)) % p;
+      }
+      return t;
+    }
+
+    // Computed at compile time, since g, a[] and p are constants
+    constexpr PowerTables tables = make_tables();
+
+    // Product of the factors of the set bits of the state
+    ull product(uint64_t state) {
+      ull res = 1;
+      for (int i = 0; i < 31; i++) {
+        // Only multiply the remainder if the corresponding bit is 1
+        if (state & (1ULL << i))
+          res = (res * tables.factor[i]) % p;
+      }
+      // The factor of the last bit is used whenever any of the bits 31 to 63 is set
+      if (state >> 31)
+        res = (res * tables.factor[31]) % p;
+      return res;
+    }
+  }
+
   NaorReingold::NaorReingold(uint32_t seed) {
-    if (seed == 0)
-      m_state = std::chrono::high_resolution_clock::now().time_since_epoch().count();
-    else
-      m_state = seed;
+    reseed(seed);
   }
 
   void NaorReingold::reseed(uint32_t seed) { 
-    if (seed == 0)
-      m_state = std::chrono::high_resolution_clock::now().time_since_epoch().count();
-    else
-      m_state = seed;
+    reseed_from(SeedSequence(seed));
+  }
+
+  void NaorReingold::reseed_from(const SeedSequence& seq) {
+    m_state = uint32_t(seq.word(0));
+    m_product = product(m_state);
+  }
+
+  // The product is a function of the state, so only the state is saved
+  void NaorReingold::write_state(detail::StateWriter& out) const {
+    out.tag("NaorReingold");
+    out.put(uint64_t(m_state));
+  }
+
+  void NaorReingold::read_state(detail::StateReader& in) {
+    in.tag("NaorReingold");
+    const uint64_t state = in.get<uint64_t>();
+    in.end();
+    m_state = state;
+    m_product = product(m_state);
   }
 
   uint32_t NaorReingold::generate() {
-    ull res = 1;
-    for (int i = 0; i < 32; i++) {
-      // Only multiply the remainder if the corresponding bit is 1
-      bool to_multiply = m_state & (1 << i);
+    ull res = m_product;
 
-      if (to_multiply)
-        res = (res * power(g, a[i], p)) % p;
-    }
+    // Incrementing the state clears its k trailing ones and sets bit k, so unless the carry reaches
+    // the last bit, the product is updated with the single precomputed step factor for k
+    int k = 0;
+    while (k < 31 && ((m_state >> k) & 1))
+      k++;
 
     m_state++;
+    if (k < 31)
+      m_product = (m_product * tables.step[k]) % p;
+    else
+      m_product = product(m_state);
     return res;
   }
 
+  void NaorReingold::jump_ahead(uint64_t steps) {
+    // Counter mode: the state is simply offset
+    m_state += steps;
+    m_product = product(m_state);
+  }
+
+  void NaorReingold::generate_block(uint32_t* out, size_t n) {
+    // Qualified call, so the whole block is generated without virtual dispatch
+    for (size_t i = 0; i < n; i++)
+      out[i] = NaorReingold::generate();
+  }
+
 } // namespace DiceForge
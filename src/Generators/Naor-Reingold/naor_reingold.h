@@ -7,15 +7,23 @@ namespace DiceForge {
   /// @brief DiceForge::NaorReingold - An implementation of the Naor-Reingold PRF 
   /// for generating 32-bit unsigned integers
   class NaorReingold : public Generator<uint32_t> {
+      friend class StaticView<NaorReingold>;
     private:
       uint64_t m_state;   // Internal state
+      uint64_t m_product; // Output for the current state
       uint32_t generate() override;
+      void generate_block(uint32_t* out, size_t n) override;
+      void jump_ahead(uint64_t steps) override;
+      bool fast_jump() const override { return true; }
       void reseed(uint32_t seed) override;
+      void reseed_from(const SeedSequence& seq) override;
+      void write_state(detail::StateWriter& out) const override;
+      void read_state(detail::StateReader& in) override;
       
     public:
       /// @brief Initializes the PRF with the given seed
       /// @param seed seed to initialize the PRF with
-      /// @note If the seed given is zero, then it is taken to be the current system time
+      /// @note The starting state is expanded from the seed by DiceForge::SeedSequence, for any seed (zero included)
       /// @note The key for the PRF is predetermined and fixed. The seed is not the key.
       NaorReingold(uint32_t seed);
       /// @brief Default destructor
@@ -0,0 +1,131 @@
+#include "Philox.h"
+
+namespace DiceForge
+{
+    namespace
+    {
+        // Multipliers and key increments (Weyl sequence) of Philox4x32
+        const uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+        const uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+
+        // The Philox4x32-10 bijection of the counter c under the key k, in place
+        inline void philox4x32_10(uint32_t c[4], uint32_t k0, uint32_t k1)
+        {
+            for (int round = 0; round < 10; round++)
+            {
+                uint64_t p0 = uint64_t(M0) * c[0], p1 = uint64_t(M1) * c[2];
+                uint32_t c0 = uint32_t(p1 >> 32) ^ c[1] ^ k0;
+                uint32_t c2 = uint32_t(p0 >> 32) ^ c[3] ^ k1;
+                c[1] = uint32_t(p1);
+                c[3] = uint32_t(p0);
+                c[0] = c0;
+                c[2] = c2;
+                k0 += W0;
+                k1 += W1;
+            }
+        }
+    }
+
+    template <typename UIntType>
+    PhiloxEngine<UIntType>::PhiloxEngine(UIntType seed, uint64_t stream) : m_stream(stream)
+    {
+        reseed(seed);
+    }
+
+    template <typename UIntType>
+    void PhiloxEngine<UIntType>::reseed(UIntType seed)
+    {
+        reseed_from(SeedSequence(seed));
+    }
+
+    template <typename UIntType>
+    void PhiloxEngine<UIntType>::reseed_from(const SeedSequence& seq)
+    {
+        const uint64_t key = seq.word(0);
+        m_key[0] = uint32_t(key);
+        m_key[1] = uint32_t(key >> 32);
+        m_position = 0;
+        m_block_valid = false;
+    }
+
+    template <typename UIntType>
+    void PhiloxEngine<UIntType>::write_state(detail::StateWriter& out) const
+    {
+        out.tag("Philox");
+        out.put(uint8_t(sizeof(UIntType)));
+        out.put(m_key, 2);
+        out.put(m_stream);
+        out.put(m_position);
+    }
+
+    template <typename UIntType>
+    void PhiloxEngine<UIntType>::read_state(detail::StateReader& in)
+    {
+        in.tag("Philox");
+        in.expect(uint8_t(sizeof(UIntType)));
+        uint32_t key[2];
+        in.get(key, 2);
+        const uint64_t stream = in.get<uint64_t>(), position = in.get<uint64_t>();
+        in.end();
+        m_stream = stream;
+        m_position = position;
+        m_key[0] = key[0];
+        m_key[1] = key[1];
+        m_block_valid = false;
+    }
+
+    template <typename UIntType>
+    void PhiloxEngine<UIntType>::compute_block(uint64_t block, UIntType* out) const
+    {
+        uint32_t c[4] = {uint32_t(block), uint32_t(block >> 32), uint32_t(m_stream), uint32_t(m_stream >> 32)};
+        philox4x32_10(c, m_key[0], m_key[1]);
+        if constexpr (per_block == 4)
+        {
+            for (int j = 0; j < 4; j++)
+                out[j] = c[j];
+        }
+        else
+        {
+            out[0] = (uint64_t(c[1]) << 32) | c[0];
+            out[1] = (uint64_t(c[3]) << 32) | c[2];
+        }
+    }
+
+    template <typename UIntType>
+    UIntType PhiloxEngine<UIntType>::at(uint64_t i) const
+    {
+        UIntType block[per_block];
+        compute_block(i / per_block, block);
+        return block[i % per_block];
+    }
+
+    template <typename UIntType>
+    void PhiloxEngine<UIntType>::generate_block(UIntType* out, size_t n)
+    {
+        // Finish the current block one by one, then write whole blocks straight to the buffer
+        while (n > 0 && m_position % per_block != 0)
+        {
+            *out++ = PhiloxEngine::generate();
+            n--;
+        }
+        for (; n >= size_t(per_block); n -= per_block, out += per_block)
+        {
+            compute_block(m_position / per_block, out);
+            m_position += per_block;
+        }
+        while (n > 0)
+        {
+            *out++ = PhiloxEngine::generate();
+            n--;
+        }
+    }
+
+    template <typename UIntType>
+    void PhiloxEngine<UIntType>::jump_ahead(uint64_t steps)
+    {
+        m_position += steps;
+    }
+
+    template class PhiloxEngine<uint32_t>;
+    template class PhiloxEngine<uint64_t>;
+}
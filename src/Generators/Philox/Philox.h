@@ -0,0 +1,90 @@
+#ifndef DF_PHILOX_H
+#define DF_PHILOX_H
+
+#include "generator.h"
+
+namespace DiceForge
+{
+    /// @brief DiceForge::PhiloxEngine - A counter-based RNG following the Philox4x32-10 algorithm
+    /// (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3")
+    /// @tparam UIntType uint32_t (4 outputs per block) or uint64_t (2 outputs per block)
+    /// @note Block b of a stream is a keyed bijection of the counter (b, stream), so element i of a stream
+    /// depends only on (seed, stream, i). Threads, processes or nodes can each take their own stream
+    /// (or ranges of one stream) with no coordination, and any element can be recomputed directly with at().
+    template <typename UIntType>
+    class PhiloxEngine : public Generator<UIntType>
+    {
+        friend class StaticView<PhiloxEngine>;
+    public:
+        /// @brief Number of outputs produced by each block of the counter
+        static constexpr int per_block = 16 / sizeof(UIntType);
+    private:
+        uint32_t m_key[2];              // Key of the bijection (derived from the seed)
+        uint64_t m_stream;              // Upper half of the counter, selects the stream
+        uint64_t m_position;            // Index of the next element of the stream
+        UIntType m_block[per_block];    // Outputs of the block m_block_index
+        uint64_t m_block_index;
+        bool m_block_valid;
+        // Computes the outputs of the given block
+        void compute_block(uint64_t block, UIntType* out) const;
+        UIntType generate() override;
+        void generate_block(UIntType* out, size_t n) override;
+        // Counter mode: the position is simply offset
+        void jump_ahead(uint64_t steps) override;
+        bool fast_jump() const override { return true; }
+        void reseed(UIntType seed) override;
+        void reseed_from(const SeedSequence& seq) override;
+        // Saves the key, the stream and the position (the block is recomputed when needed)
+        void write_state(detail::StateWriter& out) const override;
+        void read_state(detail::StateReader& in) override;
+    public:
+        /// @brief Initializes the RNG with the specified seed (key) and stream
+        /// @param seed seed to initialize the RNG with
+        /// @param stream index of the stream to generate, streams of the same seed never overlap
+        /// @note The key is the first word of DiceForge::SeedSequence(seed), for any seed (zero included)
+        PhiloxEngine(UIntType seed, uint64_t stream = 0);
+        /// @brief Returns element i of the stream, without changing the state of the RNG
+        /// @param i index of the element
+        UIntType at(uint64_t i) const;
+        /// @brief Returns the index of the next element of the stream
+        uint64_t position() const
+        {
+            return m_position;
+        }
+        /// @brief Moves to element i of the stream, so that the next call to next() returns at(i)
+        /// @param i index of the element
+        void seek(uint64_t i)
+        {
+            m_position = i;
+        }
+        /// @brief Default destructor
+        ~PhiloxEngine() = default;
+    };
+
+    // Defined here so that it can be inlined through StaticView<PhiloxEngine<...>>
+    template <typename UIntType>
+    inline UIntType PhiloxEngine<UIntType>::generate()
+    {
+        uint64_t block = m_position / per_block;
+        if (!m_block_valid || block != m_block_index)
+        {
+            compute_block(block, m_block);
+            m_block_index = block;
+            m_block_valid = true;
+        }
+        return m_block[m_position++ % per_block];
+    }
+
+    /// @brief DiceForge::Philox32 - Philox4x32-10 counter-based RNG for generating 32-bit unsigned integers
+    typedef PhiloxEngine<uint32_t> Philox32;
+    /// @brief DiceForge::Philox64 - Philox4x32-10 counter-based RNG for generating 64-bit unsigned integers
+    typedef PhiloxEngine<uint64_t> Philox64;
+
+    // The out-of-line members are compiled once in Philox.cpp for these two engines
+    extern template class PhiloxEngine<uint32_t>;
+    extern template class PhiloxEngine<uint64_t>;
+
+    typedef Philox64 Philox;
+}
+
+#endif
@@ -0,0 +1,113 @@
+#include "Sobol.h"
+#include "sobol_directions.h"
+#include <stdexcept>
+
+namespace DiceForge
+{
+    Sobol::Sobol(unsigned dimensions, uint64_t seed) : m_dimensions(dimensions)
+    {
+        if (dimensions == 0 || dimensions > max_dimensions)
+            throw std::invalid_argument("Expected 1 to 1024 dimensions");
+
+        // v_k = m_k / 2^k as a 64 bit fraction, the m_k beyond the initial ones following the recurrence of the
+        // polynomial x^s + a_1 x^(s-1) + ... + a_(s-1) x + 1:
+        // v_k = a_1 v_(k-1) ^ ... ^ a_(s-1) v_(k-s+1) ^ v_(k-s) ^ (v_(k-s) >> s)
+        m_directions.assign(size_t(dimensions) * 64, 0);
+        for (int k = 0; k < 64; k++)
+            m_directions[k] = uint64_t(1) << (63 - k);
+        for (unsigned j = 1, offset = 0; j < dimensions; j++)
+        {
+            const unsigned poly = Sobol_directions::polynomials[j - 1];
+            int s = 0;
+            while ((poly >> (s + 1)) != 0)
+                s++;
+            uint64_t* v = m_directions.data() + size_t(j) * 64;
+            for (int k = 0; k < s; k++)
+                v[k] = uint64_t(Sobol_directions::initial[offset + k]) << (63 - k);
+            offset += s;
+            for (int k = s; k < 64; k++)
+            {
+                v[k] = v[k - s] ^ (v[k - s] >> s);
+                for (int i = 1; i < s; i++)
+                    if ((poly >> (s - i)) & 1)
+                        v[k] ^= v[k - i];
+            }
+        }
+
+        m_shift.assign(dimensions, 0);
+        m_point.assign(dimensions, 0);
+        reseed(seed);
+    }
+
+    void Sobol::reseed(uint64_t seed)
+    {
+        m_seed = seed;
+        uint64_t x = seed;
+        for (unsigned j = 0; j < m_dimensions; j++)
+            m_shift[j] = seed == 0 ? 0 : splitmix64(x);
+        seek(0);
+    }
+
+    void Sobol::write_state(detail::StateWriter& out) const
+    {
+        out.tag("Sobol");
+        out.put(uint32_t(m_dimensions));
+        out.put(m_seed);
+        out.put(position());
+    }
+
+    void Sobol::read_state(detail::StateReader& in)
+    {
+        in.tag("Sobol");
+        in.expect(uint32_t(m_dimensions));
+        const uint64_t seed = in.get<uint64_t>();
+        const uint64_t i = in.get<uint64_t>();
+        in.end();
+        reseed(seed);
+        seek(i);
+    }
+
+    void Sobol::seek(uint64_t i)
+    {
+        m_index = i / m_dimensions;
+        m_coordinate = unsigned(i % m_dimensions);
+        // point n is the XOR of the direction numbers picked out by the bits of its Gray code n ^ (n >> 1)
+        const uint64_t gray = m_index ^ (m_index >> 1);
+        for (unsigned j = 0; j < m_dimensions; j++)
+        {
+            const uint64_t* v = m_directions.data() + size_t(j) * 64;
+            uint64_t x = 0;
+            for (int k = 0; k < 64; k++)
+                if ((gray >> k) & 1)
+                    x ^= v[k];
+            m_point[j] = x;
+        }
+    }
+
+    void Sobol::jump_ahead(uint64_t steps)
+    {
+        seek(position() + steps);
+    }
+
+    void Sobol::generate_block(uint64_t* out, size_t n)
+    {
+        // Finish the current point, then write whole points straight to the buffer
+        while (n > 0 && m_coordinate < m_dimensions)
+        {
+            *out++ = m_point[m_coordinate] ^ m_shift[m_coordinate];
+            m_coordinate++;
+            n--;
+        }
+        while (n >= m_dimensions)
+        {
+            advance();
+            for (unsigned j = 0; j < m_dimensions; j++)
+                out[j] = m_point[j] ^ m_shift[j];
+            m_coordinate = m_dimensions;
+            out += m_dimensions;
+            n -= m_dimensions;
+        }
+        for (size_t i = 0; i < n; i++)
+            out[i] = Sobol::generate();
+    }
+}
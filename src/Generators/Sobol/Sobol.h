@@ -0,0 +1,94 @@
+#ifndef DF_SOBOL_H
+#define DF_SOBOL_H
+
+#include "generator.h"
+#include <vector>
+
+namespace DiceForge
+{
+    /// @brief DiceForge::Sobol - The Sobol low-discrepancy sequence in up to 1024 dimensions, with the direction
+    /// numbers of Joe and Kuo
+    /// @note Hands out the coordinates of the points one after the other (point 0 in all dimensions, then
+    /// point 1, ...), so fill_unit(x, dimensions()) or next_point(x) draws one point of the unit cube, and element
+    /// i of the stream is coordinate i % dimensions() of point i / dimensions(). For quasi-Monte Carlo runs it can
+    /// replace a PRNG anywhere random reals are drawn in groups of dimensions() (e.g. monte_carlo_integrate).
+    /// @note Consecutive points differ by one direction number per coordinate (Gray code order), and jump() /
+    /// seek() compute any point directly, so that threads can take disjoint ranges of points.
+    /// @note The first point is the origin (or the shift, when scrambled).
+    class Sobol : public Generator<uint64_t>
+    {
+        friend class StaticView<Sobol>;
+    public:
+        /// @brief Largest number of dimensions supported
+        static constexpr unsigned max_dimensions = 1024;
+    private:
+        unsigned m_dimensions;
+        std::vector<uint64_t> m_directions; // Direction numbers, 64 per dimension
+        std::vector<uint64_t> m_shift;      // Random digital shift of each coordinate (zero when not scrambled)
+        std::vector<uint64_t> m_point;      // Unshifted coordinates of point m_index
+        uint64_t m_index;                   // Index of the current point
+        unsigned m_coordinate;              // Next coordinate of the current point to be handed out
+        uint64_t m_seed;                    // Seed of the digital shift
+        // Moves on to the next point in Gray code order
+        void advance();
+        uint64_t generate() override;
+        void generate_block(uint64_t* out, size_t n) override;
+        // Computes the point reached directly from the Gray code of its index
+        void jump_ahead(uint64_t steps) override;
+        bool fast_jump() const override { return true; }
+        void reseed(uint64_t seed) override;
+        // Saves the seed and the position, from which load_state rebuilds the shift and the point
+        void write_state(detail::StateWriter& out) const override;
+        void read_state(detail::StateReader& in) override;
+    public:
+        /// @brief Initializes the sequence in the given number of dimensions
+        /// @param dimensions number of coordinates of every point (1 to max_dimensions)
+        /// @param seed 0 for the plain Sobol sequence, any other seed for a random digital shift (XOR of every
+        /// coordinate with a random number), which keeps the low discrepancy and makes independent replicas
+        Sobol(unsigned dimensions, uint64_t seed = 0);
+        /// @brief Number of coordinates of every point
+        unsigned dimensions() const
+        {
+            return m_dimensions;
+        }
+        /// @brief Writes the next point of the unit cube to x (dimensions() reals)
+        void next_point(real_t* x)
+        {
+            fill_unit(x, m_dimensions);
+        }
+        /// @brief Returns the index of the next element of the stream
+        uint64_t position() const
+        {
+            return m_index * m_dimensions + m_coordinate;
+        }
+        /// @brief Moves to element i of the stream, e.g. seek(k * dimensions()) to start from point k
+        /// @param i index of the element
+        void seek(uint64_t i);
+        /// @brief Default destructor
+        ~Sobol() = default;
+    };
+
+    // Defined here so that it can be inlined through StaticView<Sobol>
+    inline void Sobol::advance()
+    {
+        // the lowest zero bit of the index is the one whose Gray code bit flips
+        int c = 0;
+        for (uint64_t i = m_index; i & 1; i >>= 1)
+            c++;
+        const uint64_t* v = m_directions.data() + c;
+        for (unsigned j = 0; j < m_dimensions; j++, v += 64)
+            m_point[j] ^= *v;
+        m_index++;
+        m_coordinate = 0;
+    }
+
+    inline uint64_t Sobol::generate()
+    {
+        if (m_coordinate == m_dimensions)
+            advance();
+        const unsigned j = m_coordinate++;
+        return m_point[j] ^ m_shift[j];
+    }
+}
+
+#endif
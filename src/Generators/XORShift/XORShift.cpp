@@ -1,8 +1,81 @@
 #include "XORShift.h"
-#include <chrono>
+#include "simd.h"
 
 namespace DiceForge
 {
+    namespace
+    {
+        // Shift triples of XORShift32 and XORShift64
+        template <typename W>
+        struct XORShiftShifts;
+        template <>
+        struct XORShiftShifts<uint32_t> { static constexpr int a = 13, b = 17, c = 5; };
+        template <>
+        struct XORShiftShifts<uint64_t> { static constexpr int a = 13, b = 7, c = 17; };
+
+        // The next non-zero word of the expansion from word i on, cut to W (a zero state would stay zero)
+        template <typename W>
+        W nonzero_word(const SeedSequence& seq, size_t& i)
+        {
+            W w;
+            do {
+                w = W(seq.word(i++));
+            } while (w == 0);
+            return w;
+        }
+
+        // Powers of the transition matrix T of the XORShift state, which is linear over GF(2):
+        // power[i][j] is the image of the j-th unit vector under T^(2^i)
+        template <typename W>
+        struct JumpTable
+        {
+            static constexpr int bits = 8 * sizeof(W);
+            W power[64][bits];
+        };
+
+        // Image of x under the matrix given by its columns
+        template <typename W>
+        W apply(const W* columns, W x)
+        {
+            W y = 0;
+            for (int j = 0; x != 0; j++, x >>= 1)
+                if (x & 1)
+                    y ^= columns[j];
+            return y;
+        }
+
+        template <typename W>
+        JumpTable<W> make_jump_table()
+        {
+            typedef XORShiftShifts<W> Sh;
+            JumpTable<W> t;
+            for (int j = 0; j < t.bits; j++)
+            {
+                W s = W(1) << j;
+                s ^= s << Sh::a;
+                s ^= s >> Sh::b;
+                s ^= s << Sh::c;
+                t.power[0][j] = s;
+            }
+            for (int i = 1; i < 64; i++)
+                for (int j = 0; j < t.bits; j++)
+                    t.power[i][j] = apply(t.power[i - 1], t.power[i - 1][j]);
+            return t;
+        }
+
+        // The state after the given number of steps, in O(log steps) time
+        template <typename W>
+        W jump_state(W state, uint64_t steps)
+        {
+            static const JumpTable<W> table = make_jump_table<W>();
+            for (int i = 0; steps != 0; i++, steps >>= 1)
+                if (steps & 1)
+                    state = apply(table.power[i], state);
+            return state;
+        }
+    }
+
+
     XORShift32::XORShift32(uint32_t seed)
     {
         reseed(seed);
@@ -10,20 +83,46 @@ namespace DiceForge
 
     void XORShift32::reseed(uint32_t seed)
     {
-        if (seed == 0){
-            m_state = std::chrono::high_resolution_clock::now().time_since_epoch().count();
-        }
-        else {
-            m_state = seed;
+        reseed_from(SeedSequence(seed));
+    }
+
+    void XORShift32::reseed_from(const SeedSequence& seq)
+    {
+        size_t i = 0;
+        m_state = nonzero_word<uint32_t>(seq, i);
+    }
+
+    void XORShift32::write_state(detail::StateWriter& out) const
+    {
+        out.tag("XORShift32");
+        out.put(m_state);
+    }
+
+    void XORShift32::read_state(detail::StateReader& in)
+    {
+        in.tag("XORShift32");
+        const uint32_t state = in.get<uint32_t>();
+        in.end();
+        m_state = state;
+    }
+
+    void XORShift32::generate_block(uint32_t* out, size_t n)
+    {
+        // Work on a local copy so the state can stay in a register for the whole block
+        uint32_t s = m_state;
+        for (size_t i = 0; i < n; i++)
+        {
+            s ^= s << 13;
+            s ^= s >> 17;
+            s ^= s << 5;
+            out[i] = s * 0x2545F4914F6CDD1DULL;
         }
+        m_state = s;
     }
 
-    uint32_t XORShift32::generate()
+    void XORShift32::jump_ahead(uint64_t steps)
     {
-        m_state ^= m_state << 13;
-        m_state ^= m_state >> 17;
-        m_state ^= m_state << 5;
-        return m_state * 0x2545F4914F6CDD1DULL;
+        m_state = jump_state(m_state, steps);
     }
 
     XORShift64::XORShift64(uint64_t seed)
@@ -33,19 +132,187 @@ namespace DiceForge
 
     void XORShift64::reseed(uint64_t seed)
     {
-        if (seed == 0){
-            m_state = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+        reseed_from(SeedSequence(seed));
+    }
+
+    void XORShift64::reseed_from(const SeedSequence& seq)
+    {
+        size_t i = 0;
+        m_state = nonzero_word<uint64_t>(seq, i);
+    }
+
+    void XORShift64::write_state(detail::StateWriter& out) const
+    {
+        out.tag("XORShift64");
+        out.put(m_state);
+    }
+
+    void XORShift64::read_state(detail::StateReader& in)
+    {
+        in.tag("XORShift64");
+        const uint64_t state = in.get<uint64_t>();
+        in.end();
+        m_state = state;
+    }
+
+    void XORShift64::generate_block(uint64_t* out, size_t n)
+    {
+        // Work on a local copy so the state can stay in a register for the whole block
+        uint64_t s = m_state;
+        for (size_t i = 0; i < n; i++)
+        {
+            s ^= s << 13;
+            s ^= s >> 7;
+            s ^= s << 17;
+            out[i] = s * 0x2545F4914F6CDD1DULL;
+        }
+        m_state = s;
+    }
+
+    void XORShift64::jump_ahead(uint64_t steps)
+    {
+        m_state = jump_state(m_state, steps);
+    }
+
+    template <typename UIntType, int Lanes>
+    XORShiftMultiLane<UIntType, Lanes>::XORShiftMultiLane(UIntType seed)
+    {
+        reseed(seed);
+    }
+
+    template <typename UIntType, int Lanes>
+    void XORShiftMultiLane<UIntType, Lanes>::reseed(UIntType seed)
+    {
+        reseed_from(SeedSequence(seed));
+    }
+
+    template <typename UIntType, int Lanes>
+    void XORShiftMultiLane<UIntType, Lanes>::reseed_from(const SeedSequence& seq)
+    {
+        // Every lane needs its own non-zero state
+        size_t i = 0;
+        for (int j = 0; j < Lanes; j++)
+            m_state[j] = nonzero_word<UIntType>(seq, i);
+        m_index = Lanes;
+    }
+
+    template <typename UIntType, int Lanes>
+    void XORShiftMultiLane<UIntType, Lanes>::write_state(detail::StateWriter& out) const
+    {
+        out.tag("XORShiftMultiLane");
+        out.put(uint8_t(sizeof(UIntType)));
+        out.put(uint8_t(Lanes));
+        out.put(m_state, Lanes);
+        // Only the outputs of the last step that are still to be handed out
+        out.put(uint8_t(m_index));
+        out.put(m_buffer + m_index, Lanes - m_index);
+    }
+
+    template <typename UIntType, int Lanes>
+    void XORShiftMultiLane<UIntType, Lanes>::read_state(detail::StateReader& in)
+    {
+        in.tag("XORShiftMultiLane");
+        in.expect(uint8_t(sizeof(UIntType)));
+        in.expect(uint8_t(Lanes));
+        UIntType state[Lanes];
+        in.get(state, Lanes);
+        const int index = in.get<uint8_t>();
+        if (index > Lanes)
+            throw std::invalid_argument("The saved state does not fit this object");
+        UIntType buffer[Lanes];
+        in.get(buffer + index, Lanes - index);
+        in.end();
+        std::copy(buffer + index, buffer + Lanes, m_buffer + index);
+        std::copy(state, state + Lanes, m_state);
+        m_index = index;
+    }
+
+    template <typename UIntType, int Lanes>
+    void XORShiftMultiLane<UIntType, Lanes>::advance(UIntType* out, size_t steps)
+    {
+        typedef XORShiftShifts<UIntType> Sh;
+        const UIntType mult = UIntType(0x2545F4914F6CDD1DULL);
+#if defined(DF_SIMD)
+        typedef simd::Lanes<UIntType> L;
+        if constexpr (Lanes % L::width == 0)
+        {
+            // The states are kept in registers for all the steps
+            constexpr int V = Lanes / L::width;
+            typename L::vec s[V];
+            const typename L::vec m = L::set1(mult);
+            for (int v = 0; v < V; v++)
+                s[v] = L::load(m_state + v * L::width);
+            for (size_t i = 0; i < steps; i++, out += Lanes)
+            {
+                for (int v = 0; v < V; v++)
+                {
+                    s[v] = L::bxor(s[v], L::sll(s[v], Sh::a));
+                    s[v] = L::bxor(s[v], L::srl(s[v], Sh::b));
+                    s[v] = L::bxor(s[v], L::sll(s[v], Sh::c));
+                    L::store(out + v * L::width, L::mul(s[v], m));
+                }
+            }
+            for (int v = 0; v < V; v++)
+                L::store(m_state + v * L::width, s[v]);
+            return;
         }
-        else {
-            m_state = seed;
+#endif
+        for (size_t i = 0; i < steps; i++, out += Lanes)
+        {
+            for (int j = 0; j < Lanes; j++)
+            {
+                UIntType& s = m_state[j];
+                s ^= s << Sh::a;
+                s ^= s >> Sh::b;
+                s ^= s << Sh::c;
+                out[j] = s * mult;
+            }
         }
     }
 
-    uint64_t XORShift64::generate()
+    template <typename UIntType, int Lanes>
+    void XORShiftMultiLane<UIntType, Lanes>::generate_block(UIntType* out, size_t n)
     {
-        m_state ^= m_state << 13;
-        m_state ^= m_state >> 7;
-        m_state ^= m_state << 17;
-        return m_state * 0x2545F4914F6CDD1DULL;
+        // Use up what is left of the last step first, so that the stream is the same as with next()
+        while (n > 0 && m_index < Lanes)
+        {
+            *out++ = m_buffer[m_index++];
+            n--;
+        }
+        size_t steps = n / Lanes;
+        advance(out, steps);
+        out += steps * Lanes;
+        n -= steps * Lanes;
+        if (n > 0)
+        {
+            advance(m_buffer, 1);
+            for (m_index = 0; size_t(m_index) < n; m_index++)
+                out[m_index] = m_buffer[m_index];
+        }
+    }
+
+    template <typename UIntType, int Lanes>
+    void XORShiftMultiLane<UIntType, Lanes>::jump_ahead(uint64_t steps)
+    {
+        // Outputs left over from the last step come first
+        uint64_t left = Lanes - m_index;
+        if (steps <= left)
+        {
+            m_index += int(steps);
+            return;
+        }
+        steps -= left;
+        // Then whole steps of all the lanes, and finally part of one more step
+        for (int j = 0; j < Lanes; j++)
+            m_state[j] = jump_state(m_state[j], steps / Lanes);
+        m_index = Lanes;
+        if (steps % Lanes != 0)
+        {
+            advance(m_buffer, 1);
+            m_index = int(steps % Lanes);
+        }
     }
+
+    template class XORShiftMultiLane<uint64_t, 4>;
+    template class XORShiftMultiLane<uint32_t, 8>;
 }
\ No newline at end of file
@@ -11,39 +11,130 @@ namespace DiceForge
     /// @note Generates 32-bit unsigned integers
     class XORShift32 : public Generator<uint32_t>
     {
+        friend class StaticView<XORShift32>;
     private:
         uint32_t m_state;   // Internal state
         uint32_t generate() override;
+        void generate_block(uint32_t* out, size_t n) override;
+        // Jumps with precomputed powers of the (linear) transition matrix of the state
+        void jump_ahead(uint64_t steps) override;
+        bool fast_jump() const override { return true; }
         void reseed(uint32_t seed) override;
+        void reseed_from(const SeedSequence& seq) override;
+        void write_state(detail::StateWriter& out) const override;
+        void read_state(detail::StateReader& in) override;
     public:
         /// @brief Initializes the XOR Shift RNG with the specified seed
-        /// @param seed must be a non-zero number
-        /// @note If the given seed is zero, then the current system is used as the seed
+        /// @param seed seed to initialize the RNG with
+        /// @note Every seed, zero included, gives its own (non-zero) state, expanded from it by DiceForge::SeedSequence
         XORShift32(uint32_t seed);
         /// @brief Default destructor
         ~XORShift32() = default;
     };
 
+    // Defined here so that it can be inlined through StaticView<XORShift32>
+    inline uint32_t XORShift32::generate()
+    {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 17;
+        m_state ^= m_state << 5;
+        return m_state * 0x2545F4914F6CDD1DULL;
+    }
+
     /// @brief DiceForge::XORShift64 - A PRNG following the XORShift* algorithm
     /// A naive implementation of the original XORShift algorithm proposed by Marsaglia
     /// followed by a multiplicative transform
     /// @note Generates 64-bit unsigned integers
     class XORShift64 : public Generator<uint64_t>
     {
+        friend class StaticView<XORShift64>;
     private:
         uint64_t m_state;   // Internal state
         uint64_t generate() override;
+        void generate_block(uint64_t* out, size_t n) override;
+        // Jumps with precomputed powers of the (linear) transition matrix of the state
+        void jump_ahead(uint64_t steps) override;
+        bool fast_jump() const override { return true; }
         void reseed(uint64_t seed) override;
+        void reseed_from(const SeedSequence& seq) override;
+        void write_state(detail::StateWriter& out) const override;
+        void read_state(detail::StateReader& in) override;
     public:
         /// @brief Initializes the XOR Shift RNG with the specified seed
-        /// @param seed must be a non-zero number
-        /// @note If the given seed is zero, then the current system is used as the seed
+        /// @param seed seed to initialize the RNG with
+        /// @note Every seed, zero included, gives its own (non-zero) state, expanded from it by DiceForge::SeedSequence
         XORShift64(uint64_t seed);
         /// @brief Default destructor
         ~XORShift64() = default;
     };
 
+    // Defined here so that it can be inlined through StaticView<XORShift64>
+    inline uint64_t XORShift64::generate()
+    {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 7;
+        m_state ^= m_state << 17;
+        return m_state * 0x2545F4914F6CDD1DULL;
+    }
+
+    /// @brief DiceForge::XORShiftMultiLane - Runs several independently seeded XORShift* generators
+    /// side by side in SIMD registers and hands out their outputs interleaved
+    /// @tparam UIntType uint32_t (same lanes as XORShift32) or uint64_t (same lanes as XORShift64)
+    /// @tparam Lanes number of lanes; every step of the generator advances all of them at once
+    /// @note Meant to be used through fill() / fill_unit(), which step all lanes for whole runs of the block
+    /// while the states stay in registers. Single calls to next() are served from the last step's outputs.
+    template <typename UIntType, int Lanes>
+    class XORShiftMultiLane : public Generator<UIntType>
+    {
+        friend class StaticView<XORShiftMultiLane>;
+    private:
+        UIntType m_state[Lanes];    // Internal state of each lane
+        UIntType m_buffer[Lanes];   // Outputs of the last step
+        int m_index;                // Index of the next unused output in m_buffer
+        // Steps all lanes the given number of times, writing Lanes outputs per step to out
+        void advance(UIntType* out, size_t steps);
+        UIntType generate() override;
+        void generate_block(UIntType* out, size_t n) override;
+        // Jumps every lane with precomputed powers of the transition matrix of XORShift32 / XORShift64
+        void jump_ahead(uint64_t steps) override;
+        bool fast_jump() const override { return true; }
+        void reseed(UIntType seed) override;
+        void reseed_from(const SeedSequence& seq) override;
+        void write_state(detail::StateWriter& out) const override;
+        void read_state(detail::StateReader& in) override;
+    public:
+        /// @brief Initializes the lanes with seeds derived from the specified seed
+        /// @param seed seed to initialize the RNG with
+        /// @note The lanes take the successive non-zero words of DiceForge::SeedSequence(seed), for any seed
+        XORShiftMultiLane(UIntType seed);
+        /// @brief Default destructor
+        ~XORShiftMultiLane() = default;
+    };
+
+    // Defined here so that it can be inlined through StaticView<XORShiftMultiLane<...>>
+    template <typename UIntType, int Lanes>
+    inline UIntType XORShiftMultiLane<UIntType, Lanes>::generate()
+    {
+        if (m_index >= Lanes)
+        {
+            advance(m_buffer, 1);
+            m_index = 0;
+        }
+        return m_buffer[m_index++];
+    }
+
+    /// @brief DiceForge::XORShift64x4 - Four interleaved XORShift64* lanes
+    typedef XORShiftMultiLane<uint64_t, 4> XORShift64x4;
+    /// @brief DiceForge::XORShift32x8 - Eight interleaved XORShift32* lanes
+    typedef XORShiftMultiLane<uint32_t, 8> XORShift32x8;
+
+    // The out-of-line members are compiled once in XORShift.cpp for these two engines
+    extern template class XORShiftMultiLane<uint64_t, 4>;
+    extern template class XORShiftMultiLane<uint32_t, 8>;
+
     typedef XORShift64 XORShift;
+    typedef XORShift64x4 XORShiftx4;
+    typedef XORShift32x8 XORShiftx8;
 }
 
 #endif
@@ -0,0 +1,3 @@
+// The whole library as one translation unit (the CMake option DICEFORGE_UNITY)
+#define DF_IMPLEMENTATION
+#include "diceforge.h"
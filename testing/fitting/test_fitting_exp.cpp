@@ -35,7 +35,7 @@ int main(int argc, char const *argv[])
     std::cout << "fit: x0 = " << fit.get_x0() << ", k = " << fit.get_k() << std::endl;
 
     FILE* gnuplot = popen("gnuplot -persist", "w");
-    fprintf(gnuplot, "f(x)= x==%f ? 0 : exp(-%f * (x - %f))\n", fit.get_x0(), fit.get_k(), fit.get_x0());
+    fprintf(gnuplot, "f(x)= x==%f ? 0 : %f * exp(-%f * (x - %f))\n", fit.get_x0(), fit.get_k(), fit.get_k(), fit.get_x0());
     fprintf(gnuplot, "set samples 1000\n plot 'noisy_data.dat' title 'samples', f(x) title 'fit curve'\n");
     fclose(gnuplot);
 
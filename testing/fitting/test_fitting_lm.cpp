@@ -0,0 +1,74 @@
+#include "diceforge.h"
+#include <iostream>
+#include <chrono>
+
+#define NUM_POINTS 1000000
+#define NOISE_AMP 0.01
+
+// Fits a large noisy sample of every distribution with a fitTo* function and reports the
+// recovered parameters next to the true ones, together with the time each fit took
+
+template <typename Dist>
+void make_data(const Dist& d, DiceForge::XORShift32& rng, double lo, double hi, std::vector<double>& x, std::vector<double>& y)
+{
+    x.clear();
+    y.clear();
+    for (int i = 0; i < NUM_POINTS; i++)
+    {
+        double x1 = rng.next_in_crange(lo, hi);
+        x.push_back(x1);
+        y.push_back(d.pdf(x1) * (1 + NOISE_AMP * (rng.next_unit() - 0.5)));
+    }
+}
+
+template <typename Fit>
+void timed(const char* name, Fit fit)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    fit();
+    std::chrono::duration<double, std::milli> t = std::chrono::high_resolution_clock::now() - start;
+    std::cout << name << "\t" << t.count() << "ms" << std::endl;
+}
+
+int main(int argc, char const *argv[])
+{
+    DiceForge::XORShift32 rng = DiceForge::XORShift32(42);
+    std::vector<double> x, y;
+
+    DiceForge::Gaussian gauss = DiceForge::Gaussian(0.7, 1.3);
+    make_data(gauss, rng, -4, 6, x, y);
+    timed("Gaussian", [&]() {
+        DiceForge::Gaussian fit = DiceForge::fitToGaussian(x, y, 1000, 1e-9);
+        std::cout << "mu = " << fit.get_mu() << " (0.7), sigma = " << fit.get_sigma() << " (1.3)" << std::endl;
+    });
+
+    DiceForge::Maxwell maxwell = DiceForge::Maxwell(1.7);
+    make_data(maxwell, rng, 0, 8, x, y);
+    timed("Maxwell", [&]() {
+        DiceForge::Maxwell fit = DiceForge::fitToMaxwell(x, y, 1000, 1e-9);
+        std::cout << "a = " << fit.get_a() << " (1.7)" << std::endl;
+    });
+
+    DiceForge::Weibull bull = DiceForge::Weibull(1.5, 2.2);
+    make_data(bull, rng, 0.01, 5, x, y);
+    timed("Weibull", [&]() {
+        DiceForge::Weibull fit = DiceForge::fitToWeibull(x, y, 1000, 1e-9);
+        std::cout << "lambda = " << fit.get_lambda() << " (1.5), k = " << fit.get_k() << " (2.2)" << std::endl;
+    });
+
+    DiceForge::Cauchy cauchy = DiceForge::Cauchy(0.4, 0.8);
+    make_data(cauchy, rng, -10, 10, x, y);
+    timed("Cauchy", [&]() {
+        DiceForge::Cauchy fit = DiceForge::fitToCauchy(x, y, 1000, 1e-9);
+        std::cout << "x0 = " << fit.get_x0() << " (0.4), gamma = " << fit.get_gamma() << " (0.8)" << std::endl;
+    });
+
+    DiceForge::Exponential expnen = DiceForge::Exponential(2.5, 0);
+    make_data(expnen, rng, 0, 4, x, y);
+    timed("Exponential", [&]() {
+        DiceForge::Exponential fit = DiceForge::fitToExponential(x, y, 1000, 1e-9);
+        std::cout << "k = " << fit.get_k() << " (2.5), x0 = " << fit.get_x0() << " (0)" << std::endl;
+    });
+
+    return 0;
+}
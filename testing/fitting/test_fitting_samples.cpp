@@ -0,0 +1,77 @@
+#include "diceforge.h"
+#include <iostream>
+#include <chrono>
+
+#define NUM_SAMPLES 1000000
+
+// Draws raw samples from every distribution with a fit*FromSamples function, fits them back by maximum
+// likelihood and reports the recovered parameters next to the true ones. The accumulators are also filled
+// with the two halves of the sample separately and merged, which has to agree with the whole.
+
+template <typename Fit>
+void timed(const char* name, Fit fit)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    fit();
+    std::chrono::duration<double, std::milli> t = std::chrono::high_resolution_clock::now() - start;
+    std::cout << name << "\t" << t.count() << "ms" << std::endl;
+}
+
+template <typename Accumulator>
+void check_merge(const char* name, const std::vector<double>& s)
+{
+    Accumulator whole, first, second;
+    whole.add(s.data(), s.size());
+    first.add(s.data(), s.size() / 3);
+    second.add(s.data() + s.size() / 3, s.size() - s.size() / 3);
+    first.merge(second);
+    double a = whole.fit().expectation(), b = first.fit().expectation();
+    std::cout << name << " merge: " << ((fabs(a - b) <= 1e-12 * fabs(a) && first.count() == whole.count()) ? "OK" : "FAILED") << std::endl;
+}
+
+int main(int argc, char const *argv[])
+{
+    DiceForge::XORShift64 rng = DiceForge::XORShift64(42);
+    std::vector<double> s(NUM_SAMPLES);
+
+    DiceForge::Gaussian gauss = DiceForge::Gaussian(0.7, 1.3);
+    gauss.sample(rng, s.data(), s.size());
+    timed("Gaussian", [&]() {
+        DiceForge::Gaussian fit = DiceForge::fitGaussianFromSamples(s);
+        std::cout << "mu = " << fit.get_mu() << " (0.7), sigma = " << fit.get_sigma() << " (1.3)" << std::endl;
+    });
+    check_merge<DiceForge::GaussianAccumulator>("Gaussian", s);
+
+    DiceForge::Exponential expnen = DiceForge::Exponential(2.5, 1);
+    expnen.sample(rng, s.data(), s.size());
+    timed("Exponential", [&]() {
+        DiceForge::Exponential fit = DiceForge::fitExponentialFromSamples(s);
+        std::cout << "k = " << fit.get_k() << " (2.5), x0 = " << fit.get_x0() << " (1)" << std::endl;
+    });
+    check_merge<DiceForge::ExponentialAccumulator>("Exponential", s);
+
+    DiceForge::Maxwell maxwell = DiceForge::Maxwell(1.7);
+    maxwell.sample(rng, s.data(), s.size());
+    timed("Maxwell", [&]() {
+        DiceForge::Maxwell fit = DiceForge::fitMaxwellFromSamples(s);
+        std::cout << "a = " << fit.get_a() << " (1.7)" << std::endl;
+    });
+    check_merge<DiceForge::MaxwellAccumulator>("Maxwell", s);
+
+    DiceForge::Weibull bull = DiceForge::Weibull(1.5, 2.2);
+    bull.sample(rng, s.data(), s.size());
+    timed("Weibull", [&]() {
+        DiceForge::Weibull fit = DiceForge::fitWeibullFromSamples(s);
+        std::cout << "lambda = " << fit.get_lambda() << " (1.5), k = " << fit.get_k() << " (2.2)" << std::endl;
+    });
+    check_merge<DiceForge::WeibullAccumulator>("Weibull", s);
+
+    DiceForge::Cauchy cauchy = DiceForge::Cauchy(0.4, 0.8);
+    cauchy.sample(rng, s.data(), s.size());
+    timed("Cauchy", [&]() {
+        DiceForge::Cauchy fit = DiceForge::fitCauchyFromSamples(s);
+        std::cout << "x0 = " << fit.get_x0() << " (0.4), gamma = " << fit.get_gamma() << " (0.8)" << std::endl;
+    });
+
+    return 0;
+}
@@ -1,6 +1,7 @@
 #ifndef RNG_TESTER_H
 #define RNG_TESTER_H
 
+#include "diceforge_core.h"
 #include "diceforge_generators.h"
 
 #include <chrono>
@@ -30,8 +31,7 @@ std::vector<size_t> test_scatter(DiceForge::Generator<T>& G, int count)
 template <typename T>
 std::vector<int> test_mod_frequency(DiceForge::Generator<T>& G, int count, int x)
 {
-    std::vector<int> s;
-    s.reserve(x);
+    std::vector<int> s(x);
     for (int i = 0; i < count; i++)
     {
         s[G.next_in_range(0, x-1)]++;
@@ -40,7 +40,7 @@ std::vector<int> test_mod_frequency(DiceForge::Generator<T>& G, int count, int x
 }
 
 /// @brief test_bin_frequency - it scales the unit random real generated [0, 1) by the RNG to [0, bins) and creates a frequency distribution of
-/// the closest integer that the generated number is to
+/// the bin (integer part) that the generated number falls into
 /// @param G random number generator to be tested
 /// @param count number of random numbers to be generated for testing 
 /// @param bins number 
@@ -48,11 +48,15 @@ std::vector<int> test_mod_frequency(DiceForge::Generator<T>& G, int count, int x
 template <typename T>
 std::vector<int> test_bin_frequency(DiceForge::Generator<T>& G, int count, int bins)
 {
-    std::vector<int> s;
-    s.reserve(bins);
+    DiceForge::Histogram h(0, 1, bins);
     for (int i = 0; i < count; i++)
     {
-        s[floor(G.next_in_crange(0.0, bins+1))]++;
+        h.add(G.next_unit());
+    }
+    std::vector<int> s(bins);
+    for (int i = 0; i < bins; i++)
+    {
+        s[i] = int(h[i]);
     }
     return s;
 }
@@ -60,34 +64,20 @@ std::vector<int> test_bin_frequency(DiceForge::Generator<T>& G, int count, int b
 /// @param G random number generator to be tested
 /// @param count number of random numbers to be generated for testing 
 /// @return a vector containing {mean, variance, minimum, maximum}
+/// @note The values are streamed through DiceForge::Moments a buffer at a time, in constant memory
 template <typename T>
-std::vector<double> test_statistical(DiceForge::Generator<T>& G, int count)
+std::vector<double> test_statistical(DiceForge::Generator<T>& G, long long count)
 {
-    std::vector<double> s;
-    s.reserve(count);
-    for (int i = 0; i < count; i++)
+    DiceForge::Moments m;
+    std::vector<double> buffer(4096);
+    for (long long i = 0; i < count; i += buffer.size())
     {
-        s.emplace_back(G.next_unit());
-    }
-    
-    double x = 0, x2 = 0, min = 1, max = 0;
-    for (int i = 0; i < count; i++)
-    {
-        x += s[i];
-        x2 += s[i] * s[i];
-
-        if (s[i] < min) min = s[i];
-        if (s[i] > max) max = s[i];
+        const size_t n = size_t(std::min<long long>(buffer.size(), count - i));
+        G.fill_unit(buffer.data(), n);
+        m.add(buffer.data(), n);
     }
 
-    std::vector<double> stat_data = {0,0,0,0};   // mean, variance, minimum, maximum
-
-    stat_data[0] = x/count;
-    stat_data[1] = x2/count - (x/count) * (x/count);
-    stat_data[2] = min;
-    stat_data[3] = max;
-
-    return stat_data;
+    return {m.mean(), m.variance(), m.min(), m.max()};   // mean, variance, minimum, maximum
 }
 
 /// @brief test_time - calculates the time taken by the RNG to generate the specified count of integers
@@ -128,4 +118,74 @@ double test_time_floats(DiceForge::Generator<T>& G, int count)
     return (end - start).count() * 1e-6;
 }
 
+/// @brief test_time_bulk_integers - calculates the time taken by the RNG to fill buffers with the specified count of integers
+/// @param G random number generator to be tested
+/// @param count number of random integers to be generated 
+/// @param block number of integers generated per call of fill()
+/// @return time taken to generate the numbers in milliseconds
+template <typename T>
+double test_time_bulk_integers(DiceForge::Generator<T>& G, int count, int block = 4096)
+{
+    std::vector<T> buffer(block);
+
+    std::chrono::time_point start = std::chrono::high_resolution_clock::now();
+
+    for (int i = 0; i < count; i += block)
+    {
+        G.fill(buffer.data(), std::min(block, count - i));
+    }    
+
+    std::chrono::time_point end = std::chrono::high_resolution_clock::now();
+
+    return (end - start).count() * 1e-6;
+}
+
+/// @brief test_time_bulk_floats - calculates the time taken by the RNG to fill buffers with the specified count of floats
+/// @param G random number generator to be tested
+/// @param count number of random floats to be generated 
+/// @param block number of floats generated per call of fill_unit()
+/// @return time taken to generate the numbers in milliseconds
+template <typename T>
+double test_time_bulk_floats(DiceForge::Generator<T>& G, int count, int block = 4096)
+{
+    std::vector<double> buffer(block);
+
+    std::chrono::time_point start = std::chrono::high_resolution_clock::now();
+
+    for (int i = 0; i < count; i += block)
+    {
+        G.fill_unit(buffer.data(), std::min(block, count - i));
+    }    
+
+    std::chrono::time_point end = std::chrono::high_resolution_clock::now();
+
+    return (end - start).count() * 1e-6;
+}
+
+/// @brief test_time_static_floats - calculates the time taken by a non-virtual view (DiceForge::StaticView) of the RNG
+/// to generate the specified count of floats
+/// @param G random number generator to be tested
+/// @param count number of random floats to be generated 
+/// @return time taken to generate the numbers in milliseconds
+template <typename Engine>
+double test_time_static_floats(Engine& G, int count)
+{
+    auto S = DiceForge::make_static(G);
+    // Accumulated so that the inlined loop cannot be optimized away
+    volatile double sink = 0;
+    double sum = 0;
+
+    std::chrono::time_point start = std::chrono::high_resolution_clock::now();
+
+    for (int i = 0; i < count; i++)
+    {
+        sum += S.next_unit();
+    }    
+
+    std::chrono::time_point end = std::chrono::high_resolution_clock::now();
+
+    sink = sum;
+    return (end - start).count() * 1e-6;
+}
+
 #endif 
@@ -46,10 +46,69 @@ void test_double_integral_2()
     std::cout << std::setprecision(17) << "actual_answer = " << actual_answer << std::endl;
 }
 
+template <typename Type>
+void test_quadrature_orders()
+{
+    // N-point rules integrate polynomials of degree below 2N exactly
+    auto x15 = [](Type x)
+    {
+        Type p = 1;
+        for (int i = 0; i < 15; i++)
+            p *= x;
+        return p;
+    };
+    std::cout << std::setprecision(17) << "8-point x^15 on [0, 2] = " << DiceForge::gauss_legendre<8>(x15, Type{0}, Type{2}) << std::endl;
+    std::cout << std::setprecision(17) << "16-point x^15 on [0, 2] = " << DiceForge::gauss_legendre<16>(x15, Type{0}, Type{2}) << std::endl;
+    std::cout << std::setprecision(17) << "actual_answer = " << 65536.0 / 16 << std::endl;
+
+    // batch integrands evaluate all nodes in one call
+    DiceForge::Gaussian g(0, 1);
+    auto pdf = [&](const Type* x, Type* y, size_t n) { g.pdf(x, y, n); };
+    std::cout << std::setprecision(17) << "batch P(|Z| < 3) = " << DiceForge::gauss_legendre<64>(pdf, Type{-3}, Type{3}) << std::endl;
+    std::cout << std::setprecision(17) << "actual_answer = " << std::erf(3 / std::sqrt(2.0)) << std::endl;
+}
+
+template <typename Type>
+void test_parallel_and_cubature()
+{
+    auto z = [](auto x, auto y)
+    {
+        return 16 - x * x - y * y;
+    };
+    auto bound_y = std::make_tuple(Type{0}, Type{2});
+    auto bound_x = std::make_tuple([](auto y) { return y * y / 4; }, [](auto y) { return (y + 2) / 4; });
+    auto actual_answer = 20803.0 / 1680.0;
+
+    // the parallel mode has to give exactly the serial result
+    auto serial = DiceForge::integrate(z, bound_y, bound_x, DiceForge::dx_dy);
+    auto parallel = DiceForge::integrate(z, bound_y, bound_x, DiceForge::dx_dy, DiceForge::parallel_t{4});
+    std::cout << "parallel == serial: " << (serial == parallel ? "OK" : "FAILED") << std::endl;
+
+    auto r = DiceForge::cubature(z, bound_y, bound_x, DiceForge::dx_dy);
+    std::cout << std::setprecision(17) << "cubature = " << r.value << " +- " << r.error << " (" << r.evaluations
+              << " evaluations)" << std::endl;
+    std::cout << std::setprecision(17) << "actual_answer = " << actual_answer << std::endl;
+
+    // a unit disc, where the fixed rule converges slowly at the edges
+    auto one = [](auto x, auto y) { return Type{1}; };
+    auto disc = std::make_tuple([](auto x) { return -std::sqrt(1 - x * x); }, [](auto x) { return std::sqrt(1 - x * x); });
+    auto rd = DiceForge::cubature(one, std::make_tuple(Type{-1}, Type{1}), disc, DiceForge::dy_dx, Type(1e-9));
+    auto rp = DiceForge::cubature(one, std::make_tuple(Type{-1}, Type{1}), disc, DiceForge::dy_dx, Type(1e-9), Type(1e-14),
+                                  1000000, DiceForge::parallel_t{4});
+    std::cout << std::setprecision(17) << "disc area = " << rd.value << " +- " << rd.error << " (" << rd.evaluations
+              << " evaluations, " << (rd.converged ? "converged" : "not converged") << ")" << std::endl;
+    std::cout << "parallel cubature == serial: " << (rd.value == rp.value && rd.evaluations == rp.evaluations ? "OK" : "FAILED") << std::endl;
+    std::cout << std::setprecision(17) << "actual_answer = " << std::asin(1) * 2 << std::endl;
+}
+
 int main()
 {
     std::cout<<"for test case one :"<<std::endl;
     test_double_integral_1<double>();
     std::cout<<"for test case two :"<<std::endl;
     test_double_integral_2<double>();
+    std::cout<<"for quadrature orders :"<<std::endl;
+    test_quadrature_orders<double>();
+    std::cout<<"for parallel integration and cubature :"<<std::endl;
+    test_parallel_and_cubature<double>();
 }
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include "diceforge.h"
+
+// Draws N values in bulk and prints the time taken, the first two moments, the acceptance rate
+// and the number of points the envelope ended up with
+template <typename Sampler, typename Engine>
+void report(const char* name, Sampler& sampler, Engine& rng, size_t N)
+{
+    std::vector<DiceForge::real_t> out(N);
+    auto t0 = std::chrono::high_resolution_clock::now();
+    sampler.sample(rng, out.data(), N);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    double m1 = 0, m2 = 0;
+    for (double x : out)
+    {
+        m1 += x;
+        m2 += x * x;
+    }
+    std::cout << name << "\t" << std::chrono::duration<double, std::milli>(t1 - t0).count() << "ms"
+              << "\tmoments: " << m1 / N << " " << m2 / N << "\tacceptance: " << sampler.acceptance()
+              << " (squeeze " << sampler.efficiency() << ")\tpoints: " << sampler.size() << std::endl;
+}
+
+int main(int argc, char const *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Enter number of samples to be drawn :(" << std::endl;
+        return -1;
+    }
+
+    size_t N = atoll(argv[1]);
+    DiceForge::XORShift64 rng(123);
+    auto fast = DiceForge::make_static(rng);
+
+    // Moments should be close to 0 1, 3 12 and 0.5 0.5
+    auto normal = [](DiceForge::real_t x) { return -x * x / 2; };
+    DiceForge::AdaptiveRejection<decltype(normal)> gaussian(normal, {-1, 0.5, 2});
+    report("Gaussian", gaussian, fast, N);
+
+    auto gamma3 = [](DiceForge::real_t x) { return 2 * std::log(x) - x; };
+    DiceForge::AdaptiveRejection<decltype(gamma3)> gamma(gamma3, {0.5, 2, 8}, 0);
+    report("Gamma(3)", gamma, fast, N);
+
+    auto half = [](DiceForge::real_t x) { return -2 * x; };
+    DiceForge::AdaptiveRejection<decltype(half)> exponential(half, {0.1, 1, 3}, 0);
+    report("Exponential(2)", exponential, fast, N);
+
+    return 0;
+}
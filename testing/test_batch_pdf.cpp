@@ -0,0 +1,82 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <cmath>
+
+#include "diceforge.h"
+
+// Largest relative difference between the batch and the scalar evaluations of a distribution
+double compare(const DiceForge::Continuous& d, const std::vector<double>& x)
+{
+    std::vector<double> pdf(x.size()), logpdf(x.size()), cdf(x.size());
+    d.pdf(x.data(), pdf.data(), x.size());
+    d.logpdf(x.data(), logpdf.data(), x.size());
+    d.cdf(x.data(), cdf.data(), x.size());
+    double worst = 0;
+    auto diff = [](double a, double b) {
+        return (a == b) ? 0 : std::abs(a - b) / std::max(std::abs(a), std::abs(b));
+    };
+    for (size_t i = 0; i < x.size(); i++)
+    {
+        worst = std::max(worst, diff(pdf[i], d.pdf(x[i])));
+        worst = std::max(worst, diff(logpdf[i], std::log(d.pdf(x[i]))));
+        worst = std::max(worst, diff(cdf[i], d.cdf(x[i])));
+    }
+    return worst;
+}
+
+double compare(const DiceForge::Discrete& d, const std::vector<DiceForge::int_t>& k)
+{
+    std::vector<double> pmf(k.size()), cdf(k.size());
+    d.pmf(k.data(), pmf.data(), k.size());
+    d.cdf(k.data(), cdf.data(), k.size());
+    double worst = 0;
+    for (size_t i = 0; i < k.size(); i++)
+    {
+        worst = std::max(worst, std::abs(pmf[i] - d.pmf(k[i])));
+        worst = std::max(worst, std::abs(cdf[i] - d.cdf(k[i])));
+    }
+    return worst;
+}
+
+int main(int argc, char const *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Enter number of points to be evaluated :(" << std::endl;
+        return -1;
+    }
+
+    size_t N = atoll(argv[1]);
+    std::vector<double> x(N);
+    for (size_t i = 0; i < N; i++)
+        x[i] = 0.1 + 5.0 * i / N;
+    std::vector<DiceForge::int_t> k = {0, 1, 2, 3, 5, 8, 13, 21};
+
+    // Relative differences should be around 1e-15 (absolute ones for the discrete distributions)
+    std::cout << "Gaussian\t" << compare(DiceForge::Gaussian(1, 2), x) << std::endl;
+    std::cout << "Cauchy\t\t" << compare(DiceForge::Cauchy(1, 2), x) << std::endl;
+    std::cout << "Exponential\t" << compare(DiceForge::Exponential(2), x) << std::endl;
+    std::cout << "Maxwell\t\t" << compare(DiceForge::Maxwell(2), x) << std::endl;
+    std::cout << "Weibull\t\t" << compare(DiceForge::Weibull(2, 1.5), x) << std::endl;
+    std::cout << "Poisson\t\t" << compare(DiceForge::Poisson(4), k) << std::endl;
+    std::cout << "Geometric\t" << compare(DiceForge::Geometric(0.25), k) << std::endl;
+    std::cout << "Binomial\t" << compare(DiceForge::Binomial(10, 0.5), k) << std::endl;
+
+    // Log-likelihood of the points under a Gaussian, point by point and in one batch
+    DiceForge::Gaussian g(1, 2);
+    std::vector<double> out(N);
+    double scalar = 0, batch = 0;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < N; i++)
+        scalar += std::log(g.pdf(x[i]));
+    auto t1 = std::chrono::high_resolution_clock::now();
+    g.logpdf(x.data(), out.data(), N);
+    for (size_t i = 0; i < N; i++)
+        batch += out[i];
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout << "log-likelihood\tscalar: " << scalar << " in " << std::chrono::duration<double, std::milli>(t1 - t0).count()
+              << "ms\tbatch: " << batch << " in " << std::chrono::duration<double, std::milli>(t2 - t1).count() << "ms" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include "diceforge.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+
+// Checks that BufferedGenerator hands out the integers of the engine it wraps, in order, with and without the
+// background thread and across jumps and reseeds, then times bursts of draws from Blum Blum Shub with the producer
+// filling the ring in the pauses between them
+
+using namespace DiceForge;
+
+template <typename Engine>
+size_t differences(BufferedGenerator<Engine>& buffered, Engine& reference, size_t n)
+{
+    size_t count = 0;
+    std::vector<typename Engine::result_type> block(1000), expected(1000);
+    for (size_t i = 0; i < n; i++)
+    {
+        if (i % 7 == 0)
+        {
+            buffered.fill(block.data(), block.size());
+            reference.fill(expected.data(), expected.size());
+            for (size_t j = 0; j < block.size(); j++)
+                count += (block[j] != expected[j]);
+        }
+        else
+            count += (buffered.next() != reference.next());
+    }
+    return count;
+}
+
+int main(int argc, char const *argv[])
+{
+    for (bool background : {true, false})
+    {
+        XORShift64 reference(99);
+        BufferedGenerator<XORShift64> buffered(reference, 4096, background);
+        size_t wrong = differences(buffered, reference, 100000);
+        // jumps within the ring and past it
+        reference.jump(3);
+        buffered.jump(3);
+        wrong += differences(buffered, reference, 10);
+        reference.jump(1000000);
+        buffered.jump(1000000);
+        wrong += differences(buffered, reference, 1000);
+        buffered.reset_seed(5);
+        reference.reset_seed(5);
+        wrong += differences(buffered, reference, 1000);
+        std::cout << (background ? "background: " : "bulk: ") << wrong << " differences" << std::endl;
+    }
+
+    // Distributions draw through it unchanged
+    {
+        BlumBlumShub64 engine(12345);
+        BufferedGenerator<BlumBlumShub64> buffered(engine);
+        BlumBlumShub64 reference = engine;
+        std::vector<double> a(10000), b(10000);
+        Gaussian(0, 1).sample(buffered, a.data(), a.size());
+        Gaussian(0, 1).sample(reference, b.data(), b.size());
+        std::cout << "Gaussian through the buffer: " << (a == b ? "same" : "different") << " values" << std::endl;
+    }
+
+    // Bursts of 20000 integers, 5ms apart
+    const size_t bursts = 20, burst = 20000;
+    BlumBlumShub64 plain(777);
+    BufferedGenerator<BlumBlumShub64> buffered(plain, 1 << 16);
+    unsigned long long sink = 0;
+    std::chrono::duration<double, std::milli> direct(0), served(0);
+    for (size_t b = 0; b < bursts; b++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < burst; i++)
+            sink += plain.next();
+        direct += std::chrono::high_resolution_clock::now() - start;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < burst; i++)
+            sink += buffered.next();
+        served += std::chrono::high_resolution_clock::now() - start;
+    }
+    std::cout << std::setprecision(4) << "BlumBlumShub64 bursts: " << direct.count() << "ms direct, " << served.count()
+              << "ms buffered (" << sink % 10 << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include "diceforge.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+// Compares log_nCr with reference values (computed to 60 digits) and with the difference of three lgamma,
+// and times the log factorial next to lgamma
+
+struct Case
+{
+    DiceForge::uint64_t n, r;
+    double reference;
+};
+
+int main(int argc, char const *argv[])
+{
+    const Case cases[] = {
+        {10, 3, 4.787491742782046},
+        {255, 1, 5.541263545158426},
+        {300, 150, 204.8656382462206},
+        {1000, 1, 6.907755278982137},
+        {1000000, 3, 39.654769204662266},
+        {1000000000, 1, 20.72326583694641},
+        {1000000000, 500000000, 693147169.9725211},
+        {1000000000000ULL, 17, 436.22228552051246},
+        {1099511627776ULL, 1048576, 15584917.609646404}};
+
+    std::cout << "n\tr\trelative error of log_nCr\tof lgamma" << std::endl;
+    for (const Case& c : cases)
+    {
+        double ours = DiceForge::log_nCr(c.n, c.r);
+        double naive = std::lgamma(c.n + 1.0) - std::lgamma(c.r + 1.0) - std::lgamma(c.n - c.r + 1.0);
+        std::cout << std::setprecision(3) << c.n << "\t" << c.r << "\t" << std::fabs(ours / c.reference - 1) << "\t"
+                  << std::fabs(naive / c.reference - 1) << std::endl;
+    }
+
+    std::cout << "log_nPr(10, 3) = " << std::exp(DiceForge::log_nPr(10, 3)) << " (720)" << std::endl;
+    std::cout << "log_nCr(5, 7) = " << DiceForge::log_nCr(5, 7) << " (-inf)" << std::endl;
+
+    double sum = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (DiceForge::uint64_t k = 0; k < 10000000; k++)
+        sum += DiceForge::log_factorial(k % 1000);
+    std::chrono::duration<double, std::milli> t = std::chrono::high_resolution_clock::now() - start;
+    std::cout << "log_factorial: " << t.count() << "ms" << std::endl;
+    start = std::chrono::high_resolution_clock::now();
+    for (DiceForge::uint64_t k = 0; k < 10000000; k++)
+        sum -= std::lgamma(double(k % 1000) + 1);
+    t = std::chrono::high_resolution_clock::now() - start;
+    std::cout << "lgamma: " << t.count() << "ms (" << sum << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include "diceforge.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <cmath>
+
+// Checks the composite distributions: samples of a mixture, truncated and affine distributions (drawn with sample
+// and with next, and nested in one another) against their own cdf by the chi-square test, their moments against
+// expectation and variance, and the moments of a truncated Gaussian against their closed form; then times the
+// batch samples against a loop over Continuous pointers with rejection for the truncation
+
+using namespace DiceForge;
+
+const size_t N = 2000000;
+
+template <typename Dist>
+void check(const char* name, Dist& dist, double lo, double hi)
+{
+    XORShift64 rng(17);
+    std::vector<double> x(N);
+    dist.sample(rng, x.data(), N);
+    Histogram h(lo, hi, 200), g(lo, hi, 200);
+    Moments m;
+    h.add(x.data(), N);
+    m.add(x.data(), N);
+    for (size_t i = 0; i < N; i++)
+        x[i] = dist.next(rng);
+    g.add(x.data(), N);
+    std::cout << std::setw(32) << std::left << name << "sample p " << std::setw(12) << h.chi_square(dist).p_value
+              << "next p " << std::setw(12) << g.chi_square(dist).p_value << "mean " << std::setw(11) << m.mean()
+              << "(" << std::setw(11) << dist.expectation() << ") variance " << std::setw(11) << m.variance()
+              << "(" << dist.variance() << ")" << std::endl;
+    std::cout << std::setw(32) << "" << "range [" << m.min() << ", " << m.max() << "] within [" << dist.minValue()
+              << ", " << dist.maxValue() << "]" << std::endl;
+}
+
+template <typename F>
+double ns(F f, size_t n)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    f();
+    std::chrono::duration<double, std::nano> t = std::chrono::high_resolution_clock::now() - start;
+    return t.count() / n;
+}
+
+int main(int argc, char const *argv[])
+{
+    Mixture latency({0.95, 0.05}, Gaussian(10, 1), Exponential(0.2, 10));
+    check("95% Gaussian + 5% Exponential", latency, 5, 40);
+
+    Truncated<Gaussian> tail(Gaussian(0, 1), 1, 3);
+    check("Gaussian on [1, 3]", tail, 1, 3);
+    // E = (phi(a) - phi(b)) / Z and Var = 1 + (a phi(a) - b phi(b)) / Z - E^2
+    {
+        const double a = 1, b = 3, phi_a = std::exp(-a * a / 2) / std::sqrt(2 * M_PI), phi_b = std::exp(-b * b / 2) / std::sqrt(2 * M_PI);
+        const double Z = 0.5 * (std::erf(b / std::sqrt(2.0)) - std::erf(a / std::sqrt(2.0))), E = (phi_a - phi_b) / Z;
+        std::cout << "  closed form: mean " << E << ", variance " << 1 + (a * phi_a - b * phi_b) / Z - E * E << std::endl;
+    }
+
+    Truncated<Cauchy> cauchy(Cauchy(0, 1), -5, INFINITY);
+    std::cout << "Cauchy on [-5, inf): min " << cauchy.minValue() << ", mass " << cauchy.get_mass()
+              << ", quantile(0.5) " << cauchy.quantile(0.5) << std::endl;
+
+    Affine<Exponential> mirrored(Exponential(1), 3, -2);
+    check("3 - 2 Exponential(1)", mirrored, -20, 3);
+
+    Mixture<Truncated<Gaussian>, Affine<Weibull>, Cauchy> nested({2, 1, 1}, Truncated<Gaussian>(Gaussian(0, 1), -1, 1),
+                                                                 Affine<Weibull>(Weibull(1.5, 1), 2, 0.5), Cauchy(0, 0.1));
+    {
+        XORShift64 rng(19);
+        std::vector<double> x(N);
+        nested.sample(rng, x.data(), N);
+        Histogram h(-3, 5, 400);
+        h.add(x.data(), N);
+        std::cout << std::setw(32) << "mixture of the composites" << "sample p " << h.chi_square(nested).p_value
+                  << ", quantile(0.9) " << nested.quantile(0.9) << " cdf there " << nested.cdf(nested.quantile(0.9)) << std::endl;
+    }
+
+    // Time per value, against the same distributions behind Continuous pointers, a loop of next_unit choosing
+    // the component and rejection for the truncation
+    {
+        XORShift64 rng(23);
+        const size_t M = 1000000;
+        std::vector<double> x(M);
+        Gaussian gaussian(10, 1), standard(0, 1);
+        Exponential exponential(0.2, 10);
+        Continuous* parts[2] = {&gaussian, &exponential};
+        double s = 0;
+
+        std::cout << "Mixture::sample                 " << ns([&]() { for (int k = 0; k < 10; k++) latency.sample(rng, x.data(), M); }, 10 * M) << " ns" << std::endl;
+        std::cout << " loop over Continuous pointers  " << ns([&]() {
+            for (int k = 0; k < 10; k++)
+                for (size_t i = 0; i < M; i++)
+                    x[i] = parts[rng.next_unit() < 0.95 ? 0 : 1]->quantile(rng.next_unit());
+        }, 10 * M) << " ns" << std::endl;
+        s += x[0];
+        std::cout << "Truncated<Gaussian>::sample     " << ns([&]() { for (int k = 0; k < 10; k++) tail.sample(rng, x.data(), M); }, 10 * M) << " ns" << std::endl;
+        std::cout << " rejection loop of next         " << ns([&]() {
+            for (int k = 0; k < 10; k++)
+                for (size_t i = 0; i < M; i++) {
+                    double v;
+                    do
+                        v = standard.next(rng);
+                    while (v < 1 || v > 3);
+                    x[i] = v;
+                }
+        }, 10 * M) << " ns" << std::endl;
+        s += x[0];
+        std::cout << "(" << s << ")" << std::endl;
+    }
+    return 0;
+}
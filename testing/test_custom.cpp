@@ -0,0 +1,60 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "diceforge.h"
+
+// Draws N values with sample() and prints the construction time, the sampling time and the
+// Kolmogorov-Smirnov distance to the exact cdf F(x) = x^3 / 27 on [0, 3], then the largest error of
+// cdf() and the expectation and variance (exactly 2.25 and 0.3375)
+void test_custom(const char* name, int n, bool smooth, size_t N)
+{
+    DiceForge::XORShift64 rng(123);
+    auto fast = DiceForge::make_static(rng);
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    DiceForge::CustomDistribution custom(0, 3, [](DiceForge::real_t x) { return x * x / 9; }, n, smooth);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    std::vector<DiceForge::real_t> out(N);
+    custom.sample(fast, out.data(), N);
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    std::sort(out.begin(), out.end());
+    double ks = 0;
+    for (size_t i = 0; i < N; i++)
+    {
+        double F = out[i] * out[i] * out[i] / 27;
+        ks = std::max(ks, std::max(std::fabs(F - double(i) / N), std::fabs(F - double(i + 1) / N)));
+    }
+    std::cout << name << "\tbuilt in " << std::chrono::duration<double, std::milli>(t1 - t0).count() << "ms"
+              << "\tsampled in " << std::chrono::duration<double, std::milli>(t2 - t1).count() << "ms"
+              << "\tKS: " << ks << " (about " << 1 / std::sqrt(double(N)) << " expected)" << std::endl;
+
+    double error = 0;
+    for (int i = 0; i <= 3000; i++)
+    {
+        double x = i / 1000.0;
+        error = std::max(error, std::fabs(custom.cdf(x) - x * x * x / 27));
+    }
+    std::cout << "\tcdf error: " << error << "\texpectation: " << custom.expectation()
+              << "\tvariance: " << custom.variance() << std::endl;
+}
+
+int main(int argc, char const *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Enter number of samples to be drawn :(" << std::endl;
+        return -1;
+    }
+
+    size_t N = atoll(argv[1]);
+    test_custom("Custom, 20 linear segments", 20, false, N);
+    test_custom("Custom, 20 Hermite segments", 20, true, N);
+    test_custom("Custom, 1000 linear segments", 1000, false, N);
+    test_custom("Custom, 1000000 linear segments", 1000000, false, N);
+
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <cmath>
+
+#include "diceforge.h"
+
+// Draws N values with sample() and prints the time taken and the chi-squared statistic against the pmf
+// over the values with at least 5 expected counts
+template <typename Distribution, typename Engine>
+void test_distribution(const char* name, Distribution& d, Engine& rng, size_t N)
+{
+    std::vector<DiceForge::int_t> out(N);
+    auto t0 = std::chrono::high_resolution_clock::now();
+    d.sample(rng, out.data(), N);
+    auto t1 = std::chrono::high_resolution_clock::now();
+
+    DiceForge::int_t top = 0;
+    for (auto k : out)
+        top = std::max(top, k);
+    std::vector<double> counts(top + 1, 0);
+    for (auto k : out)
+        counts[k]++;
+
+    double chi2 = 0;
+    int bins = 0;
+    for (DiceForge::int_t k = 0; k <= top; k++)
+    {
+        double expected = N * d.pmf(k);
+        if (expected < 5)
+            continue;
+        chi2 += (counts[k] - expected) * (counts[k] - expected) / expected;
+        bins++;
+    }
+    std::cout << name << "\t" << std::chrono::duration<double, std::milli>(t1 - t0).count() << "ms"
+              << "\tchi2: " << chi2 << " over " << bins << " values" << std::endl;
+}
+
+int main(int argc, char const *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Enter number of values to be drawn :(" << std::endl;
+        return -1;
+    }
+
+    size_t N = atoll(argv[1]);
+    DiceForge::XORShift64 rng(123);
+    auto fast = DiceForge::make_static(rng);
+
+    // chi2 should be close to the number of values
+    DiceForge::Poisson small(3.5), large(250);
+    test_distribution("Poisson(3.5)", small, fast, N);
+    test_distribution("Poisson(250)", large, fast, N);
+
+    // lambda = 0 always gives 0
+    {
+        DiceForge::Poisson zero(0);
+        const DiceForge::int_t k[2] = {0, 1};
+        DiceForge::real_t p[2];
+        zero.pmf(k, p, 2);
+        std::cout << "Poisson(0): pmf(0) " << zero.pmf(0) << ", pmf(1) " << zero.pmf(1) << ", batch " << p[0] << " "
+                  << p[1] << ", cdf(0) " << zero.cdf(0) << ", logpmf(0) " << zero.logpmf(0) << ", next "
+                  << zero.next(fast) << std::endl;
+    }
+
+    DiceForge::Binomial table(20, 0.3), btpe(100000, 0.4), flipped(100, 0.9);
+    test_distribution("Binomial(20, 0.3)", table, fast, N);
+    test_distribution("Binomial(100000, 0.4)", btpe, fast, N);
+    test_distribution("Binomial(100, 0.9)", flipped, fast, N);
+
+    DiceForge::Hypergeometric cards(52, 13, 5), inventory(4000000, 1500000, 200000);
+    test_distribution("Hypergeometric(52, 13, 5)", cards, fast, N);
+    test_distribution("Hypergeometric(4000000, 1500000, 200000)", inventory, fast, N);
+
+    DiceForge::NegHypergeometric few(60, 20, 5), many(2000000, 1000000, 3000);
+    test_distribution("NegHypergeometric(60, 20, 5)", few, fast, N);
+    test_distribution("NegHypergeometric(2000000, 1000000, 3000)", many, fast, N);
+
+    std::vector<DiceForge::int_t> states(1000);
+    std::vector<DiceForge::real_t> energies(1000);
+    for (int i = 0; i < 1000; i++)
+    {
+        states[i] = i;
+        energies[i] = std::sin(0.05 * i) + 0.001 * i;
+    }
+    DiceForge::Gibbs gibbs(states.begin(), states.end(), energies.begin(), energies.end(), 1);
+    test_distribution("Gibbs(beta = 1)", gibbs, fast, N);
+    gibbs.setBeta(5);
+    test_distribution("Gibbs(beta = 5)", gibbs, fast, N);
+
+    DiceForge::Bernoulli coin(0.5), biased(0.1234);
+    test_distribution("Bernoulli(0.5)", coin, fast, N);
+    test_distribution("Bernoulli(0.1234)", biased, fast, N);
+
+    // Packed trials: the fraction of set bits should be close to p
+    std::vector<DiceForge::uint64_t> words(N / 64 + 1);
+    auto t0 = std::chrono::high_resolution_clock::now();
+    biased.sample_bits(fast, words.data(), words.size());
+    auto t1 = std::chrono::high_resolution_clock::now();
+    double ones = 0;
+    for (DiceForge::uint64_t w : words)
+        ones += __builtin_popcountll(w);
+    std::cout << "Bernoulli(0.1234) packed\t" << std::chrono::duration<double, std::milli>(t1 - t0).count() << "ms"
+              << "\tfraction: " << ones / (64.0 * words.size()) << std::endl;
+
+    DiceForge::Geometric geometric(0.05);
+    test_distribution("Geometric(0.05)", geometric, fast, N);
+
+    return 0;
+}
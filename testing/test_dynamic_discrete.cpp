@@ -0,0 +1,139 @@
+#include "diceforge.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <cmath>
+
+// Checks DynamicDiscrete: samples against the weights with the chi-square test, before and after updates; cdf and
+// quantile against the running sums of the weights; bulk updates against single ones; the total after ten million
+// updates against a tree built from the final weights (the sums do not drift); then times an update followed by a draw out of a million weights
+
+using namespace DiceForge;
+
+int main(int argc, char const *argv[])
+{
+    XORShift64 rng(17);
+
+    // Chi-square test of 1e7 samples of 1000 weights, then after changing a tenth of them and zeroing some
+    {
+        std::vector<double> w(1000);
+        rng.fill_unit(w.data(), w.size());
+        DynamicDiscrete d(w.begin(), w.end());
+        std::vector<long long> out(10000000);
+        d.sample(rng, out.data(), out.size());
+        Histogram h(0, 1000, 1000);
+        h.add(out.data(), out.size());
+        std::cout << "chi2 p " << h.chi_square(d).p_value;
+        for (size_t k = 0; k < 100; k++)
+            d.update(rng.next_in_range(0, 999), (k % 10 == 0) ? 0 : 10 * rng.next_unit());
+        d.sample(rng, out.data(), out.size());
+        Histogram after(0, 1000, 1000);
+        after.add(out.data(), out.size());
+        std::cout << ", after 100 updates " << after.chi_square(d).p_value << std::endl;
+    }
+
+    // cdf and quantile against the running sums
+    {
+        std::vector<double> w(5000);
+        rng.fill_unit(w.data(), w.size());
+        for (size_t i = 0; i < w.size(); i += 7)
+            w[i] = 0;
+        DynamicDiscrete d(w.begin(), w.end());
+        double sum = 0, total = 0, worst = 0;
+        for (double x : w)
+            total += x;
+        size_t wrong = 0;
+        for (size_t i = 0; i < w.size(); i++) {
+            sum += w[i];
+            worst = std::max(worst, std::fabs(d.cdf(i) - sum / total));
+            // The first index reaching a cdf is the last one before it with a positive weight
+            if (w[i] > 0)
+                wrong += (d.quantile(d.cdf(i)) != (long long)(i));
+            wrong += (d.quantile(d.cdf(i) * (1 - 1e-12)) > (long long)(i));
+        }
+        std::cout << "largest cdf error " << worst << ", " << wrong << " wrong quantiles" << std::endl;
+    }
+
+    // Quantiles across a long run of zero weights, only the first and last being positive
+    {
+        const size_t n = 1000000;
+        DynamicDiscrete d(n);
+        d.update(0, 1.0);
+        d.update(n - 1, 3.0);
+        size_t wrong = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t k = 0; k < 100000; k++) {
+            const double p = rng.next_unit();
+            wrong += (d.quantile(p) != (p <= 0.25 ? 0 : (long long)(n - 1)));
+        }
+        wrong += (d.quantile(0.25) != 0) + (d.quantile(std::nextafter(0.25, 1.0)) != (long long)(n - 1));
+        std::chrono::duration<double, std::nano> t = std::chrono::high_resolution_clock::now() - start;
+        std::cout << "quantiles of 2 positive weights out of 1e6: " << wrong << " wrong, "
+                  << t.count() / 100002 << " ns" << std::endl;
+    }
+
+    // Bulk updates give the same tree as single ones
+    {
+        std::vector<double> w(100000, 1.0);
+        DynamicDiscrete single(w.begin(), w.end()), bulk(w.begin(), w.end());
+        std::vector<size_t> index(5000);
+        std::vector<double> weight(5000);
+        for (size_t k = 0; k < index.size(); k++) {
+            index[k] = size_t(rng.next_in_range(0, 99999));
+            weight[k] = rng.next_unit();
+            single.update(index[k], weight[k]);
+        }
+        bulk.update(index.data(), weight.data(), index.size());
+        size_t differences = (single.total() != bulk.total());
+        for (long long i = 0; i < 100000; i++)
+            differences += (single.cdf(i) != bulk.cdf(i));
+        std::cout << "bulk against single updates: " << differences << " differences" << std::endl;
+    }
+
+    // No drift: ten million updates, then the total against the sum of the weights
+    {
+        const size_t n = 1000000;
+        DynamicDiscrete d(n);
+        std::vector<double> w(n, 0);
+        for (size_t k = 0; k < 10000000; k++) {
+            const size_t i = size_t(rng.next_in_range(0, n - 1));
+            w[i] = std::ldexp(rng.next_unit(), int(rng.next_in_range(-20, 20)));
+            d.update(i, w[i]);
+        }
+        DynamicDiscrete fresh(w.begin(), w.end());
+        std::cout << "total after 1e7 updates against a tree of the final weights: "
+                  << (d.total() == fresh.total() ? "equal" : "DIFFERENT") << std::endl;
+
+        // An update and a draw, as in kinetic Monte Carlo
+        auto start = std::chrono::high_resolution_clock::now();
+        long long last = 0;
+        for (size_t k = 0; k < 10000000; k++) {
+            d.update(size_t(last), rng.next_unit());
+            last = d.next(rng);
+        }
+        std::chrono::duration<double, std::nano> t = std::chrono::high_resolution_clock::now() - start;
+        std::cout << "update and draw out of 1e6 weights: " << t.count() / 1e7 << " ns" << std::endl;
+    }
+
+    // Invalid arguments
+    {
+        DynamicDiscrete d(10);
+        size_t thrown = 0;
+        try { d.next(0.5); } catch (const std::invalid_argument&) { thrown++; }
+        try { d.update(10, 1.0); } catch (const std::out_of_range&) { thrown++; }
+        try { d.update(3, -1.0); } catch (const std::invalid_argument&) { thrown++; }
+        try { d.update(3, INFINITY); } catch (const std::invalid_argument&) { thrown++; }
+        // Finite weights whose total overflows, refused with the weights left as they were
+        std::vector<double> big(2, 1e308);
+        try { DynamicDiscrete o(big.begin(), big.end()); } catch (const std::invalid_argument&) { thrown++; }
+        d.update(3, 1e308);
+        try { d.update(4, 1e308); } catch (const std::invalid_argument&) { thrown++; }
+        const size_t index[2] = {5, 5};
+        const double weight[2] = {1.0, 1e308};
+        try { d.update(index, weight, 2); } catch (const std::invalid_argument&) { thrown++; }
+        std::cout << thrown << " of 7 invalid calls thrown, total after the refusals "
+                  << (d.total() == 1e308 && d.cdf(4) == 1 && d.cdf(2) == 0 ? "unchanged" : "CHANGED") << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include "diceforge.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <cstdint>
+
+// Checks the single precision and fixed-point paths: the range and mean of the float uniforms, the occupancy of
+// the 8 and 16 bit integers, the moments and the largest gap between the cdfs of the float and double normals and
+// exponentials, and times the float batches next to the double ones
+
+using namespace DiceForge;
+
+// Largest |F_a(x) - F_b(x)| between the empirical cdfs of two samples, both sorted in place
+template <typename A, typename B>
+double ks(std::vector<A>& a, std::vector<B>& b)
+{
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    size_t i = 0, j = 0;
+    double worst = 0;
+    while (i < a.size() && j < b.size())
+    {
+        if (double(a[i]) <= double(b[j]))
+            i++;
+        else
+            j++;
+        worst = std::max(worst, std::fabs(double(i) / a.size() - double(j) / b.size()));
+    }
+    return worst;
+}
+
+template <typename V>
+void moments(const std::vector<V>& x, double& mean, double& variance)
+{
+    mean = variance = 0;
+    for (V v : x)
+        mean += double(v) / x.size();
+    for (V v : x)
+        variance += (double(v) - mean) * (double(v) - mean) / x.size();
+}
+
+template <typename D>
+void compare(const char* name, D d, XORShift& rng, size_t n)
+{
+    std::vector<float> f(n);
+    std::vector<double> x(n);
+    auto start = std::chrono::high_resolution_clock::now();
+    d.sample(rng, f.data(), n);
+    std::chrono::duration<double, std::milli> tf = std::chrono::high_resolution_clock::now() - start;
+    start = std::chrono::high_resolution_clock::now();
+    d.sample(rng, x.data(), n);
+    std::chrono::duration<double, std::milli> td = std::chrono::high_resolution_clock::now() - start;
+    double mf, vf, md, vd;
+    moments(f, mf, vf);
+    moments(x, md, vd);
+    // sqrt(2 / n) scales the gap: about 1.36 of it at the 5% level
+    const double gap = ks(f, x) / std::sqrt(2.0 / n);
+    std::cout << std::setw(20) << std::left << name << std::setprecision(4) << mf << " " << vf << "\t" << md << " "
+              << vd << "\t" << gap << "\t\t" << tf.count() << "ms\t" << td.count() << "ms" << std::endl;
+}
+
+int main(int argc, char const *argv[])
+{
+    XORShift rng = XORShift(42);
+    const size_t N = 10000000;
+
+    // Uniforms
+    std::vector<float> u(N);
+    rng.fill_unit(u.data(), N);
+    float lo = 1, hi = 0;
+    double mean = 0;
+    for (float v : u)
+        lo = std::min(lo, v), hi = std::max(hi, v), mean += double(v) / N;
+    std::cout << std::setprecision(9) << "fill_unit(float): [" << lo << ", " << hi << "], mean "
+              << std::setprecision(6) << mean
+              << " (0.5, standard error " << std::sqrt(1.0 / 12 / N) << ")" << std::endl;
+    std::cout << "next_unit_float() < 1: " << ((rng.next_unit_float() < 1) ? "yes" : "no") << std::endl;
+
+    // Fixed point: chi-squared of the byte and 16 bit counts, against their degrees of freedom
+    std::vector<uint8_t> b(N);
+    std::vector<uint16_t> h(N);
+    rng.fill_fixed(b.data(), N);
+    rng.fill_fixed(h.data(), N);
+    std::vector<double> cb(256, 0.0), ch(65536, 0.0);
+    for (size_t i = 0; i < N; i++)
+        cb[b[i]]++, ch[h[i]]++;
+    double xb = 0, xh = 0;
+    for (double c : cb)
+        xb += (c - N / 256.0) * (c - N / 256.0) / (N / 256.0);
+    for (double c : ch)
+        xh += (c - N / 65536.0) * (c - N / 65536.0) / (N / 65536.0);
+    std::cout << "fill_fixed chi-squared: uint8_t " << xb << " (255), uint16_t " << xh << " (65535)" << std::endl;
+
+    std::cout << "distribution\t    float mean, variance\tdouble mean, variance\tks gap (sqrt(2/n))\tfloat\tdouble"
+              << std::endl;
+    compare("Gaussian(1, 2)", Gaussian(1, 2), rng, N);
+    compare("Exponential(1)", Exponential(1), rng, N);
+    compare("Weibull(2, 1.5)", Weibull(2, 1.5), rng, N);
+    compare("Maxwell(1)", Maxwell(1), rng, N);
+    compare("Cauchy(0, 1)", Cauchy(0, 1), rng, N);
+    compare("Custom", CustomDistribution(0, 3, [](real_t x) { return x * x; }), rng, N / 10);
+    return 0;
+}
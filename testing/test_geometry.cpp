@@ -0,0 +1,164 @@
+#include "diceforge.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <cmath>
+
+// Checks the geometric samplers: for each shape, the largest distance of its points from the surface they should
+// lie on, and the chi-square test of quantities that are uniform for uniform points (the angle around the axis,
+// the squared radius in the disk, the height on the sphere, r^3 in the ball, ...); then times each sampler
+// against a loop of next_unit with std::sin and std::cos, or rejection for the disk
+
+using namespace DiceForge;
+
+const size_t N = 2000000;
+
+// The chi-square p-value of the values against the uniform distribution on [lo, hi]
+double uniform_p(const std::vector<double>& v, double lo, double hi)
+{
+    Histogram h(lo, hi, 1000);
+    h.add(v.data(), v.size());
+    return h.chi_square().p_value;
+}
+
+void report(const char* name, double distance, double p_angle, double p)
+{
+    std::cout << std::setw(20) << std::left << name << "off the surface " << std::setw(14) << distance
+              << "angle p " << std::setw(12) << p_angle << "p " << p << std::endl;
+}
+
+template <typename F>
+double ns(F f, size_t n)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    f();
+    std::chrono::duration<double, std::nano> t = std::chrono::high_resolution_clock::now() - start;
+    return t.count() / n;
+}
+
+int main(int argc, char const *argv[])
+{
+    XORShift64 rng(21);
+    std::vector<double> x(N), y(N), z(N), a(N), b(N);
+
+    {
+        geometry::circle(rng, x.data(), y.data(), N);
+        double off = 0;
+        for (size_t i = 0; i < N; i++) {
+            off = std::max(off, std::fabs(std::hypot(x[i], y[i]) - 1));
+            a[i] = std::atan2(y[i], x[i]);
+        }
+        report("circle", off, uniform_p(a, -M_PI, M_PI), 1);
+
+        geometry::disk(rng, x.data(), y.data(), N);
+        off = 0;
+        for (size_t i = 0; i < N; i++) {
+            off = std::max(off, x[i] * x[i] + y[i] * y[i] - 1);
+            a[i] = std::atan2(y[i], x[i]);
+            b[i] = x[i] * x[i] + y[i] * y[i];
+        }
+        report("disk (r^2)", std::max(off, 0.0), uniform_p(a, -M_PI, M_PI), uniform_p(b, 0, 1));
+    }
+
+    {
+        geometry::sphere(rng, x.data(), y.data(), z.data(), N);
+        double off = 0;
+        for (size_t i = 0; i < N; i++) {
+            off = std::max(off, std::fabs(std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]) - 1));
+            a[i] = std::atan2(y[i], x[i]);
+        }
+        report("sphere (z)", off, uniform_p(a, -M_PI, M_PI), uniform_p(z, -1, 1));
+
+        geometry::hemisphere(rng, x.data(), y.data(), z.data(), N);
+        off = 0;
+        for (size_t i = 0; i < N; i++) {
+            off = std::max(off, std::fabs(std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]) - 1));
+            a[i] = std::atan2(y[i], x[i]);
+        }
+        report("hemisphere (z)", off, uniform_p(a, -M_PI, M_PI), uniform_p(z, 0, 1));
+
+        // cos(theta) sin(theta) d theta is d(z^2) / 2
+        geometry::cosine_hemisphere(rng, x.data(), y.data(), z.data(), N);
+        off = 0;
+        for (size_t i = 0; i < N; i++) {
+            off = std::max(off, std::fabs(std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]) - 1));
+            a[i] = std::atan2(y[i], x[i]);
+            b[i] = z[i] * z[i];
+        }
+        report("cosine (z^2)", off, uniform_p(a, -M_PI, M_PI), uniform_p(b, 0, 1));
+
+        geometry::ball(rng, x.data(), y.data(), z.data(), N);
+        off = 0;
+        for (size_t i = 0; i < N; i++) {
+            const double r = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+            off = std::max(off, r - 1);
+            a[i] = std::atan2(y[i], x[i]);
+            b[i] = r * r * r;
+        }
+        report("ball (r^3)", std::max(off, 0.0), uniform_p(a, -M_PI, M_PI), uniform_p(b, 0, 1));
+    }
+
+    // The weight of a vertex w has P(w > t) = (1 - t)^(d - 1) on a simplex of d weights
+    {
+        geometry::triangle(rng, x.data(), y.data(), N);
+        double off = 0;
+        for (size_t i = 0; i < N; i++) {
+            off = std::max(off, std::max(x[i] + y[i] - 1, -std::min(x[i], y[i])));
+            a[i] = (1 - x[i]) * (1 - x[i]);
+            b[i] = (x[i] + y[i]) * (x[i] + y[i]);
+        }
+        report("triangle ((1-u)^2)", std::max(off, 0.0), uniform_p(b, 0, 1), uniform_p(a, 0, 1));
+
+        const size_t d = 5, n = N / d;
+        std::vector<double> w(d * n);
+        geometry::simplex(rng, d, w.data(), n);
+        off = 0;
+        std::vector<double> first(n);
+        for (size_t i = 0; i < n; i++) {
+            double s = 0;
+            for (size_t j = 0; j < d; j++)
+                s += w[j * n + i];
+            off = std::max(off, std::fabs(s - 1));
+            first[i] = std::pow(1 - w[i], double(d - 1));
+        }
+        report("simplex of 5", off, 1, uniform_p(first, 0, 1));
+    }
+
+    // Time per point
+    {
+        const size_t M = 1000000;
+        std::vector<double> u(M), v(M), w(M);
+        double s = 0;
+        std::cout << "disk                " << ns([&]() { for (int k = 0; k < 20; k++) geometry::disk(rng, u.data(), v.data(), M); }, 20 * M) << " ns" << std::endl;
+        std::cout << " rejection loop     " << ns([&]() {
+            for (int k = 0; k < 20; k++)
+                for (size_t i = 0; i < M; i++) {
+                    double p, q;
+                    do {
+                        p = 2 * rng.next_unit() - 1;
+                        q = 2 * rng.next_unit() - 1;
+                    } while (p * p + q * q >= 1);
+                    u[i] = p;
+                    v[i] = q;
+                }
+        }, 20 * M) << " ns" << std::endl;
+        std::cout << "sphere              " << ns([&]() { for (int k = 0; k < 20; k++) geometry::sphere(rng, u.data(), v.data(), w.data(), M); }, 20 * M) << " ns" << std::endl;
+        std::cout << " std::sin/cos loop  " << ns([&]() {
+            for (int k = 0; k < 20; k++)
+                for (size_t i = 0; i < M; i++) {
+                    const double h = 2 * rng.next_unit() - 1, t = 2 * M_PI * rng.next_unit(), r = std::sqrt(1 - h * h);
+                    u[i] = r * std::cos(t);
+                    v[i] = r * std::sin(t);
+                    w[i] = h;
+                }
+        }, 20 * M) << " ns" << std::endl;
+        std::cout << "ball                " << ns([&]() { for (int k = 0; k < 20; k++) geometry::ball(rng, u.data(), v.data(), w.data(), M); }, 20 * M) << " ns" << std::endl;
+        std::cout << "cosine hemisphere   " << ns([&]() { for (int k = 0; k < 20; k++) geometry::cosine_hemisphere(rng, u.data(), v.data(), w.data(), M); }, 20 * M) << " ns" << std::endl;
+        std::cout << "simplex of 3        " << ns([&]() { for (int k = 0; k < 20; k++) geometry::simplex(rng, 3, x.data(), M / 2); }, 10 * M) << " ns" << std::endl;
+        for (size_t i = 0; i < M; i++)
+            s += u[i] + v[i] + w[i];
+        std::cout << "(" << s << ")" << std::endl;
+    }
+    return 0;
+}
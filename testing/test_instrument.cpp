@@ -0,0 +1,91 @@
+#define DF_INSTRUMENT
+#include "diceforge.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+// Checks the instrumentation (compiled in by the definition above, which must come before the headers): the words
+// counted for an engine against the draws made, the values of a distribution counted once even when sample() loops
+// over next(), the counts of several threads summed, the rejections of next_in_range and of Poisson(1000) against
+// their expected rates, and reset; then prints the table.
+//     g++ -std=c++17 -O2 -Iinclude testing/test_instrument.cpp out/linux/libdiceforge.a -pthread
+
+using namespace DiceForge;
+
+void check(const char* what, unsigned long long got, unsigned long long expected)
+{
+    std::cout << std::setw(40) << std::left << what << got << (got == expected ? "  ok" : "  WRONG") << std::endl;
+}
+
+unsigned long long count_of(const char* name)
+{
+    const instrument::Counters* c = instrument::stats().find(name);
+    return c ? c->count : 0;
+}
+
+int main(int argc, char const *argv[])
+{
+    // Words of an engine: next(), the bulk calls and everything built on them (MT64 is counted under the name of
+    // its template)
+    {
+        MT64 rng(1);
+        std::vector<unsigned long long> words(5000);
+        std::vector<double> reals(3000);
+        for (int i = 0; i < 1000; i++)
+            rng.next();
+        rng.fill(words.data(), words.size());
+        rng.fill_unit(reals.data(), reals.size());
+        check("MT64 words (9000)", count_of("MersenneTwisterEngine<uint64_t>"), 9000);
+    }
+
+    // Values of a distribution, once per value whichever entry point produced them
+    {
+        XORShift64 rng(2);
+        Geometric geometric(0.3);
+        std::vector<long long> out(100000);
+        geometric.sample(rng, out.data(), out.size());
+        for (int i = 0; i < 500; i++)
+            geometric.next(rng);
+        check("Geometric values (100500)", count_of("Geometric"), 100500);
+        check("Geometric calls (501)", instrument::stats().find("Geometric")->calls, 501);
+    }
+
+    // The counters of all the threads, including those that have ended
+    {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++)
+            threads.emplace_back([t]() {
+                XORShift32 rng(t + 1);
+                for (int i = 0; i < 250000; i++)
+                    rng.next();
+            });
+        for (std::thread& t : threads)
+            t.join();
+        check("XORShift32 words of 4 threads (1e6)", count_of("XORShift32"), 1000000);
+    }
+
+    // Rejections: next_in_range over 3 2^29 values on 32-bit words rejects a quarter of the products (1/3 retry per
+    // value), Poisson(1000) about one candidate in seven (PTRS)
+    {
+        XORShift32 rng(9);
+        for (int i = 0; i < 1000000; i++)
+            rng.next_in_range(0, (1 << 30) + (1 << 29));
+        const instrument::Counters* range = instrument::stats().find("next_in_range");
+        std::cout << "next_in_range retries/value (0.333)      " << range->retry_rate() << std::endl;
+
+        XORShift64 rng64(5);
+        Poisson poisson(1000);
+        std::vector<long long> out(1000000);
+        poisson.sample(rng64, out.data(), out.size());
+        const instrument::Counters* p = instrument::stats().find("Poisson");
+        std::cout << "Poisson(1000) retries/value              " << p->retry_rate() << std::endl;
+    }
+
+    instrument::dump(std::cout);
+
+    instrument::reset();
+    check("MT64 words after reset", count_of("MersenneTwisterEngine<uint64_t>"), 0);
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <iostream>
+
+#include "diceforge.h"
+
+// Jumps one copy of the RNG and discards the same number of outputs from another,
+// returns the number of mismatches among the next few outputs
+template <typename Engine>
+int test_jump(Engine rng, const DiceForge::uint64_t steps)
+{
+    Engine copy = rng;
+    rng.jump(steps);
+    for (DiceForge::uint64_t i = 0; i < steps; i++)
+        copy.next();
+
+    int mismatches = 0;
+    for (int i = 0; i < 100; i++)
+        mismatches += (rng.next() != copy.next());
+    return mismatches;
+}
+
+template <typename Engine>
+void test_engine(const char* name, const Engine& rng, const DiceForge::uint64_t N)
+{
+    int mismatches = 0;
+    for (DiceForge::uint64_t steps : {DiceForge::uint64_t(1), DiceForge::uint64_t(7), DiceForge::uint64_t(1000), N})
+        mismatches += test_jump(rng, steps);
+
+    // The substreams of a split should all start differently
+    auto streams = DiceForge::split(rng, 4);
+    bool distinct = streams[0].next() != streams[1].next() && streams[2].next() != streams[3].next();
+
+    std::cout << name << "\tmismatches: " << mismatches << ", split: " << (distinct ? "ok" : "overlapping") << std::endl;
+}
+
+int main(int argc, char const *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Enter number of random numbers to be jumped :(" << std::endl;
+        return -1;
+    }
+
+    DiceForge::uint64_t N = atoll(argv[1]);
+
+    test_engine("BBSM64", DiceForge::BlumBlumShubMontgomery64(123), N);
+    test_engine("XOR32", DiceForge::XORShift32(123), N);
+    test_engine("XOR64", DiceForge::XORShift64(123), N);
+    test_engine("XOR64x4", DiceForge::XORShift64x4(123), N);
+    test_engine("MT64", DiceForge::MT64(123), N);
+    test_engine("LFSR32", DiceForge::LFSR32(123), N);
+    test_engine("LFSR64", DiceForge::LFSR64(123), N);
+    test_engine("NR", DiceForge::NaorReingold32(123), N);
+    test_engine("PHI32", DiceForge::Philox32(123), N);
+    test_engine("PHI64", DiceForge::Philox64(123), N);
+
+    // Engines that discard to jump refuse the default strides instead of running for ever, but split by short ones
+    DiceForge::MT32 mt32(123);
+    DiceForge::BlumBlumShub64 bbs(123);
+    int refused = 0;
+    try { DiceForge::split(mt32, 2); } catch (const std::invalid_argument&) { refused++; }
+    try { DiceForge::split(bbs, 2); } catch (const std::invalid_argument&) { refused++; }
+    try { DiceForge::GeneratorPool<DiceForge::MT32> pool(mt32, 4); } catch (const std::invalid_argument&) { refused++; }
+    auto short_streams = DiceForge::split(mt32, 4, 1000);
+    DiceForge::MT32 skipped = mt32;
+    for (int i = 0; i < 3000; i++)
+        skipped.next();
+    std::cout << "without a fast jump: " << refused << " of 3 default strides refused, MT32 split by 1000 "
+              << (short_streams[3].next() == skipped.next() ? "ok" : "overlapping") << ", fast jump: MT32 "
+              << mt32.has_fast_jump() << ", MT64 " << DiceForge::MT64(1).has_fast_jump() << std::endl;
+
+    return 0;
+}
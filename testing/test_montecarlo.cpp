@@ -4,7 +4,7 @@
 
 int main(int argc, char const *argv[])
 {
-    DiceForge::XORShift rng = DiceForge::XORShift(time(NULL));
+    DiceForge::XORShiftx4 rng = DiceForge::XORShiftx4(time(NULL));
     std::ofstream f_out = std::ofstream("pi_out.dat");
     std::ofstream f_in = std::ofstream("pi_in.dat");
 
@@ -17,10 +17,17 @@ int main(int argc, char const *argv[])
     int num_samples = atoi(argv[1]);
     int inside = 0;
 
+    // Points are drawn in blocks so that all the lanes of the generator are kept busy
+    const int block = 4096;
+    double xy[2 * block];
+
     for (int i = 0; i < num_samples; i++)
     {
-        double x = rng.next_in_crange(0, 1);
-        double y = rng.next_in_crange(0, 1);
+        if (i % block == 0)
+            rng.fill_unit(xy, 2 * block);
+
+        double x = xy[2 * (i % block)];
+        double y = xy[2 * (i % block) + 1];
 
         if (x*x + y*y <= 1)
         {
@@ -0,0 +1,49 @@
+#include "diceforge.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+// Integrates exp(x_1 + ... + x_10) / (e - 1)^10 over the 10 dimensional unit cube (exactly 1) with plain, antithetic and
+// stratified sampling and reports every estimate with its standard error. The same run on 1 and 4 threads
+// has to give the same estimate.
+
+double product(const double* x)
+{
+    double s = 0;
+    for (int j = 0; j < 10; j++)
+        s += x[j];
+    return std::exp(s) / std::pow(M_E - 1, 10);
+}
+
+void run(const char* name, DiceForge::monte_carlo_options options, size_t n)
+{
+    std::vector<std::pair<double, double>> cube(10, {0.0, 1.0});
+    DiceForge::XORShift64 rng = DiceForge::XORShift64(42);
+    auto start = std::chrono::high_resolution_clock::now();
+    DiceForge::monte_carlo_result r = DiceForge::monte_carlo_integrate(product, cube, n, rng, options);
+    std::chrono::duration<double, std::milli> t = std::chrono::high_resolution_clock::now() - start;
+    std::cout << std::setprecision(10) << name << ": " << r.value << " +- " << r.error << " (" << r.evaluations
+              << " evaluations, " << t.count() << "ms, " << std::fabs(r.value - 1) / r.error << " sigma off)" << std::endl;
+
+    options.threads = options.threads == 1 ? 4 : 1;
+    DiceForge::XORShift64 rng2 = DiceForge::XORShift64(42);
+    DiceForge::monte_carlo_result r2 = DiceForge::monte_carlo_integrate(product, cube, n, rng2, options);
+    std::cout << "  same on other thread count: " << (r.value == r2.value && r.error == r2.error && rng.next() == rng2.next() ? "OK" : "FAILED") << std::endl;
+}
+
+int main(int argc, char const *argv[])
+{
+    const size_t n = 4000000;
+    run("plain", {false, 1, 1}, n);
+    run("antithetic", {true, 1, 1}, n);
+    run("stratified", {false, 0, 1}, n);
+    run("stratified antithetic", {true, 0, 1}, n);
+
+    // a 2 dimensional disc of radius 1, whose area is pi
+    std::vector<std::pair<double, double>> square(2, {-1.0, 1.0});
+    DiceForge::XORShift64 rng = DiceForge::XORShift64(7);
+    auto disc = [](const double* x) { return x[0] * x[0] + x[1] * x[1] <= 1 ? 1.0 : 0.0; };
+    DiceForge::monte_carlo_result r = DiceForge::monte_carlo_integrate(disc, square, n, rng, {false, 64});
+    std::cout << std::setprecision(10) << "disc: " << r.value << " +- " << r.error << " (pi = " << M_PI << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include "diceforge.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+
+// Checks MultivariateGaussian: the blocked transform against the plain product with the Cholesky factor, the sample
+// moments against the covariance, the density against the closed form in two dimensions, and times batches of
+// correlated vectors for a factor model
+
+using namespace DiceForge;
+
+// Covariance of a one factor model with d assets: beta_i beta_j + delta_ij s_i^2
+std::vector<double> factor_covariance(size_t d)
+{
+    std::vector<double> c(d * d);
+    for (size_t i = 0; i < d; i++)
+        for (size_t j = 0; j < d; j++)
+        {
+            const double bi = 0.5 + 0.5 * i / d, bj = 0.5 + 0.5 * j / d;
+            c[i * d + j] = bi * bj + ((i == j) ? 0.1 + 0.01 * (i % 7) : 0);
+        }
+    return c;
+}
+
+int main(int argc, char const *argv[])
+{
+    XORShift rng = XORShift(42);
+
+    // Blocked against plain, on a length that is not a multiple of the block nor of the tile
+    {
+        const size_t d = 37, n = 1000;
+        std::vector<double> mean(d);
+        for (size_t i = 0; i < d; i++)
+            mean[i] = 0.1 * i;
+        MultivariateGaussian mvn(mean, factor_covariance(d));
+        const std::vector<double>& L = mvn.get_cholesky();
+        std::vector<double> z(n * d), x(n * d);
+        for (double& v : z)
+            v = 2 * rng.next_unit() - 1;
+        x = z;
+        mvn.transform(x.data(), n);
+        double worst = 0;
+        for (size_t v = 0; v < n; v++)
+            for (size_t i = 0; i < d; i++)
+            {
+                double s = mean[i];
+                for (size_t k = 0; k <= i; k++)
+                    s += L[i * d + k] * z[v * d + k];
+                worst = std::max(worst, std::fabs(s - x[v * d + i]));
+            }
+        std::cout << "transform against L z: " << worst << std::endl;
+    }
+
+    // Sample moments
+    {
+        const size_t d = 50, n = 200000;
+        const std::vector<double> c = factor_covariance(d);
+        MultivariateGaussian mvn(std::vector<double>(d, 1.0), c);
+        std::vector<double> x(n * d);
+        mvn.sample(rng, x.data(), n);
+        double mean_error = 0, covariance_error = 0;
+        std::vector<double> m(d, 0.0);
+        for (size_t v = 0; v < n; v++)
+            for (size_t i = 0; i < d; i++)
+                m[i] += x[v * d + i] / n;
+        for (size_t i = 0; i < d; i++)
+        {
+            mean_error = std::max(mean_error, std::fabs(m[i] - 1) / std::sqrt(c[i * d + i] / n));
+            for (size_t j = 0; j <= i; j++)
+            {
+                double s = 0;
+                for (size_t v = 0; v < n; v++)
+                    s += (x[v * d + i] - m[i]) * (x[v * d + j] - m[j]);
+                // standard error of a sample covariance, sqrt((c_ii c_jj + c_ij^2) / n)
+                const double se = std::sqrt((c[i * d + i] * c[j * d + j] + c[i * d + j] * c[i * d + j]) / n);
+                covariance_error = std::max(covariance_error, std::fabs(s / n - c[i * d + j]) / se);
+            }
+        }
+        std::cout << "largest deviations in standard errors (over " << d << " means and " << d * (d + 1) / 2
+                  << " covariances): " << mean_error << ", " << covariance_error << std::endl;
+    }
+
+    // Density in two dimensions
+    {
+        const double s1 = 1.5, s2 = 0.5, rho = -0.6;
+        MultivariateGaussian mvn({1, -2}, {s1 * s1, rho * s1 * s2, rho * s1 * s2, s2 * s2});
+        double worst = 0;
+        for (int i = 0; i < 1000; i++)
+        {
+            const double x[2] = {1 + 6 * (rng.next_unit() - 0.5), -2 + 2 * (rng.next_unit() - 0.5)};
+            const double u = (x[0] - 1) / s1, v = (x[1] + 2) / s2;
+            const double reference = std::exp(-(u * u - 2 * rho * u * v + v * v) / (2 * (1 - rho * rho)))
+                                     / (2 * M_PI * s1 * s2 * std::sqrt(1 - rho * rho));
+            worst = std::max(worst, std::fabs(mvn.pdf(x) - reference) / reference);
+        }
+        std::cout << "2D pdf relative error: " << worst << std::endl;
+    }
+
+    // Timing: standard normals, then the blocked transform or the plain product vector by vector
+    for (size_t d : {50, 200, 500})
+    {
+        const size_t n = 20000000 / d;
+        MultivariateGaussian mvn(std::vector<double>(d, 0.0), factor_covariance(d));
+        const std::vector<double>& L = mvn.get_cholesky();
+        std::vector<double> z(n * d), x(n * d);
+        auto start = std::chrono::high_resolution_clock::now();
+        for (double& v : z)
+            v = ziggurat::next_normal(rng);
+        std::chrono::duration<double, std::milli> t = std::chrono::high_resolution_clock::now() - start;
+        std::cout << "d = " << d << ", " << n << " vectors: normals " << t.count() << "ms";
+        x = z;
+        start = std::chrono::high_resolution_clock::now();
+        mvn.transform(x.data(), n);
+        t = std::chrono::high_resolution_clock::now() - start;
+        std::cout << ", blocked " << t.count() << "ms";
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t v = 0; v < n; v++)
+            for (size_t i = 0; i < d; i++)
+            {
+                double s = 0;
+                for (size_t k = 0; k <= i; k++)
+                    s += L[i * d + k] * z[v * d + k];
+                x[v * d + i] = s;
+            }
+        t = std::chrono::high_resolution_clock::now() - start;
+        std::cout << ", plain " << t.count() << "ms (" << x[0] << ")" << std::endl;
+    }
+    return 0;
+}
@@ -45,33 +45,73 @@ void test_all_time(const size_t N)
 {
     DiceForge::BlumBlumShub32 bb1 = DiceForge::BlumBlumShub32(123);
     DiceForge::BlumBlumShub64 bb2 = DiceForge::BlumBlumShub64(123);
+    DiceForge::BlumBlumShubMontgomery64 bb3 = DiceForge::BlumBlumShubMontgomery64(123);
     DiceForge::XORShift32 xs1 = DiceForge::XORShift32(123);
     DiceForge::XORShift64 xs2 = DiceForge::XORShift64(123);
+    DiceForge::XORShift32x8 xs3 = DiceForge::XORShift32x8(123);
+    DiceForge::XORShift64x4 xs4 = DiceForge::XORShift64x4(123);
     DiceForge::MT32 mt1 = DiceForge::MT32(123);
     DiceForge::MT64 mt2 = DiceForge::MT64(123);
     DiceForge::LFSR32 lfsr1 = DiceForge::LFSR32(123);
     DiceForge::LFSR64 lfsr2 = DiceForge::LFSR64(123);
     DiceForge::NaorReingold32 nr = DiceForge::NaorReingold32(123);
+    DiceForge::Philox32 ph1 = DiceForge::Philox32(123);
+    DiceForge::Philox64 ph2 = DiceForge::Philox64(123);
 
     std::cout << "Time performance" << std::endl;
 
     std::cout << "BBS32\tfloats: " << test_time_floats(bb1, N) << "ms, ints: " << test_time_integers(bb1, N) << "ms" <<  std::endl;
+    std::cout << "BBS32\tbulk floats: " << test_time_bulk_floats(bb1, N) << "ms, bulk ints: " << test_time_bulk_integers(bb1, N) << "ms" <<  std::endl;
+    std::cout << "BBS32\tstatic floats: " << test_time_static_floats(bb1, N) << "ms" <<  std::endl;
 
     std::cout << "BBS64\tfloats: " << test_time_floats(bb2, N) << "ms, ints: " << test_time_integers(bb2, N) << "ms" <<  std::endl;
+    std::cout << "BBS64\tbulk floats: " << test_time_bulk_floats(bb2, N) << "ms, bulk ints: " << test_time_bulk_integers(bb2, N) << "ms" <<  std::endl;
+    std::cout << "BBS64\tstatic floats: " << test_time_static_floats(bb2, N) << "ms" <<  std::endl;
+
+    std::cout << "BBSM64\tfloats: " << test_time_floats(bb3, N) << "ms, ints: " << test_time_integers(bb3, N) << "ms" <<  std::endl;
+    std::cout << "BBSM64\tbulk floats: " << test_time_bulk_floats(bb3, N) << "ms, bulk ints: " << test_time_bulk_integers(bb3, N) << "ms" <<  std::endl;
 
     std::cout << "XOR32\tfloats: " << test_time_floats(xs1, N) << "ms, ints: " << test_time_integers(xs1, N) << "ms" <<  std::endl;
+    std::cout << "XOR32\tbulk floats: " << test_time_bulk_floats(xs1, N) << "ms, bulk ints: " << test_time_bulk_integers(xs1, N) << "ms" <<  std::endl;
+    std::cout << "XOR32\tstatic floats: " << test_time_static_floats(xs1, N) << "ms" <<  std::endl;
 
     std::cout << "XOR64\tfloats: " << test_time_floats(xs2, N) << "ms, ints: " << test_time_integers(xs2, N) << "ms" <<  std::endl;
+    std::cout << "XOR64\tbulk floats: " << test_time_bulk_floats(xs2, N) << "ms, bulk ints: " << test_time_bulk_integers(xs2, N) << "ms" <<  std::endl;
+    std::cout << "XOR64\tstatic floats: " << test_time_static_floats(xs2, N) << "ms" <<  std::endl;
+
+    std::cout << "XOR32x8\tfloats: " << test_time_floats(xs3, N) << "ms, ints: " << test_time_integers(xs3, N) << "ms" <<  std::endl;
+    std::cout << "XOR32x8\tbulk floats: " << test_time_bulk_floats(xs3, N) << "ms, bulk ints: " << test_time_bulk_integers(xs3, N) << "ms" <<  std::endl;
+
+    std::cout << "XOR64x4\tfloats: " << test_time_floats(xs4, N) << "ms, ints: " << test_time_integers(xs4, N) << "ms" <<  std::endl;
+    std::cout << "XOR64x4\tbulk floats: " << test_time_bulk_floats(xs4, N) << "ms, bulk ints: " << test_time_bulk_integers(xs4, N) << "ms" <<  std::endl;
 
     std::cout << "MT32\tfloats: " << test_time_floats(mt1, N) << "ms, ints: " << test_time_integers(mt1, N) << "ms" <<  std::endl;
+    std::cout << "MT32\tbulk floats: " << test_time_bulk_floats(mt1, N) << "ms, bulk ints: " << test_time_bulk_integers(mt1, N) << "ms" <<  std::endl;
+    std::cout << "MT32\tstatic floats: " << test_time_static_floats(mt1, N) << "ms" <<  std::endl;
 
     std::cout << "MT64\tfloats: " << test_time_floats(mt2, N) << "ms, ints: " << test_time_integers(mt2, N)  << "ms" <<  std::endl;
+    std::cout << "MT64\tbulk floats: " << test_time_bulk_floats(mt2, N) << "ms, bulk ints: " << test_time_bulk_integers(mt2, N) << "ms" <<  std::endl;
+    std::cout << "MT64\tstatic floats: " << test_time_static_floats(mt2, N) << "ms" <<  std::endl;
 
     std::cout << "LFSR32\tfloats: " << test_time_floats(lfsr1, N) << "ms, ints: " << test_time_integers(lfsr1, N) << "ms" <<  std::endl;
+    std::cout << "LFSR32\tbulk floats: " << test_time_bulk_floats(lfsr1, N) << "ms, bulk ints: " << test_time_bulk_integers(lfsr1, N) << "ms" <<  std::endl;
+    std::cout << "LFSR32\tstatic floats: " << test_time_static_floats(lfsr1, N) << "ms" <<  std::endl;
 
     std::cout << "LFSR64\tfloats: " << test_time_floats(lfsr2, N) << "ms, ints: " << test_time_integers(lfsr2, N)  << "ms" <<  std::endl;
+    std::cout << "LFSR64\tbulk floats: " << test_time_bulk_floats(lfsr2, N) << "ms, bulk ints: " << test_time_bulk_integers(lfsr2, N) << "ms" <<  std::endl;
+    std::cout << "LFSR64\tstatic floats: " << test_time_static_floats(lfsr2, N) << "ms" <<  std::endl;
 
     std::cout << "NR\tfloats: " << test_time_floats(nr, N) << "ms, ints: " << test_time_integers(nr, N)  << "ms" <<  std::endl;
+    std::cout << "NR\tbulk floats: " << test_time_bulk_floats(nr, N) << "ms, bulk ints: " << test_time_bulk_integers(nr, N) << "ms" <<  std::endl;
+    std::cout << "NR\tstatic floats: " << test_time_static_floats(nr, N) << "ms" <<  std::endl;
+
+    std::cout << "PHI32\tfloats: " << test_time_floats(ph1, N) << "ms, ints: " << test_time_integers(ph1, N) << "ms" <<  std::endl;
+    std::cout << "PHI32\tbulk floats: " << test_time_bulk_floats(ph1, N) << "ms, bulk ints: " << test_time_bulk_integers(ph1, N) << "ms" <<  std::endl;
+    std::cout << "PHI32\tstatic floats: " << test_time_static_floats(ph1, N) << "ms" <<  std::endl;
+
+    std::cout << "PHI64\tfloats: " << test_time_floats(ph2, N) << "ms, ints: " << test_time_integers(ph2, N) << "ms" <<  std::endl;
+    std::cout << "PHI64\tbulk floats: " << test_time_bulk_floats(ph2, N) << "ms, bulk ints: " << test_time_bulk_integers(ph2, N) << "ms" <<  std::endl;
+    std::cout << "PHI64\tstatic floats: " << test_time_static_floats(ph2, N) << "ms" <<  std::endl;
 
     std::random_device rd{};    
     std::mt19937 engine{rd()};
@@ -90,13 +130,18 @@ void test_all_stats(const size_t N)
 {
     DiceForge::BlumBlumShub32 bb1 = DiceForge::BlumBlumShub32(123);
     DiceForge::BlumBlumShub64 bb2 = DiceForge::BlumBlumShub64(123);
+    DiceForge::BlumBlumShubMontgomery64 bb3 = DiceForge::BlumBlumShubMontgomery64(123);
     DiceForge::XORShift32 xs1 = DiceForge::XORShift32(123);
     DiceForge::XORShift64 xs2 = DiceForge::XORShift64(123);
+    DiceForge::XORShift32x8 xs3 = DiceForge::XORShift32x8(123);
+    DiceForge::XORShift64x4 xs4 = DiceForge::XORShift64x4(123);
     DiceForge::MT32 mt1 = DiceForge::MT32(123);
     DiceForge::MT64 mt2 = DiceForge::MT64(123);
     DiceForge::LFSR32 lfsr1 = DiceForge::LFSR32(123);
     DiceForge::LFSR64 lfsr2 = DiceForge::LFSR64(123);
     DiceForge::NaorReingold32 nr = DiceForge::NaorReingold32(123);
+    DiceForge::Philox32 ph1 = DiceForge::Philox32(123);
+    DiceForge::Philox64 ph2 = DiceForge::Philox64(123);
 
     std::cout << "Statistical performance" << std::endl;
 
@@ -106,12 +151,21 @@ void test_all_stats(const size_t N)
     stats = test_statistical(bb2, N);
     std::cout << "BBS64\tmean: " << stats[0] << ", variance: " << stats[1] <<  std::endl;
 
+    stats = test_statistical(bb3, N);
+    std::cout << "BBSM64\tmean: " << stats[0] << ", variance: " << stats[1] <<  std::endl;
+
     stats = test_statistical(xs1, N);
     std::cout << "XOR32\tmean: " << stats[0] << ", variance: " << stats[1] <<  std::endl;
 
     stats = test_statistical(xs2, N);
     std::cout << "XOR64\tmean: " << stats[0] << ", variance: " << stats[1] <<  std::endl;
 
+    stats = test_statistical(xs3, N);
+    std::cout << "XOR32x8\tmean: " << stats[0] << ", variance: " << stats[1] <<  std::endl;
+
+    stats = test_statistical(xs4, N);
+    std::cout << "XOR64x4\tmean: " << stats[0] << ", variance: " << stats[1] <<  std::endl;
+
     stats = test_statistical(mt1, N);
     std::cout << "MT32\tmean: " << stats[0] << ", variance: " << stats[1] <<  std::endl;
 
@@ -127,5 +181,11 @@ void test_all_stats(const size_t N)
     stats = test_statistical(nr, N);
     std::cout << "NR\tmean: " << stats[0] << ", variance: " << stats[1] <<  std::endl;
 
+    stats = test_statistical(ph1, N);
+    std::cout << "PHI32\tmean: " << stats[0] << ", variance: " << stats[1] <<  std::endl;
+
+    stats = test_statistical(ph2, N);
+    std::cout << "PHI64\tmean: " << stats[0] << ", variance: " << stats[1] <<  std::endl;
+
     std::cout << "\n\n";
 }
\ No newline at end of file
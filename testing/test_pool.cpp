@@ -0,0 +1,118 @@
+#include "diceforge.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+
+// Checks GeneratorPool: the streams against DiceForge::split, parallel_fill and parallel_sample against the same
+// pool on one thread (they should not depend on the number of threads), parallel_sample of samplers keeping a
+// state between draws (adaptive rejection, Maxwell) likewise, local() handing out distinct streams, and times
+// parallel_sample against the serial batch
+
+using namespace DiceForge;
+
+int main(int argc, char const *argv[])
+{
+    const size_t N = 20000000, streams = 16;
+    const MT64 master(2024);
+
+    // Stream i is the i-th substream of split
+    {
+        GeneratorPool<MT64> pool(master, streams);
+        std::vector<MT64> reference = split(master, streams);
+        size_t differences = 0;
+        for (size_t i : {5, 0, 15, 3})
+            for (int j = 0; j < 1000; j++)
+                differences += (pool.stream(i).next() != reference[i].next());
+        std::cout << "streams against split: " << differences << " differences" << std::endl;
+    }
+
+    // The same values on any number of threads
+    std::vector<double> serial(N), parallel(N);
+    for (int threads : {1, 2, 3, 8})
+    {
+        GeneratorPool<MT64> reference(master, streams), pool(master, streams);
+        parallel_fill(reference, serial.data(), N, 1);
+        parallel_fill(pool, parallel.data(), N, threads);
+        size_t fill = 0;
+        for (size_t i = 0; i < N; i++)
+            fill += (serial[i] != parallel[i]);
+        Gaussian g(1, 2);
+        parallel_sample(reference, g, serial.data(), N, 1);
+        parallel_sample(pool, g, parallel.data(), N, threads);
+        size_t sample = 0;
+        for (size_t i = 0; i < N; i++)
+            sample += (serial[i] != parallel[i]);
+        std::cout << threads << " threads: " << fill << " fill and " << sample << " sample differences" << std::endl;
+    }
+
+    // Samplers with a state of their own: each stream draws from a copy, the originals being left unchanged
+    {
+        auto normal = [](double x) { return -x * x / 2; };
+        AdaptiveRejection<decltype(normal)> ars(normal, {-1, 0.5, 2});
+        Maxwell maxwell(2);
+        const size_t M = 2000000;
+        std::vector<double> one(M), many(M);
+        for (int threads : {2, 8})
+        {
+            GeneratorPool<MT64> reference(master, streams), pool(master, streams);
+            parallel_sample(reference, ars, one.data(), M, 1);
+            parallel_sample(pool, ars, many.data(), M, threads);
+            size_t adaptive = 0;
+            for (size_t i = 0; i < M; i++)
+                adaptive += (one[i] != many[i]);
+            parallel_sample(reference, maxwell, one.data(), M, 1);
+            parallel_sample(pool, maxwell, many.data(), M, threads);
+            size_t cached = 0;
+            for (size_t i = 0; i < M; i++)
+                cached += (one[i] != many[i]);
+            std::cout << threads << " threads: " << adaptive << " AdaptiveRejection and " << cached
+                      << " Maxwell differences, " << ars.size() << " points left in the envelope" << std::endl;
+        }
+    }
+
+    // One stream per thread from local()
+    {
+        GeneratorPool<MT64> pool(master, streams);
+        std::vector<MT64*> seen(4);
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < 4; t++)
+            workers.emplace_back([&, t]() {
+                MT64* first = &pool.local();
+                seen[t] = (&pool.local() == first) ? first : nullptr;
+            });
+        for (std::thread& w : workers)
+            w.join();
+        size_t distinct = 0;
+        for (size_t t = 0; t < 4; t++)
+        {
+            bool unique = (seen[t] != nullptr);
+            for (size_t u = 0; u < t; u++)
+                unique = unique && seen[u] != seen[t];
+            distinct += unique;
+        }
+        std::cout << "local(): " << distinct << " distinct, stable streams for 4 threads" << std::endl;
+    }
+
+    // Timing, with the streams made (jumped to) beforehand
+    {
+        Gaussian g(0, 1);
+        MT64 rng = master;
+        auto start = std::chrono::high_resolution_clock::now();
+        g.sample(rng, serial.data(), N);
+        std::chrono::duration<double, std::milli> t = std::chrono::high_resolution_clock::now() - start;
+        std::cout << "serial sample: " << t.count() << "ms";
+        for (int threads : {2, 4, 8})
+        {
+            GeneratorPool<MT64> pool(master, streams);
+            for (size_t i = 0; i < streams; i++)
+                pool.stream(i);
+            start = std::chrono::high_resolution_clock::now();
+            parallel_sample(pool, g, parallel.data(), N, threads);
+            t = std::chrono::high_resolution_clock::now() - start;
+            std::cout << ", " << threads << " threads: " << t.count() << "ms";
+        }
+        std::cout << " (hardware: " << std::thread::hardware_concurrency() << ")" << std::endl;
+    }
+    return 0;
+}
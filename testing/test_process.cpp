@@ -0,0 +1,149 @@
+#include "diceforge.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <cmath>
+
+// Checks the stochastic processes: the counts of a Poisson process per unit of time against the Poisson
+// distribution, and the same arrivals whether sample_until is given a small or a large buffer; the mean count of a
+// thinned process against the integral of its intensity; the moments of the paths of the random walk, the
+// geometric Brownian motion and the Ornstein-Uhlenbeck process against their exact values, and the same paths
+// whether advanced in blocks or at once or through save_state; then times the paths against a loop of next calls
+
+using namespace DiceForge;
+
+void compare(const char* name, double got, double expected)
+{
+    std::cout << std::setw(40) << std::left << name << std::setw(14) << got << "expected " << expected << std::endl;
+}
+
+int main(int argc, char const *argv[])
+{
+    // Homogeneous Poisson process: counts per unit of time, and small buffers against a large one
+    {
+        XORShift64 rng(3), copy(3);
+        PoissonProcess process(3.0), same(3.0);
+        const double end = 200000;
+        std::vector<double> all(1000000);
+        const size_t n = process.sample_until(rng, end, all.data(), all.size());
+        all.resize(n);
+
+        std::vector<long long> counts(size_t(end), 0);
+        for (double t : all)
+            counts[size_t(t)]++;
+        Histogram h(0, 20, 20);
+        h.add(counts.data(), counts.size());
+        std::cout << "counts per unit of time against Poisson(3): chi2 p " << h.chi_square(Poisson(3.0)).p_value << std::endl;
+
+        std::vector<double> chunked, buffer(7);
+        size_t m;
+        do {
+            m = same.sample_until(copy, end, buffer.data(), buffer.size());
+            chunked.insert(chunked.end(), buffer.begin(), buffer.begin() + m);
+        } while (m == buffer.size());
+        std::cout << "buffers of 7 against one buffer: " << (chunked == all ? "same" : "DIFFERENT") << ", ended at "
+                  << same.time() << std::endl;
+    }
+
+    // Thinning with intensity 2 + sin t: 4 pi arrivals per period, (2 pi + 2) / (4 pi) of them in its first half
+    {
+        XORShift64 rng(5);
+        InhomogeneousPoissonProcess process([](double t) { return 2 + std::sin(t); }, 3.0);
+        const double periods = 20000, end = 2 * M_PI * periods;
+        std::vector<double> times(2000000);
+        const size_t n = process.sample_until(rng, end, times.data(), times.size());
+        size_t first_half = 0;
+        for (size_t i = 0; i < n; i++)
+            first_half += (std::fmod(times[i], 2 * M_PI) < M_PI);
+        compare("arrivals per period", n / periods, 4 * M_PI);
+        compare("fraction in the first half period", double(first_half) / n, (2 * M_PI + 2) / (4 * M_PI));
+    }
+
+    // Random walk: mean and variance after 1000 steps, and blocks of 64 steps against one block
+    {
+        XORShift64 rng(7), copy(7);
+        const size_t paths = 20000, steps = 1000;
+        GaussianRandomWalk walk(paths, 0.01, 0.5, 1.0), same(paths, 0.01, 0.5, 1.0);
+        std::vector<double> block(64 * paths), once(steps * paths);
+        for (size_t s = 0; s < steps; s += 64)
+            walk.advance(rng, block.data(), std::min(size_t(64), steps - s));
+        same.advance(copy, once.data(), steps);
+        Moments m;
+        m.add(walk.values(), paths);
+        compare("random walk mean", m.mean(), 1.0 + 0.01 * steps);
+        compare("random walk variance", m.variance(), 0.25 * steps);
+        size_t differences = 0;
+        for (size_t p = 0; p < paths; p++)
+            differences += (walk.values()[p] != once[(steps - 1) * paths + p]) + (same.values()[p] != walk.values()[p]);
+        std::cout << "blocks of 64 against one block: " << differences << " differences" << std::endl;
+    }
+
+    // Geometric Brownian motion: E S_T = s0 e^(mu T) and the variance of log S_T, sigma^2 T
+    {
+        XORShift64 rng(9);
+        const size_t paths = 100000;
+        const double mu = 0.05, sigma = 0.2, dt = 1.0 / 250, T = 1;
+        GeometricBrownianMotion gbm(paths, 100.0, mu, sigma, dt);
+        gbm.advance(rng, 250);
+        Moments s, l;
+        for (size_t p = 0; p < paths; p++) {
+            s.add(gbm.values()[p]);
+            l.add(std::log(gbm.values()[p]));
+        }
+        compare("geometric Brownian motion mean", s.mean(), 100 * std::exp(mu * T));
+        compare("variance of the logarithm", l.variance(), sigma * sigma * T);
+    }
+
+    // Ornstein-Uhlenbeck: the stationary variance, the correlation between steps and a save_state resumed elsewhere
+    {
+        XORShift64 rng(11);
+        const size_t paths = 10000;
+        OrnsteinUhlenbeck ou(paths, 2.0, 1.0, 0.3, 0.1, 5.0);
+        ou.advance(rng, 100);
+        std::vector<double> x0(ou.values(), ou.values() + paths), rows(paths);
+        ou.advance(rng, rows.data(), 1);
+        Moments m;
+        m.add(x0.data(), paths);
+        double c = 0;
+        for (size_t p = 0; p < paths; p++)
+            c += (x0[p] - m.mean()) * (rows[p] - m.mean());
+        compare("Ornstein-Uhlenbeck stationary variance", m.variance(), ou.stationary_deviation() * ou.stationary_deviation());
+        compare("correlation of consecutive values", c / paths / m.variance(), std::exp(-2.0 * 0.1));
+
+        std::vector<unsigned char> state = ou.save_state();
+        XORShift64 copy = rng;
+        OrnsteinUhlenbeck resumed(paths, 1.0, 0.0, 1.0, 1.0);
+        resumed.load_state(state);
+        ou.advance(rng, 10);
+        resumed.advance(copy, 10);
+        size_t differences = (ou.steps() != resumed.steps());
+        for (size_t p = 0; p < paths; p++)
+            differences += (ou.values()[p] != resumed.values()[p]);
+        std::cout << "resumed from save_state: " << differences << " differences" << std::endl;
+    }
+
+    // Time per step of a path
+    {
+        XORShift64 rng(13);
+        const size_t paths = 1024, steps = 10000;
+        std::vector<double> block(16 * paths);
+        GeometricBrownianMotion gbm(paths, 100.0, 0.05, 0.2, 1.0 / 250);
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t s = 0; s < steps; s += 16)
+            gbm.advance(rng, block.data(), 16);
+        std::chrono::duration<double, std::nano> t = std::chrono::high_resolution_clock::now() - start;
+        std::cout << "GeometricBrownianMotion::advance " << t.count() / (paths * steps) << " ns" << std::endl;
+
+        Gaussian normal(0, 1);
+        std::vector<double> s(paths, 100.0);
+        const double drift = (0.05 - 0.02) / 250, vol = 0.2 * std::sqrt(1.0 / 250);
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t k = 0; k < steps; k++)
+            for (size_t p = 0; p < paths; p++)
+                s[p] *= std::exp(drift + vol * normal.next(rng));
+        t = std::chrono::high_resolution_clock::now() - start;
+        std::cout << " loop of Gaussian::next and exp   " << t.count() / (paths * steps) << " ns (" << s[0] + block[0] << ")" << std::endl;
+    }
+    return 0;
+}
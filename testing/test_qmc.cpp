@@ -0,0 +1,66 @@
+#include "diceforge.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+// Integrates exp(x_1 + ... + x_d) / (e - 1)^d over the unit cube (exactly 1) with the same number of points
+// from a PRNG and from the Sobol and Halton sequences, and compares the errors. Then checks that jumping
+// ahead lands on the same elements as drawing them, and times the bulk fills.
+
+const int D = 8;
+
+double product(const double* x)
+{
+    double s = 0;
+    for (int j = 0; j < D; j++)
+        s += x[j];
+    return std::exp(s) / std::pow(M_E - 1, D);
+}
+
+template <typename Engine>
+double error(Engine& rng, size_t n)
+{
+    std::vector<std::pair<double, double>> cube(D, {0.0, 1.0});
+    return std::fabs(DiceForge::monte_carlo_integrate(product, cube, n, rng, {false, 1, 1}).value - 1);
+}
+
+template <typename Engine>
+bool check_jump(Engine a, Engine b)
+{
+    std::vector<DiceForge::uint64_t> drawn(D * 10000);
+    a.fill(drawn.data(), drawn.size());
+    b.jump(D * 6543 + 5);
+    for (int i = 0; i < 1000; i++)
+        if (b.next() != drawn[D * 6543 + 5 + i])
+            return false;
+    return true;
+}
+
+int main(int argc, char const *argv[])
+{
+    std::cout << std::setprecision(4) << "points\tXORShift64\tSobol\tHalton\tscrambled Halton" << std::endl;
+    for (size_t n = 1024; n <= 1048576; n *= 8)
+    {
+        DiceForge::XORShift64 prng = DiceForge::XORShift64(42);
+        DiceForge::Sobol sobol = DiceForge::Sobol(D);
+        DiceForge::Halton halton = DiceForge::Halton(D), scrambled = DiceForge::Halton(D, 42);
+        std::cout << n << "\t" << error(prng, n) << "\t" << error(sobol, n) << "\t" << error(halton, n) << "\t"
+                  << error(scrambled, n) << std::endl;
+    }
+
+    std::cout << "Sobol jump: " << (check_jump(DiceForge::Sobol(D, 7), DiceForge::Sobol(D, 7)) ? "OK" : "FAILED") << std::endl;
+    std::cout << "Halton jump: " << (check_jump(DiceForge::Halton(D, 7), DiceForge::Halton(D, 7)) ? "OK" : "FAILED") << std::endl;
+
+    std::vector<double> x(10000000);
+    DiceForge::Sobol sobol = DiceForge::Sobol(300);
+    DiceForge::Halton halton = DiceForge::Halton(300);
+    auto start = std::chrono::high_resolution_clock::now();
+    sobol.fill_unit(x.data(), x.size());
+    std::chrono::duration<double, std::milli> t = std::chrono::high_resolution_clock::now() - start;
+    std::cout << "Sobol, 300 dimensions, " << x.size() << " coordinates: " << t.count() << "ms" << std::endl;
+    start = std::chrono::high_resolution_clock::now();
+    halton.fill_unit(x.data(), x.size());
+    t = std::chrono::high_resolution_clock::now() - start;
+    std::cout << "Halton, 300 dimensions, " << x.size() << " coordinates: " << t.count() << "ms" << std::endl;
+    return 0;
+}
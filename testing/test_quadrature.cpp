@@ -0,0 +1,28 @@
+#include "diceforge.h"
+#include <iomanip>
+
+// Adaptive Gauss-Kronrod integration of a few integrands that are hard for fixed rules: an endpoint
+// singularity, a sharp peak, an integral of zero, a reversed interval and a budget too small to converge
+
+void show(const char* name, DiceForge::quadrature_result<double> r, double exact)
+{
+    std::cout << std::setprecision(17) << name << " = " << r.value << "\terror estimate: " << std::setprecision(3) << r.error
+              << "\tactual error: " << fabs(r.value - exact) << "\tevaluations: " << r.evaluations
+              << (r.converged ? "" : "\t(not converged)") << std::endl;
+}
+
+int main()
+{
+    show("sqrt(x) on [0, 1]", DiceForge::integrate_adaptive([](double x) { return sqrt(x); }, 0.0, 1.0), 2.0 / 3);
+    show("1/sqrt(x) on [0, 1]", DiceForge::integrate_adaptive([](double x) { return 1 / sqrt(x); }, 0.0, 1.0), 2.0);
+    show("1/(1e-4 + x^2) on [-1, 1]", DiceForge::integrate_adaptive([](double x) { return 1 / (1e-4 + x * x); }, -1.0, 1.0), 200 * atan(100.0));
+    show("sin(x) on [-1, 1]", DiceForge::integrate_adaptive([](double x) { return sin(x); }, -1.0, 1.0), 0);
+    show("x on [1, 0]", DiceForge::integrate_adaptive([](double x) { return x; }, 1.0, 0.0), -0.5);
+    show("1/sqrt(x) on [0, 1], 500 evaluations", DiceForge::integrate_adaptive([](double x) { return 1 / sqrt(x); }, 0.0, 1.0, 1e-15, 0.0, 500), 2.0);
+
+    // batch integrands get the 15 nodes of a panel in one call
+    DiceForge::Gaussian g(0, 1);
+    auto pdf = [&](const double* x, double* y, size_t n) { g.pdf(x, y, n); };
+    show("batch P(|Z| < 3)", DiceForge::integrate_adaptive(pdf, -3.0, 3.0), std::erf(3 / std::sqrt(2.0)));
+    return 0;
+}
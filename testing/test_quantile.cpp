@@ -0,0 +1,120 @@
+#include "diceforge.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <cfloat>
+
+// Round trips of the quantile functions through the cdfs: for the continuous distributions the worst
+// |cdf(quantile(p)) - p| in units of the rounding of p and of the quantile x (epsilon max(p, pdf(x) |x|)), and for
+// the discrete ones the number of quantiles that are not the smallest k with cdf(k) >= p. The batches are checked
+// against the scalar functions (to 1e-14, continuous, and exactly, discrete), and the inverse transform of the
+// shifted Exponential against its quantile.
+
+using namespace DiceForge;
+
+std::vector<double> probabilities(size_t n)
+{
+    // Half uniform, half spread over the tails down to 1e-12
+    XORShift rng = XORShift(7);
+    std::vector<double> p(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        const double t = std::pow(10.0, -12 * rng.next_unit());
+        p[i] = (i % 2) ? rng.next_unit() : ((i % 4) ? t : 1 - t);
+    }
+    return p;
+}
+
+void test_continuous(const char* name, const Continuous& d, const std::vector<double>& p)
+{
+    std::vector<double> q(p.size());
+    auto start = std::chrono::high_resolution_clock::now();
+    d.quantile(p.data(), q.data(), p.size());
+    std::chrono::duration<double, std::milli> t = std::chrono::high_resolution_clock::now() - start;
+    double worst = 0;
+    size_t mismatches = 0;
+    for (size_t i = 0; i < p.size(); i++)
+    {
+        const double x = d.quantile(p[i]), unit = DBL_EPSILON * std::max(p[i], d.pdf(x) * std::fabs(x));
+        worst = std::max(worst, std::fabs(d.cdf(x) - p[i]) / unit);
+        mismatches += !(std::fabs(x - q[i]) <= 1e-14 * std::fabs(x));
+    }
+    std::cout << std::setw(24) << std::left << name << std::setprecision(3) << worst << "\t" << mismatches
+              << "\t\t\t" << t.count() << "ms" << std::endl;
+}
+
+void test_discrete(const char* name, const Discrete& d, const std::vector<double>& p)
+{
+    std::vector<int_t> q(p.size());
+    auto start = std::chrono::high_resolution_clock::now();
+    d.quantile(p.data(), q.data(), p.size());
+    std::chrono::duration<double, std::milli> t = std::chrono::high_resolution_clock::now() - start;
+    size_t wrong = 0, mismatches = 0;
+    for (size_t i = 0; i < p.size(); i++)
+    {
+        wrong += !(d.cdf(q[i]) >= p[i] && (q[i] == d.minValue() || d.cdf(q[i] - 1) < p[i]));
+        mismatches += (d.quantile(p[i]) != q[i]);
+    }
+    std::cout << std::setw(24) << std::left << name << wrong << "\t" << mismatches << "\t" << t.count() << "ms"
+              << std::endl;
+}
+
+int main(int argc, char const *argv[])
+{
+    const std::vector<double> p = probabilities(100000);
+
+    std::cout << "continuous\t\terror (in rounding units)\tbatch mismatches" << std::endl;
+    test_continuous("Gaussian(1, 2)", Gaussian(1, 2), p);
+    test_continuous("Cauchy(-1, 3)", Cauchy(-1, 3), p);
+    test_continuous("Exponential(2, 1)", Exponential(2, 1), p);
+    test_continuous("Weibull(2, 0.7)", Weibull(2, 0.7), p);
+    test_continuous("Maxwell(2)", Maxwell(2), p);
+    const std::vector<double> inner(p.begin(), p.begin() + 2000);
+    test_continuous("Custom (default)", CustomDistribution(0, 3, [](real_t x) { return x * x; }), inner);
+
+    std::cout << "discrete\t\twrong\tbatch mismatches" << std::endl;
+    test_discrete("Bernoulli(0.3)", Bernoulli(0.3), p);
+    test_discrete("Geometric(0.01)", Geometric(0.01), p);
+    test_discrete("Poisson(3)", Poisson(3), p);
+    test_discrete("Poisson(1e4)", Poisson(1e4), inner);
+    test_discrete("Binomial(40, 0.1)", Binomial(40, 0.1), p);
+    test_discrete("Binomial(1000, 0.7)", Binomial(1000, 0.7), inner);
+    test_discrete("Hypergeometric", Hypergeometric(500, 200, 100), inner);
+    test_discrete("NegHypergeometric", NegHypergeometric(500, 200, 100), inner);
+    std::vector<int_t> states = {-3, 0, 2, 7, 11};
+    std::vector<real_t> energies = {1, 0.5, 0, 2, 0.25};
+    test_discrete("Gibbs(beta = 1)", Gibbs(states.begin(), states.end(), energies.begin(), energies.end(), 1), p);
+
+    // gamma_p_inverse against gamma_p, over shapes on both sides of 1
+    double worst = 0;
+    for (double a : {0.1, 0.5, 1.0, 1.5, 7.0, 250.0})
+        for (size_t i = 0; i < 20000; i++)
+        {
+            const double x = special::gamma_p_inverse(a, p[i]);
+            const double r = (p[i] > 0.5) ? 1 - special::gamma_q(a, x) : special::gamma_p(a, x);
+            worst = std::max(worst, std::fabs(r - p[i]) / std::min(p[i], 1 - p[i]));
+        }
+    std::cout << "gamma_p_inverse " << std::setprecision(3) << worst << std::endl;
+    std::cout << "Maxwell(1).quantile(0.5) = " << std::setprecision(17) << Maxwell(1).quantile(0.5)
+              << " (1.5381722544550523)" << std::endl;
+    {
+        Exponential shifted(2, 1);
+        size_t differ = 0;
+        for (double u : p)
+            differ += (shifted.next(u) != shifted.quantile(u)) + (shifted.next(u) < shifted.minValue());
+        std::cout << "Exponential(2, 1).next(u) against quantile(u) and minValue(): " << differ << " differences"
+                  << std::endl;
+    }
+
+    try
+    {
+        Gaussian().quantile(1.5);
+        std::cout << "quantile(1.5) did not throw" << std::endl;
+    }
+    catch (const std::invalid_argument&)
+    {
+        std::cout << "quantile(1.5) throws std::invalid_argument" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include "diceforge.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <cmath>
+
+// Checks sample_each: for a single parameter repeated, the chi-square test against the distribution; for parameters
+// varying from one element to the next, the standardized values (x - mean) / sd, whose mean and variance should be
+// 0 and 1; then times sample_each against constructing a distribution per element
+
+using namespace DiceForge;
+
+const size_t N = 4000000;
+
+// Mean and variance of (x[i] - mean[i]) / sd[i]
+template <typename V>
+void standardized(const char* name, const std::vector<V>& x, const std::vector<double>& mean,
+                  const std::vector<double>& sd)
+{
+    std::vector<double> z(x.size());
+    for (size_t i = 0; i < x.size(); i++)
+        z[i] = (double(x[i]) - mean[i]) / sd[i];
+    Moments m;
+    m.add(z.data(), z.size());
+    std::cout << std::setw(34) << std::left << name << "mean " << std::setw(14) << m.mean() << "variance "
+              << m.variance() << std::endl;
+}
+
+int main(int argc, char const *argv[])
+{
+    XORShift64 rng(11);
+
+    // One parameter for all: the chi-square test against the distribution
+    for (double lambda : {0.7, 6.0, 37.5})
+    {
+        std::vector<double> l(N, lambda);
+        std::vector<long long> k(N);
+        Poisson::sample_each(rng, l.data(), k.data(), N);
+        Poisson poisson(lambda);
+        const double lo = poisson.quantile(1e-6), hi = poisson.quantile(1 - 1e-6) + 1;
+        Histogram h(lo, hi, size_t(hi - lo));
+        h.add(k.data(), N);
+        std::cout << "Poisson(" << lambda << ") chi2 p " << h.chi_square(poisson).p_value << std::endl;
+    }
+    {
+        std::vector<double> p(N, 0.3);
+        std::vector<long long> k(N);
+        Geometric::sample_each(rng, p.data(), k.data(), N);
+        Geometric geometric(0.3);
+        Histogram h(0, 60, 60);
+        h.add(k.data(), N);
+        std::cout << "Geometric(0.3) chi2 p " << h.chi_square(geometric).p_value << std::endl;
+    }
+
+    // Parameters varying per element
+    std::vector<double> a(N), b(N), mean(N), sd(N), x(N);
+    std::vector<long long> k(N);
+    rng.fill_unit(a.data(), N);
+    rng.fill_unit(b.data(), N);
+    for (size_t i = 0; i < N; i++)
+    {
+        a[i] *= 60;
+        mean[i] = a[i];
+        sd[i] = std::sqrt(a[i]);
+    }
+    Poisson::sample_each(rng, a.data(), k.data(), N);
+    standardized("Poisson, lambda in [0, 60)", k, mean, sd);
+    for (size_t i = 0; i < N; i++)
+    {
+        mean[i] = b[i];
+        sd[i] = std::sqrt(b[i] * (1 - b[i]));
+    }
+    Bernoulli::sample_each(rng, b.data(), k.data(), N);
+    standardized("Bernoulli, p in [0, 1)", k, mean, sd);
+    for (size_t i = 0; i < N; i++)
+    {
+        b[i] = 0.05 + 0.9 * b[i];
+        mean[i] = (1 - b[i]) / b[i];
+        sd[i] = std::sqrt(1 - b[i]) / b[i];
+    }
+    Geometric::sample_each(rng, b.data(), k.data(), N);
+    standardized("Geometric, p in [0.05, 0.95)", k, mean, sd);
+    for (size_t i = 0; i < N; i++)
+    {
+        b[i] = 0.1 + 10 * b[i];
+        mean[i] = 1 / b[i];
+        sd[i] = 1 / b[i];
+    }
+    Exponential::sample_each(rng, b.data(), x.data(), N);
+    standardized("Exponential, k in [0.6, 9.6)", x, mean, sd);
+    for (size_t i = 0; i < N; i++)
+    {
+        mean[i] = a[i] - 30;
+        sd[i] = b[i];
+    }
+    Gaussian::sample_each(rng, mean.data(), sd.data(), x.data(), N);
+    standardized("Gaussian, mu in [-30, 30)", x, mean, sd);
+
+    // Against one object per element
+    auto start = std::chrono::high_resolution_clock::now();
+    Poisson::sample_each(rng, a.data(), k.data(), N);
+    std::chrono::duration<double, std::nano> each = std::chrono::high_resolution_clock::now() - start;
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < N; i++)
+        k[i] = Poisson(a[i]).next(rng);
+    std::chrono::duration<double, std::nano> objects = std::chrono::high_resolution_clock::now() - start;
+    std::cout << "Poisson, lambda in [0, 60): sample_each " << each.count() / N << " ns, an object each "
+              << objects.count() / N << " ns per value" << std::endl;
+
+    rng.fill_unit(b.data(), N);
+    start = std::chrono::high_resolution_clock::now();
+    Bernoulli::sample_each(rng, b.data(), k.data(), N);
+    each = std::chrono::high_resolution_clock::now() - start;
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < N; i++)
+        k[i] = Bernoulli(b[i]).next(rng);
+    objects = std::chrono::high_resolution_clock::now() - start;
+    std::cout << "Bernoulli, p in [0, 1): sample_each " << each.count() / N << " ns, an object each "
+              << objects.count() / N << " ns per value" << std::endl;
+
+    // Invalid parameters throw before anything is drawn
+    b[N / 2] = -1;
+    try
+    {
+        Poisson::sample_each(rng, b.data(), k.data(), N);
+        std::cout << "negative lambda accepted: WRONG" << std::endl;
+    }
+    catch (const std::invalid_argument&)
+    {
+        std::cout << "negative lambda rejected" << std::endl;
+    }
+    return 0;
+}
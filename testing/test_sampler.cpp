@@ -0,0 +1,100 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <cmath>
+
+#include "diceforge.h"
+
+int main(int argc, char const *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Enter number of samples to be drawn :(" << std::endl;
+        return -1;
+    }
+
+    size_t N = atoll(argv[1]);
+    auto rng = DiceForge::XORShift64(123);
+
+    std::vector<double> weights = {1, 0, 2, 3, 4};
+    DiceForge::WeightedSampler sampler(weights.begin(), weights.end());
+
+    std::vector<size_t> out(N), counts(weights.size(), 0);
+    auto t0 = std::chrono::high_resolution_clock::now();
+    sampler.sample(rng, out.data(), N);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (size_t i : out)
+        counts[i]++;
+
+    std::cout << "alias: " << std::chrono::duration<double, std::milli>(t1 - t0).count() << "ms" << std::endl;
+    for (size_t i = 0; i < weights.size(); i++)
+        std::cout << i << "\tobserved: " << double(counts[i]) / N << "\texpected: " << sampler.probability(i) << std::endl;
+
+    // Same weights with a changed entry
+    sampler.update(1, 10);
+    counts.assign(weights.size(), 0);
+    for (size_t j = 0; j < N; j++)
+        counts[sampler.sample(rng)]++;
+    std::cout << "after update, index 1\tobserved: " << double(counts[1]) / N << "\texpected: " << sampler.probability(1) << std::endl;
+
+    // Batches with a bad entry past good ones, and infinite weights, are refused with the sampler unchanged
+    {
+        std::vector<size_t> bad_index = {0, 7}, all = {0, 1, 2, 3, 4};
+        std::vector<double> some = {5, 5}, zeros(5, 0), infinite = {INFINITY};
+        size_t refused = 0;
+        try { sampler.update(bad_index.begin(), bad_index.end(), some.begin()); } catch (const std::invalid_argument&) { refused++; }
+        try { sampler.update(all.begin(), all.end(), zeros.begin()); } catch (const std::invalid_argument&) { refused++; }
+        try { sampler.update(2, INFINITY); } catch (const std::invalid_argument&) { refused++; }
+        try { DiceForge::WeightedSampler s(infinite); } catch (const std::invalid_argument&) { refused++; }
+        std::cout << refused << " of 4 bad updates refused, weight of 0 still " << sampler.weight(0)
+                  << ", probability of 1 still " << sampler.probability(1) << std::endl;
+    }
+
+    // choice() with weights for comparison
+    std::vector<int> values = {0, 1, 2, 3, 4};
+    t0 = std::chrono::high_resolution_clock::now();
+    for (size_t j = 0; j < N; j++)
+        out[j] = rng.choice(values.begin(), values.end(), weights.begin(), weights.end());
+    t1 = std::chrono::high_resolution_clock::now();
+    std::cout << "choice: " << std::chrono::duration<double, std::milli>(t1 - t0).count() << "ms" << std::endl;
+
+    // Without replacement: every index of 0..99 should be chosen about 3% of the time
+    std::vector<int> population(100);
+    for (int i = 0; i < 100; i++)
+        population[i] = i;
+    std::vector<size_t> floyd(100, 0), vitter(100, 0), reservoir(100, 0);
+    int picked[3];
+    DiceForge::uint64_t indices[3];
+    bool ordered = true;
+    for (size_t j = 0; j < N / 3; j++)
+    {
+        rng.sample(population.begin(), population.end(), picked, 3);
+        for (int x : picked)
+            floyd[x]++;
+        rng.sample_indices(100, 3, indices);
+        ordered &= indices[0] < indices[1] && indices[1] < indices[2];
+        for (auto x : indices)
+            vitter[x]++;
+        rng.reservoir_sample(population.begin(), population.end(), picked, 3);
+        for (int x : picked)
+            reservoir[x]++;
+    }
+    double worst[3] = {0, 0, 0};
+    for (int i = 0; i < 100; i++)
+    {
+        worst[0] = std::max(worst[0], std::abs(floyd[i] / double(N) - 0.01));
+        worst[1] = std::max(worst[1], std::abs(vitter[i] / double(N) - 0.01));
+        worst[2] = std::max(worst[2], std::abs(reservoir[i] / double(N) - 0.01));
+    }
+    std::cout << "largest deviation from 1/100	Floyd: " << worst[0] << "	Vitter: " << worst[1]
+              << (ordered ? "" : " (out of order)") << "	reservoir: " << worst[2] << std::endl;
+
+    // A large population that is never stored
+    std::vector<DiceForge::uint64_t> large(1000);
+    t0 = std::chrono::high_resolution_clock::now();
+    rng.sample_indices(1000000000ULL, large.size(), large.begin());
+    t1 = std::chrono::high_resolution_clock::now();
+    std::cout << "1000 of 1e9: " << std::chrono::duration<double, std::milli>(t1 - t0).count() << "ms" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include "diceforge.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <unordered_set>
+
+// Checks the seeding of the RNGs through SeedSequence: the cost of making many short-lived generators, that
+// neighbouring seeds (0 included) give unrelated streams, that no two of them start alike, and that seed material of
+// several words reseeds reproducibly
+
+using namespace DiceForge;
+
+// Average fraction of equal bits between the first outputs of generators seeded with i and i + 1 (1/2 when unrelated),
+// the number of repeated first outputs, and the time per generator
+template <typename Engine>
+void neighbours(const char* name, size_t n)
+{
+    typedef typename Engine::result_type T;
+    std::unordered_set<T> first;
+    double agreement = 0;
+    T previous = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i <= n; i++)
+    {
+        Engine rng(static_cast<T>(i));
+        const T x = rng.next();
+        first.insert(x);
+        if (i > 0)
+            agreement += double(8 * sizeof(T) - __builtin_popcountll((unsigned long long)(x ^ previous))) / (8 * sizeof(T));
+        previous = x;
+    }
+    std::chrono::duration<double, std::micro> t = std::chrono::high_resolution_clock::now() - start;
+    std::cout << std::setw(16) << std::left << name << std::setprecision(4) << agreement / n << "\t\t"
+              << n + 1 - first.size() << "\t\t" << t.count() / (n + 1) << "us" << std::endl;
+}
+
+int main(int argc, char const *argv[])
+{
+    std::cout << "engine\t\tequal bits (0.5)\trepeats\t\tper generator" << std::endl;
+    neighbours<XORShift64>("XORShift64", 1000000);
+    neighbours<XORShift32>("XORShift32", 50000);
+    neighbours<LFSR64>("LFSR64", 1000000);
+    neighbours<Philox64>("Philox64", 1000000);
+    neighbours<MT32>("MT32", 50000);
+    neighbours<MT64>("MT64", 50000);
+    neighbours<NaorReingold>("NaorReingold", 50000);
+    neighbours<BlumBlumShub64>("BlumBlumShub64", 50000);
+
+    // MT64 used to hold 31-bit words after seeding: count the set bits above bit 31 of the first 1000 outputs
+    MT64 mt(1);
+    size_t high = 0;
+    for (int i = 0; i < 1000; i++)
+        high += __builtin_popcountll((unsigned long long)(mt.next() >> 32));
+    std::cout << "MT64 high bits set: " << high / 1000.0 << " of 32 per output" << std::endl;
+
+    // Seed material
+    XORShift64 a(1), b(1);
+    a.reset_seed(SeedSequence{2024, 7, 1});
+    b.reset_seed(SeedSequence{2024, 7, 1});
+    const bool same = a.next() == b.next();
+    b.reset_seed(SeedSequence{2024, 7, 2});
+    const bool differs = a.next() != b.next();
+    MT64 c(5), d(1);
+    d.reset_seed(SeedSequence{5});
+    std::cout << "seed material reproducible: " << (same ? "yes" : "no") << ", last word matters: "
+              << (differs ? "yes" : "no") << ", {s} seeds as s: " << (c.next() == d.next() ? "yes" : "no")
+              << std::endl;
+    return 0;
+}
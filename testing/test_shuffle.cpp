@@ -0,0 +1,64 @@
+#include <iostream>
+#include <chrono>
+#include <numeric>
+#include <map>
+
+#include "diceforge.h"
+
+// Chi-squared statistic of the orders of 4 elements over many shuffles (23 degrees of freedom)
+template <typename Shuffle>
+double chi_squared(Shuffle shuffle, int trials)
+{
+    std::map<std::vector<int>, int> counts;
+    for (int t = 0; t < trials; t++)
+    {
+        std::vector<int> v = {0, 1, 2, 3};
+        shuffle(v);
+        counts[v]++;
+    }
+    double expected = trials / 24.0, chi2 = 0;
+    for (auto& c : counts)
+        chi2 += (c.second - expected) * (c.second - expected) / expected;
+    return chi2 + (24 - counts.size()) * expected;
+}
+
+int main(int argc, char const *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Enter number of elements to be shuffled :(" << std::endl;
+        return -1;
+    }
+
+    size_t N = atoll(argv[1]);
+    DiceForge::XORShift64 rng(123);
+
+    // Values well above 41.6 (p = 0.01) point to a biased shuffle
+    std::cout << "shuffle chi2: " << chi_squared([&](std::vector<int>& v) { rng.shuffle(v.begin(), v.end()); }, 240000) << std::endl;
+    std::cout << "merge chi2: " << chi_squared([&](std::vector<int>& v) {
+        rng.shuffle(v.begin(), v.begin() + 1);
+        rng.shuffle(v.begin() + 1, v.end());
+        DiceForge::detail::merge_shuffled(v.begin(), v.begin() + 1, v.end(), rng);
+    }, 240000) << std::endl;
+
+    std::vector<DiceForge::uint64_t> v(N);
+    std::iota(v.begin(), v.end(), 0);
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    rng.shuffle(v.begin(), v.end());
+    auto t1 = std::chrono::high_resolution_clock::now();
+    DiceForge::parallel_shuffle(v.begin(), v.end(), rng);
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    std::vector<DiceForge::uint64_t> sorted = v;
+    std::sort(sorted.begin(), sorted.end());
+    bool permutation = true;
+    for (size_t i = 0; i < N; i++)
+        permutation &= (sorted[i] == i);
+
+    std::cout << "shuffle: " << std::chrono::duration<double, std::milli>(t1 - t0).count() << "ms, "
+              << "parallel: " << std::chrono::duration<double, std::milli>(t2 - t1).count() << "ms, "
+              << (permutation ? "permutation ok" : "elements lost") << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include "diceforge.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+
+// Compares the special functions with the long double functions of the C library (good to about 1e-19), checks
+// the CDFs built on them against closed forms, and times the batches next to std::erfc
+
+using namespace DiceForge;
+
+double relative(long double reference, double value)
+{
+    return (reference == 0) ? std::fabs(value) : double(fabsl((value - reference) / reference));
+}
+
+int main(int argc, char const *argv[])
+{
+    XORShift rng = XORShift(42);
+    const size_t N = 1000000;
+    std::vector<double> x(N), out(N);
+    for (size_t i = 0; i < N; i++)
+        x[i] = (2 * rng.next_unit() - 1) * 27;
+
+    // maximum relative errors of the scalar functions and of the batches, where the results are normal numbers
+    double worst[6] = {0, 0, 0, 0, 0, 0};
+    std::vector<double> batch_erf(N), batch_erfc(N), batch_cdf(N);
+    special::erf(x.data(), batch_erf.data(), N);
+    special::erfc(x.data(), batch_erfc.data(), N);
+    special::normal_cdf(x.data(), batch_cdf.data(), N);
+    for (size_t i = 0; i < N; i++)
+    {
+        const long double X = x[i], e = erfl(X), c = erfcl(X), phi = 0.5L * erfcl(-X / sqrtl(2.0L));
+        worst[0] = std::max(worst[0], relative(e, special::erf(x[i])));
+        worst[1] = std::max(worst[1], relative(e, batch_erf[i]));
+        if (c > 2.3e-308L)
+        {
+            worst[2] = std::max(worst[2], relative(c, special::erfc(x[i])));
+            worst[3] = std::max(worst[3], relative(c, batch_erfc[i]));
+        }
+        if (phi > 2.3e-308L)
+        {
+            worst[4] = std::max(worst[4], relative(phi, special::normal_cdf(x[i])));
+            worst[5] = std::max(worst[5], relative(phi, batch_cdf[i]));
+        }
+    }
+    std::cout << std::setprecision(3) << "relative errors\t\tscalar\t\tbatch" << std::endl;
+    std::cout << "erf\t\t\t" << worst[0] << "\t" << worst[1] << std::endl;
+    std::cout << "erfc\t\t\t" << worst[2] << "\t" << worst[3] << std::endl;
+    std::cout << "normal_cdf\t\t" << worst[4] << "\t" << worst[5] << std::endl;
+
+    // normal_quantile against normal_cdf, as an error in z
+    double quantile = 0;
+    for (size_t i = 0; i < N; i++)
+    {
+        const double p = (i % 2) ? rng.next_unit() : std::pow(10.0, -300 * rng.next_unit());
+        const double z = special::normal_quantile(p);
+        const long double q = (p > 0.5) ? 1.0L - p : p, Z = (p > 0.5) ? -z : z;
+        const long double pdf = expl(-Z * Z / 2) / sqrtl(2 * M_PIl);
+        quantile = std::max(quantile, double(fabsl((0.5L * erfcl(-Z / sqrtl(2.0L)) - q) / pdf)
+                                             / std::max(1.0L, fabsl(Z))));
+    }
+    std::cout << "normal_quantile\t\t" << quantile << " (in z, relative to max(1, |z|))" << std::endl;
+    std::cout << "normal_quantile(0.975) = " << std::setprecision(17) << special::normal_quantile(0.975)
+              << " (1.959963984540054)" << std::endl;
+
+    // CDFs that used to be wrong or slow against closed forms
+    double maxwell = 0, poisson = 0, binomial = 0;
+    Maxwell m = Maxwell(2);
+    for (double t = 0.05; t < 20; t += 0.05)
+    {
+        const long double y = t / 2.0L / sqrtl(2.0L);
+        maxwell = std::max(maxwell, relative(erfl(y) - sqrtl(2 / M_PIl) * (t / 2.0L) * expl(-y * y), m.cdf(t)));
+    }
+    Poisson po = Poisson(20);
+    long double term = expl(-20.0L), sum = term;
+    for (int k = 0; k < 60; term *= 20.0L / ++k, sum += term)
+        poisson = std::max(poisson, relative(sum, po.cdf(k)));
+    Binomial bi = Binomial(200, 0.3);
+    sum = 0;
+    for (int k = 0; k < 120; k++)
+    {
+        sum += expl(lgammal(201) - lgammal(k + 1) - lgammal(201 - k) + k * logl(0.3L) + (200 - k) * logl(0.7L));
+        binomial = std::max(binomial, relative(sum, bi.cdf(k)));
+    }
+    std::cout << std::setprecision(3) << "Maxwell(2).cdf " << maxwell << ", Poisson(20).cdf " << poisson
+              << ", Binomial(200, 0.3).cdf " << binomial << std::endl;
+    std::cout << "Poisson(1e4).cdf(10000) = " << std::setprecision(17) << Poisson(1e4).cdf(10000)
+              << " (0.5026595812190073)" << std::endl;
+    std::cout << "gamma_q(0.5, 2) = " << special::gamma_q(0.5, 2) << " (" << std::erfc(std::sqrt(2.0)) << ")"
+              << std::endl;
+
+    double s = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < N; i++)
+        s += std::erfc(x[i]);
+    std::chrono::duration<double, std::milli> t = std::chrono::high_resolution_clock::now() - start;
+    std::cout << std::setprecision(4) << "std::erfc: " << t.count() << "ms" << std::endl;
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < N; i++)
+        s += special::erfc(x[i]);
+    t = std::chrono::high_resolution_clock::now() - start;
+    std::cout << "special::erfc: " << t.count() << "ms" << std::endl;
+    std::sort(x.begin(), x.end());
+    start = std::chrono::high_resolution_clock::now();
+    special::erfc(x.data(), out.data(), N);
+    t = std::chrono::high_resolution_clock::now() - start;
+    std::cout << "special::erfc batch (sorted): " << t.count() << "ms" << std::endl;
+    for (size_t i = 0; i < N; i++)
+        x[i] = rng.next_unit();
+    start = std::chrono::high_resolution_clock::now();
+    special::normal_quantile(x.data(), out.data(), N);
+    t = std::chrono::high_resolution_clock::now() - start;
+    std::cout << "special::normal_quantile batch: " << t.count() << "ms (" << s + out[0] << ")" << std::endl;
+    return 0;
+}
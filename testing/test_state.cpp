@@ -0,0 +1,180 @@
+#include "diceforge.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <vector>
+
+// Checks save_state and load_state: that every RNG restored into another object (through a buffer and through a
+// stream) continues the sequence it was saved in, that states of another RNG or damaged ones are refused with the
+// object unchanged, that a buffered generator and the stateful distributions carry on alike, and times the
+// checkpoints
+
+using namespace DiceForge;
+
+// Saves the RNG after a few draws, then restores it into a copy seeded differently and compares the next outputs;
+// prints the size of the state and the time of a save and of a load
+template <typename Engine>
+void round_trip(const char* name, Engine a, Engine b)
+{
+    typedef typename Engine::result_type T;
+    for (int i = 0; i < 1001; i++)
+        a.next();
+    const std::vector<unsigned char> state = a.save_state();
+    std::stringstream file;
+    a.save_state(file);
+    std::vector<T> expected(5000);
+    a.fill(expected.data(), expected.size());
+
+    b.load_state(state);
+    size_t differ = 0;
+    for (T x : expected)
+        differ += (b.next() != x);
+    b.load_state(file);
+    for (T x : expected)
+        differ += (b.next() != x);
+
+    const int reps = 1000;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < reps; i++)
+        a.save_state();
+    std::chrono::duration<double, std::micro> ts = std::chrono::high_resolution_clock::now() - start;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < reps; i++)
+        b.load_state(state);
+    std::chrono::duration<double, std::micro> tl = std::chrono::high_resolution_clock::now() - start;
+    std::cout << std::setw(26) << std::left << name << state.size() << " bytes\t" << differ << " of "
+              << 2 * expected.size() << "\t" << std::setprecision(3) << ts.count() / reps << "us\t"
+              << tl.count() / reps << "us" << std::endl;
+}
+
+// Whether loading the bytes into the RNG is refused with std::invalid_argument
+template <typename Engine>
+bool refused(Engine& rng, const std::vector<unsigned char>& state)
+{
+    try
+    {
+        rng.load_state(state);
+    }
+    catch (const std::invalid_argument&)
+    {
+        return true;
+    }
+    return false;
+}
+
+int main(int argc, char const *argv[])
+{
+    std::cout << "engine\t\t\tstate\t\tdiffering\tsave\tload" << std::endl;
+    round_trip<XORShift32>("XORShift32", XORShift32(1), XORShift32(2));
+    round_trip<XORShift64>("XORShift64", XORShift64(1), XORShift64(2));
+    round_trip<XORShift64x4>("XORShift64x4", XORShift64x4(1), XORShift64x4(2));
+    round_trip<XORShift32x8>("XORShift32x8", XORShift32x8(1), XORShift32x8(2));
+    round_trip<LFSR64>("LFSR64", LFSR64(1), LFSR64(2));
+    round_trip<LFSR32>("LFSR32", LFSR32(1), LFSR32(2));
+    round_trip<MT32>("MT32", MT32(1), MT32(2));
+    round_trip<MT64>("MT64", MT64(1), MT64(2));
+    round_trip<Philox32>("Philox32", Philox32(1, 3), Philox32(2));
+    round_trip<Philox64>("Philox64", Philox64(1, 3), Philox64(2));
+    round_trip<NaorReingold>("NaorReingold", NaorReingold(1), NaorReingold(2));
+    round_trip<BlumBlumShub32>("BlumBlumShub32", BlumBlumShub32(1), BlumBlumShub32(2));
+    round_trip<BlumBlumShub64>("BlumBlumShub64", BlumBlumShub64(1), BlumBlumShub64(2));
+    round_trip<BlumBlumShubMontgomery64>("BlumBlumShubMontgomery64", BlumBlumShubMontgomery64(1, 12),
+                                         BlumBlumShubMontgomery64(2));
+    round_trip<Halton>("Halton(5)", Halton(5, 1), Halton(5, 2));
+    round_trip<Sobol>("Sobol(7)", Sobol(7, 1), Sobol(7));
+
+    // States of another RNG, of another size or damaged
+    MT64 mt(7);
+    MT32 mt32(7);
+    Sobol sobol(8);
+    std::vector<unsigned char> state = mt.save_state(), truncated(state.begin(), state.end() - 1), bad = state;
+    bad[0] = 'X';
+    std::cout << "refused: MT64 into MT32 " << refused(mt32, state) << ", Sobol(7) into Sobol(8) "
+              << refused(sobol, Sobol(7).save_state()) << ", truncated " << refused(mt, truncated) << ", bad magic "
+              << refused(mt, bad) << std::endl;
+    std::cout << "MT64 unchanged after refusals: " << (mt.save_state() == state) << std::endl;
+
+    // A stream whose header claims a payload of nearly 4 GiB, followed by a few bytes: refused as truncated, having
+    // allocated no more than a chunk
+    {
+        std::vector<unsigned char> huge = state;
+        huge[5] = huge[6] = huge[7] = huge[8] = 0xff;
+        std::stringstream file(std::string(huge.begin(), huge.begin() + 64));
+        bool thrown = false;
+        try { mt.load_state(file); } catch (const std::invalid_argument&) { thrown = true; }
+        std::cout << "stream claiming 4 GiB refused: " << thrown << ", MT64 unchanged " << (mt.save_state() == state)
+                  << std::endl;
+    }
+
+    // A payload with a byte too many is read in full before it is refused, the objects keeping their state
+    {
+        auto longer = [](std::vector<unsigned char> s) {
+            s.push_back(0);
+            s[5]++;
+            return s;
+        };
+        XORShift64x4 lanes(1), other(2);
+        lanes.next();
+        Gaussian g(1, 2), h;
+        const std::vector<unsigned char> s = other.save_state(), kept = lanes.save_state(), gs = h.save_state();
+        std::cout << "refused with a byte too many: XORShift64x4 " << refused(lanes, longer(s)) << ", unchanged "
+                  << (lanes.save_state() == kept);
+        try { h.load_state(longer(g.save_state())); } catch (const std::invalid_argument&) {}
+        std::cout << ", Gaussian unchanged " << (h.save_state() == gs) << std::endl;
+    }
+
+    // A buffered generator carries the integers of its ring along with the state of its engine
+    {
+        BufferedGenerator<BlumBlumShubMontgomery64> a(BlumBlumShubMontgomery64(5), 1 << 14);
+        for (int i = 0; i < 10000; i++)
+            a.next();
+        const std::vector<unsigned char> s = a.save_state();
+        std::vector<unsigned long long> expected(50000);
+        for (unsigned long long& x : expected)
+            x = a.next();
+        BufferedGenerator<BlumBlumShubMontgomery64> b(BlumBlumShubMontgomery64(6), 1 << 14);
+        BufferedGenerator<BlumBlumShubMontgomery64> c(BlumBlumShubMontgomery64(6), 1 << 14, false);
+        b.load_state(s);
+        c.load_state(s);
+        size_t differ = 0;
+        for (unsigned long long x : expected)
+        {
+            differ += (b.next() != x);
+            differ += (c.next() != x);
+        }
+        BufferedGenerator<BlumBlumShubMontgomery64> small(BlumBlumShubMontgomery64(6), 16);
+        std::cout << "BufferedGenerator: " << s.size() << " bytes, " << differ << " of " << 2 * expected.size()
+                  << " differing, refused by a smaller ring " << refused(small, s) << std::endl;
+    }
+
+    // Distributions: the value cached by next_cached, and the statistics of an accumulator
+    {
+        XORShift rng(3);
+        Gaussian g(1, 2);
+        g.next_cached(rng);
+        const std::vector<unsigned char> s = g.save_state();
+        const std::vector<unsigned char> r = rng.save_state();
+        const double x = g.next_cached(rng), y = g.next_cached(rng);
+        Gaussian h;
+        h.load_state(s);
+        rng.load_state(r);
+        std::cout << "Gaussian next_cached continues: " << (h.next_cached(rng) == x && h.next_cached(rng) == y)
+                  << ", parameters " << h.get_mu() << " " << h.get_sigma() << std::endl;
+
+        std::vector<double> sample(100000);
+        g.sample(rng, sample.data(), sample.size());
+        GaussianAccumulator all, first;
+        all.add(sample.data(), sample.size());
+        first.add(sample.data(), sample.size() / 2);
+        std::stringstream file;
+        first.save_state(file);
+        GaussianAccumulator resumed;
+        resumed.load_state(file);
+        resumed.add(sample.data() + sample.size() / 2, sample.size() - sample.size() / 2);
+        std::cout << "GaussianAccumulator resumed: " << resumed.count() << " samples, mu "
+                  << resumed.fit().get_mu() - all.fit().get_mu() << " sigma "
+                  << resumed.fit().get_sigma() - all.fit().get_sigma() << " from the uninterrupted fit" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include "diceforge.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+
+// Checks the streaming statistics: Moments against a two-pass computation over a stored sample, the parallel
+// accumulation against the same pool on one thread (it should not depend on the number of threads), then validates
+// the unit reals of every engine and the samples of the distributions with the moments, chi-square and
+// Kolmogorov-Smirnov tests, in constant memory (NaorReingold fails them, its reals never exceeding 0.9966)
+//     test_statistics [count]     (1e8 values per engine by default; 1e10 takes a few minutes per engine)
+
+using namespace DiceForge;
+
+// Mean, variance, the two tests of the unit reals of an engine at n values, with the time taken
+template <typename Engine>
+void check_engine(const char* name, const Engine& engine, unsigned long long n)
+{
+    GeneratorPool<Engine> pool(engine, 16);
+    auto start = std::chrono::high_resolution_clock::now();
+    SampleSummary s = parallel_summary(pool, n, 1000);
+    std::chrono::duration<double> t = std::chrono::high_resolution_clock::now() - start;
+    const TestResult mean = s.moments.mean_test(0.5, 1.0 / 12), chi = s.histogram.chi_square(),
+                     ks = s.histogram.kolmogorov_smirnov();
+    std::cout << std::setw(26) << std::left << name << std::setw(12) << double(n) << std::setprecision(4)
+              << std::setw(10) << mean.statistic << std::setw(12) << s.moments.variance() * 12 - 1 << std::setw(12)
+              << s.moments.min() << std::setw(12) << 1 - s.moments.max() << std::setw(10) << chi.p_value
+              << std::setw(10) << ks.p_value << t.count() << "s" << std::endl;
+}
+
+// The same for a distribution, the histogram spanning its central 1 - 2e-6 (integers one per bin)
+template <typename Distribution>
+void check_distribution(const char* name, Distribution& d, unsigned long long n)
+{
+    GeneratorPool<XORShift64> pool(XORShift64(7), 16);
+    const bool discrete = std::is_base_of<Discrete, Distribution>::value;
+    real_t lo = d.quantile(1e-6), hi = d.quantile(1 - 1e-6);
+    size_t bins = 1000;
+    if (discrete)
+    {
+        hi += 1;
+        bins = size_t(hi - lo);
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    SampleSummary s = parallel_summary(pool, d, n, lo, hi, bins);
+    std::chrono::duration<double> t = std::chrono::high_resolution_clock::now() - start;
+    const TestResult mean = s.moments.mean_test(d.expectation(), d.variance()), chi = s.histogram.chi_square(d),
+                     ks = s.histogram.kolmogorov_smirnov(d);
+    std::cout << std::setw(26) << std::left << name << std::setw(12) << double(n) << std::setprecision(4)
+              << std::setw(10) << mean.statistic << std::setw(12) << s.moments.variance() / d.variance() - 1
+              << std::setw(12) << s.moments.skewness() << std::setw(12) << s.moments.kurtosis() << std::setw(10)
+              << chi.p_value << std::setw(10) << ks.p_value << t.count() << "s" << std::endl;
+}
+
+int main(int argc, char const *argv[])
+{
+    const unsigned long long N = (argc > 1) ? std::strtoull(argv[1], nullptr, 0) : 100000000ULL;
+
+    // Against two passes over a stored sample, with an offset that ruins the naive sum of squares
+    {
+        std::vector<double> x(3000007);
+        MT64 rng(1);
+        rng.fill_unit(x.data(), x.size());
+        for (double& v : x)
+            v = 1e9 + v;
+        Moments all, half, rest;
+        all.add(x.data(), x.size());
+        half.add(x.data(), x.size() / 2);
+        for (size_t i = x.size() / 2; i < x.size(); i++)
+            rest.add(x[i]);
+        half.merge(rest);
+        double mean = 0, m2 = 0, m3 = 0, m4 = 0;
+        for (double v : x)
+            mean += v - 1e9;
+        mean = mean / x.size() + 1e9;
+        for (double v : x)
+        {
+            const double d = v - mean;
+            m2 += d * d;
+            m3 += d * d * d;
+            m4 += d * d * d * d;
+        }
+        const double n = double(x.size()), variance = m2 / (n - 1), skewness = std::sqrt(n) * m3 / std::pow(m2, 1.5),
+                     kurtosis = n * m4 / (m2 * m2) - 3;
+        std::cout << std::setprecision(3) << "against two passes: variance " << all.variance() / variance - 1
+                  << ", skewness " << all.skewness() - skewness << ", kurtosis " << all.kurtosis() - kurtosis
+                  << ", merged halves " << half.variance() / variance - 1 << std::endl;
+    }
+
+    // The same statistics on any number of threads
+    {
+        GeneratorPool<MT64> reference(MT64(3), 16);
+        SampleSummary serial = parallel_summary(reference, 10000000, 1000, 1);
+        size_t differences = 0;
+        for (int threads : {2, 3, 8})
+        {
+            GeneratorPool<MT64> pool(MT64(3), 16);
+            SampleSummary parallel = parallel_summary(pool, 10000000, 1000, threads);
+            differences += (parallel.moments.save_state() != serial.moments.save_state());
+            differences += (parallel.histogram.save_state() != serial.histogram.save_state());
+        }
+        std::cout << "2, 3 and 8 threads against 1: " << differences << " differences" << std::endl;
+    }
+
+    // Every engine: z of the mean, relative error of the variance, distance of the extremes from 0 and 1, and the
+    // p values of the chi-square test (1000 bins) and the Kolmogorov-Smirnov test
+    std::cout << "engine\t\t\t  count       z mean    variance    min         1 - max     chi2 p    KS p" << std::endl;
+    check_engine("XORShift32", XORShift32(1), N);
+    check_engine("XORShift64", XORShift64(1), N);
+    check_engine("XORShift64x4", XORShift64x4(1), N);
+    check_engine("XORShift32x8", XORShift32x8(1), N);
+    check_engine("LFSR32", LFSR32(1), N);
+    check_engine("LFSR64", LFSR64(1), N);
+    check_engine("MT64", MT64(1), N);
+    check_engine("Philox32", Philox32(1), N);
+    check_engine("Philox64", Philox64(1), N);
+    check_engine("NaorReingold", NaorReingold(1), N);
+    check_engine("BlumBlumShubMontgomery64", BlumBlumShubMontgomery64(1), N / 100);
+
+    // Distributions: z of the mean, relative error of the variance, skewness, excess kurtosis and the p values
+    std::cout << "distribution\t\t  count       z mean    variance    skewness    kurtosis    chi2 p    KS p"
+              << std::endl;
+    Gaussian gaussian(1, 2);
+    Exponential exponential(1.5);
+    Weibull weibull(1, 1.5);
+    Maxwell maxwell(2);
+    Poisson poisson(4), poisson_large(1000);
+    Binomial binomial(20, 0.3);
+    Geometric geometric(0.2);
+    check_distribution("Gaussian(1, 2)", gaussian, N);
+    check_distribution("Exponential(1.5)", exponential, N);
+    check_distribution("Weibull(1, 1.5)", weibull, N);
+    check_distribution("Maxwell(2)", maxwell, N);
+    check_distribution("Poisson(4)", poisson, N);
+    check_distribution("Poisson(1000)", poisson_large, N);
+    check_distribution("Binomial(20, 0.3)", binomial, N);
+    check_distribution("Geometric(0.2)", geometric, N);
+    return 0;
+}
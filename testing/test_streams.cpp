@@ -0,0 +1,133 @@
+#include "diceforge.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <thread>
+#include <unordered_set>
+
+// Checks the stream plans: the engines of a plan restored with load_state against those of the original; the
+// jumped streams against the base stream at the same offsets, and the Philox streams of a job for repeated
+// outputs; the aggregate of a Monte Carlo run over 256 shards run on 8 and on 64 simulated nodes of 4 threads;
+// keys out of range; then times the creation of the engines of a stream
+
+using namespace DiceForge;
+
+// The number of hits in the quarter disc of draws points of the stream
+double shard_result(const StreamPlan& plan, DiceForge::uint64_t shard, size_t draws)
+{
+    Philox rng = plan.engine<Philox>(StreamKey{7, shard, 0, 0});
+    double hits = 0;
+    for (size_t i = 0; i < draws; i++) {
+        const double x = rng.next_unit(), y = rng.next_unit();
+        hits += (x * x + y * y < 1);
+    }
+    return hits;
+}
+
+// The estimate of pi of a run of the plan spread over the given number of nodes, each running its shards on
+// threads: every machine would compute its own range, the results being gathered in the order of the shards
+double run(const StreamPlan& plan, DiceForge::uint64_t count, DiceForge::uint64_t nodes, size_t draws)
+{
+    std::vector<double> results(count);
+    for (DiceForge::uint64_t node = 0; node < nodes; node++) {
+        const std::pair<DiceForge::uint64_t, DiceForge::uint64_t> mine = StreamPlan::shards(count, node, nodes);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++)
+            threads.emplace_back([&, t]() {
+                const std::pair<DiceForge::uint64_t, DiceForge::uint64_t> part = StreamPlan::shards(mine.second - mine.first, t, 4);
+                for (DiceForge::uint64_t s = mine.first + part.first; s < mine.first + part.second; s++)
+                    results[s] = shard_result(plan, s, draws);
+            });
+        for (auto& thread : threads)
+            thread.join();
+    }
+    double sum = 0;
+    for (double r : results)
+        sum += r / draws;
+    return 4 * sum / count;
+}
+
+int main(int argc, char const *argv[])
+{
+    StreamPlan plan(20240601, 12, 4, 4);
+
+    // A plan restored elsewhere gives the same engines
+    {
+        StreamPlan restored(0);
+        restored.load_state(plan.save_state());
+        const StreamKey key{3, 100, 2, 1};
+        MT64 a = plan.engine<MT64>(key), b = restored.engine<MT64>(key);
+        XORShift64 c = plan.engine<XORShift64>(key), d = restored.engine<XORShift64>(key);
+        Philox e = plan.engine<Philox>(key), f = restored.engine<Philox>(key);
+        size_t differences = 0;
+        for (int i = 0; i < 1000; i++)
+            differences += (a.next() != b.next()) + (c.next() != d.next()) + (e.next() != f.next());
+        std::cout << "restored plan: " << differences << " differences, index " << restored.index(key)
+                  << ", stride 2^" << restored.stride_bits() << std::endl;
+    }
+
+    // The jumped streams start at index * 2^stride_bits of the stream of the job
+    {
+        const StreamKey key{1, 5, 3, 2};
+        XORShift64 stream = plan.engine<XORShift64>(key), base(0);
+        base.reset_seed(plan.job_seed(1));
+        base.jump(plan.index(key) << plan.stride_bits());
+        size_t differences = 0;
+        for (int i = 0; i < 1000; i++)
+            differences += (stream.next() != base.next());
+        std::cout << "XORShift64 stream against the jumped base: " << differences << " differences" << std::endl;
+    }
+
+    // Outputs repeated among 256 Philox streams of a job
+    {
+        std::unordered_set<DiceForge::uint64_t> seen;
+        size_t repeats = 0;
+        for (DiceForge::uint64_t node = 0; node < 16; node++)
+            for (DiceForge::uint64_t thread = 0; thread < 16; thread++) {
+                Philox rng = plan.engine<Philox>(StreamKey{1, node, thread, 0});
+                for (int i = 0; i < 4096; i++)
+                    repeats += !seen.insert(rng.next()).second;
+            }
+        std::cout << "Philox streams: " << repeats << " repeated outputs among " << seen.size() + repeats << std::endl;
+    }
+
+    // The same aggregate on 8 and on 64 nodes
+    {
+        const double on8 = run(plan, 256, 8, 20000), on64 = run(plan, 256, 64, 20000), on1 = run(plan, 256, 1, 20000);
+        std::cout << std::hexfloat << "pi on 8 nodes " << on8 << ", on 64 nodes " << on64 << ", on 1 node " << on1
+                  << std::defaultfloat << ": " << ((on8 == on64 && on8 == on1) ? "same" : "DIFFERENT") << std::endl;
+    }
+
+    // Keys out of range and widths too large
+    try {
+        plan.index(StreamKey{0, 4096, 0, 0});
+        std::cout << "node 4096 in 12 bits: accepted" << std::endl;
+    }
+    catch (const std::out_of_range&) {
+        std::cout << "node 4096 in 12 bits: out_of_range" << std::endl;
+    }
+    try {
+        StreamPlan wide(1, 32, 32, 1);
+        std::cout << "65 bits of key: accepted" << std::endl;
+    }
+    catch (const std::invalid_argument&) {
+        std::cout << "65 bits of key: invalid_argument" << std::endl;
+    }
+
+    // Time to create the engine of a stream
+    {
+        auto time = [&](const char* name, DiceForge::uint64_t count, auto make) {
+            auto start = std::chrono::high_resolution_clock::now();
+            DiceForge::uint64_t s = 0;
+            for (DiceForge::uint64_t k = 0; k < count; k++)
+                s += make(StreamKey{1, k, k % 16, 0});
+            std::chrono::duration<double, std::micro> t = std::chrono::high_resolution_clock::now() - start;
+            std::cout << std::setw(12) << std::left << name << t.count() / count << " us (" << (s & 0xff) << ")" << std::endl;
+        };
+        time("Philox", 1000, [&](const StreamKey& key) { return plan.engine<Philox>(key).next(); });
+        time("XORShift64", 1000, [&](const StreamKey& key) { return plan.engine<XORShift64>(key).next(); });
+        time("MT64", 10, [&](const StreamKey& key) { return plan.engine<MT64>(key).next(); });
+    }
+    return 0;
+}
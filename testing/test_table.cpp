@@ -0,0 +1,112 @@
+#include "diceforge.h"
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <vector>
+#include <optional>
+#include <cstdio>
+#include <cmath>
+
+// Checks the table files of CustomDistribution: a distribution read from the tables saved by another draws the
+// same values and has the same cdf, moments and (interpolated) pdf; corrupted or foreign files are refused, and a
+// damaged entry of the guide table stays within the tables; then times the construction from the pdf against the
+// mapping of the file
+
+using namespace DiceForge;
+
+template <typename F>
+double ms(F f)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> t = std::chrono::high_resolution_clock::now() - start;
+    return t.count();
+}
+
+int main(int argc, char const *argv[])
+{
+    const std::string path = "test_table.dft";
+    auto pdf = [](double x) { return std::exp(-x * x / 2) * (1 + std::sin(3 * x) * std::sin(3 * x)); };
+    const int n = 200000;
+    const size_t N = 1000000;
+
+    // Saved and mapped: the same values, cdf and moments
+    {
+        CustomDistribution built(-6, 6, pdf, n, true);
+        built.save_table(path);
+        CustomDistribution mapped(path), with_pdf(path, pdf);
+
+        XORShift64 rng(11), copy(11);
+        std::vector<double> a(N), b(N);
+        built.sample(rng, a.data(), N);
+        mapped.sample(copy, b.data(), N);
+        std::cout << "samples of the mapped tables: " << (a == b ? "same" : "DIFFERENT") << std::endl;
+
+        size_t differences = (built.expectation() != mapped.expectation()) + (built.variance() != mapped.variance())
+                           + (built.minValue() != mapped.minValue()) + (built.maxValue() != mapped.maxValue());
+        double worst = 0, mass = integrate_adaptive<double>(pdf, -6, 6).value;
+        for (double x = -6; x <= 6; x += 0.001) {
+            differences += (built.cdf(x) != mapped.cdf(x)) + (with_pdf.pdf(x) != built.pdf(x));
+            worst = std::max(worst, std::fabs(mapped.pdf(x) - built.pdf(x) / mass));
+        }
+        std::cout << "cdf, moments and pdf: " << differences << " differences, interpolated pdf within " << worst << std::endl;
+
+        // A copy shares the mapping, and outlives the original
+        std::optional<CustomDistribution> first(std::in_place, path);
+        CustomDistribution second = *first;
+        first.reset();
+        std::cout << "copy after the original is gone: " << (second.next(0.3) == built.next(0.3) ? "same" : "DIFFERENT") << std::endl;
+    }
+
+    // Files that are not tables of a CustomDistribution
+    {
+        size_t thrown = 0;
+        std::ifstream in(path, std::ios::binary);
+        std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        auto write = [&](const std::vector<char>& b) {
+            std::ofstream out("broken.dft", std::ios::binary);
+            out.write(b.data(), b.size());
+        };
+        std::vector<char> truncated(bytes.begin(), bytes.end() - 8);
+        write(truncated);
+        try { CustomDistribution d("broken.dft"); } catch (const std::invalid_argument&) { thrown++; }
+        std::vector<char> version = bytes;
+        version[4] = 99;
+        write(version);
+        try { CustomDistribution d("broken.dft"); } catch (const std::invalid_argument&) { thrown++; }
+        std::vector<char> state;
+        for (unsigned char c : XORShift64(1).save_state())
+            state.push_back(char(c));
+        write(state);
+        try { CustomDistribution d("broken.dft"); } catch (const std::invalid_argument&) { thrown++; }
+        try { CustomDistribution d("no such file.dft"); } catch (const std::runtime_error&) { thrown++; }
+        std::remove("broken.dft");
+        std::cout << thrown << " of 4 invalid files refused" << std::endl;
+
+        // The guide table is the last array of the file: its last entry pointing far past the end, then past the
+        // segment it should give
+        std::vector<char> guide = bytes;
+        for (size_t k = guide.size() - 8; k < guide.size(); k++)
+            guide[k] = char(0xFF);
+        write(guide);
+        size_t refused = 0;
+        try { CustomDistribution d("broken.dft"); } catch (const std::invalid_argument&) { refused++; }
+        guide = bytes;
+        guide[guide.size() - 8 * (n / 2)] = char(0xF0);
+        guide[guide.size() - 8 * (n / 2) + 1] = char(0xFF);
+        write(guide);
+        try { CustomDistribution d("broken.dft"); } catch (const std::invalid_argument&) { refused++; }
+        std::remove("broken.dft");
+        std::cout << refused << " of 2 damaged guide tables refused" << std::endl;
+    }
+
+    // Construction from the pdf against the mapping of its tables
+    {
+        double value = 0;
+        double build = ms([&]() { CustomDistribution d(-6, 6, pdf, n, true); value += d.next(0.5); });
+        double map = ms([&]() { CustomDistribution d(path); value += d.next(0.5); });
+        std::cout << "built from the pdf " << build << " ms, mapped " << map << " ms (" << value << ")" << std::endl;
+    }
+    std::remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,75 @@
+#define DF_IMPLEMENTATION
+#include "diceforge.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <cmath>
+
+// Compiles the whole library into this file through DF_IMPLEMENTATION, without linking it:
+//     g++ -std=c++17 -O2 -I include testing/test_unity.cpp -pthread
+// Prints the first outputs of the engines and distributions, to be compared with those of the same program
+// without the define and linked with the library, checks the batch special functions against the scalar ones,
+// then times the calls that the compiler can now inline across what were separate files
+
+using namespace DiceForge;
+
+template <typename F>
+double ns(F f, size_t n)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    f();
+    std::chrono::duration<double, std::nano> t = std::chrono::high_resolution_clock::now() - start;
+    return t.count() / n;
+}
+
+int main(int argc, char const *argv[])
+{
+    XORShift64 xorshift(1);
+    MT64 mt(1);
+    Philox philox(1);
+    std::cout << std::hex << "XORShift64 " << xorshift.next() << ", MT64 " << mt.next() << ", Philox " << philox.next()
+              << std::dec << std::setprecision(17) << std::endl;
+
+    Gaussian gaussian(0, 1);
+    Exponential exponential(2);
+    Poisson poisson(4.5);
+    std::cout << "Gaussian " << gaussian.next(xorshift) << ", Exponential " << exponential.next(xorshift)
+              << ", Poisson " << poisson.next(xorshift) << std::endl;
+
+    // Batch against scalar special functions
+    {
+        const size_t n = 100000;
+        std::vector<double> p(n), batch(n);
+        for (size_t i = 0; i < n; i++)
+            p[i] = (i + 0.5) / n;
+        special::normal_quantile(p.data(), batch.data(), n);
+        double worst = 0;
+        for (size_t i = 0; i < n; i++)
+            worst = std::fmax(worst, std::fabs(batch[i] - special::normal_quantile(p[i])));
+        std::cout << "normal_quantile batch against scalar: largest difference " << worst << std::endl;
+    }
+
+    // Time per value
+    {
+        const size_t M = 1000000;
+        std::vector<double> x(M);
+        double s = 0;
+        std::cout << std::setprecision(4);
+        std::cout << "Gaussian::sample       " << ns([&]() { for (int k = 0; k < 10; k++) gaussian.sample(xorshift, x.data(), M); }, 10 * M) << " ns" << std::endl;
+        std::cout << "Gaussian::next         " << ns([&]() {
+            for (int k = 0; k < 10; k++)
+                for (size_t i = 0; i < M; i++)
+                    x[i] = gaussian.next(xorshift);
+        }, 10 * M) << " ns" << std::endl;
+        s += x[0];
+        std::cout << "XORShift64::next_unit  " << ns([&]() {
+            for (int k = 0; k < 10; k++)
+                for (size_t i = 0; i < M; i++)
+                    x[i] = xorshift.next_unit();
+        }, 10 * M) << " ns" << std::endl;
+        s += x[0];
+        std::cout << "(" << s << ")" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include "diceforge.h"
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <ranges>
+
+// Checks the lazy views and coroutine streams (C++20): their values against the batch calls on a copy of the same
+// RNG, a pipeline of several stages, and the time per value of a sum through each of them against a loop of next_unit
+//     g++ -std=c++20 -O2 -Iinclude testing/test_views.cpp out/linux/libdiceforge.a
+
+using namespace DiceForge;
+
+template <typename F>
+double ns_per_value(F f, size_t n)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    volatile double sum = f();
+    (void)sum;
+    std::chrono::duration<double, std::nano> t = std::chrono::high_resolution_clock::now() - start;
+    return t.count() / n;
+}
+
+int main(int argc, char const *argv[])
+{
+    const size_t N = 100000;
+
+    // The same values as the batch calls, whatever the block
+    {
+        XORShift64 rng(5), copy(5);
+        std::vector<double> expected(N), got;
+        copy.fill_unit(expected.data(), N);
+        for (double x : views::uniform(rng, 1000) | std::views::take(N))
+            got.push_back(x);
+        std::cout << "views::uniform against fill_unit: " << (got == expected ? "same" : "DIFFERENT") << std::endl;
+
+        Poisson poisson(4.5);
+        std::vector<long long> k(N), from_view(N);
+        copy = rng;
+        poisson.sample(copy, k.data(), N);
+        auto view = views::sample(poisson, rng, 777);
+        std::ranges::copy_n(view.begin(), N, from_view.begin());
+        std::cout << "views::sample against sample: " << (from_view == k ? "same" : "DIFFERENT") << std::endl;
+
+        copy = rng;
+        Stream<double> stream = uniform_stream(rng, 300);
+        copy.fill_unit(expected.data(), N);
+        got.clear();
+        for (double x : std::move(stream) | std::views::take(N))
+            got.push_back(x);
+        std::cout << "uniform_stream against fill_unit: " << (got == expected ? "same" : "DIFFERENT") << std::endl;
+
+        Gaussian gaussian(1, 2);
+        std::vector<double> g(N);
+        copy = rng;
+        gaussian.sample(copy, g.data(), N);
+        Stream<double> normals = sample_stream(gaussian, rng);
+        size_t differences = 0;
+        for (size_t i = 0; i < N; i++)
+            differences += (normals.next() != g[i]);
+        std::cout << "sample_stream against sample: " << differences << " differences" << std::endl;
+    }
+
+    // A pipeline of several stages, chunk by chunk: the mean of the squares of the reals below 1/2, about 1/12
+    {
+        MT64 rng(1);
+        auto squares = views::uniform(rng) | std::views::take(20000000)
+                     | std::views::filter([](double x) { return x < 0.5; })
+                     | std::views::transform([](double x) { return x * x; });
+        double sum = 0;
+        size_t n = 0;
+        for (double x2 : squares) {
+            sum += x2;
+            n++;
+        }
+        std::cout << "mean of the squares below 1/2 (1/12 = 0.08333): " << sum / n << " of " << n << std::endl;
+    }
+
+    // Time per value of a sum of 1e8 reals
+    {
+        const size_t M = 100000000;
+        XORShift64 rng(3);
+        std::cout << "next_unit loop      " << ns_per_value([&]() {
+            double s = 0;
+            for (size_t i = 0; i < M; i++)
+                s += rng.next_unit();
+            return s;
+        }, M) << " ns" << std::endl;
+        std::cout << "views::uniform      " << ns_per_value([&]() {
+            double s = 0;
+            for (double x : views::uniform(rng) | std::views::take(M))
+                s += x;
+            return s;
+        }, M) << " ns" << std::endl;
+        std::cout << "uniform_stream      " << ns_per_value([&]() {
+            double s = 0;
+            for (double x : uniform_stream(rng) | std::views::take(M))
+                s += x;
+            return s;
+        }, M) << " ns" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include "diceforge.h"
+
+// Prints the first four moments of the samples and the time taken to draw them
+template <typename Sample>
+void report(const char* name, Sample sample, size_t N)
+{
+    double m1 = 0, m2 = 0, m3 = 0, m4 = 0;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < N; i++)
+    {
+        double x = sample();
+        m1 += x;
+        m2 += x * x;
+        m3 += x * x * x;
+        m4 += x * x * x * x;
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    std::cout << name << "\t" << std::chrono::duration<double, std::milli>(t1 - t0).count() << "ms"
+              << "\tmoments: " << m1 / N << " " << m2 / N << " " << m3 / N << " " << m4 / N << std::endl;
+}
+
+int main(int argc, char const *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Enter number of samples to be drawn :(" << std::endl;
+        return -1;
+    }
+
+    size_t N = atoll(argv[1]);
+    DiceForge::XORShift64 rng(123);
+    auto fast = DiceForge::make_static(rng);
+    DiceForge::Gaussian gaussian;
+    DiceForge::Exponential exponential(1);
+
+    // Expected moments: 0 1 0 3 for the normal, 1 2 6 24 for the exponential
+    report("Box-Muller", [&]() { return gaussian.next(1.0 - rng.next_unit(), rng.next_unit()); }, N);
+    report("Ziggurat", [&]() { return gaussian.next(fast); }, N);
+    report("Polar", [&]() { return gaussian.next_cached(fast); }, N);
+    report("Inverse", [&]() { return exponential.next(rng.next_unit()); }, N);
+    report("Ziggurat", [&]() { return exponential.next(fast); }, N);
+
+    // Expected moments: 1.596 3 6.383 15 for the Maxwell distribution with a = 1
+    DiceForge::Maxwell maxwell;
+    report("Uniforms", [&]() { return maxwell.next(1.0 - rng.next_unit(), 1.0 - rng.next_unit(), rng.next_unit()); }, N);
+    report("Polar", [&]() { return maxwell.next(fast); }, N);
+
+    // Whole buffers at a time, expected moments as above and 1 2 6 24 for the Weibull distribution with k = 1
+    std::vector<double> buffer(N);
+    auto bulk = [&](const char* name, auto& distribution) {
+        size_t i = N;
+        report(name, [&]() {
+            if (i == N) {
+                distribution.sample(fast, buffer.data(), N);
+                i = 0;
+            }
+            return buffer[i++];
+        }, N);
+    };
+    DiceForge::Weibull weibull(1, 1);
+    bulk("Bulk Gaussian", gaussian);
+    bulk("Bulk Exponential", exponential);
+    bulk("Bulk Maxwell", maxwell);
+    bulk("Bulk Weibull", weibull);
+
+    return 0;
+}
@@ -0,0 +1,107 @@
+# Generates the public headers in include/ from the headers in src/, so that the two cannot drift apart:
+#     cmake -DSOURCES="<the SRC list of CMakeLists.txt>" -DOUTPUT=<directory> -P tools/amalgamate.cmake
+# (the targets headers and check_headers of CMakeLists.txt run it). Each header of a list below is copied
+# whole, in that order, with its includes of other DiceForge headers removed, every one of which comes earlier
+# in the lists. diceforge_implementation.h follows with the headers private to the library and the SOURCES,
+# which DF_IMPLEMENTATION compiles into one translation unit of the code including diceforge.h.
+
+if (NOT DEFINED OUTPUT)
+    set(OUTPUT "${CMAKE_CURRENT_LIST_DIR}/../include")
+endif()
+if (NOT DEFINED SOURCES)
+    message(FATAL_ERROR "Expected -DSOURCES=<the .cpp files of the library>")
+endif()
+get_filename_component(ROOT "${CMAKE_CURRENT_LIST_DIR}/.." ABSOLUTE)
+
+set(CORE
+    "src/Core/types.h"
+    "src/Core/instrument.h"
+    "src/Core/state.h"
+    "src/Core/generator.h"
+    "src/Core/streams.h"
+    "src/Core/table.h"
+    "src/Core/polar.h"
+    "src/Core/ziggurat.h"
+    "src/Core/process.h"
+    "src/Core/geometry.h"
+    "src/Core/special.h"
+    "src/Core/combinatorics.h"
+    "src/Core/quadrature.h"
+    "src/Core/basicfxn.h"
+    "src/Core/distribution.h"
+    "src/Core/pool.h"
+    "src/Core/statistics.h"
+    "src/Core/sampler.h"
+    "src/Core/montecarlo.h"
+    "src/Core/2D.h"
+    "src/Core/views.h"
+    "src/Core/bigint.h")
+
+set(DISTRIBUTIONS
+    "src/Distributions/Continuous/Cauchy/Cauchy.h"
+    "src/Distributions/Continuous/Custom/Custom.h"
+    "src/Distributions/Continuous/Custom/AdaptiveRejection.h"
+    "src/Distributions/Continuous/Exponential/Exponential.h"
+    "src/Distributions/Continuous/Gaussian/Gaussian.h"
+    "src/Distributions/Continuous/Maxwell/Maxwell.h"
+    "src/Distributions/Continuous/MultivariateGaussian/MultivariateGaussian.h"
+    "src/Distributions/Continuous/Weibull/Weibull.h"
+    "src/Distributions/Continuous/Composite/Composite.h"
+    "src/Distributions/Discrete/Bernoulli/Bernoulli.h"
+    "src/Distributions/Discrete/Binomial/Binomial.h"
+    "src/Distributions/Discrete/Gibbs/Gibbs.h"
+    "src/Distributions/Discrete/DynamicDiscrete/DynamicDiscrete.h"
+    "src/Distributions/Discrete/Hypergeometric/Hypergeometric.h"
+    "src/Distributions/Discrete/Negative-Hypergeometric/NegHypergeometric.h"
+    "src/Distributions/Discrete/Poisson/Poisson.h"
+    "src/Distributions/Discrete/Geometric/Geometric.h")
+
+set(GENERATORS
+    "src/Generators/BBS/blumblumshub.h"
+    "src/Generators/LFSR/LFSR.h"
+    "src/Generators/MT/MT.h"
+    "src/Generators/Naor-Reingold/naor_reingold.h"
+    "src/Generators/XORShift/XORShift.h"
+    "src/Generators/Halton/Halton.h"
+    "src/Generators/Sobol/Sobol.h"
+    "src/Generators/Philox/Philox.h"
+    "src/Generators/Buffered/Buffered.h")
+
+# Used by the sources only: the SIMD lanes and their dispatch, the fitters, and the tables of the engines
+set(PRIVATE
+    "src/Core/simd.h"
+    "src/Core/dispatch.h"
+    "src/Core/fitting.h"
+    "src/Generators/MT/MT_jump.h"
+    "src/Generators/MT/MT_simd.h"
+    "src/Generators/Sobol/sobol_directions.h")
+
+set(BANNER "// Generated from src/ by tools/amalgamate.cmake (cmake --build <build> --target headers): edit the\n// sources rather than this file\n")
+
+# Writes the files of the list to header, between its include guard, after the lines of prologue
+function(amalgamate header guard prologue)
+    set(text "${BANNER}\n#ifndef ${guard}\n#define ${guard}\n${prologue}")
+    foreach(file ${ARGN})
+        file(READ "${ROOT}/${file}" body)
+        string(REGEX REPLACE "#include \"[^\"\n]*\"[^\n]*\n" "" body "${body}")
+        string(APPEND text "\n// ${file}\n\n${body}")
+        if (NOT body MATCHES "\n$")
+            string(APPEND text "\n")
+        endif()
+    endforeach()
+    string(APPEND text "\n#endif\n")
+    # Rewritten only when changed, so that the builds depending on the headers are not redone for nothing
+    set(path "${OUTPUT}/${header}")
+    if (EXISTS "${path}")
+        file(READ "${path}" old)
+    endif()
+    if (NOT "${old}" STREQUAL "${text}")
+        file(WRITE "${path}" "${text}")
+    endif()
+endfunction()
+
+file(MAKE_DIRECTORY "${OUTPUT}")
+amalgamate("diceforge_core.h" "DF_CORE_H" "" ${CORE})
+amalgamate("diceforge_distributions.h" "DF_DISTRIBUTIONS_H" "\n#include \"diceforge_core.h\"\n" ${DISTRIBUTIONS})
+amalgamate("diceforge_generators.h" "DF_GENERATORS_H" "\n#include \"diceforge_core.h\"\n" ${GENERATORS})
+amalgamate("diceforge_implementation.h" "DF_IMPLEMENTATION_H" "\n#include \"diceforge_core.h\"\n#include \"diceforge_distributions.h\"\n#include \"diceforge_generators.h\"\n" ${PRIVATE} ${SOURCES})
@@ -0,0 +1,489 @@
+#include "diceforge.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <type_traits>
+
+// diceforge_bench - Benchmarks of the engines, the distributions, the samplers, the fitters and the integrators, e.g.
+//     diceforge_bench --reps 9 --json results.json
+//     diceforge_bench --filter Gaussian
+// Every case runs once to warm up, then --reps times; the table gives the median time per item (a random integer,
+// a value, an element shuffled, a sample fitted or an evaluation of the integrand) with the spread of the
+// repetitions, and the throughput in GB/s for the cases that write buffers. The results are kept alive (see keep)
+// so that the compiler cannot drop the work, and the std:: engines and distributions are timed alongside as a
+// reference. Build it in Release mode for meaningful numbers.
+
+using namespace DiceForge;
+
+namespace
+{
+    struct options
+    {
+        int reps = 7;
+        double scale = 1;       // multiplies the number of items of every case
+        std::string filter;     // only the cases whose name contains it
+        std::string json;       // file the results are written to
+    };
+    options opt;
+
+    struct result
+    {
+        std::string group, name;
+        size_t items;
+        size_t bytes;           // bytes written per item, 0 when the case does not write a buffer
+        std::vector<double> ns; // time per item of every repetition
+    };
+    std::vector<result> results;
+
+    // Makes the compiler assume that the value is read and that memory may have changed
+    template <typename V>
+    inline void keep(const V& x)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(x) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &x;
+#endif
+    }
+
+    size_t scaled(size_t n)
+    {
+        return std::max<size_t>(1, size_t(n * opt.scale));
+    }
+
+    // Times body() (which handles items items) opt.reps times after a warm-up, and records the result
+    template <typename F>
+    void run(const std::string& group, const std::string& name, size_t items, size_t bytes, F&& body)
+    {
+        if (!opt.filter.empty() && (group + "/" + name).find(opt.filter) == std::string::npos)
+            return;
+        body();
+        result r{group, name, items, bytes, {}};
+        for (int i = 0; i < opt.reps; i++)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            body();
+            const std::chrono::duration<double, std::nano> t = std::chrono::steady_clock::now() - start;
+            r.ns.push_back(t.count() / items);
+        }
+        std::vector<double> sorted = r.ns;
+        std::sort(sorted.begin(), sorted.end());
+        const double median = sorted[sorted.size() / 2];
+        double mean = 0, variance = 0;
+        for (double x : r.ns)
+            mean += x / r.ns.size();
+        for (double x : r.ns)
+            variance += (x - mean) * (x - mean) / std::max<size_t>(1, r.ns.size() - 1);
+        std::cout << std::setw(12) << std::left << group << std::setw(44) << name << std::right << std::fixed
+                  << std::setprecision(3) << std::setw(10) << median << " ns  +- " << std::setw(6)
+                  << std::sqrt(variance) << "  (min " << sorted.front() << ")";
+        if (bytes > 0)
+            std::cout << "  " << std::setprecision(2) << bytes / median << " GB/s";
+        std::cout << std::endl;
+        results.push_back(r);
+    }
+
+    // Size of the buffers of the bulk cases, small enough to stay in the cache
+    constexpr size_t block = 8192;
+
+    template <typename Engine>
+    void bench_engine(const std::string& name, Engine engine, size_t n)
+    {
+        typedef typename Engine::result_type T;
+        auto rng = make_static(engine);
+        n = scaled(n);
+        std::vector<T> integers(block);
+        std::vector<real_t> reals(block);
+        std::vector<float> floats(block);
+        run("engine", name + "/next", n, 0, [&]() {
+            T x = 0;
+            for (size_t i = 0; i < n; i++)
+                x ^= rng.next();
+            keep(x);
+        });
+        run("engine", name + "/fill", n, sizeof(T), [&]() {
+            for (size_t i = 0; i < n; i += block)
+            {
+                rng.fill(integers.data(), std::min(block, n - i));
+                keep(integers[0]);
+            }
+        });
+        run("engine", name + "/fill_unit", n, sizeof(real_t), [&]() {
+            for (size_t i = 0; i < n; i += block)
+            {
+                rng.fill_unit(reals.data(), std::min(block, n - i));
+                keep(reals[0]);
+            }
+        });
+        run("engine", name + "/fill_unit(float)", n, sizeof(float), [&]() {
+            for (size_t i = 0; i < n; i += block)
+            {
+                rng.fill_unit(floats.data(), std::min(block, n - i));
+                keep(floats[0]);
+            }
+        });
+    }
+
+    // Whether the distribution draws from an RNG itself, rather than from given uniforms
+    template <typename D, typename R, typename = void>
+    struct draws_from : std::false_type {};
+    template <typename D, typename R>
+    struct draws_from<D, R, std::void_t<decltype(std::declval<D&>().next(std::declval<R&>()))>> : std::true_type {};
+
+    template <typename D, typename R, typename = void>
+    struct samples_float : std::false_type {};
+    template <typename D, typename R>
+    struct samples_float<D, R, std::void_t<decltype(std::declval<D&>().sample(std::declval<R&>(),
+                                                                               std::declval<float*>(), size_t(0)))>>
+        : std::true_type {};
+
+    // next(rng) (or next(u) with a uniform u when there is no next(rng)), the bulk sample and the float one
+    template <typename V, typename D>
+    void bench_distribution(const std::string& name, D d, size_t n)
+    {
+        XORShift64 engine(42);
+        auto rng = make_static(engine);
+        typedef decltype(rng) R;
+        n = scaled(n);
+        std::vector<V> out(block);
+        std::vector<float> floats(block);
+        run("dist", name + "/next", n, 0, [&]() {
+            V x = 0;
+            for (size_t i = 0; i < n; i++)
+            {
+                if constexpr (draws_from<D, R>::value)
+                    x += d.next(rng);
+                else
+                    x += d.next(rng.next_unit());
+            }
+            keep(x);
+        });
+        run("dist", name + "/sample", n, sizeof(V), [&]() {
+            for (size_t i = 0; i < n; i += block)
+            {
+                d.sample(rng, out.data(), std::min(block, n - i));
+                keep(out[0]);
+            }
+        });
+        if constexpr (samples_float<D, R>::value)
+            run("dist", name + "/sample(float)", n, sizeof(float), [&]() {
+                for (size_t i = 0; i < n; i += block)
+                {
+                    d.sample(rng, floats.data(), std::min(block, n - i));
+                    keep(floats[0]);
+                }
+            });
+    }
+
+    // A std:: distribution driven by std::mt19937_64, the reference for the DiceForge one
+    template <typename D>
+    void bench_std(const std::string& name, D d, size_t n)
+    {
+        std::mt19937_64 engine(42);
+        n = scaled(n);
+        run("std", name, n, 0, [&]() {
+            typename D::result_type x = 0;
+            for (size_t i = 0; i < n; i++)
+                x += d(engine);
+            keep(x);
+        });
+    }
+
+    void bench_engines()
+    {
+        bench_engine("XORShift32", XORShift32(42), 50000000);
+        bench_engine("XORShift64", XORShift64(42), 50000000);
+        bench_engine("XORShift64x4", XORShift64x4(42), 50000000);
+        bench_engine("XORShift32x8", XORShift32x8(42), 50000000);
+        bench_engine("LFSR32", LFSR32(42), 20000000);
+        bench_engine("LFSR64", LFSR64(42), 20000000);
+        bench_engine("MT32", MT32(42), 50000000);
+        bench_engine("MT64", MT64(42), 50000000);
+        bench_engine("Philox32", Philox32(42), 20000000);
+        bench_engine("Philox64", Philox64(42), 20000000);
+        bench_engine("NaorReingold", NaorReingold(42), 2000000);
+        bench_engine("BlumBlumShub32", BlumBlumShub32(42), 2000000);
+        bench_engine("BlumBlumShub64", BlumBlumShub64(42), 2000000);
+        bench_engine("BlumBlumShubMontgomery64", BlumBlumShubMontgomery64(42), 1000000);
+        bench_engine("Halton(8)", Halton(8, 42), 10000000);
+        bench_engine("Sobol(8)", Sobol(8, 42), 10000000);
+
+        std::mt19937_64 mt(42);
+        const size_t n = scaled(50000000);
+        run("std", "mt19937_64()", n, 0, [&]() {
+            unsigned long long x = 0;
+            for (size_t i = 0; i < n; i++)
+                x ^= mt();
+            keep(x);
+        });
+        std::uniform_real_distribution<double> unit(0, 1);
+        run("std", "uniform_real_distribution", n, 0, [&]() {
+            double x = 0;
+            for (size_t i = 0; i < n; i++)
+                x += unit(mt);
+            keep(x);
+        });
+    }
+
+    void bench_distributions()
+    {
+        const size_t n = 10000000;
+        bench_distribution<real_t>("Gaussian", Gaussian(0, 1), n);
+        bench_distribution<real_t>("Exponential", Exponential(1), n);
+        bench_distribution<real_t>("Weibull", Weibull(2, 1.5), n);
+        bench_distribution<real_t>("Maxwell", Maxwell(1), n);
+        bench_distribution<real_t>("Cauchy", Cauchy(0, 1), n);
+        bench_distribution<real_t>("Custom", CustomDistribution(0, 3, [](real_t x) { return x * x; }), n / 10);
+        bench_distribution<int_t>("Bernoulli", Bernoulli(0.3), n);
+        bench_distribution<int_t>("Binomial(20)", Binomial(20, 0.3), n);
+        bench_distribution<int_t>("Binomial(1000)", Binomial(1000, 0.3), n);
+        bench_distribution<int_t>("Geometric", Geometric(0.2), n);
+        bench_distribution<int_t>("Poisson(4)", Poisson(4), n);
+        bench_distribution<int_t>("Poisson(1000)", Poisson(1000), n);
+        bench_distribution<int_t>("Hypergeometric", Hypergeometric(500, 50, 100), n);
+        bench_distribution<int_t>("NegHypergeometric", NegHypergeometric(500, 50, 10), n);
+        std::vector<int_t> xs(100);
+        std::vector<real_t> energy(100);
+        for (size_t i = 0; i < xs.size(); i++)
+            xs[i] = int_t(i), energy[i] = 0.01 * real_t(i * i % 37);
+        bench_distribution<int_t>("Gibbs(100)", Gibbs(xs.begin(), xs.end(), energy.begin(), energy.end(), 1.0), n);
+
+        {
+            const size_t d = 50, vectors = scaled(200000);
+            std::vector<real_t> cov(d * d);
+            for (size_t i = 0; i < d; i++)
+                for (size_t j = 0; j < d; j++)
+                    cov[i * d + j] = 0.25 + ((i == j) ? 1 : 0);
+            MultivariateGaussian mvn(std::vector<real_t>(d, 0.0), cov);
+            XORShift64 engine(42);
+            auto rng = make_static(engine);
+            std::vector<real_t> out(d * 256);
+            run("dist", "MultivariateGaussian(50)/sample", vectors, d * sizeof(real_t), [&]() {
+                for (size_t i = 0; i < vectors; i += 256)
+                {
+                    mvn.sample(rng, out.data(), std::min<size_t>(256, vectors - i));
+                    keep(out[0]);
+                }
+            });
+        }
+
+        bench_std("normal_distribution", std::normal_distribution<double>(0, 1), n);
+        bench_std("exponential_distribution", std::exponential_distribution<double>(1), n);
+        bench_std("weibull_distribution", std::weibull_distribution<double>(1.5, 2), n);
+        bench_std("cauchy_distribution", std::cauchy_distribution<double>(0, 1), n);
+        bench_std("bernoulli_distribution", std::bernoulli_distribution(0.3), n);
+        bench_std("binomial_distribution(20)", std::binomial_distribution<long long>(20, 0.3), n);
+        bench_std("binomial_distribution(1000)", std::binomial_distribution<long long>(1000, 0.3), n);
+        bench_std("geometric_distribution", std::geometric_distribution<long long>(0.2), n);
+        bench_std("poisson_distribution(4)", std::poisson_distribution<long long>(4), n);
+        bench_std("poisson_distribution(1000)", std::poisson_distribution<long long>(1000), n);
+    }
+
+    void bench_sequences()
+    {
+        XORShift64 engine(42);
+        auto rng = make_static(engine);
+        std::mt19937_64 mt(42);
+
+        for (size_t k : {16, 1000, 100000})
+        {
+            std::vector<real_t> weights(k);
+            for (size_t i = 0; i < k; i++)
+                weights[i] = 1 + real_t(i % 17);
+            WeightedSampler sampler(weights);
+            const size_t n = scaled(10000000);
+            std::vector<size_t> out(block);
+            run("sampler", "WeightedSampler(" + std::to_string(k) + ")/sample", n, sizeof(size_t), [&]() {
+                for (size_t i = 0; i < n; i += block)
+                {
+                    sampler.sample(rng, out.data(), std::min(block, n - i));
+                    keep(out[0]);
+                }
+            });
+            std::discrete_distribution<size_t> reference(weights.begin(), weights.end());
+            bench_std("discrete_distribution(" + std::to_string(k) + ")", reference, n);
+            // The weighted choice() goes through the weights on every call
+            std::vector<size_t> indices(k);
+            std::iota(indices.begin(), indices.end(), size_t(0));
+            const size_t m = scaled(k <= 1000 ? 1000000 : 1000);
+            run("sampler", "choice(" + std::to_string(k) + " weights)", m, 0, [&]() {
+                size_t x = 0;
+                for (size_t i = 0; i < m; i++)
+                    x += rng.choice(indices.begin(), indices.end(), weights.begin(), weights.end());
+                keep(x);
+            });
+        }
+
+        std::vector<int> seq(1000);
+        std::iota(seq.begin(), seq.end(), 0);
+        const size_t n = scaled(10000000);
+        run("sampler", "choice(1000)", n, 0, [&]() {
+            long long x = 0;
+            for (size_t i = 0; i < n; i++)
+                x += rng.choice(seq.begin(), seq.end());
+            keep(x);
+        });
+
+        for (size_t size : {1000, 1000000, 10000000})
+        {
+            std::vector<unsigned> v(scaled(size));
+            std::iota(v.begin(), v.end(), 0u);
+            run("shuffle", "shuffle(" + std::to_string(v.size()) + ")", v.size(), 0, [&]() {
+                rng.shuffle(v.begin(), v.end());
+                keep(v[0]);
+            });
+            run("std", "std::shuffle(" + std::to_string(v.size()) + ")", v.size(), 0, [&]() {
+                std::shuffle(v.begin(), v.end(), mt);
+                keep(v[0]);
+            });
+        }
+        {
+            std::vector<unsigned> v(scaled(1000000)), out(1000);
+            std::iota(v.begin(), v.end(), 0u);
+            const size_t reps = 1000;
+            run("shuffle", "sample(1000 of " + std::to_string(v.size()) + ")", reps * out.size(), 0, [&]() {
+                for (size_t r = 0; r < reps; r++)
+                {
+                    rng.sample(v.begin(), v.end(), out.begin(), out.size());
+                    keep(out[0]);
+                }
+            });
+        }
+    }
+
+    // Histogram of a sample as (center, density) points, for the curve fitters
+    void histogram(const std::vector<real_t>& s, real_t lo, real_t hi, size_t bins, std::vector<real_t>& x,
+                   std::vector<real_t>& y)
+    {
+        x.assign(bins, 0);
+        y.assign(bins, 0);
+        const real_t w = (hi - lo) / bins;
+        for (size_t b = 0; b < bins; b++)
+            x[b] = lo + (b + 0.5) * w;
+        for (real_t v : s)
+            if (v >= lo && v < hi)
+                y[size_t((v - lo) / w)] += 1 / (w * s.size());
+    }
+
+    template <typename D, typename FromSamples, typename FromCurve>
+    void bench_fit(const std::string& name, D d, real_t lo, real_t hi, FromSamples from_samples, FromCurve from_curve)
+    {
+        XORShift64 engine(42);
+        auto rng = make_static(engine);
+        std::vector<real_t> s(scaled(1000000)), x, y;
+        d.sample(rng, s.data(), s.size());
+        histogram(s, lo, hi, 200, x, y);
+        run("fit", name + "FromSamples", s.size(), 0, [&]() { keep(from_samples(s)); });
+        run("fit", "fitTo" + name, x.size(), 0, [&]() { keep(from_curve(x, y)); });
+    }
+
+    void bench_fitting()
+    {
+        typedef const std::vector<real_t>& data;
+        bench_fit("Gaussian", Gaussian(1, 2), -7, 9, [](data s) { return fitGaussianFromSamples(s).get_mu(); },
+                  [](data x, data y) { return fitToGaussian(x, y).get_mu(); });
+        bench_fit("Exponential", Exponential(1.5), 0, 5, [](data s) { return fitExponentialFromSamples(s).get_k(); },
+                  [](data x, data y) { return fitToExponential(x, y).get_k(); });
+        bench_fit("Maxwell", Maxwell(1), 0, 5, [](data s) { return fitMaxwellFromSamples(s).get_a(); },
+                  [](data x, data y) { return fitToMaxwell(x, y, 10000, 1e-6).get_a(); });
+        bench_fit("Weibull", Weibull(2, 1.5), 0, 8, [](data s) { return fitWeibullFromSamples(s).get_k(); },
+                  [](data x, data y) { return fitToWeibull(x, y, 10000, 1e-6).get_k(); });
+        bench_fit("Cauchy", Cauchy(0, 1), -20, 20, [](data s) { return fitCauchyFromSamples(s).get_gamma(); },
+                  [](data x, data y) { return fitToCauchy(x, y).get_gamma(); });
+    }
+
+    void bench_integration()
+    {
+        // The evaluations are counted by hand, so the time is per evaluation of the integrand
+        size_t evaluations = 0;
+        auto f = [&](real_t x) { evaluations++; return std::exp(-x * x) * std::cos(3 * x); };
+        integrate_adaptive(f, 0.0, 10.0);
+        const size_t n1 = std::max<size_t>(1, evaluations);
+        run("integrate", "integrate_adaptive", n1, 0, [&]() { keep(integrate_adaptive(f, 0.0, 10.0).value); });
+
+        XORShift64 rng(42);
+        const std::vector<std::pair<real_t, real_t>> cube(4, std::make_pair(0.0, 1.0));
+        const size_t n = scaled(4000000);
+        auto g = [](const real_t* x) { return std::exp(-(x[0] + x[1] + x[2] + x[3])); };
+        run("integrate", "monte_carlo_integrate(4d)", n, 0, [&]() {
+            keep(monte_carlo_integrate(g, cube, n, rng).value);
+        });
+
+#if (__cplusplus >= 202002L)
+        evaluations = 0;
+        auto h = [&](real_t x, real_t y) { evaluations++; return std::sin(x) * std::cos(y * y); };
+        const real_t pi = std::acos(-1.0);
+        auto bounds = std::tuple<real_t, real_t>{0.0, pi / 2};
+        integrate(h, bounds, bounds, dy_dx);
+        const size_t n2 = std::max<size_t>(1, evaluations);
+        run("integrate", "integrate(2D)", n2, 0, [&]() { keep(integrate(h, bounds, bounds, dy_dx)); });
+        run("integrate", "integrate(2D, parallel)", n2, 0, [&]() {
+            keep(integrate([](real_t x, real_t y) { return std::sin(x) * std::cos(y * y); }, bounds, bounds, dy_dx,
+                           parallel));
+        });
+#endif
+    }
+
+    void write_json(const std::string& path)
+    {
+        std::ofstream out(path);
+        out << "{\n  \"repetitions\": " << opt.reps << ",\n  \"scale\": " << opt.scale << ",\n";
+#if defined(__VERSION__)
+        out << "  \"compiler\": \"" << __VERSION__ << "\",\n";
+#endif
+        out << "  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const result& r = results[i];
+            std::vector<double> sorted = r.ns;
+            std::sort(sorted.begin(), sorted.end());
+            const double median = sorted[sorted.size() / 2];
+            out << "    {\"group\": \"" << r.group << "\", \"name\": \"" << r.name << "\", \"items\": " << r.items
+                << ", \"median_ns\": " << median << ", \"min_ns\": " << sorted.front() << ", \"max_ns\": "
+                << sorted.back() << ", \"gbps\": " << (r.bytes > 0 ? r.bytes / median : 0.0) << ", \"ns\": [";
+            for (size_t j = 0; j < r.ns.size(); j++)
+                out << (j ? ", " : "") << r.ns[j];
+            out << "]}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+}
+
+int main(int argc, char const *argv[])
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string a = argv[i];
+        if (a == "--reps" && i + 1 < argc)
+            opt.reps = std::max(1, std::atoi(argv[++i]));
+        else if (a == "--scale" && i + 1 < argc)
+            opt.scale = std::atof(argv[++i]);
+        else if (a == "--filter" && i + 1 < argc)
+            opt.filter = argv[++i];
+        else if (a == "--json" && i + 1 < argc)
+            opt.json = argv[++i];
+        else
+        {
+            std::cerr << "usage: diceforge_bench [--reps N] [--scale F] [--filter NAME] [--json FILE]" << std::endl;
+            return 2;
+        }
+    }
+    std::cout << std::setw(12) << std::left << "group" << std::setw(44) << "case" << std::right << std::setw(13)
+              << "median/item" << "    spread" << std::endl;
+    bench_engines();
+    bench_distributions();
+    bench_sequences();
+    bench_fitting();
+    bench_integration();
+    if (!opt.json.empty())
+        write_json(opt.json);
+    return 0;
+}
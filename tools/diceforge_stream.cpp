@@ -0,0 +1,314 @@
+#include "diceforge.h"
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <chrono>
+#include <memory>
+#include <csignal>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define DF_STREAM_POSIX
+#endif
+#if defined(__linux__)
+#include <sys/uio.h>
+#endif
+
+// diceforge_stream - Writes the raw output of an RNG to stdout or to a file, for external test suites
+// (PractRand, TestU01, Dieharder...), e.g.
+//     diceforge_stream XORShift64 --seed 42 | RNG_test stdin64
+//     diceforge_stream MT64 --bytes 1073741824 --output mt64.bin --mmap
+// The integers are written in the byte order of the machine, their full width each, in the order next() hands them
+// out. The buffers are filled by the bulk fill() of the RNG through a StaticView, so the engine runs in its block
+// loop, and written with one system call per buffer (or spliced into the pipe on Linux, without a copy).
+
+using namespace DiceForge;
+
+namespace
+{
+    struct options
+    {
+        std::string engine;
+        unsigned long long seed = 0;
+        unsigned long long bytes = 0;   // 0 for an endless stream
+        size_t buffer = 1 << 22;    // bytes per buffer
+        std::string output;         // empty for stdout
+        bool mmap = false;
+        bool splice = true;
+        bool verbose = false;
+    };
+
+    void usage()
+    {
+        std::cerr << "usage: diceforge_stream ENGINE [--seed S] [--bytes N] [--buffer BYTES] [--output FILE [--mmap]]"
+                     " [--no-splice] [--verbose]\n"
+                     "engines: XORShift32 XORShift64 XORShift64x4 XORShift32x8 LFSR32 LFSR64 MT32 MT64 Philox32"
+                     " Philox64 NaorReingold BlumBlumShub32 BlumBlumShub64 BlumBlumShubMontgomery32"
+                     " BlumBlumShubMontgomery64\n";
+    }
+
+    // Page aligned buffers, so that whole pages can be handed to the kernel
+    struct aligned_free
+    {
+#if defined(_WIN32)
+        void operator()(void* p) const { _aligned_free(p); }
+#else
+        void operator()(void* p) const { std::free(p); }
+#endif
+    };
+    typedef std::unique_ptr<unsigned char, aligned_free> buffer_t;
+
+    buffer_t make_buffer(size_t bytes)
+    {
+#if defined(_WIN32)
+        void* p = _aligned_malloc(bytes, 4096);
+#else
+        void* p = std::aligned_alloc(4096, bytes);
+#endif
+        if (p == nullptr)
+            throw std::bad_alloc();
+        return buffer_t(static_cast<unsigned char*>(p));
+    }
+
+    // Writes the bytes with as many calls as needed, false once the reader has gone away
+    bool write_all([[maybe_unused]] int fd, [[maybe_unused]] std::FILE* file, const unsigned char* data, size_t n)
+    {
+#if defined(DF_STREAM_POSIX)
+        while (n > 0)
+        {
+            const ssize_t w = ::write(fd, data, n);
+            if (w < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return false;
+            }
+            data += w;
+            n -= size_t(w);
+        }
+        return true;
+#else
+        return std::fwrite(data, 1, n, file) == n;
+#endif
+    }
+
+#if defined(__linux__)
+    // Hands the pages of the buffer to the pipe. The pipe then refers to the pages rather than holding a copy, so a
+    // buffer may only be refilled once the pipe has been emptied of it: two buffers of at least the capacity of the
+    // pipe alternate, since the pipe holds no more than its capacity of what was spliced after a buffer.
+    bool splice_all(int fd, const unsigned char* data, size_t n)
+    {
+        while (n > 0)
+        {
+            iovec v = {const_cast<unsigned char*>(data), n};
+            const ssize_t w = ::vmsplice(fd, &v, 1, 0);
+            if (w < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return false;
+            }
+            data += w;
+            n -= size_t(w);
+        }
+        return true;
+    }
+#endif
+
+    // Fills and writes buffers of the RNG until the requested number of bytes (or forever)
+    template <typename Engine>
+    int stream(Engine& engine, const options& opt)
+    {
+        typedef typename Engine::result_type T;
+        auto rng = make_static(engine);
+        const size_t words = std::max<size_t>(1, opt.buffer / sizeof(T));
+        unsigned long long left = opt.bytes, written = 0;
+        const auto start = std::chrono::steady_clock::now();
+
+#if defined(DF_STREAM_POSIX)
+        if (opt.mmap)
+        {
+            // Straight into the pages of the file: the kernel writes them back, nothing is copied
+            if (opt.output.empty() || opt.bytes == 0)
+            {
+                std::cerr << "--mmap needs --output and --bytes" << std::endl;
+                return 2;
+            }
+            const int fd = ::open(opt.output.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0 || ::ftruncate(fd, off_t(opt.bytes)) != 0)
+            {
+                std::cerr << "cannot create " << opt.output << ": " << std::strerror(errno) << std::endl;
+                return 1;
+            }
+            void* map = ::mmap(nullptr, opt.bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (map == MAP_FAILED)
+            {
+                std::cerr << "cannot map " << opt.output << ": " << std::strerror(errno) << std::endl;
+                ::close(fd);
+                return 1;
+            }
+            unsigned char* out = static_cast<unsigned char*>(map);
+            // Whole words in place, the last partial word through a copy
+            const unsigned long long whole = opt.bytes / sizeof(T);
+            for (unsigned long long i = 0; i < whole; i += words)
+                rng.fill(reinterpret_cast<T*>(out) + i, size_t(std::min<unsigned long long>(words, whole - i)));
+            if (opt.bytes % sizeof(T) != 0)
+            {
+                const T last = rng.next();
+                std::memcpy(out + whole * sizeof(T), &last, opt.bytes % sizeof(T));
+            }
+            ::munmap(map, opt.bytes);
+            ::close(fd);
+            written = opt.bytes;
+        }
+        else
+#endif
+        {
+            std::FILE* file = stdout;
+            int fd = 1;
+            if (!opt.output.empty())
+            {
+                file = std::fopen(opt.output.c_str(), "wb");
+                if (file == nullptr)
+                {
+                    std::cerr << "cannot create " << opt.output << ": " << std::strerror(errno) << std::endl;
+                    return 1;
+                }
+                fd = fileno(file);
+            }
+            size_t size = words * sizeof(T);
+            bool splice = false;
+#if defined(__linux__)
+            struct stat st;
+            if (opt.splice && ::fstat(fd, &st) == 0 && S_ISFIFO(st.st_mode))
+            {
+                // A larger pipe means fewer wake-ups of the reader; the buffers must be at least as large
+                ::fcntl(fd, F_SETPIPE_SZ, 1 << 20);
+                const int capacity = ::fcntl(fd, F_GETPIPE_SZ);
+                if (capacity > 0)
+                {
+                    size = std::max(size, (size_t(capacity) + 4095) / 4096 * 4096);
+                    size = (size + sizeof(T) - 1) / sizeof(T) * sizeof(T);
+                    splice = true;
+                }
+            }
+#endif
+            buffer_t buffers[2] = {make_buffer(size), make_buffer(size)};
+            for (int b = 0; opt.bytes == 0 || left > 0; b ^= 1)
+            {
+                const size_t n = (opt.bytes == 0) ? size : size_t(std::min<unsigned long long>(size, left));
+                T* words_out = reinterpret_cast<T*>(buffers[b].get());
+                rng.fill(words_out, (n + sizeof(T) - 1) / sizeof(T));
+#if defined(__linux__)
+                const bool ok = splice ? splice_all(fd, buffers[b].get(), n)
+                                       : write_all(fd, file, buffers[b].get(), n);
+#else
+                const bool ok = write_all(fd, file, buffers[b].get(), n);
+#endif
+                if (!ok)
+                    break;  // the reader closed the pipe, as test suites do once they are done
+                written += n;
+                left -= (opt.bytes == 0) ? 0 : n;
+            }
+            if (file != stdout)
+                std::fclose(file);
+        }
+
+        if (opt.verbose)
+        {
+            const std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+            std::cerr << opt.engine << ": " << written << " bytes in " << t.count() << "s, " << written / t.count() / 1e9
+                      << " GB/s" << std::endl;
+        }
+        return 0;
+    }
+
+    template <typename Engine>
+    int run(const options& opt)
+    {
+        Engine engine(static_cast<typename Engine::result_type>(opt.seed));
+        return stream(engine, opt);
+    }
+
+    int dispatch(const options& opt)
+    {
+        static const std::pair<const char*, int (*)(const options&)> engines[] = {
+            {"XORShift32", run<XORShift32>},
+            {"XORShift64", run<XORShift64>},
+            {"XORShift64x4", run<XORShift64x4>},
+            {"XORShift32x8", run<XORShift32x8>},
+            {"LFSR32", run<LFSR32>},
+            {"LFSR64", run<LFSR64>},
+            {"MT32", run<MT32>},
+            {"MT64", run<MT64>},
+            {"Philox32", run<Philox32>},
+            {"Philox64", run<Philox64>},
+            {"NaorReingold", run<NaorReingold>},
+            {"BlumBlumShub32", run<BlumBlumShub32>},
+            {"BlumBlumShub64", run<BlumBlumShub64>},
+            {"BlumBlumShubMontgomery32", run<BlumBlumShubMontgomery32>},
+            {"BlumBlumShubMontgomery64", run<BlumBlumShubMontgomery64>},
+        };
+        for (const auto& e : engines)
+            if (opt.engine == e.first)
+                return e.second(opt);
+        std::cerr << "unknown engine " << opt.engine << std::endl;
+        usage();
+        return 2;
+    }
+}
+
+int main(int argc, char const *argv[])
+{
+    options opt;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string a = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (a == "--seed" && has_value)
+            opt.seed = std::strtoull(argv[++i], nullptr, 0);
+        else if (a == "--bytes" && has_value)
+            opt.bytes = std::strtoull(argv[++i], nullptr, 0);
+        else if (a == "--buffer" && has_value)
+            opt.buffer = std::max<size_t>(4096, std::strtoull(argv[++i], nullptr, 0));
+        else if (a == "--output" && has_value)
+            opt.output = argv[++i];
+        else if (a == "--mmap")
+            opt.mmap = true;
+        else if (a == "--no-splice")
+            opt.splice = false;
+        else if (a == "--verbose")
+            opt.verbose = true;
+        else if (a[0] != '-' && opt.engine.empty())
+            opt.engine = a;
+        else
+        {
+            usage();
+            return 2;
+        }
+    }
+    if (opt.engine.empty())
+    {
+        usage();
+        return 2;
+    }
+    // vmsplice needs the buffers to be whole pages
+    opt.buffer = (opt.buffer + 4095) / 4096 * 4096;
+#if defined(DF_STREAM_POSIX)
+    // A closed pipe then shows up as a failed write, and the stream ends normally
+    std::signal(SIGPIPE, SIG_IGN);
+#else
+    if (opt.mmap)
+    {
+        std::cerr << "--mmap is only supported on POSIX systems" << std::endl;
+        return 2;
+    }
+#endif
+    return dispatch(opt);
+}